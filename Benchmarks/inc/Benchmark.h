@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstdint>
+
+/**
+ * A minimal benchmark framework (the benchmarks only depend on the C++ standard library).
+ *
+ * Benchmarks are defined with BENCHMARK and registered before main runs. Each
+ * benchmark runs its operation State::GetNumIterations times between
+ * State::Start and State::Stop. The time per iteration is reported.
+ *
+ *   BENCHMARK(BuddyAllocate, 1000000)
+ *   {
+ *       BuddyAllocator allocator(_64MB, _64KB);
+ *       state.Start();
+ *       for (uint64_t i = 0; i < state.GetNumIterations(); ++i) { ... }
+ *       state.Stop();
+ *   }
+ *
+ * With --quick on the command line, the benchmarks run a few iterations only
+ * (ctest uses it to check that the benchmarks still work).
+ */
+namespace Benchmark
+{
+    class State
+    {
+    public:
+        explicit State(uint64_t numIterations);
+
+        uint64_t GetNumIterations() const;
+
+        // Start and stop the timer. The setup of the benchmark is not measured.
+        void Start();
+        void Stop();
+
+        // Report an additional value (for example, the number of allocations per iteration).
+        void SetCounter(const char* name, double value);
+
+        double GetElapsedTime() const;
+        const char* GetCounterName() const;
+        double GetCounterValue() const;
+
+    private:
+        uint64_t m_NumIterations;
+        uint64_t m_StartTime;
+        uint64_t m_ElapsedTime;
+        bool m_Running;
+
+        const char* m_CounterName;
+        double m_CounterValue;
+    };
+
+    using BenchmarkFunction = void (*)(State& state);
+
+    // Register a benchmark. Returns true so it can initialize a static variable.
+    bool Register(const char* name, uint64_t numIterations, BenchmarkFunction function);
+
+    // Prevent the compiler from optimizing away a value that is computed but not used.
+    void DoNotOptimize(const void* value);
+
+    template<typename T>
+    void DoNotOptimize(const T& value)
+    {
+        DoNotOptimize(static_cast<const void*>(&value));
+    }
+}
+
+#define BENCHMARK(name, numIterations) \
+    static void name(Benchmark::State& state); \
+    static const bool name##Registered = Benchmark::Register(#name, numIterations, name); \
+    static void name(Benchmark::State& state)
@@ -0,0 +1,144 @@
+#include <Benchmark.h>
+
+#include <FastClock.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+namespace
+{
+    struct BenchmarkInfo
+    {
+        const char* Name;
+        uint64_t NumIterations;
+        Benchmark::BenchmarkFunction Function;
+    };
+
+    // Function-local so the registration of the benchmarks does not depend
+    // on the initialization order of the translation units.
+    std::vector<BenchmarkInfo>& GetBenchmarks()
+    {
+        static std::vector<BenchmarkInfo> benchmarks;
+        return benchmarks;
+    }
+
+    // The number of iterations of the benchmarks with --quick.
+    const uint64_t MaxQuickIterations = 100;
+
+    volatile const void* g_DoNotOptimizeSink = nullptr;
+}
+
+Benchmark::State::State(uint64_t numIterations)
+    : m_NumIterations(numIterations)
+    , m_StartTime(0)
+    , m_ElapsedTime(0)
+    , m_Running(false)
+    , m_CounterName(nullptr)
+    , m_CounterValue(0.0)
+{}
+
+uint64_t Benchmark::State::GetNumIterations() const
+{
+    return m_NumIterations;
+}
+
+void Benchmark::State::Start()
+{
+    m_Running = true;
+    m_StartTime = FastClock::Now();
+}
+
+void Benchmark::State::Stop()
+{
+    if (m_Running)
+    {
+        m_ElapsedTime += FastClock::Now() - m_StartTime;
+        m_Running = false;
+    }
+}
+
+void Benchmark::State::SetCounter(const char* name, double value)
+{
+    m_CounterName = name;
+    m_CounterValue = value;
+}
+
+double Benchmark::State::GetElapsedTime() const
+{
+    return FastClock::ToSeconds(m_ElapsedTime);
+}
+
+const char* Benchmark::State::GetCounterName() const
+{
+    return m_CounterName;
+}
+
+double Benchmark::State::GetCounterValue() const
+{
+    return m_CounterValue;
+}
+
+bool Benchmark::Register(const char* name, uint64_t numIterations, BenchmarkFunction function)
+{
+    GetBenchmarks().push_back({ name, numIterations, function });
+    return true;
+}
+
+void Benchmark::DoNotOptimize(const void* value)
+{
+    g_DoNotOptimizeSink = value;
+}
+
+/**
+ * Run all benchmarks, or only the benchmarks whose names are passed on the command line.
+ */
+int main(int argc, char* argv[])
+{
+    bool quick = false;
+    std::vector<const char*> names;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (strcmp(argv[i], "--quick") == 0)
+        {
+            quick = true;
+        }
+        else
+        {
+            names.push_back(argv[i]);
+        }
+    }
+
+    printf("%-40s %12s %14s %14s\n", "Benchmark", "Iterations", "Total (ms)", "Time (ns)");
+
+    for (const BenchmarkInfo& benchmark : GetBenchmarks())
+    {
+        if (!names.empty() && std::none_of(names.begin(), names.end(),
+            [&benchmark](const char* name) { return strcmp(name, benchmark.Name) == 0; }))
+        {
+            continue;
+        }
+
+        uint64_t numIterations = quick ? std::min(benchmark.NumIterations, MaxQuickIterations) : benchmark.NumIterations;
+
+        Benchmark::State state(numIterations);
+        state.Start();
+        benchmark.Function(state);
+        state.Stop();
+
+        double elapsedTime = state.GetElapsedTime();
+        printf("%-40s %12llu %14.3f %14.1f",
+            benchmark.Name,
+            static_cast<unsigned long long>(numIterations),
+            elapsedTime * 1e3,
+            elapsedTime / numIterations * 1e9);
+        if (state.GetCounterName())
+        {
+            printf("  %s: %.2f", state.GetCounterName(), state.GetCounterValue());
+        }
+        printf("\n");
+    }
+
+    return 0;
+}
@@ -0,0 +1,92 @@
+#include <Benchmark.h>
+
+#include <BuddyAllocator.h>
+#include <Defines.h>
+
+#include <random>
+#include <vector>
+
+// Allocate and free a single buffer in an otherwise empty heap.
+BENCHMARK(BuddyAllocateFree, 200000)
+{
+    BuddyAllocator allocator(_64MB, _64KB);
+
+    state.Start();
+    for (uint64_t i = 0; i < state.GetNumIterations(); ++i)
+    {
+        uint64_t offset = allocator.Allocate(_64KB);
+        Benchmark::DoNotOptimize(offset);
+        allocator.Free(offset);
+    }
+    state.Stop();
+}
+
+// Fill a heap with 64KB buffers and free them again (the buddies are merged back into a single block).
+BENCHMARK(BuddyFillAndFree, 1000)
+{
+    BuddyAllocator allocator(_64MB, _64KB);
+    std::vector<uint64_t> offsets;
+    offsets.reserve(_64MB / _64KB);
+
+    state.Start();
+    for (uint64_t i = 0; i < state.GetNumIterations(); ++i)
+    {
+        while (allocator.HasSpace(_64KB))
+        {
+            offsets.push_back(allocator.Allocate(_64KB));
+        }
+        for (uint64_t offset : offsets)
+        {
+            allocator.Free(offset);
+        }
+        offsets.clear();
+    }
+    state.Stop();
+
+    state.SetCounter("allocations/iteration", _64MB / _64KB);
+}
+
+// Allocate and free buffers of random sizes and alignments in a heap that is about half full.
+BENCHMARK(BuddyRandomAllocations, 1000000)
+{
+    BuddyAllocator allocator(_128MB, _64KB);
+    std::mt19937 random(1);
+    std::vector<uint64_t> offsets;
+
+    // The sizes are generated up front so the random number generator is not measured.
+    std::vector<uint64_t> sizes(4096);
+    for (uint64_t& size : sizes)
+    {
+        size = 1 + random() % _1MB;
+    }
+
+    uint64_t numFailedAllocations = 0;
+
+    state.Start();
+    for (uint64_t i = 0; i < state.GetNumIterations(); ++i)
+    {
+        uint64_t size = sizes[i % sizes.size()];
+        if (allocator.GetFreeSize() < _128MB / 2 && !offsets.empty())
+        {
+            size_t index = size % offsets.size();
+            allocator.Free(offsets[index]);
+            offsets[index] = offsets.back();
+            offsets.pop_back();
+        }
+        else
+        {
+            uint64_t offset = allocator.Allocate(size, i % 16 == 0 ? _4MB : 0);
+            if (offset != BuddyAllocator::InvalidOffset)
+            {
+                offsets.push_back(offset);
+            }
+            else
+            {
+                ++numFailedAllocations;
+            }
+        }
+    }
+    state.Stop();
+
+    state.SetCounter("failed allocations", static_cast<double>(numFailedAllocations));
+}
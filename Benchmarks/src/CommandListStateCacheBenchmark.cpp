@@ -0,0 +1,192 @@
+#include <Benchmark.h>
+
+#include <CommandListStateCache.h>
+
+#include <cstddef>
+#include <vector>
+
+namespace
+{
+    /**
+     * Stands in for ID3D12GraphicsCommandList: counts the calls and keeps the
+     * last bound state so the calls are not optimized away.
+     */
+    class MockCommandList
+    {
+    public:
+        void SetPipelineState(const void* pipelineState) { m_PipelineState = pipelineState; ++m_NumCalls; }
+        void SetGraphicsRootSignature(const void* rootSignature) { m_RootSignature = rootSignature; ++m_NumCalls; }
+        void IASetPrimitiveTopology(uint32_t primitiveTopology) { m_PrimitiveTopology = primitiveTopology; ++m_NumCalls; }
+        void IASetVertexBuffers(uint32_t, uint32_t, const CommandListStateCache::VertexBufferView* views) { m_VertexBufferView = *views; ++m_NumCalls; }
+        void IASetIndexBuffer(const CommandListStateCache::IndexBufferView* view) { m_IndexBufferView = *view; ++m_NumCalls; }
+        void RSSetViewports(uint32_t, const CommandListStateCache::Viewport* viewports) { m_Viewport = *viewports; ++m_NumCalls; }
+        void RSSetScissorRects(uint32_t, const CommandListStateCache::Rect* rects) { m_ScissorRect = *rects; ++m_NumCalls; }
+        void DrawIndexedInstanced(uint32_t indexCount) { m_NumIndices += indexCount; ++m_NumCalls; }
+
+        uint64_t GetNumCalls() const { return m_NumCalls; }
+        uint64_t GetNumIndices() const { return m_NumIndices; }
+
+    private:
+        const void* m_PipelineState = nullptr;
+        const void* m_RootSignature = nullptr;
+        uint32_t m_PrimitiveTopology = 0;
+        CommandListStateCache::VertexBufferView m_VertexBufferView = {};
+        CommandListStateCache::IndexBufferView m_IndexBufferView = {};
+        CommandListStateCache::Viewport m_Viewport = {};
+        CommandListStateCache::Rect m_ScissorRect = {};
+        uint64_t m_NumCalls = 0;
+        uint64_t m_NumIndices = 0;
+    };
+
+    struct DrawItem
+    {
+        const void* PipelineState;
+        CommandListStateCache::VertexBufferView VertexBufferView;
+        CommandListStateCache::IndexBufferView IndexBufferView;
+        uint32_t IndexCount;
+    };
+
+    // A scene that is sorted by pipeline state. The meshes share the vertex and
+    // index buffers of a MeshBufferPool page (the ranges are selected with the
+    // start index and base vertex of the draw).
+    std::vector<DrawItem> CreateScene(size_t numDrawItems)
+    {
+        const size_t numPipelineStates = 8;
+
+        std::vector<DrawItem> scene(numDrawItems);
+        for (size_t i = 0; i < numDrawItems; ++i)
+        {
+            DrawItem& item = scene[i];
+            item.PipelineState = reinterpret_cast<const void*>(0x1000 + (i * numPipelineStates / numDrawItems) * 0x100);
+            item.VertexBufferView = { 0x10000000, 64 * 1024 * 1024, 32 };
+            item.IndexBufferView = { 0x20000000, 16 * 1024 * 1024, 42 };
+            item.IndexCount = 36 + static_cast<uint32_t>(i % 64) * 3;
+        }
+        return scene;
+    }
+
+    const void* const RootSignature = reinterpret_cast<const void*>(0x100);
+    const uint32_t TriangleList = 4;
+    const CommandListStateCache::Viewport Viewport = { 0.0f, 0.0f, 1280.0f, 720.0f, 0.0f, 1.0f };
+    const CommandListStateCache::Rect ScissorRect = { 0, 0, 1280, 720 };
+}
+
+// Every draw sets its complete state on the command list.
+BENCHMARK(UncachedDraws, 1000000)
+{
+    std::vector<DrawItem> scene = CreateScene(4096);
+    MockCommandList commandList;
+
+    state.Start();
+    for (uint64_t i = 0; i < state.GetNumIterations(); ++i)
+    {
+        const DrawItem& item = scene[i % scene.size()];
+
+        commandList.SetPipelineState(item.PipelineState);
+        commandList.SetGraphicsRootSignature(RootSignature);
+        commandList.IASetPrimitiveTopology(TriangleList);
+        commandList.RSSetViewports(1, &Viewport);
+        commandList.RSSetScissorRects(1, &ScissorRect);
+        commandList.IASetVertexBuffers(0, 1, &item.VertexBufferView);
+        commandList.IASetIndexBuffer(&item.IndexBufferView);
+        commandList.DrawIndexedInstanced(item.IndexCount);
+    }
+    state.Stop();
+
+    Benchmark::DoNotOptimize(commandList.GetNumIndices());
+    state.SetCounter("calls/draw", static_cast<double>(commandList.GetNumCalls()) / state.GetNumIterations());
+}
+
+// Redundant state changes are dropped by the state cache (like CommandList does).
+BENCHMARK(CachedDraws, 1000000)
+{
+    std::vector<DrawItem> scene = CreateScene(4096);
+    MockCommandList commandList;
+    CommandListStateCache stateCache;
+
+    state.Start();
+    for (uint64_t i = 0; i < state.GetNumIterations(); ++i)
+    {
+        const DrawItem& item = scene[i % scene.size()];
+
+        if (stateCache.SetPipelineState(item.PipelineState))
+        {
+            commandList.SetPipelineState(item.PipelineState);
+        }
+        if (stateCache.SetGraphicsRootSignature(RootSignature))
+        {
+            commandList.SetGraphicsRootSignature(RootSignature);
+        }
+        if (stateCache.SetPrimitiveTopology(TriangleList))
+        {
+            commandList.IASetPrimitiveTopology(TriangleList);
+        }
+        if (stateCache.SetViewports(1, &Viewport))
+        {
+            commandList.RSSetViewports(1, &Viewport);
+        }
+        if (stateCache.SetScissorRects(1, &ScissorRect))
+        {
+            commandList.RSSetScissorRects(1, &ScissorRect);
+        }
+        if (stateCache.SetVertexBuffer(0, item.VertexBufferView))
+        {
+            commandList.IASetVertexBuffers(0, 1, &item.VertexBufferView);
+        }
+        if (stateCache.SetIndexBuffer(item.IndexBufferView))
+        {
+            commandList.IASetIndexBuffer(&item.IndexBufferView);
+        }
+        commandList.DrawIndexedInstanced(item.IndexCount);
+        stateCache.RecordDraw();
+    }
+    state.Stop();
+
+    Benchmark::DoNotOptimize(commandList.GetNumIndices());
+    state.SetCounter("calls/draw", static_cast<double>(commandList.GetNumCalls()) / state.GetNumIterations());
+}
+
+// The state cache is reset with the command list (every 1024 draws), the statistics accumulate.
+BENCHMARK(CachedDrawsWithReset, 1000000)
+{
+    std::vector<DrawItem> scene = CreateScene(4096);
+    MockCommandList commandList;
+    CommandListStateCache stateCache;
+
+    state.Start();
+    for (uint64_t i = 0; i < state.GetNumIterations(); ++i)
+    {
+        if (i % 1024 == 0)
+        {
+            stateCache.Reset();
+        }
+
+        const DrawItem& item = scene[i % scene.size()];
+
+        if (stateCache.SetPipelineState(item.PipelineState))
+        {
+            commandList.SetPipelineState(item.PipelineState);
+        }
+        if (stateCache.SetGraphicsRootSignature(RootSignature))
+        {
+            commandList.SetGraphicsRootSignature(RootSignature);
+        }
+        if (stateCache.SetVertexBuffer(0, item.VertexBufferView))
+        {
+            commandList.IASetVertexBuffers(0, 1, &item.VertexBufferView);
+        }
+        if (stateCache.SetIndexBuffer(item.IndexBufferView))
+        {
+            commandList.IASetIndexBuffer(&item.IndexBufferView);
+        }
+        commandList.DrawIndexedInstanced(item.IndexCount);
+        stateCache.RecordDraw();
+    }
+    state.Stop();
+
+    const CommandListStateCache::Statistics& statistics = stateCache.GetStatistics();
+    Benchmark::DoNotOptimize(commandList.GetNumIndices());
+    state.SetCounter("redundant calls/draw",
+        static_cast<double>(statistics.NumRedundantPipelineStates + statistics.NumRedundantRootSignatures +
+            statistics.NumRedundantVertexBuffers + statistics.NumRedundantIndexBuffers) / statistics.NumDraws);
+}
@@ -0,0 +1,185 @@
+#include <Benchmark.h>
+
+#include <CommandQueue.h>
+#include <NullDevice.h>
+#include <ResourceStateTracker.h>
+
+#include <memory>
+#include <vector>
+
+namespace
+{
+    // Matches D3D12_RESOURCE_STATES.
+    const uint32_t PixelShaderResource = 0x80;
+    const uint32_t RenderTarget = 0x4;
+
+    /**
+     * The engine command list on the NullDevice (like CommandList): transitions
+     * are tracked with a ResourceStateTracker and the commands are recorded on
+     * a command list of the device.
+     */
+    class NullEngineCommandList
+    {
+    public:
+        NullEngineCommandList(Device& device, Device::CommandListType type)
+            : m_CommandList(std::static_pointer_cast<NullDevice::CommandList>(device.CreateCommandList(type)))
+        {}
+
+        void TransitionBarrier(void* resource, uint32_t stateAfter)
+        {
+            m_ResourceStateTracker.TransitionResource(resource, stateAfter);
+        }
+
+        void Draw()
+        {
+            FlushResourceBarriers();
+            m_CommandList->DrawInstanced(3, 1);
+        }
+
+        bool Close(NullEngineCommandList& pendingCommandList)
+        {
+            FlushResourceBarriers();
+            m_CommandList->Close();
+
+            uint32_t numPendingBarriers = m_ResourceStateTracker.FlushPendingResourceBarriers(pendingCommandList.GetResourceBarrierFunction());
+            m_ResourceStateTracker.CommitFinalResourceStates();
+
+            return numPendingBarriers > 0;
+        }
+
+        void Close()
+        {
+            FlushResourceBarriers();
+            m_CommandList->Close();
+        }
+
+        void Reset()
+        {
+            m_CommandList->Reset();
+            m_ResourceStateTracker.Reset();
+        }
+
+        Device::CommandList& GetDeviceCommandList() const
+        {
+            return *m_CommandList;
+        }
+
+    private:
+        ResourceStateTracker::ResourceBarrierFunction GetResourceBarrierFunction()
+        {
+            NullDevice::CommandList* commandList = m_CommandList.get();
+            return [commandList](uint32_t numBarriers, const ResourceStateTracker::Barrier*)
+            {
+                commandList->ResourceBarrier(numBarriers);
+            };
+        }
+
+        void FlushResourceBarriers()
+        {
+            m_ResourceStateTracker.FlushResourceBarriers(GetResourceBarrierFunction());
+        }
+
+        std::shared_ptr<NullDevice::CommandList> m_CommandList;
+        ResourceStateTracker m_ResourceStateTracker;
+    };
+
+    using NullCommandQueue = BasicCommandQueue<NullEngineCommandList>;
+
+    // Resources that are registered in the global resource state while they are alive.
+    class Resources
+    {
+    public:
+        explicit Resources(size_t numResources)
+            : m_Resources(numResources)
+        {
+            for (char& resource : m_Resources)
+            {
+                ResourceStateTracker::AddGlobalResourceState(&resource, PixelShaderResource);
+            }
+        }
+
+        ~Resources()
+        {
+            for (char& resource : m_Resources)
+            {
+                ResourceStateTracker::RemoveGlobalResourceState(&resource);
+            }
+        }
+
+        void* operator[](size_t index)
+        {
+            return &m_Resources[index];
+        }
+
+    private:
+        std::vector<char> m_Resources;
+    };
+}
+
+// Record a pass that renders to 4 render targets and samples them in the next
+// pass (like a G-buffer) and execute it. The first transitions of the command
+// list are pending barriers, which are executed on a pending command list.
+BENCHMARK(ExecuteCommandList, 200000)
+{
+    const size_t numRenderTargets = 4;
+
+    NullDevice device;
+    NullCommandQueue commandQueue(device, Device::CommandListType::Direct);
+    Resources renderTargets(numRenderTargets);
+
+    state.Start();
+    for (uint64_t i = 0; i < state.GetNumIterations(); ++i)
+    {
+        std::shared_ptr<NullEngineCommandList> commandList = commandQueue.GetCommandList();
+
+        for (size_t j = 0; j < numRenderTargets; ++j)
+        {
+            commandList->TransitionBarrier(renderTargets[j], RenderTarget);
+        }
+        commandList->Draw();
+        for (size_t j = 0; j < numRenderTargets; ++j)
+        {
+            commandList->TransitionBarrier(renderTargets[j], PixelShaderResource);
+        }
+        commandList->Draw();
+
+        commandQueue.ExecuteCommandList(commandList);
+    }
+    state.Stop();
+
+    commandQueue.Flush();
+    state.SetCounter("command lists", static_cast<double>(device.GetStatistics().NumExecutedCommandLists) / state.GetNumIterations());
+}
+
+// Execute the command lists of a frame in a single batch (like the command
+// lists that are recorded on the workers of the job system).
+BENCHMARK(ExecuteCommandLists, 50000)
+{
+    const size_t numCommandLists = 8;
+
+    NullDevice device;
+    NullCommandQueue commandQueue(device, Device::CommandListType::Direct);
+    Resources textures(numCommandLists);
+
+    std::vector< std::shared_ptr<NullEngineCommandList> > commandLists;
+    commandLists.reserve(numCommandLists);
+
+    state.Start();
+    for (uint64_t i = 0; i < state.GetNumIterations(); ++i)
+    {
+        for (size_t j = 0; j < numCommandLists; ++j)
+        {
+            std::shared_ptr<NullEngineCommandList> commandList = commandQueue.GetCommandList();
+            commandList->TransitionBarrier(textures[j], (i & 1) ? PixelShaderResource : RenderTarget);
+            commandList->Draw();
+            commandLists.push_back(commandList);
+        }
+
+        commandQueue.ExecuteCommandLists(commandLists);
+        commandLists.clear();
+    }
+    state.Stop();
+
+    commandQueue.Flush();
+    state.SetCounter("command lists", static_cast<double>(device.GetStatistics().NumExecutedCommandLists) / state.GetNumIterations());
+}
@@ -0,0 +1,128 @@
+#include <Benchmark.h>
+
+#include <DescriptorAllocator.h>
+#include <DynamicDescriptorHeap.h>
+#include <NullDevice.h>
+#include <UploadBuffer.h>
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace
+{
+    // The number of frames that are in flight (freed descriptors are released
+    // when the frame that freed them has completed).
+    const uint64_t NumFramesInFlight = 3;
+}
+
+// Allocate single descriptors (like the views of the textures), free them at
+// the end of the frame and release the stale descriptors of completed frames.
+BENCHMARK(DescriptorAllocateFree, 1000000)
+{
+    const size_t numAllocationsPerFrame = 64;
+
+    NullDevice device;
+    DescriptorAllocator allocator(device, Device::DescriptorHeapType::CBV_SRV_UAV);
+    std::vector<DescriptorAllocation> allocations;
+    allocations.reserve(numAllocationsPerFrame);
+
+    uint64_t frameCount = 0;
+
+    state.Start();
+    for (uint64_t i = 0; i < state.GetNumIterations(); ++i)
+    {
+        allocations.push_back(allocator.Allocate());
+
+        if (allocations.size() == numAllocationsPerFrame)
+        {
+            allocations.clear();
+
+            device.SetFrameCount(++frameCount);
+            if (frameCount > NumFramesInFlight)
+            {
+                allocator.ReleaseStaleDescriptors(frameCount - NumFramesInFlight);
+            }
+        }
+    }
+    state.Stop();
+
+    state.SetCounter("descriptor heaps", static_cast<double>(device.GetStatistics().NumDescriptorHeaps));
+}
+
+// Allocate constant buffers from the upload buffer of a command list, which is
+// reset when the command list is reset (every 1024 allocations).
+BENCHMARK(UploadBufferAllocate, 1000000)
+{
+    const size_t constantBufferSize = 256;
+
+    NullDevice device;
+    UploadBuffer uploadBuffer(device);
+    uint64_t gpuAddress = 0;
+
+    state.Start();
+    for (uint64_t i = 0; i < state.GetNumIterations(); ++i)
+    {
+        if (i % 1024 == 0)
+        {
+            uploadBuffer.Reset();
+        }
+
+        UploadBuffer::Allocation allocation = uploadBuffer.Allocate(constantBufferSize, constantBufferSize);
+        gpuAddress ^= allocation.GPU;
+    }
+    state.Stop();
+
+    Benchmark::DoNotOptimize(gpuAddress);
+    state.SetCounter("resources", static_cast<double>(device.GetStatistics().NumResources));
+}
+
+// Stage a descriptor table per draw and commit it to the shader visible
+// descriptor heap (like CommandList::DrawIndexed). The dynamic descriptor heap
+// is reset with the command list (every 1024 draws).
+BENCHMARK(DynamicDescriptorHeapCommit, 1000000)
+{
+    // A root signature with a constant buffer (root parameter 0), a table
+    // of 4 textures (root parameter 1) and a table of 2 UAVs (root parameter 2).
+    const uint32_t numDescriptors[] = { 0, 4, 2 };
+    const uint32_t descriptorTableBitMask = (1u << 1) | (1u << 2);
+
+    NullDevice device;
+    DynamicDescriptorHeap dynamicDescriptorHeap(device, Device::DescriptorHeapType::CBV_SRV_UAV);
+
+    // The CPU visible descriptors of the textures.
+    std::shared_ptr<Device::DescriptorHeap> textures = device.CreateDescriptorHeap(Device::DescriptorHeapType::CBV_SRV_UAV, 64, false);
+    const uint64_t textureDescriptors = textures->GetCPUDescriptorHandleForHeapStart();
+    const uint32_t descriptorSize = device.GetDescriptorHandleIncrementSize(Device::DescriptorHeapType::CBV_SRV_UAV);
+
+    auto commandList = std::static_pointer_cast<NullDevice::CommandList>(device.CreateCommandList(NullDevice::CommandListType::Direct));
+
+    auto setDescriptorHeap = [&commandList](Device::DescriptorHeap& descriptorHeap)
+    {
+        commandList->SetDescriptorHeap(descriptorHeap);
+    };
+    auto setDescriptorTable = [&commandList](uint32_t rootParameterIndex, uint64_t baseDescriptor)
+    {
+        commandList->SetRootDescriptorTable(rootParameterIndex, baseDescriptor);
+    };
+
+    state.Start();
+    for (uint64_t i = 0; i < state.GetNumIterations(); ++i)
+    {
+        if (i % 1024 == 0)
+        {
+            commandList->Reset();
+            dynamicDescriptorHeap.Reset();
+            dynamicDescriptorHeap.ParseRootSignature(descriptorTableBitMask, numDescriptors, 3);
+        }
+
+        const uint64_t material = textureDescriptors + (i % 16) * 4 * descriptorSize;
+        dynamicDescriptorHeap.StageDescriptors(1, 0, 4, material);
+        dynamicDescriptorHeap.StageDescriptors(2, 0, 2, textureDescriptors);
+        dynamicDescriptorHeap.CommitStagedDescriptors(setDescriptorHeap, setDescriptorTable);
+    }
+    state.Stop();
+
+    Benchmark::DoNotOptimize(commandList->GetCommands().size());
+    state.SetCounter("descriptor heaps", static_cast<double>(device.GetStatistics().NumDescriptorHeaps));
+}
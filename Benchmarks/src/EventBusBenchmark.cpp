@@ -0,0 +1,109 @@
+#include <Benchmark.h>
+
+#include <EventBus.h>
+#include <Events.h>
+
+#include <functional>
+#include <vector>
+
+namespace
+{
+    // The number of listeners of the mouse motion events (the game, the camera
+    // controller, the GUI and the profiler overlay).
+    const int NumListeners = 4;
+
+    struct MouseListener
+    {
+        void OnMouseMoved(MouseMotionEventArgs& e)
+        {
+            Sum += e.X + e.Y;
+        }
+
+        int64_t Sum = 0;
+    };
+
+    std::vector<MouseMotionEventArgs> CreateMouseEvents(size_t numEvents)
+    {
+        std::vector<MouseMotionEventArgs> events;
+        events.reserve(numEvents);
+        for (size_t i = 0; i < numEvents; ++i)
+        {
+            events.emplace_back(false, false, false, false, false, static_cast<int>(i % 1280), static_cast<int>(i % 720));
+        }
+        return events;
+    }
+}
+
+// Publish the events one at a time.
+BENCHMARK(EventBusPublish, 10000000)
+{
+    EventBus eventBus;
+    MouseListener listeners[NumListeners];
+    for (MouseListener& listener : listeners)
+    {
+        eventBus.Subscribe<&MouseListener::OnMouseMoved>(&listener);
+    }
+
+    std::vector<MouseMotionEventArgs> events = CreateMouseEvents(1024);
+
+    state.Start();
+    for (uint64_t i = 0; i < state.GetNumIterations(); ++i)
+    {
+        eventBus.Publish(events[i % events.size()]);
+    }
+    state.Stop();
+
+    Benchmark::DoNotOptimize(listeners[0].Sum);
+    state.SetCounter("listeners", NumListeners);
+}
+
+// Publish the events of a frame as a batch (like Window::ProcessInput).
+BENCHMARK(EventBusPublishBatch, 10000000)
+{
+    const size_t batchSize = 64;
+
+    EventBus eventBus;
+    MouseListener listeners[NumListeners];
+    for (MouseListener& listener : listeners)
+    {
+        eventBus.Subscribe<&MouseListener::OnMouseMoved>(&listener);
+    }
+
+    std::vector<MouseMotionEventArgs> events = CreateMouseEvents(batchSize);
+
+    state.Start();
+    for (uint64_t i = 0; i < state.GetNumIterations(); i += batchSize)
+    {
+        eventBus.Publish(events.data(), events.size());
+    }
+    state.Stop();
+
+    Benchmark::DoNotOptimize(listeners[0].Sum);
+    state.SetCounter("listeners", NumListeners);
+}
+
+// Dispatch the events to a list of std::function for comparison.
+BENCHMARK(StdFunctionPublish, 10000000)
+{
+    MouseListener listeners[NumListeners];
+    std::vector< std::function<void(MouseMotionEventArgs&)> > callbacks;
+    for (MouseListener& listener : listeners)
+    {
+        callbacks.push_back([&listener](MouseMotionEventArgs& e) { listener.OnMouseMoved(e); });
+    }
+
+    std::vector<MouseMotionEventArgs> events = CreateMouseEvents(1024);
+
+    state.Start();
+    for (uint64_t i = 0; i < state.GetNumIterations(); ++i)
+    {
+        for (const auto& callback : callbacks)
+        {
+            callback(events[i % events.size()]);
+        }
+    }
+    state.Stop();
+
+    Benchmark::DoNotOptimize(listeners[0].Sum);
+    state.SetCounter("listeners", NumListeners);
+}
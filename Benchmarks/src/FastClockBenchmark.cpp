@@ -0,0 +1,51 @@
+#include <Benchmark.h>
+
+#include <FastClock.h>
+
+#include <chrono>
+
+// Read the clock (like the profiler zones and the frame timing).
+BENCHMARK(FastClockNow, 10000000)
+{
+    uint64_t ticks = 0;
+
+    state.Start();
+    for (uint64_t i = 0; i < state.GetNumIterations(); ++i)
+    {
+        ticks ^= FastClock::Now();
+    }
+    state.Stop();
+
+    Benchmark::DoNotOptimize(ticks);
+    state.SetCounter("TSC", FastClock::GetSource() == FastClock::Source::TSC ? 1.0 : 0.0);
+}
+
+// Read std::chrono::steady_clock (the fallback of FastClock::Now) for comparison.
+BENCHMARK(SteadyClockNow, 10000000)
+{
+    uint64_t ticks = 0;
+
+    state.Start();
+    for (uint64_t i = 0; i < state.GetNumIterations(); ++i)
+    {
+        ticks ^= static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+    }
+    state.Stop();
+
+    Benchmark::DoNotOptimize(ticks);
+}
+
+// Read the time in seconds (like the platforms and the frame pacer).
+BENCHMARK(FastClockGetSeconds, 10000000)
+{
+    double seconds = 0.0;
+
+    state.Start();
+    for (uint64_t i = 0; i < state.GetNumIterations(); ++i)
+    {
+        seconds += FastClock::GetSeconds();
+    }
+    state.Stop();
+
+    Benchmark::DoNotOptimize(seconds);
+}
@@ -0,0 +1,115 @@
+#include <Benchmark.h>
+
+#include <JobSystem.h>
+
+#include <cmath>
+#include <cstddef>
+#include <vector>
+
+namespace
+{
+    // The number of objects that are updated per frame.
+    const uint32_t NumObjects = 16384;
+
+    struct Object
+    {
+        float Position[3];
+        float Velocity[3];
+        float Angle;
+        float Transform[4];
+    };
+
+    // The per-object update of a frame: integrate the motion and rebuild the
+    // rotation (a few hundred cycles, like a small game object).
+    void UpdateObject(Object& object, float elapsedTime)
+    {
+        for (int i = 0; i < 3; ++i)
+        {
+            object.Position[i] += object.Velocity[i] * elapsedTime;
+        }
+        object.Angle += elapsedTime;
+
+        float s = std::sin(object.Angle * 0.5f);
+        float c = std::cos(object.Angle * 0.5f);
+        float length = std::sqrt(object.Position[0] * object.Position[0] + object.Position[1] * object.Position[1] + 1.0f);
+        object.Transform[0] = s * object.Position[0] / length;
+        object.Transform[1] = s * object.Position[1] / length;
+        object.Transform[2] = s / length;
+        object.Transform[3] = c;
+    }
+
+    std::vector<Object> CreateObjects()
+    {
+        std::vector<Object> objects(NumObjects);
+        for (uint32_t i = 0; i < NumObjects; ++i)
+        {
+            objects[i] = { { static_cast<float>(i % 128), static_cast<float>(i / 128), 0.0f }, { 1.0f, 0.5f, 0.0f }, 0.0f, {} };
+        }
+        return objects;
+    }
+
+    // Update all objects once per iteration with ParallelFor.
+    void ParallelUpdate(Benchmark::State& state, size_t numWorkers)
+    {
+        JobSystem jobSystem(numWorkers);
+        std::vector<Object> objects = CreateObjects();
+
+        state.Start();
+        for (uint64_t i = 0; i < state.GetNumIterations(); ++i)
+        {
+            jobSystem.ParallelFor(NumObjects, 0, [&objects](uint32_t index)
+            {
+                UpdateObject(objects[index], 1.0f / 60.0f);
+            });
+        }
+        state.Stop();
+
+        Benchmark::DoNotOptimize(objects[NumObjects - 1].Transform[3]);
+        state.SetCounter("workers", static_cast<double>(jobSystem.GetNumWorkers()));
+    }
+}
+
+// The scaling of a frame update with the number of workers (the time per
+// iteration is the time to update all objects).
+BENCHMARK(ParallelUpdate1Worker, 1000)
+{
+    ParallelUpdate(state, 1);
+}
+
+BENCHMARK(ParallelUpdate2Workers, 1000)
+{
+    ParallelUpdate(state, 2);
+}
+
+BENCHMARK(ParallelUpdate4Workers, 1000)
+{
+    ParallelUpdate(state, 4);
+}
+
+BENCHMARK(ParallelUpdate8Workers, 1000)
+{
+    ParallelUpdate(state, 8);
+}
+
+// All hardware threads.
+BENCHMARK(ParallelUpdateAllWorkers, 1000)
+{
+    ParallelUpdate(state, 0);
+}
+
+// The overhead of submitting and waiting for an empty job.
+BENCHMARK(JobRunWait, 1000000)
+{
+    JobSystem jobSystem;
+
+    state.Start();
+    for (uint64_t i = 0; i < state.GetNumIterations(); ++i)
+    {
+        JobCounter counter;
+        jobSystem.Run([]() {}, &counter);
+        jobSystem.Wait(counter);
+    }
+    state.Stop();
+
+    state.SetCounter("workers", static_cast<double>(jobSystem.GetNumWorkers()));
+}
@@ -0,0 +1,183 @@
+#include <Benchmark.h>
+
+#include <DynamicDescriptorHeap.h>
+#include <NullDevice.h>
+#include <PackedRootSignatureDesc.h>
+
+#include <algorithm>
+#include <vector>
+
+namespace
+{
+    // Stand-ins for the D3D12 root signature structures (with the same members).
+    struct DescriptorRange
+    {
+        uint32_t RangeType;
+        uint32_t NumDescriptors;
+        uint32_t BaseShaderRegister;
+        uint32_t RegisterSpace;
+        uint32_t Flags;
+        uint32_t OffsetInDescriptorsFromTableStart;
+    };
+
+    struct RootDescriptorTable
+    {
+        uint32_t NumDescriptorRanges;
+        const DescriptorRange* pDescriptorRanges;
+    };
+
+    struct RootConstants
+    {
+        uint32_t ShaderRegister;
+        uint32_t RegisterSpace;
+        uint32_t Num32BitValues;
+    };
+
+    struct RootParameter
+    {
+        uint32_t ParameterType;
+        union
+        {
+            RootDescriptorTable DescriptorTable;
+            RootConstants Constants;
+        };
+        uint32_t ShaderVisibility;
+    };
+
+    struct StaticSampler
+    {
+        uint32_t Filter;
+        uint32_t AddressU;
+        uint32_t AddressV;
+        uint32_t AddressW;
+        float MipLODBias;
+        uint32_t MaxAnisotropy;
+        uint32_t ComparisonFunc;
+        uint32_t BorderColor;
+        float MinLOD;
+        float MaxLOD;
+        uint32_t ShaderRegister;
+        uint32_t RegisterSpace;
+        uint32_t ShaderVisibility;
+    };
+
+    struct RootSignatureDesc
+    {
+        uint32_t NumParameters;
+        const RootParameter* pParameters;
+        uint32_t NumStaticSamplers;
+        const StaticSampler* pStaticSamplers;
+        uint32_t Flags;
+    };
+
+    using PackedDesc = PackedRootSignatureDesc<RootSignatureDesc>;
+
+    // Matches D3D12_ROOT_PARAMETER_TYPE and D3D12_DESCRIPTOR_RANGE_TYPE.
+    const uint32_t DescriptorTable = 0;
+    const uint32_t Constants = 1;
+    const uint32_t SRV = 0;
+    const uint32_t Sampler = 3;
+
+    /**
+     * A root signature with root constants followed by numTables descriptor
+     * tables of 4 SRVs and a sampler table (like a material root signature).
+     */
+    class MaterialRootSignature
+    {
+    public:
+        explicit MaterialRootSignature(uint32_t numTables)
+            : m_Parameters(numTables + 2)
+        {
+            m_TextureRange = { SRV, 4, 0, 0, 0, 0 };
+            m_SamplerRange = { Sampler, 2, 0, 0, 0, 0 };
+
+            m_Parameters[0].ParameterType = Constants;
+            m_Parameters[0].Constants = { 0, 0, 16 };
+            m_Parameters[0].ShaderVisibility = 0;
+            for (uint32_t i = 1; i <= numTables; ++i)
+            {
+                m_Parameters[i].ParameterType = DescriptorTable;
+                m_Parameters[i].DescriptorTable = { 1, &m_TextureRange };
+                m_Parameters[i].ShaderVisibility = 5;
+            }
+            m_Parameters.back().ParameterType = DescriptorTable;
+            m_Parameters.back().DescriptorTable = { 1, &m_SamplerRange };
+            m_Parameters.back().ShaderVisibility = 5;
+
+            m_Desc = { static_cast<uint32_t>(m_Parameters.size()), m_Parameters.data(), 0, nullptr, 0 };
+        }
+
+        const RootSignatureDesc& GetDesc() const
+        {
+            return m_Desc;
+        }
+
+    private:
+        DescriptorRange m_TextureRange;
+        DescriptorRange m_SamplerRange;
+        std::vector<RootParameter> m_Parameters;
+        RootSignatureDesc m_Desc;
+    };
+}
+
+// Parse the root signature when it is set on a command list (like
+// CommandList::ParseRootSignature). The draws alternate between two root signatures.
+BENCHMARK(ParseRootSignature, 1000000)
+{
+    MaterialRootSignature opaque(4);
+    MaterialRootSignature transparent(6);
+    PackedDesc rootSignatures[] = { PackedDesc(opaque.GetDesc()), PackedDesc(transparent.GetDesc()) };
+
+    NullDevice device;
+    DynamicDescriptorHeap descriptorHeap(device, Device::DescriptorHeapType::CBV_SRV_UAV);
+    DynamicDescriptorHeap samplerHeap(device, Device::DescriptorHeapType::Sampler);
+
+    state.Start();
+    for (uint64_t i = 0; i < state.GetNumIterations(); ++i)
+    {
+        const PackedDesc& rootSignature = rootSignatures[i & 1];
+
+        uint32_t numParameters = std::min(rootSignature.GetDesc().NumParameters, DynamicDescriptorHeap::MaxDescriptorTables);
+        uint32_t numDescriptors[DynamicDescriptorHeap::MaxDescriptorTables];
+        for (uint32_t j = 0; j < numParameters; ++j)
+        {
+            numDescriptors[j] = rootSignature.GetNumDescriptors(j);
+        }
+
+        descriptorHeap.ParseRootSignature(rootSignature.GetDescriptorTableBitMask(), numDescriptors, numParameters);
+        samplerHeap.ParseRootSignature(rootSignature.GetSamplerTableBitMask(), numDescriptors, numParameters);
+    }
+    state.Stop();
+}
+
+// Store a description (like RootSignature::SetRootSignatureDesc, without the serialization).
+BENCHMARK(StoreRootSignatureDesc, 1000000)
+{
+    MaterialRootSignature rootSignature(8);
+    PackedDesc packedDesc;
+
+    state.Start();
+    for (uint64_t i = 0; i < state.GetNumIterations(); ++i)
+    {
+        packedDesc.Store(rootSignature.GetDesc());
+    }
+    state.Stop();
+
+    Benchmark::DoNotOptimize(packedDesc.GetNumDescriptors(1));
+    state.SetCounter("bytes", static_cast<double>(packedDesc.GetStorageSize()));
+}
+
+// Copy a description (like a copy of a RootSignature).
+BENCHMARK(CopyRootSignatureDesc, 1000000)
+{
+    MaterialRootSignature rootSignature(8);
+    PackedDesc packedDesc(rootSignature.GetDesc());
+
+    state.Start();
+    for (uint64_t i = 0; i < state.GetNumIterations(); ++i)
+    {
+        PackedDesc copy(packedDesc);
+        Benchmark::DoNotOptimize(copy.GetDesc().pParameters);
+    }
+    state.Stop();
+}
@@ -1,23 +1,38 @@
 #pragma once
 
+#include <CommandQueue.h>
+
 #include <d3d12.h>
 #include <dxgi1_6.h>
 #include <wrl.h>
 
 #include <memory>
+#include <queue>
 #include <string>
 
 class Window;
 class Game;
-class CommandQueue;
+class D3D12Device;
+class FrameCapture;
+class GpuProfiler;
+class HeapAllocator;
+class JobSystem;
+class MeshBufferPool;
+class Platform;
+class RootSignatureCache;
+class PipelineStateCache;
+class ShaderReloader;
+class ThreadPool;
 
 class Application
 {
 public:
      /**
     * Create the application singleton with the application instance handle.
+    * @param platform The platform that runs the application loop. If nullptr,
+    * the Win32 message loop is used.
     */
-    static void Create(HINSTANCE hInst);
+    static void Create(HINSTANCE hInst, std::unique_ptr<Platform> platform = nullptr);
 
     /**
     * Destroy the application instance and all windows created by this application instance.
@@ -72,10 +87,35 @@ public:
     */
     void Quit(int exitCode = 0);
 
+    /**
+     * Get the platform that runs the application loop.
+     */
+    Platform& GetPlatform() const;
+
+    /**
+     * Get the recorder that captures the engine level calls of a number of
+     * frames (see FrameCapture::Begin). The capture can be replayed without
+     * a GPU with the FrameReplay tool.
+     */
+    FrameCapture& GetFrameCapture() const;
+
+    /**
+     * Get the profiler that measures the GPU time of the scopes in the
+     * command lists of the direct command queue (see GPU_PROFILE_SCOPE).
+     */
+    GpuProfiler& GetGpuProfiler() const;
+
     /**
      * Get the Direct3D 12 device
      */
     Microsoft::WRL::ComPtr<ID3D12Device2> GetDevice() const;
+
+    /**
+     * Get the device interface that is used by the descriptor allocators, upload
+     * buffers, dynamic descriptor heaps and command queues (see Device).
+     */
+    D3D12Device& GetD3D12Device() const;
+
     /**
      * Get a command queue. Valid types are:
      * - D3D12_COMMAND_LIST_TYPE_DIRECT : Can be used for draw, dispatch, or copy commands.
@@ -84,12 +124,72 @@ public:
      */
     std::shared_ptr<CommandQueue> GetCommandQueue(D3D12_COMMAND_LIST_TYPE type = D3D12_COMMAND_LIST_TYPE_DIRECT) const;
 
+    /**
+     * Get the allocator for placed buffer resources. Valid types are:
+     * - D3D12_HEAP_TYPE_DEFAULT: GPU local buffers.
+     * - D3D12_HEAP_TYPE_UPLOAD : CPU writable buffers.
+     */
+    std::shared_ptr<HeapAllocator> GetBufferAllocator(D3D12_HEAP_TYPE type = D3D12_HEAP_TYPE_DEFAULT) const;
+
+    /**
+     * Get the pool that packs the vertex and index data of meshes into shared buffers.
+     * The stale ranges of the pool are released with the stale heap allocations.
+     */
+    std::shared_ptr<MeshBufferPool> GetMeshBufferPool() const;
+
+    /**
+     * Get the cache that is used to share root signatures with the same description.
+     */
+    std::shared_ptr<RootSignatureCache> GetRootSignatureCache() const;
+
+    /**
+     * Get the cache that is used to share pipeline states and to persist
+     * compiled pipeline states between runs of the application.
+     */
+    std::shared_ptr<PipelineStateCache> GetPipelineStateCache() const;
+
+    /**
+     * Get the thread pool that is used for background work
+     * (for example, pipeline state compilation).
+     */
+    std::shared_ptr<ThreadPool> GetThreadPool() const;
+
+    /**
+     * Get the service that recompiles shaders when their source files change
+     * and swaps in the rebuilt pipelines at the start of each frame.
+     */
+    std::shared_ptr<ShaderReloader> GetShaderReloader() const;
+
+    /**
+     * Get the job system that is used to split the work of a frame
+     * (for example, in Game::OnUpdate or Game::OnRender) over the CPU cores.
+     * Jobs can only be waited for on the main thread or inside other jobs.
+     */
+    std::shared_ptr<JobSystem> GetJobSystem() const;
+
     // Flush all command queues.
+    // Stale heap allocations are released after the queues are flushed
+    // and the heap allocators are defragmented (see HeapAllocator::Defragment).
     void Flush();
 
+    /**
+     * End the current frame (called by Window::Present). The frame has
+     * completed when the direct command queue reaches fenceValue.
+     */
+    void EndFrame(uint64_t fenceValue);
+
+    /**
+     * Release the stale allocations (and the stale mesh buffer ranges) of the
+     * frames that have completed on the GPU. Called by the window every frame,
+     * after it waited for the frames in flight.
+     */
+    void ReleaseStaleAllocations();
+
     Microsoft::WRL::ComPtr<ID3D12DescriptorHeap> CreateDescriptorHeap(UINT numDescriptors, D3D12_DESCRIPTOR_HEAP_TYPE type);
     UINT GetDescriptorHandleIncrementSize(D3D12_DESCRIPTOR_HEAP_TYPE type) const;
 
+    // The number of the current frame (the number of frames that have ended).
+    // Allocations that are freed in a frame are stale until the frame has completed.
     static uint64_t GetFrameCount()
     {
         return ms_FrameCount;
@@ -97,7 +197,7 @@ public:
 
 protected:
     // Create an application instance.
-    Application(HINSTANCE hInst);
+    Application(HINSTANCE hInst, std::unique_ptr<Platform> platform);
     // Destroy the application instance and all windows associated with this application.
     virtual ~Application();
 
@@ -112,15 +212,45 @@ private:
     // The application instance handle that this application was created with.
     HINSTANCE m_hInstance;
 
+    std::unique_ptr<Platform> m_Platform;
+    std::unique_ptr<FrameCapture> m_FrameCapture;
+
     Microsoft::WRL::ComPtr<IDXGIAdapter4> m_dxgiAdapter;
     Microsoft::WRL::ComPtr<ID3D12Device2> m_d3d12Device;
 
+    std::shared_ptr<HeapAllocator> m_DefaultBufferAllocator;
+    std::shared_ptr<HeapAllocator> m_UploadBufferAllocator;
+    // Declared after the upload allocator and before the objects that use it.
+    std::unique_ptr<D3D12Device> m_Device;
+
     std::shared_ptr<CommandQueue> m_DirectCommandQueue;
     std::shared_ptr<CommandQueue> m_ComputeCommandQueue;
     std::shared_ptr<CommandQueue> m_CopyCommandQueue;
 
+    std::unique_ptr<GpuProfiler> m_GpuProfiler;
+
+    // Declared after the heap allocators so its pages are released first.
+    std::shared_ptr<MeshBufferPool> m_MeshBufferPool;
+
+    std::shared_ptr<RootSignatureCache> m_RootSignatureCache;
+    std::shared_ptr<PipelineStateCache> m_PipelineStateCache;
+    std::shared_ptr<ShaderReloader> m_ShaderReloader;
+    std::shared_ptr<JobSystem> m_JobSystem;
+
+    // Declared last so the worker threads are joined before the
+    // objects they use are destroyed.
+    std::shared_ptr<ThreadPool> m_ThreadPool;
+
     bool m_TearingSupported;
 
+    // The fence values of the frames that have not completed on the GPU.
+    struct FrameFence
+    {
+        uint64_t FrameNumber;
+        uint64_t FenceValue;
+    };
+    std::queue<FrameFence> m_FrameFences;
+
     static uint64_t ms_FrameCount;
 };
 
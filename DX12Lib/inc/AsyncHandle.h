@@ -0,0 +1,75 @@
+#pragma once
+
+#include <chrono>
+#include <future>
+
+/**
+ * A handle to the result of an asynchronous operation (for example, a pipeline
+ * state that is compiled on the ThreadPool).
+ *
+ * The render loop can poll the handle every frame and use a fallback
+ * until the result is ready. Handles can be copied; all copies refer
+ * to the same result.
+ */
+template<typename T>
+class AsyncHandle
+{
+public:
+    AsyncHandle() = default;
+
+    explicit AsyncHandle(std::future<T>&& future)
+        : m_Future(future.share())
+    {}
+
+    explicit AsyncHandle(std::shared_future<T> future)
+        : m_Future(std::move(future))
+    {}
+
+    // Create a handle to a result that is already available.
+    static AsyncHandle MakeReady(T value)
+    {
+        std::promise<T> promise;
+        promise.set_value(std::move(value));
+        return AsyncHandle(promise.get_future());
+    }
+
+    // Check if the handle refers to an operation.
+    bool IsValid() const
+    {
+        return m_Future.valid();
+    }
+
+    // Check if the result is available without blocking.
+    bool IsReady() const
+    {
+        return m_Future.valid() &&
+            m_Future.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+    }
+
+    // Block until the result is available.
+    void Wait() const
+    {
+        m_Future.wait();
+    }
+
+    /**
+     * Get the result. Blocks until the result is available.
+     * If the operation failed, the exception of the operation is rethrown.
+     */
+    const T& Get() const
+    {
+        return m_Future.get();
+    }
+
+    /**
+     * Get the result if it is available, otherwise the fallback.
+     * If the operation failed, the exception of the operation is rethrown.
+     */
+    T GetOr(const T& fallback) const
+    {
+        return IsReady() ? m_Future.get() : fallback;
+    }
+
+private:
+    std::shared_future<T> m_Future;
+};
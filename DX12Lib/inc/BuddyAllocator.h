@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstdint>
+#include <set>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * A device independent buddy allocator that manages offsets in a memory range.
+ *
+ * The range is split into power of two sized blocks. Every block is aligned
+ * to its own size, so an allocation with a (power of two) alignment
+ * requirement is satisfied by using a block that is at least as large as the
+ * alignment. This matches the placement alignment classes of D3D12 heaps
+ * (64KB for buffers and textures, 4MB for MSAA textures).
+ *
+ * The allocator only deals with offsets, it does not own any memory.
+ */
+class BuddyAllocator
+{
+public:
+    // Returned from Allocate if the allocation could not be satisfied.
+    static constexpr uint64_t InvalidOffset = ~0ull;
+
+    /**
+     * @param size The size of the managed range. Must be a power of two
+     * multiple of minBlockSize.
+     * @param minBlockSize The size of the smallest block. Must be a power of two.
+     */
+    BuddyAllocator(uint64_t size, uint64_t minBlockSize);
+
+    /**
+     * Allocate a block that can hold sizeInBytes with the requested alignment.
+     * @returns The offset of the block or InvalidOffset if there is no
+     * free block large enough to satisfy the request.
+     */
+    uint64_t Allocate(uint64_t sizeInBytes, uint64_t alignment = 0);
+
+    /**
+     * Return a block back to the allocator. Free buddies are merged.
+     */
+    void Free(uint64_t offset);
+
+    /**
+     * Check to see if the allocator has a free block that is large enough
+     * to satisfy the request.
+     */
+    bool HasSpace(uint64_t sizeInBytes, uint64_t alignment = 0) const;
+
+    // Get the size of the block that is used to satisfy the request.
+    uint64_t GetBlockSize(uint64_t sizeInBytes, uint64_t alignment = 0) const;
+
+    // Get the size of an allocated block.
+    uint64_t GetAllocationSize(uint64_t offset) const;
+
+    uint64_t GetSize() const;
+    uint64_t GetMinBlockSize() const;
+    uint64_t GetFreeSize() const;
+    uint64_t GetLargestFreeBlockSize() const;
+    uint32_t GetNumAllocations() const;
+    bool IsEmpty() const;
+
+    /**
+     * A measure of the external fragmentation of the free space in the range
+     * [0...1]. 0 means all free space is a single block, values close to 1
+     * mean the free space is scattered across many small blocks.
+     */
+    float GetFragmentation() const;
+
+private:
+    // Level 0 is the block that spans the entire range.
+    uint32_t GetLevel(uint64_t blockSize) const;
+    uint64_t GetLevelBlockSize(uint32_t level) const;
+
+    uint64_t m_Size;
+    uint64_t m_MinBlockSize;
+    uint64_t m_FreeSize;
+    uint32_t m_NumLevels;
+
+    // Free blocks per level, sorted by offset so that the lowest address is
+    // always used first. This keeps allocations packed at the start of the range.
+    std::vector< std::set<uint64_t> > m_FreeBlocks;
+
+    // The level of each allocated block by offset.
+    std::unordered_map<uint64_t, uint32_t> m_Allocations;
+};
@@ -0,0 +1,366 @@
+#pragma once
+
+/**
+ * CommandList class encapsulates a ID3D12GraphicsCommandList2 interface.
+ * The CommandList class provides additional functionality that makes working with
+ * DirectX 12 applications easier:
+ *   * Resource transitions are recorded with a ResourceStateTracker.
+ *   * Dynamic vertex, index and constant buffer data is staged in an UploadBuffer.
+ *   * Descriptors are staged in DynamicDescriptorHeaps.
+ *   * Pipeline state, root signatures, vertex/index buffers, viewports and scissor
+ *     rectangles are cached and redundant calls on the command list are dropped.
+ *   * Objects used on the command list are kept alive until the command list
+ *     has finished executing on the command queue.
+ */
+
+#include <CommandListStateCache.h>
+#include <D3D12Device.h>
+
+#include <d3d12.h>
+#include <wrl.h>
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+class DynamicDescriptorHeap;
+class ResourceStateTracker;
+class RootSignature;
+class UploadBuffer;
+
+class CommandList
+{
+public:
+    // Counters for the state changes that were dropped because the
+    // state was already bound on the command list.
+    using Statistics = CommandListStateCache::Statistics;
+
+    // Created by the CommandQueue. The device must be a D3D12Device.
+    CommandList(Device& device, Device::CommandListType type);
+    virtual ~CommandList();
+
+    /**
+     * Get the type of command list.
+     */
+    D3D12_COMMAND_LIST_TYPE GetCommandListType() const
+    {
+        return m_d3d12CommandListType;
+    }
+
+    /**
+     * Get direct access to the ID3D12GraphicsCommandList2 interface.
+     * State that is set directly on the command list is not cached
+     * by the CommandList.
+     */
+    Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList2> GetGraphicsCommandList() const
+    {
+        return m_d3d12CommandList;
+    }
+
+    /**
+     * Transition a resource to a particular state.
+     *
+     * @param resource The resource to transition.
+     * @param stateAfter The state to transition the resource to. The before state is resolved by the resource state tracker.
+     * @param subresource The subresource to transition. By default, this is D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES which indicates that all subresources are transitioned to the same state.
+     * @param flushBarriers Force flush any barriers. Resource barriers need to be flushed before a command (draw, dispatch, or copy) that expects the resource to be in a particular state can run.
+     */
+    void TransitionBarrier(Microsoft::WRL::ComPtr<ID3D12Resource> resource, D3D12_RESOURCE_STATES stateAfter, UINT subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES, bool flushBarriers = false);
+
+    /**
+     * Add a UAV barrier to ensure that any writes to a resource have completed
+     * before reading from the resource.
+     *
+     * @param resource The resource to add a UAV barrier for.
+     * @param flushBarriers Force flush any barriers.
+     */
+    void UAVBarrier(Microsoft::WRL::ComPtr<ID3D12Resource> resource, bool flushBarriers = false);
+
+    /**
+     * Add an aliasing barrier to indicate a transition between usages of two
+     * different resources that occupy the same space in a heap.
+     *
+     * @param beforeResource The resource that currently occupies the heap.
+     * @param afterResource The resource that will occupy the space in the heap.
+     */
+    void AliasingBarrier(Microsoft::WRL::ComPtr<ID3D12Resource> beforeResource, Microsoft::WRL::ComPtr<ID3D12Resource> afterResource, bool flushBarriers = false);
+
+    /**
+     * Flush any barriers that have been pushed to the command list.
+     */
+    void FlushResourceBarriers();
+
+    /**
+     * Copy resources.
+     */
+    void CopyResource(Microsoft::WRL::ComPtr<ID3D12Resource> dstRes, Microsoft::WRL::ComPtr<ID3D12Resource> srcRes);
+
+    /**
+     * Copy the contents of a CPU buffer to a GPU buffer.
+     * The data is staged in the upload buffer of the command list.
+     * The destination buffer is transitioned to the COPY_DEST state.
+     */
+    void CopyBuffer(ID3D12Resource* dstBuffer, uint64_t dstOffset, size_t bufferSize, const void* bufferData);
+
+    /**
+     * Set the current primitive topology for the rendering pipeline.
+     */
+    void SetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY primitiveTopology);
+
+    /**
+     * Set a vertex buffer view on the input assembler.
+     */
+    void SetVertexBuffer(uint32_t slot, const D3D12_VERTEX_BUFFER_VIEW& vertexBufferView);
+
+    /**
+     * Set dynamic vertex buffer data to the rendering pipeline.
+     */
+    void SetDynamicVertexBuffer(uint32_t slot, size_t numVertices, size_t vertexSize, const void* vertexBufferData);
+    template<typename T>
+    void SetDynamicVertexBuffer(uint32_t slot, const std::vector<T>& vertexBufferData)
+    {
+        SetDynamicVertexBuffer(slot, vertexBufferData.size(), sizeof(T), vertexBufferData.data());
+    }
+
+    /**
+     * Bind the index buffer to the rendering pipeline.
+     */
+    void SetIndexBuffer(const D3D12_INDEX_BUFFER_VIEW& indexBufferView);
+
+    /**
+     * Bind dynamic index buffer data to the rendering pipeline.
+     */
+    void SetDynamicIndexBuffer(size_t numIndicies, DXGI_FORMAT indexFormat, const void* indexBufferData);
+    template<typename T>
+    void SetDynamicIndexBuffer(const std::vector<T>& indexBufferData)
+    {
+        static_assert(sizeof(T) == 2 || sizeof(T) == 4);
+
+        DXGI_FORMAT indexFormat = (sizeof(T) == 2) ? DXGI_FORMAT_R16_UINT : DXGI_FORMAT_R32_UINT;
+        SetDynamicIndexBuffer(indexBufferData.size(), indexFormat, indexBufferData.data());
+    }
+
+    /**
+     * Set a dynamic constant buffer data to an inline descriptor in the root
+     * signature.
+     */
+    void SetGraphicsDynamicConstantBuffer(uint32_t rootParameterIndex, size_t sizeInBytes, const void* bufferData);
+    template<typename T>
+    void SetGraphicsDynamicConstantBuffer(uint32_t rootParameterIndex, const T& data)
+    {
+        SetGraphicsDynamicConstantBuffer(rootParameterIndex, sizeof(T), &data);
+    }
+
+    /**
+     * Set a set of 32-bit constants on the graphics pipeline.
+     */
+    void SetGraphics32BitConstants(uint32_t rootParameterIndex, uint32_t numConstants, const void* constants);
+    template<typename T>
+    void SetGraphics32BitConstants(uint32_t rootParameterIndex, const T& constants)
+    {
+        static_assert(sizeof(T) % sizeof(uint32_t) == 0, "Size of type must be a multiple of 4 bytes");
+        SetGraphics32BitConstants(rootParameterIndex, sizeof(T) / sizeof(uint32_t), &constants);
+    }
+
+    /**
+     * Set a set of 32-bit constants on the compute pipeline.
+     */
+    void SetCompute32BitConstants(uint32_t rootParameterIndex, uint32_t numConstants, const void* constants);
+    template<typename T>
+    void SetCompute32BitConstants(uint32_t rootParameterIndex, const T& constants)
+    {
+        static_assert(sizeof(T) % sizeof(uint32_t) == 0, "Size of type must be a multiple of 4 bytes");
+        SetCompute32BitConstants(rootParameterIndex, sizeof(T) / sizeof(uint32_t), &constants);
+    }
+
+    /**
+     * Set viewports.
+     */
+    void SetViewport(const D3D12_VIEWPORT& viewport);
+    void SetViewports(const std::vector<D3D12_VIEWPORT>& viewports);
+
+    /**
+     * Set scissor rects.
+     */
+    void SetScissorRect(const D3D12_RECT& scissorRect);
+    void SetScissorRects(const std::vector<D3D12_RECT>& scissorRects);
+
+    /**
+     * Set the pipeline state object on the command list.
+     */
+    void SetPipelineState(Microsoft::WRL::ComPtr<ID3D12PipelineState> pipelineState);
+
+    /**
+     * Set the current root signature on the command list.
+     */
+    void SetGraphicsRootSignature(const RootSignature& rootSignature);
+    void SetComputeRootSignature(const RootSignature& rootSignature);
+
+    /**
+     * Set the SRV on the graphics pipeline.
+     * The resource is transitioned to stateAfter and the descriptor is staged
+     * in the dynamic descriptor heap.
+     */
+    void SetShaderResourceView(
+        uint32_t rootParameterIndex,
+        uint32_t descriptorOffset,
+        Microsoft::WRL::ComPtr<ID3D12Resource> resource,
+        D3D12_CPU_DESCRIPTOR_HANDLE srv,
+        D3D12_RESOURCE_STATES stateAfter = D3D12_RESOURCE_STATE_PIXEL_SHADER_RESOURCE | D3D12_RESOURCE_STATE_NON_PIXEL_SHADER_RESOURCE,
+        UINT subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES);
+
+    /**
+     * Set the UAV on the graphics pipeline.
+     */
+    void SetUnorderedAccessView(
+        uint32_t rootParameterIndex,
+        uint32_t descriptorOffset,
+        Microsoft::WRL::ComPtr<ID3D12Resource> resource,
+        D3D12_CPU_DESCRIPTOR_HANDLE uav,
+        D3D12_RESOURCE_STATES stateAfter = D3D12_RESOURCE_STATE_UNORDERED_ACCESS,
+        UINT subresource = D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES);
+
+    /**
+     * Set the render targets for the graphics rendering pipeline.
+     * The render target and depth-stencil resources must be transitioned
+     * to the correct states before drawing.
+     */
+    void SetRenderTargets(uint32_t numRenderTargets, const D3D12_CPU_DESCRIPTOR_HANDLE* renderTargets, const D3D12_CPU_DESCRIPTOR_HANDLE* depthStencil);
+
+    /**
+     * Clear a render target view.
+     */
+    void ClearRenderTargetView(D3D12_CPU_DESCRIPTOR_HANDLE rtv, const float clearColor[4]);
+
+    /**
+     * Clear depth/stencil view.
+     */
+    void ClearDepthStencilView(D3D12_CPU_DESCRIPTOR_HANDLE dsv, D3D12_CLEAR_FLAGS clearFlags, float depth = 1.0f, uint8_t stencil = 0);
+
+    /**
+     * Draw geometry.
+     */
+    void Draw(uint32_t vertexCount, uint32_t instanceCount = 1, uint32_t startVertex = 0, uint32_t startInstance = 0);
+    void DrawIndexed(uint32_t indexCount, uint32_t instanceCount = 1, uint32_t startIndex = 0, int32_t baseVertex = 0, uint32_t startInstance = 0);
+
+    /**
+     * Dispatch a compute shader.
+     */
+    void Dispatch(uint32_t numGroupsX, uint32_t numGroupsY = 1, uint32_t numGroupsZ = 1);
+
+    /**
+     * Write a timestamp to a query (see GpuProfiler).
+     * Pending resource barriers are flushed first so they are timed with the
+     * commands that were recorded before the query.
+     */
+    void EndQuery(ID3D12QueryHeap* queryHeap, D3D12_QUERY_TYPE type, uint32_t index);
+
+    /**
+     * Copy the results of a range of queries to a buffer.
+     */
+    void ResolveQueryData(ID3D12QueryHeap* queryHeap, D3D12_QUERY_TYPE type, uint32_t startIndex, uint32_t numQueries,
+        ID3D12Resource* destinationBuffer, uint64_t destinationOffset);
+
+    /**
+     * Get the state change counters. The counters accumulate over all uses
+     * of the command list (they are not cleared when the command list is reset).
+     */
+    const Statistics& GetStatistics() const
+    {
+        return m_StateCache.GetStatistics();
+    }
+
+    /**
+     * Clear the state change counters.
+     */
+    void ResetStatistics()
+    {
+        m_StateCache.ResetStatistics();
+    }
+
+    /***************************************************************************
+     * Methods defined below are only intended to be used by internal classes. *
+     ***************************************************************************/
+
+    /**
+     * Close the command list.
+     * Used by the command queue.
+     *
+     * @param pendingCommandList The command list that is used to execute pending
+     * resource barriers (if any) for this command list.
+     *
+     * @return true if there are any pending resource barriers that need to be
+     * processed.
+     */
+    bool Close(CommandList& pendingCommandList);
+    // Just close the command list. This is useful for pending command lists.
+    void Close();
+
+    /**
+     * Reset the command list. This should only be called by the CommandQueue
+     * before the command list is returned from CommandQueue::GetCommandList.
+     */
+    void Reset();
+
+    // The command list that is executed on the command queue of the device.
+    Device::CommandList& GetDeviceCommandList() const;
+
+    /**
+     * Release tracked objects. Useful if the swap chain needs to be resized.
+     */
+    void ReleaseTrackedObjects();
+
+    /**
+     * Set the currently bound descriptor heap.
+     * Only called when the DynamicDescriptorHeap class switches to a new descriptor heap.
+     */
+    void SetDescriptorHeap(D3D12_DESCRIPTOR_HEAP_TYPE heapType, ID3D12DescriptorHeap* heap);
+
+private:
+    // ID3D12GraphicsCommandList::SetGraphicsRootDescriptorTable or SetComputeRootDescriptorTable.
+    using SetRootDescriptorTableFunction = void (STDMETHODCALLTYPE ID3D12GraphicsCommandList::*)(UINT, D3D12_GPU_DESCRIPTOR_HANDLE);
+
+    // Parse the descriptor tables of the root signature for the dynamic descriptor heaps.
+    void ParseRootSignature(const RootSignature& rootSignature);
+
+    // Commit the staged descriptors of the dynamic descriptor heaps before a draw or dispatch.
+    void CommitStagedDescriptors(SetRootDescriptorTableFunction setRootDescriptorTable);
+
+    // Keep an object alive until the command list has finished executing.
+    void TrackObject(Microsoft::WRL::ComPtr<ID3D12Object> object);
+
+    // Binds the current descriptor heaps to the command list.
+    void BindDescriptorHeaps();
+
+    D3D12_COMMAND_LIST_TYPE m_d3d12CommandListType;
+    // Owns the command allocator and the command list.
+    std::shared_ptr<D3D12Device::CommandList> m_DeviceCommandList;
+    Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList2> m_d3d12CommandList;
+
+    // Resource created in an upload heap. Useful for drawing of dynamic geometry
+    // or for uploading constant buffer data that changes every draw call.
+    std::unique_ptr<UploadBuffer> m_UploadBuffer;
+
+    // Resource state tracker is used by the command list to track (per command list)
+    // the current state of a resource. The resource state tracker also tracks the
+    // global state of a resource in order to minimize resource state transitions.
+    std::unique_ptr<ResourceStateTracker> m_ResourceStateTracker;
+
+    // The dynamic descriptor heap allows for descriptors to be staged before
+    // being committed to the command list. Dynamic descriptors need to be
+    // committed before a Draw or Dispatch.
+    std::unique_ptr<DynamicDescriptorHeap> m_DynamicDescriptorHeap[D3D12_DESCRIPTOR_HEAP_TYPE_NUM_TYPES];
+
+    // Keep track of the currently bound state (including the descriptor heaps)
+    // to avoid redundant calls on the command list.
+    CommandListStateCache m_StateCache;
+
+    // Objects that are being referenced by a command list that is "in-flight" on
+    // the command-queue cannot be deleted. To ensure objects are not deleted
+    // until the command list is finished executing, a reference to the object
+    // is stored. The referenced objects are released when the command list is
+    // reset.
+    using TrackedObjects = std::vector< Microsoft::WRL::ComPtr<ID3D12Object> >;
+
+    TrackedObjects m_TrackedObjects;
+};
@@ -0,0 +1,131 @@
+#pragma once
+
+#include <cstdint>
+
+/**
+ * Caches the state that is bound on a command list so redundant state changes
+ * can be dropped before they reach the command list (see CommandList).
+ *
+ * Each Set method returns true if the state changed and must be set on the
+ * command list, or false (and counts the redundant call) if the state is
+ * already bound.
+ *
+ * The cache does not depend on Direct3D. Objects (pipeline states, root
+ * signatures and descriptor heaps) are opaque pointers and the views have
+ * the same layout as the D3D12 structures they mirror.
+ */
+class CommandListStateCache
+{
+public:
+    // Matches D3D12_IA_VERTEX_INPUT_RESOURCE_SLOT_COUNT.
+    static constexpr uint32_t MaxVertexBuffers = 32;
+    // Matches D3D12_VIEWPORT_AND_SCISSORRECT_OBJECT_COUNT_PER_PIPELINE.
+    static constexpr uint32_t MaxViewports = 16;
+    // Matches D3D12_DESCRIPTOR_HEAP_TYPE_NUM_TYPES.
+    static constexpr uint32_t NumDescriptorHeapTypes = 4;
+
+    // Matches D3D12_VERTEX_BUFFER_VIEW.
+    struct VertexBufferView
+    {
+        uint64_t BufferLocation;
+        uint32_t SizeInBytes;
+        uint32_t StrideInBytes;
+    };
+
+    // Matches D3D12_INDEX_BUFFER_VIEW.
+    struct IndexBufferView
+    {
+        uint64_t BufferLocation;
+        uint32_t SizeInBytes;
+        uint32_t Format;
+    };
+
+    // Matches D3D12_VIEWPORT.
+    struct Viewport
+    {
+        float TopLeftX;
+        float TopLeftY;
+        float Width;
+        float Height;
+        float MinDepth;
+        float MaxDepth;
+    };
+
+    // Matches D3D12_RECT.
+    struct Rect
+    {
+        int32_t Left;
+        int32_t Top;
+        int32_t Right;
+        int32_t Bottom;
+    };
+
+    // Counters for the state changes that were dropped because the
+    // state was already bound on the command list.
+    struct Statistics
+    {
+        uint32_t NumRedundantPipelineStates;
+        uint32_t NumRedundantRootSignatures;
+        uint32_t NumRedundantPrimitiveTopologies;
+        uint32_t NumRedundantVertexBuffers;
+        uint32_t NumRedundantIndexBuffers;
+        uint32_t NumRedundantViewports;
+        uint32_t NumRedundantScissorRects;
+        uint32_t NumRedundantDescriptorHeaps;
+        uint32_t NumDraws;
+        uint32_t NumDispatches;
+    };
+
+    CommandListStateCache();
+
+    bool SetPipelineState(const void* pipelineState);
+    bool SetGraphicsRootSignature(const void* rootSignature);
+    bool SetComputeRootSignature(const void* rootSignature);
+    bool SetPrimitiveTopology(uint32_t primitiveTopology);
+    bool SetVertexBuffer(uint32_t slot, const VertexBufferView& vertexBufferView);
+    bool SetIndexBuffer(const IndexBufferView& indexBufferView);
+    bool SetViewports(uint32_t numViewports, const Viewport* viewports);
+    bool SetScissorRects(uint32_t numScissorRects, const Rect* scissorRects);
+    bool SetDescriptorHeap(uint32_t heapType, void* descriptorHeap);
+
+    // The descriptor heap that is bound for a descriptor heap type (or nullptr).
+    void* GetDescriptorHeap(uint32_t heapType) const;
+
+    // Count the draws and dispatches on the command list.
+    void RecordDraw();
+    void RecordDispatch();
+
+    /**
+     * Forget all of the cached state. Must be called when the command list is
+     * reset. The statistics are kept.
+     */
+    void Reset();
+
+    /**
+     * The statistics accumulate over all uses of the command list until they are reset.
+     */
+    const Statistics& GetStatistics() const;
+    void ResetStatistics();
+
+private:
+    const void* m_PipelineState;
+    const void* m_GraphicsRootSignature;
+    const void* m_ComputeRootSignature;
+    uint32_t m_PrimitiveTopology;
+
+    VertexBufferView m_VertexBufferViews[MaxVertexBuffers];
+    // Each bit set represents a vertex buffer slot with a valid view.
+    uint32_t m_VertexBufferBitMask;
+
+    IndexBufferView m_IndexBufferView;
+    bool m_IndexBufferValid;
+
+    Viewport m_Viewports[MaxViewports];
+    uint32_t m_NumViewports;
+    Rect m_ScissorRects[MaxViewports];
+    uint32_t m_NumScissorRects;
+
+    void* m_DescriptorHeaps[NumDescriptorHeapTypes];
+
+    Statistics m_Statistics;
+};
@@ -1,52 +1,217 @@
 #pragma once
 
-#include <d3d12.h>
-#include <wrl.h>
+#include <Device.h>
+#include <FrameCapture.h>
+#include <Profiler.h>
+#include <ResourceStateTracker.h>
+
 #include <cstdint>
+#include <memory>
 #include <queue>
+#include <vector>
+
+class CommandList;
 
-class CommandQueue
+/**
+ * Executes the command lists of the engine on a command queue of the device
+ * and reuses the command lists when the GPU has finished them.
+ *
+ * Pending resource barriers of a command list are resolved against the global
+ * resource state and executed on a separate command list before the command list.
+ *
+ * The queue only uses the Device interface, so the submission runs on a
+ * D3D12Device or on the NullDevice. The application uses CommandQueue
+ * (with the CommandList of the engine). EngineCommandList must provide:
+ *
+ *   * EngineCommandList(Device& device, Device::CommandListType type)
+ *   * bool Close(EngineCommandList& pendingCommandList), which closes the command
+ *     list and records its pending barriers on the pending command list. Returns
+ *     true if there are pending barriers.
+ *   * void Close(), which closes a pending command list.
+ *   * void Reset(), which resets the command list for recording.
+ *   * Device::CommandList& GetDeviceCommandList() const
+ */
+template<typename EngineCommandList>
+class BasicCommandQueue
 {
 public:
-    CommandQueue(Microsoft::WRL::ComPtr<ID3D12Device2> device, D3D12_COMMAND_LIST_TYPE type);
-    virtual ~CommandQueue();
+    BasicCommandQueue(Device& device, Device::CommandListType type)
+        : m_Device(device)
+        , m_CommandListType(type)
+        , m_FenceValue(0)
+    {
+        m_DeviceCommandQueue = device.CreateCommandQueue(type);
+        m_Fence = device.CreateFence(m_FenceValue);
+    }
+
+    virtual ~BasicCommandQueue() {}
 
     // Get an available command list from the command queue.
-    Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList2> GetCommandList();
+    std::shared_ptr<EngineCommandList> GetCommandList()
+    {
+        std::shared_ptr<EngineCommandList> commandList;
+
+        ReleaseCompletedCommandLists();
+
+        if (!m_AvailableCommandLists.empty())
+        {
+            commandList = m_AvailableCommandLists.front();
+            m_AvailableCommandLists.pop();
+
+            // The command list has finished executing. Release the objects
+            // it referenced and reset it for recording.
+            commandList->Reset();
+        }
+        else
+        {
+            commandList = std::make_shared<EngineCommandList>(m_Device, m_CommandListType);
+        }
+
+        return commandList;
+    }
 
     // Execute a command list.
+    // Pending resource barriers of the command list are resolved against the global
+    // resource state and executed on a separate command list before the command list.
     // Returns the fence value to wait for for this command list.
-    uint64_t ExecuteCommandList(Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList2> commandList);
+    uint64_t ExecuteCommandList(std::shared_ptr<EngineCommandList> commandList)
+    {
+        return ExecuteCommandLists(std::vector< std::shared_ptr<EngineCommandList> >({ commandList }));
+    }
+
+    uint64_t ExecuteCommandLists(const std::vector< std::shared_ptr<EngineCommandList> >& commandLists)
+    {
+        PROFILE_FUNCTION();
+
+        // Command lists that need to be put back on the command list queue.
+        std::vector< std::shared_ptr<EngineCommandList> > toBeQueued;
+        toBeQueued.reserve(commandLists.size() * 2);        // 2x since each command list will have a pending command list.
+
+        // Command lists that need to be executed.
+        std::vector<Device::CommandList*> deviceCommandLists;
+        deviceCommandLists.reserve(commandLists.size() * 2); // 2x since each command list will have a pending command list.
+
+        FrameCapture* frameCapture = m_Device.GetFrameCapture();
+
+        uint64_t fenceValue;
+        {
+            // The global resource state must stay locked until the command lists have been
+            // submitted so that the state is consistent with the order of execution on the queue.
+            ResourceStateTracker::ScopedLock resourceStateLock;
+
+            for (const std::shared_ptr<EngineCommandList>& commandList : commandLists)
+            {
+                std::shared_ptr<EngineCommandList> pendingCommandList = GetCommandList();
+                bool hasPendingBarriers = commandList->Close(*pendingCommandList);
+                pendingCommandList->Close();
+
+                if (frameCapture)
+                {
+                    frameCapture->Record(FrameCapture::Call::ExecuteCommandList, { static_cast<uint64_t>(m_CommandListType) });
+                }
+
+                // If there are no pending barriers on the pending command list, there is no reason to
+                // execute an empty command list on the command queue.
+                if (hasPendingBarriers)
+                {
+                    deviceCommandLists.push_back(&pendingCommandList->GetDeviceCommandList());
+                }
+                deviceCommandLists.push_back(&commandList->GetDeviceCommandList());
+
+                toBeQueued.push_back(pendingCommandList);
+                toBeQueued.push_back(commandList);
+            }
 
-    uint64_t Signal();
-    bool IsFenceComplete(uint64_t fenceValue);
-    void WaitForFenceValue(uint64_t fenceValue);
-    void Flush();
+            m_DeviceCommandQueue->ExecuteCommandLists(static_cast<uint32_t>(deviceCommandLists.size()), deviceCommandLists.data());
+            fenceValue = Signal();
+        }
 
-    Microsoft::WRL::ComPtr<ID3D12CommandQueue> GetD3D12CommandQueue() const;
-protected:
+        // Queue command lists for reuse.
+        for (const std::shared_ptr<EngineCommandList>& commandList : toBeQueued)
+        {
+            m_InFlightCommandLists.push(CommandListEntry{ fenceValue, commandList });
+        }
 
-    Microsoft::WRL::ComPtr<ID3D12CommandAllocator> CreateCommandAllocator();
-    Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList2> CreateCommandList(Microsoft::WRL::ComPtr<ID3D12CommandAllocator> allocator);
+        return fenceValue;
+    }
+
+    uint64_t Signal()
+    {
+        uint64_t fenceValue = ++m_FenceValue;
+        m_DeviceCommandQueue->Signal(*m_Fence, fenceValue);
+        return fenceValue;
+    }
+
+    bool IsFenceComplete(uint64_t fenceValue)
+    {
+        return m_Fence->GetCompletedValue() >= fenceValue;
+    }
+
+    uint64_t GetCompletedFenceValue() const
+    {
+        return m_Fence->GetCompletedValue();
+    }
+
+    void WaitForFenceValue(uint64_t fenceValue)
+    {
+        PROFILE_FUNCTION();
+
+        m_Fence->Wait(fenceValue);
+    }
+
+    void Flush()
+    {
+        WaitForFenceValue(Signal());
+    }
+
+    // The GPU waits until the command lists that were executed on the other queue have finished.
+    void Wait(const BasicCommandQueue& other)
+    {
+        m_DeviceCommandQueue->Wait(*other.m_Fence, other.m_FenceValue);
+    }
+
+    Device::CommandListType GetCommandListType() const
+    {
+        return m_CommandListType;
+    }
+
+    const std::shared_ptr<Device::CommandQueue>& GetDeviceCommandQueue() const
+    {
+        return m_DeviceCommandQueue;
+    }
 
 private:
-    // Keep track of command allocators that are "in-flight"
-    struct CommandAllocatorEntry
+    // Keep track of command lists that are "in-flight".
+    // The command lists (and the objects they reference) are kept alive
+    // until the fence value has been reached.
+    struct CommandListEntry
     {
         uint64_t fenceValue;
-        Microsoft::WRL::ComPtr<ID3D12CommandAllocator> commandAllocator;
+        std::shared_ptr<EngineCommandList> commandList;
     };
 
-    using CommandAllocatorQueue = std::queue<CommandAllocatorEntry>;
-    using CommandListQueue = std::queue< Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList2> >;
+    using CommandListEntryQueue = std::queue<CommandListEntry>;
+    using CommandListQueue = std::queue< std::shared_ptr<EngineCommandList> >;
 
-    D3D12_COMMAND_LIST_TYPE                     m_CommandListType;
-    Microsoft::WRL::ComPtr<ID3D12Device2>       m_d3d12Device;
-    Microsoft::WRL::ComPtr<ID3D12CommandQueue>  m_d3d12CommandQueue;
-    Microsoft::WRL::ComPtr<ID3D12Fence>         m_d3d12Fence;
-    HANDLE                                      m_FenceEvent;
+    // Move command lists whose fence value has been reached to the available command lists.
+    void ReleaseCompletedCommandLists()
+    {
+        while (!m_InFlightCommandLists.empty() && IsFenceComplete(m_InFlightCommandLists.front().fenceValue))
+        {
+            m_AvailableCommandLists.push(m_InFlightCommandLists.front().commandList);
+            m_InFlightCommandLists.pop();
+        }
+    }
+
+    Device&                                     m_Device;
+    Device::CommandListType                     m_CommandListType;
+    std::shared_ptr<Device::CommandQueue>       m_DeviceCommandQueue;
+    std::shared_ptr<Device::Fence>              m_Fence;
     uint64_t                                    m_FenceValue;
 
-    CommandAllocatorQueue                       m_CommandAllocatorQueue;
-    CommandListQueue                            m_CommandListQueue;
-};
\ No newline at end of file
+    CommandListEntryQueue                       m_InFlightCommandLists;
+    CommandListQueue                            m_AvailableCommandLists;
+};
+
+// The command queue of the application (the CommandList of the engine is only available on Windows).
+using CommandQueue = BasicCommandQueue<CommandList>;
@@ -0,0 +1,136 @@
+#pragma once
+
+#include <Device.h>
+#include <HeapAllocation.h>
+
+#include <d3d12.h>
+#include <wrl.h>
+
+#include <cstdint>
+#include <memory>
+
+class FrameCapture;
+class HeapAllocator;
+
+/**
+ * Implements the Device interface on a Direct3D 12 device.
+ *
+ * Upload buffers are placed in the upload heap allocator of the application
+ * and the calls of the descriptor allocators, upload buffers and dynamic
+ * descriptor heaps are recorded in the frame capture of the application.
+ */
+class D3D12Device : public Device
+{
+public:
+    class DescriptorHeap : public Device::DescriptorHeap
+    {
+    public:
+        DescriptorHeap(Microsoft::WRL::ComPtr<ID3D12DescriptorHeap> descriptorHeap);
+
+        DescriptorHeapType GetType() const override;
+        uint32_t GetNumDescriptors() const override;
+        uint64_t GetCPUDescriptorHandleForHeapStart() const override;
+        uint64_t GetGPUDescriptorHandleForHeapStart() const override;
+
+        ID3D12DescriptorHeap* GetD3D12DescriptorHeap() const;
+
+    private:
+        Microsoft::WRL::ComPtr<ID3D12DescriptorHeap> m_d3d12DescriptorHeap;
+        D3D12_DESCRIPTOR_HEAP_DESC m_Desc;
+    };
+
+    class Resource : public Device::Resource
+    {
+    public:
+        // The resource is mapped until it is destroyed.
+        explicit Resource(HeapAllocation&& allocation);
+        ~Resource();
+
+        uint64_t GetSize() const override;
+        uint64_t GetGPUVirtualAddress() const override;
+        void* Map() const override;
+
+        ID3D12Resource* GetD3D12Resource() const;
+
+    private:
+        HeapAllocation m_Allocation;
+        void* m_CPUPtr;
+    };
+
+    class Fence : public Device::Fence
+    {
+    public:
+        Fence(Microsoft::WRL::ComPtr<ID3D12Fence> fence);
+        ~Fence();
+
+        uint64_t GetCompletedValue() override;
+        void Wait(uint64_t value) override;
+
+        ID3D12Fence* GetD3D12Fence() const;
+
+    private:
+        Microsoft::WRL::ComPtr<ID3D12Fence> m_d3d12Fence;
+        HANDLE m_FenceEvent;
+    };
+
+    class CommandList : public Device::CommandList
+    {
+    public:
+        // Create a command list (and its command allocator) that is open for recording.
+        CommandList(Microsoft::WRL::ComPtr<ID3D12Device2> device, CommandListType type);
+
+        CommandListType GetType() const override;
+        void Close() override;
+        void Reset() override;
+
+        Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList2> GetD3D12CommandList() const;
+
+    private:
+        CommandListType m_Type;
+        Microsoft::WRL::ComPtr<ID3D12CommandAllocator> m_d3d12CommandAllocator;
+        Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList2> m_d3d12CommandList;
+    };
+
+    class CommandQueue : public Device::CommandQueue
+    {
+    public:
+        CommandQueue(Microsoft::WRL::ComPtr<ID3D12CommandQueue> commandQueue, CommandListType type);
+
+        CommandListType GetType() const override;
+        // The command lists must be D3D12Device::CommandLists.
+        void ExecuteCommandLists(uint32_t numCommandLists, Device::CommandList* const* commandLists) override;
+        // The fence must be a D3D12Device::Fence.
+        void Signal(Device::Fence& fence, uint64_t value) override;
+        void Wait(Device::Fence& fence, uint64_t value) override;
+
+        Microsoft::WRL::ComPtr<ID3D12CommandQueue> GetD3D12CommandQueue() const;
+
+    private:
+        Microsoft::WRL::ComPtr<ID3D12CommandQueue> m_d3d12CommandQueue;
+        CommandListType m_Type;
+    };
+
+    D3D12Device(Microsoft::WRL::ComPtr<ID3D12Device2> device, std::shared_ptr<HeapAllocator> uploadAllocator, FrameCapture& frameCapture);
+
+    std::shared_ptr<Device::DescriptorHeap> CreateDescriptorHeap(DescriptorHeapType type, uint32_t numDescriptors, bool shaderVisible) override;
+    uint32_t GetDescriptorHandleIncrementSize(DescriptorHeapType type) const override;
+
+    void CopyDescriptorsSimple(uint32_t numDescriptors, uint64_t destDescriptor, uint64_t srcDescriptor, DescriptorHeapType type) const override;
+    void CopyDescriptors(uint32_t numDescriptors, uint64_t destDescriptor, const uint64_t* srcDescriptors, DescriptorHeapType type) const override;
+
+    std::shared_ptr<Device::Resource> CreateUploadBuffer(uint64_t sizeInBytes) override;
+    std::shared_ptr<Device::Fence> CreateFence(uint64_t initialValue) override;
+    std::shared_ptr<Device::CommandQueue> CreateCommandQueue(CommandListType type) override;
+    std::shared_ptr<Device::CommandList> CreateCommandList(CommandListType type) override;
+
+    // The frame count of the application (see Application::GetFrameCount).
+    uint64_t GetFrameCount() const override;
+    FrameCapture* GetFrameCapture() const override;
+
+    Microsoft::WRL::ComPtr<ID3D12Device2> GetD3D12Device() const;
+
+private:
+    Microsoft::WRL::ComPtr<ID3D12Device2> m_d3d12Device;
+    std::shared_ptr<HeapAllocator> m_UploadAllocator;
+    FrameCapture& m_FrameCapture;
+};
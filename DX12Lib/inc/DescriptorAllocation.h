@@ -1,12 +1,15 @@
 #pragma once
 
-#include <d3d12.h>
-
 #include <cstdint>
 #include <memory>
 
 class DescriptorAllocatorPage;
 
+/**
+ * A range of descriptors that was allocated from a DescriptorAllocatorPage.
+ * The descriptors are returned to the page when the allocation is destroyed.
+ * The descriptor handles are CPU descriptor handles (D3D12_CPU_DESCRIPTOR_HANDLE::ptr).
+ */
 class DescriptorAllocation
 {
 public:
@@ -14,7 +17,7 @@ public:
     DescriptorAllocation();
 
     DescriptorAllocation( 
-        D3D12_CPU_DESCRIPTOR_HANDLE descriptor, 
+        uint64_t descriptor,
         uint32_t numHandles,
         uint32_t descriptorSize, 
         std::shared_ptr<DescriptorAllocatorPage> page );
@@ -34,7 +37,7 @@ public:
     bool IsNull() const;
 
     // Get a descriptor at a particular offset in the allocation.
-    D3D12_CPU_DESCRIPTOR_HANDLE GetDescriptorHandle( uint32_t offset = 0 ) const;
+    uint64_t GetDescriptorHandle( uint32_t offset = 0 ) const;
 
     // Get the number of (consecutive) handles for this allocation.
     uint32_t GetNumHandles() const;
@@ -48,7 +51,7 @@ private:
     void Free();
 
     // The base descriptor.
-    D3D12_CPU_DESCRIPTOR_HANDLE m_Descriptor;
+    uint64_t m_Descriptor;
     // The number of descriptors in this allocation.
     uint32_t m_NumHandles;
     // The offset to the next descriptor.
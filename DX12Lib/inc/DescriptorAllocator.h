@@ -1,8 +1,7 @@
 #pragma once
 
 #include <DescriptorAllocation.h>
-
-#include <d3dx12.h>
+#include <Device.h>
 
 #include <cstdint>
 #include <mutex>
@@ -12,10 +11,15 @@
 
 class DescriptorAllocatorPage;
 
+/**
+ * Allocates CPU visible descriptors from pages of descriptor heaps.
+ * Freed descriptors are stale until the frame they were freed in has
+ * completed (see ReleaseStaleDescriptors).
+ */
 class DescriptorAllocator
 {
 public:
-    DescriptorAllocator(D3D12_DESCRIPTOR_HEAP_TYPE type, uint32_t numDescriptorsPerHeap = 256u);
+    DescriptorAllocator(Device& device, Device::DescriptorHeapType type, uint32_t numDescriptorsPerHeap = 256u);
     virtual ~DescriptorAllocator();
 
     /**
@@ -27,7 +31,8 @@ public:
     DescriptorAllocation Allocate(uint32_t numDescriptors = 1);
 
     /**
-     * When the frame has completed, the stale descriptors can be released.
+     * When the frame has completed, the stale descriptors that were freed
+     * in or before the frame can be released.
      */
     void ReleaseStaleDescriptors( uint64_t frameNumber );
 
@@ -37,7 +42,8 @@ private:
     // Create a new heap with a specific number of descriptors.
     std::shared_ptr<DescriptorAllocatorPage> CreateAllocatorPage();
 
-    D3D12_DESCRIPTOR_HEAP_TYPE m_HeapType;
+    Device& m_Device;
+    Device::DescriptorHeapType m_HeapType;
     uint32_t m_NumDescriptorsPerHeap;
 
     DescriptorHeapPool m_HeapPool;
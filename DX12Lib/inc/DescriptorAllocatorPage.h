@@ -1,10 +1,8 @@
 #pragma once
 
 #include <DescriptorAllocation.h>
+#include <Device.h>
 
-#include <d3dx12.h>
-
-#include <wrl.h>
 #include <map>
 #include <memory>
 #include <queue>
@@ -13,9 +11,9 @@
 class DescriptorAllocatorPage : public std::enable_shared_from_this<DescriptorAllocatorPage>
 {
 public:
-    DescriptorAllocatorPage( D3D12_DESCRIPTOR_HEAP_TYPE type, uint32_t numDescriptors );
+    DescriptorAllocatorPage( Device& device, Device::DescriptorHeapType type, uint32_t numDescriptors );
 
-    D3D12_DESCRIPTOR_HEAP_TYPE GetHeapType() const;
+    Device::DescriptorHeapType GetHeapType() const;
 
     /**
     * Check to see if this descriptor page has a contiguous block of descriptors
@@ -37,21 +35,22 @@ public:
 
     /**
     * Return a descriptor back to the heap.
-    * @param frameNumber Stale descriptors are not freed directly, but put
-    * on a stale allocations queue. Stale allocations are returned to the heap
-    * using the DescriptorAllocatorPage::ReleaseStaleAllocations method.
+    * Stale descriptors are not freed directly, but put on a stale allocations
+    * queue with the current frame number of the device. Stale allocations are
+    * returned to the heap using the DescriptorAllocatorPage::ReleaseStaleDescriptors method.
     */
-    void Free( DescriptorAllocation&& descriptorHandle, uint64_t frameNumber );
+    void Free( DescriptorAllocation&& descriptorHandle );
 
     /**
-    * Returned the stale descriptors back to the descriptor heap.
+    * Return the stale descriptors that were freed in or before the
+    * completed frame back to the descriptor heap.
     */
     void ReleaseStaleDescriptors( uint64_t frameNumber );
 
 protected:
 
     // Compute the offset of the descriptor handle from the start of the heap.
-    uint32_t ComputeOffset( D3D12_CPU_DESCRIPTOR_HANDLE handle );
+    uint32_t ComputeOffset( uint64_t handle );
 
     // Adds a new block to the free list.
     void AddNewBlock( uint32_t offset, uint32_t numDescriptors );
@@ -107,9 +106,10 @@ private:
     FreeListBySize m_FreeListBySize;
     StaleDescriptorQueue m_StaleDescriptors;
 
-    Microsoft::WRL::ComPtr<ID3D12DescriptorHeap> m_d3d12DescriptorHeap;
-    D3D12_DESCRIPTOR_HEAP_TYPE m_HeapType;
-    CD3DX12_CPU_DESCRIPTOR_HANDLE m_BaseDescriptor;
+    Device& m_Device;
+    std::shared_ptr<Device::DescriptorHeap> m_DescriptorHeap;
+    Device::DescriptorHeapType m_HeapType;
+    uint64_t m_BaseDescriptor;
     uint32_t m_DescriptorHandleIncrementSize;
     uint32_t m_NumDescriptorsInHeap;
     uint32_t m_NumFreeHandles;
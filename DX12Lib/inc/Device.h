@@ -0,0 +1,137 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+
+class FrameCapture;
+
+/**
+ * The device interface that is used by the descriptor allocators, the upload
+ * buffer, the dynamic descriptor heap and the command queue, so they can run
+ * on a Direct3D 12 device (D3D12Device) or without a GPU (NullDevice).
+ *
+ * The interface does not depend on Direct3D. The enumerations use the same
+ * values as the D3D12 enumerations they mirror and descriptor handles and GPU
+ * virtual addresses are plain integers (D3D12_CPU_DESCRIPTOR_HANDLE::ptr,
+ * D3D12_GPU_DESCRIPTOR_HANDLE::ptr and D3D12_GPU_VIRTUAL_ADDRESS).
+ */
+class Device
+{
+public:
+    // Matches D3D12_DESCRIPTOR_HEAP_TYPE.
+    enum class DescriptorHeapType : uint32_t
+    {
+        CBV_SRV_UAV = 0,
+        Sampler = 1,
+        RTV = 2,
+        DSV = 3,
+        NumTypes = 4,
+    };
+
+    // Matches D3D12_COMMAND_LIST_TYPE.
+    enum class CommandListType : uint32_t
+    {
+        Direct = 0,
+        Bundle = 1,
+        Compute = 2,
+        Copy = 3,
+    };
+
+    class DescriptorHeap
+    {
+    public:
+        virtual ~DescriptorHeap() = default;
+
+        virtual DescriptorHeapType GetType() const = 0;
+        virtual uint32_t GetNumDescriptors() const = 0;
+
+        virtual uint64_t GetCPUDescriptorHandleForHeapStart() const = 0;
+        // Only valid for shader visible heaps (0 otherwise).
+        virtual uint64_t GetGPUDescriptorHandleForHeapStart() const = 0;
+    };
+
+    // A buffer in CPU writable (upload) memory.
+    class Resource
+    {
+    public:
+        virtual ~Resource() = default;
+
+        virtual uint64_t GetSize() const = 0;
+        virtual uint64_t GetGPUVirtualAddress() const = 0;
+
+        // The CPU address of the buffer. The buffer stays mapped while it is alive.
+        virtual void* Map() const = 0;
+    };
+
+    class Fence
+    {
+    public:
+        virtual ~Fence() = default;
+
+        virtual uint64_t GetCompletedValue() = 0;
+
+        // Block until the value is completed. The value must have been
+        // signaled on a command queue.
+        virtual void Wait(uint64_t value) = 0;
+    };
+
+    // The commands of a command list are recorded by the engine command list (see CommandQueue).
+    class CommandList
+    {
+    public:
+        virtual ~CommandList() = default;
+
+        virtual CommandListType GetType() const = 0;
+
+        // Close the command list for execution.
+        virtual void Close() = 0;
+        // Reset a closed command list for recording. The command list must have finished executing.
+        virtual void Reset() = 0;
+    };
+
+    class CommandQueue
+    {
+    public:
+        virtual ~CommandQueue() = default;
+
+        virtual CommandListType GetType() const = 0;
+
+        // Execute closed command lists (in order).
+        virtual void ExecuteCommandLists(uint32_t numCommandLists, CommandList* const* commandLists) = 0;
+
+        // Set the fence to a value when the GPU has finished the commands that were executed before.
+        virtual void Signal(Fence& fence, uint64_t value) = 0;
+
+        // The GPU waits until the fence has reached the value before it executes the next command lists.
+        virtual void Wait(Fence& fence, uint64_t value) = 0;
+    };
+
+    virtual ~Device() = default;
+
+    virtual std::shared_ptr<DescriptorHeap> CreateDescriptorHeap(DescriptorHeapType type, uint32_t numDescriptors, bool shaderVisible) = 0;
+    virtual uint32_t GetDescriptorHandleIncrementSize(DescriptorHeapType type) const = 0;
+
+    // Copy a contiguous range of descriptors.
+    virtual void CopyDescriptorsSimple(uint32_t numDescriptors, uint64_t destDescriptor, uint64_t srcDescriptor, DescriptorHeapType type) const = 0;
+    // Copy single descriptors to a contiguous range of descriptors.
+    virtual void CopyDescriptors(uint32_t numDescriptors, uint64_t destDescriptor, const uint64_t* srcDescriptors, DescriptorHeapType type) const = 0;
+
+    virtual std::shared_ptr<Resource> CreateUploadBuffer(uint64_t sizeInBytes) = 0;
+    virtual std::shared_ptr<Fence> CreateFence(uint64_t initialValue) = 0;
+
+    virtual std::shared_ptr<CommandQueue> CreateCommandQueue(CommandListType type) = 0;
+    // The command list is open for recording.
+    virtual std::shared_ptr<CommandList> CreateCommandList(CommandListType type) = 0;
+
+    /**
+     * The number of the current frame. Descriptors that are freed in a frame
+     * are stale until the frame has completed (see DescriptorAllocator::ReleaseStaleDescriptors).
+     */
+    virtual uint64_t GetFrameCount() const = 0;
+
+    // The recorder of the engine level calls, or nullptr if the calls are not captured.
+    virtual FrameCapture* GetFrameCapture() const
+    {
+        return nullptr;
+    }
+};
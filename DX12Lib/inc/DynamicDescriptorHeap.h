@@ -1,22 +1,40 @@
 #pragma once
 
-#include <d3dx12.h>
-#include <wrl.h>
+#include <Device.h>
+
 #include <cstdint>
 #include <memory>
 #include <queue>
 #include <functional>
 
-class CommandList;
-class RootSignature;
-
+/**
+ * Stages CPU visible descriptors and copies them to shader visible descriptor
+ * heaps before a draw or dispatch.
+ *
+ * The dynamic descriptor heap does not depend on Direct3D. The descriptor
+ * heaps and descriptor tables are set on the command list with the functions
+ * that are passed to CommitStagedDescriptors (see CommandList).
+ */
 class DynamicDescriptorHeap
 {
 public:
+    // Set a (shader visible) descriptor heap on the command list.
+    using SetDescriptorHeapFunction = std::function<void(Device::DescriptorHeap& descriptorHeap)>;
+    // Set the GPU descriptor handle of a descriptor table on the command list.
+    using SetDescriptorTableFunction = std::function<void(uint32_t rootParameterIndex, uint64_t baseDescriptor)>;
+
+    /**
+     * The maximum number of descriptor tables per root signature.
+     * A 32-bit mask is used to keep track of the root parameter indices that
+     * are descriptor tables.
+     */
+    static constexpr uint32_t MaxDescriptorTables = 32;
+
     DynamicDescriptorHeap(
-        D3D12_DESCRIPTOR_HEAP_TYPE heapType,
+        Device& device,
+        Device::DescriptorHeapType heapType,
         uint32_t numDescriptorsPerHeap = 1024);
-    
+
     virtual ~DynamicDescriptorHeap();
 
     /**
@@ -26,73 +44,72 @@ public:
     */
     void StageDescriptors(
         uint32_t rootParameterIndex,
-        uint32_t offset, 
-        uint32_t numDescriptors, 
-        const D3D12_CPU_DESCRIPTOR_HANDLE srcDescriptors);
+        uint32_t offset,
+        uint32_t numDescriptors,
+        uint64_t srcDescriptors);
 
     /**
     * Copy all of the staged descriptors to the GPU visible descriptor heap and
     * bind the descriptor heap and the descriptor tables to the command list.
-    * The passed-in function object is used to set the GPU visible descriptors
-    * on the command list. Two possible functions are:
+    * The passed-in function objects are used to set the GPU visible descriptor
+    * heap and descriptors on the command list. Two possible table functions are:
     *   * Before a draw    : ID3D12GraphicsCommandList::SetGraphicsRootDescriptorTable
     *   * Before a dispatch: ID3D12GraphicsCommandList::SetComputeRootDescriptorTable
-    * 
+    *
     * Since the DynamicDescriptorHeap can't know which function will be used, it must
     * be passed as an argument to the function.
     */
-    void CommitStagedDescriptors( CommandList& commandList, std::function<void(ID3D12GraphicsCommandList*, UINT, D3D12_GPU_DESCRIPTOR_HANDLE)> setFunc );
-    void CommitStagedDescriptorsForDraw(CommandList& commandList);
-    void CommitStagedDescriptorsForDispatch(CommandList& commandList);
+    void CommitStagedDescriptors(const SetDescriptorHeapFunction& setDescriptorHeap, const SetDescriptorTableFunction& setDescriptorTable);
 
     /**
     * Copies a single CPU visible descriptor to a GPU visible descriptor heap.
     * This is useful for the
     *   * ID3D12GraphicsCommandList::ClearUnorderedAccessViewFloat
     *   * ID3D12GraphicsCommandList::ClearUnorderedAccessViewUint
-    * methods which require both a CPU and GPU visible descriptors for a UAV 
+    * methods which require both a CPU and GPU visible descriptors for a UAV
     * resource.
-    * 
-    * @param commandList The command list is required in case the GPU visible
-    * descriptor heap needs to be updated on the command list.
-    * @param cpuDescriptor The CPU descriptor to copy into a GPU visible 
+    *
+    * @param setDescriptorHeap Sets the GPU visible descriptor heap on the
+    * command list in case it needs to be updated.
+    * @param cpuDescriptor The CPU descriptor to copy into a GPU visible
     * descriptor heap.
-    * 
+    *
     * @return The GPU visible descriptor.
     */
-    D3D12_GPU_DESCRIPTOR_HANDLE CopyDescriptor( CommandList& commandList, D3D12_CPU_DESCRIPTOR_HANDLE cpuDescriptor);
+    uint64_t CopyDescriptor(const SetDescriptorHeapFunction& setDescriptorHeap, uint64_t cpuDescriptor);
 
     /**
     * Parse the root signature to determine which root parameters contain
     * descriptor tables and determine the number of descriptors needed for
     * each table.
+    *
+    * @param descriptorTableBitMask The root parameter indices that are descriptor
+    * tables of the heap type of this dynamic descriptor heap (see RootSignature::GetDescriptorTableBitMask).
+    * @param numDescriptors The number of descriptors of each root parameter
+    * (at least numParameters values, see RootSignature::GetNumDescriptors).
     */
-    void ParseRootSignature( const RootSignature& rootSignature);
+    void ParseRootSignature(uint32_t descriptorTableBitMask, const uint32_t* numDescriptors, uint32_t numParameters);
 
     /**
     * Reset used descriptors. This should only be done if any descriptors
-    * that are being referenced by a command list has finished executing on the 
+    * that are being referenced by a command list has finished executing on the
     * command queue.
     */
     void Reset();
 
 private:
     // Request a descriptor heap if one is available.
-    Microsoft::WRL::ComPtr<ID3D12DescriptorHeap> RequestDescriptorHeap();
+    std::shared_ptr<Device::DescriptorHeap> RequestDescriptorHeap();
     // Create a new descriptor heap of no descriptor heap is available.
-    Microsoft::WRL::ComPtr<ID3D12DescriptorHeap> CreateDescriptorHeap();
+    std::shared_ptr<Device::DescriptorHeap> CreateDescriptorHeap();
+
+    // Request a new descriptor heap and set it on the command list.
+    void SetNewDescriptorHeap(const SetDescriptorHeapFunction& setDescriptorHeap);
 
     // Compute the number of stale descriptors that need to be copied
     // to GPU visible descriptor heap.
     uint32_t ComputeStaleDescriptorCount() const;
 
-    /**
-     * The maximum number of descriptor tables per root signature.
-     * A 32-bit mask is used to keep track of the root parameter indices that
-     * are descriptor tables.
-     */
-    static const uint32_t MaxDescriptorTables = 32;
-
     /**
      * A structure that represents a descriptor table entry in the root signature.
      */
@@ -113,17 +130,19 @@ private:
         // The number of descriptors in this descriptor table.
         uint32_t NumDescriptors;
         // The pointer to the descriptor in the descriptor handle cache.
-        D3D12_CPU_DESCRIPTOR_HANDLE* BaseDescriptor;
+        uint64_t* BaseDescriptor;
     };
 
-    // Describes the type of descriptors that can be staged using this 
+    Device& m_Device;
+
+    // Describes the type of descriptors that can be staged using this
     // dynamic descriptor heap.
     // Valid values are:
-    //   * D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV
-    //   * D3D12_DESCRIPTOR_HEAP_TYPE_SAMPLER
-    // This parameter also determines the type of GPU visible descriptor heap to 
+    //   * Device::DescriptorHeapType::CBV_SRV_UAV
+    //   * Device::DescriptorHeapType::Sampler
+    // This parameter also determines the type of GPU visible descriptor heap to
     // create.
-    D3D12_DESCRIPTOR_HEAP_TYPE m_DescriptorHeapType;
+    Device::DescriptorHeapType m_DescriptorHeapType;
 
     // The number of descriptors to allocate in new GPU visible descriptor heaps.
     uint32_t m_NumDescriptorsPerHeap;
@@ -132,7 +151,7 @@ private:
     uint32_t m_DescriptorHandleIncrementSize;
 
     // The descriptor handle cache.
-    std::unique_ptr<D3D12_CPU_DESCRIPTOR_HANDLE[]> m_DescriptorHandleCache;
+    std::unique_ptr<uint64_t[]> m_DescriptorHandleCache;
 
     // Descriptor handle cache per descriptor table.
     DescriptorTableCache m_DescriptorTableCache[MaxDescriptorTables];
@@ -142,21 +161,18 @@ private:
     uint32_t m_DescriptorTableBitMask;
 
     // Each bit set in the bit mask represents a descriptor table
-    // in the root signature that has changed since the last time the 
+    // in the root signature that has changed since the last time the
     // descriptors were copied.
     uint32_t m_StaleDescriptorTableBitMask;
 
-    using DescriptorHeapPool = std::queue< Microsoft::WRL::ComPtr<ID3D12DescriptorHeap> >;
+    using DescriptorHeapPool = std::queue< std::shared_ptr<Device::DescriptorHeap> >;
 
     DescriptorHeapPool m_DescriptorHeapPool;
     DescriptorHeapPool m_AvailableDescriptorHeaps;
 
-    Microsoft::WRL::ComPtr<ID3D12DescriptorHeap> m_CurrentDescriptorHeap;
-    CD3DX12_GPU_DESCRIPTOR_HANDLE m_CurrentGPUDescriptorHandle;
-    CD3DX12_CPU_DESCRIPTOR_HANDLE m_CurrentCPUDescriptorHandle;
+    std::shared_ptr<Device::DescriptorHeap> m_CurrentDescriptorHeap;
+    uint64_t m_CurrentGPUDescriptorHandle;
+    uint64_t m_CurrentCPUDescriptorHandle;
 
     uint32_t m_NumFreeHandles;
 };
-
-
-
@@ -0,0 +1,169 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+/**
+ * Dispatches events to the listeners that are subscribed to the type of the event.
+ *
+ * Each event type has its own list of listeners. A listener is a function
+ * pointer and a context pointer (no std::function, no shared_ptr), so
+ * dispatching an event to a listener is a single indirect call. The lists
+ * are kept in subscription order.
+ *
+ * Subscribe returns a handle that stays valid until it is passed to
+ * Unsubscribe. The bus does not own the listeners: a listener must be
+ * unsubscribed before its context is destroyed. Listeners can subscribe
+ * and unsubscribe while an event is dispatched. A listener that is
+ * unsubscribed during a dispatch is not called again, and a listener that
+ * is subscribed during a dispatch receives the next event.
+ *
+ * The bus is not synchronized and must be used from one thread
+ * (for the window events, the thread that runs the application loop).
+ */
+class EventBus
+{
+public:
+    // A handle to a subscribed listener. InvalidListener is never returned by Subscribe.
+    using ListenerHandle = uint64_t;
+    static constexpr ListenerHandle InvalidListener = 0;
+
+    template<typename Event>
+    using Callback = void (*)(void* context, Event& e);
+
+    EventBus();
+
+    EventBus(const EventBus&) = delete;
+    EventBus& operator=(const EventBus&) = delete;
+
+    template<typename Event>
+    ListenerHandle Subscribe(Callback<Event> callback, void* context)
+    {
+        return AddListener(GetEventTypeId<Event>(), reinterpret_cast<GenericCallback>(callback), context);
+    }
+
+    /**
+     * Subscribe a member function of an object, for example:
+     *   bus.Subscribe<&CameraController::OnMouseMoved>(&cameraController);
+     * The event type is the parameter type of the member function.
+     */
+    template<auto Method, typename Object>
+    ListenerHandle Subscribe(Object* object)
+    {
+        using Event = typename MethodTraits<decltype(Method)>::Event;
+        return Subscribe<Event>([](void* context, Event& e)
+        {
+            (static_cast<Object*>(context)->*Method)(e);
+        }, object);
+    }
+
+    /**
+     * Remove a listener.
+     * @return false if the handle does not refer to a subscribed listener.
+     */
+    bool Unsubscribe(ListenerHandle handle);
+
+    // Dispatch an event to the listeners of its type.
+    template<typename Event>
+    void Publish(Event& e)
+    {
+        Publish(&e, 1);
+    }
+
+    /**
+     * Dispatch a batch of events of the same type. The listener list is looked
+     * up once for the batch. Each event is dispatched to all listeners before
+     * the next event (as if Publish was called for each event).
+     */
+    template<typename Event>
+    void Publish(Event* events, size_t numEvents)
+    {
+        uint32_t eventTypeId = GetEventTypeId<Event>();
+        if (eventTypeId >= m_ListenerLists.size() || m_ListenerLists[eventTypeId].NumListeners == 0)
+        {
+            return;
+        }
+
+        DispatchScope dispatchScope(*this);
+        for (size_t i = 0; i < numEvents; ++i)
+        {
+            // The list may grow while the event is dispatched (listeners are read by index).
+            size_t numListeners = m_ListenerLists[eventTypeId].Listeners.size();
+            for (size_t j = 0; j < numListeners; ++j)
+            {
+                Listener listener = m_ListenerLists[eventTypeId].Listeners[j];
+                if (listener.Callback)
+                {
+                    reinterpret_cast<Callback<Event>>(listener.Callback)(listener.Context, events[i]);
+                }
+            }
+        }
+    }
+
+    template<typename Event>
+    uint32_t GetNumListeners() const
+    {
+        uint32_t eventTypeId = GetEventTypeId<Event>();
+        return eventTypeId < m_ListenerLists.size() ? m_ListenerLists[eventTypeId].NumListeners : 0;
+    }
+
+private:
+    // The callbacks are stored without their event type (void (*)() is the
+    // function pointer type that can be cast to any other without a warning).
+    using GenericCallback = void (*)();
+
+    template<typename Method>
+    struct MethodTraits;
+
+    template<typename Object, typename EventType>
+    struct MethodTraits<void (Object::*)(EventType&)>
+    {
+        using Event = EventType;
+    };
+
+    struct Listener
+    {
+        // Null if the listener was unsubscribed during a dispatch.
+        GenericCallback Callback;
+        void* Context;
+        uint32_t Id;
+    };
+
+    struct ListenerList
+    {
+        std::vector<Listener> Listeners;
+        uint32_t NumListeners = 0;
+        // Listeners were unsubscribed during a dispatch.
+        bool HasRemovedListeners = false;
+    };
+
+    // The event type ids are shared by all buses (they index the listener lists).
+    static uint32_t AllocateEventTypeId();
+
+    template<typename Event>
+    static uint32_t GetEventTypeId()
+    {
+        static const uint32_t eventTypeId = AllocateEventTypeId();
+        return eventTypeId;
+    }
+
+    ListenerHandle AddListener(uint32_t eventTypeId, GenericCallback callback, void* context);
+
+    // Removes the listeners that were unsubscribed during the dispatch
+    // when the outermost dispatch ends (also if a listener throws).
+    class DispatchScope
+    {
+    public:
+        explicit DispatchScope(EventBus& eventBus);
+        ~DispatchScope();
+
+    private:
+        EventBus& m_EventBus;
+    };
+
+    std::vector<ListenerList> m_ListenerLists;
+    uint32_t m_NextListenerId;
+    uint32_t m_DispatchDepth;
+    bool m_HasRemovedListeners;
+};
@@ -48,6 +48,8 @@ public:
         , Shift( shift )
         , X( x )
         , Y( y )
+        , RelX( 0 )
+        , RelY( 0 )
     {}
 
     bool LeftButton;    // Is the left mouse button down?
@@ -163,13 +165,17 @@ class RenderEventArgs : public EventArgs
 {
 public:
     typedef EventArgs base;
-    RenderEventArgs( double fDeltaTime, double fTotalTime )
+    RenderEventArgs( double fDeltaTime, double fTotalTime, double fAlpha = 1.0 )
         : ElapsedTime( fDeltaTime )
         , TotalTime( fTotalTime )
+        , Alpha( fAlpha )
     {}
 
     double ElapsedTime;
     double TotalTime;
+    // The interpolation factor between the state before and after the last
+    // fixed update step (1 if the window does not use fixed update steps).
+    double Alpha;
 };
 
 class UserEventArgs : public EventArgs
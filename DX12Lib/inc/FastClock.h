@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstdint>
+
+/**
+ * A monotonic clock with a low overhead Now.
+ *
+ * On x86 CPUs with an invariant TSC (the time stamp counter runs at a constant
+ * rate in all power states and is synchronized between the cores), Now reads
+ * the TSC. The frequency of the TSC is calibrated against std::chrono::steady_clock
+ * over the time from the first use of the clock until the frequency is first
+ * needed. On other CPUs, Now reads std::chrono::steady_clock in nanoseconds.
+ * The source is selected when the clock is first used and never changes, so
+ * all ticks of a run can be compared with each other.
+ *
+ * Now returns integer ticks, so intervals can be accumulated without rounding
+ * and are only converted to seconds when they are read.
+ */
+class FastClock
+{
+public:
+    enum class Source
+    {
+        TSC,
+        SteadyClock,
+    };
+
+    // The time in ticks (of an unspecified epoch).
+    static uint64_t Now();
+
+    static Source GetSource();
+
+    // Whether the CPU has an invariant TSC.
+    static bool HasInvariantTSC();
+
+    // The number of ticks per second.
+    static double GetFrequency();
+    static double GetSecondsPerTick();
+
+    static double ToSeconds(uint64_t ticks);
+
+    // The time in seconds (of an unspecified epoch). Used as the real time clock of the platforms and the frame pacing.
+    static double GetSeconds();
+    static uint64_t ToNanoseconds(uint64_t ticks);
+};
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <filesystem>
+#include <memory>
+#include <vector>
+
+/**
+ * Watches directories for files that are written, created or renamed.
+ *
+ * Changes are collected by the operating system (ReadDirectoryChangesW on
+ * Windows, inotify on Linux) and returned by Poll, which never blocks, so
+ * the watcher can be polled from the render loop. The watcher does not
+ * depend on Direct3D.
+ */
+class FileWatcher
+{
+public:
+    FileWatcher();
+    virtual ~FileWatcher();
+
+    FileWatcher(const FileWatcher&) = delete;
+    FileWatcher& operator=(const FileWatcher&) = delete;
+
+    /**
+     * Watch the files in a directory (subdirectories are not watched).
+     * Adding a directory that is already watched has no effect.
+     *
+     * @return false if the directory could not be watched.
+     */
+    bool AddDirectory(const std::filesystem::path& directory);
+
+    /**
+     * Get the files that changed since the last call. Each file is only
+     * returned once, even if it was written multiple times.
+     */
+    std::vector<std::filesystem::path> Poll();
+
+private:
+    // The platform specific state (directory handles or inotify descriptors).
+    struct Platform;
+    std::unique_ptr<Platform> m_Platform;
+};
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <cstdint>
+
+/**
+ * Schedules fixed-duration simulation steps for a variable frame rate.
+ *
+ * The time between frames is added to an accumulator and a step is run for
+ * every full step duration in the accumulator. The remainder is used to
+ * interpolate between the last two simulated states when rendering (alpha).
+ *
+ * The number of steps per frame is limited. If the simulation can't keep up
+ * (or after a long stall, like a breakpoint), the time that can't be simulated
+ * is dropped instead of running more and more steps each frame.
+ *
+ * Like the FramePacer, the scheduler does not own a clock. The current time
+ * is passed in by the caller, so it can be driven by a simulated clock.
+ */
+class FixedStepScheduler
+{
+public:
+    struct Settings
+    {
+        // The number of simulation steps per second.
+        double StepsPerSecond = 60.0;
+        // The maximum number of steps that are run in a single frame.
+        uint32_t MaxStepsPerFrame = 4;
+    };
+
+    FixedStepScheduler();
+    explicit FixedStepScheduler(const Settings& settings);
+
+    const Settings& GetSettings() const;
+    void SetSettings(const Settings& settings);
+
+    /**
+     * Start a new frame.
+     * @param now The current time (in seconds).
+     * @return The number of steps to run in this frame.
+     */
+    uint32_t BeginFrame(double now);
+
+    /**
+     * Restart the accumulation at the next frame (for example, after the
+     * simulation was paused). The simulation time is kept.
+     */
+    void Reset();
+
+    // The duration of a step in seconds.
+    double GetStepDuration() const;
+
+    /**
+     * The interpolation factor between the state before and the state after the
+     * last step, in the range [0, 1).
+     */
+    double GetAlpha() const;
+
+    // The number of steps that have been scheduled.
+    uint64_t GetStepCount() const;
+
+    // The simulation time (the number of steps times the step duration).
+    double GetTime() const;
+
+    // The time (in seconds) that was dropped because the simulation could not keep up.
+    double GetDroppedTime() const;
+
+private:
+    // Keep less than a step in the accumulator.
+    void DropUnsimulatedTime();
+
+    Settings m_Settings;
+    double m_StepDuration;
+
+    double m_Accumulator;
+    uint64_t m_StepCount;
+    double m_DroppedTime;
+
+    bool m_HasPreviousFrame;
+    double m_PreviousFrameTime;
+};
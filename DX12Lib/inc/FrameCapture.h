@@ -0,0 +1,114 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <initializer_list>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * Records the engine level calls (descriptor allocations, upload buffer
+ * allocations, dynamic descriptor heap staging, command list commands and
+ * command list execution) of a number of frames into a compact binary stream.
+ *
+ * A capture can be replayed with the FrameReplayer on a NullDevice to measure
+ * the CPU cost of the calls without a GPU (see the FrameReplay tool).
+ *
+ * The capture does not depend on Direct3D. Each call is stored as a byte for
+ * the call type, followed by the number of arguments and the arguments as
+ * variable length (LEB128) integers.
+ */
+class FrameCapture
+{
+public:
+    // The arguments of each call are listed in order.
+    enum class Call : uint8_t
+    {
+        // heapType, numDescriptors, descriptor (the CPU handle of the allocation)
+        AllocateDescriptors,
+        // heapType, descriptor, frameNumber
+        FreeDescriptors,
+        // heapType, frameNumber
+        ReleaseStaleDescriptors,
+        // sizeInBytes, alignment
+        AllocateUpload,
+        ResetUploadBuffer,
+        // heapType, the number of descriptors of each root parameter
+        // (0 for parameters that are not descriptor tables of the heap type)
+        ParseRootSignature,
+        // heapType, rootParameterIndex, offset, numDescriptors
+        StageDescriptors,
+        // heapType
+        CommitStagedDescriptors,
+        // heapType
+        ResetDynamicDescriptorHeap,
+        // NullDevice::CommandType, the arguments of the command
+        Command,
+        // commandListType
+        ExecuteCommandList,
+        EndFrame,
+        NumCalls
+    };
+
+    struct CallRecord
+    {
+        Call Type;
+        // The arguments of the record in Stream::Arguments.
+        uint32_t FirstArgument;
+        uint32_t NumArguments;
+    };
+
+    // A decoded capture.
+    struct Stream
+    {
+        std::vector<CallRecord> Records;
+        std::vector<uint64_t> Arguments;
+        uint32_t NumFrames = 0;
+    };
+
+    FrameCapture();
+
+    /**
+     * Start recording the calls of the next numFrames frames.
+     * The capture is written to the file when the last frame ends.
+     */
+    void Begin(const std::string& fileName, uint32_t numFrames);
+
+    bool IsCapturing() const
+    {
+        return m_IsCapturing.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * Record a call. Can be called from any thread. Calls are ignored
+     * if no capture is in progress.
+     */
+    void Record(Call call, std::initializer_list<uint64_t> arguments);
+    void Record(Call call, const uint64_t* arguments, size_t numArguments);
+
+    /**
+     * Mark the end of a frame. Ends the capture after the last frame.
+     * @return false if the capture could not be written to the file.
+     */
+    bool EndFrame();
+
+    /**
+     * Decode a capture. Returns false if the data is not a valid capture.
+     */
+    static bool Decode(const std::vector<uint8_t>& data, Stream& stream);
+    static bool Load(const std::string& fileName, Stream& stream);
+
+    static const char* GetCallName(Call call);
+
+private:
+    void Write(Call call, const uint64_t* arguments, size_t numArguments);
+
+    std::atomic<bool> m_IsCapturing;
+
+    std::mutex m_Mutex;
+    std::vector<uint8_t> m_Data;
+    std::string m_FileName;
+    uint32_t m_NumFrames;
+    uint32_t m_FrameCount;
+};
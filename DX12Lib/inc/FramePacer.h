@@ -0,0 +1,131 @@
+#pragma once
+
+#include <cstdint>
+
+/**
+ * Frame pacing policy for a render window.
+ *
+ * The frame pacer decides how long the CPU has to wait before it is allowed
+ * to start recording the next frame. Two limits are applied:
+ *   * The number of frames that are queued on the GPU (frames in flight).
+ *   * A CPU frame-time budget (frame rate cap).
+ *
+ * The pacer does not own a clock or any GPU objects. All timestamps (in seconds)
+ * and fence values are passed in by the caller, so the policy can be driven
+ * by a simulated clock.
+ */
+class FramePacer
+{
+public:
+    // The maximum number of frames that can be tracked in flight.
+    static constexpr uint32_t MaxTrackedFrames = 16;
+    // The number of frame timings that are kept in the history.
+    static constexpr uint32_t TimingHistorySize = 128;
+
+    struct Settings
+    {
+        // The maximum number of frames the CPU may queue ahead of the GPU.
+        // Lower values reduce input latency at the cost of throughput.
+        uint32_t MaxFramesInFlight = 2;
+        // The maximum number of queued presents on the swapchain.
+        uint32_t MaxFrameLatency = 1;
+        // Block on the swapchain's frame latency waitable object before
+        // a new frame is started.
+        bool WaitableSwapChain = true;
+        // The sync interval to use when presenting with VSync enabled.
+        uint32_t SyncInterval = 1;
+        // The target CPU frame time in seconds. Use 0 to run unthrottled.
+        double TargetFrameTime = 0.0;
+    };
+
+    struct FrameTiming
+    {
+        // The frame number of this frame.
+        uint64_t FrameNumber = 0;
+        // The time the frame started recording (after all pacing waits).
+        double BeginTime = 0.0;
+        // The time between the start of the previous frame and this frame.
+        double FrameTime = 0.0;
+        // The time between BeginFrame and EndFrame.
+        double CpuTime = 0.0;
+        // The time spent waiting for the GPU to retire queued frames.
+        double GpuWaitTime = 0.0;
+        // The time spent waiting on the swapchain and the CPU frame-time budget.
+        double PacingWaitTime = 0.0;
+        // The number of frames that were queued on the GPU when the frame started.
+        uint32_t FramesInFlight = 0;
+    };
+
+    FramePacer();
+    explicit FramePacer(const Settings& settings);
+
+    const Settings& GetSettings() const;
+    void SetSettings(const Settings& settings);
+
+    /**
+     * Get the fence value that must be completed before the next frame
+     * can begin without exceeding the maximum number of frames in flight.
+     * @returns 0 if no wait is required.
+     */
+    uint64_t GetFenceValueToWait() const;
+
+    /**
+     * Get the number of submitted frames that have not been retired by the GPU.
+     * @param completedFenceValue The last completed fence value on the queue.
+     */
+    uint32_t GetFramesInFlight(uint64_t completedFenceValue) const;
+
+    /**
+     * Get the time (in seconds) the caller should wait before starting
+     * a new frame to respect the CPU frame-time budget.
+     */
+    double GetPacingDelay(double now) const;
+
+    /**
+     * Start a new frame. A frame that was started but not ended is discarded.
+     * @param now The current time (in seconds).
+     * @param gpuWaitTime The time spent waiting for frames in flight.
+     * @param pacingWaitTime The time spent waiting on the swapchain or frame-time budget.
+     * @param completedFenceValue The last completed fence value on the queue.
+     */
+    void BeginFrame(double now, double gpuWaitTime, double pacingWaitTime, uint64_t completedFenceValue);
+
+    /**
+     * End the current frame.
+     * @param now The current time (in seconds).
+     * @param fenceValue The fence value that is signaled when the GPU has finished the frame.
+     */
+    void EndFrame(double now, uint64_t fenceValue);
+
+    /**
+     * Reset the frame history. This should be done after the command queue
+     * was flushed (for example, when the swapchain is resized).
+     */
+    void Reset();
+
+    uint64_t GetFrameCount() const;
+
+    /**
+     * Get the timing of a previously completed frame.
+     * @param framesAgo 0 returns the last completed frame.
+     */
+    const FrameTiming& GetFrameTiming(uint32_t framesAgo = 0) const;
+
+    // The number of valid entries in the frame timing history.
+    uint32_t GetNumFrameTimings() const;
+
+private:
+    Settings m_Settings;
+
+    // Fence values of submitted frames, indexed by frame number.
+    uint64_t m_FrameFenceValues[MaxTrackedFrames];
+
+    FrameTiming m_TimingHistory[TimingHistorySize];
+    FrameTiming m_CurrentFrame;
+
+    // The number of frames that have been ended.
+    uint64_t m_FrameCount;
+    bool m_InFrame;
+    bool m_HasPreviousFrame;
+    double m_PreviousBeginTime;
+};
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <DescriptorAllocation.h>
+#include <DescriptorAllocator.h>
+#include <DynamicDescriptorHeap.h>
+#include <FrameCapture.h>
+#include <NullDevice.h>
+#include <UploadBuffer.h>
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <vector>
+
+/**
+ * Replays a FrameCapture on a NullDevice and measures the CPU time of each call.
+ *
+ * The calls are replayed on the engine's DescriptorAllocator, UploadBuffer and
+ * DynamicDescriptorHeap, which run on the NullDevice, so the measured times
+ * are the times of the engine code. The commands are recorded into a command
+ * list that is executed on a direct command queue (a direct queue accepts all
+ * commands).
+ *
+ * The engine uses a dynamic descriptor heap and an upload buffer for each
+ * command list. The replayer uses a single instance of each.
+ */
+class FrameReplayer
+{
+public:
+    struct Settings
+    {
+        // The defaults match the defaults of the DescriptorAllocator,
+        // UploadBuffer and DynamicDescriptorHeap.
+        uint32_t NumDescriptorsPerHeap = 256;
+        uint64_t UploadPageSize = 2 * 1024 * 1024;
+        uint32_t NumDynamicDescriptorsPerHeap = 1024;
+    };
+
+    struct CallStatistics
+    {
+        uint64_t Count = 0;
+        // Times in seconds.
+        double TotalTime = 0.0;
+        double MinTime = 0.0;
+        double MaxTime = 0.0;
+    };
+
+    struct Statistics
+    {
+        CallStatistics Calls[static_cast<size_t>(FrameCapture::Call::NumCalls)];
+        // The time of each replayed frame in seconds.
+        std::vector<double> FrameTimes;
+        // Calls that could not be replayed (for example, freeing descriptors
+        // that were allocated before the capture started).
+        uint64_t NumSkippedCalls = 0;
+    };
+
+    explicit FrameReplayer(NullDevice& device);
+    FrameReplayer(NullDevice& device, const Settings& settings);
+
+    /**
+     * Replay the calls of a capture. The state of the replayer (allocations,
+     * descriptor heaps and pages) is kept between replays and the statistics
+     * are accumulated.
+     */
+    void Replay(const FrameCapture::Stream& stream);
+
+    const Statistics& GetStatistics() const;
+
+private:
+    using Call = FrameCapture::Call;
+
+    static constexpr uint32_t NumHeapTypes = static_cast<uint32_t>(Device::DescriptorHeapType::NumTypes);
+
+    // Returns false if the call could not be replayed.
+    bool Execute(Call call, const uint64_t* arguments, uint32_t numArguments);
+
+    bool AllocateDescriptors(uint32_t heapType, uint32_t numDescriptors, uint64_t descriptor);
+    bool FreeDescriptors(uint32_t heapType, uint64_t descriptor, uint64_t frameNumber);
+    void ReleaseStaleDescriptors(uint32_t heapType, uint64_t frameNumber);
+    bool AllocateUpload(uint64_t sizeInBytes, uint64_t alignment);
+    void ResetUploadBuffer();
+    bool ParseRootSignature(uint32_t heapType, const uint64_t* numDescriptors, uint32_t numParameters);
+    bool StageDescriptors(uint32_t heapType, uint32_t rootParameterIndex, uint32_t offset, uint32_t numDescriptors);
+    void CommitStagedDescriptors(uint32_t heapType);
+    void ResetDynamicDescriptorHeap(uint32_t heapType);
+    bool RecordCommand(const uint64_t* arguments, uint32_t numArguments);
+    void ExecuteCommandList();
+
+    NullDevice& m_Device;
+    Settings m_Settings;
+
+    std::unique_ptr<DescriptorAllocator> m_DescriptorAllocators[NumHeapTypes];
+    // The allocations by the descriptor handle in the capture.
+    std::map<uint64_t, DescriptorAllocation> m_DescriptorAllocations[NumHeapTypes];
+
+    std::unique_ptr<DynamicDescriptorHeap> m_DynamicDescriptorHeaps[NumHeapTypes];
+    // The source of the staged descriptors.
+    std::shared_ptr<Device::DescriptorHeap> m_SourceDescriptorHeaps[NumHeapTypes];
+
+    std::unique_ptr<UploadBuffer> m_UploadBuffer;
+
+    std::shared_ptr<NullDevice::CommandQueue> m_CommandQueue;
+    std::shared_ptr<NullDevice::CommandList> m_CommandList;
+
+    DynamicDescriptorHeap::SetDescriptorHeapFunction m_SetDescriptorHeap;
+    DynamicDescriptorHeap::SetDescriptorTableFunction m_SetDescriptorTable;
+
+    Statistics m_Statistics;
+};
@@ -0,0 +1,129 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * Frame time statistics for a stream of frame times (see Window::GetRenderFrameStats).
+ *
+ * All samples since the last Reset are counted in a log-linear histogram
+ * (like an HDR histogram: the times below SubBucketCount microseconds have
+ * a bucket per microsecond and each power of two above is split into
+ * SubBucketCount / 2 buckets, so a percentile is accurate to within 1%). The last samples are
+ * also kept in a ring (a rolling window), which is used to detect hitches.
+ *
+ * The histogram and the ring are allocated once, so adding a sample never
+ * allocates. The statistics are not synchronized and must be used from
+ * one thread.
+ */
+class FrameStats
+{
+public:
+    static constexpr uint32_t SubBucketBits = 7;
+    static constexpr uint32_t SubBucketCount = 1u << SubBucketBits;
+    // Samples are counted in microseconds up to 2^MaxTimeBits microseconds (about 70 minutes).
+    static constexpr uint32_t MaxTimeBits = 32;
+    static constexpr uint32_t NumBuckets = (MaxTimeBits - SubBucketBits + 2) * (SubBucketCount / 2);
+
+    struct Settings
+    {
+        // The number of samples in the rolling window.
+        uint32_t NumRecentSamples = 240;
+        // A frame is a hitch if it takes longer than this factor times
+        // the average frame time of the rolling window.
+        double HitchFactor = 2.0;
+    };
+
+    struct Summary
+    {
+        uint64_t NumSamples = 0;
+        // The times in seconds.
+        double MinTime = 0.0;
+        double MaxTime = 0.0;
+        double AverageTime = 0.0;
+        double P50 = 0.0;
+        double P95 = 0.0;
+        double P99 = 0.0;
+    };
+
+    FrameStats();
+    explicit FrameStats(const Settings& settings);
+
+    const Settings& GetSettings() const;
+
+    // Add the time (in seconds) of a frame.
+    void AddSample(double time);
+
+    // Remove all samples (the hitch count is reset too).
+    void Reset();
+
+    // The statistics of all samples since the last Reset (the percentiles are read from the histogram).
+    Summary GetSummary() const;
+
+    // The statistics of the samples in the rolling window (the percentiles are exact).
+    Summary GetRecentSummary() const;
+
+    /**
+     * The time (in seconds) below which the given percentage of all samples falls.
+     * @param percentile The percentile in the range [0, 100].
+     */
+    double GetPercentile(double percentile) const;
+
+    // The number of frames that were detected as hitches since the last Reset.
+    uint64_t GetNumHitches() const;
+
+    // The number of samples in the rolling window.
+    uint32_t GetNumRecentSamples() const;
+
+    /**
+     * Get a sample of the rolling window.
+     * @param framesAgo 0 returns the last sample.
+     */
+    double GetRecentSample(uint32_t framesAgo = 0) const;
+
+    /**
+     * Write the samples of the rolling window (oldest first) as CSV
+     * with the columns sample,time_ms,hitch.
+     * @return false if the file could not be written.
+     */
+    bool WriteSamplesCSV(const std::string& fileName) const;
+
+    /**
+     * Write the non-empty buckets of the histogram as CSV with the
+     * columns lower_ms,upper_ms,count,cumulative_percent.
+     * @return false if the file could not be written.
+     */
+    bool WriteHistogramCSV(const std::string& fileName) const;
+
+    /**
+     * The bucket of a time in microseconds and the range of times (in
+     * microseconds) of a bucket. The upper bound is exclusive.
+     */
+    static uint32_t GetBucketIndex(uint64_t microseconds);
+    static uint64_t GetBucketLowerBound(uint32_t bucketIndex);
+    static uint64_t GetBucketUpperBound(uint32_t bucketIndex);
+
+private:
+    Settings m_Settings;
+
+    std::vector<uint64_t> m_Buckets;
+    uint64_t m_NumSamples;
+    double m_MinTime;
+    double m_MaxTime;
+    double m_TotalTime;
+    uint64_t m_NumHitches;
+
+    struct Sample
+    {
+        double Time;
+        bool Hitch;
+    };
+
+    // The rolling window.
+    std::vector<Sample> m_RecentSamples;
+    // The index of the next sample in the ring.
+    uint32_t m_NextRecentSample;
+    uint32_t m_NumRecentSamples;
+    double m_RecentTotalTime;
+};
@@ -51,11 +51,15 @@ protected:
 
     /**
      *  Update the game logic.
+     *  If the window uses a fixed time step (Window::SetFixedStep), this is
+     *  called zero or more times per frame with the step duration.
      */
     virtual void OnUpdate(UpdateEventArgs& e);
 
     /**
      *  Render stuff.
+     *  With a fixed time step, RenderEventArgs::Alpha is used to interpolate
+     *  between the states of the last two update steps.
      */
     virtual void OnRender(RenderEventArgs& e);
 
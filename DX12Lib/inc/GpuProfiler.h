@@ -0,0 +1,89 @@
+#pragma once
+
+/**
+ * Measures the GPU time of named scopes (passes) in the command lists of a frame
+ * with timestamp queries (see GPU_PROFILE_SCOPE).
+ *
+ * The timestamps of a frame are resolved to a readback buffer at the end of the
+ * frame and read at the start of a later frame, once the GPU has finished the
+ * frame, so the profiler never waits for the GPU. The bookkeeping of the queries
+ * is done by a TimestampQueryRing.
+ *
+ * The scopes must be recorded on command lists of the direct command queue.
+ */
+
+#include <CommandQueue.h>
+#include <Profiler.h>
+#include <TimestampQueryRing.h>
+
+#include <d3d12.h>
+#include <wrl.h>
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+class CommandList;
+
+#if PROFILER_ENABLED
+// Measure the GPU time of the commands that are recorded on the command list until the end of the scope.
+#define GPU_PROFILE_SCOPE(commandList, name) GpuProfileScope PROFILE_CONCAT(gpuProfileScope, __LINE__)(commandList, name)
+#else
+#define GPU_PROFILE_SCOPE(commandList, name) do {} while(0)
+#endif
+
+class GpuProfiler
+{
+public:
+    GpuProfiler(Microsoft::WRL::ComPtr<ID3D12Device2> device, std::shared_ptr<CommandQueue> commandQueue,
+        const TimestampQueryRing::Settings& settings = TimestampQueryRing::Settings());
+    virtual ~GpuProfiler();
+
+    /**
+     * Read the timings of the frames the GPU has finished and start recording a frame.
+     * Called by the Window before Game::OnRender.
+     */
+    void BeginFrame();
+
+    void BeginScope(CommandList& commandList, const std::string& name);
+    void EndScope(CommandList& commandList);
+
+    /**
+     * Resolve the timestamps of the frame on the command queue.
+     * Called by the Window after Game::OnRender.
+     */
+    void EndFrame();
+
+    // The timings of the last frame that was read (see TimestampQueryRing::GetTimings).
+    const std::vector<TimestampQueryRing::ScopeTiming>& GetTimings() const;
+    std::string GetTimingsTable() const;
+
+    const TimestampQueryRing& GetQueryRing() const;
+
+private:
+    std::shared_ptr<CommandQueue> m_CommandQueue;
+    Microsoft::WRL::ComPtr<ID3D12QueryHeap> m_d3d12QueryHeap;
+    // A persistently mapped buffer in a readback heap with a timestamp for each query.
+    Microsoft::WRL::ComPtr<ID3D12Resource> m_d3d12ReadbackBuffer;
+    const uint64_t* m_Timestamps;
+    uint64_t m_TimestampFrequency;
+
+    TimestampQueryRing m_QueryRing;
+};
+
+/**
+ * Measures a GPU scope from construction to destruction (see GPU_PROFILE_SCOPE).
+ */
+class GpuProfileScope
+{
+public:
+    GpuProfileScope(CommandList& commandList, const std::string& name);
+    ~GpuProfileScope();
+
+    GpuProfileScope(const GpuProfileScope&) = delete;
+    GpuProfileScope& operator=(const GpuProfileScope&) = delete;
+
+private:
+    CommandList& m_CommandList;
+};
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <type_traits>
+
+/**
+ * Incremental 64-bit FNV-1a hash.
+ * Used to build the keys for the root signature and pipeline state caches.
+ * Only add canonical data (no padding bytes or pointers) to get stable hashes.
+ */
+class Hasher
+{
+public:
+    static constexpr uint64_t OffsetBasis = 14695981039346656037ull;
+    static constexpr uint64_t Prime = 1099511628211ull;
+
+    Hasher()
+        : m_Hash(OffsetBasis)
+    {}
+
+    explicit Hasher(uint64_t seed)
+        : m_Hash(seed)
+    {}
+
+    void Add(const void* data, size_t sizeInBytes)
+    {
+        const uint8_t* bytes = static_cast<const uint8_t*>(data);
+        for (size_t i = 0; i < sizeInBytes; ++i)
+        {
+            m_Hash ^= bytes[i];
+            m_Hash *= Prime;
+        }
+    }
+
+    template<typename T>
+    void Add(const T& value)
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "Only trivially copyable types can be hashed.");
+        Add(&value, sizeof(T));
+    }
+
+    void Add(const std::string& value)
+    {
+        Add(value.size());
+        Add(value.data(), value.size());
+    }
+
+    uint64_t GetHash() const
+    {
+        return m_Hash;
+    }
+
+private:
+    uint64_t m_Hash;
+};
+
+// Hash a block of memory.
+inline uint64_t HashBytes(const void* data, size_t sizeInBytes, uint64_t seed = Hasher::OffsetBasis)
+{
+    Hasher hasher(seed);
+    hasher.Add(data, sizeInBytes);
+    return hasher.GetHash();
+}
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <Platform.h>
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+/**
+ * A platform without a window system. Each iteration of the event loop
+ * delivers the synthetic input events of the frame to all windows and then
+ * updates and renders them.
+ *
+ * By default, the time advances by a fixed amount per frame (independent of
+ * how long a frame takes), so runs with the same input are deterministic.
+ */
+class HeadlessPlatform : public Platform
+{
+public:
+    struct Settings
+    {
+        // The simulated duration of a frame in seconds. Use 0 to use the real time.
+        double FrameTime = 1.0 / 60.0;
+        // Stop after this number of frames (0 to run until Quit is called).
+        uint64_t MaxFrames = 0;
+    };
+
+    // Generates the input events for a frame.
+    using InputGenerator = std::function<void(uint64_t frame, std::vector<InputQueue::Event>& events)>;
+
+    HeadlessPlatform();
+    explicit HeadlessPlatform(const Settings& settings);
+
+    int Run() override;
+    void Quit(int exitCode) override;
+    double GetTime() const override;
+
+    void AddWindow(PlatformWindow* window) override;
+    void RemoveWindow(PlatformWindow* window) override;
+
+    void SetInputGenerator(InputGenerator inputGenerator);
+
+    /**
+     * Create a generator for pseudo-random mouse motion, mouse clicks and key
+     * presses inside a client area of the given size. The same seed always
+     * generates the same events.
+     */
+    static InputGenerator CreateRandomInput(uint32_t seed, int clientWidth, int clientHeight);
+
+    // The number of frames that have been run.
+    uint64_t GetFrameCount() const;
+
+private:
+    Settings m_Settings;
+    InputGenerator m_InputGenerator;
+    std::vector<PlatformWindow*> m_Windows;
+    std::vector<InputQueue::Event> m_Events;
+
+    uint64_t m_FrameCount;
+    double m_StartTime;
+    bool m_Quit;
+    int m_ExitCode;
+};
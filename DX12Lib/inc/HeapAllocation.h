@@ -0,0 +1,71 @@
+#pragma once
+
+#include <d3d12.h>
+#include <wrl.h>
+
+#include <cstdint>
+#include <memory>
+
+class HeapAllocatorPage;
+
+/**
+ * A placed resource that was sub-allocated from a heap page.
+ * The memory is returned to the heap page when the allocation is destroyed.
+ */
+class HeapAllocation
+{
+public:
+    // Creates a NULL allocation.
+    HeapAllocation();
+
+    HeapAllocation(
+        Microsoft::WRL::ComPtr<ID3D12Resource> resource,
+        uint64_t offset,
+        uint64_t sizeInBytes,
+        std::shared_ptr<HeapAllocatorPage> page );
+
+    // The destructor will automatically free the allocation.
+    ~HeapAllocation();
+
+    // Copies are not allowed.
+    HeapAllocation( const HeapAllocation& ) = delete;
+    HeapAllocation& operator=( const HeapAllocation& ) = delete;
+
+    // Move is allowed.
+    HeapAllocation( HeapAllocation&& allocation );
+    HeapAllocation& operator=( HeapAllocation&& other );
+
+    // Check if this a valid allocation.
+    bool IsNull() const;
+
+    // Get the placed resource.
+    Microsoft::WRL::ComPtr<ID3D12Resource> GetResource() const;
+
+    // Get the offset of the resource in the heap.
+    uint64_t GetOffset() const;
+
+    // Get the size of the memory block that was reserved for this resource.
+    uint64_t GetSize() const;
+
+    D3D12_GPU_VIRTUAL_ADDRESS GetGPUVirtualAddress() const;
+
+    // Get the heap page that this allocation came from.
+    // This can be used to find allocations that live in a fragmented heap
+    // (see HeapAllocator::SetDefragmentationCallback).
+    std::shared_ptr<HeapAllocatorPage> GetHeapAllocatorPage() const;
+
+private:
+    friend class HeapAllocatorPage;
+
+    // Free the memory back to the heap page it came from.
+    void Free();
+
+    Microsoft::WRL::ComPtr<ID3D12Resource> m_Resource;
+    // The offset of the resource in the heap.
+    uint64_t m_Offset;
+    // The size of the reserved memory block.
+    uint64_t m_Size;
+
+    // A pointer back to the original page where this allocation came from.
+    std::shared_ptr<HeapAllocatorPage> m_Page;
+};
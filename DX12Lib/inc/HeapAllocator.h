@@ -0,0 +1,103 @@
+#pragma once
+
+#include <Defines.h>
+#include <HeapAllocation.h>
+
+#include <d3dx12.h>
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+class HeapAllocatorPage;
+
+/**
+ * Allocates placed resources from large ID3D12Heap blocks instead of
+ * creating a committed resource (and an implicit heap) per resource.
+ *
+ * Resources are sorted into two alignment classes. Buffers and regular
+ * textures use the 64KB placement alignment, MSAA textures use the 4MB
+ * placement alignment. Each alignment class uses its own set of heaps.
+ */
+class HeapAllocator
+{
+public:
+    // Invoked for heaps whose fragmentation exceeds the defragmentation threshold.
+    using DefragmentationCallback = std::function<void(HeapAllocatorPage&)>;
+
+    struct Statistics
+    {
+        uint32_t NumHeaps;
+        uint32_t NumAllocations;
+        uint64_t TotalSize;
+        uint64_t AllocatedSize;
+    };
+
+    /**
+     * @param heapType The type of heaps to create.
+     * @param heapFlags The heap flags. Resource heap tier 1 hardware requires
+     * one of D3D12_HEAP_FLAG_ALLOW_ONLY_BUFFERS, D3D12_HEAP_FLAG_ALLOW_ONLY_NON_RT_DS_TEXTURES
+     * or D3D12_HEAP_FLAG_ALLOW_ONLY_RT_DS_TEXTURES.
+     * @param heapSize The size of each heap. Resources that are larger than
+     * the heap size get a dedicated heap.
+     */
+    HeapAllocator( D3D12_HEAP_TYPE heapType, D3D12_HEAP_FLAGS heapFlags, uint64_t heapSize = _64MB );
+    virtual ~HeapAllocator();
+
+    /**
+     * Create a placed resource.
+     */
+    HeapAllocation CreateResource(
+        const D3D12_RESOURCE_DESC& resourceDesc,
+        D3D12_RESOURCE_STATES initialState,
+        const D3D12_CLEAR_VALUE* clearValue = nullptr );
+
+    /**
+     * When the frame has completed, the stale allocations can be released.
+     */
+    void ReleaseStaleAllocations( uint64_t frameNumber );
+
+    /**
+     * Set a callback that is invoked by Defragment for every heap whose
+     * fragmentation is greater than the threshold. The callback can recreate
+     * the resources that live in the heap (see HeapAllocation::GetHeapAllocatorPage)
+     * so the heap can be released once it is empty.
+     */
+    void SetDefragmentationCallback( float fragmentationThreshold, DefragmentationCallback callback );
+
+    /**
+     * Release empty heaps and report fragmented heaps to the defragmentation callback.
+     * Called by Application::Flush when no resources are in use by the GPU.
+     */
+    void Defragment();
+
+    Statistics GetStatistics() const;
+
+private:
+    enum AlignmentClass
+    {
+        // 64KB alignment (buffers and textures).
+        Default = 0,
+        // 4MB alignment (MSAA textures).
+        MSAA = 1,
+        NumAlignmentClasses
+    };
+
+    using HeapPool = std::vector< std::shared_ptr<HeapAllocatorPage> >;
+
+    // Create a new heap for the alignment class.
+    std::shared_ptr<HeapAllocatorPage> CreateAllocatorPage( AlignmentClass alignmentClass, uint64_t heapSize );
+
+    D3D12_HEAP_TYPE m_HeapType;
+    D3D12_HEAP_FLAGS m_HeapFlags;
+    uint64_t m_HeapSize;
+
+    HeapPool m_HeapPool[NumAlignmentClasses];
+
+    float m_FragmentationThreshold;
+    DefragmentationCallback m_DefragmentationCallback;
+
+    mutable std::mutex m_AllocationMutex;
+};
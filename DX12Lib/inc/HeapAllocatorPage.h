@@ -0,0 +1,98 @@
+#pragma once
+
+#include <BuddyAllocator.h>
+#include <HeapAllocation.h>
+
+#include <d3dx12.h>
+
+#include <wrl.h>
+#include <memory>
+#include <mutex>
+#include <queue>
+
+/**
+ * A single ID3D12Heap that placed resources are sub-allocated from.
+ */
+class HeapAllocatorPage : public std::enable_shared_from_this<HeapAllocatorPage>
+{
+public:
+    /**
+     * @param heapType The type of heap (DEFAULT, UPLOAD, or READBACK).
+     * @param heapFlags The heap flags (for example D3D12_HEAP_FLAG_ALLOW_ONLY_BUFFERS).
+     * @param sizeInBytes The size of the heap. Must be a power of two multiple of the alignment.
+     * @param alignment The placement alignment of the heap
+     * (D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT or D3D12_DEFAULT_MSAA_RESOURCE_PLACEMENT_ALIGNMENT).
+     */
+    HeapAllocatorPage( D3D12_HEAP_TYPE heapType, D3D12_HEAP_FLAGS heapFlags, uint64_t sizeInBytes, uint64_t alignment );
+
+    /**
+     * Check to see if this heap has a free block large enough to
+     * satisfy the request.
+     */
+    bool HasSpace( uint64_t sizeInBytes, uint64_t alignment ) const;
+
+    /**
+     * Create a placed resource in this heap.
+     * If the allocation cannot be satisfied, then a NULL allocation is returned.
+     */
+    HeapAllocation Allocate(
+        const D3D12_RESOURCE_DESC& resourceDesc,
+        const D3D12_RESOURCE_ALLOCATION_INFO& allocationInfo,
+        D3D12_RESOURCE_STATES initialState,
+        const D3D12_CLEAR_VALUE* clearValue );
+
+    /**
+     * Return an allocation back to the heap.
+     * @param frameNumber Stale allocations are not freed directly, but put
+     * on a stale allocations queue. Stale allocations are returned to the heap
+     * using the HeapAllocatorPage::ReleaseStaleAllocations method.
+     */
+    void Free( HeapAllocation&& allocation, uint64_t frameNumber );
+
+    /**
+     * Return the stale allocations that were freed in or before frameNumber
+     * back to the heap.
+     */
+    void ReleaseStaleAllocations( uint64_t frameNumber );
+
+    Microsoft::WRL::ComPtr<ID3D12Heap> GetHeap() const;
+
+    uint64_t GetAlignment() const;
+    uint64_t GetSize() const;
+    uint64_t GetFreeSize() const;
+    uint64_t GetLargestFreeBlockSize() const;
+    // The number of allocations including stale allocations.
+    uint32_t GetNumAllocations() const;
+    bool IsEmpty() const;
+    float GetFragmentation() const;
+
+private:
+    struct StaleAllocationInfo
+    {
+        StaleAllocationInfo( Microsoft::WRL::ComPtr<ID3D12Resource> resource, uint64_t offset, uint64_t frame )
+            : Resource( resource )
+            , Offset( offset )
+            , FrameNumber( frame )
+        {}
+
+        // The resource is kept alive until the frame has completed.
+        Microsoft::WRL::ComPtr<ID3D12Resource> Resource;
+        // The offset within the heap.
+        uint64_t Offset;
+        // The frame number that the allocation was freed.
+        uint64_t FrameNumber;
+    };
+
+    // Stale allocations are queued for release until the frame that they were freed
+    // has completed.
+    using StaleAllocationQueue = std::queue<StaleAllocationInfo>;
+
+    Microsoft::WRL::ComPtr<ID3D12Heap> m_d3d12Heap;
+    D3D12_HEAP_TYPE m_HeapType;
+    uint64_t m_Alignment;
+
+    BuddyAllocator m_Allocator;
+    StaleAllocationQueue m_StaleAllocations;
+
+    mutable std::mutex m_AllocationMutex;
+};
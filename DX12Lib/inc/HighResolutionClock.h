@@ -1,7 +1,11 @@
 #pragma once
 
-#include <chrono>
+#include <cstdint>
 
+/**
+ * Measures the time between ticks with the FastClock.
+ * The times are kept in clock ticks and converted when they are read.
+ */
 class HighResolutionClock
 {
 public:
@@ -27,11 +31,11 @@ public:
     double GetTotalSeconds() const;
 
 private:
-    // Initial time point.
-    std::chrono::high_resolution_clock::time_point m_T0;
+    // Initial time point (in FastClock ticks).
+    uint64_t m_T0;
     // Time since last tick.
-    std::chrono::high_resolution_clock::duration m_DeltaTime;
-    std::chrono::high_resolution_clock::duration m_TotalTime;
+    uint64_t m_DeltaTime;
+    uint64_t m_TotalTime;
 };
 
 
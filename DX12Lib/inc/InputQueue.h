@@ -0,0 +1,55 @@
+#pragma once
+
+#include <Events.h>
+#include <SpscRing.h>
+
+#include <atomic>
+#include <cstdint>
+#include <variant>
+#include <vector>
+
+/**
+ * Queues the input events of a window between the message pump (producer)
+ * and the update of the game (consumer).
+ *
+ * The consumer removes all queued events in one batch per frame. Consecutive
+ * mouse motion events are combined into a single event and the relative
+ * motion (MouseMotionEventArgs::RelX/RelY) is computed from the positions of
+ * the mouse events.
+ *
+ * If the queue is full, events are dropped (and counted) instead of blocking
+ * the message pump.
+ */
+class InputQueue
+{
+public:
+    using Event = std::variant<std::monostate, KeyEventArgs, MouseMotionEventArgs, MouseButtonEventArgs, MouseWheelEventArgs>;
+
+    static const size_t DefaultCapacity = 1024;
+
+    explicit InputQueue(size_t capacity = DefaultCapacity);
+
+    // Add an event (producer thread only).
+    void Push(const Event& event);
+
+    /**
+     * Remove all queued events (consumer thread only).
+     * @param events The events are appended to this vector.
+     */
+    void PopAll(std::vector<Event>& events);
+
+    // The number of events that were dropped because the queue was full.
+    uint64_t GetNumDroppedEvents() const;
+
+private:
+    // Update the mouse position and return the motion since the last mouse event.
+    void UpdateMousePosition(int x, int y, int& relX, int& relY);
+
+    SpscRing<Event> m_Events;
+    std::atomic<uint64_t> m_NumDroppedEvents;
+
+    // The position of the last mouse event that was removed from the queue.
+    bool m_HasMousePosition;
+    int m_MouseX;
+    int m_MouseY;
+};
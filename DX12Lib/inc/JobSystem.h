@@ -0,0 +1,177 @@
+#pragma once
+
+#include <WorkStealingDeque.h>
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * Counts the jobs that have not finished yet. Used to wait for a group of jobs.
+ */
+class JobCounter
+{
+public:
+    JobCounter()
+        : m_NumJobs(0)
+    {}
+
+    JobCounter(const JobCounter&) = delete;
+    JobCounter& operator=(const JobCounter&) = delete;
+
+    bool IsDone() const
+    {
+        return m_NumJobs.load(std::memory_order_acquire) == 0;
+    }
+
+private:
+    friend class JobSystem;
+    std::atomic<uint32_t> m_NumJobs;
+};
+
+/**
+ * A work-stealing job system for short, fine-grained jobs that are part of
+ * a frame (for example, updating objects or recording command lists).
+ *
+ * Each worker owns a Chase-Lev deque (WorkStealingDeque). Jobs are pushed to
+ * the deque of the thread that submits them and idle workers steal from the
+ * other deques. The thread that creates the job system is worker 0 and only
+ * executes jobs while it waits for a counter. Jobs that are submitted by other
+ * threads go to a shared queue.
+ *
+ * Instead of switching fibers, a thread that waits for a counter executes
+ * other jobs until the counter reaches zero, so jobs can wait for the jobs
+ * they submit (continuations are written as nested jobs).
+ *
+ * Long-running background work (for example, pipeline compilation) should
+ * use the ThreadPool instead, since it would occupy a worker for many frames.
+ * Jobs must not throw exceptions.
+ */
+class JobSystem
+{
+public:
+    using Job = std::function<void()>;
+
+    /**
+     * Create a job system.
+     *
+     * @param numWorkers The number of workers (including the calling thread).
+     * If 0, the number of hardware threads is used.
+     */
+    explicit JobSystem(size_t numWorkers = 0);
+    virtual ~JobSystem();
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    /**
+     * Submit a job.
+     *
+     * @param counter If not nullptr, the counter is incremented and decremented
+     * again when the job finishes.
+     */
+    void Run(Job job, JobCounter* counter = nullptr);
+
+    /**
+     * Execute jobs until the counter reaches zero.
+     */
+    void Wait(const JobCounter& counter);
+
+    /**
+     * Call function(i) for i in [0, count) on the workers and wait for all calls to finish.
+     *
+     * @param batchSize The number of indices that are processed by a single job.
+     * If 0, the indices are divided in a few batches per worker.
+     */
+    template<typename Function>
+    void ParallelFor(uint32_t count, uint32_t batchSize, const Function& function)
+    {
+        if (count == 0)
+        {
+            return;
+        }
+        if (batchSize == 0)
+        {
+            uint32_t numBatches = static_cast<uint32_t>(GetNumWorkers()) * 4;
+            batchSize = std::max(1u, (count + numBatches - 1) / numBatches);
+        }
+
+        JobCounter counter;
+        // The last batch is executed by the calling thread.
+        uint32_t lastBegin = ((count - 1) / batchSize) * batchSize;
+        for (uint32_t begin = 0; begin < lastBegin; begin += batchSize)
+        {
+            uint32_t end = begin + batchSize;
+            Run([&function, begin, end]()
+            {
+                for (uint32_t i = begin; i < end; ++i)
+                {
+                    function(i);
+                }
+            }, &counter);
+        }
+
+        for (uint32_t i = lastBegin; i < count; ++i)
+        {
+            function(i);
+        }
+
+        Wait(counter);
+    }
+
+    // The number of workers (including the thread that created the job system).
+    size_t GetNumWorkers() const
+    {
+        return m_Workers.size();
+    }
+
+private:
+    struct Task
+    {
+        Job Function;
+        JobCounter* Counter;
+    };
+
+    struct Worker
+    {
+        WorkStealingDeque<Task*> Deque;
+        std::thread Thread;
+    };
+
+    void WorkerThread(uint32_t workerIndex);
+
+    // Push a task to the deque of the current worker (or the shared queue).
+    void Push(Task* task);
+
+    // Find a task: the own deque first, then the shared queue, then steal from the other workers.
+    Task* FindTask(uint32_t workerIndex);
+
+    // Execute a task (if one is available).
+    bool TryExecuteTask();
+
+    void Execute(Task* task);
+
+    // The index of the calling thread or ~0u if the thread is not a worker of this job system.
+    uint32_t GetWorkerIndex() const;
+
+    std::vector< std::unique_ptr<Worker> > m_Workers;
+
+    // Tasks that are submitted by threads that are not workers.
+    std::deque<Task*> m_SharedTasks;
+    std::mutex m_SharedTasksMutex;
+
+    // The number of tasks that are queued (but not yet executing).
+    std::atomic<uint32_t> m_NumQueuedTasks;
+
+    // Idle workers sleep until a task is queued.
+    std::mutex m_SleepMutex;
+    std::condition_variable m_TaskAvailable;
+    std::atomic<bool> m_Stop;
+};
@@ -0,0 +1,54 @@
+#pragma once
+
+#define WIN32_LEAN_AND_MEAN
+#include <Windows.h>
+
+#include <cstddef>
+#include <string>
+
+/**
+ * A read-only memory-mapped file.
+ */
+class MappedFile
+{
+public:
+    MappedFile();
+    virtual ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /**
+     * Map the contents of a file into memory.
+     * Any previously mapped file is unmapped.
+     *
+     * @return false if the file does not exist or could not be mapped.
+     */
+    bool Open(const std::wstring& fileName);
+
+    /**
+     * Unmap the file. Pointers to the contents of the file are invalid afterwards.
+     */
+    void Close();
+
+    bool IsOpen() const
+    {
+        return m_Data != nullptr;
+    }
+
+    const void* GetData() const
+    {
+        return m_Data;
+    }
+
+    size_t GetSize() const
+    {
+        return m_Size;
+    }
+
+private:
+    HANDLE m_hFile;
+    HANDLE m_hMapping;
+    const void* m_Data;
+    size_t m_Size;
+};
@@ -0,0 +1,143 @@
+#pragma once
+
+#include <Defines.h>
+#include <HeapAllocation.h>
+#include <RangeAllocator.h>
+
+#include <d3d12.h>
+#include <wrl.h>
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <vector>
+
+class CommandList;
+
+/**
+ * Packs the vertex and index data of many meshes into a few large GPU buffers.
+ *
+ * Each page of the pool is a single buffer in a default heap. Vertex and index
+ * ranges are sub-allocated from the pages and can be freed for reuse.
+ * Pages are transitioned to COPY_DEST for uploads and are otherwise kept in
+ * the COMMON state, relying on implicit state promotion for vertex/index
+ * buffer reads (so the pages can be uploaded on a copy queue).
+ */
+class MeshBufferPool
+{
+public:
+    struct Range
+    {
+        // The buffer that contains the range.
+        ID3D12Resource* Buffer = nullptr;
+        // The index of the page in the pool.
+        uint32_t PageIndex = 0;
+        // The offset (in bytes) of the range in the buffer.
+        uint64_t Offset = 0;
+        // The size (in bytes) of the range.
+        uint64_t SizeInBytes = 0;
+        // The number of vertices or indices.
+        uint32_t Count = 0;
+        // The vertex stride or the size of an index.
+        uint32_t Stride = 0;
+        // The index format (DXGI_FORMAT_UNKNOWN for vertex ranges).
+        DXGI_FORMAT Format = DXGI_FORMAT_UNKNOWN;
+        D3D12_GPU_VIRTUAL_ADDRESS GPUAddress = 0;
+
+        bool IsNull() const { return Buffer == nullptr; }
+
+        /**
+         * The first vertex (or index) of the range relative to the start of the page.
+         * Use as the BaseVertexLocation (or StartIndexLocation) when the page
+         * view is bound instead of the view of the range.
+         */
+        uint32_t GetFirstElement() const { return static_cast<uint32_t>(Offset / Stride); }
+
+        D3D12_VERTEX_BUFFER_VIEW GetVertexBufferView() const;
+        D3D12_INDEX_BUFFER_VIEW GetIndexBufferView() const;
+    };
+
+    struct Statistics
+    {
+        uint32_t NumPages;
+        uint32_t NumRanges;
+        uint64_t TotalSize;
+        uint64_t AllocatedSize;
+    };
+
+    /**
+     * @param pageSize The size of each buffer in the pool. Ranges that are
+     * larger than the page size get a dedicated page.
+     */
+    explicit MeshBufferPool(uint64_t pageSize = _16MB);
+    virtual ~MeshBufferPool();
+
+    /**
+     * Allocate a range for numVertices vertices.
+     * The range is aligned to the vertex stride.
+     */
+    Range AllocateVertices(uint32_t numVertices, uint32_t vertexStride);
+
+    /**
+     * Allocate a range for numIndices indices.
+     * @param indexFormat DXGI_FORMAT_R16_UINT or DXGI_FORMAT_R32_UINT.
+     */
+    Range AllocateIndices(uint32_t numIndices, DXGI_FORMAT indexFormat);
+
+    /**
+     * Record the upload of the data for a range on a command list.
+     * The data is staged in the upload buffer of the command list.
+     */
+    void Upload(CommandList& commandList, const Range& range, const void* data);
+
+    /**
+     * Return a range back to the pool.
+     * The range is put on a stale queue and returned to the page
+     * using MeshBufferPool::ReleaseStaleRanges.
+     */
+    void Free(const Range& range);
+
+    /**
+     * When the frame has completed, the stale ranges can be released.
+     * The pool of the application is released by Application::ReleaseStaleAllocations.
+     */
+    void ReleaseStaleRanges(uint64_t frameNumber);
+
+    /**
+     * Get a view of an entire page. Binding the page view once allows drawing
+     * all ranges in the page by offsetting with Range::GetFirstElement.
+     */
+    D3D12_VERTEX_BUFFER_VIEW GetPageVertexBufferView(uint32_t pageIndex, uint32_t vertexStride) const;
+    D3D12_INDEX_BUFFER_VIEW GetPageIndexBufferView(uint32_t pageIndex, DXGI_FORMAT indexFormat) const;
+
+    Statistics GetStatistics() const;
+
+private:
+    struct Page
+    {
+        Page(uint64_t sizeInBytes);
+
+        HeapAllocation Buffer;
+        RangeAllocator Allocator;
+        uint32_t NumRanges;
+    };
+
+    struct StaleRangeInfo
+    {
+        uint32_t PageIndex;
+        uint64_t Offset;
+        uint64_t SizeInBytes;
+        // The frame number that the range was freed.
+        uint64_t FrameNumber;
+    };
+
+    Range Allocate(uint32_t count, uint32_t stride, DXGI_FORMAT format);
+
+    uint64_t m_PageSize;
+
+    std::vector< std::unique_ptr<Page> > m_Pages;
+    std::queue<StaleRangeInfo> m_StaleRanges;
+
+    mutable std::mutex m_Mutex;
+};
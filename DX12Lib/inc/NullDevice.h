@@ -0,0 +1,311 @@
+#pragma once
+
+#include <Device.h>
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+/**
+ * A device that emulates the GPU objects that are used by the engine in host
+ * memory, so the CPU side of the engine (allocators, descriptor management and
+ * command submission) can be run and benchmarked without a GPU.
+ *
+ * The device does not depend on Direct3D. The enumerations use the same values
+ * as the D3D12 enumerations they mirror and descriptor handles and GPU virtual
+ * addresses are plain integers (the CPU descriptor handles point to host memory,
+ * so descriptors can be copied like on a real device). The engine classes that
+ * take a Device (for example, the DescriptorAllocator) run on the NullDevice
+ * unchanged.
+ *
+ *   * Descriptor heaps, heaps and resources are backed by host memory.
+ *   * Command lists record the commands into a list instead of executing them.
+ *   * The fence value that is signaled when a command list is executed
+ *     completes after a configurable GPU latency.
+ *   * Timestamp queries are written (and resolved) when the command list
+ *     is executed, using the host clock.
+ */
+class NullDevice : public Device
+{
+public:
+    struct Settings
+    {
+        // The size of a descriptor for each descriptor heap type.
+        uint32_t DescriptorSizes[static_cast<uint32_t>(DescriptorHeapType::NumTypes)] = { 32, 32, 32, 32 };
+        // The placement alignment of heaps and committed resources in bytes.
+        uint64_t ResourceAlignment = 64 * 1024;
+        // The time (in seconds) between the execution of a command list and
+        // the completion of its fence value.
+        double GpuLatency = 0.0;
+    };
+
+    struct Statistics
+    {
+        uint64_t NumDescriptorHeaps = 0;
+        uint64_t NumHeaps = 0;
+        uint64_t NumResources = 0;
+        // The host memory that was allocated for heaps and committed resources.
+        uint64_t NumBytesAllocated = 0;
+        uint64_t NumExecutedCommandLists = 0;
+        uint64_t NumExecutedCommands = 0;
+    };
+
+    class DescriptorHeap : public Device::DescriptorHeap
+    {
+    public:
+        DescriptorHeapType GetType() const override { return m_Type; }
+        uint32_t GetNumDescriptors() const override { return m_NumDescriptors; }
+
+        // The handle of the first descriptor (the address of the descriptor in host memory).
+        uint64_t GetCPUDescriptorHandleForHeapStart() const override;
+        // Only valid for shader visible heaps (0 otherwise).
+        uint64_t GetGPUDescriptorHandleForHeapStart() const override { return m_GPUHandleStart; }
+
+    private:
+        friend class NullDevice;
+
+        DescriptorHeapType m_Type;
+        uint32_t m_NumDescriptors;
+        uint64_t m_GPUHandleStart;
+        std::vector<uint8_t> m_Memory;
+    };
+
+    class Heap
+    {
+    public:
+        uint64_t GetSize() const { return m_Memory.size(); }
+        uint64_t GetGPUVirtualAddress() const { return m_GPUVirtualAddress; }
+
+    private:
+        friend class NullDevice;
+
+        uint64_t m_GPUVirtualAddress;
+        std::vector<uint8_t> m_Memory;
+    };
+
+    class Resource : public Device::Resource
+    {
+    public:
+        uint64_t GetSize() const override { return m_Size; }
+        uint64_t GetGPUVirtualAddress() const override { return m_GPUVirtualAddress; }
+
+        // The host memory of the resource. Always mapped.
+        void* Map() const override;
+
+    private:
+        friend class NullDevice;
+
+        // Keeps the memory of the resource alive.
+        std::shared_ptr<Heap> m_Heap;
+        uint64_t m_Offset;
+        uint64_t m_Size;
+        uint64_t m_GPUVirtualAddress;
+    };
+
+    // A heap of timestamp queries.
+    class QueryHeap
+    {
+    public:
+        uint32_t GetNumQueries() const { return static_cast<uint32_t>(m_Timestamps.size()); }
+
+    private:
+        friend class NullDevice;
+
+        std::vector<uint64_t> m_Timestamps;
+    };
+
+    class Fence : public Device::Fence
+    {
+    public:
+        uint64_t GetCompletedValue() override;
+
+        // Block until the value is completed. Asserts if the value
+        // was never signaled by a command queue (the wait would not return).
+        void Wait(uint64_t value) override;
+
+    private:
+        friend class NullDevice;
+
+        struct PendingValue
+        {
+            uint64_t Value;
+            // The time (in seconds) the value completes.
+            double CompletionTime;
+        };
+
+        std::mutex m_Mutex;
+        uint64_t m_CompletedValue;
+        std::deque<PendingValue> m_PendingValues;
+    };
+
+    // The commands that are recorded by a command list.
+    enum class CommandType : uint32_t
+    {
+        ResourceBarrier,
+        CopyBufferRegion,
+        SetPipelineState,
+        SetRootSignature,
+        SetDescriptorHeap,
+        SetRootDescriptorTable,
+        SetRoot32BitConstants,
+        SetVertexBuffer,
+        SetIndexBuffer,
+        ClearRenderTargetView,
+        ClearDepthStencilView,
+        DrawInstanced,
+        DrawIndexedInstanced,
+        Dispatch,
+        // The arguments of the query commands are host pointers, so they can't be captured.
+        EndQuery,
+        ResolveQueryData,
+        NumCommandTypes
+    };
+
+    struct Command
+    {
+        CommandType Type;
+        uint64_t Arguments[4];
+    };
+
+    class CommandList : public Device::CommandList
+    {
+    public:
+        CommandListType GetType() const override { return m_Type; }
+
+        // The commands are kept until the command list is reset.
+        void Close() override {}
+        // Remove the recorded commands.
+        void Reset() override;
+
+        void ResourceBarrier(uint32_t numBarriers);
+        void CopyBufferRegion(uint64_t dstAddress, uint64_t srcAddress, uint64_t numBytes);
+        void SetPipelineState(uint64_t pipelineState);
+        void SetRootSignature(uint64_t rootSignature);
+        void SetDescriptorHeap(const Device::DescriptorHeap& descriptorHeap);
+        void SetRootDescriptorTable(uint32_t rootParameterIndex, uint64_t baseDescriptor);
+        void SetRoot32BitConstants(uint32_t rootParameterIndex, uint32_t num32BitValues);
+        void SetVertexBuffer(uint32_t slot, uint64_t address, uint32_t sizeInBytes, uint32_t strideInBytes);
+        void SetIndexBuffer(uint64_t address, uint32_t sizeInBytes);
+        void ClearRenderTargetView(uint64_t descriptor);
+        void ClearDepthStencilView(uint64_t descriptor);
+        void DrawInstanced(uint32_t vertexCount, uint32_t instanceCount);
+        void DrawIndexedInstanced(uint32_t indexCount, uint32_t instanceCount);
+        void Dispatch(uint32_t x, uint32_t y, uint32_t z);
+
+        // Write a timestamp to a query.
+        void EndQuery(QueryHeap& queryHeap, uint32_t index);
+        // Copy the timestamps of a range of queries to a resource.
+        void ResolveQueryData(const QueryHeap& queryHeap, uint32_t startIndex, uint32_t numQueries,
+            const Resource& destination, uint64_t destinationOffset);
+
+        // Record a command (for example, a command that is replayed from a FrameCapture).
+        void Record(const Command& command);
+
+        const std::vector<Command>& GetCommands() const { return m_Commands; }
+
+    private:
+        friend class NullDevice;
+
+        void Record(CommandType type, uint64_t a0 = 0, uint64_t a1 = 0, uint64_t a2 = 0, uint64_t a3 = 0);
+
+        CommandListType m_Type;
+        std::vector<Command> m_Commands;
+    };
+
+    class CommandQueue : public Device::CommandQueue
+    {
+    public:
+        CommandListType GetType() const override { return m_Type; }
+
+        // The queries of the command lists are written when they are executed.
+        void ExecuteCommandLists(uint32_t numCommandLists, Device::CommandList* const* commandLists) override;
+
+        // The value completes after the GPU latency (and not before the values the queue waits for).
+        void Signal(Device::Fence& fence, uint64_t value) override;
+
+        // Delays the completion of the next signaled values until the fence value completes.
+        // Asserts if the value was never signaled (the queue would never continue).
+        void Wait(Device::Fence& fence, uint64_t value) override;
+
+        /**
+         * Execute a command list and signal the fence of the queue.
+         * @return The fence value that completes when the command list has finished.
+         */
+        uint64_t ExecuteCommandList(const CommandList& commandList);
+
+        const std::shared_ptr<Fence>& GetFence() const { return m_Fence; }
+
+    private:
+        friend class NullDevice;
+
+        void Execute(const CommandList& commandList);
+
+        NullDevice* m_Device;
+        CommandListType m_Type;
+        std::shared_ptr<Fence> m_Fence;
+        uint64_t m_FenceValue;
+        // The time (in seconds) the last fence value the queue waits for completes.
+        double m_WaitCompletionTime;
+    };
+
+    NullDevice();
+    explicit NullDevice(const Settings& settings);
+
+    const Settings& GetSettings() const;
+
+    std::shared_ptr<Device::DescriptorHeap> CreateDescriptorHeap(DescriptorHeapType type, uint32_t numDescriptors, bool shaderVisible) override;
+    uint32_t GetDescriptorHandleIncrementSize(DescriptorHeapType type) const override;
+
+    // Copy descriptors between (CPU) descriptor handles.
+    void CopyDescriptorsSimple(uint32_t numDescriptors, uint64_t destDescriptor, uint64_t srcDescriptor, DescriptorHeapType type) const override;
+    void CopyDescriptors(uint32_t numDescriptors, uint64_t destDescriptor, const uint64_t* srcDescriptors, DescriptorHeapType type) const override;
+
+    std::shared_ptr<Heap> CreateHeap(uint64_t sizeInBytes);
+    std::shared_ptr<Resource> CreateCommittedResource(uint64_t sizeInBytes);
+    // Create a resource in a heap. Returns nullptr if the resource does not fit in the heap.
+    std::shared_ptr<Resource> CreatePlacedResource(std::shared_ptr<Heap> heap, uint64_t offset, uint64_t sizeInBytes);
+    // A committed resource.
+    std::shared_ptr<Device::Resource> CreateUploadBuffer(uint64_t sizeInBytes) override;
+
+    std::shared_ptr<QueryHeap> CreateQueryHeap(uint32_t numQueries);
+    // The number of timestamp ticks per second (the timestamps are in nanoseconds).
+    uint64_t GetTimestampFrequency() const;
+
+    std::shared_ptr<Device::Fence> CreateFence(uint64_t initialValue) override;
+    // A NullDevice::CommandQueue.
+    std::shared_ptr<Device::CommandQueue> CreateCommandQueue(CommandListType type) override;
+    // A NullDevice::CommandList.
+    std::shared_ptr<Device::CommandList> CreateCommandList(CommandListType type) override;
+
+    /**
+     * The device does not end frames by itself. The frame count is set by the
+     * caller (for example, the FrameReplayer sets the frame numbers of a capture).
+     */
+    uint64_t GetFrameCount() const override;
+    void SetFrameCount(uint64_t frameCount);
+
+    Statistics GetStatistics() const;
+
+    // The time (in seconds) that is used for the fence completion.
+    static double GetTime();
+
+private:
+    // Reserve a range of GPU virtual addresses.
+    uint64_t AllocateGPUVirtualAddress(uint64_t sizeInBytes);
+
+    Settings m_Settings;
+
+    std::atomic<uint64_t> m_NextGPUVirtualAddress;
+    std::atomic<uint64_t> m_NextGPUDescriptorHandle;
+    std::atomic<uint64_t> m_FrameCount;
+
+    std::atomic<uint64_t> m_NumDescriptorHeaps;
+    std::atomic<uint64_t> m_NumHeaps;
+    std::atomic<uint64_t> m_NumResources;
+    std::atomic<uint64_t> m_NumBytesAllocated;
+    std::atomic<uint64_t> m_NumExecutedCommandLists;
+    std::atomic<uint64_t> m_NumExecutedCommands;
+};
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <RootSignatureOptimizer.h>
+
+#include <d3d12.h>
+
+#include <vector>
+
+/**
+ * Converts the layout that is produced by the RootSignatureOptimizer into
+ * a D3D12_ROOT_SIGNATURE_DESC1 that can be used to create a RootSignature.
+ * The description points into storage that is owned by this class.
+ */
+class OptimizedRootSignatureDesc
+{
+public:
+    explicit OptimizedRootSignatureDesc(
+        const RootSignatureOptimizer::Layout& layout,
+        D3D12_ROOT_SIGNATURE_FLAGS flags = D3D12_ROOT_SIGNATURE_FLAG_NONE,
+        const std::vector<D3D12_STATIC_SAMPLER_DESC>& staticSamplers = {});
+
+    // The description points into the storage of this object.
+    OptimizedRootSignatureDesc(const OptimizedRootSignatureDesc&) = delete;
+    OptimizedRootSignatureDesc& operator=(const OptimizedRootSignatureDesc&) = delete;
+
+    const D3D12_ROOT_SIGNATURE_DESC1& GetDesc() const
+    {
+        return m_RootSignatureDesc;
+    }
+
+private:
+    std::vector<D3D12_ROOT_PARAMETER1> m_RootParameters;
+    std::vector< std::vector<D3D12_DESCRIPTOR_RANGE1> > m_DescriptorRanges;
+    std::vector<D3D12_STATIC_SAMPLER_DESC> m_StaticSamplers;
+
+    D3D12_ROOT_SIGNATURE_DESC1 m_RootSignatureDesc;
+};
@@ -0,0 +1,312 @@
+#pragma once
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+/**
+ * A copy of a root signature description that is stored in a single block of memory.
+ *
+ * The root parameters, static samplers and descriptor ranges of all descriptor
+ * tables are packed (in that order) into one allocation. Storing or copying a
+ * description makes a single allocation and moving it makes none. The
+ * descriptor table bit masks and the number of descriptors per table are
+ * computed when the description is stored (see CommandList::ParseRootSignature).
+ *
+ * The class does not depend on Direct3D. RootSignatureDesc must have the members
+ * of D3D12_ROOT_SIGNATURE_DESC1 (and its parameters, descriptor ranges and static
+ * samplers the members of the D3D12 structures), RootSignature uses
+ * PackedRootSignatureDesc<D3D12_ROOT_SIGNATURE_DESC1>.
+ */
+template<typename RootSignatureDesc>
+class PackedRootSignatureDesc
+{
+public:
+    using RootParameter = std::remove_const_t< std::remove_pointer_t<decltype(std::declval<RootSignatureDesc&>().pParameters)> >;
+    using StaticSampler = std::remove_const_t< std::remove_pointer_t<decltype(std::declval<RootSignatureDesc&>().pStaticSamplers)> >;
+    using DescriptorRange = std::remove_const_t< std::remove_pointer_t<decltype(std::declval<RootParameter&>().DescriptorTable.pDescriptorRanges)> >;
+
+    // Matches D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE.
+    static constexpr uint32_t DescriptorTableParameterType = 0;
+    // Matches D3D12_DESCRIPTOR_RANGE_TYPE_SAMPLER.
+    static constexpr uint32_t SamplerRangeType = 3;
+
+    // A 32-bit mask is used to represent the descriptor tables.
+    static constexpr uint32_t MaxDescriptorTables = 32;
+
+    PackedRootSignatureDesc()
+        : m_Desc{}
+        , m_StorageSize(0)
+        , m_NumDescriptorsPerTable{ 0 }
+        , m_SamplerTableBitMask(0)
+        , m_DescriptorTableBitMask(0)
+    {}
+
+    explicit PackedRootSignatureDesc(const RootSignatureDesc& desc)
+        : PackedRootSignatureDesc()
+    {
+        Store(desc);
+    }
+
+    // Copies duplicate the storage block with a single allocation.
+    PackedRootSignatureDesc(const PackedRootSignatureDesc& copy)
+        : PackedRootSignatureDesc()
+    {
+        CopyFrom(copy);
+    }
+
+    // Moves take ownership of the storage block (the description stays valid).
+    PackedRootSignatureDesc(PackedRootSignatureDesc&& copy) noexcept
+        : PackedRootSignatureDesc()
+    {
+        MoveFrom(copy);
+    }
+
+    PackedRootSignatureDesc& operator=(const PackedRootSignatureDesc& other)
+    {
+        if (this != &other)
+        {
+            Reset();
+            CopyFrom(other);
+        }
+        return *this;
+    }
+
+    PackedRootSignatureDesc& operator=(PackedRootSignatureDesc&& other) noexcept
+    {
+        if (this != &other)
+        {
+            Reset();
+            MoveFrom(other);
+        }
+        return *this;
+    }
+
+    // Replace the stored description with a copy of desc.
+    void Store(const RootSignatureDesc& desc)
+    {
+        Reset();
+
+        m_StorageSize = ComputeStorageSize(desc);
+        m_Storage = m_StorageSize > 0 ? std::make_unique<uint8_t[]>(m_StorageSize) : nullptr;
+
+        uint8_t* storage = m_Storage.get();
+        size_t offset = 0;
+
+        uint32_t numParameters = desc.NumParameters;
+        RootParameter* pParameters = numParameters > 0 ? reinterpret_cast<RootParameter*>(storage + offset) : nullptr;
+        offset += sizeof(RootParameter) * numParameters;
+
+        uint32_t numStaticSamplers = desc.NumStaticSamplers;
+        offset = AlignOffset<StaticSampler>(offset);
+        StaticSampler* pStaticSamplers = numStaticSamplers > 0 ? reinterpret_cast<StaticSampler*>(storage + offset) : nullptr;
+        offset += sizeof(StaticSampler) * numStaticSamplers;
+
+        if (pStaticSamplers)
+        {
+            memcpy(pStaticSamplers, desc.pStaticSamplers, sizeof(StaticSampler) * numStaticSamplers);
+        }
+
+        // The descriptor ranges of all tables are packed after the static samplers.
+        offset = AlignOffset<DescriptorRange>(offset);
+
+        for (uint32_t i = 0; i < numParameters; ++i)
+        {
+            const RootParameter& rootParameter = desc.pParameters[i];
+            pParameters[i] = rootParameter;
+
+            if (static_cast<uint32_t>(rootParameter.ParameterType) != DescriptorTableParameterType)
+            {
+                continue;
+            }
+
+            uint32_t numDescriptorRanges = rootParameter.DescriptorTable.NumDescriptorRanges;
+            DescriptorRange* pDescriptorRanges = numDescriptorRanges > 0 ? reinterpret_cast<DescriptorRange*>(storage + offset) : nullptr;
+            offset += sizeof(DescriptorRange) * numDescriptorRanges;
+
+            if (pDescriptorRanges)
+            {
+                memcpy(pDescriptorRanges, rootParameter.DescriptorTable.pDescriptorRanges, sizeof(DescriptorRange) * numDescriptorRanges);
+            }
+            pParameters[i].DescriptorTable.pDescriptorRanges = pDescriptorRanges;
+
+            if (i >= MaxDescriptorTables || numDescriptorRanges == 0)
+            {
+                continue;
+            }
+
+            // Set the bit mask depending on the type of descriptor table.
+            if (static_cast<uint32_t>(pDescriptorRanges[0].RangeType) == SamplerRangeType)
+            {
+                m_SamplerTableBitMask |= (1u << i);
+            }
+            else
+            {
+                m_DescriptorTableBitMask |= (1u << i);
+            }
+
+            // Count the number of descriptors in the descriptor table.
+            for (uint32_t j = 0; j < numDescriptorRanges; ++j)
+            {
+                m_NumDescriptorsPerTable[i] += pDescriptorRanges[j].NumDescriptors;
+            }
+        }
+
+        assert(offset == m_StorageSize);
+
+        m_Desc.NumParameters = numParameters;
+        m_Desc.pParameters = pParameters;
+        m_Desc.NumStaticSamplers = numStaticSamplers;
+        m_Desc.pStaticSamplers = pStaticSamplers;
+        m_Desc.Flags = desc.Flags;
+    }
+
+    // Release the storage block.
+    void Reset()
+    {
+        m_Storage.reset();
+        m_StorageSize = 0;
+        m_Desc = {};
+
+        memset(m_NumDescriptorsPerTable, 0, sizeof(m_NumDescriptorsPerTable));
+        m_SamplerTableBitMask = 0;
+        m_DescriptorTableBitMask = 0;
+    }
+
+    // The description points into the storage block.
+    const RootSignatureDesc& GetDesc() const
+    {
+        return m_Desc;
+    }
+
+    // The size of the storage block in bytes.
+    size_t GetStorageSize() const
+    {
+        return m_StorageSize;
+    }
+
+    // The root parameter indices that are CBV, SRV and UAV descriptor tables.
+    uint32_t GetDescriptorTableBitMask() const
+    {
+        return m_DescriptorTableBitMask;
+    }
+
+    // The root parameter indices that are sampler descriptor tables.
+    uint32_t GetSamplerTableBitMask() const
+    {
+        return m_SamplerTableBitMask;
+    }
+
+    // The number of descriptors in the descriptor table at a root index (0 for other parameters).
+    uint32_t GetNumDescriptors(uint32_t rootIndex) const
+    {
+        assert(rootIndex < MaxDescriptorTables);
+        return m_NumDescriptorsPerTable[rootIndex];
+    }
+
+    // Compute the size (in bytes) of the storage that is required for the
+    // parameters, descriptor ranges, and static samplers of a root signature description.
+    static size_t ComputeStorageSize(const RootSignatureDesc& desc)
+    {
+        size_t numDescriptorRanges = 0;
+        for (uint32_t i = 0; i < desc.NumParameters; ++i)
+        {
+            const RootParameter& rootParameter = desc.pParameters[i];
+            if (static_cast<uint32_t>(rootParameter.ParameterType) == DescriptorTableParameterType)
+            {
+                numDescriptorRanges += rootParameter.DescriptorTable.NumDescriptorRanges;
+            }
+        }
+
+        size_t size = sizeof(RootParameter) * desc.NumParameters;
+        size = AlignOffset<StaticSampler>(size) + sizeof(StaticSampler) * desc.NumStaticSamplers;
+        size = AlignOffset<DescriptorRange>(size) + sizeof(DescriptorRange) * numDescriptorRanges;
+
+        return size;
+    }
+
+private:
+    // Round a storage offset up to the alignment of a type.
+    template<typename T>
+    static size_t AlignOffset(size_t offset)
+    {
+        return (offset + alignof(T) - 1) & ~(alignof(T) - 1);
+    }
+
+    void CopyFrom(const PackedRootSignatureDesc& other)
+    {
+        m_Desc = other.m_Desc;
+        m_StorageSize = other.m_StorageSize;
+
+        memcpy(m_NumDescriptorsPerTable, other.m_NumDescriptorsPerTable, sizeof(m_NumDescriptorsPerTable));
+        m_SamplerTableBitMask = other.m_SamplerTableBitMask;
+        m_DescriptorTableBitMask = other.m_DescriptorTableBitMask;
+
+        if (m_StorageSize == 0)
+        {
+            return;
+        }
+
+        // The storage block only contains plain structures, so it can be copied
+        // with a single memcpy. The pointers in the copy are then relocated to
+        // the new block.
+        m_Storage = std::make_unique<uint8_t[]>(m_StorageSize);
+        memcpy(m_Storage.get(), other.m_Storage.get(), m_StorageSize);
+
+        const uint8_t* srcStorage = other.m_Storage.get();
+        uint8_t* dstStorage = m_Storage.get();
+
+        auto relocate = [srcStorage, dstStorage](auto* pointer)
+        {
+            using T = std::remove_const_t< std::remove_pointer_t<decltype(pointer)> >;
+            return pointer ? reinterpret_cast<T*>(dstStorage + (reinterpret_cast<const uint8_t*>(pointer) - srcStorage)) : nullptr;
+        };
+
+        RootParameter* pParameters = relocate(m_Desc.pParameters);
+        for (uint32_t i = 0; i < m_Desc.NumParameters; ++i)
+        {
+            if (static_cast<uint32_t>(pParameters[i].ParameterType) == DescriptorTableParameterType)
+            {
+                pParameters[i].DescriptorTable.pDescriptorRanges = relocate(pParameters[i].DescriptorTable.pDescriptorRanges);
+            }
+        }
+
+        m_Desc.pParameters = pParameters;
+        m_Desc.pStaticSamplers = relocate(m_Desc.pStaticSamplers);
+    }
+
+    void MoveFrom(PackedRootSignatureDesc& other)
+    {
+        // The description points into the storage block, which does not move.
+        m_Desc = other.m_Desc;
+        m_Storage = std::move(other.m_Storage);
+        m_StorageSize = other.m_StorageSize;
+
+        memcpy(m_NumDescriptorsPerTable, other.m_NumDescriptorsPerTable, sizeof(m_NumDescriptorsPerTable));
+        m_SamplerTableBitMask = other.m_SamplerTableBitMask;
+        m_DescriptorTableBitMask = other.m_DescriptorTableBitMask;
+
+        other.Reset();
+    }
+
+    RootSignatureDesc m_Desc;
+
+    // The root parameters, static samplers and descriptor ranges of the
+    // description are stored (in that order) in a single block of memory.
+    std::unique_ptr<uint8_t[]> m_Storage;
+    size_t m_StorageSize;
+
+    // The number of descriptors per descriptor table.
+    uint32_t m_NumDescriptorsPerTable[MaxDescriptorTables];
+
+    // A bit mask that represents the root parameter indices that are
+    // descriptor tables for Samplers.
+    uint32_t m_SamplerTableBitMask;
+    // A bit mask that represents the root parameter indices that are
+    // CBV, UAV, and SRV descriptor tables.
+    uint32_t m_DescriptorTableBitMask;
+};
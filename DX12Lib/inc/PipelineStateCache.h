@@ -0,0 +1,108 @@
+#pragma once
+
+#include <MappedFile.h>
+#include <PipelineStateCacheFile.h>
+
+#include <d3d12.h>
+#include <dxgi1_6.h>
+#include <wrl.h>
+
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+/**
+ * A cache of pipeline state objects that is persisted to disk.
+ *
+ * Pipeline states are keyed by the hash of the pipeline state stream
+ * (see PipelineStateKey). The cache file is memory-mapped when the cache
+ * is created and the cached blobs in the file are used to speed up the
+ * creation of pipeline states. If a cached blob is rejected by the driver
+ * the pipeline state is compiled from the stream.
+ *
+ * Pipeline states that were compiled by this cache are written to the
+ * cache file with Save. Blobs of pipeline states that were not used since
+ * the cache was created are dropped from the cache file, so the file doesn't
+ * grow with pipeline states that are not used anymore.
+ */
+class PipelineStateCache
+{
+public:
+    struct Statistics
+    {
+        // Pipeline states that were already created by this cache.
+        uint64_t NumHits;
+        // Pipeline states that were created from a blob in the cache file.
+        uint64_t NumDiskHits;
+        // Pipeline states that were compiled from the stream.
+        uint64_t NumMisses;
+        // Blobs in the cache file that were rejected by the driver.
+        uint64_t NumRejectedBlobs;
+    };
+
+    PipelineStateCache(Microsoft::WRL::ComPtr<ID3D12Device2> device, Microsoft::WRL::ComPtr<IDXGIAdapter4> adapter, const std::wstring& fileName);
+    virtual ~PipelineStateCache();
+
+    /**
+     * Get a pipeline state for the pipeline state stream.
+     *
+     * @param pipelineStateStreamDesc The pipeline state stream.
+     * @param rootSignatureHash The hash of the root signature that is referenced
+     * by the stream (see RootSignatureCache::ComputeHash).
+     */
+    Microsoft::WRL::ComPtr<ID3D12PipelineState> GetPipelineState(
+        const D3D12_PIPELINE_STATE_STREAM_DESC& pipelineStateStreamDesc,
+        uint64_t rootSignatureHash);
+
+    /**
+     * Release a pipeline state that is no longer used (for example, a pipeline
+     * state that was replaced after its shaders were reloaded). The pipeline
+     * state is not written to the cache file by Save.
+     */
+    void Release(ID3D12PipelineState* pipelineState);
+
+    /**
+     * Compute the hash of a pipeline state stream.
+     * Cached PSO subobjects in the stream are not part of the hash.
+     */
+    static uint64_t ComputeHash(
+        const D3D12_PIPELINE_STATE_STREAM_DESC& pipelineStateStreamDesc,
+        uint64_t rootSignatureHash);
+
+    /**
+     * Write the cache file if pipeline states were compiled since it was loaded
+     * or if the file contains blobs of pipeline states that were not used.
+     *
+     * @return false if the cache file could not be written.
+     */
+    bool Save();
+
+    Statistics GetStatistics() const;
+
+private:
+    // Load the blobs in the cache file.
+    void Load();
+
+    Microsoft::WRL::ComPtr<ID3D12Device2> m_d3d12Device;
+    std::wstring m_FileName;
+
+    // Identifies the adapter and driver version the cached blobs are valid for.
+    uint64_t m_DeviceHash;
+
+    MappedFile m_MappedFile;
+    // Blobs in the (mapped) cache file.
+    PipelineStateCacheFile m_CacheFile;
+
+    std::unordered_map< uint64_t, Microsoft::WRL::ComPtr<ID3D12PipelineState> > m_PipelineStates;
+    // Blobs of pipeline states that are not in the cache file yet.
+    std::unordered_map< uint64_t, Microsoft::WRL::ComPtr<ID3DBlob> > m_NewBlobs;
+    // The keys of the pipeline states that were requested (and not released).
+    // Only the blobs of these pipeline states are kept by Save.
+    std::unordered_set<uint64_t> m_UsedKeys;
+
+    Statistics m_Statistics;
+
+    mutable std::mutex m_Mutex;
+};
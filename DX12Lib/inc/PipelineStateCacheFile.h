@@ -0,0 +1,101 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <vector>
+
+/**
+ * The file format of the pipeline state cache.
+ *
+ * The file contains the cached blobs of pipeline state objects
+ * (ID3D12PipelineState::GetCachedBlob) keyed by the hash of the
+ * pipeline state description (see PipelineStateKey).
+ *
+ * Layout:
+ *   Header
+ *   Entry[NumEntries] (sorted by key)
+ *   Blob data
+ *
+ * The file is rejected if the magic number or version don't match, if it
+ * was written for a different device (or driver), or if the checksum of
+ * the entries and blob data doesn't match. The file format does not depend
+ * on Direct3D. Loaded blobs point directly into the file image, so the image
+ * must stay valid (mapped) while the blobs are used.
+ */
+class PipelineStateCacheFile
+{
+public:
+    // "PSOC"
+    static constexpr uint32_t Magic = 0x434F5350;
+    // Increment the version when the layout of the file changes.
+    static constexpr uint32_t Version = 1;
+
+    struct Header
+    {
+        uint32_t Magic;
+        uint32_t Version;
+        // Identifies the device and driver the blobs were created with.
+        uint64_t DeviceHash;
+        uint64_t NumEntries;
+        // Hash of everything that follows the header.
+        uint64_t Checksum;
+    };
+
+    struct Entry
+    {
+        uint64_t Key;
+        // Offset of the blob from the start of the file.
+        uint64_t Offset;
+        uint64_t Size;
+    };
+
+    struct Blob
+    {
+        const void* Data;
+        size_t Size;
+    };
+
+    // Blobs sorted by key.
+    using BlobMap = std::map<uint64_t, Blob>;
+
+    PipelineStateCacheFile();
+
+    /**
+     * Load the cache from a file image.
+     *
+     * @param data The contents of the file.
+     * @param sizeInBytes The size of the file.
+     * @param deviceHash The hash of the device the blobs must be created with.
+     * @return true if the file is valid. If the file is not valid the cache is empty.
+     */
+    bool Load(const void* data, size_t sizeInBytes, uint64_t deviceHash);
+
+    /**
+     * Find the blob with the given key.
+     *
+     * @return The blob or an empty blob (nullptr, 0) if the key is not in the cache.
+     */
+    Blob Find(uint64_t key) const;
+
+    /**
+     * Get all of the blobs in the cache.
+     */
+    const BlobMap& GetBlobs() const
+    {
+        return m_Blobs;
+    }
+
+    /**
+     * Remove all blobs from the cache.
+     */
+    void Clear();
+
+    /**
+     * Write a file image that contains the blobs.
+     */
+    static std::vector<uint8_t> Serialize(const BlobMap& blobs, uint64_t deviceHash);
+
+private:
+    BlobMap m_Blobs;
+};
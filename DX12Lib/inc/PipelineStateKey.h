@@ -0,0 +1,86 @@
+#pragma once
+
+#include <Hash.h>
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Builds the key of a pipeline state object.
+ *
+ * The key is a hash of the canonical description of the pipeline state.
+ * Shader bytecode is added by the hash of its contents and the root signature
+ * by the hash of its description (see RootSignatureCache::ComputeHash) so
+ * the key is stable between runs of the application.
+ *
+ * Every value is tagged with the field it belongs to so that different
+ * descriptions can't produce the same sequence of hashed values.
+ * The key builder does not depend on Direct3D.
+ */
+class PipelineStateKey
+{
+public:
+    // Matches D3D12_PIPELINE_STATE_SUBOBJECT_TYPE.
+    enum class Field : uint32_t
+    {
+        RootSignature = 0,
+        VS = 1,
+        PS = 2,
+        DS = 3,
+        HS = 4,
+        GS = 5,
+        CS = 6,
+        StreamOutput = 7,
+        Blend = 8,
+        SampleMask = 9,
+        Rasterizer = 10,
+        DepthStencil = 11,
+        InputLayout = 12,
+        IBStripCutValue = 13,
+        PrimitiveTopology = 14,
+        RenderTargetFormats = 15,
+        DepthStencilFormat = 16,
+        SampleDesc = 17,
+        NodeMask = 18,
+        CachedPSO = 19,
+        Flags = 20,
+        DepthStencil1 = 21,
+        ViewInstancing = 22,
+    };
+
+    /**
+     * Add a 32-bit value of a field to the key.
+     */
+    void AddValue(Field field, uint32_t value);
+
+    /**
+     * Add a block of values to the key. The block must not contain
+     * padding bytes (their contents are undefined).
+     */
+    void AddBytes(Field field, const void* data, size_t sizeInBytes);
+
+    /**
+     * Add a null-terminated string (for example, a semantic name) to the key.
+     * A nullptr string is added as an empty string.
+     */
+    void AddString(Field field, const char* value);
+
+    /**
+     * Add shader bytecode to the key. Shaders with the same bytecode have
+     * the same hash regardless of the address of the bytecode.
+     */
+    void AddShader(Field field, const void* bytecode, size_t sizeInBytes);
+
+    /**
+     * Add the root signature to the key by the hash of its description.
+     */
+    void AddRootSignature(uint64_t rootSignatureHash);
+
+    uint64_t GetHash() const
+    {
+        return m_Hasher.GetHash();
+    }
+
+private:
+    Hasher m_Hasher;
+};
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <InputQueue.h>
+
+/**
+ * A window that receives events from the platform. Implemented by Window.
+ */
+class PlatformWindow
+{
+public:
+    virtual ~PlatformWindow() = default;
+
+    // Queue an input event. Queued events are dispatched at the start of the next frame.
+    virtual void QueueInputEvent(const InputQueue::Event& e) = 0;
+
+    // The client area of the window was resized.
+    virtual void Resize(int width, int height) = 0;
+
+    // Update and render a frame.
+    virtual void Frame() = 0;
+};
+
+/**
+ * The operating system services that are used by the application loop.
+ *
+ * Win32Platform runs the Windows message loop. HeadlessPlatform runs without
+ * a window system: it ticks frames and generates synthetic input, so the frame
+ * loop can run in benchmarks and soak tests on machines without a display.
+ */
+class Platform
+{
+public:
+    virtual ~Platform() = default;
+
+    /**
+     * Run the event loop until Quit is called.
+     * @return The exit code that was passed to Quit.
+     */
+    virtual int Run() = 0;
+
+    // Request the event loop to stop.
+    virtual void Quit(int exitCode) = 0;
+
+    // The current time in seconds. Only differences between times are meaningful.
+    virtual double GetTime() const = 0;
+
+    /**
+     * Register a window to receive frames and input events. The Win32 platform
+     * delivers the events through the window procedure instead.
+     */
+    virtual void AddWindow(PlatformWindow* window) = 0;
+    virtual void RemoveWindow(PlatformWindow* window) = 0;
+};
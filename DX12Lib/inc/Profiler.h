@@ -0,0 +1,199 @@
+#pragma once
+
+#include <SpscRing.h>
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Define PROFILER_ENABLED as 0 to compile the profile zones out.
+#ifndef PROFILER_ENABLED
+#define PROFILER_ENABLED 1
+#endif
+
+#define PROFILE_CONCAT_IMPL(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_IMPL(a, b)
+
+#if PROFILER_ENABLED
+// Measure the time until the end of the scope. The name must be a string literal
+// (or another string that outlives the profiler).
+#define PROFILE_SCOPE(name) ProfileZone PROFILE_CONCAT(profileZone, __LINE__)(name)
+#define PROFILE_FUNCTION() PROFILE_SCOPE(__FUNCTION__)
+#else
+#define PROFILE_SCOPE(name) do {} while(0)
+#define PROFILE_FUNCTION() do {} while(0)
+#endif
+
+/**
+ * A CPU profiler for named zones (see PROFILE_SCOPE).
+ *
+ * Each thread writes its zones to its own single producer ring buffer, so
+ * recording a zone does not take a lock. The zones are collected once per
+ * frame (EndFrame) into per-zone statistics over the last frames and, while
+ * a trace is recorded, into a Chrome trace (chrome://tracing or Perfetto).
+ *
+ * The profiler does not depend on Windows.
+ */
+class Profiler
+{
+public:
+    // The number of frames the statistics are computed over.
+    static constexpr uint32_t NumHistoryFrames = 120;
+    // The number of zones that a thread can record between calls to EndFrame.
+    static constexpr size_t ThreadBufferCapacity = 16 * 1024;
+
+    struct ZoneStatistics
+    {
+        std::string Name;
+        // The number of frames (of the last NumHistoryFrames) the statistics are computed over.
+        uint32_t NumFrames = 0;
+        // The average number of times the zone is entered per frame.
+        double CallsPerFrame = 0.0;
+        // The time (in seconds) per frame, summed over all threads.
+        double AverageTime = 0.0;
+        double MinTime = 0.0;
+        double MaxTime = 0.0;
+    };
+
+    static Profiler& Get();
+
+    // The time of a zone boundary in FastClock ticks.
+    static uint64_t GetTimestamp();
+
+    /**
+     * Record a zone on the calling thread.
+     */
+    void AddZone(const char* name, uint64_t start, uint64_t end);
+
+    /**
+     * Set the name of the calling thread in the trace.
+     */
+    void SetThreadName(const std::string& name);
+
+    /**
+     * Start recording the zones of the next numFrames frames.
+     * The trace is written to the file when the last frame ends.
+     */
+    void BeginTrace(const std::string& fileName, uint32_t numFrames);
+
+    /**
+     * Collect the zones of all threads and update the statistics.
+     * Must always be called from the same thread.
+     * @return false if the trace could not be written to the file.
+     */
+    bool EndFrame();
+
+    /**
+     * The statistics of each zone, sorted by the average time per frame (highest first).
+     */
+    std::vector<ZoneStatistics> GetStatistics() const;
+
+    // The statistics formatted as a table.
+    std::string GetStatisticsTable() const;
+
+    // The number of zones that were dropped because a thread buffer was full.
+    uint64_t GetNumDroppedZones() const;
+
+    /**
+     * The number of thread buffers. The buffer of a thread that exited is
+     * reused by a new thread after its zones were collected (EndFrame).
+     */
+    size_t GetNumThreadBuffers() const;
+
+private:
+    Profiler();
+
+    struct ZoneEvent
+    {
+        const char* Name;
+        uint64_t Start;
+        uint64_t End;
+    };
+
+    struct ThreadBuffer
+    {
+        ThreadBuffer(uint32_t threadId)
+            : ThreadId(threadId)
+            , Events(ThreadBufferCapacity)
+            , NumDroppedZones(0)
+            , IsActive(true)
+            , IsFree(false)
+        {}
+
+        uint32_t ThreadId;
+        std::string Name;
+        SpscRing<ZoneEvent> Events;
+        std::atomic<uint64_t> NumDroppedZones;
+        // Cleared when the thread exits.
+        std::atomic<bool> IsActive;
+        // The thread exited and its zones were collected, so the buffer can
+        // be used by a new thread (guarded by m_ThreadBuffersMutex).
+        bool IsFree;
+    };
+
+    struct TraceEvent
+    {
+        const char* Name;
+        uint64_t Start;
+        uint64_t End;
+        uint32_t ThreadId;
+    };
+
+    struct Zone
+    {
+        std::string Name;
+        // The time and count of the current frame.
+        uint64_t FrameTime = 0;
+        uint32_t FrameCount = 0;
+        // The time and count of the last NumHistoryFrames frames.
+        uint64_t Times[NumHistoryFrames] = {};
+        uint32_t Counts[NumHistoryFrames] = {};
+    };
+
+    ThreadBuffer& GetThreadBuffer();
+    Zone& GetZone(const char* name);
+    bool WriteTrace() const;
+
+    mutable std::mutex m_ThreadBuffersMutex;
+    std::vector< std::unique_ptr<ThreadBuffer> > m_ThreadBuffers;
+
+    mutable std::mutex m_StatisticsMutex;
+    std::vector<Zone> m_Zones;
+    // The zone of each name pointer (zones with the same name share an entry).
+    std::unordered_map<const char*, size_t> m_ZoneIndices;
+    uint64_t m_FrameCount;
+
+    std::vector<TraceEvent> m_TraceEvents;
+    std::string m_TraceFileName;
+    uint64_t m_TraceStart;
+    uint32_t m_NumTraceFrames;
+    uint32_t m_TraceFrameCount;
+};
+
+/**
+ * Records a zone from construction to destruction (see PROFILE_SCOPE).
+ */
+class ProfileZone
+{
+public:
+    explicit ProfileZone(const char* name)
+        : m_Name(name)
+        , m_Start(Profiler::GetTimestamp())
+    {}
+
+    ~ProfileZone()
+    {
+        Profiler::Get().AddZone(m_Name, m_Start, Profiler::GetTimestamp());
+    }
+
+    ProfileZone(const ProfileZone&) = delete;
+    ProfileZone& operator=(const ProfileZone&) = delete;
+
+private:
+    const char* m_Name;
+    uint64_t m_Start;
+};
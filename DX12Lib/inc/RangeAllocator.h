@@ -0,0 +1,91 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <unordered_map>
+
+/**
+ * A device independent allocator for byte ranges in a linear buffer.
+ *
+ * The free list is kept sorted by offset and by size (the same scheme that
+ * is used by the DescriptorAllocatorPage). Allocations use the smallest free
+ * block that fits the request and freed ranges are merged with adjacent free
+ * blocks.
+ */
+class RangeAllocator
+{
+public:
+    // Returned from Allocate if the allocation could not be satisfied.
+    static constexpr uint64_t InvalidOffset = ~0ull;
+
+    explicit RangeAllocator( uint64_t size );
+
+    /**
+     * Allocate a range of sizeInBytes.
+     * @param alignment The offset of the range will be a multiple of the alignment.
+     * The alignment does not need to be a power of two (for example, a vertex stride).
+     * @returns The offset of the range or InvalidOffset if there is no free block
+     * large enough to satisfy the request.
+     */
+    uint64_t Allocate( uint64_t sizeInBytes, uint64_t alignment = 1 );
+
+    /**
+     * Return a range back to the allocator.
+     * The range must have been returned by Allocate with the same size.
+     */
+    void Free( uint64_t offset, uint64_t sizeInBytes );
+
+    /**
+     * Check to see if there is a free block large enough to satisfy the request.
+     */
+    bool HasSpace( uint64_t sizeInBytes, uint64_t alignment = 1 ) const;
+
+    uint64_t GetSize() const;
+    uint64_t GetFreeSize() const;
+    bool IsEmpty() const;
+
+    // The number of blocks in the free list.
+    uint32_t GetNumFreeBlocks() const;
+
+    // The number of allocated ranges.
+    uint32_t GetNumAllocations() const;
+
+private:
+    // Find the first free block that fits the request.
+    // Returns true if a block was found and sets the offset and padding of the allocation.
+    bool FindBlock( uint64_t sizeInBytes, uint64_t alignment, uint64_t& blockOffset, uint64_t& alignedOffset ) const;
+
+    // Adds a new block to the free list.
+    void AddNewBlock( uint64_t offset, uint64_t sizeInBytes );
+
+    // Remove a block from the free list.
+    void RemoveBlock( uint64_t offset );
+
+    using OffsetType = uint64_t;
+    using SizeType = uint64_t;
+
+    struct FreeBlockInfo;
+    // A map that lists the free blocks by the offset within the buffer.
+    using FreeListByOffset = std::map<OffsetType, FreeBlockInfo>;
+
+    // A map that lists the free blocks by size.
+    // Needs to be a multimap since multiple blocks can have the same size.
+    using FreeListBySize = std::multimap<SizeType, FreeListByOffset::iterator>;
+
+    struct FreeBlockInfo
+    {
+        FreeBlockInfo( SizeType size ) : Size( size ) {}
+
+        SizeType Size;
+        FreeListBySize::iterator FreeListBySizeIt;
+    };
+
+    FreeListByOffset m_FreeListByOffset;
+    FreeListBySize m_FreeListBySize;
+
+    // The size of each allocated range by offset.
+    std::unordered_map<OffsetType, SizeType> m_Allocations;
+
+    uint64_t m_Size;
+    uint64_t m_FreeSize;
+};
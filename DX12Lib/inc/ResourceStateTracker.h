@@ -0,0 +1,316 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * Tracks the known state of the resources that are used on a command list.
+ *
+ * Transitions are requested with only the state the resource must be in.
+ * If the state of the resource is not yet known on the command list, the
+ * transition is stored as a pending barrier and resolved against the global
+ * resource state when the command list is executed on the command queue.
+ * Barriers are batched and only submitted to the command list with
+ * FlushResourceBarriers. All barriers must be flushed before recording
+ * commands that depend on the state of the resources.
+ *
+ * Transitions to the state the resource is already in are dropped and
+ * consecutive transitions of the same (sub)resource in a batch are merged
+ * into a single barrier.
+ *
+ * The tracker does not depend on Direct3D. Resources are opaque pointers
+ * (ID3D12Resource*), the states are D3D12_RESOURCE_STATES values and the
+ * barriers have the same layout as D3D12_RESOURCE_BARRIER, so the flushed
+ * barriers can be passed to ID3D12GraphicsCommandList::ResourceBarrier as is.
+ * Every resource that is transitioned must be registered with
+ * AddGlobalResourceState when it is created.
+ */
+class ResourceStateTracker
+{
+public:
+    // Matches D3D12_RESOURCE_BARRIER_TYPE.
+    enum class BarrierType : uint32_t
+    {
+        Transition = 0,
+        Aliasing = 1,
+        UAV = 2,
+    };
+
+    // Matches D3D12_RESOURCE_BARRIER_FLAGS.
+    enum BarrierFlags : uint32_t
+    {
+        BarrierFlagNone = 0,
+        BarrierFlagBeginOnly = 1,
+        BarrierFlagEndOnly = 2,
+    };
+
+    // Matches D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES.
+    static constexpr uint32_t AllSubresources = 0xffffffff;
+    // Matches D3D12_RESOURCE_STATE_COMMON.
+    static constexpr uint32_t CommonState = 0;
+
+    // Matches D3D12_RESOURCE_TRANSITION_BARRIER.
+    struct ResourceTransition
+    {
+        void* Resource;
+        uint32_t Subresource;
+        uint32_t StateBefore;
+        uint32_t StateAfter;
+    };
+
+    // Matches D3D12_RESOURCE_ALIASING_BARRIER.
+    struct ResourceAliasing
+    {
+        void* ResourceBefore;
+        void* ResourceAfter;
+    };
+
+    // Matches D3D12_RESOURCE_UAV_BARRIER.
+    struct ResourceUAV
+    {
+        void* Resource;
+    };
+
+    // Matches D3D12_RESOURCE_BARRIER.
+    struct Barrier
+    {
+        BarrierType Type;
+        uint32_t Flags;
+        union
+        {
+            ResourceTransition Transition;
+            ResourceAliasing Aliasing;
+            ResourceUAV UAV;
+        };
+    };
+
+    /**
+     * Receives the barriers that are flushed to the command list
+     * (ID3D12GraphicsCommandList::ResourceBarrier).
+     */
+    using ResourceBarrierFunction = std::function<void(uint32_t numBarriers, const Barrier* barriers)>;
+
+    struct Statistics
+    {
+        // The number of transitions that were requested.
+        uint32_t NumTransitions;
+        // The number of transitions that were dropped because the
+        // resource was already in the requested state.
+        uint32_t NumRedundantTransitions;
+        // The number of transitions that were merged with a previous barrier in the batch.
+        uint32_t NumMergedTransitions;
+        // The number of barriers that were submitted to the command list.
+        uint32_t NumBarriers;
+        // The number of ResourceBarrier calls on the command list.
+        uint32_t NumFlushes;
+    };
+
+    ResourceStateTracker();
+    virtual ~ResourceStateTracker();
+
+    /**
+     * Push a resource barrier to the resource state tracker.
+     *
+     * @param barrier The resource barrier to push to the resource state tracker.
+     */
+    void ResourceBarrier(const Barrier& barrier);
+
+    /**
+     * Push a transition resource barrier to the resource state tracker.
+     *
+     * @param resource The resource to transition.
+     * @param stateAfter The state to transition the resource to.
+     * @param subResource The subresource to transition. By default, this is AllSubresources
+     * which indicates that all subresources should be transitioned to the same state.
+     */
+    void TransitionResource(void* resource, uint32_t stateAfter, uint32_t subResource = AllSubresources);
+
+    /**
+     * Push a UAV resource barrier for the given resource.
+     *
+     * @param resource The resource to add a UAV barrier for. Can be nullptr which
+     * indicates that any UAV access could require the barrier.
+     */
+    void UAVBarrier(void* resource = nullptr);
+
+    /**
+     * Push an aliasing barrier for the given resource.
+     *
+     * @param resourceBefore The resource currently occupying the space in the heap.
+     * @param resourceAfter The resource that will be occupying the space in the heap.
+     *
+     * Either the resourceBefore or the resourceAfter parameters can be nullptr which
+     * indicates that any placed or reserved resource could cause aliasing.
+     */
+    void AliasBarrier(void* resourceBefore = nullptr, void* resourceAfter = nullptr);
+
+    /**
+     * Flush any pending resource barriers to the command list.
+     * This should be done on a separate command list that is executed
+     * just before the command list that was used to record the transitions.
+     * The global resource state must be locked (ResourceStateTracker::Lock)
+     * while the pending barriers are resolved.
+     *
+     * @return The number of resource barriers that were flushed to the command list.
+     */
+    uint32_t FlushPendingResourceBarriers(const ResourceBarrierFunction& resourceBarrier);
+
+    /**
+     * Flush any (non-pending) resource barriers that have been pushed to the resource state
+     * tracker with a single call to the resource barrier function.
+     * @return The number of barriers that were flushed.
+     */
+    uint32_t FlushResourceBarriers(const ResourceBarrierFunction& resourceBarrier);
+
+    /**
+     * Commit final resource states to the global resource state map.
+     * This must be called when the command list is closed.
+     */
+    void CommitFinalResourceStates();
+
+    /**
+     * Reset state tracking. This must be done when the command list is reset.
+     */
+    void Reset();
+
+    const Statistics& GetStatistics() const;
+
+    /**
+     * The global state must be locked before flushing pending resource barriers
+     * and committing the final resource state to the global resource state.
+     * This ensures consistency of the global resource state between command list
+     * executions.
+     */
+    static void Lock();
+
+    /**
+     * Unlocks the global resource state after the final states have been committed
+     * to the global resource state array.
+     */
+    static void Unlock();
+
+    // Locks the global resource state for the lifetime of the object (also if an exception is thrown).
+    class ScopedLock
+    {
+    public:
+        ScopedLock() { Lock(); }
+        ~ScopedLock() { Unlock(); }
+
+        ScopedLock(const ScopedLock&) = delete;
+        ScopedLock& operator=(const ScopedLock&) = delete;
+    };
+
+    /**
+     * Add a resource with a given state to the global resource state array (map).
+     * This must be done when the resource is created, before it is transitioned
+     * on a command list.
+     *
+     * @param numSubresources The number of subresources (mip levels times array size)
+     * of the resource. Used to split transitions of all subresources when the
+     * subresources are in different states.
+     */
+    static void AddGlobalResourceState(void* resource, uint32_t state, uint32_t numSubresources = 1);
+
+    /**
+     * Remove a resource from the global resource state array (map).
+     * This should only be done when the resource is destroyed.
+     */
+    static void RemoveGlobalResourceState(void* resource);
+
+    // Check if a resource was added to the global resource state array (map).
+    static bool HasGlobalResourceState(void* resource);
+
+private:
+    // An array (vector) of resource barriers.
+    using ResourceBarriers = std::vector<Barrier>;
+
+    /**
+     * Tracks the state of a particular resource and all of its subresources.
+     */
+    struct ResourceState
+    {
+        // Initialize all of the subresources within a resource to the given state.
+        explicit ResourceState(uint32_t state = CommonState, uint32_t numSubresources = 0)
+            : State(state)
+            , NumSubresources(numSubresources)
+        {}
+
+        // Set a subresource to a particular state.
+        void SetSubresourceState(uint32_t subresource, uint32_t state)
+        {
+            if (subresource == AllSubresources)
+            {
+                State = state;
+                SubresourceState.clear();
+            }
+            else
+            {
+                SubresourceState[subresource] = state;
+            }
+        }
+
+        // Get the state of a (sub)resource within the resource.
+        // If the specified subresource is not found in the SubresourceState array (map)
+        // then the state of the resource (AllSubresources) is returned.
+        uint32_t GetSubresourceState(uint32_t subresource) const
+        {
+            uint32_t state = State;
+            const auto iter = SubresourceState.find(subresource);
+            if (iter != SubresourceState.end())
+            {
+                state = iter->second;
+            }
+            return state;
+        }
+
+        // If the SubresourceState array (map) is empty, then the State variable defines
+        // the state of all of the subresources.
+        uint32_t State;
+        std::map<uint32_t, uint32_t> SubresourceState;
+        // The number of subresources of the resource. Only known for the global
+        // resource state (0 for the state of a resource on a command list).
+        uint32_t NumSubresources;
+    };
+
+    using ResourceStateMap = std::unordered_map<void*, ResourceState>;
+
+    // Push a transition of a resource from the state in resourceState.
+    // Subresources that are tracked individually are transitioned one by one.
+    // Transitions of subresources in an unknown state are added to pendingBarriers (if not nullptr).
+    void PushTransition(ResourceBarriers& barriers, ResourceBarriers* pendingBarriers, const Barrier& barrier, const ResourceState& resourceState);
+
+    // Push a single barrier to the batch, merging it with a previous
+    // transition of the same subresource if possible.
+    void PushBarrier(ResourceBarriers& barriers, const Barrier& barrier);
+
+    // The number of subresources of a resource in the given state.
+    // The global resource state is used if the number of subresources is not known.
+    static uint32_t GetNumSubresources(void* resource, const ResourceState& resourceState);
+
+    // Pending resource transitions are committed before a command list
+    // is executed on the command queue. This guarantees that resources will
+    // be in the expected state at the beginning of a command list.
+    ResourceBarriers m_PendingResourceBarriers;
+
+    // Resource barriers that need to be committed to the command list.
+    ResourceBarriers m_ResourceBarriers;
+
+    // The final (last known state) of the resources within a command list.
+    // The final resource state is committed to the global resource state when the
+    // command list is closed but before it is executed on the command queue.
+    ResourceStateMap m_FinalResourceState;
+
+    Statistics m_Statistics;
+
+    // The global resource state array (map) stores the state of a resource
+    // between command list execution.
+    static ResourceStateMap ms_GlobalResourceState;
+
+    // The mutex protects shared access to the GlobalResourceState map.
+    static std::mutex ms_GlobalMutex;
+    static bool ms_IsLocked;
+};
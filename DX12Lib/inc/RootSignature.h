@@ -1,17 +1,29 @@
 #pragma once
 
+#include <PackedRootSignatureDesc.h>
+
 #include <d3dx12.h>
 #include <wrl.h>
 
+#include <cstdint>
+#include <memory>
+
 class RootSignature
 {
 public:
-    // TODO: Add (deep) copy/move constructors and assignment operators!
     RootSignature();
     RootSignature(
         const D3D12_ROOT_SIGNATURE_DESC1& rootSignatureDesc,
         D3D_ROOT_SIGNATURE_VERSION rootSignatureVersion);
-    
+
+    // Copies make a deep copy of the root signature description.
+    // The ID3D12RootSignature is shared between the copies.
+    RootSignature(const RootSignature& copy);
+    RootSignature(RootSignature&& copy) noexcept;
+
+    RootSignature& operator=(const RootSignature& other);
+    RootSignature& operator=(RootSignature&& other) noexcept;
+
     virtual ~RootSignature();
 
     void Destroy();
@@ -27,26 +39,15 @@ public:
     
     const D3D12_ROOT_SIGNATURE_DESC1& GetRootSignatureDesc() const
     {
-        return m_RootSignatureDesc;
+        return m_RootSignatureDesc.GetDesc();
     }
 
     uint32_t GetDescriptorTableBitMask(D3D12_DESCRIPTOR_HEAP_TYPE descriptorHeapType) const;
     uint32_t GetNumDescriptors(uint32_t rootIndex) const;
 
 private:
-    D3D12_ROOT_SIGNATURE_DESC1 m_RootSignatureDesc;
+    // The description is stored in a single block of memory, together with
+    // the descriptor table bit masks and the number of descriptors per table.
+    PackedRootSignatureDesc<D3D12_ROOT_SIGNATURE_DESC1> m_RootSignatureDesc;
     Microsoft::WRL::ComPtr<ID3D12RootSignature> m_RootSignature;
-
-    // Need to know the number of descriptors per descriptor table.
-    // A maximum of 32 descriptor tables are supported (since a 32-bit
-    // mask is used to represent the descriptor tables in the root signature.
-    uint32_t m_NumDescriptorsPerTable[32];
-
-    // A bit mask that represents the root parameter indices that are 
-    // descriptor tables for Samplers.
-    uint32_t m_SamplerTableBitMask;
-    // A bit mask that represents the root parameter indices that are 
-    // CBV, UAV, and SRV descriptor tables.
-    uint32_t m_DescriptorTableBitMask;
 };
-
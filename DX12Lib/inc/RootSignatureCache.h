@@ -0,0 +1,88 @@
+#pragma once
+
+#include <RootSignatureKey.h>
+
+#include <d3d12.h>
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+class RootSignature;
+
+/**
+ * A process-wide cache of root signatures.
+ *
+ * Root signatures are keyed by a canonical form of the root signature
+ * description (root parameters, descriptor ranges, static samplers and flags,
+ * see RootSignatureKey). Descriptor ranges that use
+ * D3D12_DESCRIPTOR_RANGE_OFFSET_APPEND are resolved to explicit offsets so
+ * equivalent descriptions share the same root signature.
+ */
+class RootSignatureCache
+{
+public:
+    struct Statistics
+    {
+        uint64_t NumHits;
+        uint64_t NumMisses;
+        uint32_t NumRootSignatures;
+
+        float GetHitRate() const
+        {
+            uint64_t numRequests = NumHits + NumMisses;
+            return numRequests > 0 ? static_cast<float>(NumHits) / numRequests : 0.0f;
+        }
+    };
+
+    RootSignatureCache();
+    virtual ~RootSignatureCache();
+
+    /**
+     * Get a root signature that matches the description.
+     * The root signature is created if it is not in the cache yet.
+     */
+    std::shared_ptr<RootSignature> GetRootSignature(
+        const D3D12_ROOT_SIGNATURE_DESC1& rootSignatureDesc,
+        D3D_ROOT_SIGNATURE_VERSION rootSignatureVersion);
+
+    /**
+     * Compute the hash of the canonical form of a root signature description.
+     */
+    static uint64_t ComputeHash(
+        const D3D12_ROOT_SIGNATURE_DESC1& rootSignatureDesc,
+        D3D_ROOT_SIGNATURE_VERSION rootSignatureVersion);
+
+    Statistics GetStatistics() const;
+
+    /**
+     * Release all of the root signatures in the cache.
+     * Root signatures that are still referenced are not destroyed.
+     */
+    void Clear();
+
+private:
+    // Build the canonical form of a root signature description.
+    static RootSignatureKey BuildKey(
+        const D3D12_ROOT_SIGNATURE_DESC1& rootSignatureDesc,
+        D3D_ROOT_SIGNATURE_VERSION rootSignatureVersion);
+
+    // Find a root signature in the cache. The mutex must be locked.
+    std::shared_ptr<RootSignature> Find(uint64_t hash, const RootSignatureKey& key) const;
+
+    struct Entry
+    {
+        RootSignatureKey CanonicalDesc;
+        std::shared_ptr<RootSignature> Instance;
+    };
+
+    // Entries with the same hash are compared by their keys.
+    using EntryMap = std::unordered_map< uint64_t, std::vector<Entry> >;
+
+    EntryMap m_RootSignatures;
+    Statistics m_Statistics;
+
+    mutable std::mutex m_Mutex;
+};
@@ -0,0 +1,129 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+/**
+ * Builds the canonical form of a root signature description
+ * (see RootSignatureCache).
+ *
+ * Only the members of the root parameter unions that are valid for the
+ * parameter type are added to the key. Descriptor ranges that use
+ * DescriptorRangeOffsetAppend are resolved to explicit offsets and flags that
+ * are ignored by version 1.0 root signatures are cleared, so equivalent
+ * descriptions produce the same key.
+ *
+ * The key builder does not depend on Direct3D. The enumerations use the same
+ * values as the D3D12 enumerations they mirror.
+ */
+class RootSignatureKey
+{
+public:
+    // Matches D3D_ROOT_SIGNATURE_VERSION.
+    enum class Version : uint32_t
+    {
+        V1_0 = 0x1,
+        V1_1 = 0x2,
+    };
+
+    // Matches D3D12_ROOT_PARAMETER_TYPE.
+    enum class ParameterType : uint32_t
+    {
+        DescriptorTable = 0,
+        Constants = 1,
+        CBV = 2,
+        SRV = 3,
+        UAV = 4,
+    };
+
+    // Matches D3D12_DESCRIPTOR_RANGE_TYPE.
+    enum class DescriptorRangeType : uint32_t
+    {
+        SRV = 0,
+        UAV = 1,
+        CBV = 2,
+        Sampler = 3,
+    };
+
+    // Matches D3D12_DESCRIPTOR_RANGE_OFFSET_APPEND.
+    static constexpr uint32_t DescriptorRangeOffsetAppend = 0xffffffff;
+    // The number of descriptors of an unbounded descriptor range (UINT_MAX).
+    static constexpr uint32_t UnboundedNumDescriptors = 0xffffffff;
+
+    // Matches D3D12_DESCRIPTOR_RANGE1.
+    struct DescriptorRange
+    {
+        DescriptorRangeType RangeType;
+        uint32_t NumDescriptors;
+        uint32_t BaseShaderRegister;
+        uint32_t RegisterSpace;
+        uint32_t Flags;
+        uint32_t OffsetInDescriptorsFromTableStart;
+    };
+
+    // Matches D3D12_STATIC_SAMPLER_DESC.
+    struct StaticSampler
+    {
+        uint32_t Filter;
+        uint32_t AddressU;
+        uint32_t AddressV;
+        uint32_t AddressW;
+        float MipLODBias;
+        uint32_t MaxAnisotropy;
+        uint32_t ComparisonFunc;
+        uint32_t BorderColor;
+        float MinLOD;
+        float MaxLOD;
+        uint32_t ShaderRegister;
+        uint32_t RegisterSpace;
+        uint32_t ShaderVisibility;
+    };
+
+    /**
+     * Start the key of a root signature with numParameters root parameters.
+     * The root parameters must be added in order, followed by the static samplers.
+     */
+    RootSignatureKey(Version version, uint32_t flags, uint32_t numParameters);
+
+    /**
+     * Add a descriptor table root parameter. The numRanges descriptor ranges
+     * of the table must be added with AddDescriptorRange.
+     */
+    void AddDescriptorTable(uint32_t shaderVisibility, uint32_t numRanges);
+    void AddDescriptorRange(const DescriptorRange& descriptorRange);
+
+    // Add a 32-bit constants root parameter.
+    void AddConstants(uint32_t shaderVisibility, uint32_t shaderRegister, uint32_t registerSpace, uint32_t num32BitValues);
+
+    // Add a root CBV, SRV or UAV root parameter.
+    void AddDescriptor(ParameterType type, uint32_t shaderVisibility, uint32_t shaderRegister, uint32_t registerSpace, uint32_t flags);
+
+    /**
+     * Start the static samplers (after the root parameters). The
+     * numStaticSamplers static samplers must be added with AddStaticSampler.
+     */
+    void AddStaticSamplers(uint32_t numStaticSamplers);
+    void AddStaticSampler(const StaticSampler& staticSampler);
+
+    const std::vector<uint32_t>& GetValues() const
+    {
+        return m_Values;
+    }
+
+    // The hash of the canonical form.
+    uint64_t GetHash() const;
+
+    bool operator==(const RootSignatureKey& other) const
+    {
+        return m_Values == other.m_Values;
+    }
+
+private:
+    void AddFloat(float value);
+
+    std::vector<uint32_t> m_Values;
+    Version m_Version;
+
+    // The offset of the next appended descriptor range in the current table.
+    uint32_t m_TableOffset;
+};
@@ -0,0 +1,148 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+/**
+ * Builds a root signature layout from the resources that are used by a set of shaders.
+ *
+ * The optimizer does not depend on Direct3D. The enumerations use the same values
+ * as the D3D12 enumerations they mirror so the layout can be converted to a
+ * D3D12_ROOT_SIGNATURE_DESC1 with OptimizedRootSignatureDesc.
+ *
+ * The following optimizations are applied:
+ *   * Small constant buffers are promoted to root constants as long as the
+ *     root signature stays within the 64 DWORD budget. Constant buffers that
+ *     are updated most frequently are promoted first.
+ *   * Descriptors with the same update frequency and shader visibility are
+ *     merged into a single descriptor table and ranges with consecutive
+ *     registers are merged into a single descriptor range.
+ *   * Root parameters are sorted by update frequency so the parameters that
+ *     change most often are at the lowest root indices.
+ */
+class RootSignatureOptimizer
+{
+public:
+    // Matches D3D12_DESCRIPTOR_RANGE_TYPE.
+    enum class BindingType : uint32_t
+    {
+        SRV = 0,
+        UAV = 1,
+        CBV = 2,
+        Sampler = 3,
+    };
+
+    // Matches D3D12_SHADER_VISIBILITY.
+    enum class ShaderVisibility : uint32_t
+    {
+        All = 0,
+        Vertex = 1,
+        Hull = 2,
+        Domain = 3,
+        Geometry = 4,
+        Pixel = 5,
+    };
+
+    // Matches D3D12_ROOT_PARAMETER_TYPE.
+    enum class ParameterType : uint32_t
+    {
+        DescriptorTable = 0,
+        Constants = 1,
+        CBV = 2,
+        SRV = 3,
+        UAV = 4,
+    };
+
+    // How often the resource bound to a register changes.
+    enum class UpdateFrequency : uint32_t
+    {
+        PerFrame = 0,
+        PerPass = 1,
+        PerMaterial = 2,
+        PerDraw = 3,
+    };
+
+    // The maximum size of a root signature in DWORDs.
+    static constexpr uint32_t MaxRootSignatureDWORDs = 64;
+
+    // The number of descriptors of an unbounded range (for example, a bindless
+    // array of textures). Matches UINT_MAX in D3D12_DESCRIPTOR_RANGE1::NumDescriptors.
+    static constexpr uint32_t UnboundedNumDescriptors = ~0u;
+
+    // A resource that is used by the shaders (typically reflected from the HLSL).
+    struct Binding
+    {
+        BindingType Type = BindingType::SRV;
+        uint32_t ShaderRegister = 0;
+        uint32_t RegisterSpace = 0;
+        uint32_t NumDescriptors = 1;
+        // The size of a constant buffer in bytes (0 for other binding types).
+        uint32_t SizeInBytes = 0;
+        ShaderVisibility Visibility = ShaderVisibility::All;
+        UpdateFrequency Frequency = UpdateFrequency::PerMaterial;
+    };
+
+    struct Settings
+    {
+        // The size of the root signature must not exceed this number of DWORDs.
+        uint32_t MaxRootDWORDs = MaxRootSignatureDWORDs;
+        // Constant buffers up to this size (in DWORDs) are promoted to root constants.
+        uint32_t MaxRootConstantDWORDs = 16;
+        bool PromoteRootConstants = true;
+        bool MergeDescriptorTables = true;
+    };
+
+    struct DescriptorRange
+    {
+        BindingType Type;
+        uint32_t NumDescriptors;
+        uint32_t BaseShaderRegister;
+        uint32_t RegisterSpace;
+        uint32_t OffsetInDescriptorsFromTableStart;
+    };
+
+    struct RootParameter
+    {
+        ParameterType Type;
+        ShaderVisibility Visibility;
+        UpdateFrequency Frequency;
+        // Root constants.
+        uint32_t ShaderRegister;
+        uint32_t RegisterSpace;
+        uint32_t Num32BitValues;
+        // Descriptor tables.
+        std::vector<DescriptorRange> Ranges;
+    };
+
+    // The location of a binding in the optimized root signature.
+    struct BindingLocation
+    {
+        uint32_t RootParameterIndex;
+        // The offset of the descriptor in the descriptor table
+        // (0 for root constants).
+        uint32_t DescriptorOffset;
+    };
+
+    struct Layout
+    {
+        std::vector<RootParameter> Parameters;
+        // The location of each of the input bindings (in the same order as the bindings).
+        std::vector<BindingLocation> Remap;
+        // The size of the root signature in DWORDs.
+        uint32_t NumDWORDs = 0;
+    };
+
+    /**
+     * Build an optimized root signature layout for the bindings.
+     * Bindings with the same type, register and space are treated as a single
+     * binding (for example, a constant buffer that is used by multiple stages
+     * is made visible to all stages).
+     */
+    static Layout Optimize(const std::vector<Binding>& bindings);
+    static Layout Optimize(const std::vector<Binding>& bindings, const Settings& settings);
+
+    /**
+     * The cost of a root parameter in DWORDs.
+     */
+    static uint32_t GetDWORDCost(const RootParameter& rootParameter);
+};
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+/**
+ * The description of a single shader (permutation) to build.
+ */
+struct ShaderDesc
+{
+    // The HLSL source file.
+    std::string Source;
+    std::string EntryPoint = "main";
+    // The shader profile (for example, vs_5_1).
+    std::string Profile;
+    // Preprocessor definitions (NAME or NAME=VALUE) that select the permutation.
+    std::vector<std::string> Defines;
+    std::vector<std::string> IncludeDirs;
+    // Disable optimizations and generate debug information.
+    bool Debug = false;
+};
+
+/**
+ * Invokes an offline shader compiler (FXC or DXC) to preprocess and
+ * compile HLSL shaders.
+ *
+ * Used by the ShaderBuild tool and by the ShaderReloader, so reloaded
+ * shaders are compiled with the same compiler and options as the build.
+ */
+class ShaderCompiler
+{
+public:
+    enum class Backend
+    {
+        FXC,
+        DXC,
+    };
+
+    ShaderCompiler(Backend backend, const std::string& compilerPath);
+
+    /**
+     * Parse the name of a backend ("fxc" or "dxc").
+     *
+     * @return false if the name is not a valid backend.
+     */
+    static bool ParseBackend(const std::string& name, Backend& backend);
+
+    Backend GetBackend() const
+    {
+        return m_Backend;
+    }
+
+    /**
+     * Get the profile the shader is compiled with. DXC only supports shader
+     * model 6.0 and up, so older shader models are promoted to 6.0.
+     */
+    std::string GetProfile(const ShaderDesc& shaderDesc) const;
+
+    /**
+     * Identifies the compiler (backend, path, and the size and time stamp
+     * of the compiler executable) so that the cache is invalidated when the
+     * compiler is updated.
+     */
+    std::string GetCompilerId() const;
+
+    /**
+     * The compiler options that affect the generated bytecode.
+     */
+    std::vector<std::string> GetCompileOptions(const ShaderDesc& shaderDesc) const;
+
+    /**
+     * Write the preprocessed source of the shader to a file.
+     * The preprocessed source includes all of the included files, so it
+     * identifies the contents of the shader.
+     */
+    bool Preprocess(const ShaderDesc& shaderDesc, const std::string& outputFile, std::string& errors) const;
+
+    /**
+     * Get the files that a preprocessed source was read from (the shader and
+     * the files it includes) from the #line directives of the preprocessor.
+     * The files are returned in the order they are first seen.
+     */
+    static std::vector<std::string> GetSourceFiles(const std::string& preprocessedSource);
+
+    /**
+     * Compile the shader to a bytecode file.
+     *
+     * @param listingFile If not empty, the assembly listing of the shader is
+     * written to this file. The listing contains the reflection data of the
+     * shader (see ShaderReflect).
+     */
+    bool Compile(const ShaderDesc& shaderDesc, const std::string& outputFile, const std::string& listingFile, std::string& errors) const;
+
+private:
+    // Common options for preprocessing and compiling.
+    std::vector<std::string> GetPreprocessorOptions(const ShaderDesc& shaderDesc) const;
+
+    // Run the compiler with the arguments. The output of the compiler is returned in output.
+    bool Run(const std::vector<std::string>& arguments, const std::string& outputFile, std::string& output) const;
+
+    // Prefix an option with / (FXC) or - (DXC).
+    std::string Option(const char* name) const;
+
+    Backend m_Backend;
+    std::string m_CompilerPath;
+};
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstdint>
+#include <filesystem>
+#include <map>
+#include <set>
+#include <vector>
+
+/**
+ * Tracks which shaders depend on which files (the source file and the files
+ * it includes) and which pipelines use which shaders, so only the pipelines
+ * that are affected by a changed file are rebuilt when shaders are reloaded.
+ *
+ * Shaders and pipelines are identified by integer ids that are assigned by
+ * the owner of the graph (see ShaderReloader). The graph does not depend on
+ * Direct3D.
+ */
+class ShaderDependencyGraph
+{
+public:
+    using ShaderId = uint32_t;
+    using PipelineId = uint32_t;
+
+    /**
+     * Set the files that a shader depends on. Replaces the previous files
+     * of the shader (the includes may change when the shader is edited).
+     */
+    void SetShaderFiles(ShaderId shader, const std::vector<std::filesystem::path>& files);
+
+    /**
+     * Set the shaders that are used by a pipeline.
+     */
+    void SetPipelineShaders(PipelineId pipeline, const std::vector<ShaderId>& shaders);
+
+    void RemovePipeline(PipelineId pipeline);
+
+    /**
+     * Get the shaders that depend on any of the files.
+     */
+    std::set<ShaderId> GetShaders(const std::vector<std::filesystem::path>& files) const;
+
+    /**
+     * Get the pipelines that use any of the shaders.
+     */
+    std::set<PipelineId> GetPipelines(const std::set<ShaderId>& shaders) const;
+
+    /**
+     * Get the shaders that are used by a pipeline.
+     */
+    const std::vector<ShaderId>& GetPipelineShaders(PipelineId pipeline) const;
+
+    /**
+     * Get the directories of all of the files that shaders depend on
+     * (the directories that must be watched).
+     */
+    std::set<std::filesystem::path> GetDirectories() const;
+
+    // Files are compared by their canonical path.
+    static std::filesystem::path NormalizePath(const std::filesystem::path& path);
+
+private:
+    std::map< ShaderId, std::vector<std::filesystem::path> > m_ShaderFiles;
+    std::map< std::filesystem::path, std::set<ShaderId> > m_FileShaders;
+    std::map< PipelineId, std::vector<ShaderId> > m_PipelineShaders;
+    std::map< ShaderId, std::set<PipelineId> > m_ShaderPipelines;
+};
@@ -0,0 +1,191 @@
+#pragma once
+
+#include <FileWatcher.h>
+#include <ShaderDependencyGraph.h>
+
+#include <d3d12.h>
+#include <wrl.h>
+
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <future>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+class ThreadPool;
+
+/**
+ * Reloads shaders when their source files change (hot shader reload).
+ *
+ * Shaders are loaded from their compiled bytecode and their source files
+ * (and the files they include) are watched for changes. When a file changes,
+ * the shaders that depend on it are recompiled on the thread pool and only the
+ * pipelines that use these shaders are rebuilt (also on the thread pool). The
+ * new pipelines are swapped in by Update, which must be called at a frame
+ * boundary on the main thread. Update never waits for the background work,
+ * so the render loop keeps using the old pipelines until the new ones are ready.
+ *
+ * Shaders are recompiled with the offline compiler that built them (see
+ * ShaderCompiler and shader_build_definitions in ShaderBuild.cmake). If a
+ * shader fails to compile, the error is written to the debug output and the
+ * pipelines that use the shader are not rebuilt.
+ */
+class ShaderReloader
+{
+public:
+    using ShaderId = ShaderDependencyGraph::ShaderId;
+    using PipelineId = ShaderDependencyGraph::PipelineId;
+
+    struct ShaderDesc
+    {
+        // The HLSL source file that is watched and recompiled.
+        std::filesystem::path SourceFile;
+        // The compiled shader that is loaded when the shader is added (built by ShaderBuild).
+        std::filesystem::path BytecodeFile;
+        std::string EntryPoint = "main";
+        // The shader profile (for example, vs_5_1). DXC promotes it to shader model 6.
+        std::string Profile;
+
+        // The compiler backend (fxc or dxc), the path to the compiler and the
+        // debug option the bytecode was built with (SHADER_BUILD_BACKEND,
+        // SHADER_COMPILER and SHADER_BUILD_DEBUG). Shaders without a compiler
+        // are not reloaded.
+        std::string Backend;
+        std::filesystem::path CompilerPath;
+        bool Debug = false;
+    };
+
+    // The bytecode of the shaders of a pipeline (in the order the shaders were added to the pipeline).
+    using Bytecode = std::vector< Microsoft::WRL::ComPtr<ID3DBlob> >;
+
+    // Swaps in a rebuilt pipeline. Invoked by Update (at a frame boundary).
+    using CommitFunction = std::function<void()>;
+
+    // Builds a pipeline from the bytecode of its shaders. Invoked on the thread pool.
+    using PipelineBuilder = std::function<CommitFunction(const Bytecode& shaders)>;
+
+    struct Statistics
+    {
+        // The number of times shaders were recompiled because files changed.
+        uint32_t NumReloads;
+        uint32_t NumCompiledShaders;
+        uint32_t NumFailedShaders;
+        uint32_t NumRebuiltPipelines;
+    };
+
+    // Changes are only processed after the files have not changed for this long
+    // (editors may write a file multiple times when it is saved).
+    static constexpr std::chrono::milliseconds SettleTime = std::chrono::milliseconds(100);
+
+    explicit ShaderReloader(std::shared_ptr<ThreadPool> threadPool);
+    virtual ~ShaderReloader();
+
+    ShaderReloader(const ShaderReloader&) = delete;
+    ShaderReloader& operator=(const ShaderReloader&) = delete;
+
+    /**
+     * Load the bytecode of a shader and watch its source file and the
+     * files it includes.
+     */
+    ShaderId AddShader(const ShaderDesc& shaderDesc);
+
+    /**
+     * Get the current bytecode of a shader.
+     */
+    Microsoft::WRL::ComPtr<ID3DBlob> GetBytecode(ShaderId shader) const;
+
+    /**
+     * Register a pipeline that is rebuilt with the builder when any of its shaders is reloaded.
+     * The pipeline itself is created by the caller (the builder is only used to rebuild it).
+     */
+    PipelineId AddPipeline(const std::vector<ShaderId>& shaders, PipelineBuilder builder);
+
+    /**
+     * Unregister a pipeline. Waits for a reload that is in progress, so the
+     * builder of the pipeline is not invoked after this function returns.
+     */
+    void RemovePipeline(PipelineId pipeline);
+
+    /**
+     * Process file changes and swap in the pipelines that were rebuilt.
+     * Call once per frame at a frame boundary. Never blocks.
+     */
+    void Update();
+
+    /**
+     * Wait for the reload that is in progress (if any) to finish.
+     */
+    void Wait();
+
+    const Statistics& GetStatistics() const
+    {
+        return m_Statistics;
+    }
+
+private:
+    struct Shader
+    {
+        ShaderDesc Desc;
+        Microsoft::WRL::ComPtr<ID3DBlob> Bytecode;
+    };
+
+    // The result of compiling a shader on the thread pool.
+    struct CompiledShader
+    {
+        ShaderId Id;
+        Microsoft::WRL::ComPtr<ID3DBlob> Bytecode;
+        // The source file and the files it includes.
+        std::vector<std::filesystem::path> Files;
+        std::string Errors;
+    };
+
+    struct RebuiltPipeline
+    {
+        PipelineId Id;
+        CommitFunction Commit;
+    };
+
+    struct ReloadResult
+    {
+        std::vector<CompiledShader> Shaders;
+        std::vector<RebuiltPipeline> Pipelines;
+    };
+
+    // Start recompiling the shaders that depend on the changed files.
+    void StartReload();
+
+    // Apply the result of a reload (at a frame boundary).
+    void FinishReload(ReloadResult& result);
+
+    // Watch the directories of the files the shaders depend on.
+    void WatchDirectories();
+
+    // Preprocess a shader to find the source file and the files it includes.
+    // Returns an empty list if the shader can't be preprocessed.
+    static std::vector<std::filesystem::path> GetShaderFiles(const ShaderDesc& shaderDesc, std::string& errors);
+
+    // Compile a shader and record the files it includes. Runs on the thread pool.
+    static CompiledShader CompileShader(ShaderId id, const ShaderDesc& shaderDesc);
+
+    std::shared_ptr<ThreadPool> m_ThreadPool;
+
+    FileWatcher m_FileWatcher;
+    ShaderDependencyGraph m_DependencyGraph;
+
+    std::vector<Shader> m_Shaders;
+    std::map<PipelineId, PipelineBuilder> m_Pipelines;
+    PipelineId m_NextPipelineId;
+
+    // Files that changed since the last reload was started.
+    std::vector<std::filesystem::path> m_ChangedFiles;
+    std::chrono::steady_clock::time_point m_LastChangeTime;
+
+    // The reload that is in progress on the thread pool.
+    std::future<ReloadResult> m_Reload;
+
+    Statistics m_Statistics;
+};
@@ -0,0 +1,162 @@
+#pragma once
+
+#include <Profiler.h>
+#include <TripleBuffer.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <thread>
+
+/**
+ * Runs the simulation of a game on a separate thread at a fixed tick rate,
+ * decoupled from rendering.
+ *
+ * After each tick, the simulation thread publishes a snapshot with the
+ * previous and the current state through a TripleBuffer. The render thread
+ * picks up the latest snapshot and interpolates between the two states with
+ * GetAlpha, so a slow frame does not stall the simulation and a slow tick
+ * does not stall rendering. The rendered state lags one tick behind the
+ * simulation.
+ *
+ * State is copied into every snapshot, so it should only contain what is
+ * needed for rendering (for example, transforms).
+ */
+template<typename State>
+class SimulationThread
+{
+public:
+    struct Snapshot
+    {
+        // The state before the last tick.
+        State Previous;
+        // The state after the last tick.
+        State Current;
+        // The number of ticks that were simulated.
+        uint64_t Tick = 0;
+        // The simulation time of the current state in seconds.
+        double Time = 0.0;
+    };
+
+    /**
+     * Advance the state by one tick.
+     * @param deltaTime The duration of a tick in seconds.
+     * @param totalTime The simulation time after the tick in seconds.
+     */
+    using UpdateFunction = std::function<void(State& state, double deltaTime, double totalTime)>;
+
+    SimulationThread(double ticksPerSecond, const State& initialState, UpdateFunction update)
+        : m_TickDuration(1.0 / ticksPerSecond)
+        , m_State(initialState)
+        , m_Update(std::move(update))
+        , m_Snapshots(Snapshot{ initialState, initialState, 0, 0.0 })
+        , m_Stop(false)
+    {}
+
+    ~SimulationThread()
+    {
+        Stop();
+    }
+
+    SimulationThread(const SimulationThread&) = delete;
+    SimulationThread& operator=(const SimulationThread&) = delete;
+
+    // Start the simulation thread.
+    void Start()
+    {
+        if (m_Thread.joinable())
+        {
+            return;
+        }
+
+        // Continue at the simulation time where the simulation was stopped.
+        m_Stop = false;
+        m_StartTime = Clock::now() - ToDuration(m_Tick * m_TickDuration);
+        m_Thread = std::thread(&SimulationThread::Run, this);
+    }
+
+    // Stop the simulation thread. The state is kept, so the simulation can be resumed.
+    void Stop()
+    {
+        m_Stop = true;
+        if (m_Thread.joinable())
+        {
+            m_Thread.join();
+        }
+    }
+
+    /**
+     * Get the latest snapshot (render thread only).
+     * The snapshot stays valid until the next call.
+     */
+    const Snapshot& GetSnapshot()
+    {
+        m_Snapshots.Update();
+        return m_Snapshots.GetFront();
+    }
+
+    /**
+     * The interpolation factor between the previous and the current state of
+     * the snapshot for the current time, in the range [0, 1].
+     */
+    double GetAlpha(const Snapshot& snapshot) const
+    {
+        double now = std::chrono::duration<double>(Clock::now() - m_StartTime).count();
+        return std::clamp((now - snapshot.Time) / m_TickDuration, 0.0, 1.0);
+    }
+
+    // The duration of a tick in seconds.
+    double GetTickDuration() const
+    {
+        return m_TickDuration;
+    }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    static Clock::duration ToDuration(double seconds)
+    {
+        return std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(seconds));
+    }
+
+    void Run()
+    {
+        Profiler::Get().SetThreadName("Simulation");
+
+        while (!m_Stop)
+        {
+            // Ticks are scheduled relative to the start time so sleep inaccuracies don't accumulate.
+            double time = (m_Tick + 1) * m_TickDuration;
+            std::this_thread::sleep_until(m_StartTime + ToDuration(time));
+
+            Snapshot& snapshot = m_Snapshots.GetBack();
+            snapshot.Previous = m_State;
+
+            {
+                PROFILE_SCOPE("SimulationThread::Update");
+                m_Update(m_State, m_TickDuration, time);
+            }
+            ++m_Tick;
+
+            snapshot.Current = m_State;
+            snapshot.Tick = m_Tick;
+            snapshot.Time = time;
+            m_Snapshots.Publish();
+        }
+    }
+
+    double m_TickDuration;
+
+    // Only accessed by the simulation thread while it is running.
+    State m_State;
+    UpdateFunction m_Update;
+    uint64_t m_Tick = 0;
+
+    TripleBuffer<Snapshot> m_Snapshots;
+
+    Clock::time_point m_StartTime;
+    std::atomic<bool> m_Stop;
+    std::thread m_Thread;
+};
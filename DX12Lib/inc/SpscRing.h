@@ -0,0 +1,97 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+/**
+ * A fixed-capacity ring buffer for a single producer thread and a single
+ * consumer thread. TryPush and TryPop are wait-free.
+ *
+ * Each side keeps a cached copy of the other side's index, so the shared
+ * indices are only read when the ring looks full (or empty).
+ */
+template<typename T>
+class SpscRing
+{
+public:
+    /**
+     * @param capacity The maximum number of items in the ring (rounded up to a power of two).
+     */
+    explicit SpscRing(size_t capacity)
+        : m_Tail(0)
+        , m_CachedHead(0)
+        , m_Head(0)
+        , m_CachedTail(0)
+    {
+        size_t size = 1;
+        while (size < capacity)
+        {
+            size <<= 1;
+        }
+        m_Mask = size - 1;
+        m_Items = std::make_unique<T[]>(size);
+    }
+
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+
+    /**
+     * Add an item (producer thread only).
+     * @return false if the ring is full.
+     */
+    bool TryPush(const T& item)
+    {
+        size_t tail = m_Tail.load(std::memory_order_relaxed);
+        if (tail - m_CachedHead > m_Mask)
+        {
+            m_CachedHead = m_Head.load(std::memory_order_acquire);
+            if (tail - m_CachedHead > m_Mask)
+            {
+                return false;
+            }
+        }
+
+        m_Items[tail & m_Mask] = item;
+        m_Tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * Remove the oldest item (consumer thread only).
+     * @return false if the ring is empty.
+     */
+    bool TryPop(T& item)
+    {
+        size_t head = m_Head.load(std::memory_order_relaxed);
+        if (head == m_CachedTail)
+        {
+            m_CachedTail = m_Tail.load(std::memory_order_acquire);
+            if (head == m_CachedTail)
+            {
+                return false;
+            }
+        }
+
+        item = m_Items[head & m_Mask];
+        m_Head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    size_t GetCapacity() const
+    {
+        return m_Mask + 1;
+    }
+
+private:
+    std::unique_ptr<T[]> m_Items;
+    size_t m_Mask;
+
+    // Written by the producer.
+    alignas(64) std::atomic<size_t> m_Tail;
+    size_t m_CachedHead;
+
+    // Written by the consumer.
+    alignas(64) std::atomic<size_t> m_Head;
+    size_t m_CachedTail;
+};
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+/**
+ * A fixed-size pool of worker threads that execute tasks in FIFO order.
+ *
+ * Used to move expensive work (for example, pipeline state and root
+ * signature creation) off the main thread. The thread pool does not
+ * depend on Direct3D.
+ */
+class ThreadPool
+{
+public:
+    /**
+     * Create a thread pool.
+     *
+     * @param numThreads The number of worker threads. If 0, one thread less
+     * than the number of hardware threads is used (but at least one).
+     */
+    explicit ThreadPool(size_t numThreads = 0);
+
+    /**
+     * Waits for all of the submitted tasks to finish before the worker
+     * threads are joined.
+     */
+    virtual ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     * Submit a task to the thread pool.
+     *
+     * @return A future that receives the result of the task (or the exception
+     * that was thrown by the task).
+     */
+    template<typename Function>
+    std::future< std::invoke_result_t<Function> > Submit(Function&& function)
+    {
+        using ResultType = std::invoke_result_t<Function>;
+
+        auto task = std::make_shared< std::packaged_task<ResultType()> >(std::forward<Function>(function));
+        std::future<ResultType> future = task->get_future();
+
+        Enqueue([task]() { (*task)(); });
+
+        return future;
+    }
+
+    /**
+     * Block until all submitted tasks have finished.
+     */
+    void WaitIdle();
+
+    size_t GetNumThreads() const
+    {
+        return m_Threads.size();
+    }
+
+    // The number of tasks that are queued or running.
+    size_t GetNumPendingTasks() const;
+
+private:
+    void Enqueue(std::function<void()> task);
+    void WorkerThread();
+
+    std::vector<std::thread> m_Threads;
+    std::queue< std::function<void()> > m_Tasks;
+
+    // The number of tasks that are queued or running.
+    size_t m_NumPendingTasks;
+    bool m_Stop;
+
+    mutable std::mutex m_Mutex;
+    std::condition_variable m_TaskAvailable;
+    std::condition_variable m_Idle;
+};
@@ -0,0 +1,140 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * The bookkeeping of the timestamp queries of the GPU profiler.
+ *
+ * The queries are split into a region for each frame in flight. The scopes
+ * of a frame write a timestamp at the start and at the end of the scope into
+ * the region of the frame and the region is resolved to a readback buffer at
+ * the end of the frame. The timestamps of a frame are read a few frames later,
+ * when the fence value of the frame has completed, so reading the timestamps
+ * never waits for the GPU. If the region of a frame is still in flight when
+ * the frame starts, the scopes of the frame are not measured (the frame is skipped).
+ *
+ * The ring does not depend on Direct3D (the query indices are used with
+ * ID3D12GraphicsCommandList::EndQuery and ResolveQueryData, or with the NullDevice).
+ */
+class TimestampQueryRing
+{
+public:
+    // Returned from BeginScope and EndScope if the scope is not measured.
+    static constexpr uint32_t InvalidQuery = ~0u;
+
+    struct Settings
+    {
+        // The number of frames that can be in flight before the timestamps are read.
+        uint32_t NumFrames = 4;
+        uint32_t MaxScopesPerFrame = 256;
+    };
+
+    struct ScopeTiming
+    {
+        std::string Name;
+        // The nesting level of the scope (0 for scopes that are not nested).
+        uint32_t Depth;
+        // The GPU time of the scope in seconds.
+        double Time;
+    };
+
+    TimestampQueryRing();
+    explicit TimestampQueryRing(const Settings& settings);
+
+    // The number of queries (the size of the query heap and of the readback buffer in timestamps).
+    uint32_t GetNumQueries() const;
+
+    /**
+     * Read the timestamps of the frames whose fence value has completed.
+     * @param timestamps The readback buffer (GetNumQueries timestamps).
+     * @param frequency The number of timestamp ticks per second.
+     */
+    void Resolve(uint64_t completedFenceValue, const uint64_t* timestamps, uint64_t frequency);
+
+    void BeginFrame();
+
+    /**
+     * @return The index of the query to write the start timestamp to,
+     * or InvalidQuery if the scope is not measured.
+     */
+    uint32_t BeginScope(const std::string& name);
+
+    /**
+     * End the last scope that was started.
+     * @return The index of the query to write the end timestamp to,
+     * or InvalidQuery if the scope is not measured.
+     */
+    uint32_t EndScope();
+
+    /**
+     * End the recording of the frame.
+     * @param firstQuery, numQueries The queries to resolve. If numQueries is 0,
+     * there is nothing to resolve and Submit must not be called.
+     */
+    void EndFrame(uint32_t& firstQuery, uint32_t& numQueries);
+
+    /**
+     * Set the fence value that is signaled after the queries of the
+     * last frame have been resolved.
+     */
+    void Submit(uint64_t fenceValue);
+
+    // The timings of the last frame that was read.
+    const std::vector<ScopeTiming>& GetTimings() const;
+
+    // The timings of the last frame that was read as a text table (nested scopes are indented).
+    std::string GetTimingsTable() const;
+
+    // The number of frames that were read.
+    uint64_t GetNumResolvedFrames() const;
+
+    // The number of frames that were not measured because their region was still in flight.
+    uint64_t GetNumSkippedFrames() const;
+
+    // The number of scopes that were not measured because the frame had more than MaxScopesPerFrame scopes.
+    uint64_t GetNumDroppedScopes() const;
+
+private:
+    enum class FrameState
+    {
+        Free,
+        Recording,
+        // Recorded, but not yet submitted.
+        Closed,
+        Submitted,
+    };
+
+    struct Scope
+    {
+        std::string Name;
+        uint32_t Depth;
+        uint32_t BeginQuery;
+        uint32_t EndQuery;
+    };
+
+    struct Frame
+    {
+        FrameState State = FrameState::Free;
+        uint64_t FenceValue = 0;
+        uint32_t NumQueries = 0;
+        std::vector<Scope> Scopes;
+    };
+
+    Settings m_Settings;
+    std::vector<Frame> m_Frames;
+
+    // The region of the next frame that is recorded. The regions are used in order.
+    uint32_t m_CurrentFrame;
+    // The next region to read.
+    uint32_t m_ResolveFrame;
+    bool m_IsRecording;
+    // The scopes that are open in the current frame (InvalidQuery for scopes that are not measured).
+    std::vector<uint32_t> m_OpenScopes;
+
+    std::vector<ScopeTiming> m_Timings;
+    uint64_t m_NumResolvedFrames;
+    uint64_t m_NumSkippedFrames;
+    uint64_t m_NumDroppedScopes;
+};
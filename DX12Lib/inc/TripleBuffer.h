@@ -0,0 +1,88 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+/**
+ * Exchanges values between a single writer thread and a single reader thread
+ * without locks and without blocking either thread.
+ *
+ * The writer fills the back buffer and publishes it. The reader picks up the
+ * most recently published buffer (older buffers that were not picked up are
+ * skipped). The writer and the reader never wait for each other, so a slow
+ * reader does not stall the writer and vice versa.
+ *
+ * The three buffers are rotated through a single atomic index: the writer owns
+ * the back buffer, the reader owns the front buffer and the middle buffer holds
+ * the last published value.
+ */
+template<typename T>
+class TripleBuffer
+{
+public:
+    TripleBuffer()
+        : m_Middle(1)
+        , m_BackIndex(0)
+        , m_FrontIndex(2)
+    {}
+
+    explicit TripleBuffer(const T& initialValue)
+        : TripleBuffer()
+    {
+        m_Buffers[0] = initialValue;
+        m_Buffers[1] = initialValue;
+        m_Buffers[2] = initialValue;
+    }
+
+    TripleBuffer(const TripleBuffer&) = delete;
+    TripleBuffer& operator=(const TripleBuffer&) = delete;
+
+    // The buffer the writer fills before it is published (writer thread only).
+    T& GetBack()
+    {
+        return m_Buffers[m_BackIndex];
+    }
+
+    // Publish the back buffer (writer thread only).
+    void Publish()
+    {
+        uint8_t middle = m_Middle.exchange(m_BackIndex | PublishedFlag, std::memory_order_acq_rel);
+        m_BackIndex = middle & IndexMask;
+    }
+
+    /**
+     * Make the most recently published buffer the front buffer (reader thread only).
+     * @return false if nothing was published since the last call.
+     */
+    bool Update()
+    {
+        if ((m_Middle.load(std::memory_order_relaxed) & PublishedFlag) == 0)
+        {
+            return false;
+        }
+
+        uint8_t middle = m_Middle.exchange(m_FrontIndex, std::memory_order_acq_rel);
+        m_FrontIndex = middle & IndexMask;
+        return true;
+    }
+
+    // The buffer the reader uses (reader thread only).
+    const T& GetFront() const
+    {
+        return m_Buffers[m_FrontIndex];
+    }
+
+private:
+    static const uint8_t IndexMask = 0x3;
+    // Set if the middle buffer was published but not yet picked up by the reader.
+    static const uint8_t PublishedFlag = 0x4;
+
+    T m_Buffers[3];
+
+    // The index of the middle buffer and the published flag.
+    alignas(64) std::atomic<uint8_t> m_Middle;
+    // Only accessed by the writer.
+    alignas(64) uint8_t m_BackIndex;
+    // Only accessed by the reader.
+    alignas(64) uint8_t m_FrontIndex;
+};
@@ -1,12 +1,16 @@
 #pragma once
 
 #include <Defines.h>
+#include <Device.h>
 
-#include <wrl.h>
-#include <d3d12.h>
+#include <cstddef>
 #include <memory>
 #include <deque>
 
+/**
+ * A linear allocator for upload memory. Pages are created with
+ * Device::CreateUploadBuffer and reused after the upload buffer is reset.
+ */
 class UploadBuffer
 {
 public:
@@ -14,13 +18,18 @@ public:
     struct Allocation
     {
         void* CPU;
-        D3D12_GPU_VIRTUAL_ADDRESS GPU;
+        // The GPU virtual address (D3D12_GPU_VIRTUAL_ADDRESS).
+        uint64_t GPU;
+        // The upload resource and the offset of the allocation in the resource.
+        // Used as the source of a CopyBufferRegion.
+        Device::Resource* Resource;
+        size_t Offset;
     };
 
     /**
      * @param pageSize The size to use to allocate new pages in GPU memory.
      */
-    explicit UploadBuffer(size_t pageSize = _2MB);
+    explicit UploadBuffer(Device& device, size_t pageSize = _2MB);
 
     virtual ~UploadBuffer();
 
@@ -48,8 +57,7 @@ private:
     // A single page for the allocator.
     struct Page
     {
-        Page(size_t sizeInBytes);
-        ~Page();
+        Page(Device& device, size_t sizeInBytes);
 
         // Check to see if the page has room to satisfy the requested allocation.
         bool HasSpace(size_t sizeInBytes, size_t alignment ) const;
@@ -63,11 +71,12 @@ private:
         void Reset();
 
     private:
-        Microsoft::WRL::ComPtr<ID3D12Resource> m_d3d12Resource;
+        // The upload buffer of the page (mapped while the page is alive).
+        std::shared_ptr<Device::Resource> m_Resource;
 
         // Base pointer.
         void* m_CPUPtr;
-        D3D12_GPU_VIRTUAL_ADDRESS m_GPUPtr;
+        uint64_t m_GPUPtr;
 
         // Allocated page size.
         size_t m_PageSize;
@@ -82,6 +91,8 @@ private:
     // or create a new page if there are no available pages.
     std::shared_ptr<Page> RequestPage();
 
+    Device& m_Device;
+
     PagePool m_PagePool;
     PagePool m_AvailablePages;
 
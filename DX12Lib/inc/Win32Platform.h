@@ -0,0 +1,18 @@
+#pragma once
+
+#include <Platform.h>
+
+/**
+ * Runs the Windows message loop. The messages of the windows are converted
+ * to events by the window procedure of the Application.
+ */
+class Win32Platform : public Platform
+{
+public:
+    int Run() override;
+    void Quit(int exitCode) override;
+    double GetTime() const override;
+
+    void AddWindow(PlatformWindow* window) override;
+    void RemoveWindow(PlatformWindow* window) override;
+};
@@ -7,14 +7,22 @@
 #include <d3d12.h>
 #include <dxgi1_5.h>
 
+#include <EventBus.h>
 #include <Events.h>
+#include <FixedStepScheduler.h>
+#include <FramePacer.h>
+#include <FrameStats.h>
 #include <HighResolutionClock.h>
+#include <InputQueue.h>
+#include <Platform.h>
+
+#include <vector>
 
 using Microsoft::WRL::ComPtr;
 
 class Game;
 
-class Window
+class Window : public PlatformWindow
 {
 public:
     // Number of swapchain back buffers.
@@ -83,6 +91,46 @@ public:
      */
     Microsoft::WRL::ComPtr<ID3D12Resource> GetCurrentBackBuffer() const;
 
+    /**
+     * Get the frame pacer for this window.
+     * The frame pacer also provides the timing statistics of the last frames.
+     */
+    const FramePacer& GetFramePacer() const;
+
+    /**
+     * Configure the frame pacing (frames in flight, frame latency, CPU frame-time budget).
+     * The number of frames in flight is limited to the number of back buffers (BufferCount).
+     */
+    void SetFramePacerSettings(const FramePacer::Settings& settings);
+
+    /**
+     * Get the statistics of the time between updates and between renders
+     * (percentiles, hitches and the last frame times).
+     */
+    const FrameStats& GetUpdateFrameStats() const;
+    const FrameStats& GetRenderFrameStats() const;
+
+    /**
+     * Get the bus the input events (KeyEventArgs, MouseMotionEventArgs,
+     * MouseButtonEventArgs and MouseWheelEventArgs) are published on at the
+     * start of each update. The registered game is subscribed to the bus.
+     */
+    EventBus& GetEventBus();
+
+    /**
+     * Update the game with a fixed time step. Game::OnUpdate is called zero or
+     * more times per frame (limited by MaxStepsPerFrame) and RenderEventArgs::Alpha
+     * is the interpolation factor between the last two steps.
+     */
+    void SetFixedStep(const FixedStepScheduler::Settings& settings);
+
+    // Update the game once per frame with the variable frame time (the default).
+    void SetVariableStep();
+
+    bool IsFixedStep() const;
+
+    const FixedStepScheduler& GetFixedStepScheduler() const;
+
 protected:
      // The Window procedure needs to call protected methods of this class.
     friend LRESULT CALLBACK WndProc(HWND hwnd, UINT message, WPARAM wParam, LPARAM lParam);
@@ -94,7 +142,7 @@ protected:
 
     Window() = delete;
     Window(HWND hwnd, const std::wstring& windowName, int clientWidth, int clientHeight, bool vSync);
-    virtual ~Window();
+    virtual ~Window() override;
     
     // Register a Game with this window. This allows 
     // the window to callback functions in the Game class.
@@ -104,19 +152,14 @@ protected:
     virtual void OnUpdate(UpdateEventArgs& e);
     virtual void OnRender(RenderEventArgs& e);
 
-    // A keyboard key was pressed
-    virtual void OnKeyPressed(KeyEventArgs& e);
-    // A keyboard key was released
-    virtual void OnKeyReleased(KeyEventArgs& e);
+    // Queue an input event. The queued events are dispatched at the start of the next update.
+    void QueueInputEvent(const InputQueue::Event& e) override;
+
+    // Resize the client area (invokes OnResize).
+    void Resize(int width, int height) override;
 
-    // The mouse was moved
-    virtual void OnMouseMoved(MouseMotionEventArgs& e);
-    // A button on the mouse was pressed
-    virtual void OnMouseButtonPressed(MouseButtonEventArgs& e);
-    // A button on the mouse was released
-    virtual void OnMouseButtonReleased(MouseButtonEventArgs& e);
-    // The mouse wheel was moved.
-    virtual void OnMouseWheel(MouseWheelEventArgs& e);
+    // Update and render a frame (invokes OnUpdate and OnRender).
+    void Frame() override;
 
     // The window was resized.
     virtual void OnResize(ResizeEventArgs& e);
@@ -127,6 +170,16 @@ protected:
     // Update the render target views for the swapchain back buffers.
     void UpdateRenderTargetViews();
 
+    // Publish the queued input events on the event bus.
+    void DispatchInputEvents();
+
+    // Unsubscribe the input event handlers of the registered game.
+    void UnregisterGameListeners();
+
+    // Block until the next frame is allowed to start.
+    // Returns the time spent waiting for the GPU and the time spent pacing the frame.
+    void WaitForNextFrame(double& gpuWaitTime, double& pacingWaitTime);
+
 private:
     // Windows should not be copied.
     Window(const Window& copy) = delete;
@@ -143,11 +196,34 @@ private:
 
     HighResolutionClock m_UpdateClock;
     HighResolutionClock m_RenderClock;
+    FrameStats m_UpdateFrameStats;
+    FrameStats m_RenderFrameStats;
     uint64_t m_FrameCounter;
 
+    FixedStepScheduler m_FixedStepScheduler;
+    bool m_FixedStep;
+
     std::weak_ptr<Game> m_pGame;
 
+    // Input events from the message pump.
+    InputQueue m_InputQueue;
+    std::vector<InputQueue::Event> m_InputEvents;
+
+    // The input events are published on the event bus in batches of
+    // consecutive events of the same type (the vectors are reused).
+    EventBus m_EventBus;
+    std::vector<KeyEventArgs> m_KeyEvents;
+    std::vector<MouseMotionEventArgs> m_MouseMotionEvents;
+    std::vector<MouseButtonEventArgs> m_MouseButtonEvents;
+    std::vector<MouseWheelEventArgs> m_MouseWheelEvents;
+    std::vector<EventBus::ListenerHandle> m_GameListeners;
+
+    FramePacer m_FramePacer;
+
     ComPtr<IDXGISwapChain4> m_dxgiSwapChain;
+    HANDLE m_FrameLatencyWaitableObject;
+    // Set by Present. The frame latency waitable object is only waited on after a present.
+    bool m_WaitForFrameLatency;
     ComPtr<ID3D12DescriptorHeap> m_d3d12RTVDescriptorHeap;
     ComPtr<ID3D12Resource> m_d3d12BackBuffers[BufferCount];
 
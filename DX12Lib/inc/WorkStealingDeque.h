@@ -0,0 +1,140 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+/**
+ * A fixed-capacity Chase-Lev work-stealing deque.
+ *
+ * The owner thread pushes and pops items at the bottom (LIFO, which keeps
+ * recently pushed work in the cache), while other threads steal items from
+ * the top (FIFO). Push and Pop are wait-free and Steal is lock-free.
+ *
+ * The deque does not grow: Push returns false if the deque is full and the
+ * owner must handle the item another way (for example, execute it directly).
+ * T must be trivially copyable (typically a pointer).
+ *
+ * Based on "Correct and Efficient Work-Stealing for Weak Memory Models"
+ * (Lê, Pop, Cohen, Zappa Nardelli, PPoPP 2013), using sequentially consistent
+ * operations instead of standalone fences.
+ */
+template<typename T>
+class WorkStealingDeque
+{
+public:
+    /**
+     * @param capacity The maximum number of items in the deque (rounded up to a power of two).
+     */
+    explicit WorkStealingDeque(size_t capacity = 4096)
+        : m_Top(0)
+        , m_Bottom(0)
+    {
+        size_t size = 1;
+        while (size < capacity)
+        {
+            size <<= 1;
+        }
+        m_Mask = size - 1;
+        m_Buffer = std::make_unique< std::atomic<T>[] >(size);
+    }
+
+    WorkStealingDeque(const WorkStealingDeque&) = delete;
+    WorkStealingDeque& operator=(const WorkStealingDeque&) = delete;
+
+    /**
+     * Push an item to the bottom of the deque. Only called by the owner.
+     *
+     * @return false if the deque is full.
+     */
+    bool Push(T item)
+    {
+        int64_t bottom = m_Bottom.load(std::memory_order_relaxed);
+        int64_t top = m_Top.load(std::memory_order_acquire);
+        if (bottom - top > static_cast<int64_t>(m_Mask))
+        {
+            return false;
+        }
+
+        m_Buffer[bottom & m_Mask].store(item, std::memory_order_relaxed);
+        // Publish the item before the new bottom is visible to thieves.
+        m_Bottom.store(bottom + 1, std::memory_order_release);
+
+        return true;
+    }
+
+    /**
+     * Pop the most recently pushed item. Only called by the owner.
+     *
+     * @return false if the deque is empty (or the last item was stolen).
+     */
+    bool Pop(T& item)
+    {
+        int64_t bottom = m_Bottom.load(std::memory_order_relaxed) - 1;
+        // Reserve the bottom item before reading the top (must not be reordered).
+        m_Bottom.store(bottom, std::memory_order_seq_cst);
+        int64_t top = m_Top.load(std::memory_order_seq_cst);
+
+        if (top > bottom)
+        {
+            // Empty.
+            m_Bottom.store(bottom + 1, std::memory_order_relaxed);
+            return false;
+        }
+
+        item = m_Buffer[bottom & m_Mask].load(std::memory_order_relaxed);
+        if (top == bottom)
+        {
+            // The last item: race against the thieves for it.
+            bool won = m_Top.compare_exchange_strong(top, top + 1,
+                std::memory_order_seq_cst, std::memory_order_relaxed);
+            m_Bottom.store(bottom + 1, std::memory_order_relaxed);
+            return won;
+        }
+
+        return true;
+    }
+
+    /**
+     * Steal the least recently pushed item. Can be called by any thread.
+     *
+     * @return false if the deque is empty or another thread took the item first.
+     */
+    bool Steal(T& item)
+    {
+        int64_t top = m_Top.load(std::memory_order_seq_cst);
+        int64_t bottom = m_Bottom.load(std::memory_order_seq_cst);
+
+        if (top >= bottom)
+        {
+            return false;
+        }
+
+        T stolenItem = m_Buffer[top & m_Mask].load(std::memory_order_relaxed);
+        if (!m_Top.compare_exchange_strong(top, top + 1,
+            std::memory_order_seq_cst, std::memory_order_relaxed))
+        {
+            return false;
+        }
+
+        item = stolenItem;
+        return true;
+    }
+
+    // The number of items in the deque (only an estimate if other threads are stealing).
+    size_t GetSize() const
+    {
+        int64_t bottom = m_Bottom.load(std::memory_order_relaxed);
+        int64_t top = m_Top.load(std::memory_order_relaxed);
+        return bottom > top ? static_cast<size_t>(bottom - top) : 0;
+    }
+
+private:
+    // The top and bottom are on separate cache lines since they are
+    // written by different threads.
+    alignas(64) std::atomic<int64_t> m_Top;
+    alignas(64) std::atomic<int64_t> m_Bottom;
+    size_t m_Mask;
+    std::unique_ptr< std::atomic<T>[] > m_Buffer;
+};
@@ -6,14 +6,30 @@
 
 #include <Game.h>
 #include <CommandQueue.h>
+#include <D3D12Device.h>
+#include <FrameCapture.h>
+#include <GpuProfiler.h>
+#include <HeapAllocator.h>
+#include <Platform.h>
+#include <Profiler.h>
+#include <JobSystem.h>
+#include <MeshBufferPool.h>
+#include <PipelineStateCache.h>
+#include <RootSignatureCache.h>
+#include <ShaderReloader.h>
+#include <ThreadPool.h>
+#include <Win32Platform.h>
 #include <Window.h>
 
 constexpr wchar_t WINDOW_CLASS_NAME[] = L"DX12RenderWindowClass";
+constexpr wchar_t PIPELINE_STATE_CACHE_FILE_NAME[] = L"PipelineStateCache.bin";
 
 using WindowPtr = std::shared_ptr<Window>;
 using WindowMap = std::map< HWND, WindowPtr >;
 using WindowNameMap = std::map< std::wstring, WindowPtr >;
 
+uint64_t Application::ms_FrameCount = 0;
+
 static Application* gs_pSingelton = nullptr;
 static WindowMap gs_Windows;
 static WindowNameMap gs_WindowByName;
@@ -31,10 +47,17 @@ struct MakeWindow : public Window
         : Window(hWnd, windowName, clientWidth, clientHeight, vSync) {}
 };
 
-Application::Application(HINSTANCE hInst) 
+Application::Application(HINSTANCE hInst, std::unique_ptr<Platform> platform) 
     : m_hInstance(hInst), 
+      m_Platform(std::move(platform)),
+      m_FrameCapture(std::make_unique<FrameCapture>()),
       m_TearingSupported(false)
 {
+    if (!m_Platform)
+    {
+        m_Platform = std::make_unique<Win32Platform>();
+    }
+
     // Windows 10 Creators update adds Per Monitor V2 DPI awareness context.
     // Using this awareness context allows the client area of the window 
     // to achieve 100% scaling while still allowing non-client window content to 
@@ -73,19 +96,34 @@ Application::Application(HINSTANCE hInst)
     }
     if (m_d3d12Device)
     {
-        m_DirectCommandQueue  = std::make_shared<CommandQueue>(m_d3d12Device, D3D12_COMMAND_LIST_TYPE_DIRECT);
-        m_ComputeCommandQueue = std::make_shared<CommandQueue>(m_d3d12Device, D3D12_COMMAND_LIST_TYPE_COMPUTE);
-        m_CopyCommandQueue = std::make_shared<CommandQueue>(m_d3d12Device, D3D12_COMMAND_LIST_TYPE_COPY);
+        m_DefaultBufferAllocator = std::make_shared<HeapAllocator>(D3D12_HEAP_TYPE_DEFAULT, D3D12_HEAP_FLAG_ALLOW_ONLY_BUFFERS);
+        m_UploadBufferAllocator = std::make_shared<HeapAllocator>(D3D12_HEAP_TYPE_UPLOAD, D3D12_HEAP_FLAG_ALLOW_ONLY_BUFFERS);
+        m_Device = std::make_unique<D3D12Device>(m_d3d12Device, m_UploadBufferAllocator, *m_FrameCapture);
+
+        m_DirectCommandQueue  = std::make_shared<CommandQueue>(*m_Device, Device::CommandListType::Direct);
+        m_ComputeCommandQueue = std::make_shared<CommandQueue>(*m_Device, Device::CommandListType::Compute);
+        m_CopyCommandQueue = std::make_shared<CommandQueue>(*m_Device, Device::CommandListType::Copy);
+
+        m_GpuProfiler = std::make_unique<GpuProfiler>(m_d3d12Device, m_DirectCommandQueue);
+
+        m_MeshBufferPool = std::make_shared<MeshBufferPool>();
+
+        m_RootSignatureCache = std::make_shared<RootSignatureCache>();
+        m_PipelineStateCache = std::make_shared<PipelineStateCache>(m_d3d12Device, m_dxgiAdapter, PIPELINE_STATE_CACHE_FILE_NAME);
+        m_ThreadPool = std::make_shared<ThreadPool>();
+        m_ShaderReloader = std::make_shared<ShaderReloader>(m_ThreadPool);
+        // The main thread is the first worker of the job system.
+        m_JobSystem = std::make_shared<JobSystem>();
 
         m_TearingSupported = CheckTearingSupport();
     }
 }
 
-void Application::Create(HINSTANCE hInst)
+void Application::Create(HINSTANCE hInst, std::unique_ptr<Platform> platform)
 {
     if (!gs_pSingelton)
     {
-        gs_pSingelton = new Application(hInst);
+        gs_pSingelton = new Application(hInst, std::move(platform));
     }
 }
 
@@ -109,7 +147,19 @@ void Application::Destroy()
 
 Application::~Application()
 {
+    // Finish any background work before the GPU objects are released.
+    if (m_ThreadPool)
+    {
+        m_ThreadPool->WaitIdle();
+    }
+
     Flush();
+
+    // Persist the pipeline states that were compiled during this run.
+    if (m_PipelineStateCache)
+    {
+        m_PipelineStateCache->Save();
+    }
 }
 
 Microsoft::WRL::ComPtr<IDXGIAdapter4> Application::GetAdapter(bool bUseWarp)
@@ -247,6 +297,7 @@ std::shared_ptr<Window> Application::CreateRenderWindow(const std::wstring& wind
 
     WindowPtr pWindow = std::make_shared<MakeWindow>(hwnd, windowName, clientWidth, clientHeight, vSync);
     gs_Windows.insert(WindowMap::value_type(hwnd, pWindow));
+    m_Platform->AddWindow(pWindow.get());
 
     return pWindow;
 }
@@ -278,27 +329,38 @@ std::shared_ptr<Window> Application::GetWindowByName(const std::wstring& windowN
 
 int Application::Run(std::shared_ptr<Game> pGame)
 {
+    Profiler::Get().SetThreadName("Main Thread");
+
     if (!pGame->Initialize()) return 1;
     if (!pGame->LoadContent()) return 2;
-    MSG msg = { 0 };
-    while (msg.message != WM_QUIT)
-    {
-        if (PeekMessage(&msg, 0, 0, 0, PM_REMOVE))
-        {
-            TranslateMessage(&msg);
-            DispatchMessage(&msg);
-        }
-    }
+
+    int exitCode = m_Platform->Run();
+
     // Flush any commands in the commands queues before quiting.
     Flush();
     pGame->UnloadContent();
     pGame->Destroy();
-    return static_cast<int>(msg.wParam);
+    return exitCode;
 }
 
 void Application::Quit(int exitCode)
 {
-    PostQuitMessage(exitCode);
+    m_Platform->Quit(exitCode);
+}
+
+Platform& Application::GetPlatform() const
+{
+    return *m_Platform;
+}
+
+FrameCapture& Application::GetFrameCapture() const
+{
+    return *m_FrameCapture;
+}
+
+GpuProfiler& Application::GetGpuProfiler() const
+{
+    return *m_GpuProfiler;
 }
 
 Microsoft::WRL::ComPtr<ID3D12Device2> Application::GetDevice() const 
@@ -326,11 +388,103 @@ std::shared_ptr<CommandQueue> Application::GetCommandQueue(D3D12_COMMAND_LIST_TY
     return commandQueue;
 }
 
+D3D12Device& Application::GetD3D12Device() const
+{
+    return *m_Device;
+}
+
+std::shared_ptr<HeapAllocator> Application::GetBufferAllocator(D3D12_HEAP_TYPE type) const
+{
+    std::shared_ptr<HeapAllocator> heapAllocator;
+    switch (type)
+    {
+        case D3D12_HEAP_TYPE_DEFAULT:
+            heapAllocator = m_DefaultBufferAllocator;
+            break;
+        case D3D12_HEAP_TYPE_UPLOAD:
+            heapAllocator = m_UploadBufferAllocator;
+            break;
+        default:
+            ASSERT(false && "Invalid heap type.");
+    }
+    return heapAllocator;
+}
+
+std::shared_ptr<MeshBufferPool> Application::GetMeshBufferPool() const
+{
+    return m_MeshBufferPool;
+}
+
+std::shared_ptr<RootSignatureCache> Application::GetRootSignatureCache() const
+{
+    return m_RootSignatureCache;
+}
+
+std::shared_ptr<PipelineStateCache> Application::GetPipelineStateCache() const
+{
+    return m_PipelineStateCache;
+}
+
+std::shared_ptr<ThreadPool> Application::GetThreadPool() const
+{
+    return m_ThreadPool;
+}
+
+std::shared_ptr<ShaderReloader> Application::GetShaderReloader() const
+{
+    return m_ShaderReloader;
+}
+
+std::shared_ptr<JobSystem> Application::GetJobSystem() const
+{
+    return m_JobSystem;
+}
+
 void Application::Flush() 
 {
     m_DirectCommandQueue->Flush();
     m_ComputeCommandQueue->Flush();
     m_CopyCommandQueue->Flush();
+
+    // All GPU work has completed, so stale allocations can be reused.
+    m_FrameFences = std::queue<FrameFence>();
+    m_MeshBufferPool->ReleaseStaleRanges(ms_FrameCount);
+    m_DefaultBufferAllocator->ReleaseStaleAllocations(ms_FrameCount);
+    m_UploadBufferAllocator->ReleaseStaleAllocations(ms_FrameCount);
+
+    // No resources are in use by the GPU, so resources can be moved out of
+    // fragmented heaps and empty heaps can be released.
+    m_DefaultBufferAllocator->Defragment();
+    m_UploadBufferAllocator->Defragment();
+}
+
+void Application::EndFrame(uint64_t fenceValue)
+{
+    m_FrameFences.push({ ms_FrameCount, fenceValue });
+    ++ms_FrameCount;
+}
+
+void Application::ReleaseStaleAllocations()
+{
+    PROFILE_FUNCTION();
+
+    uint64_t completedFenceValue = m_DirectCommandQueue->GetCompletedFenceValue();
+
+    bool frameCompleted = false;
+    uint64_t completedFrame = 0;
+    while (!m_FrameFences.empty() && m_FrameFences.front().FenceValue <= completedFenceValue)
+    {
+        completedFrame = m_FrameFences.front().FrameNumber;
+        frameCompleted = true;
+        m_FrameFences.pop();
+    }
+
+    if (frameCompleted)
+    {
+        m_MeshBufferPool->ReleaseStaleRanges(completedFrame);
+        m_DefaultBufferAllocator->ReleaseStaleAllocations(completedFrame);
+        m_UploadBufferAllocator->ReleaseStaleAllocations(completedFrame);
+    }
 }
 
 Microsoft::WRL::ComPtr<ID3D12DescriptorHeap> Application::CreateDescriptorHeap(UINT numDescriptors, D3D12_DESCRIPTOR_HEAP_TYPE type) 
@@ -359,6 +513,7 @@ static void RemoveWindow(HWND hWnd)
     if (windowIter != gs_Windows.end())
     {
         WindowPtr pWindow = windowIter->second;
+        Application::Get().GetPlatform().RemoveWindow(pWindow.get());
         gs_WindowByName.erase(pWindow->GetWindowName());
         gs_Windows.erase(windowIter);
     }
@@ -415,12 +570,7 @@ static LRESULT CALLBACK WndProc(HWND hwnd, UINT message, WPARAM wParam, LPARAM l
         {
         case WM_PAINT:
         {
-            // Delta time will be filled in by the Window.
-            UpdateEventArgs updateEventArgs(0.0f, 0.0f);
-            pWindow->OnUpdate(updateEventArgs);
-            RenderEventArgs renderEventArgs(0.0f, 0.0f);
-            // Delta time will be filled in by the Window.
-            pWindow->OnRender(renderEventArgs);
+            pWindow->Frame();
         }
         break;
         case WM_SYSKEYDOWN:
@@ -443,7 +593,7 @@ static LRESULT CALLBACK WndProc(HWND hwnd, UINT message, WPARAM wParam, LPARAM l
             KeyCode::Key key = (KeyCode::Key)wParam;
             unsigned int scanCode = (lParam & 0x00FF0000) >> 16;
             KeyEventArgs keyEventArgs(key, c, KeyEventArgs::Pressed, shift, control, alt);
-            pWindow->OnKeyPressed(keyEventArgs);
+            pWindow->QueueInputEvent(keyEventArgs);
         }
         break;
         case WM_SYSKEYUP:
@@ -468,7 +618,7 @@ static LRESULT CALLBACK WndProc(HWND hwnd, UINT message, WPARAM wParam, LPARAM l
             }
 
             KeyEventArgs keyEventArgs(key, c, KeyEventArgs::Released, shift, control, alt);
-            pWindow->OnKeyReleased(keyEventArgs);
+            pWindow->QueueInputEvent(keyEventArgs);
         }
         break;
         // The default window procedure will play a system notification sound 
@@ -488,7 +638,7 @@ static LRESULT CALLBACK WndProc(HWND hwnd, UINT message, WPARAM wParam, LPARAM l
             int y = ((int)(short)HIWORD(lParam));
 
             MouseMotionEventArgs mouseMotionEventArgs(lButton, mButton, rButton, control, shift, x, y);
-            pWindow->OnMouseMoved(mouseMotionEventArgs);
+            pWindow->QueueInputEvent(mouseMotionEventArgs);
         }
         break;
         case WM_LBUTTONDOWN:
@@ -505,7 +655,7 @@ static LRESULT CALLBACK WndProc(HWND hwnd, UINT message, WPARAM wParam, LPARAM l
             int y = ((int)(short)HIWORD(lParam));
 
             MouseButtonEventArgs mouseButtonEventArgs(DecodeMouseButton(message), MouseButtonEventArgs::Pressed, lButton, mButton, rButton, control, shift, x, y);
-            pWindow->OnMouseButtonPressed(mouseButtonEventArgs);
+            pWindow->QueueInputEvent(mouseButtonEventArgs);
         }
         break;
         case WM_LBUTTONUP:
@@ -522,7 +672,7 @@ static LRESULT CALLBACK WndProc(HWND hwnd, UINT message, WPARAM wParam, LPARAM l
             int y = ((int)(short)HIWORD(lParam));
 
             MouseButtonEventArgs mouseButtonEventArgs(DecodeMouseButton(message), MouseButtonEventArgs::Released, lButton, mButton, rButton, control, shift, x, y);
-            pWindow->OnMouseButtonReleased(mouseButtonEventArgs);
+            pWindow->QueueInputEvent(mouseButtonEventArgs);
         }
         break;
         case WM_MOUSEWHEEL:
@@ -549,7 +699,7 @@ static LRESULT CALLBACK WndProc(HWND hwnd, UINT message, WPARAM wParam, LPARAM l
             ScreenToClient(hwnd, &clientToScreenPoint);
 
             MouseWheelEventArgs mouseWheelEventArgs(zDelta, lButton, mButton, rButton, control, shift, (int)clientToScreenPoint.x, (int)clientToScreenPoint.y);
-            pWindow->OnMouseWheel(mouseWheelEventArgs);
+            pWindow->QueueInputEvent(mouseWheelEventArgs);
         }
         break;
         // WM_SIZE is sent when the user resizes the window. 
@@ -558,8 +708,7 @@ static LRESULT CALLBACK WndProc(HWND hwnd, UINT message, WPARAM wParam, LPARAM l
             int width = ((int)(short)LOWORD(lParam));
             int height = ((int)(short)HIWORD(lParam));
 
-            ResizeEventArgs resizeEventArgs(width, height);
-            pWindow->OnResize(resizeEventArgs);
+            pWindow->Resize(width, height);
         }
         break;
         case WM_DESTROY:
@@ -0,0 +1,201 @@
+#include <BuddyAllocator.h>
+
+#include <algorithm>
+#include <cassert>
+
+static bool IsPow2(uint64_t v)
+{
+    return v != 0 && (v & (v - 1)) == 0;
+}
+
+static uint64_t NextPow2(uint64_t v)
+{
+    uint64_t p = 1;
+    while (p < v)
+    {
+        p <<= 1;
+    }
+    return p;
+}
+
+BuddyAllocator::BuddyAllocator(uint64_t size, uint64_t minBlockSize)
+    : m_Size(size)
+    , m_MinBlockSize(minBlockSize)
+    , m_FreeSize(size)
+    , m_NumLevels(1)
+{
+    assert(IsPow2(minBlockSize) && "The minimum block size must be a power of two.");
+    assert(size >= minBlockSize && IsPow2(size / minBlockSize) && size % minBlockSize == 0 &&
+        "The size must be a power of two multiple of the minimum block size.");
+
+    for (uint64_t blockSize = m_Size; blockSize > m_MinBlockSize; blockSize >>= 1)
+    {
+        ++m_NumLevels;
+    }
+
+    m_FreeBlocks.resize(m_NumLevels);
+    m_FreeBlocks[0].insert(0);
+}
+
+uint32_t BuddyAllocator::GetLevel(uint64_t blockSize) const
+{
+    uint32_t level = 0;
+    for (uint64_t size = m_Size; size > blockSize; size >>= 1)
+    {
+        ++level;
+    }
+    return level;
+}
+
+uint64_t BuddyAllocator::GetLevelBlockSize(uint32_t level) const
+{
+    return m_Size >> level;
+}
+
+uint64_t BuddyAllocator::GetBlockSize(uint64_t sizeInBytes, uint64_t alignment) const
+{
+    // Blocks are aligned to their own size, so any power of two alignment
+    // is satisfied by a block that is at least as large as the alignment.
+    uint64_t blockSize = std::max(NextPow2(sizeInBytes), m_MinBlockSize);
+    return std::max(blockSize, NextPow2(alignment));
+}
+
+bool BuddyAllocator::HasSpace(uint64_t sizeInBytes, uint64_t alignment) const
+{
+    uint64_t blockSize = GetBlockSize(sizeInBytes, alignment);
+    if (blockSize > m_Size)
+    {
+        return false;
+    }
+
+    for (int32_t level = static_cast<int32_t>(GetLevel(blockSize)); level >= 0; --level)
+    {
+        if (!m_FreeBlocks[level].empty())
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+uint64_t BuddyAllocator::Allocate(uint64_t sizeInBytes, uint64_t alignment)
+{
+    uint64_t blockSize = GetBlockSize(sizeInBytes, alignment);
+    if (sizeInBytes == 0 || blockSize > m_Size)
+    {
+        return InvalidOffset;
+    }
+
+    const uint32_t targetLevel = GetLevel(blockSize);
+
+    // Find the smallest free block that can satisfy the request.
+    int32_t level = static_cast<int32_t>(targetLevel);
+    while (level >= 0 && m_FreeBlocks[level].empty())
+    {
+        --level;
+    }
+
+    if (level < 0)
+    {
+        return InvalidOffset;
+    }
+
+    uint64_t offset = *m_FreeBlocks[level].begin();
+    m_FreeBlocks[level].erase(m_FreeBlocks[level].begin());
+
+    // Split the block until it matches the requested size. The upper half
+    // of each split is returned to the free list.
+    while (static_cast<uint32_t>(level) < targetLevel)
+    {
+        ++level;
+        m_FreeBlocks[level].insert(offset + GetLevelBlockSize(level));
+    }
+
+    m_Allocations.emplace(offset, targetLevel);
+    m_FreeSize -= blockSize;
+
+    return offset;
+}
+
+void BuddyAllocator::Free(uint64_t offset)
+{
+    auto iter = m_Allocations.find(offset);
+    assert(iter != m_Allocations.end() && "Invalid offset passed to BuddyAllocator::Free.");
+    if (iter == m_Allocations.end())
+    {
+        return;
+    }
+
+    uint32_t level = iter->second;
+    m_Allocations.erase(iter);
+    m_FreeSize += GetLevelBlockSize(level);
+
+    // Merge the block with its buddy as long as the buddy is also free.
+    while (level > 0)
+    {
+        uint64_t buddyOffset = offset ^ GetLevelBlockSize(level);
+        auto buddyIter = m_FreeBlocks[level].find(buddyOffset);
+        if (buddyIter == m_FreeBlocks[level].end())
+        {
+            break;
+        }
+
+        m_FreeBlocks[level].erase(buddyIter);
+        offset = std::min(offset, buddyOffset);
+        --level;
+    }
+
+    m_FreeBlocks[level].insert(offset);
+}
+
+uint64_t BuddyAllocator::GetAllocationSize(uint64_t offset) const
+{
+    auto iter = m_Allocations.find(offset);
+    return iter != m_Allocations.end() ? GetLevelBlockSize(iter->second) : 0;
+}
+
+uint64_t BuddyAllocator::GetSize() const
+{
+    return m_Size;
+}
+
+uint64_t BuddyAllocator::GetMinBlockSize() const
+{
+    return m_MinBlockSize;
+}
+
+uint64_t BuddyAllocator::GetFreeSize() const
+{
+    return m_FreeSize;
+}
+
+uint64_t BuddyAllocator::GetLargestFreeBlockSize() const
+{
+    for (uint32_t level = 0; level < m_NumLevels; ++level)
+    {
+        if (!m_FreeBlocks[level].empty())
+        {
+            return GetLevelBlockSize(level);
+        }
+    }
+    return 0;
+}
+
+uint32_t BuddyAllocator::GetNumAllocations() const
+{
+    return static_cast<uint32_t>(m_Allocations.size());
+}
+
+bool BuddyAllocator::IsEmpty() const
+{
+    return m_Allocations.empty();
+}
+
+float BuddyAllocator::GetFragmentation() const
+{
+    if (m_FreeSize == 0)
+    {
+        return 0.0f;
+    }
+    return 1.0f - static_cast<float>(GetLargestFreeBlockSize()) / static_cast<float>(m_FreeSize);
+}
@@ -0,0 +1,533 @@
+#include <DX12LibPCH.h>
+
+#include <CommandList.h>
+
+#include <Application.h>
+#include <D3D12Device.h>
+#include <DynamicDescriptorHeap.h>
+#include <FrameCapture.h>
+#include <NullDevice.h>
+#include <ResourceStateTracker.h>
+#include <RootSignature.h>
+#include <UploadBuffer.h>
+
+static_assert(sizeof(ResourceStateTracker::Barrier) == sizeof(D3D12_RESOURCE_BARRIER), "Barriers must match D3D12_RESOURCE_BARRIER.");
+static_assert(offsetof(ResourceStateTracker::Barrier, Transition) == offsetof(D3D12_RESOURCE_BARRIER, Transition), "Barriers must match D3D12_RESOURCE_BARRIER.");
+static_assert(offsetof(ResourceStateTracker::ResourceTransition, StateAfter) == offsetof(D3D12_RESOURCE_TRANSITION_BARRIER, StateAfter), "Transitions must match D3D12_RESOURCE_TRANSITION_BARRIER.");
+static_assert(ResourceStateTracker::AllSubresources == D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES, "Subresource indices must match D3D12_RESOURCE_BARRIER_ALL_SUBRESOURCES.");
+static_assert(static_cast<uint32_t>(ResourceStateTracker::BarrierType::UAV) == D3D12_RESOURCE_BARRIER_TYPE_UAV, "Barrier types must match D3D12_RESOURCE_BARRIER_TYPE.");
+
+static_assert(sizeof(CommandListStateCache::VertexBufferView) == sizeof(D3D12_VERTEX_BUFFER_VIEW), "Vertex buffer views must match D3D12_VERTEX_BUFFER_VIEW.");
+static_assert(sizeof(CommandListStateCache::IndexBufferView) == sizeof(D3D12_INDEX_BUFFER_VIEW), "Index buffer views must match D3D12_INDEX_BUFFER_VIEW.");
+static_assert(sizeof(CommandListStateCache::Viewport) == sizeof(D3D12_VIEWPORT), "Viewports must match D3D12_VIEWPORT.");
+static_assert(sizeof(CommandListStateCache::Rect) == sizeof(D3D12_RECT), "Rects must match D3D12_RECT.");
+static_assert(CommandListStateCache::MaxVertexBuffers == D3D12_IA_VERTEX_INPUT_RESOURCE_SLOT_COUNT, "The number of vertex buffer slots must match.");
+static_assert(CommandListStateCache::MaxViewports == D3D12_VIEWPORT_AND_SCISSORRECT_OBJECT_COUNT_PER_PIPELINE, "The number of viewports must match.");
+static_assert(CommandListStateCache::NumDescriptorHeapTypes == D3D12_DESCRIPTOR_HEAP_TYPE_NUM_TYPES, "The number of descriptor heap types must match.");
+
+namespace
+{
+    // Submit the barriers that are flushed by the resource state tracker to a command list.
+    ResourceStateTracker::ResourceBarrierFunction ResourceBarrierCallback(ID3D12GraphicsCommandList* commandList)
+    {
+        return [commandList](uint32_t numBarriers, const ResourceStateTracker::Barrier* barriers)
+        {
+            commandList->ResourceBarrier(numBarriers, reinterpret_cast<const D3D12_RESOURCE_BARRIER*>(barriers));
+        };
+    }
+
+    // Record a command in the frame capture (if a capture is in progress).
+    void CaptureCommand(NullDevice::CommandType type, uint64_t a0 = 0, uint64_t a1 = 0, uint64_t a2 = 0, uint64_t a3 = 0)
+    {
+        Application::Get().GetFrameCapture().Record(FrameCapture::Call::Command,
+            { static_cast<uint64_t>(type), a0, a1, a2, a3 });
+    }
+}
+
+CommandList::CommandList(Device& device, Device::CommandListType type)
+    : m_d3d12CommandListType(static_cast<D3D12_COMMAND_LIST_TYPE>(type))
+{
+    // The commands are recorded on the Direct3D command list (the device is a D3D12Device).
+    m_DeviceCommandList = std::static_pointer_cast<D3D12Device::CommandList>(device.CreateCommandList(type));
+    m_d3d12CommandList = m_DeviceCommandList->GetD3D12CommandList();
+
+    m_UploadBuffer = std::make_unique<UploadBuffer>(device);
+
+    m_ResourceStateTracker = std::make_unique<ResourceStateTracker>();
+
+    for (int i = 0; i < D3D12_DESCRIPTOR_HEAP_TYPE_NUM_TYPES; ++i)
+    {
+        m_DynamicDescriptorHeap[i] = std::make_unique<DynamicDescriptorHeap>(device, static_cast<Device::DescriptorHeapType>(i));
+    }
+}
+
+CommandList::~CommandList() {}
+
+void CommandList::TransitionBarrier(Microsoft::WRL::ComPtr<ID3D12Resource> resource, D3D12_RESOURCE_STATES stateAfter, UINT subresource, bool flushBarriers)
+{
+    if (resource)
+    {
+        // The "before" state is not important. It will be resolved by the resource state tracker.
+        m_ResourceStateTracker->TransitionResource(resource.Get(), stateAfter, subresource);
+    }
+
+    if (flushBarriers)
+    {
+        FlushResourceBarriers();
+    }
+}
+
+void CommandList::UAVBarrier(Microsoft::WRL::ComPtr<ID3D12Resource> resource, bool flushBarriers)
+{
+    m_ResourceStateTracker->UAVBarrier(resource.Get());
+
+    if (flushBarriers)
+    {
+        FlushResourceBarriers();
+    }
+}
+
+void CommandList::AliasingBarrier(Microsoft::WRL::ComPtr<ID3D12Resource> beforeResource, Microsoft::WRL::ComPtr<ID3D12Resource> afterResource, bool flushBarriers)
+{
+    m_ResourceStateTracker->AliasBarrier(beforeResource.Get(), afterResource.Get());
+
+    if (flushBarriers)
+    {
+        FlushResourceBarriers();
+    }
+}
+
+void CommandList::FlushResourceBarriers()
+{
+    uint32_t numBarriers = m_ResourceStateTracker->FlushResourceBarriers(ResourceBarrierCallback(m_d3d12CommandList.Get()));
+    if (numBarriers > 0)
+    {
+        CaptureCommand(NullDevice::CommandType::ResourceBarrier, numBarriers);
+    }
+}
+
+void CommandList::CopyResource(Microsoft::WRL::ComPtr<ID3D12Resource> dstRes, Microsoft::WRL::ComPtr<ID3D12Resource> srcRes)
+{
+    TransitionBarrier(dstRes, D3D12_RESOURCE_STATE_COPY_DEST);
+    TransitionBarrier(srcRes, D3D12_RESOURCE_STATE_COPY_SOURCE);
+
+    FlushResourceBarriers();
+
+    m_d3d12CommandList->CopyResource(dstRes.Get(), srcRes.Get());
+
+    TrackObject(dstRes);
+    TrackObject(srcRes);
+}
+
+void CommandList::CopyBuffer(ID3D12Resource* dstBuffer, uint64_t dstOffset, size_t bufferSize, const void* bufferData)
+{
+    TransitionBarrier(dstBuffer, D3D12_RESOURCE_STATE_COPY_DEST);
+    FlushResourceBarriers();
+
+    // The data can be larger than a page of the upload buffer,
+    // so it is copied in chunks.
+    const uint8_t* srcData = static_cast<const uint8_t*>(bufferData);
+    size_t bytesCopied = 0;
+    while (bytesCopied < bufferSize)
+    {
+        size_t chunkSize = std::min(bufferSize - bytesCopied, m_UploadBuffer->GetPageSize());
+
+        UploadBuffer::Allocation allocation = m_UploadBuffer->Allocate(chunkSize, 4);
+        memcpy(allocation.CPU, srcData + bytesCopied, chunkSize);
+
+        m_d3d12CommandList->CopyBufferRegion(dstBuffer, dstOffset + bytesCopied,
+            static_cast<D3D12Device::Resource*>(allocation.Resource)->GetD3D12Resource(), allocation.Offset, chunkSize);
+        CaptureCommand(NullDevice::CommandType::CopyBufferRegion,
+            dstBuffer->GetGPUVirtualAddress() + dstOffset + bytesCopied, allocation.GPU, chunkSize);
+
+        bytesCopied += chunkSize;
+    }
+}
+
+void CommandList::SetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY primitiveTopology)
+{
+    if (!m_StateCache.SetPrimitiveTopology(primitiveTopology))
+    {
+        return;
+    }
+
+    m_d3d12CommandList->IASetPrimitiveTopology(primitiveTopology);
+}
+
+void CommandList::SetVertexBuffer(uint32_t slot, const D3D12_VERTEX_BUFFER_VIEW& vertexBufferView)
+{
+    ASSERT(slot < D3D12_IA_VERTEX_INPUT_RESOURCE_SLOT_COUNT);
+
+    if (!m_StateCache.SetVertexBuffer(slot, reinterpret_cast<const CommandListStateCache::VertexBufferView&>(vertexBufferView)))
+    {
+        return;
+    }
+
+    m_d3d12CommandList->IASetVertexBuffers(slot, 1, &vertexBufferView);
+    CaptureCommand(NullDevice::CommandType::SetVertexBuffer, slot, vertexBufferView.BufferLocation,
+        vertexBufferView.SizeInBytes, vertexBufferView.StrideInBytes);
+}
+
+void CommandList::SetDynamicVertexBuffer(uint32_t slot, size_t numVertices, size_t vertexSize, const void* vertexBufferData)
+{
+    size_t bufferSize = numVertices * vertexSize;
+
+    auto heapAllocation = m_UploadBuffer->Allocate(bufferSize, vertexSize);
+    memcpy(heapAllocation.CPU, vertexBufferData, bufferSize);
+
+    D3D12_VERTEX_BUFFER_VIEW vertexBufferView = {};
+    vertexBufferView.BufferLocation = heapAllocation.GPU;
+    vertexBufferView.SizeInBytes = static_cast<UINT>(bufferSize);
+    vertexBufferView.StrideInBytes = static_cast<UINT>(vertexSize);
+
+    SetVertexBuffer(slot, vertexBufferView);
+}
+
+void CommandList::SetIndexBuffer(const D3D12_INDEX_BUFFER_VIEW& indexBufferView)
+{
+    if (!m_StateCache.SetIndexBuffer(reinterpret_cast<const CommandListStateCache::IndexBufferView&>(indexBufferView)))
+    {
+        return;
+    }
+
+    m_d3d12CommandList->IASetIndexBuffer(&indexBufferView);
+    CaptureCommand(NullDevice::CommandType::SetIndexBuffer, indexBufferView.BufferLocation, indexBufferView.SizeInBytes);
+}
+
+void CommandList::SetDynamicIndexBuffer(size_t numIndicies, DXGI_FORMAT indexFormat, const void* indexBufferData)
+{
+    size_t indexSizeInBytes = indexFormat == DXGI_FORMAT_R16_UINT ? 2 : 4;
+    size_t bufferSize = numIndicies * indexSizeInBytes;
+
+    auto heapAllocation = m_UploadBuffer->Allocate(bufferSize, indexSizeInBytes);
+    memcpy(heapAllocation.CPU, indexBufferData, bufferSize);
+
+    D3D12_INDEX_BUFFER_VIEW indexBufferView = {};
+    indexBufferView.BufferLocation = heapAllocation.GPU;
+    indexBufferView.SizeInBytes = static_cast<UINT>(bufferSize);
+    indexBufferView.Format = indexFormat;
+
+    SetIndexBuffer(indexBufferView);
+}
+
+void CommandList::SetGraphicsDynamicConstantBuffer(uint32_t rootParameterIndex, size_t sizeInBytes, const void* bufferData)
+{
+    // Constant buffers must be 256-byte aligned.
+    auto heapAllocation = m_UploadBuffer->Allocate(sizeInBytes, D3D12_CONSTANT_BUFFER_DATA_PLACEMENT_ALIGNMENT);
+    memcpy(heapAllocation.CPU, bufferData, sizeInBytes);
+
+    m_d3d12CommandList->SetGraphicsRootConstantBufferView(rootParameterIndex, heapAllocation.GPU);
+}
+
+void CommandList::SetGraphics32BitConstants(uint32_t rootParameterIndex, uint32_t numConstants, const void* constants)
+{
+    m_d3d12CommandList->SetGraphicsRoot32BitConstants(rootParameterIndex, numConstants, constants, 0);
+    CaptureCommand(NullDevice::CommandType::SetRoot32BitConstants, rootParameterIndex, numConstants);
+}
+
+void CommandList::SetCompute32BitConstants(uint32_t rootParameterIndex, uint32_t numConstants, const void* constants)
+{
+    m_d3d12CommandList->SetComputeRoot32BitConstants(rootParameterIndex, numConstants, constants, 0);
+    CaptureCommand(NullDevice::CommandType::SetRoot32BitConstants, rootParameterIndex, numConstants);
+}
+
+void CommandList::SetViewport(const D3D12_VIEWPORT& viewport)
+{
+    SetViewports({ viewport });
+}
+
+void CommandList::SetViewports(const std::vector<D3D12_VIEWPORT>& viewports)
+{
+    ASSERT(viewports.size() <= D3D12_VIEWPORT_AND_SCISSORRECT_OBJECT_COUNT_PER_PIPELINE);
+
+    uint32_t numViewports = static_cast<uint32_t>(viewports.size());
+    if (!m_StateCache.SetViewports(numViewports, reinterpret_cast<const CommandListStateCache::Viewport*>(viewports.data())))
+    {
+        return;
+    }
+
+    m_d3d12CommandList->RSSetViewports(numViewports, viewports.data());
+}
+
+void CommandList::SetScissorRect(const D3D12_RECT& scissorRect)
+{
+    SetScissorRects({ scissorRect });
+}
+
+void CommandList::SetScissorRects(const std::vector<D3D12_RECT>& scissorRects)
+{
+    ASSERT(scissorRects.size() <= D3D12_VIEWPORT_AND_SCISSORRECT_OBJECT_COUNT_PER_PIPELINE);
+
+    uint32_t numScissorRects = static_cast<uint32_t>(scissorRects.size());
+    if (!m_StateCache.SetScissorRects(numScissorRects, reinterpret_cast<const CommandListStateCache::Rect*>(scissorRects.data())))
+    {
+        return;
+    }
+
+    m_d3d12CommandList->RSSetScissorRects(numScissorRects, scissorRects.data());
+}
+
+void CommandList::SetPipelineState(Microsoft::WRL::ComPtr<ID3D12PipelineState> pipelineState)
+{
+    if (!m_StateCache.SetPipelineState(pipelineState.Get()))
+    {
+        return;
+    }
+
+    m_d3d12CommandList->SetPipelineState(pipelineState.Get());
+    CaptureCommand(NullDevice::CommandType::SetPipelineState, reinterpret_cast<uint64_t>(pipelineState.Get()));
+
+    TrackObject(pipelineState);
+}
+
+void CommandList::SetGraphicsRootSignature(const RootSignature& rootSignature)
+{
+    auto d3d12RootSignature = rootSignature.GetRootSignature();
+    if (!m_StateCache.SetGraphicsRootSignature(d3d12RootSignature.Get()))
+    {
+        return;
+    }
+
+    ParseRootSignature(rootSignature);
+
+    m_d3d12CommandList->SetGraphicsRootSignature(d3d12RootSignature.Get());
+    CaptureCommand(NullDevice::CommandType::SetRootSignature, reinterpret_cast<uint64_t>(d3d12RootSignature.Get()));
+
+    TrackObject(d3d12RootSignature);
+}
+
+void CommandList::SetComputeRootSignature(const RootSignature& rootSignature)
+{
+    auto d3d12RootSignature = rootSignature.GetRootSignature();
+    if (!m_StateCache.SetComputeRootSignature(d3d12RootSignature.Get()))
+    {
+        return;
+    }
+
+    ParseRootSignature(rootSignature);
+
+    m_d3d12CommandList->SetComputeRootSignature(d3d12RootSignature.Get());
+    CaptureCommand(NullDevice::CommandType::SetRootSignature, reinterpret_cast<uint64_t>(d3d12RootSignature.Get()));
+
+    TrackObject(d3d12RootSignature);
+}
+
+void CommandList::SetShaderResourceView(
+    uint32_t rootParameterIndex,
+    uint32_t descriptorOffset,
+    Microsoft::WRL::ComPtr<ID3D12Resource> resource,
+    D3D12_CPU_DESCRIPTOR_HANDLE srv,
+    D3D12_RESOURCE_STATES stateAfter,
+    UINT subresource)
+{
+    TransitionBarrier(resource, stateAfter, subresource);
+
+    m_DynamicDescriptorHeap[D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV]->StageDescriptors(rootParameterIndex, descriptorOffset, 1, srv.ptr);
+
+    TrackObject(resource);
+}
+
+void CommandList::SetUnorderedAccessView(
+    uint32_t rootParameterIndex,
+    uint32_t descriptorOffset,
+    Microsoft::WRL::ComPtr<ID3D12Resource> resource,
+    D3D12_CPU_DESCRIPTOR_HANDLE uav,
+    D3D12_RESOURCE_STATES stateAfter,
+    UINT subresource)
+{
+    TransitionBarrier(resource, stateAfter, subresource);
+
+    m_DynamicDescriptorHeap[D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV]->StageDescriptors(rootParameterIndex, descriptorOffset, 1, uav.ptr);
+
+    TrackObject(resource);
+}
+
+void CommandList::SetRenderTargets(uint32_t numRenderTargets, const D3D12_CPU_DESCRIPTOR_HANDLE* renderTargets, const D3D12_CPU_DESCRIPTOR_HANDLE* depthStencil)
+{
+    m_d3d12CommandList->OMSetRenderTargets(numRenderTargets, renderTargets, FALSE, depthStencil);
+}
+
+void CommandList::ClearRenderTargetView(D3D12_CPU_DESCRIPTOR_HANDLE rtv, const float clearColor[4])
+{
+    FlushResourceBarriers();
+    m_d3d12CommandList->ClearRenderTargetView(rtv, clearColor, 0, nullptr);
+    CaptureCommand(NullDevice::CommandType::ClearRenderTargetView, rtv.ptr);
+}
+
+void CommandList::ClearDepthStencilView(D3D12_CPU_DESCRIPTOR_HANDLE dsv, D3D12_CLEAR_FLAGS clearFlags, float depth, uint8_t stencil)
+{
+    FlushResourceBarriers();
+    m_d3d12CommandList->ClearDepthStencilView(dsv, clearFlags, depth, stencil, 0, nullptr);
+    CaptureCommand(NullDevice::CommandType::ClearDepthStencilView, dsv.ptr);
+}
+
+void CommandList::Draw(uint32_t vertexCount, uint32_t instanceCount, uint32_t startVertex, uint32_t startInstance)
+{
+    FlushResourceBarriers();
+
+    CommitStagedDescriptors(&ID3D12GraphicsCommandList::SetGraphicsRootDescriptorTable);
+
+    m_d3d12CommandList->DrawInstanced(vertexCount, instanceCount, startVertex, startInstance);
+    CaptureCommand(NullDevice::CommandType::DrawInstanced, vertexCount, instanceCount);
+    m_StateCache.RecordDraw();
+}
+
+void CommandList::DrawIndexed(uint32_t indexCount, uint32_t instanceCount, uint32_t startIndex, int32_t baseVertex, uint32_t startInstance)
+{
+    FlushResourceBarriers();
+
+    CommitStagedDescriptors(&ID3D12GraphicsCommandList::SetGraphicsRootDescriptorTable);
+
+    m_d3d12CommandList->DrawIndexedInstanced(indexCount, instanceCount, startIndex, baseVertex, startInstance);
+    CaptureCommand(NullDevice::CommandType::DrawIndexedInstanced, indexCount, instanceCount);
+    m_StateCache.RecordDraw();
+}
+
+void CommandList::Dispatch(uint32_t numGroupsX, uint32_t numGroupsY, uint32_t numGroupsZ)
+{
+    FlushResourceBarriers();
+
+    CommitStagedDescriptors(&ID3D12GraphicsCommandList::SetComputeRootDescriptorTable);
+
+    m_d3d12CommandList->Dispatch(numGroupsX, numGroupsY, numGroupsZ);
+    CaptureCommand(NullDevice::CommandType::Dispatch, numGroupsX, numGroupsY, numGroupsZ);
+    m_StateCache.RecordDispatch();
+}
+
+// The queries are not captured. They are issued by the GpuProfiler, which
+// is exercised on the NullDevice directly.
+void CommandList::EndQuery(ID3D12QueryHeap* queryHeap, D3D12_QUERY_TYPE type, uint32_t index)
+{
+    FlushResourceBarriers();
+    m_d3d12CommandList->EndQuery(queryHeap, type, index);
+}
+
+void CommandList::ResolveQueryData(ID3D12QueryHeap* queryHeap, D3D12_QUERY_TYPE type, uint32_t startIndex, uint32_t numQueries,
+    ID3D12Resource* destinationBuffer, uint64_t destinationOffset)
+{
+    FlushResourceBarriers();
+    m_d3d12CommandList->ResolveQueryData(queryHeap, type, startIndex, numQueries, destinationBuffer, destinationOffset);
+}
+
+bool CommandList::Close(CommandList& pendingCommandList)
+{
+    // Flush any remaining barriers.
+    FlushResourceBarriers();
+
+    m_DeviceCommandList->Close();
+
+    // Flush pending resource barriers.
+    uint32_t numPendingBarriers = m_ResourceStateTracker->FlushPendingResourceBarriers(
+        ResourceBarrierCallback(pendingCommandList.GetGraphicsCommandList().Get()));
+    // Commit the final resource state to the global state.
+    m_ResourceStateTracker->CommitFinalResourceStates();
+
+    return numPendingBarriers > 0;
+}
+
+void CommandList::Close()
+{
+    FlushResourceBarriers();
+    m_DeviceCommandList->Close();
+}
+
+void CommandList::Reset()
+{
+    m_DeviceCommandList->Reset();
+
+    m_ResourceStateTracker->Reset();
+    m_UploadBuffer->Reset();
+
+    ReleaseTrackedObjects();
+
+    for (int i = 0; i < D3D12_DESCRIPTOR_HEAP_TYPE_NUM_TYPES; ++i)
+    {
+        m_DynamicDescriptorHeap[i]->Reset();
+    }
+
+    // The statistics are kept.
+    m_StateCache.Reset();
+}
+
+Device::CommandList& CommandList::GetDeviceCommandList() const
+{
+    return *m_DeviceCommandList;
+}
+
+void CommandList::TrackObject(Microsoft::WRL::ComPtr<ID3D12Object> object)
+{
+    if (object)
+    {
+        m_TrackedObjects.push_back(object);
+    }
+}
+
+void CommandList::ReleaseTrackedObjects()
+{
+    m_TrackedObjects.clear();
+}
+
+void CommandList::SetDescriptorHeap(D3D12_DESCRIPTOR_HEAP_TYPE heapType, ID3D12DescriptorHeap* heap)
+{
+    if (!m_StateCache.SetDescriptorHeap(heapType, heap))
+    {
+        return;
+    }
+
+    BindDescriptorHeaps();
+}
+
+void CommandList::ParseRootSignature(const RootSignature& rootSignature)
+{
+    uint32_t numParameters = rootSignature.GetRootSignatureDesc().NumParameters;
+
+    uint32_t numDescriptors[DynamicDescriptorHeap::MaxDescriptorTables] = {};
+    for (uint32_t i = 0; i < numParameters && i < DynamicDescriptorHeap::MaxDescriptorTables; ++i)
+    {
+        numDescriptors[i] = rootSignature.GetNumDescriptors(i);
+    }
+    numParameters = std::min(numParameters, DynamicDescriptorHeap::MaxDescriptorTables);
+
+    for (int i = 0; i < D3D12_DESCRIPTOR_HEAP_TYPE_NUM_TYPES; ++i)
+    {
+        uint32_t descriptorTableBitMask = rootSignature.GetDescriptorTableBitMask(static_cast<D3D12_DESCRIPTOR_HEAP_TYPE>(i));
+        m_DynamicDescriptorHeap[i]->ParseRootSignature(descriptorTableBitMask, numDescriptors, numParameters);
+    }
+}
+
+void CommandList::CommitStagedDescriptors(SetRootDescriptorTableFunction setRootDescriptorTable)
+{
+    ID3D12GraphicsCommandList* graphicsCommandList = m_d3d12CommandList.Get();
+
+    auto setDescriptorHeap = [this](Device::DescriptorHeap& descriptorHeap)
+    {
+        SetDescriptorHeap(static_cast<D3D12_DESCRIPTOR_HEAP_TYPE>(descriptorHeap.GetType()),
+            static_cast<D3D12Device::DescriptorHeap&>(descriptorHeap).GetD3D12DescriptorHeap());
+    };
+    auto setDescriptorTable = [graphicsCommandList, setRootDescriptorTable](uint32_t rootParameterIndex, uint64_t baseDescriptor)
+    {
+        (graphicsCommandList->*setRootDescriptorTable)(rootParameterIndex, D3D12_GPU_DESCRIPTOR_HANDLE{ baseDescriptor });
+    };
+
+    for (int i = 0; i < D3D12_DESCRIPTOR_HEAP_TYPE_NUM_TYPES; ++i)
+    {
+        m_DynamicDescriptorHeap[i]->CommitStagedDescriptors(setDescriptorHeap, setDescriptorTable);
+    }
+}
+
+void CommandList::BindDescriptorHeaps()
+{
+    UINT numDescriptorHeaps = 0;
+    ID3D12DescriptorHeap* descriptorHeaps[D3D12_DESCRIPTOR_HEAP_TYPE_NUM_TYPES] = {};
+
+    for (uint32_t i = 0; i < D3D12_DESCRIPTOR_HEAP_TYPE_NUM_TYPES; ++i)
+    {
+        ID3D12DescriptorHeap* descriptorHeap = static_cast<ID3D12DescriptorHeap*>(m_StateCache.GetDescriptorHeap(i));
+        if (descriptorHeap)
+        {
+            descriptorHeaps[numDescriptorHeaps++] = descriptorHeap;
+        }
+    }
+
+    m_d3d12CommandList->SetDescriptorHeaps(numDescriptorHeaps, descriptorHeaps);
+}
@@ -0,0 +1,181 @@
+#include <CommandListStateCache.h>
+
+#include <cassert>
+#include <cstring>
+
+// Matches D3D_PRIMITIVE_TOPOLOGY_UNDEFINED.
+static const uint32_t UndefinedPrimitiveTopology = 0;
+
+CommandListStateCache::CommandListStateCache()
+    : m_Statistics{}
+{
+    Reset();
+}
+
+bool CommandListStateCache::SetPipelineState(const void* pipelineState)
+{
+    if (m_PipelineState == pipelineState)
+    {
+        m_Statistics.NumRedundantPipelineStates++;
+        return false;
+    }
+
+    m_PipelineState = pipelineState;
+    return true;
+}
+
+bool CommandListStateCache::SetGraphicsRootSignature(const void* rootSignature)
+{
+    if (m_GraphicsRootSignature == rootSignature)
+    {
+        m_Statistics.NumRedundantRootSignatures++;
+        return false;
+    }
+
+    m_GraphicsRootSignature = rootSignature;
+    return true;
+}
+
+bool CommandListStateCache::SetComputeRootSignature(const void* rootSignature)
+{
+    if (m_ComputeRootSignature == rootSignature)
+    {
+        m_Statistics.NumRedundantRootSignatures++;
+        return false;
+    }
+
+    m_ComputeRootSignature = rootSignature;
+    return true;
+}
+
+bool CommandListStateCache::SetPrimitiveTopology(uint32_t primitiveTopology)
+{
+    if (m_PrimitiveTopology == primitiveTopology)
+    {
+        m_Statistics.NumRedundantPrimitiveTopologies++;
+        return false;
+    }
+
+    m_PrimitiveTopology = primitiveTopology;
+    return true;
+}
+
+bool CommandListStateCache::SetVertexBuffer(uint32_t slot, const VertexBufferView& vertexBufferView)
+{
+    assert(slot < MaxVertexBuffers);
+
+    if ((m_VertexBufferBitMask & (1u << slot)) != 0 &&
+        memcmp(&m_VertexBufferViews[slot], &vertexBufferView, sizeof(VertexBufferView)) == 0)
+    {
+        m_Statistics.NumRedundantVertexBuffers++;
+        return false;
+    }
+
+    m_VertexBufferViews[slot] = vertexBufferView;
+    m_VertexBufferBitMask |= (1u << slot);
+    return true;
+}
+
+bool CommandListStateCache::SetIndexBuffer(const IndexBufferView& indexBufferView)
+{
+    if (m_IndexBufferValid &&
+        memcmp(&m_IndexBufferView, &indexBufferView, sizeof(IndexBufferView)) == 0)
+    {
+        m_Statistics.NumRedundantIndexBuffers++;
+        return false;
+    }
+
+    m_IndexBufferView = indexBufferView;
+    m_IndexBufferValid = true;
+    return true;
+}
+
+bool CommandListStateCache::SetViewports(uint32_t numViewports, const Viewport* viewports)
+{
+    assert(numViewports <= MaxViewports);
+
+    if (m_NumViewports == numViewports &&
+        memcmp(m_Viewports, viewports, sizeof(Viewport) * numViewports) == 0)
+    {
+        m_Statistics.NumRedundantViewports++;
+        return false;
+    }
+
+    memcpy(m_Viewports, viewports, sizeof(Viewport) * numViewports);
+    m_NumViewports = numViewports;
+    return true;
+}
+
+bool CommandListStateCache::SetScissorRects(uint32_t numScissorRects, const Rect* scissorRects)
+{
+    assert(numScissorRects <= MaxViewports);
+
+    if (m_NumScissorRects == numScissorRects &&
+        memcmp(m_ScissorRects, scissorRects, sizeof(Rect) * numScissorRects) == 0)
+    {
+        m_Statistics.NumRedundantScissorRects++;
+        return false;
+    }
+
+    memcpy(m_ScissorRects, scissorRects, sizeof(Rect) * numScissorRects);
+    m_NumScissorRects = numScissorRects;
+    return true;
+}
+
+bool CommandListStateCache::SetDescriptorHeap(uint32_t heapType, void* descriptorHeap)
+{
+    assert(heapType < NumDescriptorHeapTypes);
+
+    if (m_DescriptorHeaps[heapType] == descriptorHeap)
+    {
+        m_Statistics.NumRedundantDescriptorHeaps++;
+        return false;
+    }
+
+    m_DescriptorHeaps[heapType] = descriptorHeap;
+    return true;
+}
+
+void* CommandListStateCache::GetDescriptorHeap(uint32_t heapType) const
+{
+    assert(heapType < NumDescriptorHeapTypes);
+    return m_DescriptorHeaps[heapType];
+}
+
+void CommandListStateCache::RecordDraw()
+{
+    m_Statistics.NumDraws++;
+}
+
+void CommandListStateCache::RecordDispatch()
+{
+    m_Statistics.NumDispatches++;
+}
+
+void CommandListStateCache::Reset()
+{
+    for (uint32_t i = 0; i < NumDescriptorHeapTypes; ++i)
+    {
+        m_DescriptorHeaps[i] = nullptr;
+    }
+
+    m_PipelineState = nullptr;
+    m_GraphicsRootSignature = nullptr;
+    m_ComputeRootSignature = nullptr;
+    m_PrimitiveTopology = UndefinedPrimitiveTopology;
+
+    m_VertexBufferBitMask = 0;
+    m_IndexBufferValid = false;
+    m_NumViewports = 0;
+    m_NumScissorRects = 0;
+}
+
+const CommandListStateCache::Statistics& CommandListStateCache::GetStatistics() const
+{
+    return m_Statistics;
+}
+
+void CommandListStateCache::ResetStatistics()
+{
+    m_Statistics = {};
+}
@@ -0,0 +1,280 @@
+#include <DX12LibPCH.h>
+
+#include <D3D12Device.h>
+
+#include <Application.h>
+#include <HeapAllocator.h>
+
+static_assert(static_cast<uint32_t>(Device::DescriptorHeapType::CBV_SRV_UAV) == D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV, "Descriptor heap types must match D3D12_DESCRIPTOR_HEAP_TYPE.");
+static_assert(static_cast<uint32_t>(Device::DescriptorHeapType::Sampler) == D3D12_DESCRIPTOR_HEAP_TYPE_SAMPLER, "Descriptor heap types must match D3D12_DESCRIPTOR_HEAP_TYPE.");
+static_assert(static_cast<uint32_t>(Device::DescriptorHeapType::RTV) == D3D12_DESCRIPTOR_HEAP_TYPE_RTV, "Descriptor heap types must match D3D12_DESCRIPTOR_HEAP_TYPE.");
+static_assert(static_cast<uint32_t>(Device::DescriptorHeapType::DSV) == D3D12_DESCRIPTOR_HEAP_TYPE_DSV, "Descriptor heap types must match D3D12_DESCRIPTOR_HEAP_TYPE.");
+static_assert(static_cast<uint32_t>(Device::DescriptorHeapType::NumTypes) == D3D12_DESCRIPTOR_HEAP_TYPE_NUM_TYPES, "Descriptor heap types must match D3D12_DESCRIPTOR_HEAP_TYPE.");
+static_assert(static_cast<uint32_t>(Device::CommandListType::Direct) == D3D12_COMMAND_LIST_TYPE_DIRECT, "Command list types must match D3D12_COMMAND_LIST_TYPE.");
+static_assert(static_cast<uint32_t>(Device::CommandListType::Bundle) == D3D12_COMMAND_LIST_TYPE_BUNDLE, "Command list types must match D3D12_COMMAND_LIST_TYPE.");
+static_assert(static_cast<uint32_t>(Device::CommandListType::Compute) == D3D12_COMMAND_LIST_TYPE_COMPUTE, "Command list types must match D3D12_COMMAND_LIST_TYPE.");
+static_assert(static_cast<uint32_t>(Device::CommandListType::Copy) == D3D12_COMMAND_LIST_TYPE_COPY, "Command list types must match D3D12_COMMAND_LIST_TYPE.");
+static_assert(sizeof(D3D12_CPU_DESCRIPTOR_HANDLE) == sizeof(uint64_t), "CPU descriptor handles must be 64-bit.");
+
+D3D12Device::DescriptorHeap::DescriptorHeap(Microsoft::WRL::ComPtr<ID3D12DescriptorHeap> descriptorHeap)
+    : m_d3d12DescriptorHeap(descriptorHeap)
+    , m_Desc(descriptorHeap->GetDesc())
+{}
+
+Device::DescriptorHeapType D3D12Device::DescriptorHeap::GetType() const
+{
+    return static_cast<DescriptorHeapType>(m_Desc.Type);
+}
+
+uint32_t D3D12Device::DescriptorHeap::GetNumDescriptors() const
+{
+    return m_Desc.NumDescriptors;
+}
+
+uint64_t D3D12Device::DescriptorHeap::GetCPUDescriptorHandleForHeapStart() const
+{
+    return m_d3d12DescriptorHeap->GetCPUDescriptorHandleForHeapStart().ptr;
+}
+
+uint64_t D3D12Device::DescriptorHeap::GetGPUDescriptorHandleForHeapStart() const
+{
+    if ((m_Desc.Flags & D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE) == 0)
+    {
+        return 0;
+    }
+    return m_d3d12DescriptorHeap->GetGPUDescriptorHandleForHeapStart().ptr;
+}
+
+ID3D12DescriptorHeap* D3D12Device::DescriptorHeap::GetD3D12DescriptorHeap() const
+{
+    return m_d3d12DescriptorHeap.Get();
+}
+
+D3D12Device::Resource::Resource(HeapAllocation&& allocation)
+    : m_Allocation(std::move(allocation))
+    , m_CPUPtr(nullptr)
+{
+    ThrowIfFailed(m_Allocation.GetResource()->Map(0, nullptr, &m_CPUPtr));
+}
+
+D3D12Device::Resource::~Resource()
+{
+    m_Allocation.GetResource()->Unmap(0, nullptr);
+}
+
+uint64_t D3D12Device::Resource::GetSize() const
+{
+    return m_Allocation.GetResource()->GetDesc().Width;
+}
+
+uint64_t D3D12Device::Resource::GetGPUVirtualAddress() const
+{
+    return m_Allocation.GetGPUVirtualAddress();
+}
+
+void* D3D12Device::Resource::Map() const
+{
+    return m_CPUPtr;
+}
+
+ID3D12Resource* D3D12Device::Resource::GetD3D12Resource() const
+{
+    return m_Allocation.GetResource().Get();
+}
+
+D3D12Device::Fence::Fence(Microsoft::WRL::ComPtr<ID3D12Fence> fence)
+    : m_d3d12Fence(fence)
+{
+    m_FenceEvent = ::CreateEvent(NULL, FALSE, FALSE, NULL);
+    ASSERT(m_FenceEvent && "Failed to create fence event handle.");
+}
+
+D3D12Device::Fence::~Fence()
+{
+    ::CloseHandle(m_FenceEvent);
+}
+
+uint64_t D3D12Device::Fence::GetCompletedValue()
+{
+    return m_d3d12Fence->GetCompletedValue();
+}
+
+void D3D12Device::Fence::Wait(uint64_t value)
+{
+    if (m_d3d12Fence->GetCompletedValue() < value)
+    {
+        ThrowIfFailed(m_d3d12Fence->SetEventOnCompletion(value, m_FenceEvent));
+        ::WaitForSingleObject(m_FenceEvent, DWORD_MAX);
+    }
+}
+
+ID3D12Fence* D3D12Device::Fence::GetD3D12Fence() const
+{
+    return m_d3d12Fence.Get();
+}
+
+D3D12Device::CommandList::CommandList(Microsoft::WRL::ComPtr<ID3D12Device2> device, CommandListType type)
+    : m_Type(type)
+{
+    D3D12_COMMAND_LIST_TYPE d3d12Type = static_cast<D3D12_COMMAND_LIST_TYPE>(type);
+
+    ThrowIfFailed(device->CreateCommandAllocator(d3d12Type, IID_PPV_ARGS(&m_d3d12CommandAllocator)));
+
+    ThrowIfFailed(device->CreateCommandList(0, d3d12Type, m_d3d12CommandAllocator.Get(),
+        nullptr, IID_PPV_ARGS(&m_d3d12CommandList)));
+}
+
+Device::CommandListType D3D12Device::CommandList::GetType() const
+{
+    return m_Type;
+}
+
+void D3D12Device::CommandList::Close()
+{
+    ThrowIfFailed(m_d3d12CommandList->Close());
+}
+
+void D3D12Device::CommandList::Reset()
+{
+    ThrowIfFailed(m_d3d12CommandAllocator->Reset());
+    ThrowIfFailed(m_d3d12CommandList->Reset(m_d3d12CommandAllocator.Get(), nullptr));
+}
+
+Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList2> D3D12Device::CommandList::GetD3D12CommandList() const
+{
+    return m_d3d12CommandList;
+}
+
+D3D12Device::CommandQueue::CommandQueue(Microsoft::WRL::ComPtr<ID3D12CommandQueue> commandQueue, CommandListType type)
+    : m_d3d12CommandQueue(commandQueue)
+    , m_Type(type)
+{}
+
+Device::CommandListType D3D12Device::CommandQueue::GetType() const
+{
+    return m_Type;
+}
+
+void D3D12Device::CommandQueue::ExecuteCommandLists(uint32_t numCommandLists, Device::CommandList* const* commandLists)
+{
+    std::vector<ID3D12CommandList*> d3d12CommandLists(numCommandLists);
+    for (uint32_t i = 0; i < numCommandLists; ++i)
+    {
+        d3d12CommandLists[i] = static_cast<CommandList*>(commandLists[i])->GetD3D12CommandList().Get();
+    }
+
+    m_d3d12CommandQueue->ExecuteCommandLists(numCommandLists, d3d12CommandLists.data());
+}
+
+void D3D12Device::CommandQueue::Signal(Device::Fence& fence, uint64_t value)
+{
+    ThrowIfFailed(m_d3d12CommandQueue->Signal(static_cast<Fence&>(fence).GetD3D12Fence(), value));
+}
+
+void D3D12Device::CommandQueue::Wait(Device::Fence& fence, uint64_t value)
+{
+    ThrowIfFailed(m_d3d12CommandQueue->Wait(static_cast<Fence&>(fence).GetD3D12Fence(), value));
+}
+
+Microsoft::WRL::ComPtr<ID3D12CommandQueue> D3D12Device::CommandQueue::GetD3D12CommandQueue() const
+{
+    return m_d3d12CommandQueue;
+}
+
+D3D12Device::D3D12Device(Microsoft::WRL::ComPtr<ID3D12Device2> device, std::shared_ptr<HeapAllocator> uploadAllocator, FrameCapture& frameCapture)
+    : m_d3d12Device(device)
+    , m_UploadAllocator(uploadAllocator)
+    , m_FrameCapture(frameCapture)
+{}
+
+std::shared_ptr<Device::DescriptorHeap> D3D12Device::CreateDescriptorHeap(DescriptorHeapType type, uint32_t numDescriptors, bool shaderVisible)
+{
+    D3D12_DESCRIPTOR_HEAP_DESC desc = {};
+    desc.Type = static_cast<D3D12_DESCRIPTOR_HEAP_TYPE>(type);
+    desc.NumDescriptors = numDescriptors;
+    desc.Flags = shaderVisible ? D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE : D3D12_DESCRIPTOR_HEAP_FLAG_NONE;
+
+    Microsoft::WRL::ComPtr<ID3D12DescriptorHeap> descriptorHeap;
+    ThrowIfFailed(m_d3d12Device->CreateDescriptorHeap(&desc, IID_PPV_ARGS(&descriptorHeap)));
+
+    return std::make_shared<DescriptorHeap>(descriptorHeap);
+}
+
+uint32_t D3D12Device::GetDescriptorHandleIncrementSize(DescriptorHeapType type) const
+{
+    return m_d3d12Device->GetDescriptorHandleIncrementSize(static_cast<D3D12_DESCRIPTOR_HEAP_TYPE>(type));
+}
+
+void D3D12Device::CopyDescriptorsSimple(uint32_t numDescriptors, uint64_t destDescriptor, uint64_t srcDescriptor, DescriptorHeapType type) const
+{
+    m_d3d12Device->CopyDescriptorsSimple(numDescriptors, D3D12_CPU_DESCRIPTOR_HANDLE{ static_cast<SIZE_T>(destDescriptor) },
+        D3D12_CPU_DESCRIPTOR_HANDLE{ static_cast<SIZE_T>(srcDescriptor) }, static_cast<D3D12_DESCRIPTOR_HEAP_TYPE>(type));
+}
+
+void D3D12Device::CopyDescriptors(uint32_t numDescriptors, uint64_t destDescriptor, const uint64_t* srcDescriptors, DescriptorHeapType type) const
+{
+    D3D12_CPU_DESCRIPTOR_HANDLE pDestDescriptorRangeStarts[] =
+    {
+        { static_cast<SIZE_T>(destDescriptor) }
+    };
+    UINT pDestDescriptorRangeSizes[] =
+    {
+        numDescriptors
+    };
+
+    // Each source descriptor is a range of one descriptor.
+    m_d3d12Device->CopyDescriptors(1, pDestDescriptorRangeStarts, pDestDescriptorRangeSizes,
+        numDescriptors, reinterpret_cast<const D3D12_CPU_DESCRIPTOR_HANDLE*>(srcDescriptors), nullptr,
+        static_cast<D3D12_DESCRIPTOR_HEAP_TYPE>(type));
+}
+
+std::shared_ptr<Device::Resource> D3D12Device::CreateUploadBuffer(uint64_t sizeInBytes)
+{
+    HeapAllocation allocation = m_UploadAllocator->CreateResource(
+        CD3DX12_RESOURCE_DESC::Buffer(sizeInBytes),
+        D3D12_RESOURCE_STATE_GENERIC_READ);
+
+    return std::make_shared<Resource>(std::move(allocation));
+}
+
+std::shared_ptr<Device::Fence> D3D12Device::CreateFence(uint64_t initialValue)
+{
+    Microsoft::WRL::ComPtr<ID3D12Fence> fence;
+    ThrowIfFailed(m_d3d12Device->CreateFence(initialValue, D3D12_FENCE_FLAG_NONE, IID_PPV_ARGS(&fence)));
+
+    return std::make_shared<Fence>(fence);
+}
+
+std::shared_ptr<Device::CommandQueue> D3D12Device::CreateCommandQueue(CommandListType type)
+{
+    D3D12_COMMAND_QUEUE_DESC desc = {};
+    desc.Type = static_cast<D3D12_COMMAND_LIST_TYPE>(type);
+    desc.Priority = D3D12_COMMAND_QUEUE_PRIORITY_NORMAL;
+    desc.Flags = D3D12_COMMAND_QUEUE_FLAG_NONE;
+    desc.NodeMask = 0;
+
+    Microsoft::WRL::ComPtr<ID3D12CommandQueue> commandQueue;
+    ThrowIfFailed(m_d3d12Device->CreateCommandQueue(&desc, IID_PPV_ARGS(&commandQueue)));
+
+    return std::make_shared<CommandQueue>(commandQueue, type);
+}
+
+std::shared_ptr<Device::CommandList> D3D12Device::CreateCommandList(CommandListType type)
+{
+    return std::make_shared<CommandList>(m_d3d12Device, type);
+}
+
+uint64_t D3D12Device::GetFrameCount() const
+{
+    return Application::GetFrameCount();
+}
+
+FrameCapture* D3D12Device::GetFrameCapture() const
+{
+    return &m_FrameCapture;
+}
+
+Microsoft::WRL::ComPtr<ID3D12Device2> D3D12Device::GetD3D12Device() const
+{
+    return m_d3d12Device;
+}
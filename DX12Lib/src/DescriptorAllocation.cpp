@@ -1,20 +1,18 @@
-#include <DX12LibPCH.h>
-
 #include <DescriptorAllocation.h>
 
-#include <Application.h>
 #include <DescriptorAllocatorPage.h>
+
 #include <cassert>
 
 DescriptorAllocation::DescriptorAllocation()
-    : m_Descriptor{ 0 }
+    : m_Descriptor( 0 )
     , m_NumHandles( 0 )
     , m_DescriptorSize( 0 )
     , m_Page( nullptr )
 {}
 
 DescriptorAllocation::DescriptorAllocation( 
-    D3D12_CPU_DESCRIPTOR_HANDLE descriptor, 
+    uint64_t descriptor,
     uint32_t numHandles, uint32_t descriptorSize, 
     std::shared_ptr<DescriptorAllocatorPage> page )
     : m_Descriptor( descriptor )
@@ -35,7 +33,7 @@ DescriptorAllocation::DescriptorAllocation( DescriptorAllocation&& allocation )
     , m_DescriptorSize(allocation.m_DescriptorSize)
     , m_Page(std::move(allocation.m_Page))
 {
-    allocation.m_Descriptor.ptr = 0;
+    allocation.m_Descriptor = 0;
     allocation.m_NumHandles = 0;
     allocation.m_DescriptorSize = 0;
 }
@@ -50,7 +48,7 @@ DescriptorAllocation& DescriptorAllocation::operator=( DescriptorAllocation&& ot
     m_DescriptorSize = other.m_DescriptorSize;
     m_Page = std::move( other.m_Page );
 
-    other.m_Descriptor.ptr = 0;
+    other.m_Descriptor = 0;
     other.m_NumHandles = 0;
     other.m_DescriptorSize = 0;
 
@@ -61,9 +59,9 @@ void DescriptorAllocation::Free()
 {
     if ( !IsNull() && m_Page )
     {
-        m_Page->Free( std::move( *this ), Application::GetFrameCount() ); // push to stale descriptors queue.
+        m_Page->Free( std::move( *this ) ); // push to stale descriptors queue.
         
-        m_Descriptor.ptr = 0;
+        m_Descriptor = 0;
         m_NumHandles = 0;
         m_DescriptorSize = 0;
         m_Page.reset();
@@ -73,14 +71,14 @@ void DescriptorAllocation::Free()
 // Check if this a valid descriptor.
 bool DescriptorAllocation::IsNull() const
 {
-    return m_Descriptor.ptr == 0;
+    return m_Descriptor == 0;
 }
 
 // Get a descriptor at a particular offset in the allocation.
-D3D12_CPU_DESCRIPTOR_HANDLE DescriptorAllocation::GetDescriptorHandle( uint32_t offset ) const
+uint64_t DescriptorAllocation::GetDescriptorHandle( uint32_t offset ) const
 {
     assert( offset < m_NumHandles );
-    return { m_Descriptor.ptr + ( m_DescriptorSize * offset ) };
+    return m_Descriptor + static_cast<uint64_t>( m_DescriptorSize ) * offset;
 }
 
 uint32_t DescriptorAllocation::GetNumHandles() const
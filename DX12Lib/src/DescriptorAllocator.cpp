@@ -1,20 +1,28 @@
 #include <DescriptorAllocator.h>
 #include <DescriptorAllocatorPage.h>
-#include <DX12LibPCH.h>
 
-DescriptorAllocator::DescriptorAllocator(D3D12_DESCRIPTOR_HEAP_TYPE type, uint32_t numDescriptorsPerHeap)
-    : m_HeapType(type)
+#include <FrameCapture.h>
+#include <Profiler.h>
+
+#include <algorithm>
+
+DescriptorAllocator::DescriptorAllocator(Device& device, Device::DescriptorHeapType type, uint32_t numDescriptorsPerHeap)
+    : m_Device(device)
+    , m_HeapType(type)
     , m_NumDescriptorsPerHeap(numDescriptorsPerHeap) {} 
 
 DescriptorAllocator::~DescriptorAllocator() {}
 
 DescriptorAllocation DescriptorAllocator::Allocate(uint32_t numDescriptors)
 {
+    PROFILE_FUNCTION();
+
     std::lock_guard<std::mutex> lock( m_AllocationMutex );
 
     DescriptorAllocation allocation;
 
-    for ( auto iter = m_AvailableHeaps.begin(); iter != m_AvailableHeaps.end(); ++iter )
+    auto iter = m_AvailableHeaps.begin();
+    while ( iter != m_AvailableHeaps.end() )
     {
         std::shared_ptr<DescriptorAllocatorPage> allocatorPage = m_HeapPool[*iter];
 
@@ -24,6 +32,10 @@ DescriptorAllocation DescriptorAllocator::Allocate(uint32_t numDescriptors)
         {
             iter = m_AvailableHeaps.erase( iter );
         }
+        else
+        {
+            ++iter;
+        }
 
         // A valid allocation has been found.
         if ( !allocation.IsNull() )
@@ -41,13 +53,19 @@ DescriptorAllocation DescriptorAllocator::Allocate(uint32_t numDescriptors)
         allocation = newPage->Allocate( numDescriptors );
     }
 
+    if ( FrameCapture* frameCapture = m_Device.GetFrameCapture() )
+    {
+        frameCapture->Record( FrameCapture::Call::AllocateDescriptors,
+            { static_cast<uint64_t>( m_HeapType ), numDescriptors, allocation.GetDescriptorHandle() } );
+    }
+
     return allocation;
 }
 
 std::shared_ptr<DescriptorAllocatorPage> DescriptorAllocator::CreateAllocatorPage()
 {
     std::shared_ptr<DescriptorAllocatorPage> newPage = 
-        std::make_shared<DescriptorAllocatorPage>( m_HeapType, m_NumDescriptorsPerHeap );
+        std::make_shared<DescriptorAllocatorPage>( m_Device, m_HeapType, m_NumDescriptorsPerHeap );
 
     m_HeapPool.emplace_back( newPage );
     m_AvailableHeaps.insert( m_HeapPool.size() - 1 );
@@ -57,7 +75,15 @@ std::shared_ptr<DescriptorAllocatorPage> DescriptorAllocator::CreateAllocatorPag
 
 void DescriptorAllocator::ReleaseStaleDescriptors( uint64_t frameNumber )
 {
+    PROFILE_FUNCTION();
+
     std::lock_guard<std::mutex> lock( m_AllocationMutex );
+
+    if ( FrameCapture* frameCapture = m_Device.GetFrameCapture() )
+    {
+        frameCapture->Record( FrameCapture::Call::ReleaseStaleDescriptors,
+            { static_cast<uint64_t>( m_HeapType ), frameNumber } );
+    }
  
     for ( size_t i = 0; i < m_HeapPool.size(); ++i )
     {
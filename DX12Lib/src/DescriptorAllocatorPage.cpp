@@ -1,31 +1,24 @@
 #include <DescriptorAllocatorPage.h>
-#include <Application.h>
-#include <d3dx12.h>
-#include <DX12LibPCH.h>
+#include <FrameCapture.h>
 
 #include <mutex>
 
-DescriptorAllocatorPage::DescriptorAllocatorPage(D3D12_DESCRIPTOR_HEAP_TYPE type, uint32_t numDescriptors) 
-    : m_HeapType(type)
+DescriptorAllocatorPage::DescriptorAllocatorPage(Device& device, Device::DescriptorHeapType type, uint32_t numDescriptors) 
+    : m_Device(device)
+    , m_HeapType(type)
     , m_NumDescriptorsInHeap(numDescriptors)
 {
-    Microsoft::WRL::ComPtr<ID3D12Device2> device = Application::Get().GetDevice();
+    m_DescriptorHeap = m_Device.CreateDescriptorHeap( m_HeapType, m_NumDescriptorsInHeap, false );
 
-    D3D12_DESCRIPTOR_HEAP_DESC heapDesc = {};
-    heapDesc.Type = m_HeapType;
-    heapDesc.NumDescriptors = m_NumDescriptorsInHeap;
-
-    ThrowIfFailed( device->CreateDescriptorHeap( &heapDesc, IID_PPV_ARGS( &m_d3d12DescriptorHeap ) ) );
-
-    m_BaseDescriptor = m_d3d12DescriptorHeap->GetCPUDescriptorHandleForHeapStart();
-    m_DescriptorHandleIncrementSize = device->GetDescriptorHandleIncrementSize( m_HeapType );
+    m_BaseDescriptor = m_DescriptorHeap->GetCPUDescriptorHandleForHeapStart();
+    m_DescriptorHandleIncrementSize = m_Device.GetDescriptorHandleIncrementSize( m_HeapType );
     m_NumFreeHandles = m_NumDescriptorsInHeap;
 
     // Initialize the free lists
     AddNewBlock( 0, m_NumFreeHandles );
 }
 
-D3D12_DESCRIPTOR_HEAP_TYPE DescriptorAllocatorPage::GetHeapType() const
+Device::DescriptorHeapType DescriptorAllocatorPage::GetHeapType() const
 {
     return m_HeapType;
 }
@@ -95,19 +88,26 @@ DescriptorAllocation DescriptorAllocatorPage::Allocate(uint32_t numDescriptors)
     m_NumFreeHandles -= numDescriptors;
 
     return DescriptorAllocation(
-        CD3DX12_CPU_DESCRIPTOR_HANDLE(m_BaseDescriptor, offset, m_DescriptorHandleIncrementSize),
+        m_BaseDescriptor + static_cast<uint64_t>(offset) * m_DescriptorHandleIncrementSize,
         numDescriptors, m_DescriptorHandleIncrementSize, shared_from_this());
 }
 
-uint32_t DescriptorAllocatorPage::ComputeOffset(D3D12_CPU_DESCRIPTOR_HANDLE handle) 
+uint32_t DescriptorAllocatorPage::ComputeOffset(uint64_t handle) 
 {
-    return static_cast<uint32_t>(handle.ptr - m_BaseDescriptor.ptr) / m_DescriptorHandleIncrementSize;
+    return static_cast<uint32_t>(handle - m_BaseDescriptor) / m_DescriptorHandleIncrementSize;
 }
 
-void DescriptorAllocatorPage::Free(DescriptorAllocation&& descriptor, uint64_t frameNumber) 
+void DescriptorAllocatorPage::Free(DescriptorAllocation&& descriptor) 
 {
     // Compute the offset of the descriptor within descriptor heap.
     uint32_t offset = ComputeOffset(descriptor.GetDescriptorHandle());
+    uint64_t frameNumber = m_Device.GetFrameCount();
+
+    if (FrameCapture* frameCapture = m_Device.GetFrameCapture())
+    {
+        frameCapture->Record(FrameCapture::Call::FreeDescriptors,
+            { static_cast<uint64_t>(m_HeapType), descriptor.GetDescriptorHandle(), frameNumber });
+    }
 
     std::lock_guard<std::mutex> lock(m_AllocationMutex);
     
@@ -185,7 +185,8 @@ void DescriptorAllocatorPage::ReleaseStaleDescriptors(uint64_t frameNumber)
 {
     std::lock_guard<std::mutex> lock(m_AllocationMutex);
 
-    while (!m_StaleDescriptors.empty())
+    // The stale descriptors are queued in the order of the frames they were freed in.
+    while (!m_StaleDescriptors.empty() && m_StaleDescriptors.front().FrameNumber <= frameNumber)
     {
         StaleDescriptorInfo& staleDescriptor = m_StaleDescriptors.front();
 
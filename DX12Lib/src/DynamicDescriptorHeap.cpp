@@ -1,57 +1,100 @@
-#include "d3dx12.h"
 #include <DynamicDescriptorHeap.h>
-#include <DX12LibPCH.h>
-#include <Application.h>
-#include <CommandList.h>
-#include <RootSignature.h>
-#include <Utility.h>
+
+#include <FrameCapture.h>
+#include <Profiler.h>
+
+#include <cassert>
+#include <new>
+#include <stdexcept>
+#include <vector>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace
+{
+    // Find the index of the least significant bit that is set (like _BitScanForward).
+    // Returns false if no bit is set.
+    bool BitScanForward(uint32_t& index, uint32_t mask)
+    {
+        if (mask == 0)
+        {
+            return false;
+        }
+#if defined(_MSC_VER)
+        unsigned long bitIndex;
+        _BitScanForward(&bitIndex, mask);
+        index = static_cast<uint32_t>(bitIndex);
+#else
+        index = static_cast<uint32_t>(__builtin_ctz(mask));
+#endif
+        return true;
+    }
+}
 
 DynamicDescriptorHeap::DynamicDescriptorHeap(
-    D3D12_DESCRIPTOR_HEAP_TYPE heapType,
-    uint32_t numDescriptorsPerHeap) 
-    : m_DescriptorHeapType(heapType)
+    Device& device,
+    Device::DescriptorHeapType heapType,
+    uint32_t numDescriptorsPerHeap)
+    : m_Device(device)
+    , m_DescriptorHeapType(heapType)
     , m_NumDescriptorsPerHeap(numDescriptorsPerHeap)
     , m_DescriptorTableBitMask(0)
     , m_StaleDescriptorTableBitMask(0)
-    , m_CurrentCPUDescriptorHandle(D3D12_DEFAULT)
-    , m_CurrentGPUDescriptorHandle(D3D12_DEFAULT)
+    , m_CurrentGPUDescriptorHandle(0)
+    , m_CurrentCPUDescriptorHandle(0)
     , m_NumFreeHandles(0)
 {
-    m_DescriptorHandleIncrementSize = Application::Get().GetDescriptorHandleIncrementSize(heapType);
+    m_DescriptorHandleIncrementSize = m_Device.GetDescriptorHandleIncrementSize(heapType);
 
     // Allocate space for staging CPU visible descriptors.
-    m_DescriptorHandleCache = std::make_unique<D3D12_CPU_DESCRIPTOR_HANDLE[]>(m_NumDescriptorsPerHeap);
+    m_DescriptorHandleCache = std::make_unique<uint64_t[]>(m_NumDescriptorsPerHeap);
 }
 
 DynamicDescriptorHeap::~DynamicDescriptorHeap() {}
 
-void DynamicDescriptorHeap::ParseRootSignature(const RootSignature& rootSignature) 
+void DynamicDescriptorHeap::ParseRootSignature(uint32_t descriptorTableBitMask, const uint32_t* numDescriptors, uint32_t numParameters)
 {
-    // If the root signature changes, all descriptors 
+    // If the root signature changes, all descriptors
     // must be (re)bound to the command list.
     m_StaleDescriptorTableBitMask = 0;
 
-    const D3D12_ROOT_SIGNATURE_DESC1& rootSignatureDesc = rootSignature.GetRootSignatureDesc();
-
-    // Get a bit mask that represents the root parameter indices that match the
+    // The bit mask represents the root parameter indices that match the
     // descriptor heap type for this dynamic descriptor heap.
-    m_DescriptorTableBitMask = rootSignature.GetDescriptorTableBitMask(m_DescriptorHeapType);
-    uint32_t descriptorTableBitMask = m_DescriptorTableBitMask;
+    m_DescriptorTableBitMask = descriptorTableBitMask;
 
     uint32_t currentOffset = 0;
-    DWORD rootIndex;
-    while (_BitScanForward(&rootIndex, descriptorTableBitMask) && rootIndex < rootSignatureDesc.NumParameters)
+    uint32_t rootIndex;
+    while (BitScanForward(rootIndex, descriptorTableBitMask) && rootIndex < numParameters)
     {
-        uint32_t numDescriptors = rootSignature.GetNumDescriptors(rootIndex);
         DescriptorTableCache& descriptorTableCache = m_DescriptorTableCache[rootIndex];
-        descriptorTableCache.NumDescriptors = numDescriptors;
+        descriptorTableCache.NumDescriptors = numDescriptors[rootIndex];
         descriptorTableCache.BaseDescriptor = m_DescriptorHandleCache.get() + currentOffset;
 
-        currentOffset += numDescriptors;
+        currentOffset += numDescriptors[rootIndex];
 
         // Flip the descriptor table bit so it's not scanned again for the current index.
-        descriptorTableBitMask ^= (1 << rootIndex);
+        descriptorTableBitMask ^= (1u << rootIndex);
     }
+
+    FrameCapture* frameCapture = m_Device.GetFrameCapture();
+    if (frameCapture && frameCapture->IsCapturing())
+    {
+        // The number of descriptors of each root parameter (0 if the parameter
+        // is not a descriptor table of this heap type).
+        std::vector<uint64_t> arguments(1 + numParameters, 0);
+        arguments[0] = static_cast<uint64_t>(m_DescriptorHeapType);
+        for (uint32_t i = 0; i < numParameters && i < MaxDescriptorTables; ++i)
+        {
+            if (m_DescriptorTableBitMask & (1u << i))
+            {
+                arguments[1 + i] = m_DescriptorTableCache[i].NumDescriptors;
+            }
+        }
+        frameCapture->Record(FrameCapture::Call::ParseRootSignature, arguments.data(), arguments.size());
+    }
+
     // Make sure the maximum number of descriptors per descriptor heap has not been exceeded.
     assert(currentOffset <= m_NumDescriptorsPerHeap &&
         "The root signature requires more than the maximum number of descriptors per descriptor heap. Consider increasing the maximum number of descriptors per descriptor heap.");
@@ -59,9 +102,9 @@ void DynamicDescriptorHeap::ParseRootSignature(const RootSignature& rootSignatur
 
 void DynamicDescriptorHeap::StageDescriptors(
     uint32_t rootParameterIndex,
-    uint32_t offset, 
-    uint32_t numDescriptors, 
-    const D3D12_CPU_DESCRIPTOR_HANDLE srcDescriptors) 
+    uint32_t offset,
+    uint32_t numDescriptors,
+    uint64_t srcDescriptors)
 {
     // Cannot stage more than the maximum number of descriptors per heap.
     // Cannot stage more than MaxDescriptorTables root parameters.
@@ -79,34 +122,40 @@ void DynamicDescriptorHeap::StageDescriptors(
         throw std::length_error("Number of descriptors exceeds the number of descriptors in the descriptor table.");
     }
 
-    D3D12_CPU_DESCRIPTOR_HANDLE* dstDescriptor = (descriptorTableCache.BaseDescriptor + offset);
+    if (FrameCapture* frameCapture = m_Device.GetFrameCapture())
+    {
+        frameCapture->Record(FrameCapture::Call::StageDescriptors,
+            { static_cast<uint64_t>(m_DescriptorHeapType), rootParameterIndex, offset, numDescriptors });
+    }
+
+    uint64_t* dstDescriptor = (descriptorTableCache.BaseDescriptor + offset);
     for (uint32_t i = 0; i < numDescriptors; ++i)
     {
-        dstDescriptor[i] = CD3DX12_CPU_DESCRIPTOR_HANDLE(srcDescriptors, i, m_DescriptorHandleIncrementSize);
+        dstDescriptor[i] = srcDescriptors + static_cast<uint64_t>(i) * m_DescriptorHandleIncrementSize;
     }
 
     // Set the root parameter index bit to make sure the descriptor table
     // at the index is bound to the command list.
-    m_StaleDescriptorTableBitMask |= (1 << rootParameterIndex);
+    m_StaleDescriptorTableBitMask |= (1u << rootParameterIndex);
 }
-    
+
 uint32_t DynamicDescriptorHeap::ComputeStaleDescriptorCount() const
 {
     uint32_t numStaleDescriptors = 0;
-    DWORD i;
-    DWORD staleDescriptorsBitMask = m_StaleDescriptorTableBitMask;
+    uint32_t i;
+    uint32_t staleDescriptorsBitMask = m_StaleDescriptorTableBitMask;
 
-    while (_BitScanForward(&i, staleDescriptorsBitMask))
+    while (BitScanForward(i, staleDescriptorsBitMask))
     {
         numStaleDescriptors += m_DescriptorTableCache[i].NumDescriptors;
-        staleDescriptorsBitMask ^= (1 << i);
+        staleDescriptorsBitMask ^= (1u << i);
     }
     return numStaleDescriptors;
 }
 
-ComPtr<ID3D12DescriptorHeap> DynamicDescriptorHeap::RequestDescriptorHeap() 
+std::shared_ptr<Device::DescriptorHeap> DynamicDescriptorHeap::RequestDescriptorHeap()
 {
-    ComPtr<ID3D12DescriptorHeap> descriptorHeap;
+    std::shared_ptr<Device::DescriptorHeap> descriptorHeap;
     if (!m_AvailableDescriptorHeaps.empty())
     {
         descriptorHeap = m_AvailableDescriptorHeaps.front();
@@ -120,171 +169,109 @@ ComPtr<ID3D12DescriptorHeap> DynamicDescriptorHeap::RequestDescriptorHeap()
     return descriptorHeap;
 }
 
-ComPtr<ID3D12DescriptorHeap> DynamicDescriptorHeap::CreateDescriptorHeap() 
+std::shared_ptr<Device::DescriptorHeap> DynamicDescriptorHeap::CreateDescriptorHeap()
 {
-    const ComPtr<ID3D12Device2> device = Application::Get().GetDevice();
-    D3D12_DESCRIPTOR_HEAP_DESC descriptorHeapDesc = {};
-    descriptorHeapDesc.Type = m_DescriptorHeapType;
-    descriptorHeapDesc.NumDescriptors = m_NumDescriptorsPerHeap;
-    descriptorHeapDesc.Flags = D3D12_DESCRIPTOR_HEAP_FLAG_SHADER_VISIBLE;
+    return m_Device.CreateDescriptorHeap(m_DescriptorHeapType, m_NumDescriptorsPerHeap, true);
+}
 
-    ComPtr<ID3D12DescriptorHeap> descriptorHeap;
-    ThrowIfFailed(device->CreateDescriptorHeap(&descriptorHeapDesc, IID_PPV_ARGS(&descriptorHeap)));
+void DynamicDescriptorHeap::SetNewDescriptorHeap(const SetDescriptorHeapFunction& setDescriptorHeap)
+{
+    m_CurrentDescriptorHeap = RequestDescriptorHeap();
+    m_CurrentCPUDescriptorHandle = m_CurrentDescriptorHeap->GetCPUDescriptorHandleForHeapStart();
+    m_CurrentGPUDescriptorHandle = m_CurrentDescriptorHeap->GetGPUDescriptorHandleForHeapStart();
+    m_NumFreeHandles = m_NumDescriptorsPerHeap;
 
-    return descriptorHeap;
+    setDescriptorHeap(*m_CurrentDescriptorHeap);
+
+    // When updating the descriptor heap on the command list, all descriptor
+    // tables must be (re)recopied to the new descriptor heap (not just
+    // the stale descriptor tables).
+    m_StaleDescriptorTableBitMask = m_DescriptorTableBitMask;
 }
 
-void DynamicDescriptorHeap::CommitStagedDescriptors(CommandList& commandList, 
-    std::function<void(ID3D12GraphicsCommandList*, UINT, D3D12_GPU_DESCRIPTOR_HANDLE)> setFunc) 
+void DynamicDescriptorHeap::CommitStagedDescriptors(const SetDescriptorHeapFunction& setDescriptorHeap,
+    const SetDescriptorTableFunction& setDescriptorTable)
 {
+    PROFILE_FUNCTION();
+
+    if (FrameCapture* frameCapture = m_Device.GetFrameCapture())
+    {
+        frameCapture->Record(FrameCapture::Call::CommitStagedDescriptors,
+            { static_cast<uint64_t>(m_DescriptorHeapType) });
+    }
+
     // Compute the number of descriptors that need to be copied.
     const uint32_t numDescriptorsToCommit = ComputeStaleDescriptorCount();
 
     if (numDescriptorsToCommit > 0)
     {
-        const ComPtr<ID3D12Device2> device = Application::Get().GetDevice();
-        auto graphicsCommandList = commandList.GetGraphicsCommandList().Get(); 
-        ASSERT(graphicsCommandList != nullptr);
-
         if (!m_CurrentDescriptorHeap || m_NumFreeHandles < numDescriptorsToCommit)
         {
-            m_CurrentDescriptorHeap = RequestDescriptorHeap();
-            m_CurrentCPUDescriptorHandle = m_CurrentDescriptorHeap->GetCPUDescriptorHandleForHeapStart();
-            m_CurrentGPUDescriptorHandle = m_CurrentDescriptorHeap->GetGPUDescriptorHandleForHeapStart();
-            m_NumFreeHandles = m_NumDescriptorsPerHeap;
-
-            commandList.SetDescriptorHeap(m_DescriptorHeapType, m_CurrentDescriptorHeap.Get());
-
-            // When updating the descriptor heap on the command list, all descriptor
-            // tables must be (re)recopied to the new descriptor heap (not just
-            // the stale descriptor tables).
-            m_StaleDescriptorTableBitMask = m_DescriptorTableBitMask;
+            SetNewDescriptorHeap(setDescriptorHeap);
         }
 
-        DWORD rootIndex;
+        uint32_t rootIndex;
 
         // Scan from LSB to MSB for a bit set in staleDescriptorsBitMask
-        while (_BitScanForward(&rootIndex, m_StaleDescriptorTableBitMask))
+        while (BitScanForward(rootIndex, m_StaleDescriptorTableBitMask))
         {
-            UINT numSrcDescriptors = m_DescriptorTableCache[rootIndex].NumDescriptors;
-            D3D12_CPU_DESCRIPTOR_HANDLE* pSrcDescriptorHandles = m_DescriptorTableCache[rootIndex].BaseDescriptor;
-
-            D3D12_CPU_DESCRIPTOR_HANDLE pDestDescriptorRangeStarts[] =
-            {
-                m_CurrentCPUDescriptorHandle
-            };
-            UINT pDestDescriptorRangeSizes[] =
-            {
-                numSrcDescriptors
-            };
+            uint32_t numSrcDescriptors = m_DescriptorTableCache[rootIndex].NumDescriptors;
+            const uint64_t* pSrcDescriptorHandles = m_DescriptorTableCache[rootIndex].BaseDescriptor;
 
             // Copy the staged CPU visible descriptors to the GPU visible descriptor heap.
-            device->CopyDescriptors(1, pDestDescriptorRangeStarts, pDestDescriptorRangeSizes,
-                numSrcDescriptors, pSrcDescriptorHandles, nullptr, m_DescriptorHeapType);
+            m_Device.CopyDescriptors(numSrcDescriptors, m_CurrentCPUDescriptorHandle, pSrcDescriptorHandles, m_DescriptorHeapType);
 
             // Set the descriptors on the command list using the passed-in setter function.
-            setFunc(graphicsCommandList, rootIndex, m_CurrentGPUDescriptorHandle);
+            setDescriptorTable(rootIndex, m_CurrentGPUDescriptorHandle);
 
             // Offset current CPU and GPU descriptor handles.
-            m_CurrentCPUDescriptorHandle.Offset(numSrcDescriptors, m_DescriptorHandleIncrementSize);
-            m_CurrentGPUDescriptorHandle.Offset(numSrcDescriptors, m_DescriptorHandleIncrementSize);
+            uint64_t tableSize = static_cast<uint64_t>(numSrcDescriptors) * m_DescriptorHandleIncrementSize;
+            m_CurrentCPUDescriptorHandle += tableSize;
+            m_CurrentGPUDescriptorHandle += tableSize;
             m_NumFreeHandles -= numSrcDescriptors;
 
             // Flip the stale bit so the descriptor table is not recopied again unless it is updated with a new descriptor.
-            m_StaleDescriptorTableBitMask ^= (1 << rootIndex);
+            m_StaleDescriptorTableBitMask ^= (1u << rootIndex);
         }
     }
 }
 
-void DynamicDescriptorHeap::CommitStagedDescriptorsForDraw(CommandList& commandList) 
-{
-    CommitStagedDescriptors(commandList, &ID3D12GraphicsCommandList::SetGraphicsRootDescriptorTable);
-}
-
-void DynamicDescriptorHeap::CommitStagedDescriptorsForDispatch(CommandList& commandList) 
-{
-    CommitStagedDescriptors(commandList, &ID3D12GraphicsCommandList::SetComputeRootDescriptorTable);
-}
-
-D3D12_GPU_DESCRIPTOR_HANDLE DynamicDescriptorHeap::CopyDescriptor(CommandList& commandList, D3D12_CPU_DESCRIPTOR_HANDLE cpuDescriptor) 
+uint64_t DynamicDescriptorHeap::CopyDescriptor(const SetDescriptorHeapFunction& setDescriptorHeap, uint64_t cpuDescriptor)
 {
     if (!m_CurrentDescriptorHeap || m_NumFreeHandles < 1)
     {
-        m_CurrentDescriptorHeap = RequestDescriptorHeap();
-        m_CurrentCPUDescriptorHandle = m_CurrentDescriptorHeap->GetCPUDescriptorHandleForHeapStart();
-        m_CurrentGPUDescriptorHandle = m_CurrentDescriptorHeap->GetGPUDescriptorHandleForHeapStart();
-        m_NumFreeHandles = m_NumDescriptorsPerHeap;
-
-        commandList.SetDescriptorHeap(m_DescriptorHeapType, m_CurrentDescriptorHeap.Get());
-
-        // When updating the descriptor heap on the command list, all descriptor
-        // tables must be (re)recopied to the new descriptor heap (not just
-        // the stale descriptor tables).
-        m_StaleDescriptorTableBitMask = m_DescriptorTableBitMask;
+        SetNewDescriptorHeap(setDescriptorHeap);
     }
 
-    const ComPtr<ID3D12Device2> device = Application::Get().GetDevice();
-    D3D12_GPU_DESCRIPTOR_HANDLE hGPU = m_CurrentGPUDescriptorHandle;
-    device->CopyDescriptorsSimple(1, m_CurrentCPUDescriptorHandle, cpuDescriptor, m_DescriptorHeapType);
+    uint64_t hGPU = m_CurrentGPUDescriptorHandle;
+    m_Device.CopyDescriptorsSimple(1, m_CurrentCPUDescriptorHandle, cpuDescriptor, m_DescriptorHeapType);
 
-    m_CurrentCPUDescriptorHandle.Offset(1, m_DescriptorHandleIncrementSize);
-    m_CurrentGPUDescriptorHandle.Offset(1, m_DescriptorHandleIncrementSize);
+    m_CurrentCPUDescriptorHandle += m_DescriptorHandleIncrementSize;
+    m_CurrentGPUDescriptorHandle += m_DescriptorHandleIncrementSize;
     m_NumFreeHandles -= 1;
 
     return hGPU;
 }
 
-void DynamicDescriptorHeap::Reset() 
+void DynamicDescriptorHeap::Reset()
 {
+    if (FrameCapture* frameCapture = m_Device.GetFrameCapture())
+    {
+        frameCapture->Record(FrameCapture::Call::ResetDynamicDescriptorHeap,
+            { static_cast<uint64_t>(m_DescriptorHeapType) });
+    }
+
     m_AvailableDescriptorHeaps = m_DescriptorHeapPool;
-    m_CurrentDescriptorHeap.Reset();
-    m_CurrentCPUDescriptorHandle = CD3DX12_CPU_DESCRIPTOR_HANDLE(D3D12_DEFAULT);
-    m_CurrentGPUDescriptorHandle = CD3DX12_GPU_DESCRIPTOR_HANDLE(D3D12_DEFAULT);
+    m_CurrentDescriptorHeap.reset();
+    m_CurrentCPUDescriptorHandle = 0;
+    m_CurrentGPUDescriptorHandle = 0;
     m_NumFreeHandles = 0;
     m_DescriptorTableBitMask = 0;
     m_StaleDescriptorTableBitMask = 0;
 
-    // Reset the table cache 
-    for (int i = 0; i < MaxDescriptorTables; ++i)
+    // Reset the table cache
+    for (uint32_t i = 0; i < MaxDescriptorTables; ++i)
     {
         m_DescriptorTableCache[i].Reset();
     }
 }
-
-// void sfjkafja()
-// {
-//     CD3DX12_DESCRIPTOR_RANGE1 DescRange[6];
-
-//     DescRange[0].Init(D3D12_DESCRIPTOR_RANGE_TYPE_SRV,6,2); // t2-t7
-//     DescRange[1].Init(D3D12_DESCRIPTOR_RANGE_TYPE_UAV,4,0); // u0-u3
-//     DescRange[2].Init(D3D12_DESCRIPTOR_RANGE_TYPE_SAMPLER,2,0); // s0-s1
-//     DescRange[3].Init(D3D12_DESCRIPTOR_RANGE_TYPE_SRV,-1,8, 0,
-//                     D3D12_DESCRIPTOR_RANGE_FLAG_DESCRIPTORS_VOLATILE); // t8-unbounded
-//     DescRange[4].Init(D3D12_DESCRIPTOR_RANGE_TYPE_SRV,-1,0,1,
-//                     D3D12_DESCRIPTOR_RANGE_FLAG_DESCRIPTORS_VOLATILE); 
-//                                                                 // (t0,space1)-unbounded
-//     DescRange[5].Init(D3D12_DESCRIPTOR_RANGE_TYPE_CBV,1,1,
-//                     D3D12_DESCRIPTOR_RANGE_FLAG_DATA_STATIC); // b1
-
-//     CD3DX12_ROOT_PARAMETER1 RP[7];
-
-//     RP[0].InitAsConstants(3,2); // 3 constants at b2
-//     RP[1].InitAsDescriptorTable(2,&DescRange[0]); // 2 ranges t2-t7 and u0-u3
-//     RP[2].InitAsConstantBufferView(0, 0, D3D12_ROOT_DESCRIPTOR_FLAG_DATA_STATIC); // b0
-//     RP[3].InitAsDescriptorTable(1,&DescRange[2]); // s0-s1
-//     RP[4].InitAsDescriptorTable(1,&DescRange[3]); // t8-unbounded
-//     RP[5].InitAsDescriptorTable(1,&DescRange[4]); // (t0,space1)-unbounded
-//     RP[6].InitAsDescriptorTable(1,&DescRange[5]); // b1 
-//     CD3DX12_STATIC_SAMPLER_DESC StaticSamplers[1];
-//     StaticSamplers[0].Init(3, D3D12_FILTER_ANISOTROPIC); // s3
-//     CD3DX12_VERSIONED_ROOT_SIGNATURE_DESC RootSig(7,RP,1,StaticSamplers);
-//     ID3DBlob* pSerializedRootSig;
-//     HRESULT hr = (D3D12SerializeVersionedRootSignature(&RootSig,pSerializedRootSig)); 
-
-//     ID3D12RootSignature* pRootSignature;
-//     hr = CheckHR(pDevice->CreateRootSignature(
-//         pSerializedRootSig->GetBufferPointer(),pSerializedRootSig->GetBufferSize(),
-//         __uuidof(ID3D12RootSignature),
-//         &pRootSignature));
-// }
-
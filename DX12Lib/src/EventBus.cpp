@@ -0,0 +1,109 @@
+#include <EventBus.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+
+namespace
+{
+    // The listener handle is the event type id (high bits) and the listener id (low bits).
+    EventBus::ListenerHandle MakeHandle(uint32_t eventTypeId, uint32_t listenerId)
+    {
+        return (static_cast<uint64_t>(eventTypeId) << 32) | listenerId;
+    }
+}
+
+EventBus::EventBus()
+    : m_NextListenerId(1)
+    , m_DispatchDepth(0)
+    , m_HasRemovedListeners(false)
+{}
+
+uint32_t EventBus::AllocateEventTypeId()
+{
+    static std::atomic<uint32_t> nextEventTypeId(0);
+    return nextEventTypeId++;
+}
+
+EventBus::ListenerHandle EventBus::AddListener(uint32_t eventTypeId, GenericCallback callback, void* context)
+{
+    assert(callback);
+
+    if (eventTypeId >= m_ListenerLists.size())
+    {
+        m_ListenerLists.resize(eventTypeId + 1);
+    }
+
+    // Listener id 0 is never used, so no handle is InvalidListener.
+    uint32_t listenerId = m_NextListenerId++;
+    if (m_NextListenerId == 0)
+    {
+        m_NextListenerId = 1;
+    }
+
+    ListenerList& listenerList = m_ListenerLists[eventTypeId];
+    listenerList.Listeners.push_back({ callback, context, listenerId });
+    listenerList.NumListeners++;
+
+    return MakeHandle(eventTypeId, listenerId);
+}
+
+bool EventBus::Unsubscribe(ListenerHandle handle)
+{
+    uint32_t eventTypeId = static_cast<uint32_t>(handle >> 32);
+    uint32_t listenerId = static_cast<uint32_t>(handle);
+
+    if (handle == InvalidListener || eventTypeId >= m_ListenerLists.size())
+    {
+        return false;
+    }
+
+    ListenerList& listenerList = m_ListenerLists[eventTypeId];
+    auto listener = std::find_if(listenerList.Listeners.begin(), listenerList.Listeners.end(),
+        [listenerId](const Listener& candidate) { return candidate.Id == listenerId && candidate.Callback; });
+    if (listener == listenerList.Listeners.end())
+    {
+        return false;
+    }
+
+    if (m_DispatchDepth > 0)
+    {
+        // The list is being iterated. The listener is removed at the end of the dispatch.
+        listener->Callback = nullptr;
+        listenerList.HasRemovedListeners = true;
+        m_HasRemovedListeners = true;
+    }
+    else
+    {
+        listenerList.Listeners.erase(listener);
+    }
+    listenerList.NumListeners--;
+
+    return true;
+}
+
+EventBus::DispatchScope::DispatchScope(EventBus& eventBus)
+    : m_EventBus(eventBus)
+{
+    m_EventBus.m_DispatchDepth++;
+}
+
+EventBus::DispatchScope::~DispatchScope()
+{
+    assert(m_EventBus.m_DispatchDepth > 0);
+    if (--m_EventBus.m_DispatchDepth > 0 || !m_EventBus.m_HasRemovedListeners)
+    {
+        return;
+    }
+
+    for (ListenerList& listenerList : m_EventBus.m_ListenerLists)
+    {
+        if (listenerList.HasRemovedListeners)
+        {
+            listenerList.Listeners.erase(std::remove_if(listenerList.Listeners.begin(), listenerList.Listeners.end(),
+                [](const Listener& listener) { return !listener.Callback; }), listenerList.Listeners.end());
+            listenerList.HasRemovedListeners = false;
+        }
+    }
+    m_EventBus.m_HasRemovedListeners = false;
+}
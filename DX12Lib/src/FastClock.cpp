@@ -0,0 +1,151 @@
+#include <FastClock.h>
+
+#include <chrono>
+#include <mutex>
+#include <thread>
+
+#if defined(_M_X64) || defined(_M_IX86)
+#include <intrin.h>
+#define FASTCLOCK_X86 1
+#elif defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#include <x86intrin.h>
+#define FASTCLOCK_X86 1
+#else
+#define FASTCLOCK_X86 0
+#endif
+
+namespace
+{
+    // The minimum time the TSC is counted against steady_clock to calibrate its frequency.
+    const std::chrono::nanoseconds MinCalibrationTime = std::chrono::milliseconds(20);
+
+    bool DetectInvariantTSC()
+    {
+#if FASTCLOCK_X86
+        // CPUID.80000007H:EDX[8] is the invariant TSC flag.
+#if defined(_MSC_VER)
+        int registers[4];
+        __cpuid(registers, 0x80000000);
+        if (static_cast<unsigned int>(registers[0]) < 0x80000007)
+        {
+            return false;
+        }
+        __cpuid(registers, 0x80000007);
+        return (registers[3] & (1 << 8)) != 0;
+#else
+        unsigned int eax, ebx, ecx, edx;
+        if (__get_cpuid_max(0x80000000, nullptr) < 0x80000007 ||
+            !__get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx))
+        {
+            return false;
+        }
+        return (edx & (1 << 8)) != 0;
+#endif
+#else
+        return false;
+#endif
+    }
+
+    uint64_t ReadTSC()
+    {
+#if FASTCLOCK_X86
+        return __rdtsc();
+#else
+        return 0;
+#endif
+    }
+
+    uint64_t ReadSteadyClock()
+    {
+        using namespace std::chrono;
+        return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+    }
+
+    struct ClockState
+    {
+        ClockState()
+            : InvariantTSC(DetectInvariantTSC())
+            , UseTSC(InvariantTSC)
+            , CalibrationSteadyClock(ReadSteadyClock())
+            , CalibrationTSC(ReadTSC())
+        {}
+
+        // The TSC is used if it is invariant.
+        const bool InvariantTSC;
+        const bool UseTSC;
+
+        // The calibration counts the TSC ticks from the first use of the
+        // clock until the frequency is needed (usually much longer than
+        // MinCalibrationTime, so the calibration does not have to wait).
+        const uint64_t CalibrationSteadyClock;
+        const uint64_t CalibrationTSC;
+        std::once_flag CalibrationFlag;
+        double TSCFrequency = 0.0;
+    };
+
+    ClockState& GetState()
+    {
+        static ClockState state;
+        return state;
+    }
+
+    double GetTSCFrequency()
+    {
+        ClockState& state = GetState();
+        std::call_once(state.CalibrationFlag, [&state]()
+        {
+            uint64_t elapsed = ReadSteadyClock() - state.CalibrationSteadyClock;
+            if (elapsed < static_cast<uint64_t>(MinCalibrationTime.count()))
+            {
+                std::this_thread::sleep_for(MinCalibrationTime - std::chrono::nanoseconds(elapsed));
+            }
+
+            uint64_t tsc = ReadTSC();
+            uint64_t steadyClock = ReadSteadyClock();
+            state.TSCFrequency = static_cast<double>(tsc - state.CalibrationTSC) * 1e9 /
+                static_cast<double>(steadyClock - state.CalibrationSteadyClock);
+        });
+        return state.TSCFrequency;
+    }
+}
+
+uint64_t FastClock::Now()
+{
+    return GetState().UseTSC ? ReadTSC() : ReadSteadyClock();
+}
+
+FastClock::Source FastClock::GetSource()
+{
+    return GetState().UseTSC ? Source::TSC : Source::SteadyClock;
+}
+
+bool FastClock::HasInvariantTSC()
+{
+    return GetState().InvariantTSC;
+}
+
+double FastClock::GetFrequency()
+{
+    return GetSource() == Source::TSC ? GetTSCFrequency() : 1e9;
+}
+
+double FastClock::GetSecondsPerTick()
+{
+    return 1.0 / GetFrequency();
+}
+
+double FastClock::ToSeconds(uint64_t ticks)
+{
+    return static_cast<double>(ticks) * GetSecondsPerTick();
+}
+
+double FastClock::GetSeconds()
+{
+    return ToSeconds(Now());
+}
+
+uint64_t FastClock::ToNanoseconds(uint64_t ticks)
+{
+    return static_cast<uint64_t>(static_cast<double>(ticks) * 1e9 * GetSecondsPerTick());
+}
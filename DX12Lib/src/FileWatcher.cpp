@@ -0,0 +1,236 @@
+#include <FileWatcher.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <map>
+#include <system_error>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#include <Windows.h>
+#else
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace
+{
+    // Directories are compared by their canonical path.
+    fs::path GetCanonicalPath(const fs::path& path)
+    {
+        std::error_code error;
+        fs::path canonicalPath = fs::weakly_canonical(path, error);
+        return error ? path.lexically_normal() : canonicalPath;
+    }
+
+    void AddUnique(std::vector<fs::path>& files, fs::path file)
+    {
+        if (std::find(files.begin(), files.end(), file) == files.end())
+        {
+            files.push_back(std::move(file));
+        }
+    }
+}
+
+#if defined(_WIN32)
+
+struct FileWatcher::Platform
+{
+    struct Directory
+    {
+        fs::path Path;
+        HANDLE hDirectory = INVALID_HANDLE_VALUE;
+        OVERLAPPED Overlapped = {};
+        // FILE_NOTIFY_INFORMATION records are DWORD aligned.
+        alignas(DWORD) uint8_t Buffer[16 * 1024];
+    };
+
+    // Start (or restart) an asynchronous read of the changes in the directory.
+    static bool ReadChanges(Directory& directory)
+    {
+        return ReadDirectoryChangesW(directory.hDirectory, directory.Buffer, sizeof(directory.Buffer), FALSE,
+            FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_SIZE,
+            nullptr, &directory.Overlapped, nullptr) != FALSE;
+    }
+
+    ~Platform()
+    {
+        for (auto& directory : Directories)
+        {
+            CancelIoEx(directory->hDirectory, &directory->Overlapped);
+            // Wait for the cancelled read to complete before the buffer is released.
+            DWORD numBytes;
+            GetOverlappedResult(directory->hDirectory, &directory->Overlapped, &numBytes, TRUE);
+            CloseHandle(directory->hDirectory);
+            CloseHandle(directory->Overlapped.hEvent);
+        }
+    }
+
+    std::vector< std::unique_ptr<Directory> > Directories;
+};
+
+FileWatcher::FileWatcher()
+    : m_Platform(std::make_unique<Platform>())
+{}
+
+FileWatcher::~FileWatcher()
+{}
+
+bool FileWatcher::AddDirectory(const fs::path& directoryPath)
+{
+    fs::path path = GetCanonicalPath(directoryPath);
+    for (const auto& directory : m_Platform->Directories)
+    {
+        if (directory->Path == path)
+        {
+            return true;
+        }
+    }
+
+    auto directory = std::make_unique<Platform::Directory>();
+    directory->Path = path;
+    directory->hDirectory = CreateFileW(path.c_str(), FILE_LIST_DIRECTORY,
+        FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING,
+        FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OVERLAPPED, nullptr);
+    if (directory->hDirectory == INVALID_HANDLE_VALUE)
+    {
+        return false;
+    }
+
+    directory->Overlapped.hEvent = CreateEventW(nullptr, TRUE, FALSE, nullptr);
+    if (!directory->Overlapped.hEvent || !Platform::ReadChanges(*directory))
+    {
+        if (directory->Overlapped.hEvent)
+        {
+            CloseHandle(directory->Overlapped.hEvent);
+        }
+        CloseHandle(directory->hDirectory);
+        return false;
+    }
+
+    m_Platform->Directories.push_back(std::move(directory));
+    return true;
+}
+
+std::vector<fs::path> FileWatcher::Poll()
+{
+    std::vector<fs::path> changedFiles;
+
+    for (auto& directory : m_Platform->Directories)
+    {
+        DWORD numBytes = 0;
+        if (!GetOverlappedResult(directory->hDirectory, &directory->Overlapped, &numBytes, FALSE))
+        {
+            // ERROR_IO_INCOMPLETE: no changes yet.
+            continue;
+        }
+
+        // numBytes is 0 if the buffer overflowed. The changes are lost in that case.
+        const uint8_t* record = directory->Buffer;
+        while (numBytes > 0)
+        {
+            auto info = reinterpret_cast<const FILE_NOTIFY_INFORMATION*>(record);
+            if (info->Action != FILE_ACTION_REMOVED && info->Action != FILE_ACTION_RENAMED_OLD_NAME)
+            {
+                std::wstring fileName(info->FileName, info->FileNameLength / sizeof(WCHAR));
+                AddUnique(changedFiles, directory->Path / fileName);
+            }
+
+            if (info->NextEntryOffset == 0)
+            {
+                break;
+            }
+            record += info->NextEntryOffset;
+        }
+
+        ResetEvent(directory->Overlapped.hEvent);
+        Platform::ReadChanges(*directory);
+    }
+
+    return changedFiles;
+}
+
+#else
+
+struct FileWatcher::Platform
+{
+    ~Platform()
+    {
+        if (FileDescriptor >= 0)
+        {
+            close(FileDescriptor);
+        }
+    }
+
+    int FileDescriptor = -1;
+    // The watched directory of each watch descriptor.
+    std::map<int, fs::path> Directories;
+};
+
+FileWatcher::FileWatcher()
+    : m_Platform(std::make_unique<Platform>())
+{
+    m_Platform->FileDescriptor = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+}
+
+FileWatcher::~FileWatcher()
+{}
+
+bool FileWatcher::AddDirectory(const fs::path& directoryPath)
+{
+    if (m_Platform->FileDescriptor < 0)
+    {
+        return false;
+    }
+
+    fs::path path = GetCanonicalPath(directoryPath);
+
+    // Editors either write the file in place or write a temporary file and rename it.
+    int watchDescriptor = inotify_add_watch(m_Platform->FileDescriptor, path.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO);
+    if (watchDescriptor < 0)
+    {
+        return false;
+    }
+
+    // inotify returns the same descriptor if the directory is already watched.
+    m_Platform->Directories[watchDescriptor] = path;
+    return true;
+}
+
+std::vector<fs::path> FileWatcher::Poll()
+{
+    std::vector<fs::path> changedFiles;
+
+    if (m_Platform->FileDescriptor < 0)
+    {
+        return changedFiles;
+    }
+
+    alignas(inotify_event) char buffer[16 * 1024];
+    for (;;)
+    {
+        ssize_t numBytes = read(m_Platform->FileDescriptor, buffer, sizeof(buffer));
+        if (numBytes <= 0)
+        {
+            // EAGAIN: no more events.
+            break;
+        }
+
+        for (char* record = buffer; record < buffer + numBytes; )
+        {
+            auto event = reinterpret_cast<const inotify_event*>(record);
+            auto directory = m_Platform->Directories.find(event->wd);
+            if (event->len > 0 && directory != m_Platform->Directories.end())
+            {
+                AddUnique(changedFiles, directory->second / event->name);
+            }
+            record += sizeof(inotify_event) + event->len;
+        }
+    }
+
+    return changedFiles;
+}
+
+#endif
@@ -0,0 +1,107 @@
+#include <FixedStepScheduler.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    // The timestamps are rounded, so a frame that ends exactly on a step
+    // boundary may accumulate slightly less than a full step.
+    const double StepTolerance = 1e-6;
+}
+
+FixedStepScheduler::FixedStepScheduler()
+    : FixedStepScheduler(Settings())
+{}
+
+FixedStepScheduler::FixedStepScheduler(const Settings& settings)
+    : m_Accumulator(0.0)
+    , m_StepCount(0)
+    , m_DroppedTime(0.0)
+    , m_HasPreviousFrame(false)
+    , m_PreviousFrameTime(0.0)
+{
+    SetSettings(settings);
+}
+
+const FixedStepScheduler::Settings& FixedStepScheduler::GetSettings() const
+{
+    return m_Settings;
+}
+
+void FixedStepScheduler::SetSettings(const Settings& settings)
+{
+    m_Settings = settings;
+    m_Settings.StepsPerSecond = std::max(1.0, m_Settings.StepsPerSecond);
+    m_Settings.MaxStepsPerFrame = std::max(1u, m_Settings.MaxStepsPerFrame);
+
+    // A shorter step duration can leave more than a step in the accumulator.
+    m_StepDuration = 1.0 / m_Settings.StepsPerSecond;
+    DropUnsimulatedTime();
+}
+
+uint32_t FixedStepScheduler::BeginFrame(double now)
+{
+    // The first frame only starts the accumulation.
+    if (!m_HasPreviousFrame)
+    {
+        m_HasPreviousFrame = true;
+        m_PreviousFrameTime = now;
+        return 0;
+    }
+
+    m_Accumulator += std::max(0.0, now - m_PreviousFrameTime);
+    m_PreviousFrameTime = now;
+
+    uint32_t numSteps = static_cast<uint32_t>(std::min(std::floor(m_Accumulator / m_StepDuration + StepTolerance),
+        static_cast<double>(m_Settings.MaxStepsPerFrame)));
+    m_Accumulator = std::max(0.0, m_Accumulator - numSteps * m_StepDuration);
+    DropUnsimulatedTime();
+
+    m_StepCount += numSteps;
+
+    return numSteps;
+}
+
+void FixedStepScheduler::DropUnsimulatedTime()
+{
+    // Drop the time that can't be simulated in this frame (but keep the fraction
+    // of a step, so alpha is continuous and stays below one).
+    if (m_Accumulator >= m_StepDuration)
+    {
+        double remainder = std::fmod(m_Accumulator, m_StepDuration);
+        m_DroppedTime += m_Accumulator - remainder;
+        m_Accumulator = remainder;
+    }
+}
+
+void FixedStepScheduler::Reset()
+{
+    m_Accumulator = 0.0;
+    m_HasPreviousFrame = false;
+}
+
+double FixedStepScheduler::GetStepDuration() const
+{
+    return m_StepDuration;
+}
+
+double FixedStepScheduler::GetAlpha() const
+{
+    return m_Accumulator / m_StepDuration;
+}
+
+uint64_t FixedStepScheduler::GetStepCount() const
+{
+    return m_StepCount;
+}
+
+double FixedStepScheduler::GetTime() const
+{
+    return m_StepCount * m_StepDuration;
+}
+
+double FixedStepScheduler::GetDroppedTime() const
+{
+    return m_DroppedTime;
+}
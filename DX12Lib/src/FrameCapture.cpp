@@ -0,0 +1,208 @@
+#include <FrameCapture.h>
+
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+
+namespace
+{
+    const uint8_t Magic[] = { 'D', 'X', 'F', 'C' };
+    const uint8_t Version = 1;
+
+    void WriteVarint(std::vector<uint8_t>& data, uint64_t value)
+    {
+        while (value >= 0x80)
+        {
+            data.push_back(static_cast<uint8_t>(value) | 0x80);
+            value >>= 7;
+        }
+        data.push_back(static_cast<uint8_t>(value));
+    }
+
+    bool ReadVarint(const std::vector<uint8_t>& data, size_t& position, uint64_t& value)
+    {
+        value = 0;
+        for (uint32_t shift = 0; shift < 64; shift += 7)
+        {
+            if (position >= data.size())
+            {
+                return false;
+            }
+
+            uint8_t byte = data[position++];
+            value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+            if ((byte & 0x80) == 0)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+}
+
+FrameCapture::FrameCapture()
+    : m_IsCapturing(false)
+    , m_NumFrames(0)
+    , m_FrameCount(0)
+{}
+
+void FrameCapture::Begin(const std::string& fileName, uint32_t numFrames)
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+
+    m_Data.assign(std::begin(Magic), std::end(Magic));
+    m_Data.push_back(Version);
+    m_FileName = fileName;
+    m_NumFrames = numFrames;
+    m_FrameCount = 0;
+
+    m_IsCapturing = numFrames > 0;
+}
+
+void FrameCapture::Record(Call call, std::initializer_list<uint64_t> arguments)
+{
+    Record(call, arguments.begin(), arguments.size());
+}
+
+void FrameCapture::Record(Call call, const uint64_t* arguments, size_t numArguments)
+{
+    if (!IsCapturing())
+    {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(m_Mutex);
+
+    // The capture may have ended while waiting for the lock.
+    if (m_IsCapturing)
+    {
+        Write(call, arguments, numArguments);
+    }
+}
+
+bool FrameCapture::EndFrame()
+{
+    if (!IsCapturing())
+    {
+        return true;
+    }
+
+    std::lock_guard<std::mutex> lock(m_Mutex);
+
+    Write(Call::EndFrame, nullptr, 0);
+    if (++m_FrameCount < m_NumFrames)
+    {
+        return true;
+    }
+
+    m_IsCapturing = false;
+
+    std::ofstream file(m_FileName, std::ios::binary);
+    file.write(reinterpret_cast<const char*>(m_Data.data()), m_Data.size());
+    m_Data.clear();
+
+    return static_cast<bool>(file);
+}
+
+void FrameCapture::Write(Call call, const uint64_t* arguments, size_t numArguments)
+{
+    m_Data.push_back(static_cast<uint8_t>(call));
+    WriteVarint(m_Data, numArguments);
+    for (size_t i = 0; i < numArguments; ++i)
+    {
+        WriteVarint(m_Data, arguments[i]);
+    }
+}
+
+bool FrameCapture::Decode(const std::vector<uint8_t>& data, Stream& stream)
+{
+    stream = Stream();
+
+    size_t position = sizeof(Magic) + 1;
+    if (data.size() < position || !std::equal(std::begin(Magic), std::end(Magic), data.begin()) ||
+        data[sizeof(Magic)] != Version)
+    {
+        return false;
+    }
+
+    while (position < data.size())
+    {
+        uint8_t call = data[position++];
+        uint64_t numArguments;
+        if (call >= static_cast<uint8_t>(Call::NumCalls) ||
+            !ReadVarint(data, position, numArguments) ||
+            numArguments > data.size() - position)
+        {
+            return false;
+        }
+
+        CallRecord record;
+        record.Type = static_cast<Call>(call);
+        record.FirstArgument = static_cast<uint32_t>(stream.Arguments.size());
+        record.NumArguments = static_cast<uint32_t>(numArguments);
+
+        for (uint64_t i = 0; i < numArguments; ++i)
+        {
+            uint64_t argument;
+            if (!ReadVarint(data, position, argument))
+            {
+                return false;
+            }
+            stream.Arguments.push_back(argument);
+        }
+
+        if (record.Type == Call::EndFrame)
+        {
+            stream.NumFrames++;
+        }
+
+        stream.Records.push_back(record);
+    }
+
+    return true;
+}
+
+bool FrameCapture::Load(const std::string& fileName, Stream& stream)
+{
+    std::ifstream file(fileName, std::ios::binary);
+    if (!file)
+    {
+        return false;
+    }
+
+    std::vector<uint8_t> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    return Decode(data, stream);
+}
+
+const char* FrameCapture::GetCallName(Call call)
+{
+    switch (call)
+    {
+    case Call::AllocateDescriptors:
+        return "AllocateDescriptors";
+    case Call::FreeDescriptors:
+        return "FreeDescriptors";
+    case Call::ReleaseStaleDescriptors:
+        return "ReleaseStaleDescriptors";
+    case Call::AllocateUpload:
+        return "AllocateUpload";
+    case Call::ResetUploadBuffer:
+        return "ResetUploadBuffer";
+    case Call::ParseRootSignature:
+        return "ParseRootSignature";
+    case Call::StageDescriptors:
+        return "StageDescriptors";
+    case Call::CommitStagedDescriptors:
+        return "CommitStagedDescriptors";
+    case Call::ResetDynamicDescriptorHeap:
+        return "ResetDynamicDescriptorHeap";
+    case Call::Command:
+        return "Command";
+    case Call::ExecuteCommandList:
+        return "ExecuteCommandList";
+    case Call::EndFrame:
+        return "EndFrame";
+    default:
+        return "Unknown";
+    }
+}
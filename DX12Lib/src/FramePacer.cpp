@@ -0,0 +1,130 @@
+#include <FramePacer.h>
+
+#include <algorithm>
+#include <cassert>
+
+FramePacer::FramePacer()
+    : FramePacer(Settings())
+{}
+
+FramePacer::FramePacer(const Settings& settings)
+    : m_FrameFenceValues{ 0 }
+    , m_FrameCount(0)
+    , m_InFrame(false)
+    , m_HasPreviousFrame(false)
+    , m_PreviousBeginTime(0.0)
+{
+    SetSettings(settings);
+}
+
+const FramePacer::Settings& FramePacer::GetSettings() const
+{
+    return m_Settings;
+}
+
+void FramePacer::SetSettings(const Settings& settings)
+{
+    m_Settings = settings;
+    m_Settings.MaxFramesInFlight = std::clamp(m_Settings.MaxFramesInFlight, 1u, MaxTrackedFrames);
+    m_Settings.MaxFrameLatency = std::clamp(m_Settings.MaxFrameLatency, 1u, MaxTrackedFrames);
+    m_Settings.SyncInterval = std::clamp(m_Settings.SyncInterval, 1u, 4u);
+    m_Settings.TargetFrameTime = std::max(0.0, m_Settings.TargetFrameTime);
+}
+
+uint64_t FramePacer::GetFenceValueToWait() const
+{
+    // Frame N may only start when frame (N - MaxFramesInFlight) has been retired.
+    if (m_FrameCount < m_Settings.MaxFramesInFlight)
+    {
+        return 0;
+    }
+
+    uint64_t frameToRetire = m_FrameCount - m_Settings.MaxFramesInFlight;
+    return m_FrameFenceValues[frameToRetire % MaxTrackedFrames];
+}
+
+uint32_t FramePacer::GetFramesInFlight(uint64_t completedFenceValue) const
+{
+    uint64_t firstFrame = m_FrameCount > MaxTrackedFrames ? m_FrameCount - MaxTrackedFrames : 0;
+
+    uint32_t framesInFlight = 0;
+    for (uint64_t frame = firstFrame; frame < m_FrameCount; ++frame)
+    {
+        if (m_FrameFenceValues[frame % MaxTrackedFrames] > completedFenceValue)
+        {
+            ++framesInFlight;
+        }
+    }
+    return framesInFlight;
+}
+
+double FramePacer::GetPacingDelay(double now) const
+{
+    if (!m_HasPreviousFrame || m_Settings.TargetFrameTime <= 0.0)
+    {
+        return 0.0;
+    }
+
+    double targetBeginTime = m_PreviousBeginTime + m_Settings.TargetFrameTime;
+    return std::max(0.0, targetBeginTime - now);
+}
+
+void FramePacer::BeginFrame(double now, double gpuWaitTime, double pacingWaitTime, uint64_t completedFenceValue)
+{
+    // If the previous frame was not presented (for example, the game did not
+    // render), it is discarded: it has no fence value and is not in the history.
+    m_CurrentFrame = FrameTiming();
+    m_CurrentFrame.FrameNumber = m_FrameCount;
+    m_CurrentFrame.BeginTime = now;
+    m_CurrentFrame.FrameTime = m_HasPreviousFrame ? now - m_PreviousBeginTime : 0.0;
+    m_CurrentFrame.GpuWaitTime = gpuWaitTime;
+    m_CurrentFrame.PacingWaitTime = pacingWaitTime;
+    m_CurrentFrame.FramesInFlight = GetFramesInFlight(completedFenceValue);
+
+    m_PreviousBeginTime = now;
+    m_HasPreviousFrame = true;
+    m_InFrame = true;
+}
+
+void FramePacer::EndFrame(double now, uint64_t fenceValue)
+{
+    if (!m_InFrame)
+    {
+        // Present was called outside of a paced frame (for example, during a resize).
+        // Still track the fence so the frames in flight limit is respected.
+        m_CurrentFrame = FrameTiming();
+        m_CurrentFrame.FrameNumber = m_FrameCount;
+        m_CurrentFrame.BeginTime = now;
+    }
+
+    m_CurrentFrame.CpuTime = now - m_CurrentFrame.BeginTime;
+
+    m_FrameFenceValues[m_FrameCount % MaxTrackedFrames] = fenceValue;
+    m_TimingHistory[m_FrameCount % TimingHistorySize] = m_CurrentFrame;
+
+    ++m_FrameCount;
+    m_InFrame = false;
+}
+
+void FramePacer::Reset()
+{
+    std::fill_n(m_FrameFenceValues, MaxTrackedFrames, 0);
+    m_InFrame = false;
+    m_HasPreviousFrame = false;
+}
+
+uint64_t FramePacer::GetFrameCount() const
+{
+    return m_FrameCount;
+}
+
+const FramePacer::FrameTiming& FramePacer::GetFrameTiming(uint32_t framesAgo) const
+{
+    assert(framesAgo < GetNumFrameTimings());
+    return m_TimingHistory[(m_FrameCount - 1 - framesAgo) % TimingHistorySize];
+}
+
+uint32_t FramePacer::GetNumFrameTimings() const
+{
+    return static_cast<uint32_t>(std::min<uint64_t>(m_FrameCount, TimingHistorySize));
+}
@@ -0,0 +1,309 @@
+#include <FrameReplayer.h>
+
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+
+namespace
+{
+    using DescriptorHeapType = Device::DescriptorHeapType;
+
+    double GetTime()
+    {
+        using namespace std::chrono;
+        return duration<double>(steady_clock::now().time_since_epoch()).count();
+    }
+}
+
+FrameReplayer::FrameReplayer(NullDevice& device)
+    : FrameReplayer(device, Settings())
+{}
+
+FrameReplayer::FrameReplayer(NullDevice& device, const Settings& settings)
+    : m_Device(device)
+    , m_Settings(settings)
+{
+    for (uint32_t i = 0; i < NumHeapTypes; ++i)
+    {
+        DescriptorHeapType heapType = static_cast<DescriptorHeapType>(i);
+
+        m_DescriptorAllocators[i] = std::make_unique<DescriptorAllocator>(m_Device, heapType, m_Settings.NumDescriptorsPerHeap);
+        m_DynamicDescriptorHeaps[i] = std::make_unique<DynamicDescriptorHeap>(m_Device, heapType, m_Settings.NumDynamicDescriptorsPerHeap);
+        // A descriptor table can't be larger than a dynamic descriptor heap,
+        // so all staged descriptors are copied from the start of the source heap.
+        m_SourceDescriptorHeaps[i] = m_Device.CreateDescriptorHeap(heapType, m_Settings.NumDynamicDescriptorsPerHeap, false);
+    }
+
+    m_UploadBuffer = std::make_unique<UploadBuffer>(m_Device, static_cast<size_t>(m_Settings.UploadPageSize));
+
+    m_CommandQueue = std::static_pointer_cast<NullDevice::CommandQueue>(m_Device.CreateCommandQueue(NullDevice::CommandListType::Direct));
+    m_CommandList = std::static_pointer_cast<NullDevice::CommandList>(m_Device.CreateCommandList(NullDevice::CommandListType::Direct));
+
+    m_SetDescriptorHeap = [this](Device::DescriptorHeap& descriptorHeap)
+    {
+        m_CommandList->SetDescriptorHeap(descriptorHeap);
+    };
+    m_SetDescriptorTable = [this](uint32_t rootParameterIndex, uint64_t baseDescriptor)
+    {
+        m_CommandList->SetRootDescriptorTable(rootParameterIndex, baseDescriptor);
+    };
+}
+
+void FrameReplayer::Replay(const FrameCapture::Stream& stream)
+{
+    double frameStart = GetTime();
+
+    for (const FrameCapture::CallRecord& record : stream.Records)
+    {
+        const uint64_t* arguments = stream.Arguments.data() + record.FirstArgument;
+
+        double start = GetTime();
+        bool replayed = Execute(record.Type, arguments, record.NumArguments);
+        double end = GetTime();
+
+        if (!replayed)
+        {
+            m_Statistics.NumSkippedCalls++;
+            continue;
+        }
+
+        CallStatistics& callStatistics = m_Statistics.Calls[static_cast<size_t>(record.Type)];
+        double time = end - start;
+        callStatistics.MinTime = callStatistics.Count > 0 ? std::min(callStatistics.MinTime, time) : time;
+        callStatistics.MaxTime = std::max(callStatistics.MaxTime, time);
+        callStatistics.TotalTime += time;
+        callStatistics.Count++;
+
+        if (record.Type == Call::EndFrame)
+        {
+            m_Statistics.FrameTimes.push_back(end - frameStart);
+            frameStart = end;
+        }
+    }
+}
+
+const FrameReplayer::Statistics& FrameReplayer::GetStatistics() const
+{
+    return m_Statistics;
+}
+
+bool FrameReplayer::Execute(Call call, const uint64_t* arguments, uint32_t numArguments)
+{
+    // The number of arguments of the calls with a fixed number of arguments.
+    static const uint32_t NumArguments[] =
+    {
+        3, // AllocateDescriptors
+        3, // FreeDescriptors
+        2, // ReleaseStaleDescriptors
+        2, // AllocateUpload
+        0, // ResetUploadBuffer
+        1, // ParseRootSignature (at least)
+        4, // StageDescriptors
+        1, // CommitStagedDescriptors
+        1, // ResetDynamicDescriptorHeap
+        1, // Command (at least)
+        1, // ExecuteCommandList
+        0, // EndFrame
+    };
+    static_assert(sizeof(NumArguments) / sizeof(NumArguments[0]) == static_cast<size_t>(Call::NumCalls),
+        "The number of arguments must be specified for each call.");
+
+    if (numArguments < NumArguments[static_cast<size_t>(call)])
+    {
+        return false;
+    }
+
+    // Calls that take a descriptor heap type as the first argument.
+    uint32_t heapType = numArguments > 0 ? static_cast<uint32_t>(arguments[0]) : 0;
+    switch (call)
+    {
+    case Call::AllocateDescriptors:
+    case Call::FreeDescriptors:
+    case Call::ReleaseStaleDescriptors:
+    case Call::ParseRootSignature:
+    case Call::StageDescriptors:
+    case Call::CommitStagedDescriptors:
+    case Call::ResetDynamicDescriptorHeap:
+        if (heapType >= NumHeapTypes)
+        {
+            return false;
+        }
+        break;
+    default:
+        break;
+    }
+
+    switch (call)
+    {
+    case Call::AllocateDescriptors:
+        return AllocateDescriptors(heapType, static_cast<uint32_t>(arguments[1]), arguments[2]);
+    case Call::FreeDescriptors:
+        return FreeDescriptors(heapType, arguments[1], arguments[2]);
+    case Call::ReleaseStaleDescriptors:
+        ReleaseStaleDescriptors(heapType, arguments[1]);
+        return true;
+    case Call::AllocateUpload:
+        return AllocateUpload(arguments[0], arguments[1]);
+    case Call::ResetUploadBuffer:
+        ResetUploadBuffer();
+        return true;
+    case Call::ParseRootSignature:
+        return ParseRootSignature(heapType, arguments + 1, numArguments - 1);
+    case Call::StageDescriptors:
+        return StageDescriptors(heapType, static_cast<uint32_t>(arguments[1]),
+            static_cast<uint32_t>(arguments[2]), static_cast<uint32_t>(arguments[3]));
+    case Call::CommitStagedDescriptors:
+        CommitStagedDescriptors(heapType);
+        return true;
+    case Call::ResetDynamicDescriptorHeap:
+        ResetDynamicDescriptorHeap(heapType);
+        return true;
+    case Call::Command:
+        return RecordCommand(arguments, numArguments);
+    case Call::ExecuteCommandList:
+        ExecuteCommandList();
+        return true;
+    case Call::EndFrame:
+        return true;
+    default:
+        return false;
+    }
+}
+
+bool FrameReplayer::AllocateDescriptors(uint32_t heapType, uint32_t numDescriptors, uint64_t descriptor)
+{
+    if (numDescriptors == 0)
+    {
+        return false;
+    }
+
+    // Replace an allocation that was not freed in the capture (it was freed
+    // before the capture started and the handle was allocated again).
+    m_DescriptorAllocations[heapType][descriptor] = m_DescriptorAllocators[heapType]->Allocate(numDescriptors);
+
+    return true;
+}
+
+bool FrameReplayer::FreeDescriptors(uint32_t heapType, uint64_t descriptor, uint64_t frameNumber)
+{
+    std::map<uint64_t, DescriptorAllocation>& allocations = m_DescriptorAllocations[heapType];
+
+    auto iter = allocations.find(descriptor);
+    if (iter == allocations.end())
+    {
+        // The descriptors were allocated before the capture started.
+        return false;
+    }
+
+    // The descriptors are stale until the frame that freed them is released.
+    m_Device.SetFrameCount(frameNumber);
+    allocations.erase(iter);
+
+    return true;
+}
+
+void FrameReplayer::ReleaseStaleDescriptors(uint32_t heapType, uint64_t frameNumber)
+{
+    m_DescriptorAllocators[heapType]->ReleaseStaleDescriptors(frameNumber);
+}
+
+bool FrameReplayer::AllocateUpload(uint64_t sizeInBytes, uint64_t alignment)
+{
+    // The alignment must be a power of two and the aligned allocation must fit in a page.
+    if (alignment == 0 || (alignment & (alignment - 1)) != 0 ||
+        sizeInBytes > m_Settings.UploadPageSize ||
+        ((sizeInBytes + alignment - 1) & ~(alignment - 1)) > m_Settings.UploadPageSize)
+    {
+        return false;
+    }
+
+    m_UploadBuffer->Allocate(static_cast<size_t>(sizeInBytes), static_cast<size_t>(alignment));
+
+    return true;
+}
+
+void FrameReplayer::ResetUploadBuffer()
+{
+    m_UploadBuffer->Reset();
+}
+
+bool FrameReplayer::ParseRootSignature(uint32_t heapType, const uint64_t* numDescriptors, uint32_t numParameters)
+{
+    numParameters = std::min(numParameters, DynamicDescriptorHeap::MaxDescriptorTables);
+
+    uint32_t descriptorTableNumDescriptors[DynamicDescriptorHeap::MaxDescriptorTables] = {};
+    uint32_t descriptorTableBitMask = 0;
+    uint64_t totalNumDescriptors = 0;
+    for (uint32_t rootIndex = 0; rootIndex < numParameters; ++rootIndex)
+    {
+        if (numDescriptors[rootIndex] > 0)
+        {
+            descriptorTableNumDescriptors[rootIndex] = static_cast<uint32_t>(numDescriptors[rootIndex]);
+            descriptorTableBitMask |= (1u << rootIndex);
+            totalNumDescriptors += numDescriptors[rootIndex];
+        }
+    }
+
+    // The dynamic descriptor heap asserts if the root signature doesn't fit.
+    if (totalNumDescriptors > m_Settings.NumDynamicDescriptorsPerHeap)
+    {
+        return false;
+    }
+
+    m_DynamicDescriptorHeaps[heapType]->ParseRootSignature(descriptorTableBitMask, descriptorTableNumDescriptors, numParameters);
+
+    return true;
+}
+
+bool FrameReplayer::StageDescriptors(uint32_t heapType, uint32_t rootParameterIndex, uint32_t offset, uint32_t numDescriptors)
+{
+    try
+    {
+        m_DynamicDescriptorHeaps[heapType]->StageDescriptors(rootParameterIndex, offset, numDescriptors,
+            m_SourceDescriptorHeaps[heapType]->GetCPUDescriptorHandleForHeapStart());
+    }
+    catch (const std::exception&)
+    {
+        // The descriptor table doesn't match the current root signature (the
+        // root signature was set before the capture started).
+        return false;
+    }
+
+    return true;
+}
+
+void FrameReplayer::CommitStagedDescriptors(uint32_t heapType)
+{
+    m_DynamicDescriptorHeaps[heapType]->CommitStagedDescriptors(m_SetDescriptorHeap, m_SetDescriptorTable);
+}
+
+void FrameReplayer::ResetDynamicDescriptorHeap(uint32_t heapType)
+{
+    m_DynamicDescriptorHeaps[heapType]->Reset();
+}
+
+bool FrameReplayer::RecordCommand(const uint64_t* arguments, uint32_t numArguments)
+{
+    NullDevice::Command command = {};
+    // The query commands are not captured (their arguments are host pointers).
+    if (arguments[0] >= static_cast<uint64_t>(NullDevice::CommandType::EndQuery) ||
+        numArguments - 1 > sizeof(command.Arguments) / sizeof(command.Arguments[0]))
+    {
+        return false;
+    }
+
+    command.Type = static_cast<NullDevice::CommandType>(arguments[0]);
+    std::copy(arguments + 1, arguments + numArguments, command.Arguments);
+    m_CommandList->Record(command);
+
+    return true;
+}
+
+void FrameReplayer::ExecuteCommandList()
+{
+    m_CommandQueue->ExecuteCommandList(*m_CommandList);
+    m_CommandList->Reset();
+
+    // Retire the completed fence values.
+    m_CommandQueue->GetFence()->GetCompletedValue();
+}
@@ -0,0 +1,270 @@
+#include <FrameStats.h>
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <fstream>
+
+namespace
+{
+    uint32_t GetMostSignificantBit(uint64_t value)
+    {
+        uint32_t bit = 0;
+        while (value >>= 1)
+        {
+            ++bit;
+        }
+        return bit;
+    }
+
+    // The nearest-rank percentile of sorted times.
+    double GetSortedPercentile(const std::vector<double>& sortedTimes, double percentile)
+    {
+        size_t rank = static_cast<size_t>(std::ceil(percentile / 100.0 * sortedTimes.size()));
+        return sortedTimes[std::clamp<size_t>(rank, 1, sortedTimes.size()) - 1];
+    }
+}
+
+FrameStats::FrameStats()
+    : FrameStats(Settings())
+{}
+
+FrameStats::FrameStats(const Settings& settings)
+    : m_Settings(settings)
+    , m_Buckets(NumBuckets)
+{
+    m_Settings.NumRecentSamples = std::max(1u, m_Settings.NumRecentSamples);
+    m_RecentSamples.resize(m_Settings.NumRecentSamples);
+
+    Reset();
+}
+
+const FrameStats::Settings& FrameStats::GetSettings() const
+{
+    return m_Settings;
+}
+
+void FrameStats::AddSample(double time)
+{
+    time = std::max(0.0, time);
+
+    // Compare to the average of the rolling window before the sample is added,
+    // so a hitch does not raise its own threshold.
+    bool hitch = m_NumRecentSamples > 0 &&
+        time > m_Settings.HitchFactor * m_RecentTotalTime / m_NumRecentSamples;
+
+    uint64_t microseconds = static_cast<uint64_t>(std::min(time * 1e6 + 0.5, static_cast<double>(1ull << MaxTimeBits)));
+    m_Buckets[GetBucketIndex(microseconds)]++;
+
+    m_MinTime = m_NumSamples > 0 ? std::min(m_MinTime, time) : time;
+    m_MaxTime = std::max(m_MaxTime, time);
+    m_TotalTime += time;
+    m_NumSamples++;
+    m_NumHitches += hitch ? 1 : 0;
+
+    Sample& sample = m_RecentSamples[m_NextRecentSample];
+    if (m_NumRecentSamples == m_RecentSamples.size())
+    {
+        // Replace the oldest sample.
+        m_RecentTotalTime -= sample.Time;
+    }
+    else
+    {
+        m_NumRecentSamples++;
+    }
+    sample = { time, hitch };
+    m_RecentTotalTime += time;
+
+    m_NextRecentSample = (m_NextRecentSample + 1) % m_RecentSamples.size();
+}
+
+void FrameStats::Reset()
+{
+    std::fill(m_Buckets.begin(), m_Buckets.end(), 0);
+    m_NumSamples = 0;
+    m_MinTime = 0.0;
+    m_MaxTime = 0.0;
+    m_TotalTime = 0.0;
+    m_NumHitches = 0;
+
+    m_NextRecentSample = 0;
+    m_NumRecentSamples = 0;
+    m_RecentTotalTime = 0.0;
+}
+
+FrameStats::Summary FrameStats::GetSummary() const
+{
+    Summary summary;
+    if (m_NumSamples == 0)
+    {
+        return summary;
+    }
+
+    summary.NumSamples = m_NumSamples;
+    summary.MinTime = m_MinTime;
+    summary.MaxTime = m_MaxTime;
+    summary.AverageTime = m_TotalTime / m_NumSamples;
+    summary.P50 = GetPercentile(50.0);
+    summary.P95 = GetPercentile(95.0);
+    summary.P99 = GetPercentile(99.0);
+    return summary;
+}
+
+FrameStats::Summary FrameStats::GetRecentSummary() const
+{
+    Summary summary;
+    if (m_NumRecentSamples == 0)
+    {
+        return summary;
+    }
+
+    std::vector<double> times;
+    times.reserve(m_NumRecentSamples);
+    for (uint32_t i = 0; i < m_NumRecentSamples; ++i)
+    {
+        times.push_back(GetRecentSample(i));
+    }
+    std::sort(times.begin(), times.end());
+
+    summary.NumSamples = m_NumRecentSamples;
+    summary.MinTime = times.front();
+    summary.MaxTime = times.back();
+    summary.AverageTime = m_RecentTotalTime / m_NumRecentSamples;
+    summary.P50 = GetSortedPercentile(times, 50.0);
+    summary.P95 = GetSortedPercentile(times, 95.0);
+    summary.P99 = GetSortedPercentile(times, 99.0);
+    return summary;
+}
+
+double FrameStats::GetPercentile(double percentile) const
+{
+    if (m_NumSamples == 0)
+    {
+        return 0.0;
+    }
+
+    uint64_t rank = static_cast<uint64_t>(std::ceil(std::clamp(percentile, 0.0, 100.0) / 100.0 * m_NumSamples));
+    rank = std::max<uint64_t>(rank, 1);
+    if (rank == m_NumSamples)
+    {
+        // The slowest frame is known exactly (also if it is beyond the range of the histogram).
+        return m_MaxTime;
+    }
+
+    uint64_t count = 0;
+    for (uint32_t i = 0; i < NumBuckets; ++i)
+    {
+        count += m_Buckets[i];
+        if (count >= rank)
+        {
+            // The middle of the bucket (limited to the range of the samples).
+            double lower = GetBucketLowerBound(i) * 1e-6;
+            double upper = GetBucketUpperBound(i) * 1e-6;
+            return std::clamp(0.5 * (lower + upper), m_MinTime, m_MaxTime);
+        }
+    }
+
+    return m_MaxTime;
+}
+
+uint64_t FrameStats::GetNumHitches() const
+{
+    return m_NumHitches;
+}
+
+uint32_t FrameStats::GetNumRecentSamples() const
+{
+    return m_NumRecentSamples;
+}
+
+double FrameStats::GetRecentSample(uint32_t framesAgo) const
+{
+    assert(framesAgo < m_NumRecentSamples);
+
+    uint32_t size = static_cast<uint32_t>(m_RecentSamples.size());
+    return m_RecentSamples[(m_NextRecentSample + size - 1 - framesAgo) % size].Time;
+}
+
+bool FrameStats::WriteSamplesCSV(const std::string& fileName) const
+{
+    std::ofstream file(fileName);
+    if (!file)
+    {
+        return false;
+    }
+
+    file << "sample,time_ms,hitch\n";
+
+    uint32_t size = static_cast<uint32_t>(m_RecentSamples.size());
+    uint64_t firstSample = m_NumSamples - m_NumRecentSamples;
+    for (uint32_t i = 0; i < m_NumRecentSamples; ++i)
+    {
+        const Sample& sample = m_RecentSamples[(m_NextRecentSample + size - m_NumRecentSamples + i) % size];
+        file << firstSample + i << "," << sample.Time * 1e3 << "," << (sample.Hitch ? 1 : 0) << "\n";
+    }
+
+    return static_cast<bool>(file);
+}
+
+bool FrameStats::WriteHistogramCSV(const std::string& fileName) const
+{
+    std::ofstream file(fileName);
+    if (!file)
+    {
+        return false;
+    }
+
+    file << "lower_ms,upper_ms,count,cumulative_percent\n";
+
+    uint64_t count = 0;
+    for (uint32_t i = 0; i < NumBuckets; ++i)
+    {
+        if (m_Buckets[i] == 0)
+        {
+            continue;
+        }
+
+        count += m_Buckets[i];
+        file << GetBucketLowerBound(i) * 1e-3 << "," << GetBucketUpperBound(i) * 1e-3 << "," << m_Buckets[i] << ","
+            << 100.0 * count / m_NumSamples << "\n";
+    }
+
+    return static_cast<bool>(file);
+}
+
+uint32_t FrameStats::GetBucketIndex(uint64_t microseconds)
+{
+    // Times that are too long are counted in the last bucket.
+    microseconds = std::min<uint64_t>(microseconds, (1ull << MaxTimeBits) - 1);
+
+    // Below SubBucketCount, the buckets are one microsecond wide. Above, each
+    // power of two is split into SubBucketCount / 2 buckets (the mantissa of
+    // the time is in [SubBucketCount / 2, SubBucketCount) after the shift).
+    if (microseconds < SubBucketCount)
+    {
+        return static_cast<uint32_t>(microseconds);
+    }
+
+    uint32_t shift = GetMostSignificantBit(microseconds) - SubBucketBits + 1;
+    uint32_t mantissa = static_cast<uint32_t>(microseconds >> shift);
+    return shift * (SubBucketCount / 2) + mantissa;
+}
+
+uint64_t FrameStats::GetBucketLowerBound(uint32_t bucketIndex)
+{
+    if (bucketIndex < SubBucketCount)
+    {
+        return bucketIndex;
+    }
+
+    uint32_t shift = bucketIndex / (SubBucketCount / 2) - 1;
+    uint64_t mantissa = bucketIndex - shift * (SubBucketCount / 2);
+    return mantissa << shift;
+}
+
+// Exclusive.
+uint64_t FrameStats::GetBucketUpperBound(uint32_t bucketIndex)
+{
+    uint32_t shift = bucketIndex < SubBucketCount ? 0 : bucketIndex / (SubBucketCount / 2) - 1;
+    return GetBucketLowerBound(bucketIndex) + (1ull << shift);
+}
@@ -0,0 +1,116 @@
+#include <DX12LibPCH.h>
+
+#include <GpuProfiler.h>
+
+#include <Application.h>
+#include <CommandList.h>
+#include <CommandQueue.h>
+#include <D3D12Device.h>
+
+GpuProfiler::GpuProfiler(Microsoft::WRL::ComPtr<ID3D12Device2> device, std::shared_ptr<CommandQueue> commandQueue,
+    const TimestampQueryRing::Settings& settings)
+    : m_CommandQueue(commandQueue)
+    , m_Timestamps(nullptr)
+    , m_TimestampFrequency(1)
+    , m_QueryRing(settings)
+{
+    UINT numQueries = m_QueryRing.GetNumQueries();
+
+    D3D12_QUERY_HEAP_DESC queryHeapDesc = {};
+    queryHeapDesc.Type = D3D12_QUERY_HEAP_TYPE_TIMESTAMP;
+    queryHeapDesc.Count = numQueries;
+    ThrowIfFailed(device->CreateQueryHeap(&queryHeapDesc, IID_PPV_ARGS(&m_d3d12QueryHeap)));
+
+    // Buffers in a readback heap must be created in the copy destination state.
+    ThrowIfFailed(device->CreateCommittedResource(
+        &CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_READBACK),
+        D3D12_HEAP_FLAG_NONE,
+        &CD3DX12_RESOURCE_DESC::Buffer(numQueries * sizeof(uint64_t)),
+        D3D12_RESOURCE_STATE_COPY_DEST,
+        nullptr,
+        IID_PPV_ARGS(&m_d3d12ReadbackBuffer)));
+
+    // The buffer stays mapped. The regions of the frames in flight are never read.
+    void* timestamps = nullptr;
+    ThrowIfFailed(m_d3d12ReadbackBuffer->Map(0, nullptr, &timestamps));
+    m_Timestamps = static_cast<const uint64_t*>(timestamps);
+
+    D3D12Device::CommandQueue& d3d12CommandQueue = static_cast<D3D12Device::CommandQueue&>(*m_CommandQueue->GetDeviceCommandQueue());
+    ThrowIfFailed(d3d12CommandQueue.GetD3D12CommandQueue()->GetTimestampFrequency(&m_TimestampFrequency));
+}
+
+GpuProfiler::~GpuProfiler()
+{
+    D3D12_RANGE writtenRange = {};
+    m_d3d12ReadbackBuffer->Unmap(0, &writtenRange);
+}
+
+void GpuProfiler::BeginFrame()
+{
+    m_QueryRing.Resolve(m_CommandQueue->GetCompletedFenceValue(), m_Timestamps, m_TimestampFrequency);
+    m_QueryRing.BeginFrame();
+}
+
+void GpuProfiler::BeginScope(CommandList& commandList, const std::string& name)
+{
+    ASSERT(commandList.GetCommandListType() == D3D12_COMMAND_LIST_TYPE_DIRECT);
+
+    uint32_t query = m_QueryRing.BeginScope(name);
+    if (query != TimestampQueryRing::InvalidQuery)
+    {
+        commandList.EndQuery(m_d3d12QueryHeap.Get(), D3D12_QUERY_TYPE_TIMESTAMP, query);
+    }
+}
+
+void GpuProfiler::EndScope(CommandList& commandList)
+{
+    uint32_t query = m_QueryRing.EndScope();
+    if (query != TimestampQueryRing::InvalidQuery)
+    {
+        commandList.EndQuery(m_d3d12QueryHeap.Get(), D3D12_QUERY_TYPE_TIMESTAMP, query);
+    }
+}
+
+void GpuProfiler::EndFrame()
+{
+    uint32_t firstQuery;
+    uint32_t numQueries;
+    m_QueryRing.EndFrame(firstQuery, numQueries);
+
+    if (numQueries > 0)
+    {
+        // The command lists of the frame have been executed, so the resolve
+        // runs after the last query of the frame.
+        auto commandList = m_CommandQueue->GetCommandList();
+        commandList->ResolveQueryData(m_d3d12QueryHeap.Get(), D3D12_QUERY_TYPE_TIMESTAMP, firstQuery, numQueries,
+            m_d3d12ReadbackBuffer.Get(), firstQuery * sizeof(uint64_t));
+
+        m_QueryRing.Submit(m_CommandQueue->ExecuteCommandList(commandList));
+    }
+}
+
+const std::vector<TimestampQueryRing::ScopeTiming>& GpuProfiler::GetTimings() const
+{
+    return m_QueryRing.GetTimings();
+}
+
+std::string GpuProfiler::GetTimingsTable() const
+{
+    return m_QueryRing.GetTimingsTable();
+}
+
+const TimestampQueryRing& GpuProfiler::GetQueryRing() const
+{
+    return m_QueryRing;
+}
+
+GpuProfileScope::GpuProfileScope(CommandList& commandList, const std::string& name)
+    : m_CommandList(commandList)
+{
+    Application::Get().GetGpuProfiler().BeginScope(m_CommandList, name);
+}
+
+GpuProfileScope::~GpuProfileScope()
+{
+    Application::Get().GetGpuProfiler().EndScope(m_CommandList);
+}
@@ -0,0 +1,135 @@
+#include <HeadlessPlatform.h>
+
+#include <FastClock.h>
+
+#include <algorithm>
+#include <memory>
+#include <random>
+
+HeadlessPlatform::HeadlessPlatform()
+    : HeadlessPlatform(Settings())
+{}
+
+HeadlessPlatform::HeadlessPlatform(const Settings& settings)
+    : m_Settings(settings)
+    , m_FrameCount(0)
+    , m_StartTime(FastClock::GetSeconds())
+    , m_Quit(false)
+    , m_ExitCode(0)
+{
+    m_Settings.FrameTime = std::max(0.0, m_Settings.FrameTime);
+}
+
+int HeadlessPlatform::Run()
+{
+    m_Quit = false;
+    while (!m_Quit && (m_Settings.MaxFrames == 0 || m_FrameCount < m_Settings.MaxFrames))
+    {
+        m_Events.clear();
+        if (m_InputGenerator)
+        {
+            m_InputGenerator(m_FrameCount, m_Events);
+        }
+
+        // Windows can be removed while the frame is running.
+        std::vector<PlatformWindow*> windows = m_Windows;
+        for (PlatformWindow* window : windows)
+        {
+            for (const InputQueue::Event& event : m_Events)
+            {
+                window->QueueInputEvent(event);
+            }
+            window->Frame();
+        }
+
+        ++m_FrameCount;
+    }
+
+    return m_ExitCode;
+}
+
+void HeadlessPlatform::Quit(int exitCode)
+{
+    m_Quit = true;
+    m_ExitCode = exitCode;
+}
+
+double HeadlessPlatform::GetTime() const
+{
+    if (m_Settings.FrameTime > 0.0)
+    {
+        return m_FrameCount * m_Settings.FrameTime;
+    }
+    return FastClock::GetSeconds() - m_StartTime;
+}
+
+void HeadlessPlatform::AddWindow(PlatformWindow* window)
+{
+    m_Windows.push_back(window);
+}
+
+void HeadlessPlatform::RemoveWindow(PlatformWindow* window)
+{
+    m_Windows.erase(std::remove(m_Windows.begin(), m_Windows.end(), window), m_Windows.end());
+}
+
+void HeadlessPlatform::SetInputGenerator(InputGenerator inputGenerator)
+{
+    m_InputGenerator = std::move(inputGenerator);
+}
+
+HeadlessPlatform::InputGenerator HeadlessPlatform::CreateRandomInput(uint32_t seed, int clientWidth, int clientHeight)
+{
+    struct State
+    {
+        std::mt19937 Random;
+        int X;
+        int Y;
+        bool LeftButton;
+    };
+
+    auto state = std::make_shared<State>(State{ std::mt19937(seed), clientWidth / 2, clientHeight / 2, false });
+
+    return [state, clientWidth, clientHeight](uint64_t, std::vector<InputQueue::Event>& events)
+    {
+        std::mt19937& random = state->Random;
+        std::uniform_int_distribution<int> motion(-8, 8);
+        std::uniform_int_distribution<int> percent(0, 99);
+
+        // A few mouse motion events per frame (like a real mouse at a high polling rate).
+        int numMotionEvents = percent(random) % 4;
+        for (int i = 0; i < numMotionEvents; ++i)
+        {
+            state->X = std::clamp(state->X + motion(random), 0, clientWidth - 1);
+            state->Y = std::clamp(state->Y + motion(random), 0, clientHeight - 1);
+            events.push_back(MouseMotionEventArgs(state->LeftButton, false, false, false, false, state->X, state->Y));
+        }
+
+        if (percent(random) < 5)
+        {
+            state->LeftButton = !state->LeftButton;
+            events.push_back(MouseButtonEventArgs(MouseButtonEventArgs::Left,
+                state->LeftButton ? MouseButtonEventArgs::Pressed : MouseButtonEventArgs::Released,
+                state->LeftButton, false, false, false, false, state->X, state->Y));
+        }
+
+        if (percent(random) < 5)
+        {
+            // Press and release a letter key.
+            KeyCode::Key key = static_cast<KeyCode::Key>(KeyCode::A + percent(random) % 26);
+            unsigned int c = 'a' + (key - KeyCode::A);
+            events.push_back(KeyEventArgs(key, c, KeyEventArgs::Pressed, false, false, false));
+            events.push_back(KeyEventArgs(key, c, KeyEventArgs::Released, false, false, false));
+        }
+
+        if (percent(random) < 2)
+        {
+            events.push_back(MouseWheelEventArgs(percent(random) < 50 ? 1.0f : -1.0f, state->LeftButton, false, false, false, false, state->X, state->Y));
+        }
+    };
+}
+
+uint64_t HeadlessPlatform::GetFrameCount() const
+{
+    return m_FrameCount;
+}
@@ -0,0 +1,98 @@
+#include <DX12LibPCH.h>
+
+#include <HeapAllocation.h>
+
+#include <Application.h>
+#include <HeapAllocatorPage.h>
+
+HeapAllocation::HeapAllocation()
+    : m_Resource( nullptr )
+    , m_Offset( 0 )
+    , m_Size( 0 )
+    , m_Page( nullptr )
+{}
+
+HeapAllocation::HeapAllocation(
+    Microsoft::WRL::ComPtr<ID3D12Resource> resource,
+    uint64_t offset, uint64_t sizeInBytes,
+    std::shared_ptr<HeapAllocatorPage> page )
+    : m_Resource( resource )
+    , m_Offset( offset )
+    , m_Size( sizeInBytes )
+    , m_Page( page )
+{}
+
+HeapAllocation::~HeapAllocation()
+{
+    Free();
+}
+
+HeapAllocation::HeapAllocation( HeapAllocation&& allocation )
+    : m_Resource( std::move( allocation.m_Resource ) )
+    , m_Offset( allocation.m_Offset )
+    , m_Size( allocation.m_Size )
+    , m_Page( std::move( allocation.m_Page ) )
+{
+    allocation.m_Offset = 0;
+    allocation.m_Size = 0;
+}
+
+HeapAllocation& HeapAllocation::operator=( HeapAllocation&& other )
+{
+    // Free this allocation if it points to anything.
+    Free();
+
+    m_Resource = std::move( other.m_Resource );
+    m_Offset = other.m_Offset;
+    m_Size = other.m_Size;
+    m_Page = std::move( other.m_Page );
+
+    other.m_Offset = 0;
+    other.m_Size = 0;
+
+    return *this;
+}
+
+void HeapAllocation::Free()
+{
+    if ( !IsNull() && m_Page )
+    {
+        // The page takes ownership of the resource until the frame has completed.
+        std::shared_ptr<HeapAllocatorPage> page = std::move( m_Page );
+        page->Free( std::move( *this ), Application::GetFrameCount() );
+
+        m_Resource.Reset();
+        m_Offset = 0;
+        m_Size = 0;
+    }
+}
+
+bool HeapAllocation::IsNull() const
+{
+    return m_Resource == nullptr;
+}
+
+Microsoft::WRL::ComPtr<ID3D12Resource> HeapAllocation::GetResource() const
+{
+    return m_Resource;
+}
+
+uint64_t HeapAllocation::GetOffset() const
+{
+    return m_Offset;
+}
+
+uint64_t HeapAllocation::GetSize() const
+{
+    return m_Size;
+}
+
+D3D12_GPU_VIRTUAL_ADDRESS HeapAllocation::GetGPUVirtualAddress() const
+{
+    return m_Resource ? m_Resource->GetGPUVirtualAddress() : D3D12_GPU_VIRTUAL_ADDRESS( 0 );
+}
+
+std::shared_ptr<HeapAllocatorPage> HeapAllocation::GetHeapAllocatorPage() const
+{
+    return m_Page;
+}
@@ -0,0 +1,155 @@
+#include <DX12LibPCH.h>
+
+#include <HeapAllocator.h>
+
+#include <Application.h>
+#include <HeapAllocatorPage.h>
+#include <Profiler.h>
+
+HeapAllocator::HeapAllocator( D3D12_HEAP_TYPE heapType, D3D12_HEAP_FLAGS heapFlags, uint64_t heapSize )
+    : m_HeapType( heapType )
+    , m_HeapFlags( heapFlags )
+    , m_HeapSize( Math::NextHighestPow2( heapSize ) )
+    , m_FragmentationThreshold( 1.0f )
+{}
+
+HeapAllocator::~HeapAllocator() {}
+
+HeapAllocation HeapAllocator::CreateResource(
+    const D3D12_RESOURCE_DESC& resourceDesc,
+    D3D12_RESOURCE_STATES initialState,
+    const D3D12_CLEAR_VALUE* clearValue )
+{
+    PROFILE_FUNCTION();
+
+    Microsoft::WRL::ComPtr<ID3D12Device2> device = Application::Get().GetDevice();
+
+    // Query the size and placement alignment of the resource.
+    D3D12_RESOURCE_ALLOCATION_INFO allocationInfo = device->GetResourceAllocationInfo( 0, 1, &resourceDesc );
+
+    AlignmentClass alignmentClass = allocationInfo.Alignment > D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT ? MSAA : Default;
+
+    std::lock_guard<std::mutex> lock( m_AllocationMutex );
+
+    HeapAllocation allocation;
+
+    for ( std::shared_ptr<HeapAllocatorPage>& page : m_HeapPool[alignmentClass] )
+    {
+        if ( page->HasSpace( allocationInfo.SizeInBytes, allocationInfo.Alignment ) )
+        {
+            allocation = page->Allocate( resourceDesc, allocationInfo, initialState, clearValue );
+
+            // A valid allocation has been found.
+            if ( !allocation.IsNull() )
+            {
+                break;
+            }
+        }
+    }
+
+    // No available heap could satisfy the request.
+    if ( allocation.IsNull() )
+    {
+        // Resources that are larger than the default heap size get a dedicated heap.
+        uint64_t heapSize = std::max( m_HeapSize, Math::NextHighestPow2( allocationInfo.SizeInBytes ) );
+        std::shared_ptr<HeapAllocatorPage> newPage = CreateAllocatorPage( alignmentClass, heapSize );
+
+        allocation = newPage->Allocate( resourceDesc, allocationInfo, initialState, clearValue );
+    }
+
+    return allocation;
+}
+
+std::shared_ptr<HeapAllocatorPage> HeapAllocator::CreateAllocatorPage( AlignmentClass alignmentClass, uint64_t heapSize )
+{
+    uint64_t alignment = alignmentClass == MSAA ?
+        D3D12_DEFAULT_MSAA_RESOURCE_PLACEMENT_ALIGNMENT : D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT;
+
+    std::shared_ptr<HeapAllocatorPage> newPage =
+        std::make_shared<HeapAllocatorPage>( m_HeapType, m_HeapFlags, std::max( heapSize, alignment ), alignment );
+
+    m_HeapPool[alignmentClass].emplace_back( newPage );
+
+    return newPage;
+}
+
+void HeapAllocator::ReleaseStaleAllocations( uint64_t frameNumber )
+{
+    std::lock_guard<std::mutex> lock( m_AllocationMutex );
+
+    for ( HeapPool& heapPool : m_HeapPool )
+    {
+        for ( std::shared_ptr<HeapAllocatorPage>& page : heapPool )
+        {
+            page->ReleaseStaleAllocations( frameNumber );
+        }
+    }
+}
+
+void HeapAllocator::SetDefragmentationCallback( float fragmentationThreshold, DefragmentationCallback callback )
+{
+    std::lock_guard<std::mutex> lock( m_AllocationMutex );
+
+    m_FragmentationThreshold = fragmentationThreshold;
+    m_DefragmentationCallback = callback;
+}
+
+void HeapAllocator::Defragment()
+{
+    std::vector< std::shared_ptr<HeapAllocatorPage> > fragmentedPages;
+    DefragmentationCallback callback;
+    {
+        std::lock_guard<std::mutex> lock( m_AllocationMutex );
+
+        for ( HeapPool& heapPool : m_HeapPool )
+        {
+            // Release empty heaps. The first heap of each alignment class is kept
+            // to avoid recreating it on the next allocation.
+            for ( auto iter = heapPool.begin(); iter != heapPool.end(); )
+            {
+                if ( iter != heapPool.begin() && (*iter)->IsEmpty() )
+                {
+                    iter = heapPool.erase( iter );
+                }
+                else
+                {
+                    if ( (*iter)->GetFragmentation() > m_FragmentationThreshold )
+                    {
+                        fragmentedPages.push_back( *iter );
+                    }
+                    ++iter;
+                }
+            }
+        }
+
+        callback = m_DefragmentationCallback;
+    }
+
+    // The callback is invoked without holding the lock since it will most likely
+    // recreate resources using this allocator.
+    if ( callback )
+    {
+        for ( std::shared_ptr<HeapAllocatorPage>& page : fragmentedPages )
+        {
+            callback( *page );
+        }
+    }
+}
+
+HeapAllocator::Statistics HeapAllocator::GetStatistics() const
+{
+    std::lock_guard<std::mutex> lock( m_AllocationMutex );
+
+    Statistics statistics = {};
+    for ( const HeapPool& heapPool : m_HeapPool )
+    {
+        for ( const std::shared_ptr<HeapAllocatorPage>& page : heapPool )
+        {
+            statistics.NumHeaps++;
+            statistics.NumAllocations += page->GetNumAllocations();
+            statistics.TotalSize += page->GetSize();
+            statistics.AllocatedSize += page->GetSize() - page->GetFreeSize();
+        }
+    }
+    return statistics;
+}
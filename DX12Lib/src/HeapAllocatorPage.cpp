@@ -0,0 +1,138 @@
+#include <DX12LibPCH.h>
+
+#include <HeapAllocatorPage.h>
+
+#include <Application.h>
+#include <ResourceStateTracker.h>
+
+// The number of subresources of a resource. Planar formats are not supported.
+static UINT GetNumSubresources( const D3D12_RESOURCE_DESC& resourceDesc )
+{
+    if ( resourceDesc.Dimension == D3D12_RESOURCE_DIMENSION_BUFFER )
+    {
+        return 1;
+    }
+
+    UINT arraySize = resourceDesc.Dimension == D3D12_RESOURCE_DIMENSION_TEXTURE3D ? 1 : resourceDesc.DepthOrArraySize;
+    return resourceDesc.MipLevels * arraySize;
+}
+
+HeapAllocatorPage::HeapAllocatorPage( D3D12_HEAP_TYPE heapType, D3D12_HEAP_FLAGS heapFlags, uint64_t sizeInBytes, uint64_t alignment )
+    : m_HeapType( heapType )
+    , m_Alignment( alignment )
+    , m_Allocator( sizeInBytes, D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT )
+{
+    Microsoft::WRL::ComPtr<ID3D12Device2> device = Application::Get().GetDevice();
+
+    CD3DX12_HEAP_DESC heapDesc( sizeInBytes, heapType, alignment, heapFlags );
+    ThrowIfFailed( device->CreateHeap( &heapDesc, IID_PPV_ARGS( &m_d3d12Heap ) ) );
+}
+
+bool HeapAllocatorPage::HasSpace( uint64_t sizeInBytes, uint64_t alignment ) const
+{
+    std::lock_guard<std::mutex> lock( m_AllocationMutex );
+    return m_Allocator.HasSpace( sizeInBytes, alignment );
+}
+
+HeapAllocation HeapAllocatorPage::Allocate(
+    const D3D12_RESOURCE_DESC& resourceDesc,
+    const D3D12_RESOURCE_ALLOCATION_INFO& allocationInfo,
+    D3D12_RESOURCE_STATES initialState,
+    const D3D12_CLEAR_VALUE* clearValue )
+{
+    uint64_t offset;
+    {
+        std::lock_guard<std::mutex> lock( m_AllocationMutex );
+        offset = m_Allocator.Allocate( allocationInfo.SizeInBytes, allocationInfo.Alignment );
+    }
+
+    if ( offset == BuddyAllocator::InvalidOffset )
+    {
+        // There was no free block that could satisfy the request.
+        return HeapAllocation();
+    }
+
+    Microsoft::WRL::ComPtr<ID3D12Device2> device = Application::Get().GetDevice();
+    Microsoft::WRL::ComPtr<ID3D12Resource> resource;
+
+    HRESULT hr = device->CreatePlacedResource( m_d3d12Heap.Get(), offset, &resourceDesc,
+        initialState, clearValue, IID_PPV_ARGS( &resource ) );
+
+    if ( FAILED( hr ) )
+    {
+        std::lock_guard<std::mutex> lock( m_AllocationMutex );
+        m_Allocator.Free( offset );
+        ThrowIfFailed( hr );
+    }
+
+    // The resource can be transitioned on a command list from now on.
+    ResourceStateTracker::AddGlobalResourceState( resource.Get(), initialState, GetNumSubresources( resourceDesc ) );
+
+    return HeapAllocation( resource, offset, m_Allocator.GetBlockSize( allocationInfo.SizeInBytes, allocationInfo.Alignment ),
+        shared_from_this() );
+}
+
+void HeapAllocatorPage::Free( HeapAllocation&& allocation, uint64_t frameNumber )
+{
+    std::lock_guard<std::mutex> lock( m_AllocationMutex );
+
+    // Don't return the block to the heap until the frame has completed.
+    m_StaleAllocations.emplace( std::move( allocation.m_Resource ), allocation.m_Offset, frameNumber );
+}
+
+void HeapAllocatorPage::ReleaseStaleAllocations( uint64_t frameNumber )
+{
+    std::lock_guard<std::mutex> lock( m_AllocationMutex );
+
+    while ( !m_StaleAllocations.empty() && m_StaleAllocations.front().FrameNumber <= frameNumber )
+    {
+        ResourceStateTracker::RemoveGlobalResourceState( m_StaleAllocations.front().Resource.Get() );
+        m_Allocator.Free( m_StaleAllocations.front().Offset );
+        m_StaleAllocations.pop();
+    }
+}
+
+Microsoft::WRL::ComPtr<ID3D12Heap> HeapAllocatorPage::GetHeap() const
+{
+    return m_d3d12Heap;
+}
+
+uint64_t HeapAllocatorPage::GetAlignment() const
+{
+    return m_Alignment;
+}
+
+uint64_t HeapAllocatorPage::GetSize() const
+{
+    return m_Allocator.GetSize();
+}
+
+uint64_t HeapAllocatorPage::GetFreeSize() const
+{
+    std::lock_guard<std::mutex> lock( m_AllocationMutex );
+    return m_Allocator.GetFreeSize();
+}
+
+uint64_t HeapAllocatorPage::GetLargestFreeBlockSize() const
+{
+    std::lock_guard<std::mutex> lock( m_AllocationMutex );
+    return m_Allocator.GetLargestFreeBlockSize();
+}
+
+uint32_t HeapAllocatorPage::GetNumAllocations() const
+{
+    std::lock_guard<std::mutex> lock( m_AllocationMutex );
+    return m_Allocator.GetNumAllocations();
+}
+
+bool HeapAllocatorPage::IsEmpty() const
+{
+    std::lock_guard<std::mutex> lock( m_AllocationMutex );
+    return m_Allocator.IsEmpty();
+}
+
+float HeapAllocatorPage::GetFragmentation() const
+{
+    std::lock_guard<std::mutex> lock( m_AllocationMutex );
+    return m_Allocator.GetFragmentation();
+}
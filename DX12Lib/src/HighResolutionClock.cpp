@@ -1,16 +1,17 @@
 #include <HighResolutionClock.h>
-#include <DX12LibPCH.h>
+
+#include <FastClock.h>
 
 HighResolutionClock::HighResolutionClock()
     : m_DeltaTime(0),
       m_TotalTime(0)
 {
-    m_T0 = std::chrono::high_resolution_clock::now();
+    m_T0 = FastClock::Now();
 }
 
 void HighResolutionClock::Tick() 
 {
-    auto t1 = std::chrono::high_resolution_clock::now();
+    uint64_t t1 = FastClock::Now();
     m_DeltaTime = t1 - m_T0;
     m_TotalTime += m_DeltaTime;
     m_T0 = t1;
@@ -18,46 +19,46 @@ void HighResolutionClock::Tick()
 
 void HighResolutionClock::Reset()
 {
-    m_T0 = std::chrono::high_resolution_clock::now();
-    m_DeltaTime = std::chrono::high_resolution_clock::duration();
-    m_TotalTime = std::chrono::high_resolution_clock::duration();
+    m_T0 = FastClock::Now();
+    m_DeltaTime = 0;
+    m_TotalTime = 0;
 }
 
 double HighResolutionClock::GetDeltaNanoseconds() const
 {
-    return m_DeltaTime.count() * 1.0;
+    return FastClock::ToSeconds(m_DeltaTime) * 1e9;
 }
 double HighResolutionClock::GetDeltaMicroseconds() const
 {
-    return m_DeltaTime.count() * 1e-3;
+    return FastClock::ToSeconds(m_DeltaTime) * 1e6;
 }
 
 double HighResolutionClock::GetDeltaMilliseconds() const
 {
-    return m_DeltaTime.count() * 1e-6;
+    return FastClock::ToSeconds(m_DeltaTime) * 1e3;
 }
 
 double HighResolutionClock::GetDeltaSeconds() const
 {
-    return m_DeltaTime.count() * 1e-9;
+    return FastClock::ToSeconds(m_DeltaTime);
 }
 
 double HighResolutionClock::GetTotalNanoseconds() const
 {
-    return m_TotalTime.count() * 1.0;
+    return FastClock::ToSeconds(m_TotalTime) * 1e9;
 }
 
 double HighResolutionClock::GetTotalMicroseconds() const
 {
-    return m_TotalTime.count() * 1e-3;
+    return FastClock::ToSeconds(m_TotalTime) * 1e6;
 }
 
 double HighResolutionClock::GetTotalMilliSeconds() const
 {
-    return m_TotalTime.count() * 1e-6;
+    return FastClock::ToSeconds(m_TotalTime) * 1e3;
 }
 
 double HighResolutionClock::GetTotalSeconds() const
 {
-    return m_TotalTime.count() * 1e-9;
+    return FastClock::ToSeconds(m_TotalTime);
 }
@@ -0,0 +1,72 @@
+#include <InputQueue.h>
+
+InputQueue::InputQueue(size_t capacity)
+    : m_Events(capacity)
+    , m_NumDroppedEvents(0)
+    , m_HasMousePosition(false)
+    , m_MouseX(0)
+    , m_MouseY(0)
+{}
+
+void InputQueue::Push(const Event& event)
+{
+    if (!m_Events.TryPush(event))
+    {
+        m_NumDroppedEvents.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void InputQueue::PopAll(std::vector<Event>& events)
+{
+    // Only motion events that were added in this batch are combined.
+    size_t firstEvent = events.size();
+
+    Event event;
+    while (m_Events.TryPop(event))
+    {
+        if (auto* mouseMotion = std::get_if<MouseMotionEventArgs>(&event))
+        {
+            UpdateMousePosition(mouseMotion->X, mouseMotion->Y, mouseMotion->RelX, mouseMotion->RelY);
+
+            if (events.size() > firstEvent)
+            {
+                if (auto* previous = std::get_if<MouseMotionEventArgs>(&events.back()))
+                {
+                    // Keep the buttons and position of the last event and the motion of both events.
+                    mouseMotion->RelX += previous->RelX;
+                    mouseMotion->RelY += previous->RelY;
+                    *previous = *mouseMotion;
+                    continue;
+                }
+            }
+        }
+        else if (auto* mouseButton = std::get_if<MouseButtonEventArgs>(&event))
+        {
+            int relX, relY;
+            UpdateMousePosition(mouseButton->X, mouseButton->Y, relX, relY);
+        }
+        else if (auto* mouseWheel = std::get_if<MouseWheelEventArgs>(&event))
+        {
+            int relX, relY;
+            UpdateMousePosition(mouseWheel->X, mouseWheel->Y, relX, relY);
+        }
+
+        events.push_back(event);
+    }
+}
+
+uint64_t InputQueue::GetNumDroppedEvents() const
+{
+    return m_NumDroppedEvents.load(std::memory_order_relaxed);
+}
+
+void InputQueue::UpdateMousePosition(int x, int y, int& relX, int& relY)
+{
+    // The first mouse event has no motion.
+    relX = m_HasMousePosition ? x - m_MouseX : 0;
+    relY = m_HasMousePosition ? y - m_MouseY : 0;
+
+    m_HasMousePosition = true;
+    m_MouseX = x;
+    m_MouseY = y;
+}
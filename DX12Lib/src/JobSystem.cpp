@@ -0,0 +1,215 @@
+#include <JobSystem.h>
+
+#include <Profiler.h>
+
+namespace
+{
+    // The job system and worker index of the calling thread.
+    thread_local const JobSystem* tls_JobSystem = nullptr;
+    thread_local uint32_t tls_WorkerIndex = ~0u;
+
+    // Idle workers spin (stealing) for a while before they sleep,
+    // since new jobs usually arrive within the same frame.
+    const uint32_t NumSpinsBeforeSleep = 64;
+}
+
+JobSystem::JobSystem(size_t numWorkers)
+    : m_NumQueuedTasks(0)
+    , m_Stop(false)
+{
+    if (numWorkers == 0)
+    {
+        numWorkers = std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    for (size_t i = 0; i < numWorkers; ++i)
+    {
+        m_Workers.push_back(std::make_unique<Worker>());
+    }
+
+    // The calling thread is worker 0.
+    tls_JobSystem = this;
+    tls_WorkerIndex = 0;
+
+    for (uint32_t i = 1; i < numWorkers; ++i)
+    {
+        m_Workers[i]->Thread = std::thread(&JobSystem::WorkerThread, this, i);
+    }
+}
+
+JobSystem::~JobSystem()
+{
+    // Execute the remaining tasks.
+    while (TryExecuteTask())
+    {}
+
+    {
+        std::lock_guard<std::mutex> lock(m_SleepMutex);
+        m_Stop = true;
+    }
+    m_TaskAvailable.notify_all();
+
+    for (auto& worker : m_Workers)
+    {
+        if (worker->Thread.joinable())
+        {
+            worker->Thread.join();
+        }
+    }
+
+    if (tls_JobSystem == this)
+    {
+        tls_JobSystem = nullptr;
+        tls_WorkerIndex = ~0u;
+    }
+}
+
+uint32_t JobSystem::GetWorkerIndex() const
+{
+    return tls_JobSystem == this ? tls_WorkerIndex : ~0u;
+}
+
+void JobSystem::Run(Job job, JobCounter* counter)
+{
+    if (counter)
+    {
+        counter->m_NumJobs.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    Push(new Task{ std::move(job), counter });
+}
+
+void JobSystem::Push(Task* task)
+{
+    // Count the task before it is published. Otherwise a thief could take the
+    // task (and decrement the counter) before it is counted.
+    m_NumQueuedTasks.fetch_add(1, std::memory_order_seq_cst);
+
+    uint32_t workerIndex = GetWorkerIndex();
+    if (workerIndex != ~0u)
+    {
+        if (!m_Workers[workerIndex]->Deque.Push(task))
+        {
+            // The deque is full.
+            m_NumQueuedTasks.fetch_sub(1, std::memory_order_relaxed);
+            Execute(task);
+            return;
+        }
+    }
+    else
+    {
+        std::lock_guard<std::mutex> lock(m_SharedTasksMutex);
+        m_SharedTasks.push_back(task);
+    }
+
+    // Make sure a sleeping worker does not miss the task (the worker checks
+    // the number of queued tasks while holding the mutex).
+    {
+        std::lock_guard<std::mutex> lock(m_SleepMutex);
+    }
+    m_TaskAvailable.notify_one();
+}
+
+JobSystem::Task* JobSystem::FindTask(uint32_t workerIndex)
+{
+    Task* task = nullptr;
+
+    if (workerIndex != ~0u && m_Workers[workerIndex]->Deque.Pop(task))
+    {
+        return task;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_SharedTasksMutex);
+        if (!m_SharedTasks.empty())
+        {
+            task = m_SharedTasks.front();
+            m_SharedTasks.pop_front();
+            return task;
+        }
+    }
+
+    // Steal from the other workers, starting after the own index so
+    // thieves are spread over the workers.
+    size_t numWorkers = m_Workers.size();
+    size_t start = workerIndex != ~0u ? workerIndex + 1 : 0;
+    for (size_t i = 0; i < numWorkers; ++i)
+    {
+        size_t victim = (start + i) % numWorkers;
+        if (victim != workerIndex && m_Workers[victim]->Deque.Steal(task))
+        {
+            return task;
+        }
+    }
+
+    return nullptr;
+}
+
+void JobSystem::Execute(Task* task)
+{
+    task->Function();
+
+    if (task->Counter)
+    {
+        task->Counter->m_NumJobs.fetch_sub(1, std::memory_order_release);
+    }
+
+    delete task;
+}
+
+bool JobSystem::TryExecuteTask()
+{
+    Task* task = FindTask(GetWorkerIndex());
+    if (!task)
+    {
+        return false;
+    }
+
+    m_NumQueuedTasks.fetch_sub(1, std::memory_order_relaxed);
+    Execute(task);
+
+    return true;
+}
+
+void JobSystem::Wait(const JobCounter& counter)
+{
+    while (!counter.IsDone())
+    {
+        if (!TryExecuteTask())
+        {
+            // The remaining jobs are executing on other workers.
+            std::this_thread::yield();
+        }
+    }
+}
+
+void JobSystem::WorkerThread(uint32_t workerIndex)
+{
+    tls_JobSystem = this;
+    tls_WorkerIndex = workerIndex;
+
+    Profiler::Get().SetThreadName("Job Worker " + std::to_string(workerIndex));
+
+    uint32_t numSpins = 0;
+    while (!m_Stop)
+    {
+        if (TryExecuteTask())
+        {
+            numSpins = 0;
+            continue;
+        }
+
+        if (++numSpins < NumSpinsBeforeSleep)
+        {
+            std::this_thread::yield();
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(m_SleepMutex);
+        m_TaskAvailable.wait(lock, [this]()
+        {
+            return m_Stop || m_NumQueuedTasks.load(std::memory_order_seq_cst) > 0;
+        });
+        numSpins = 0;
+    }
+}
@@ -0,0 +1,73 @@
+#include <DX12LibPCH.h>
+
+#include <MappedFile.h>
+
+MappedFile::MappedFile()
+    : m_hFile(INVALID_HANDLE_VALUE)
+    , m_hMapping(NULL)
+    , m_Data(nullptr)
+    , m_Size(0)
+{}
+
+MappedFile::~MappedFile()
+{
+    Close();
+}
+
+bool MappedFile::Open(const std::wstring& fileName)
+{
+    Close();
+
+    m_hFile = ::CreateFileW(fileName.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+        OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (m_hFile == INVALID_HANDLE_VALUE)
+    {
+        return false;
+    }
+
+    LARGE_INTEGER fileSize;
+    // Empty files can't be mapped.
+    if (!::GetFileSizeEx(m_hFile, &fileSize) || fileSize.QuadPart == 0)
+    {
+        Close();
+        return false;
+    }
+
+    m_hMapping = ::CreateFileMappingW(m_hFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (m_hMapping == NULL)
+    {
+        Close();
+        return false;
+    }
+
+    m_Data = ::MapViewOfFile(m_hMapping, FILE_MAP_READ, 0, 0, 0);
+    if (!m_Data)
+    {
+        Close();
+        return false;
+    }
+
+    m_Size = static_cast<size_t>(fileSize.QuadPart);
+
+    return true;
+}
+
+void MappedFile::Close()
+{
+    if (m_Data)
+    {
+        ::UnmapViewOfFile(m_Data);
+        m_Data = nullptr;
+    }
+    if (m_hMapping != NULL)
+    {
+        ::CloseHandle(m_hMapping);
+        m_hMapping = NULL;
+    }
+    if (m_hFile != INVALID_HANDLE_VALUE)
+    {
+        ::CloseHandle(m_hFile);
+        m_hFile = INVALID_HANDLE_VALUE;
+    }
+    m_Size = 0;
+}
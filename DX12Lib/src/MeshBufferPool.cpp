@@ -0,0 +1,183 @@
+#include <DX12LibPCH.h>
+
+#include <MeshBufferPool.h>
+
+#include <Application.h>
+#include <CommandList.h>
+#include <HeapAllocator.h>
+
+#include <numeric>
+
+D3D12_VERTEX_BUFFER_VIEW MeshBufferPool::Range::GetVertexBufferView() const
+{
+    D3D12_VERTEX_BUFFER_VIEW vertexBufferView = {};
+    vertexBufferView.BufferLocation = GPUAddress;
+    vertexBufferView.SizeInBytes = static_cast<UINT>(SizeInBytes);
+    vertexBufferView.StrideInBytes = Stride;
+    return vertexBufferView;
+}
+
+D3D12_INDEX_BUFFER_VIEW MeshBufferPool::Range::GetIndexBufferView() const
+{
+    D3D12_INDEX_BUFFER_VIEW indexBufferView = {};
+    indexBufferView.BufferLocation = GPUAddress;
+    indexBufferView.SizeInBytes = static_cast<UINT>(SizeInBytes);
+    indexBufferView.Format = Format;
+    return indexBufferView;
+}
+
+MeshBufferPool::Page::Page(uint64_t sizeInBytes)
+    : Allocator(sizeInBytes)
+    , NumRanges(0)
+{
+    Buffer = Application::Get().GetBufferAllocator(D3D12_HEAP_TYPE_DEFAULT)->CreateResource(
+        CD3DX12_RESOURCE_DESC::Buffer(sizeInBytes),
+        D3D12_RESOURCE_STATE_COMMON);
+}
+
+MeshBufferPool::MeshBufferPool(uint64_t pageSize)
+    : m_PageSize(pageSize)
+{}
+
+MeshBufferPool::~MeshBufferPool() {}
+
+MeshBufferPool::Range MeshBufferPool::AllocateVertices(uint32_t numVertices, uint32_t vertexStride)
+{
+    return Allocate(numVertices, vertexStride, DXGI_FORMAT_UNKNOWN);
+}
+
+MeshBufferPool::Range MeshBufferPool::AllocateIndices(uint32_t numIndices, DXGI_FORMAT indexFormat)
+{
+    ASSERT(indexFormat == DXGI_FORMAT_R16_UINT || indexFormat == DXGI_FORMAT_R32_UINT);
+    uint32_t indexSize = indexFormat == DXGI_FORMAT_R16_UINT ? 2 : 4;
+    return Allocate(numIndices, indexSize, indexFormat);
+}
+
+MeshBufferPool::Range MeshBufferPool::Allocate(uint32_t count, uint32_t stride, DXGI_FORMAT format)
+{
+    uint64_t sizeInBytes = static_cast<uint64_t>(count) * stride;
+    // The offset must be a multiple of the stride so the range can be addressed
+    // from the start of the page, and a multiple of 4 bytes for the views.
+    uint64_t alignment = std::lcm<uint64_t>(stride, 4);
+
+    std::lock_guard<std::mutex> lock(m_Mutex);
+
+    uint32_t pageIndex = 0;
+    uint64_t offset = RangeAllocator::InvalidOffset;
+
+    for (; pageIndex < m_Pages.size(); ++pageIndex)
+    {
+        offset = m_Pages[pageIndex]->Allocator.Allocate(sizeInBytes, alignment);
+        if (offset != RangeAllocator::InvalidOffset)
+        {
+            break;
+        }
+    }
+
+    // No page could satisfy the request.
+    if (offset == RangeAllocator::InvalidOffset)
+    {
+        uint64_t pageSize = std::max(m_PageSize, Math::AlignUp(sizeInBytes, _64KB));
+        m_Pages.emplace_back(std::make_unique<Page>(pageSize));
+        pageIndex = static_cast<uint32_t>(m_Pages.size() - 1);
+
+        offset = m_Pages[pageIndex]->Allocator.Allocate(sizeInBytes, alignment);
+    }
+
+    Page& page = *m_Pages[pageIndex];
+    page.NumRanges++;
+
+    Range range;
+    range.Buffer = page.Buffer.GetResource().Get();
+    range.PageIndex = pageIndex;
+    range.Offset = offset;
+    range.SizeInBytes = sizeInBytes;
+    range.Count = count;
+    range.Stride = stride;
+    range.Format = format;
+    range.GPUAddress = page.Buffer.GetGPUVirtualAddress() + offset;
+
+    return range;
+}
+
+void MeshBufferPool::Upload(CommandList& commandList, const Range& range, const void* data)
+{
+    ASSERT(!range.IsNull());
+
+    commandList.CopyBuffer(range.Buffer, range.Offset, static_cast<size_t>(range.SizeInBytes), data);
+
+    // Buffers decay to the COMMON state when the command list has executed. The transition
+    // keeps the tracked state in sync and is merged with the transition to COPY_DEST of
+    // the next upload to the page.
+    commandList.TransitionBarrier(range.Buffer, D3D12_RESOURCE_STATE_COMMON);
+}
+
+void MeshBufferPool::Free(const Range& range)
+{
+    if (range.IsNull())
+    {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(m_Mutex);
+
+    // Don't return the range to the page until the frame has completed.
+    m_StaleRanges.push({ range.PageIndex, range.Offset, range.SizeInBytes, Application::GetFrameCount() });
+}
+
+void MeshBufferPool::ReleaseStaleRanges(uint64_t frameNumber)
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+
+    while (!m_StaleRanges.empty() && m_StaleRanges.front().FrameNumber <= frameNumber)
+    {
+        const StaleRangeInfo& staleRange = m_StaleRanges.front();
+
+        Page& page = *m_Pages[staleRange.PageIndex];
+        page.Allocator.Free(staleRange.Offset, staleRange.SizeInBytes);
+        page.NumRanges--;
+
+        m_StaleRanges.pop();
+    }
+}
+
+D3D12_VERTEX_BUFFER_VIEW MeshBufferPool::GetPageVertexBufferView(uint32_t pageIndex, uint32_t vertexStride) const
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+
+    const Page& page = *m_Pages[pageIndex];
+
+    D3D12_VERTEX_BUFFER_VIEW vertexBufferView = {};
+    vertexBufferView.BufferLocation = page.Buffer.GetGPUVirtualAddress();
+    vertexBufferView.SizeInBytes = static_cast<UINT>(page.Allocator.GetSize());
+    vertexBufferView.StrideInBytes = vertexStride;
+    return vertexBufferView;
+}
+
+D3D12_INDEX_BUFFER_VIEW MeshBufferPool::GetPageIndexBufferView(uint32_t pageIndex, DXGI_FORMAT indexFormat) const
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+
+    const Page& page = *m_Pages[pageIndex];
+
+    D3D12_INDEX_BUFFER_VIEW indexBufferView = {};
+    indexBufferView.BufferLocation = page.Buffer.GetGPUVirtualAddress();
+    indexBufferView.SizeInBytes = static_cast<UINT>(page.Allocator.GetSize());
+    indexBufferView.Format = indexFormat;
+    return indexBufferView;
+}
+
+MeshBufferPool::Statistics MeshBufferPool::GetStatistics() const
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+
+    Statistics statistics = {};
+    for (const std::unique_ptr<Page>& page : m_Pages)
+    {
+        statistics.NumPages++;
+        statistics.NumRanges += page->NumRanges;
+        statistics.TotalSize += page->Allocator.GetSize();
+        statistics.AllocatedSize += page->Allocator.GetSize() - page->Allocator.GetFreeSize();
+    }
+    return statistics;
+}
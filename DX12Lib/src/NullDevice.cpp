@@ -0,0 +1,454 @@
+#include <NullDevice.h>
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cstring>
+#include <thread>
+
+namespace
+{
+    // Keep the emulated addresses away from 0 so they can't be mistaken for null handles.
+    const uint64_t FirstGPUVirtualAddress = 0x100000000ull;
+    const uint64_t FirstGPUDescriptorHandle = 0x10000ull;
+
+    const uint64_t TimestampFrequency = 1000000000ull;
+
+    uint64_t AlignUp(uint64_t value, uint64_t alignment)
+    {
+        return (value + alignment - 1) / alignment * alignment;
+    }
+
+    uint64_t GetTimestamp()
+    {
+        using namespace std::chrono;
+        return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+    }
+}
+
+uint64_t NullDevice::DescriptorHeap::GetCPUDescriptorHandleForHeapStart() const
+{
+    return reinterpret_cast<uint64_t>(m_Memory.data());
+}
+
+void* NullDevice::Resource::Map() const
+{
+    return m_Heap->m_Memory.data() + m_Offset;
+}
+
+uint64_t NullDevice::Fence::GetCompletedValue()
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+
+    double now = NullDevice::GetTime();
+    while (!m_PendingValues.empty() && m_PendingValues.front().CompletionTime <= now)
+    {
+        m_CompletedValue = std::max(m_CompletedValue, m_PendingValues.front().Value);
+        m_PendingValues.pop_front();
+    }
+
+    return m_CompletedValue;
+}
+
+void NullDevice::Fence::Wait(uint64_t value)
+{
+    double completionTime = 0.0;
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        if (m_CompletedValue >= value)
+        {
+            return;
+        }
+
+        bool signaled = false;
+        for (const PendingValue& pendingValue : m_PendingValues)
+        {
+            if (pendingValue.Value >= value)
+            {
+                completionTime = pendingValue.CompletionTime;
+                signaled = true;
+                break;
+            }
+        }
+
+        // Waiting for a value that is never signaled blocks forever on a real device.
+        assert(signaled && "The fence value was never signaled.");
+        if (!signaled)
+        {
+            return;
+        }
+    }
+
+    double delay = completionTime - NullDevice::GetTime();
+    if (delay > 0.0)
+    {
+        std::this_thread::sleep_for(std::chrono::duration<double>(delay));
+    }
+
+    while (GetCompletedValue() < value)
+    {
+        std::this_thread::yield();
+    }
+}
+
+void NullDevice::CommandList::Reset()
+{
+    m_Commands.clear();
+}
+
+void NullDevice::CommandList::Record(const Command& command)
+{
+    m_Commands.push_back(command);
+}
+
+void NullDevice::CommandList::Record(CommandType type, uint64_t a0, uint64_t a1, uint64_t a2, uint64_t a3)
+{
+    m_Commands.push_back({ type, { a0, a1, a2, a3 } });
+}
+
+void NullDevice::CommandList::ResourceBarrier(uint32_t numBarriers)
+{
+    Record(CommandType::ResourceBarrier, numBarriers);
+}
+
+void NullDevice::CommandList::CopyBufferRegion(uint64_t dstAddress, uint64_t srcAddress, uint64_t numBytes)
+{
+    Record(CommandType::CopyBufferRegion, dstAddress, srcAddress, numBytes);
+}
+
+void NullDevice::CommandList::SetPipelineState(uint64_t pipelineState)
+{
+    Record(CommandType::SetPipelineState, pipelineState);
+}
+
+void NullDevice::CommandList::SetRootSignature(uint64_t rootSignature)
+{
+    Record(CommandType::SetRootSignature, rootSignature);
+}
+
+void NullDevice::CommandList::SetDescriptorHeap(const Device::DescriptorHeap& descriptorHeap)
+{
+    Record(CommandType::SetDescriptorHeap, static_cast<uint64_t>(descriptorHeap.GetType()), descriptorHeap.GetGPUDescriptorHandleForHeapStart());
+}
+
+void NullDevice::CommandList::SetRootDescriptorTable(uint32_t rootParameterIndex, uint64_t baseDescriptor)
+{
+    Record(CommandType::SetRootDescriptorTable, rootParameterIndex, baseDescriptor);
+}
+
+void NullDevice::CommandList::SetRoot32BitConstants(uint32_t rootParameterIndex, uint32_t num32BitValues)
+{
+    Record(CommandType::SetRoot32BitConstants, rootParameterIndex, num32BitValues);
+}
+
+void NullDevice::CommandList::SetVertexBuffer(uint32_t slot, uint64_t address, uint32_t sizeInBytes, uint32_t strideInBytes)
+{
+    Record(CommandType::SetVertexBuffer, slot, address, sizeInBytes, strideInBytes);
+}
+
+void NullDevice::CommandList::SetIndexBuffer(uint64_t address, uint32_t sizeInBytes)
+{
+    Record(CommandType::SetIndexBuffer, address, sizeInBytes);
+}
+
+void NullDevice::CommandList::ClearRenderTargetView(uint64_t descriptor)
+{
+    Record(CommandType::ClearRenderTargetView, descriptor);
+}
+
+void NullDevice::CommandList::ClearDepthStencilView(uint64_t descriptor)
+{
+    Record(CommandType::ClearDepthStencilView, descriptor);
+}
+
+void NullDevice::CommandList::DrawInstanced(uint32_t vertexCount, uint32_t instanceCount)
+{
+    Record(CommandType::DrawInstanced, vertexCount, instanceCount);
+}
+
+void NullDevice::CommandList::DrawIndexedInstanced(uint32_t indexCount, uint32_t instanceCount)
+{
+    Record(CommandType::DrawIndexedInstanced, indexCount, instanceCount);
+}
+
+void NullDevice::CommandList::Dispatch(uint32_t x, uint32_t y, uint32_t z)
+{
+    Record(CommandType::Dispatch, x, y, z);
+}
+
+void NullDevice::CommandList::EndQuery(QueryHeap& queryHeap, uint32_t index)
+{
+    assert(index < queryHeap.GetNumQueries());
+    Record(CommandType::EndQuery, reinterpret_cast<uint64_t>(&queryHeap), index);
+}
+
+void NullDevice::CommandList::ResolveQueryData(const QueryHeap& queryHeap, uint32_t startIndex, uint32_t numQueries,
+    const Resource& destination, uint64_t destinationOffset)
+{
+    assert(startIndex + numQueries <= queryHeap.GetNumQueries());
+    assert(destinationOffset + numQueries * sizeof(uint64_t) <= destination.GetSize());
+    Record(CommandType::ResolveQueryData, reinterpret_cast<uint64_t>(&queryHeap), startIndex, numQueries,
+        reinterpret_cast<uint64_t>(static_cast<uint8_t*>(destination.Map()) + destinationOffset));
+}
+
+void NullDevice::CommandQueue::Execute(const CommandList& commandList)
+{
+    assert(commandList.GetType() == m_Type);
+
+    // The queries are the only commands that have an effect.
+    for (const Command& command : commandList.GetCommands())
+    {
+        if (command.Type == CommandType::EndQuery)
+        {
+            QueryHeap* queryHeap = reinterpret_cast<QueryHeap*>(command.Arguments[0]);
+            queryHeap->m_Timestamps[command.Arguments[1]] = GetTimestamp();
+        }
+        else if (command.Type == CommandType::ResolveQueryData)
+        {
+            const QueryHeap* queryHeap = reinterpret_cast<const QueryHeap*>(command.Arguments[0]);
+            std::memcpy(reinterpret_cast<void*>(command.Arguments[3]), queryHeap->m_Timestamps.data() + command.Arguments[1],
+                static_cast<size_t>(command.Arguments[2]) * sizeof(uint64_t));
+        }
+    }
+
+    m_Device->m_NumExecutedCommandLists++;
+    m_Device->m_NumExecutedCommands += commandList.GetCommands().size();
+}
+
+void NullDevice::CommandQueue::ExecuteCommandLists(uint32_t numCommandLists, Device::CommandList* const* commandLists)
+{
+    for (uint32_t i = 0; i < numCommandLists; ++i)
+    {
+        Execute(static_cast<const CommandList&>(*commandLists[i]));
+    }
+}
+
+void NullDevice::CommandQueue::Signal(Device::Fence& fence, uint64_t value)
+{
+    Fence& nullFence = static_cast<Fence&>(fence);
+    double completionTime = std::max(NullDevice::GetTime() + m_Device->m_Settings.GpuLatency, m_WaitCompletionTime);
+
+    std::lock_guard<std::mutex> lock(nullFence.m_Mutex);
+    nullFence.m_PendingValues.push_back({ value, completionTime });
+}
+
+void NullDevice::CommandQueue::Wait(Device::Fence& fence, uint64_t value)
+{
+    Fence& nullFence = static_cast<Fence&>(fence);
+
+    std::lock_guard<std::mutex> lock(nullFence.m_Mutex);
+    if (nullFence.m_CompletedValue >= value)
+    {
+        return;
+    }
+
+    for (const Fence::PendingValue& pendingValue : nullFence.m_PendingValues)
+    {
+        if (pendingValue.Value >= value)
+        {
+            m_WaitCompletionTime = std::max(m_WaitCompletionTime, pendingValue.CompletionTime);
+            return;
+        }
+    }
+
+    // A queue that waits for a value that is never signaled stalls forever on a real device.
+    assert(false && "The fence value was never signaled.");
+}
+
+uint64_t NullDevice::CommandQueue::ExecuteCommandList(const CommandList& commandList)
+{
+    Execute(commandList);
+
+    uint64_t fenceValue = ++m_FenceValue;
+    Signal(*m_Fence, fenceValue);
+
+    return fenceValue;
+}
+
+NullDevice::NullDevice()
+    : NullDevice(Settings())
+{}
+
+NullDevice::NullDevice(const Settings& settings)
+    : m_Settings(settings)
+    , m_NextGPUVirtualAddress(FirstGPUVirtualAddress)
+    , m_NextGPUDescriptorHandle(FirstGPUDescriptorHandle)
+    , m_FrameCount(0)
+    , m_NumDescriptorHeaps(0)
+    , m_NumHeaps(0)
+    , m_NumResources(0)
+    , m_NumBytesAllocated(0)
+    , m_NumExecutedCommandLists(0)
+    , m_NumExecutedCommands(0)
+{
+    m_Settings.ResourceAlignment = std::max<uint64_t>(1, m_Settings.ResourceAlignment);
+    m_Settings.GpuLatency = std::max(0.0, m_Settings.GpuLatency);
+}
+
+const NullDevice::Settings& NullDevice::GetSettings() const
+{
+    return m_Settings;
+}
+
+std::shared_ptr<Device::DescriptorHeap> NullDevice::CreateDescriptorHeap(DescriptorHeapType type, uint32_t numDescriptors, bool shaderVisible)
+{
+    uint32_t descriptorSize = GetDescriptorHandleIncrementSize(type);
+
+    auto descriptorHeap = std::make_shared<DescriptorHeap>();
+    descriptorHeap->m_Type = type;
+    descriptorHeap->m_NumDescriptors = numDescriptors;
+    descriptorHeap->m_Memory.resize(static_cast<size_t>(numDescriptors) * descriptorSize);
+    descriptorHeap->m_GPUHandleStart = shaderVisible ?
+        m_NextGPUDescriptorHandle.fetch_add(static_cast<uint64_t>(numDescriptors) * descriptorSize) : 0;
+
+    m_NumDescriptorHeaps++;
+
+    return descriptorHeap;
+}
+
+uint32_t NullDevice::GetDescriptorHandleIncrementSize(DescriptorHeapType type) const
+{
+    return m_Settings.DescriptorSizes[static_cast<uint32_t>(type)];
+}
+
+void NullDevice::CopyDescriptorsSimple(uint32_t numDescriptors, uint64_t destDescriptor, uint64_t srcDescriptor, DescriptorHeapType type) const
+{
+    std::memcpy(reinterpret_cast<void*>(destDescriptor), reinterpret_cast<const void*>(srcDescriptor),
+        static_cast<size_t>(numDescriptors) * GetDescriptorHandleIncrementSize(type));
+}
+
+void NullDevice::CopyDescriptors(uint32_t numDescriptors, uint64_t destDescriptor, const uint64_t* srcDescriptors, DescriptorHeapType type) const
+{
+    uint32_t descriptorSize = GetDescriptorHandleIncrementSize(type);
+    for (uint32_t i = 0; i < numDescriptors; ++i)
+    {
+        void* dest = reinterpret_cast<void*>(destDescriptor + static_cast<uint64_t>(i) * descriptorSize);
+        // Descriptors of a table that were never staged are null.
+        if (srcDescriptors[i] == 0)
+        {
+            std::memset(dest, 0, descriptorSize);
+            continue;
+        }
+        std::memcpy(dest, reinterpret_cast<const void*>(srcDescriptors[i]), descriptorSize);
+    }
+}
+
+std::shared_ptr<NullDevice::Heap> NullDevice::CreateHeap(uint64_t sizeInBytes)
+{
+    auto heap = std::make_shared<Heap>();
+    heap->m_Memory.resize(static_cast<size_t>(sizeInBytes));
+    heap->m_GPUVirtualAddress = AllocateGPUVirtualAddress(sizeInBytes);
+
+    m_NumHeaps++;
+    m_NumBytesAllocated += sizeInBytes;
+
+    return heap;
+}
+
+std::shared_ptr<NullDevice::Resource> NullDevice::CreateCommittedResource(uint64_t sizeInBytes)
+{
+    // A committed resource has an implicit heap (that is not counted as a heap).
+    uint64_t heapSize = AlignUp(sizeInBytes, m_Settings.ResourceAlignment);
+
+    auto heap = std::make_shared<Heap>();
+    heap->m_Memory.resize(static_cast<size_t>(heapSize));
+    heap->m_GPUVirtualAddress = AllocateGPUVirtualAddress(heapSize);
+
+    m_NumBytesAllocated += heapSize;
+
+    return CreatePlacedResource(heap, 0, sizeInBytes);
+}
+
+std::shared_ptr<NullDevice::Resource> NullDevice::CreatePlacedResource(std::shared_ptr<Heap> heap, uint64_t offset, uint64_t sizeInBytes)
+{
+    if (!heap || offset + sizeInBytes > heap->GetSize())
+    {
+        return nullptr;
+    }
+
+    auto resource = std::make_shared<Resource>();
+    resource->m_GPUVirtualAddress = heap->m_GPUVirtualAddress + offset;
+    resource->m_Heap = std::move(heap);
+    resource->m_Offset = offset;
+    resource->m_Size = sizeInBytes;
+
+    m_NumResources++;
+
+    return resource;
+}
+
+std::shared_ptr<Device::Resource> NullDevice::CreateUploadBuffer(uint64_t sizeInBytes)
+{
+    return CreateCommittedResource(sizeInBytes);
+}
+
+std::shared_ptr<NullDevice::QueryHeap> NullDevice::CreateQueryHeap(uint32_t numQueries)
+{
+    auto queryHeap = std::make_shared<QueryHeap>();
+    queryHeap->m_Timestamps.resize(numQueries);
+    return queryHeap;
+}
+
+uint64_t NullDevice::GetTimestampFrequency() const
+{
+    return TimestampFrequency;
+}
+
+std::shared_ptr<Device::Fence> NullDevice::CreateFence(uint64_t initialValue)
+{
+    auto fence = std::make_shared<Fence>();
+    fence->m_CompletedValue = initialValue;
+    return fence;
+}
+
+std::shared_ptr<Device::CommandQueue> NullDevice::CreateCommandQueue(CommandListType type)
+{
+    auto commandQueue = std::make_shared<CommandQueue>();
+    commandQueue->m_Device = this;
+    commandQueue->m_Type = type;
+    commandQueue->m_Fence = std::make_shared<Fence>();
+    commandQueue->m_Fence->m_CompletedValue = 0;
+    commandQueue->m_FenceValue = 0;
+    commandQueue->m_WaitCompletionTime = 0.0;
+    return commandQueue;
+}
+
+std::shared_ptr<Device::CommandList> NullDevice::CreateCommandList(CommandListType type)
+{
+    auto commandList = std::make_shared<CommandList>();
+    commandList->m_Type = type;
+    return commandList;
+}
+
+uint64_t NullDevice::GetFrameCount() const
+{
+    return m_FrameCount;
+}
+
+void NullDevice::SetFrameCount(uint64_t frameCount)
+{
+    m_FrameCount = frameCount;
+}
+
+NullDevice::Statistics NullDevice::GetStatistics() const
+{
+    Statistics statistics;
+    statistics.NumDescriptorHeaps = m_NumDescriptorHeaps;
+    statistics.NumHeaps = m_NumHeaps;
+    statistics.NumResources = m_NumResources;
+    statistics.NumBytesAllocated = m_NumBytesAllocated;
+    statistics.NumExecutedCommandLists = m_NumExecutedCommandLists;
+    statistics.NumExecutedCommands = m_NumExecutedCommands;
+    return statistics;
+}
+
+double NullDevice::GetTime()
+{
+    using namespace std::chrono;
+    return duration<double>(steady_clock::now().time_since_epoch()).count();
+}
+
+uint64_t NullDevice::AllocateGPUVirtualAddress(uint64_t sizeInBytes)
+{
+    return m_NextGPUVirtualAddress.fetch_add(AlignUp(std::max<uint64_t>(1, sizeInBytes), m_Settings.ResourceAlignment));
+}
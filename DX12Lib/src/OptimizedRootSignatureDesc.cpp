@@ -0,0 +1,70 @@
+#include <DX12LibPCH.h>
+
+#include <OptimizedRootSignatureDesc.h>
+
+// The optimizer enumerations have the same values as the D3D12 enumerations.
+static_assert(static_cast<uint32_t>(RootSignatureOptimizer::BindingType::Sampler) == D3D12_DESCRIPTOR_RANGE_TYPE_SAMPLER, "Binding types must match D3D12_DESCRIPTOR_RANGE_TYPE.");
+static_assert(static_cast<uint32_t>(RootSignatureOptimizer::ShaderVisibility::Pixel) == D3D12_SHADER_VISIBILITY_PIXEL, "Shader visibility must match D3D12_SHADER_VISIBILITY.");
+static_assert(static_cast<uint32_t>(RootSignatureOptimizer::ParameterType::UAV) == D3D12_ROOT_PARAMETER_TYPE_UAV, "Parameter types must match D3D12_ROOT_PARAMETER_TYPE.");
+
+OptimizedRootSignatureDesc::OptimizedRootSignatureDesc(
+    const RootSignatureOptimizer::Layout& layout,
+    D3D12_ROOT_SIGNATURE_FLAGS flags,
+    const std::vector<D3D12_STATIC_SAMPLER_DESC>& staticSamplers)
+    : m_StaticSamplers(staticSamplers)
+    , m_RootSignatureDesc{}
+{
+    m_RootParameters.resize(layout.Parameters.size());
+    m_DescriptorRanges.resize(layout.Parameters.size());
+
+    for (size_t i = 0; i < layout.Parameters.size(); ++i)
+    {
+        const RootSignatureOptimizer::RootParameter& parameter = layout.Parameters[i];
+        D3D12_ROOT_PARAMETER1& rootParameter = m_RootParameters[i];
+
+        rootParameter = {};
+        rootParameter.ParameterType = static_cast<D3D12_ROOT_PARAMETER_TYPE>(parameter.Type);
+        rootParameter.ShaderVisibility = static_cast<D3D12_SHADER_VISIBILITY>(parameter.Visibility);
+
+        switch (parameter.Type)
+        {
+        case RootSignatureOptimizer::ParameterType::DescriptorTable:
+        {
+            std::vector<D3D12_DESCRIPTOR_RANGE1>& descriptorRanges = m_DescriptorRanges[i];
+            descriptorRanges.reserve(parameter.Ranges.size());
+
+            for (const RootSignatureOptimizer::DescriptorRange& range : parameter.Ranges)
+            {
+                D3D12_DESCRIPTOR_RANGE1 descriptorRange = {};
+                descriptorRange.RangeType = static_cast<D3D12_DESCRIPTOR_RANGE_TYPE>(range.Type);
+                descriptorRange.NumDescriptors = range.NumDescriptors;
+                descriptorRange.BaseShaderRegister = range.BaseShaderRegister;
+                descriptorRange.RegisterSpace = range.RegisterSpace;
+                descriptorRange.Flags = D3D12_DESCRIPTOR_RANGE_FLAG_NONE;
+                descriptorRange.OffsetInDescriptorsFromTableStart = range.OffsetInDescriptorsFromTableStart;
+                descriptorRanges.push_back(descriptorRange);
+            }
+
+            rootParameter.DescriptorTable.NumDescriptorRanges = static_cast<UINT>(descriptorRanges.size());
+            rootParameter.DescriptorTable.pDescriptorRanges = descriptorRanges.data();
+        }
+        break;
+        case RootSignatureOptimizer::ParameterType::Constants:
+            rootParameter.Constants.ShaderRegister = parameter.ShaderRegister;
+            rootParameter.Constants.RegisterSpace = parameter.RegisterSpace;
+            rootParameter.Constants.Num32BitValues = parameter.Num32BitValues;
+            break;
+        default:
+            rootParameter.Descriptor.ShaderRegister = parameter.ShaderRegister;
+            rootParameter.Descriptor.RegisterSpace = parameter.RegisterSpace;
+            rootParameter.Descriptor.Flags = D3D12_ROOT_DESCRIPTOR_FLAG_NONE;
+            break;
+        }
+    }
+
+    m_RootSignatureDesc.NumParameters = static_cast<UINT>(m_RootParameters.size());
+    m_RootSignatureDesc.pParameters = m_RootParameters.data();
+    m_RootSignatureDesc.NumStaticSamplers = static_cast<UINT>(m_StaticSamplers.size());
+    m_RootSignatureDesc.pStaticSamplers = m_StaticSamplers.data();
+    m_RootSignatureDesc.Flags = flags;
+}
@@ -0,0 +1,464 @@
+#include <DX12LibPCH.h>
+
+#include <PipelineStateCache.h>
+
+#include <Hash.h>
+#include <PipelineStateKey.h>
+
+#include <fstream>
+
+namespace
+{
+    using Field = PipelineStateKey::Field;
+
+    // Builds the key of a pipeline state stream.
+    // Structures that contain padding are added to the key member by member.
+    class PipelineStateKeyBuilder : public ID3DX12PipelineParserCallbacks
+    {
+    public:
+        explicit PipelineStateKeyBuilder(uint64_t rootSignatureHash)
+            : RootSignatureHash(rootSignatureHash)
+            , HasCachedPSO(false)
+        {}
+
+        void FlagsCb(D3D12_PIPELINE_STATE_FLAGS flags) override
+        {
+            Key.AddValue(Field::Flags, flags);
+        }
+
+        void NodeMaskCb(UINT nodeMask) override
+        {
+            Key.AddValue(Field::NodeMask, nodeMask);
+        }
+
+        void RootSignatureCb(ID3D12RootSignature*) override
+        {
+            Key.AddRootSignature(RootSignatureHash);
+        }
+
+        void InputLayoutCb(const D3D12_INPUT_LAYOUT_DESC& inputLayout) override
+        {
+            Key.AddValue(Field::InputLayout, inputLayout.NumElements);
+            for (UINT i = 0; i < inputLayout.NumElements; ++i)
+            {
+                const D3D12_INPUT_ELEMENT_DESC& element = inputLayout.pInputElementDescs[i];
+                Key.AddString(Field::InputLayout, element.SemanticName);
+                Key.AddValue(Field::InputLayout, element.SemanticIndex);
+                Key.AddValue(Field::InputLayout, element.Format);
+                Key.AddValue(Field::InputLayout, element.InputSlot);
+                Key.AddValue(Field::InputLayout, element.AlignedByteOffset);
+                Key.AddValue(Field::InputLayout, element.InputSlotClass);
+                Key.AddValue(Field::InputLayout, element.InstanceDataStepRate);
+            }
+        }
+
+        void IBStripCutValueCb(D3D12_INDEX_BUFFER_STRIP_CUT_VALUE value) override
+        {
+            Key.AddValue(Field::IBStripCutValue, value);
+        }
+
+        void PrimitiveTopologyTypeCb(D3D12_PRIMITIVE_TOPOLOGY_TYPE primitiveTopologyType) override
+        {
+            Key.AddValue(Field::PrimitiveTopology, primitiveTopologyType);
+        }
+
+        void VSCb(const D3D12_SHADER_BYTECODE& shader) override
+        {
+            Key.AddShader(Field::VS, shader.pShaderBytecode, shader.BytecodeLength);
+        }
+
+        void GSCb(const D3D12_SHADER_BYTECODE& shader) override
+        {
+            Key.AddShader(Field::GS, shader.pShaderBytecode, shader.BytecodeLength);
+        }
+
+        void HSCb(const D3D12_SHADER_BYTECODE& shader) override
+        {
+            Key.AddShader(Field::HS, shader.pShaderBytecode, shader.BytecodeLength);
+        }
+
+        void DSCb(const D3D12_SHADER_BYTECODE& shader) override
+        {
+            Key.AddShader(Field::DS, shader.pShaderBytecode, shader.BytecodeLength);
+        }
+
+        void PSCb(const D3D12_SHADER_BYTECODE& shader) override
+        {
+            Key.AddShader(Field::PS, shader.pShaderBytecode, shader.BytecodeLength);
+        }
+
+        void CSCb(const D3D12_SHADER_BYTECODE& shader) override
+        {
+            Key.AddShader(Field::CS, shader.pShaderBytecode, shader.BytecodeLength);
+        }
+
+        void StreamOutputCb(const D3D12_STREAM_OUTPUT_DESC& streamOutput) override
+        {
+            Key.AddValue(Field::StreamOutput, streamOutput.NumEntries);
+            for (UINT i = 0; i < streamOutput.NumEntries; ++i)
+            {
+                const D3D12_SO_DECLARATION_ENTRY& entry = streamOutput.pSODeclaration[i];
+                Key.AddValue(Field::StreamOutput, entry.Stream);
+                Key.AddString(Field::StreamOutput, entry.SemanticName);
+                Key.AddValue(Field::StreamOutput, entry.SemanticIndex);
+                Key.AddValue(Field::StreamOutput, entry.StartComponent);
+                Key.AddValue(Field::StreamOutput, entry.ComponentCount);
+                Key.AddValue(Field::StreamOutput, entry.OutputSlot);
+            }
+            Key.AddBytes(Field::StreamOutput, streamOutput.pBufferStrides, streamOutput.NumStrides * sizeof(UINT));
+            Key.AddValue(Field::StreamOutput, streamOutput.RasterizedStream);
+        }
+
+        void BlendStateCb(const D3D12_BLEND_DESC& blendState) override
+        {
+            Key.AddValue(Field::Blend, blendState.AlphaToCoverageEnable);
+            Key.AddValue(Field::Blend, blendState.IndependentBlendEnable);
+            for (const D3D12_RENDER_TARGET_BLEND_DESC& renderTarget : blendState.RenderTarget)
+            {
+                Key.AddValue(Field::Blend, renderTarget.BlendEnable);
+                Key.AddValue(Field::Blend, renderTarget.LogicOpEnable);
+                Key.AddValue(Field::Blend, renderTarget.SrcBlend);
+                Key.AddValue(Field::Blend, renderTarget.DestBlend);
+                Key.AddValue(Field::Blend, renderTarget.BlendOp);
+                Key.AddValue(Field::Blend, renderTarget.SrcBlendAlpha);
+                Key.AddValue(Field::Blend, renderTarget.DestBlendAlpha);
+                Key.AddValue(Field::Blend, renderTarget.BlendOpAlpha);
+                Key.AddValue(Field::Blend, renderTarget.LogicOp);
+                Key.AddValue(Field::Blend, renderTarget.RenderTargetWriteMask);
+            }
+        }
+
+        void DepthStencilStateCb(const D3D12_DEPTH_STENCIL_DESC& depthStencilState) override
+        {
+            Key.AddValue(Field::DepthStencil, depthStencilState.DepthEnable);
+            Key.AddValue(Field::DepthStencil, depthStencilState.DepthWriteMask);
+            Key.AddValue(Field::DepthStencil, depthStencilState.DepthFunc);
+            Key.AddValue(Field::DepthStencil, depthStencilState.StencilEnable);
+            Key.AddValue(Field::DepthStencil, depthStencilState.StencilReadMask);
+            Key.AddValue(Field::DepthStencil, depthStencilState.StencilWriteMask);
+            AddStencilOp(Field::DepthStencil, depthStencilState.FrontFace);
+            AddStencilOp(Field::DepthStencil, depthStencilState.BackFace);
+        }
+
+        void DepthStencilState1Cb(const D3D12_DEPTH_STENCIL_DESC1& depthStencilState) override
+        {
+            Key.AddValue(Field::DepthStencil1, depthStencilState.DepthEnable);
+            Key.AddValue(Field::DepthStencil1, depthStencilState.DepthWriteMask);
+            Key.AddValue(Field::DepthStencil1, depthStencilState.DepthFunc);
+            Key.AddValue(Field::DepthStencil1, depthStencilState.StencilEnable);
+            Key.AddValue(Field::DepthStencil1, depthStencilState.StencilReadMask);
+            Key.AddValue(Field::DepthStencil1, depthStencilState.StencilWriteMask);
+            AddStencilOp(Field::DepthStencil1, depthStencilState.FrontFace);
+            AddStencilOp(Field::DepthStencil1, depthStencilState.BackFace);
+            Key.AddValue(Field::DepthStencil1, depthStencilState.DepthBoundsTestEnable);
+        }
+
+        void DSVFormatCb(DXGI_FORMAT format) override
+        {
+            Key.AddValue(Field::DepthStencilFormat, format);
+        }
+
+        void RasterizerStateCb(const D3D12_RASTERIZER_DESC& rasterizerState) override
+        {
+            // The rasterizer description only contains 32-bit members.
+            Key.AddBytes(Field::Rasterizer, &rasterizerState, sizeof(D3D12_RASTERIZER_DESC));
+        }
+
+        void RTVFormatsCb(const D3D12_RT_FORMAT_ARRAY& rtvFormats) override
+        {
+            // Only the formats of the bound render targets are relevant.
+            UINT numRenderTargets = std::min<UINT>(rtvFormats.NumRenderTargets, _countof(rtvFormats.RTFormats));
+            Key.AddValue(Field::RenderTargetFormats, numRenderTargets);
+            Key.AddBytes(Field::RenderTargetFormats, rtvFormats.RTFormats, numRenderTargets * sizeof(DXGI_FORMAT));
+        }
+
+        void SampleDescCb(const DXGI_SAMPLE_DESC& sampleDesc) override
+        {
+            Key.AddValue(Field::SampleDesc, sampleDesc.Count);
+            Key.AddValue(Field::SampleDesc, sampleDesc.Quality);
+        }
+
+        void SampleMaskCb(UINT sampleMask) override
+        {
+            Key.AddValue(Field::SampleMask, sampleMask);
+        }
+
+        void ViewInstancingCb(const D3D12_VIEW_INSTANCING_DESC& viewInstancing) override
+        {
+            Key.AddValue(Field::ViewInstancing, viewInstancing.ViewInstanceCount);
+            for (UINT i = 0; i < viewInstancing.ViewInstanceCount; ++i)
+            {
+                Key.AddValue(Field::ViewInstancing, viewInstancing.pViewInstanceLocations[i].ViewportArrayIndex);
+                Key.AddValue(Field::ViewInstancing, viewInstancing.pViewInstanceLocations[i].RenderTargetArrayIndex);
+            }
+            Key.AddValue(Field::ViewInstancing, viewInstancing.Flags);
+        }
+
+        void CachedPSOCb(const D3D12_CACHED_PIPELINE_STATE&) override
+        {
+            // A cached blob does not change the pipeline state.
+            HasCachedPSO = true;
+        }
+
+        PipelineStateKey Key;
+        uint64_t RootSignatureHash;
+        bool HasCachedPSO;
+
+    private:
+        void AddStencilOp(Field field, const D3D12_DEPTH_STENCILOP_DESC& stencilOp)
+        {
+            Key.AddValue(field, stencilOp.StencilFailOp);
+            Key.AddValue(field, stencilOp.StencilDepthFailOp);
+            Key.AddValue(field, stencilOp.StencilPassOp);
+            Key.AddValue(field, stencilOp.StencilFunc);
+        }
+    };
+
+    // Identify the adapter and the version of the user-mode driver.
+    // Cached blobs can't be used with a different adapter or driver.
+    uint64_t ComputeDeviceHash(ComPtr<IDXGIAdapter4> adapter)
+    {
+        DXGI_ADAPTER_DESC1 adapterDesc;
+        ThrowIfFailed(adapter->GetDesc1(&adapterDesc));
+
+        LARGE_INTEGER driverVersion = {};
+        adapter->CheckInterfaceSupport(__uuidof(IDXGIDevice), &driverVersion);
+
+        Hasher hasher;
+        hasher.Add(adapterDesc.VendorId);
+        hasher.Add(adapterDesc.DeviceId);
+        hasher.Add(adapterDesc.SubSysId);
+        hasher.Add(adapterDesc.Revision);
+        hasher.Add(driverVersion.QuadPart);
+        // Blobs of 32-bit and 64-bit processes are not compatible.
+        hasher.Add(static_cast<uint32_t>(sizeof(void*)));
+
+        return hasher.GetHash();
+    }
+}
+
+PipelineStateCache::PipelineStateCache(ComPtr<ID3D12Device2> device, ComPtr<IDXGIAdapter4> adapter, const std::wstring& fileName)
+    : m_d3d12Device(device)
+    , m_FileName(fileName)
+    , m_DeviceHash(ComputeDeviceHash(adapter))
+    , m_Statistics{}
+{
+    Load();
+}
+
+PipelineStateCache::~PipelineStateCache()
+{}
+
+void PipelineStateCache::Load()
+{
+    m_CacheFile.Clear();
+
+    if (m_MappedFile.Open(m_FileName))
+    {
+        // A cache file that is invalid (or was written for a different device)
+        // is replaced the next time the cache is saved.
+        if (!m_CacheFile.Load(m_MappedFile.GetData(), m_MappedFile.GetSize(), m_DeviceHash))
+        {
+            m_MappedFile.Close();
+        }
+    }
+}
+
+uint64_t PipelineStateCache::ComputeHash(
+    const D3D12_PIPELINE_STATE_STREAM_DESC& pipelineStateStreamDesc,
+    uint64_t rootSignatureHash)
+{
+    PipelineStateKeyBuilder keyBuilder(rootSignatureHash);
+    ThrowIfFailed(D3DX12ParsePipelineStream(pipelineStateStreamDesc, &keyBuilder));
+
+    return keyBuilder.Key.GetHash();
+}
+
+ComPtr<ID3D12PipelineState> PipelineStateCache::GetPipelineState(
+    const D3D12_PIPELINE_STATE_STREAM_DESC& pipelineStateStreamDesc,
+    uint64_t rootSignatureHash)
+{
+    PipelineStateKeyBuilder keyBuilder(rootSignatureHash);
+    ThrowIfFailed(D3DX12ParsePipelineStream(pipelineStateStreamDesc, &keyBuilder));
+
+    uint64_t key = keyBuilder.Key.GetHash();
+
+    // The blob is copied so the pipeline state can be compiled without
+    // holding the lock (the cache file is unmapped when it is saved).
+    std::vector<uint8_t> cachedBlob;
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        m_UsedKeys.insert(key);
+
+        auto iter = m_PipelineStates.find(key);
+        if (iter != m_PipelineStates.end())
+        {
+            ++m_Statistics.NumHits;
+            return iter->second;
+        }
+
+        PipelineStateCacheFile::Blob blob = m_CacheFile.Find(key);
+        if (blob.Data && !keyBuilder.HasCachedPSO)
+        {
+            const uint8_t* blobData = static_cast<const uint8_t*>(blob.Data);
+            cachedBlob.assign(blobData, blobData + blob.Size);
+        }
+    }
+
+    ComPtr<ID3D12PipelineState> pipelineState;
+    bool loadedFromBlob = false;
+    bool rejectedBlob = false;
+
+    if (!cachedBlob.empty())
+    {
+        // Append the cached blob to a copy of the stream.
+        // The stream is stored in pointer-sized elements to satisfy the
+        // alignment of the subobjects.
+        size_t streamSize = pipelineStateStreamDesc.SizeInBytes;
+        size_t cachedStreamSize = streamSize + sizeof(CD3DX12_PIPELINE_STATE_STREAM_CACHED_PSO);
+        std::vector<void*> cachedStream((cachedStreamSize + sizeof(void*) - 1) / sizeof(void*));
+
+        uint8_t* streamData = reinterpret_cast<uint8_t*>(cachedStream.data());
+        memcpy(streamData, pipelineStateStreamDesc.pPipelineStateSubobjectStream, streamSize);
+        new (streamData + streamSize) CD3DX12_PIPELINE_STATE_STREAM_CACHED_PSO(
+            D3D12_CACHED_PIPELINE_STATE{ cachedBlob.data(), cachedBlob.size() });
+
+        D3D12_PIPELINE_STATE_STREAM_DESC cachedStreamDesc = { cachedStreamSize, streamData };
+
+        // The driver rejects blobs that don't match the description or the driver version.
+        if (SUCCEEDED(m_d3d12Device->CreatePipelineState(&cachedStreamDesc, IID_PPV_ARGS(&pipelineState))))
+        {
+            loadedFromBlob = true;
+        }
+        else
+        {
+            rejectedBlob = true;
+            pipelineState.Reset();
+        }
+    }
+
+    ComPtr<ID3DBlob> newBlob;
+    if (!pipelineState)
+    {
+        ThrowIfFailed(m_d3d12Device->CreatePipelineState(&pipelineStateStreamDesc, IID_PPV_ARGS(&pipelineState)));
+
+        if (FAILED(pipelineState->GetCachedBlob(&newBlob)))
+        {
+            newBlob.Reset();
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(m_Mutex);
+
+    if (rejectedBlob)
+    {
+        ++m_Statistics.NumRejectedBlobs;
+    }
+
+    // Another thread may have created the same pipeline state in the meantime.
+    auto result = m_PipelineStates.emplace(key, pipelineState);
+    if (result.second)
+    {
+        if (loadedFromBlob)
+        {
+            ++m_Statistics.NumDiskHits;
+        }
+        else
+        {
+            ++m_Statistics.NumMisses;
+        }
+
+        if (newBlob)
+        {
+            m_NewBlobs[key] = newBlob;
+        }
+    }
+    else
+    {
+        ++m_Statistics.NumHits;
+    }
+
+    return result.first->second;
+}
+
+void PipelineStateCache::Release(ID3D12PipelineState* pipelineState)
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+
+    for (auto iter = m_PipelineStates.begin(); iter != m_PipelineStates.end(); ++iter)
+    {
+        if (iter->second.Get() == pipelineState)
+        {
+            m_NewBlobs.erase(iter->first);
+            m_UsedKeys.erase(iter->first);
+            m_PipelineStates.erase(iter);
+            break;
+        }
+    }
+}
+
+bool PipelineStateCache::Save()
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+
+    // Drop the blobs of the pipeline states that were not used.
+    PipelineStateCacheFile::BlobMap blobs;
+    for (const auto& blob : m_CacheFile.GetBlobs())
+    {
+        if (m_UsedKeys.count(blob.first) > 0)
+        {
+            blobs.insert(blob);
+        }
+    }
+
+    if (m_NewBlobs.empty() && blobs.size() == m_CacheFile.GetBlobs().size())
+    {
+        return true;
+    }
+
+    for (const auto& newBlob : m_NewBlobs)
+    {
+        blobs[newBlob.first] = { newBlob.second->GetBufferPointer(), newBlob.second->GetBufferSize() };
+    }
+
+    std::vector<uint8_t> image = PipelineStateCacheFile::Serialize(blobs, m_DeviceHash);
+
+    // Write to a temporary file first so a partially written file never
+    // replaces a valid cache file.
+    std::wstring tempFileName = m_FileName + L".tmp";
+    {
+        std::ofstream file(tempFileName, std::ios::binary | std::ios::trunc);
+        file.write(reinterpret_cast<const char*>(image.data()), image.size());
+        file.close();
+        if (!file)
+        {
+            ::DeleteFileW(tempFileName.c_str());
+            return false;
+        }
+    }
+
+    // The cache file can't be replaced while it is mapped.
+    m_CacheFile.Clear();
+    m_MappedFile.Close();
+
+    bool saved = ::MoveFileExW(tempFileName.c_str(), m_FileName.c_str(), MOVEFILE_REPLACE_EXISTING) != FALSE;
+    if (saved)
+    {
+        m_NewBlobs.clear();
+    }
+    else
+    {
+        ::DeleteFileW(tempFileName.c_str());
+    }
+
+    Load();
+
+    return saved;
+}
+
+PipelineStateCache::Statistics PipelineStateCache::GetStatistics() const
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    return m_Statistics;
+}
@@ -0,0 +1,109 @@
+#include <PipelineStateCacheFile.h>
+
+#include <Hash.h>
+
+#include <cstring>
+
+PipelineStateCacheFile::PipelineStateCacheFile()
+{}
+
+bool PipelineStateCacheFile::Load(const void* data, size_t sizeInBytes, uint64_t deviceHash)
+{
+    Clear();
+
+    if (!data || sizeInBytes < sizeof(Header))
+    {
+        return false;
+    }
+
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+
+    Header header;
+    memcpy(&header, bytes, sizeof(Header));
+
+    if (header.Magic != Magic || header.Version != Version || header.DeviceHash != deviceHash)
+    {
+        return false;
+    }
+
+    uint64_t maxEntries = (sizeInBytes - sizeof(Header)) / sizeof(Entry);
+    if (header.NumEntries > maxEntries)
+    {
+        return false;
+    }
+
+    if (HashBytes(bytes + sizeof(Header), sizeInBytes - sizeof(Header)) != header.Checksum)
+    {
+        return false;
+    }
+
+    const uint8_t* entries = bytes + sizeof(Header);
+    for (uint64_t i = 0; i < header.NumEntries; ++i)
+    {
+        Entry entry;
+        memcpy(&entry, entries + i * sizeof(Entry), sizeof(Entry));
+
+        if (entry.Offset > sizeInBytes || entry.Size > sizeInBytes - entry.Offset)
+        {
+            Clear();
+            return false;
+        }
+
+        m_Blobs[entry.Key] = { bytes + entry.Offset, static_cast<size_t>(entry.Size) };
+    }
+
+    return true;
+}
+
+PipelineStateCacheFile::Blob PipelineStateCacheFile::Find(uint64_t key) const
+{
+    auto iter = m_Blobs.find(key);
+    if (iter != m_Blobs.end())
+    {
+        return iter->second;
+    }
+
+    return { nullptr, 0 };
+}
+
+void PipelineStateCacheFile::Clear()
+{
+    m_Blobs.clear();
+}
+
+std::vector<uint8_t> PipelineStateCacheFile::Serialize(const BlobMap& blobs, uint64_t deviceHash)
+{
+    size_t dataOffset = sizeof(Header) + blobs.size() * sizeof(Entry);
+    size_t sizeInBytes = dataOffset;
+    for (const auto& blob : blobs)
+    {
+        sizeInBytes += blob.second.Size;
+    }
+
+    std::vector<uint8_t> image(sizeInBytes);
+
+    uint8_t* entries = image.data() + sizeof(Header);
+    size_t offset = dataOffset;
+    for (const auto& blob : blobs)
+    {
+        Entry entry = { blob.first, offset, blob.second.Size };
+        memcpy(entries, &entry, sizeof(Entry));
+        entries += sizeof(Entry);
+
+        if (blob.second.Size > 0)
+        {
+            memcpy(image.data() + offset, blob.second.Data, blob.second.Size);
+        }
+        offset += blob.second.Size;
+    }
+
+    Header header = {};
+    header.Magic = Magic;
+    header.Version = Version;
+    header.DeviceHash = deviceHash;
+    header.NumEntries = blobs.size();
+    header.Checksum = HashBytes(image.data() + sizeof(Header), sizeInBytes - sizeof(Header));
+    memcpy(image.data(), &header, sizeof(Header));
+
+    return image;
+}
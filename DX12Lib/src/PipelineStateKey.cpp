@@ -0,0 +1,37 @@
+#include <PipelineStateKey.h>
+
+#include <cstring>
+
+void PipelineStateKey::AddValue(Field field, uint32_t value)
+{
+    m_Hasher.Add(field);
+    m_Hasher.Add(value);
+}
+
+void PipelineStateKey::AddBytes(Field field, const void* data, size_t sizeInBytes)
+{
+    m_Hasher.Add(field);
+    m_Hasher.Add(static_cast<uint64_t>(sizeInBytes));
+    m_Hasher.Add(data, sizeInBytes);
+}
+
+void PipelineStateKey::AddString(Field field, const char* value)
+{
+    size_t length = value ? strlen(value) : 0;
+    AddBytes(field, value, length);
+}
+
+void PipelineStateKey::AddShader(Field field, const void* bytecode, size_t sizeInBytes)
+{
+    // Only the hash of the bytecode is added to the key, so different
+    // shaders don't produce the same sequence of bytes in the key.
+    m_Hasher.Add(field);
+    m_Hasher.Add(static_cast<uint64_t>(sizeInBytes));
+    m_Hasher.Add(sizeInBytes > 0 ? HashBytes(bytecode, sizeInBytes) : 0ull);
+}
+
+void PipelineStateKey::AddRootSignature(uint64_t rootSignatureHash)
+{
+    m_Hasher.Add(Field::RootSignature);
+    m_Hasher.Add(rootSignatureHash);
+}
@@ -0,0 +1,351 @@
+#include <Profiler.h>
+
+#include <FastClock.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+
+namespace
+{
+    // Marks the thread buffer of the thread as inactive when the thread exits,
+    // so the buffer is reused instead of growing the profiler with every thread.
+    struct ThreadBufferOwner
+    {
+        ~ThreadBufferOwner()
+        {
+            if (IsActive)
+            {
+                IsActive->store(false, std::memory_order_release);
+            }
+        }
+
+        void* ThreadBuffer = nullptr;
+        std::atomic<bool>* IsActive = nullptr;
+    };
+
+    thread_local ThreadBufferOwner tls_ThreadBuffer;
+
+    // Write a string as a JSON string.
+    void WriteString(std::ostream& stream, const std::string& string)
+    {
+        stream << '"';
+        for (char c : string)
+        {
+            if (c == '"' || c == '\\')
+            {
+                stream << '\\' << c;
+            }
+            else if (static_cast<unsigned char>(c) < 0x20)
+            {
+                char escaped[8];
+                snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+                stream << escaped;
+            }
+            else
+            {
+                stream << c;
+            }
+        }
+        stream << '"';
+    }
+}
+
+Profiler::Profiler()
+    : m_FrameCount(0)
+    , m_TraceStart(0)
+    , m_NumTraceFrames(0)
+    , m_TraceFrameCount(0)
+{}
+
+Profiler& Profiler::Get()
+{
+    static Profiler profiler;
+    return profiler;
+}
+
+uint64_t Profiler::GetTimestamp()
+{
+    return FastClock::Now();
+}
+
+Profiler::ThreadBuffer& Profiler::GetThreadBuffer()
+{
+    if (!tls_ThreadBuffer.ThreadBuffer)
+    {
+        std::lock_guard<std::mutex> lock(m_ThreadBuffersMutex);
+
+        // Reuse the buffer of a thread that exited (the trace shows the
+        // new thread on the same track).
+        ThreadBuffer* threadBuffer = nullptr;
+        for (const auto& freeBuffer : m_ThreadBuffers)
+        {
+            if (freeBuffer->IsFree)
+            {
+                threadBuffer = freeBuffer.get();
+                threadBuffer->IsFree = false;
+                threadBuffer->IsActive.store(true, std::memory_order_relaxed);
+                break;
+            }
+        }
+
+        if (!threadBuffer)
+        {
+            uint32_t threadId = static_cast<uint32_t>(m_ThreadBuffers.size());
+            m_ThreadBuffers.push_back(std::make_unique<ThreadBuffer>(threadId));
+            threadBuffer = m_ThreadBuffers.back().get();
+        }
+
+        threadBuffer->Name = "Thread " + std::to_string(threadBuffer->ThreadId);
+        tls_ThreadBuffer.ThreadBuffer = threadBuffer;
+        tls_ThreadBuffer.IsActive = &threadBuffer->IsActive;
+    }
+
+    return *static_cast<ThreadBuffer*>(tls_ThreadBuffer.ThreadBuffer);
+}
+
+void Profiler::AddZone(const char* name, uint64_t start, uint64_t end)
+{
+    ThreadBuffer& threadBuffer = GetThreadBuffer();
+    if (!threadBuffer.Events.TryPush({ name, start, end }))
+    {
+        threadBuffer.NumDroppedZones.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void Profiler::SetThreadName(const std::string& name)
+{
+    ThreadBuffer& threadBuffer = GetThreadBuffer();
+
+    std::lock_guard<std::mutex> lock(m_ThreadBuffersMutex);
+    threadBuffer.Name = name;
+}
+
+void Profiler::BeginTrace(const std::string& fileName, uint32_t numFrames)
+{
+    std::lock_guard<std::mutex> lock(m_StatisticsMutex);
+
+    m_TraceEvents.clear();
+    m_TraceFileName = fileName;
+    m_TraceStart = GetTimestamp();
+    m_NumTraceFrames = numFrames;
+    m_TraceFrameCount = 0;
+}
+
+Profiler::Zone& Profiler::GetZone(const char* name)
+{
+    auto iter = m_ZoneIndices.find(name);
+    if (iter != m_ZoneIndices.end())
+    {
+        return m_Zones[iter->second];
+    }
+
+    // The same name can be stored at different addresses (for example, in different modules).
+    size_t index = 0;
+    while (index < m_Zones.size() && m_Zones[index].Name != name)
+    {
+        ++index;
+    }
+
+    if (index == m_Zones.size())
+    {
+        m_Zones.emplace_back();
+        m_Zones.back().Name = name;
+    }
+
+    m_ZoneIndices[name] = index;
+    return m_Zones[index];
+}
+
+bool Profiler::EndFrame()
+{
+    std::lock_guard<std::mutex> statisticsLock(m_StatisticsMutex);
+
+    bool isTracing = m_TraceFrameCount < m_NumTraceFrames;
+
+    // Threads that are added while the zones are collected are collected in the next frame.
+    size_t numThreadBuffers;
+    {
+        std::lock_guard<std::mutex> lock(m_ThreadBuffersMutex);
+        numThreadBuffers = m_ThreadBuffers.size();
+    }
+
+    for (size_t i = 0; i < numThreadBuffers; ++i)
+    {
+        ThreadBuffer* threadBuffer;
+        {
+            std::lock_guard<std::mutex> lock(m_ThreadBuffersMutex);
+            threadBuffer = m_ThreadBuffers[i].get();
+        }
+
+        // The zones of a thread that exited are collected before its buffer is reused.
+        bool wasActive = threadBuffer->IsActive.load(std::memory_order_acquire);
+
+        ZoneEvent event;
+        while (threadBuffer->Events.TryPop(event))
+        {
+            Zone& zone = GetZone(event.Name);
+            zone.FrameTime += event.End - event.Start;
+            zone.FrameCount++;
+
+            if (isTracing && event.Start >= m_TraceStart)
+            {
+                m_TraceEvents.push_back({ event.Name, event.Start, event.End, threadBuffer->ThreadId });
+            }
+        }
+
+        if (!wasActive)
+        {
+            std::lock_guard<std::mutex> lock(m_ThreadBuffersMutex);
+            // The buffer may have been reused by a new thread in the meantime.
+            if (!threadBuffer->IsActive.load(std::memory_order_relaxed))
+            {
+                threadBuffer->IsFree = true;
+            }
+        }
+    }
+
+    size_t historyIndex = m_FrameCount % NumHistoryFrames;
+    for (Zone& zone : m_Zones)
+    {
+        zone.Times[historyIndex] = zone.FrameTime;
+        zone.Counts[historyIndex] = zone.FrameCount;
+        zone.FrameTime = 0;
+        zone.FrameCount = 0;
+    }
+    m_FrameCount++;
+
+    if (isTracing && ++m_TraceFrameCount == m_NumTraceFrames)
+    {
+        bool written = WriteTrace();
+        m_TraceEvents.clear();
+        return written;
+    }
+
+    return true;
+}
+
+bool Profiler::WriteTrace() const
+{
+    std::ofstream file(m_TraceFileName);
+
+    file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+
+    {
+        std::lock_guard<std::mutex> lock(m_ThreadBuffersMutex);
+        for (const auto& threadBuffer : m_ThreadBuffers)
+        {
+            file << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << threadBuffer->ThreadId
+                << ",\"args\":{\"name\":";
+            WriteString(file, threadBuffer->Name);
+            file << "}},\n";
+        }
+    }
+
+    // Chrome traces use microseconds.
+    const double microsecondsPerTick = FastClock::GetSecondsPerTick() * 1e6;
+
+    char timestamps[64];
+    for (size_t i = 0; i < m_TraceEvents.size(); ++i)
+    {
+        const TraceEvent& event = m_TraceEvents[i];
+
+        snprintf(timestamps, sizeof(timestamps), "\"ts\":%.3f,\"dur\":%.3f",
+            (event.Start - m_TraceStart) * microsecondsPerTick, (event.End - event.Start) * microsecondsPerTick);
+
+        file << "{\"name\":";
+        WriteString(file, event.Name);
+        file << ",\"ph\":\"X\"," << timestamps << ",\"pid\":1,\"tid\":" << event.ThreadId << "}";
+        file << (i + 1 < m_TraceEvents.size() ? ",\n" : "\n");
+    }
+
+    file << "]}\n";
+
+    return static_cast<bool>(file);
+}
+
+std::vector<Profiler::ZoneStatistics> Profiler::GetStatistics() const
+{
+    std::lock_guard<std::mutex> lock(m_StatisticsMutex);
+
+    uint32_t numFrames = static_cast<uint32_t>(std::min<uint64_t>(m_FrameCount, NumHistoryFrames));
+    const double secondsPerTick = FastClock::GetSecondsPerTick();
+
+    std::vector<ZoneStatistics> statistics;
+    statistics.reserve(m_Zones.size());
+
+    for (const Zone& zone : m_Zones)
+    {
+        ZoneStatistics zoneStatistics;
+        zoneStatistics.Name = zone.Name;
+        zoneStatistics.NumFrames = numFrames;
+
+        if (numFrames > 0)
+        {
+            uint64_t totalTime = 0;
+            uint64_t totalCount = 0;
+            uint64_t minTime = ~0ull;
+            uint64_t maxTime = 0;
+            for (uint32_t i = 0; i < numFrames; ++i)
+            {
+                totalTime += zone.Times[i];
+                totalCount += zone.Counts[i];
+                minTime = std::min(minTime, zone.Times[i]);
+                maxTime = std::max(maxTime, zone.Times[i]);
+            }
+
+            zoneStatistics.CallsPerFrame = static_cast<double>(totalCount) / numFrames;
+            zoneStatistics.AverageTime = totalTime * secondsPerTick / numFrames;
+            zoneStatistics.MinTime = minTime * secondsPerTick;
+            zoneStatistics.MaxTime = maxTime * secondsPerTick;
+        }
+
+        statistics.push_back(zoneStatistics);
+    }
+
+    std::stable_sort(statistics.begin(), statistics.end(), [](const ZoneStatistics& a, const ZoneStatistics& b)
+    {
+        return a.AverageTime > b.AverageTime;
+    });
+
+    return statistics;
+}
+
+std::string Profiler::GetStatisticsTable() const
+{
+    std::vector<ZoneStatistics> statistics = GetStatistics();
+
+    std::string table;
+    char line[256];
+
+    snprintf(line, sizeof(line), "%-40s %10s %10s %10s %10s\n", "Zone", "Calls", "Avg (ms)", "Min (ms)", "Max (ms)");
+    table += line;
+
+    for (const ZoneStatistics& zone : statistics)
+    {
+        snprintf(line, sizeof(line), "%-40.40s %10.1f %10.3f %10.3f %10.3f\n", zone.Name.c_str(),
+            zone.CallsPerFrame, zone.AverageTime * 1e3, zone.MinTime * 1e3, zone.MaxTime * 1e3);
+        table += line;
+    }
+
+    return table;
+}
+
+uint64_t Profiler::GetNumDroppedZones() const
+{
+    std::lock_guard<std::mutex> lock(m_ThreadBuffersMutex);
+
+    uint64_t numDroppedZones = 0;
+    for (const auto& threadBuffer : m_ThreadBuffers)
+    {
+        numDroppedZones += threadBuffer->NumDroppedZones.load(std::memory_order_relaxed);
+    }
+    return numDroppedZones;
+}
+
+size_t Profiler::GetNumThreadBuffers() const
+{
+    std::lock_guard<std::mutex> lock(m_ThreadBuffersMutex);
+    return m_ThreadBuffers.size();
+}
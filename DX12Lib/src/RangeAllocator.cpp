@@ -0,0 +1,173 @@
+#include <RangeAllocator.h>
+
+#include <cassert>
+
+// Round the offset up to the next multiple of the alignment.
+static uint64_t AlignOffset( uint64_t offset, uint64_t alignment )
+{
+    return alignment > 1 ? ( ( offset + alignment - 1 ) / alignment ) * alignment : offset;
+}
+
+RangeAllocator::RangeAllocator( uint64_t size )
+    : m_Size( size )
+    , m_FreeSize( size )
+{
+    if ( size > 0 )
+    {
+        AddNewBlock( 0, size );
+    }
+}
+
+void RangeAllocator::AddNewBlock( uint64_t offset, uint64_t sizeInBytes )
+{
+    auto offsetIter = m_FreeListByOffset.emplace( offset, FreeBlockInfo{ sizeInBytes } );
+    auto sizeIter = m_FreeListBySize.emplace( sizeInBytes, offsetIter.first );
+    offsetIter.first->second.FreeListBySizeIt = sizeIter;
+}
+
+void RangeAllocator::RemoveBlock( uint64_t offset )
+{
+    auto offsetIter = m_FreeListByOffset.find( offset );
+    assert( offsetIter != m_FreeListByOffset.end() );
+
+    m_FreeListBySize.erase( offsetIter->second.FreeListBySizeIt );
+    m_FreeListByOffset.erase( offsetIter );
+}
+
+bool RangeAllocator::FindBlock( uint64_t sizeInBytes, uint64_t alignment, uint64_t& blockOffset, uint64_t& alignedOffset ) const
+{
+    // Start with the smallest block that could satisfy the request and
+    // continue with larger blocks until the alignment padding also fits.
+    for ( auto sizeIter = m_FreeListBySize.lower_bound( sizeInBytes ); sizeIter != m_FreeListBySize.end(); ++sizeIter )
+    {
+        uint64_t offset = sizeIter->second->first;
+        uint64_t size = sizeIter->first;
+        uint64_t aligned = AlignOffset( offset, alignment );
+
+        if ( aligned - offset + sizeInBytes <= size )
+        {
+            blockOffset = offset;
+            alignedOffset = aligned;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool RangeAllocator::HasSpace( uint64_t sizeInBytes, uint64_t alignment ) const
+{
+    uint64_t blockOffset, alignedOffset;
+    return FindBlock( sizeInBytes, alignment, blockOffset, alignedOffset );
+}
+
+uint64_t RangeAllocator::Allocate( uint64_t sizeInBytes, uint64_t alignment )
+{
+    uint64_t blockOffset, alignedOffset;
+    if ( sizeInBytes == 0 || !FindBlock( sizeInBytes, alignment, blockOffset, alignedOffset ) )
+    {
+        // There was no free block that could satisfy the request.
+        return InvalidOffset;
+    }
+
+    uint64_t blockSize = m_FreeListByOffset.find( blockOffset )->second.Size;
+
+    // Remove existing free block from the free list.
+    RemoveBlock( blockOffset );
+
+    // Return the padding in front of the aligned offset to the free list.
+    uint64_t padding = alignedOffset - blockOffset;
+    if ( padding > 0 )
+    {
+        AddNewBlock( blockOffset, padding );
+    }
+
+    // If the allocation didn't exactly match the requested size,
+    // return the left-over to the free list.
+    uint64_t remaining = blockSize - padding - sizeInBytes;
+    if ( remaining > 0 )
+    {
+        AddNewBlock( alignedOffset + sizeInBytes, remaining );
+    }
+
+    m_FreeSize -= sizeInBytes;
+    m_Allocations.emplace( alignedOffset, sizeInBytes );
+
+    return alignedOffset;
+}
+
+void RangeAllocator::Free( uint64_t offset, uint64_t sizeInBytes )
+{
+    auto allocationIter = m_Allocations.find( offset );
+    assert( allocationIter != m_Allocations.end() && allocationIter->second == sizeInBytes &&
+        "Invalid range passed to RangeAllocator::Free." );
+    if ( allocationIter == m_Allocations.end() || allocationIter->second != sizeInBytes )
+    {
+        return;
+    }
+    m_Allocations.erase( allocationIter );
+
+    // Find the first element whose offset is greater than the specified offset.
+    // This is the block that should appear after the block that is being freed.
+    auto nextBlockIter = m_FreeListByOffset.upper_bound( offset );
+
+    // Find the block that appears before the block being freed.
+    auto prevBlockIter = nextBlockIter;
+    if ( prevBlockIter != m_FreeListByOffset.begin() )
+    {
+        --prevBlockIter;
+    }
+    else
+    {
+        prevBlockIter = m_FreeListByOffset.end();
+    }
+
+    m_FreeSize += sizeInBytes;
+
+    if ( prevBlockIter != m_FreeListByOffset.end() &&
+        offset == prevBlockIter->first + prevBlockIter->second.Size )
+    {
+        // The previous block is exactly behind the block that is to be freed.
+        offset = prevBlockIter->first;
+        sizeInBytes += prevBlockIter->second.Size;
+
+        m_FreeListBySize.erase( prevBlockIter->second.FreeListBySizeIt );
+        m_FreeListByOffset.erase( prevBlockIter );
+    }
+
+    if ( nextBlockIter != m_FreeListByOffset.end() &&
+        offset + sizeInBytes == nextBlockIter->first )
+    {
+        // The next block is exactly in front of the block that is to be freed.
+        sizeInBytes += nextBlockIter->second.Size;
+
+        m_FreeListBySize.erase( nextBlockIter->second.FreeListBySizeIt );
+        m_FreeListByOffset.erase( nextBlockIter );
+    }
+
+    AddNewBlock( offset, sizeInBytes );
+}
+
+uint64_t RangeAllocator::GetSize() const
+{
+    return m_Size;
+}
+
+uint64_t RangeAllocator::GetFreeSize() const
+{
+    return m_FreeSize;
+}
+
+bool RangeAllocator::IsEmpty() const
+{
+    return m_FreeSize == m_Size;
+}
+
+uint32_t RangeAllocator::GetNumFreeBlocks() const
+{
+    return static_cast<uint32_t>( m_FreeListByOffset.size() );
+}
+
+uint32_t RangeAllocator::GetNumAllocations() const
+{
+    return static_cast<uint32_t>( m_Allocations.size() );
+}
@@ -0,0 +1,339 @@
+#include <ResourceStateTracker.h>
+
+#include <cassert>
+#include <iterator>
+
+// Static definitions.
+ResourceStateTracker::ResourceStateMap ResourceStateTracker::ms_GlobalResourceState;
+std::mutex ResourceStateTracker::ms_GlobalMutex;
+bool ResourceStateTracker::ms_IsLocked = false;
+
+// Used for (sub)resources whose state is not yet known on the command list.
+static const uint32_t UnknownState = static_cast<uint32_t>(-1);
+
+ResourceStateTracker::ResourceStateTracker()
+    : m_Statistics{}
+{}
+
+ResourceStateTracker::~ResourceStateTracker() {}
+
+void ResourceStateTracker::ResourceBarrier(const Barrier& barrier)
+{
+    if (barrier.Type == BarrierType::Transition)
+    {
+        const ResourceTransition& transitionBarrier = barrier.Transition;
+
+        m_Statistics.NumTransitions++;
+
+        // The first time a resource is used on the command list, its state is unknown.
+        auto iter = m_FinalResourceState.find(transitionBarrier.Resource);
+        if (iter == m_FinalResourceState.end())
+        {
+            iter = m_FinalResourceState.emplace(transitionBarrier.Resource, ResourceState(UnknownState)).first;
+        }
+
+        ResourceState& resourceState = iter->second;
+
+        // Transitions of (sub)resources in an unknown state are added to the
+        // pending resource barriers and resolved when the command list is executed.
+        PushTransition(m_ResourceBarriers, &m_PendingResourceBarriers, barrier, resourceState);
+
+        // Push the final known state (possibly replacing the previously known state for the subresource).
+        resourceState.SetSubresourceState(transitionBarrier.Subresource, transitionBarrier.StateAfter);
+    }
+    else
+    {
+        // Just push non-transition barriers to the resource barriers array.
+        m_ResourceBarriers.push_back(barrier);
+    }
+}
+
+void ResourceStateTracker::PushTransition(ResourceBarriers& barriers, ResourceBarriers* pendingBarriers, const Barrier& barrier, const ResourceState& resourceState)
+{
+    const ResourceTransition& transitionBarrier = barrier.Transition;
+
+    if (transitionBarrier.Subresource == AllSubresources && !resourceState.SubresourceState.empty())
+    {
+        // The subresources of the resource are in different states.
+        // Transition each subresource that is not already in the requested state.
+        uint32_t numSubresources = GetNumSubresources(transitionBarrier.Resource, resourceState);
+        for (uint32_t subresource = 0; subresource < numSubresources; ++subresource)
+        {
+            uint32_t stateBefore = resourceState.GetSubresourceState(subresource);
+
+            Barrier newBarrier = barrier;
+            newBarrier.Transition.Subresource = subresource;
+
+            if (stateBefore == UnknownState)
+            {
+                if (pendingBarriers)
+                {
+                    pendingBarriers->push_back(newBarrier);
+                }
+            }
+            else if (stateBefore != transitionBarrier.StateAfter)
+            {
+                newBarrier.Transition.StateBefore = stateBefore;
+                PushBarrier(barriers, newBarrier);
+            }
+        }
+    }
+    else
+    {
+        uint32_t stateBefore = resourceState.GetSubresourceState(transitionBarrier.Subresource);
+
+        if (stateBefore == UnknownState)
+        {
+            if (pendingBarriers)
+            {
+                pendingBarriers->push_back(barrier);
+            }
+        }
+        else if (stateBefore != transitionBarrier.StateAfter)
+        {
+            Barrier newBarrier = barrier;
+            newBarrier.Transition.StateBefore = stateBefore;
+            PushBarrier(barriers, newBarrier);
+        }
+        else
+        {
+            // The resource is already in the requested state.
+            m_Statistics.NumRedundantTransitions++;
+        }
+    }
+}
+
+void ResourceStateTracker::PushBarrier(ResourceBarriers& barriers, const Barrier& barrier)
+{
+    const ResourceTransition& transitionBarrier = barrier.Transition;
+
+    // Find the last barrier in the batch that affects the same resource.
+    // Since all barriers must be flushed before the resource is used, consecutive
+    // transitions of the same subresource (A -> B, B -> C) can be merged (A -> C).
+    for (auto iter = barriers.rbegin(); iter != barriers.rend(); ++iter)
+    {
+        if (iter->Type != BarrierType::Transition)
+        {
+            // Don't move transitions across UAV or aliasing barriers.
+            break;
+        }
+
+        ResourceTransition& previousBarrier = iter->Transition;
+        if (previousBarrier.Resource != transitionBarrier.Resource)
+        {
+            continue;
+        }
+
+        if (previousBarrier.Subresource == transitionBarrier.Subresource &&
+            previousBarrier.StateAfter == transitionBarrier.StateBefore &&
+            iter->Flags == BarrierFlagNone &&
+            barrier.Flags == BarrierFlagNone)
+        {
+            m_Statistics.NumMergedTransitions++;
+
+            previousBarrier.StateAfter = transitionBarrier.StateAfter;
+            if (previousBarrier.StateBefore == previousBarrier.StateAfter)
+            {
+                // The transitions cancel each other out.
+                barriers.erase(std::next(iter).base());
+            }
+            return;
+        }
+
+        // The previous transition affects another subresource of the same resource.
+        break;
+    }
+
+    barriers.push_back(barrier);
+}
+
+void ResourceStateTracker::TransitionResource(void* resource, uint32_t stateAfter, uint32_t subResource)
+{
+    if (resource)
+    {
+        Barrier barrier = {};
+        barrier.Type = BarrierType::Transition;
+        barrier.Flags = BarrierFlagNone;
+        barrier.Transition.Resource = resource;
+        barrier.Transition.Subresource = subResource;
+        barrier.Transition.StateBefore = CommonState;
+        barrier.Transition.StateAfter = stateAfter;
+        ResourceBarrier(barrier);
+    }
+}
+
+void ResourceStateTracker::UAVBarrier(void* resource)
+{
+    Barrier barrier = {};
+    barrier.Type = BarrierType::UAV;
+    barrier.Flags = BarrierFlagNone;
+    barrier.UAV.Resource = resource;
+    ResourceBarrier(barrier);
+}
+
+void ResourceStateTracker::AliasBarrier(void* resourceBefore, void* resourceAfter)
+{
+    Barrier barrier = {};
+    barrier.Type = BarrierType::Aliasing;
+    barrier.Flags = BarrierFlagNone;
+    barrier.Aliasing.ResourceBefore = resourceBefore;
+    barrier.Aliasing.ResourceAfter = resourceAfter;
+    ResourceBarrier(barrier);
+}
+
+uint32_t ResourceStateTracker::FlushResourceBarriers(const ResourceBarrierFunction& resourceBarrier)
+{
+    uint32_t numBarriers = static_cast<uint32_t>(m_ResourceBarriers.size());
+    if (numBarriers > 0)
+    {
+        resourceBarrier(numBarriers, m_ResourceBarriers.data());
+        m_ResourceBarriers.clear();
+
+        m_Statistics.NumBarriers += numBarriers;
+        m_Statistics.NumFlushes++;
+    }
+
+    return numBarriers;
+}
+
+uint32_t ResourceStateTracker::FlushPendingResourceBarriers(const ResourceBarrierFunction& resourceBarrier)
+{
+    assert(ms_IsLocked);
+
+    // Resolve the pending resource barriers by checking the global state of the
+    // (sub)resources. Add barriers if the pending state and the global state do
+    // not match.
+    ResourceBarriers resourceBarriers;
+    // Reserve enough space (worst-case, all pending barriers).
+    resourceBarriers.reserve(m_PendingResourceBarriers.size());
+
+    for (const Barrier& pendingBarrier : m_PendingResourceBarriers)
+    {
+        // Only transition barriers should be pending...
+        assert(pendingBarrier.Type == BarrierType::Transition);
+
+        auto iter = ms_GlobalResourceState.find(pendingBarrier.Transition.Resource);
+        // The state of a resource that was not added to the global resource state
+        // is unknown, so the transition can't be resolved.
+        assert(iter != ms_GlobalResourceState.end() && "The resource was not added to the global resource state.");
+        if (iter != ms_GlobalResourceState.end())
+        {
+            PushTransition(resourceBarriers, nullptr, pendingBarrier, iter->second);
+        }
+    }
+
+    uint32_t numBarriers = static_cast<uint32_t>(resourceBarriers.size());
+    if (numBarriers > 0)
+    {
+        resourceBarrier(numBarriers, resourceBarriers.data());
+
+        m_Statistics.NumBarriers += numBarriers;
+        m_Statistics.NumFlushes++;
+    }
+
+    m_PendingResourceBarriers.clear();
+
+    return numBarriers;
+}
+
+void ResourceStateTracker::CommitFinalResourceStates()
+{
+    assert(ms_IsLocked);
+
+    // Commit final resource states to the global resource state array (map).
+    for (const auto& resourceState : m_FinalResourceState)
+    {
+        const ResourceState& finalState = resourceState.second;
+
+        // Unknown resources were reported when the pending barriers were flushed.
+        // Don't add them to the global state (the resource may already be destroyed).
+        auto iter = ms_GlobalResourceState.find(resourceState.first);
+        if (iter == ms_GlobalResourceState.end())
+        {
+            continue;
+        }
+        ResourceState& globalState = iter->second;
+
+        if (finalState.State != UnknownState)
+        {
+            globalState.State = finalState.State;
+            globalState.SubresourceState = finalState.SubresourceState;
+        }
+        else
+        {
+            // Only some of the subresources were transitioned on the command list.
+            for (const auto& subresourceState : finalState.SubresourceState)
+            {
+                globalState.SetSubresourceState(subresourceState.first, subresourceState.second);
+            }
+        }
+    }
+
+    m_FinalResourceState.clear();
+}
+
+void ResourceStateTracker::Reset()
+{
+    // Reset the pending, current, and final resource states.
+    m_PendingResourceBarriers.clear();
+    m_ResourceBarriers.clear();
+    m_FinalResourceState.clear();
+    m_Statistics = {};
+}
+
+const ResourceStateTracker::Statistics& ResourceStateTracker::GetStatistics() const
+{
+    return m_Statistics;
+}
+
+void ResourceStateTracker::Lock()
+{
+    ms_GlobalMutex.lock();
+    ms_IsLocked = true;
+}
+
+void ResourceStateTracker::Unlock()
+{
+    ms_IsLocked = false;
+    ms_GlobalMutex.unlock();
+}
+
+void ResourceStateTracker::AddGlobalResourceState(void* resource, uint32_t state, uint32_t numSubresources)
+{
+    if (resource != nullptr)
+    {
+        std::lock_guard<std::mutex> lock(ms_GlobalMutex);
+        ms_GlobalResourceState[resource] = ResourceState(state, numSubresources);
+    }
+}
+
+void ResourceStateTracker::RemoveGlobalResourceState(void* resource)
+{
+    if (resource != nullptr)
+    {
+        std::lock_guard<std::mutex> lock(ms_GlobalMutex);
+        ms_GlobalResourceState.erase(resource);
+    }
+}
+
+bool ResourceStateTracker::HasGlobalResourceState(void* resource)
+{
+    std::lock_guard<std::mutex> lock(ms_GlobalMutex);
+    return ms_GlobalResourceState.find(resource) != ms_GlobalResourceState.end();
+}
+
+uint32_t ResourceStateTracker::GetNumSubresources(void* resource, const ResourceState& resourceState)
+{
+    if (resourceState.NumSubresources > 0)
+    {
+        return resourceState.NumSubresources;
+    }
+
+    // The state of a resource on a command list (only called while recording,
+    // the global state is not locked by this thread).
+    std::lock_guard<std::mutex> lock(ms_GlobalMutex);
+
+    auto iter = ms_GlobalResourceState.find(resource);
+    assert(iter != ms_GlobalResourceState.end() && "The resource was not added to the global resource state.");
+    return iter != ms_GlobalResourceState.end() ? iter->second.NumSubresources : 0;
+}
@@ -6,48 +6,55 @@
 
 using Microsoft::WRL::ComPtr;
 
-RootSignature::RootSignature()
-    : m_RootSignatureDesc{}, m_NumDescriptorsPerTable{0},
-      m_SamplerTableBitMask(0), m_DescriptorTableBitMask(0) {}
+static_assert(PackedRootSignatureDesc<D3D12_ROOT_SIGNATURE_DESC1>::DescriptorTableParameterType == D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE, "The parameter type must match D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE.");
+static_assert(PackedRootSignatureDesc<D3D12_ROOT_SIGNATURE_DESC1>::SamplerRangeType == D3D12_DESCRIPTOR_RANGE_TYPE_SAMPLER, "The range type must match D3D12_DESCRIPTOR_RANGE_TYPE_SAMPLER.");
+
+RootSignature::RootSignature() {}
 
 RootSignature::RootSignature(
     const D3D12_ROOT_SIGNATURE_DESC1& rootSignatureDesc, D3D_ROOT_SIGNATURE_VERSION rootSignatureVersion )
-    : m_RootSignatureDesc{}
-    , m_NumDescriptorsPerTable{ 0 }
-    , m_SamplerTableBitMask(0)
-    , m_DescriptorTableBitMask(0)
 {
     SetRootSignatureDesc(rootSignatureDesc, rootSignatureVersion);
 }
 
-RootSignature::~RootSignature()
+RootSignature::RootSignature(const RootSignature& copy)
+    : m_RootSignatureDesc(copy.m_RootSignatureDesc)
+    , m_RootSignature(copy.m_RootSignature)
+{}
+
+RootSignature::RootSignature(RootSignature&& copy) noexcept
+    : m_RootSignatureDesc(std::move(copy.m_RootSignatureDesc))
+    , m_RootSignature(std::move(copy.m_RootSignature))
+{}
+
+RootSignature& RootSignature::operator=(const RootSignature& other)
 {
-    Destroy();
+    m_RootSignatureDesc = other.m_RootSignatureDesc;
+    m_RootSignature = other.m_RootSignature;
+    return *this;
 }
 
-void RootSignature::Destroy()
+RootSignature& RootSignature::operator=(RootSignature&& other) noexcept
 {
-    for (UINT i = 0; i < m_RootSignatureDesc.NumParameters; ++i)
+    if (this != &other)
     {
-        const D3D12_ROOT_PARAMETER1& rootParameter = m_RootSignatureDesc.pParameters[i];
-        if (rootParameter.ParameterType == D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE)
-        {
-            delete[] rootParameter.DescriptorTable.pDescriptorRanges;
-        }
+        m_RootSignatureDesc = std::move(other.m_RootSignatureDesc);
+        m_RootSignature = std::move(other.m_RootSignature);
     }
+    return *this;
+}
 
-    delete[] m_RootSignatureDesc.pParameters; 
-    m_RootSignatureDesc.pParameters = nullptr;
-    m_RootSignatureDesc.NumParameters = 0;
-    
-    delete[] m_RootSignatureDesc.pStaticSamplers; 
-    m_RootSignatureDesc.pStaticSamplers = nullptr;
-    m_RootSignatureDesc.NumStaticSamplers = 0;
-
-    m_DescriptorTableBitMask = 0;
-    m_SamplerTableBitMask = 0;
+RootSignature::~RootSignature()
+{
+    Destroy();
+}
 
-    memset(m_NumDescriptorsPerTable, 0, sizeof(m_NumDescriptorsPerTable));
+void RootSignature::Destroy()
+{
+    // All of the parameters, descriptor ranges, and static samplers
+    // are released with the storage block.
+    m_RootSignatureDesc.Reset();
+    m_RootSignature.Reset();
 }
 
 void RootSignature::SetRootSignatureDesc(
@@ -60,69 +67,12 @@ void RootSignature::SetRootSignatureDesc(
 
     ComPtr<ID3D12Device2> device = Application::Get().GetDevice();
 
-    UINT numParameters = rootSignatureDesc.NumParameters;
-    D3D12_ROOT_PARAMETER1* pParameters = numParameters > 0 ? new D3D12_ROOT_PARAMETER1[numParameters] : nullptr;
-
-    for (UINT i = 0; i < numParameters; ++i)
-    {
-        const D3D12_ROOT_PARAMETER1& rootParameter = rootSignatureDesc.pParameters[i];
-        pParameters[i] = rootParameter;
-
-        if (rootParameter.ParameterType == D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE)
-        {
-            UINT numDescriptorRanges = rootParameter.DescriptorTable.NumDescriptorRanges;
-            D3D12_DESCRIPTOR_RANGE1* pDescriptorRanges = numDescriptorRanges > 0 ? new D3D12_DESCRIPTOR_RANGE1[numDescriptorRanges] : nullptr;
-
-            memcpy(pDescriptorRanges, rootParameter.DescriptorTable.pDescriptorRanges,
-                sizeof(D3D12_DESCRIPTOR_RANGE1) * numDescriptorRanges);
-
-            pParameters[i].DescriptorTable.NumDescriptorRanges = numDescriptorRanges;
-            pParameters[i].DescriptorTable.pDescriptorRanges = pDescriptorRanges;
-
-            // Set the bit mask depending on the type of descriptor table.
-            if (numDescriptorRanges > 0)
-            {
-                switch (pDescriptorRanges[0].RangeType)
-                {
-                    case D3D12_DESCRIPTOR_RANGE_TYPE_CBV:
-                    case D3D12_DESCRIPTOR_RANGE_TYPE_SRV:
-                    case D3D12_DESCRIPTOR_RANGE_TYPE_UAV:
-                        m_DescriptorTableBitMask |= (1 << i);
-                        break;
-                    case D3D12_DESCRIPTOR_RANGE_TYPE_SAMPLER:
-                        m_SamplerTableBitMask |= (1 << i);
-                        break;
-                }
-            }
-
-            // Count the number of descriptors in the descriptor table.
-            for (UINT j = 0; j < numDescriptorRanges; ++j)
-            {
-                m_NumDescriptorsPerTable[i] += pDescriptorRanges[j].NumDescriptors;
-            }
-        }
-    }
-
-    m_RootSignatureDesc.NumParameters = numParameters;
-    m_RootSignatureDesc.pParameters = pParameters;
-
-    UINT numStaticSamplers = rootSignatureDesc.NumStaticSamplers;
-    D3D12_STATIC_SAMPLER_DESC* pStaticSamplers = numStaticSamplers > 0 ? new D3D12_STATIC_SAMPLER_DESC[numStaticSamplers] : nullptr;
-
-    if ( pStaticSamplers )
-    {
-        memcpy( pStaticSamplers, rootSignatureDesc.pStaticSamplers,
-                sizeof( D3D12_STATIC_SAMPLER_DESC ) * numStaticSamplers );
-    }
-
-    m_RootSignatureDesc.NumStaticSamplers = numStaticSamplers;
-    m_RootSignatureDesc.pStaticSamplers = pStaticSamplers;
-
-    D3D12_ROOT_SIGNATURE_FLAGS flags = rootSignatureDesc.Flags;
-    m_RootSignatureDesc.Flags = flags;
+    m_RootSignatureDesc.Store(rootSignatureDesc);
 
+    const D3D12_ROOT_SIGNATURE_DESC1& desc = m_RootSignatureDesc.GetDesc();
     CD3DX12_VERSIONED_ROOT_SIGNATURE_DESC versionRootSignatureDesc;
-    versionRootSignatureDesc.Init_1_1(numParameters, pParameters, numStaticSamplers, pStaticSamplers, flags);
+    versionRootSignatureDesc.Init_1_1(desc.NumParameters, desc.pParameters,
+        desc.NumStaticSamplers, desc.pStaticSamplers, desc.Flags);
 
     // Serialize the root signature.
     ComPtr<ID3DBlob> rootSignatureBlob;
@@ -141,10 +91,10 @@ uint32_t RootSignature::GetDescriptorTableBitMask(D3D12_DESCRIPTOR_HEAP_TYPE des
     switch (descriptorHeapType)
     {
     case D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV:
-        descriptorTableBitMask = m_DescriptorTableBitMask;
+        descriptorTableBitMask = m_RootSignatureDesc.GetDescriptorTableBitMask();
         break;
     case D3D12_DESCRIPTOR_HEAP_TYPE_SAMPLER:
-        descriptorTableBitMask = m_SamplerTableBitMask;
+        descriptorTableBitMask = m_RootSignatureDesc.GetSamplerTableBitMask();
         break;
     }
 
@@ -154,5 +104,5 @@ uint32_t RootSignature::GetDescriptorTableBitMask(D3D12_DESCRIPTOR_HEAP_TYPE des
 uint32_t RootSignature::GetNumDescriptors(uint32_t rootIndex) const
 {
     ASSERT(rootIndex < 32);
-    return m_NumDescriptorsPerTable[rootIndex];
+    return m_RootSignatureDesc.GetNumDescriptors(rootIndex);
 }
@@ -0,0 +1,161 @@
+#include <DX12LibPCH.h>
+
+#include <RootSignatureCache.h>
+
+#include <RootSignature.h>
+
+static_assert(static_cast<uint32_t>(RootSignatureKey::Version::V1_1) == D3D_ROOT_SIGNATURE_VERSION_1_1, "Versions must match D3D_ROOT_SIGNATURE_VERSION.");
+static_assert(static_cast<uint32_t>(RootSignatureKey::ParameterType::UAV) == D3D12_ROOT_PARAMETER_TYPE_UAV, "Parameter types must match D3D12_ROOT_PARAMETER_TYPE.");
+static_assert(static_cast<uint32_t>(RootSignatureKey::DescriptorRangeType::Sampler) == D3D12_DESCRIPTOR_RANGE_TYPE_SAMPLER, "Descriptor range types must match D3D12_DESCRIPTOR_RANGE_TYPE.");
+static_assert(RootSignatureKey::DescriptorRangeOffsetAppend == D3D12_DESCRIPTOR_RANGE_OFFSET_APPEND, "The append offset must match D3D12_DESCRIPTOR_RANGE_OFFSET_APPEND.");
+static_assert(RootSignatureKey::UnboundedNumDescriptors == UINT_MAX, "Unbounded descriptor ranges must use UINT_MAX descriptors.");
+
+RootSignatureCache::RootSignatureCache()
+    : m_Statistics{}
+{}
+
+RootSignatureCache::~RootSignatureCache() {}
+
+RootSignatureKey RootSignatureCache::BuildKey(
+    const D3D12_ROOT_SIGNATURE_DESC1& rootSignatureDesc,
+    D3D_ROOT_SIGNATURE_VERSION rootSignatureVersion)
+{
+    RootSignatureKey key(static_cast<RootSignatureKey::Version>(rootSignatureVersion), rootSignatureDesc.Flags, rootSignatureDesc.NumParameters);
+
+    for (UINT i = 0; i < rootSignatureDesc.NumParameters; ++i)
+    {
+        const D3D12_ROOT_PARAMETER1& rootParameter = rootSignatureDesc.pParameters[i];
+
+        switch (rootParameter.ParameterType)
+        {
+        case D3D12_ROOT_PARAMETER_TYPE_DESCRIPTOR_TABLE:
+        {
+            const D3D12_ROOT_DESCRIPTOR_TABLE1& descriptorTable = rootParameter.DescriptorTable;
+            key.AddDescriptorTable(rootParameter.ShaderVisibility, descriptorTable.NumDescriptorRanges);
+
+            for (UINT j = 0; j < descriptorTable.NumDescriptorRanges; ++j)
+            {
+                const D3D12_DESCRIPTOR_RANGE1& descriptorRange = descriptorTable.pDescriptorRanges[j];
+                key.AddDescriptorRange({
+                    static_cast<RootSignatureKey::DescriptorRangeType>(descriptorRange.RangeType),
+                    descriptorRange.NumDescriptors,
+                    descriptorRange.BaseShaderRegister,
+                    descriptorRange.RegisterSpace,
+                    static_cast<uint32_t>(descriptorRange.Flags),
+                    descriptorRange.OffsetInDescriptorsFromTableStart });
+            }
+        }
+        break;
+        case D3D12_ROOT_PARAMETER_TYPE_32BIT_CONSTANTS:
+            key.AddConstants(rootParameter.ShaderVisibility, rootParameter.Constants.ShaderRegister,
+                rootParameter.Constants.RegisterSpace, rootParameter.Constants.Num32BitValues);
+            break;
+        case D3D12_ROOT_PARAMETER_TYPE_CBV:
+        case D3D12_ROOT_PARAMETER_TYPE_SRV:
+        case D3D12_ROOT_PARAMETER_TYPE_UAV:
+            key.AddDescriptor(static_cast<RootSignatureKey::ParameterType>(rootParameter.ParameterType), rootParameter.ShaderVisibility,
+                rootParameter.Descriptor.ShaderRegister, rootParameter.Descriptor.RegisterSpace, rootParameter.Descriptor.Flags);
+            break;
+        }
+    }
+
+    key.AddStaticSamplers(rootSignatureDesc.NumStaticSamplers);
+    for (UINT i = 0; i < rootSignatureDesc.NumStaticSamplers; ++i)
+    {
+        const D3D12_STATIC_SAMPLER_DESC& staticSampler = rootSignatureDesc.pStaticSamplers[i];
+        key.AddStaticSampler({
+            static_cast<uint32_t>(staticSampler.Filter),
+            static_cast<uint32_t>(staticSampler.AddressU),
+            static_cast<uint32_t>(staticSampler.AddressV),
+            static_cast<uint32_t>(staticSampler.AddressW),
+            staticSampler.MipLODBias,
+            staticSampler.MaxAnisotropy,
+            static_cast<uint32_t>(staticSampler.ComparisonFunc),
+            static_cast<uint32_t>(staticSampler.BorderColor),
+            staticSampler.MinLOD,
+            staticSampler.MaxLOD,
+            staticSampler.ShaderRegister,
+            staticSampler.RegisterSpace,
+            static_cast<uint32_t>(staticSampler.ShaderVisibility) });
+    }
+
+    return key;
+}
+
+uint64_t RootSignatureCache::ComputeHash(
+    const D3D12_ROOT_SIGNATURE_DESC1& rootSignatureDesc,
+    D3D_ROOT_SIGNATURE_VERSION rootSignatureVersion)
+{
+    return BuildKey(rootSignatureDesc, rootSignatureVersion).GetHash();
+}
+
+std::shared_ptr<RootSignature> RootSignatureCache::GetRootSignature(
+    const D3D12_ROOT_SIGNATURE_DESC1& rootSignatureDesc,
+    D3D_ROOT_SIGNATURE_VERSION rootSignatureVersion)
+{
+    RootSignatureKey key = BuildKey(rootSignatureDesc, rootSignatureVersion);
+    uint64_t hash = key.GetHash();
+
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+
+        std::shared_ptr<RootSignature> rootSignature = Find(hash, key);
+        if (rootSignature)
+        {
+            m_Statistics.NumHits++;
+            return rootSignature;
+        }
+    }
+
+    // The root signature is created without holding the lock so root
+    // signatures can be created on multiple threads.
+    std::shared_ptr<RootSignature> rootSignature = std::make_shared<RootSignature>(rootSignatureDesc, rootSignatureVersion);
+
+    std::lock_guard<std::mutex> lock(m_Mutex);
+
+    // Another thread may have created the same root signature in the meantime.
+    std::shared_ptr<RootSignature> existingRootSignature = Find(hash, key);
+    if (existingRootSignature)
+    {
+        m_Statistics.NumHits++;
+        return existingRootSignature;
+    }
+
+    m_Statistics.NumMisses++;
+    m_Statistics.NumRootSignatures++;
+
+    m_RootSignatures[hash].push_back(Entry{ std::move(key), rootSignature });
+
+    return rootSignature;
+}
+
+std::shared_ptr<RootSignature> RootSignatureCache::Find(uint64_t hash, const RootSignatureKey& key) const
+{
+    auto iter = m_RootSignatures.find(hash);
+    if (iter != m_RootSignatures.end())
+    {
+        for (const Entry& entry : iter->second)
+        {
+            if (entry.CanonicalDesc == key)
+            {
+                return entry.Instance;
+            }
+        }
+    }
+
+    return nullptr;
+}
+
+RootSignatureCache::Statistics RootSignatureCache::GetStatistics() const
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    return m_Statistics;
+}
+
+void RootSignatureCache::Clear()
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+
+    m_RootSignatures.clear();
+    m_Statistics.NumRootSignatures = 0;
+}
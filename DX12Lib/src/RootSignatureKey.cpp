@@ -0,0 +1,103 @@
+#include <RootSignatureKey.h>
+
+#include <Hash.h>
+
+#include <cassert>
+#include <cstring>
+
+RootSignatureKey::RootSignatureKey(Version version, uint32_t flags, uint32_t numParameters)
+    : m_Version(version)
+    , m_TableOffset(0)
+{
+    m_Values.push_back(static_cast<uint32_t>(version));
+    m_Values.push_back(flags);
+    m_Values.push_back(numParameters);
+}
+
+void RootSignatureKey::AddDescriptorTable(uint32_t shaderVisibility, uint32_t numRanges)
+{
+    m_Values.push_back(static_cast<uint32_t>(ParameterType::DescriptorTable));
+    m_Values.push_back(shaderVisibility);
+    m_Values.push_back(numRanges);
+
+    m_TableOffset = 0;
+}
+
+void RootSignatureKey::AddDescriptorRange(const DescriptorRange& descriptorRange)
+{
+    // Resolve appended ranges to explicit offsets from the start of the table.
+    if (descriptorRange.OffsetInDescriptorsFromTableStart != DescriptorRangeOffsetAppend)
+    {
+        m_TableOffset = descriptorRange.OffsetInDescriptorsFromTableStart;
+    }
+
+    m_Values.push_back(static_cast<uint32_t>(descriptorRange.RangeType));
+    m_Values.push_back(descriptorRange.NumDescriptors);
+    m_Values.push_back(descriptorRange.BaseShaderRegister);
+    m_Values.push_back(descriptorRange.RegisterSpace);
+    // Descriptor range flags are ignored by version 1.0 root signatures.
+    m_Values.push_back(m_Version == Version::V1_0 ? 0 : descriptorRange.Flags);
+    m_Values.push_back(m_TableOffset);
+
+    // An unbounded range must be the last range in the table.
+    if (descriptorRange.NumDescriptors != UnboundedNumDescriptors)
+    {
+        m_TableOffset += descriptorRange.NumDescriptors;
+    }
+}
+
+void RootSignatureKey::AddConstants(uint32_t shaderVisibility, uint32_t shaderRegister, uint32_t registerSpace, uint32_t num32BitValues)
+{
+    m_Values.push_back(static_cast<uint32_t>(ParameterType::Constants));
+    m_Values.push_back(shaderVisibility);
+    m_Values.push_back(shaderRegister);
+    m_Values.push_back(registerSpace);
+    m_Values.push_back(num32BitValues);
+}
+
+void RootSignatureKey::AddDescriptor(ParameterType type, uint32_t shaderVisibility, uint32_t shaderRegister, uint32_t registerSpace, uint32_t flags)
+{
+    assert(type == ParameterType::CBV || type == ParameterType::SRV || type == ParameterType::UAV);
+
+    m_Values.push_back(static_cast<uint32_t>(type));
+    m_Values.push_back(shaderVisibility);
+    m_Values.push_back(shaderRegister);
+    m_Values.push_back(registerSpace);
+    // Root descriptor flags are ignored by version 1.0 root signatures.
+    m_Values.push_back(m_Version == Version::V1_0 ? 0 : flags);
+}
+
+void RootSignatureKey::AddStaticSamplers(uint32_t numStaticSamplers)
+{
+    m_Values.push_back(numStaticSamplers);
+}
+
+void RootSignatureKey::AddStaticSampler(const StaticSampler& staticSampler)
+{
+    m_Values.push_back(staticSampler.Filter);
+    m_Values.push_back(staticSampler.AddressU);
+    m_Values.push_back(staticSampler.AddressV);
+    m_Values.push_back(staticSampler.AddressW);
+    AddFloat(staticSampler.MipLODBias);
+    m_Values.push_back(staticSampler.MaxAnisotropy);
+    m_Values.push_back(staticSampler.ComparisonFunc);
+    m_Values.push_back(staticSampler.BorderColor);
+    AddFloat(staticSampler.MinLOD);
+    AddFloat(staticSampler.MaxLOD);
+    m_Values.push_back(staticSampler.ShaderRegister);
+    m_Values.push_back(staticSampler.RegisterSpace);
+    m_Values.push_back(staticSampler.ShaderVisibility);
+}
+
+uint64_t RootSignatureKey::GetHash() const
+{
+    return HashBytes(m_Values.data(), m_Values.size() * sizeof(uint32_t));
+}
+
+// Add a float to the key using its bit pattern.
+void RootSignatureKey::AddFloat(float value)
+{
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    m_Values.push_back(bits);
+}
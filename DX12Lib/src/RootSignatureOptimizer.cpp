@@ -0,0 +1,326 @@
+#include <RootSignatureOptimizer.h>
+
+#include <algorithm>
+#include <cassert>
+#include <map>
+#include <tuple>
+
+namespace
+{
+    using Binding = RootSignatureOptimizer::Binding;
+    using BindingType = RootSignatureOptimizer::BindingType;
+    using ShaderVisibility = RootSignatureOptimizer::ShaderVisibility;
+    using UpdateFrequency = RootSignatureOptimizer::UpdateFrequency;
+    using ParameterType = RootSignatureOptimizer::ParameterType;
+    using RootParameter = RootSignatureOptimizer::RootParameter;
+    using DescriptorRange = RootSignatureOptimizer::DescriptorRange;
+    using BindingLocation = RootSignatureOptimizer::BindingLocation;
+
+    // Unbounded descriptor ranges can't be merged with the next range.
+    const uint32_t UnboundedNumDescriptors = RootSignatureOptimizer::UnboundedNumDescriptors;
+
+    uint32_t GetNumDWORDs(uint32_t sizeInBytes)
+    {
+        return (sizeInBytes + 3) / 4;
+    }
+
+    // Combine bindings that refer to the same register.
+    std::vector<Binding> MergeBindings(const std::vector<Binding>& bindings, std::vector<uint32_t>& bindingToUnique)
+    {
+        std::vector<Binding> uniqueBindings;
+        std::map<std::tuple<BindingType, uint32_t, uint32_t>, uint32_t> uniqueIndices;
+
+        bindingToUnique.resize(bindings.size());
+
+        for (size_t i = 0; i < bindings.size(); ++i)
+        {
+            const Binding& binding = bindings[i];
+            auto key = std::make_tuple(binding.Type, binding.RegisterSpace, binding.ShaderRegister);
+
+            auto iter = uniqueIndices.find(key);
+            if (iter == uniqueIndices.end())
+            {
+                iter = uniqueIndices.emplace(key, static_cast<uint32_t>(uniqueBindings.size())).first;
+                uniqueBindings.push_back(binding);
+            }
+            else
+            {
+                Binding& uniqueBinding = uniqueBindings[iter->second];
+                if (uniqueBinding.Visibility != binding.Visibility)
+                {
+                    uniqueBinding.Visibility = ShaderVisibility::All;
+                }
+                uniqueBinding.Frequency = std::max(uniqueBinding.Frequency, binding.Frequency);
+                uniqueBinding.NumDescriptors = std::max(uniqueBinding.NumDescriptors, binding.NumDescriptors);
+                uniqueBinding.SizeInBytes = std::max(uniqueBinding.SizeInBytes, binding.SizeInBytes);
+            }
+
+            bindingToUnique[i] = iter->second;
+        }
+
+        return uniqueBindings;
+    }
+
+    // Build the descriptor tables for the bindings that are not promoted to root constants.
+    // The location of each binding is stored in locations (the root parameter index is
+    // relative to the first table).
+    std::vector<RootParameter> BuildDescriptorTables(
+        const std::vector<Binding>& bindings,
+        const std::vector<bool>& isRootConstant,
+        bool mergeDescriptorTables,
+        std::vector<BindingLocation>& locations)
+    {
+        // Group the bindings by table. Samplers can't be in the same table as
+        // CBVs, SRVs, and UAVs since they are in a different descriptor heap.
+        // A table can only contain a single unbounded range (which must be the
+        // last range), so the second and later unbounded bindings of a group
+        // are placed in tables of their own.
+        using GroupKey = std::tuple<UpdateFrequency, ShaderVisibility, bool>;
+        using TableKey = std::tuple<UpdateFrequency, ShaderVisibility, bool, uint32_t>;
+        std::map< TableKey, std::vector<uint32_t> > tables;
+        std::map<GroupKey, uint32_t> numUnboundedBindings;
+
+        for (uint32_t i = 0; i < bindings.size(); ++i)
+        {
+            if (isRootConstant[i])
+            {
+                continue;
+            }
+
+            const Binding& binding = bindings[i];
+            GroupKey groupKey = std::make_tuple(binding.Frequency, binding.Visibility,
+                binding.Type == BindingType::Sampler);
+
+            uint32_t tableIndex = 0;
+            if (!mergeDescriptorTables)
+            {
+                tableIndex = i;
+            }
+            else if (binding.NumDescriptors == UnboundedNumDescriptors)
+            {
+                tableIndex = numUnboundedBindings[groupKey]++;
+            }
+
+            TableKey key = std::tuple_cat(groupKey, std::make_tuple(tableIndex));
+            tables[key].push_back(i);
+        }
+
+        std::vector<RootParameter> rootParameters;
+        rootParameters.reserve(tables.size());
+
+        for (auto& table : tables)
+        {
+            std::vector<uint32_t>& tableBindings = table.second;
+
+            // Sort the bindings so consecutive registers can be merged into a single range.
+            // The unbounded binding (if any) is sorted last since nothing can follow it.
+            std::sort(tableBindings.begin(), tableBindings.end(), [&bindings](uint32_t a, uint32_t b)
+            {
+                const Binding& lhs = bindings[a];
+                const Binding& rhs = bindings[b];
+                bool lhsUnbounded = lhs.NumDescriptors == UnboundedNumDescriptors;
+                bool rhsUnbounded = rhs.NumDescriptors == UnboundedNumDescriptors;
+                return std::make_tuple(lhsUnbounded, lhs.Type, lhs.RegisterSpace, lhs.ShaderRegister) <
+                    std::make_tuple(rhsUnbounded, rhs.Type, rhs.RegisterSpace, rhs.ShaderRegister);
+            });
+
+            RootParameter rootParameter = {};
+            rootParameter.Type = ParameterType::DescriptorTable;
+            rootParameter.Frequency = std::get<0>(table.first);
+            rootParameter.Visibility = std::get<1>(table.first);
+
+            uint32_t rootParameterIndex = static_cast<uint32_t>(rootParameters.size());
+            uint32_t offset = 0;
+
+            for (uint32_t bindingIndex : tableBindings)
+            {
+                const Binding& binding = bindings[bindingIndex];
+
+                bool merged = false;
+                if (!rootParameter.Ranges.empty())
+                {
+                    DescriptorRange& range = rootParameter.Ranges.back();
+                    if (range.Type == binding.Type &&
+                        range.RegisterSpace == binding.RegisterSpace &&
+                        range.NumDescriptors != UnboundedNumDescriptors &&
+                        range.BaseShaderRegister + range.NumDescriptors == binding.ShaderRegister)
+                    {
+                        range.NumDescriptors = binding.NumDescriptors == UnboundedNumDescriptors ?
+                            UnboundedNumDescriptors : range.NumDescriptors + binding.NumDescriptors;
+                        merged = true;
+                    }
+                }
+
+                if (!merged)
+                {
+                    DescriptorRange range = {};
+                    range.Type = binding.Type;
+                    range.NumDescriptors = binding.NumDescriptors;
+                    range.BaseShaderRegister = binding.ShaderRegister;
+                    range.RegisterSpace = binding.RegisterSpace;
+                    range.OffsetInDescriptorsFromTableStart = offset;
+                    rootParameter.Ranges.push_back(range);
+                }
+
+                locations[bindingIndex] = { rootParameterIndex, offset };
+
+                // An unbounded range must be the last range in a table.
+                assert(binding.NumDescriptors != UnboundedNumDescriptors || bindingIndex == tableBindings.back());
+                offset += binding.NumDescriptors;
+            }
+
+            rootParameters.push_back(std::move(rootParameter));
+        }
+
+        return rootParameters;
+    }
+}
+
+uint32_t RootSignatureOptimizer::GetDWORDCost(const RootParameter& rootParameter)
+{
+    switch (rootParameter.Type)
+    {
+    case ParameterType::DescriptorTable:
+        return 1;
+    case ParameterType::Constants:
+        return rootParameter.Num32BitValues;
+    default:
+        // Root descriptors are 64-bit GPU virtual addresses.
+        return 2;
+    }
+}
+
+RootSignatureOptimizer::Layout RootSignatureOptimizer::Optimize(const std::vector<Binding>& bindings)
+{
+    return Optimize(bindings, Settings());
+}
+
+RootSignatureOptimizer::Layout RootSignatureOptimizer::Optimize(const std::vector<Binding>& bindings, const Settings& settings)
+{
+    std::vector<uint32_t> bindingToUnique;
+    std::vector<Binding> uniqueBindings = MergeBindings(bindings, bindingToUnique);
+    uint32_t numBindings = static_cast<uint32_t>(uniqueBindings.size());
+
+    std::vector<bool> isRootConstant(numBindings, false);
+    std::vector<BindingLocation> tableLocations(numBindings);
+
+    auto computeCost = [&]()
+    {
+        uint32_t cost = static_cast<uint32_t>(BuildDescriptorTables(uniqueBindings, isRootConstant,
+            settings.MergeDescriptorTables, tableLocations).size());
+        for (uint32_t i = 0; i < numBindings; ++i)
+        {
+            if (isRootConstant[i])
+            {
+                cost += GetNumDWORDs(uniqueBindings[i].SizeInBytes);
+            }
+        }
+        return cost;
+    };
+
+    if (settings.PromoteRootConstants)
+    {
+        // Constant buffers that are small enough to fit in root constants.
+        std::vector<uint32_t> candidates;
+        for (uint32_t i = 0; i < numBindings; ++i)
+        {
+            const Binding& binding = uniqueBindings[i];
+            if (binding.Type == BindingType::CBV && binding.NumDescriptors == 1 && binding.SizeInBytes > 0 &&
+                GetNumDWORDs(binding.SizeInBytes) <= settings.MaxRootConstantDWORDs)
+            {
+                candidates.push_back(i);
+            }
+        }
+
+        // Promote the most frequently updated (and then the smallest) constant buffers first.
+        std::stable_sort(candidates.begin(), candidates.end(), [&uniqueBindings](uint32_t a, uint32_t b)
+        {
+            const Binding& lhs = uniqueBindings[a];
+            const Binding& rhs = uniqueBindings[b];
+            if (lhs.Frequency != rhs.Frequency)
+            {
+                return lhs.Frequency > rhs.Frequency;
+            }
+            return lhs.SizeInBytes < rhs.SizeInBytes;
+        });
+
+        for (uint32_t candidate : candidates)
+        {
+            isRootConstant[candidate] = true;
+            if (computeCost() > settings.MaxRootDWORDs)
+            {
+                isRootConstant[candidate] = false;
+            }
+        }
+    }
+
+    std::vector<RootParameter> rootParameters = BuildDescriptorTables(uniqueBindings, isRootConstant,
+        settings.MergeDescriptorTables, tableLocations);
+
+    // Index of the root parameter of each (unique) binding before sorting.
+    std::vector<uint32_t> parameterIndices(numBindings);
+    for (uint32_t i = 0; i < numBindings; ++i)
+    {
+        if (isRootConstant[i])
+        {
+            const Binding& binding = uniqueBindings[i];
+
+            RootParameter rootParameter = {};
+            rootParameter.Type = ParameterType::Constants;
+            rootParameter.Visibility = binding.Visibility;
+            rootParameter.Frequency = binding.Frequency;
+            rootParameter.ShaderRegister = binding.ShaderRegister;
+            rootParameter.RegisterSpace = binding.RegisterSpace;
+            rootParameter.Num32BitValues = GetNumDWORDs(binding.SizeInBytes);
+
+            parameterIndices[i] = static_cast<uint32_t>(rootParameters.size());
+            rootParameters.push_back(std::move(rootParameter));
+        }
+        else
+        {
+            parameterIndices[i] = tableLocations[i].RootParameterIndex;
+        }
+    }
+
+    // Sort the root parameters by update frequency (most frequent first).
+    // Root constants are placed before descriptor tables with the same frequency.
+    std::vector<uint32_t> order(rootParameters.size());
+    for (uint32_t i = 0; i < order.size(); ++i)
+    {
+        order[i] = i;
+    }
+
+    std::stable_sort(order.begin(), order.end(), [&rootParameters](uint32_t a, uint32_t b)
+    {
+        const RootParameter& lhs = rootParameters[a];
+        const RootParameter& rhs = rootParameters[b];
+        if (lhs.Frequency != rhs.Frequency)
+        {
+            return lhs.Frequency > rhs.Frequency;
+        }
+        return (lhs.Type == ParameterType::Constants) && (rhs.Type != ParameterType::Constants);
+    });
+
+    std::vector<uint32_t> newIndices(rootParameters.size());
+
+    Layout layout;
+    layout.Parameters.reserve(rootParameters.size());
+    for (uint32_t i = 0; i < order.size(); ++i)
+    {
+        newIndices[order[i]] = i;
+        layout.NumDWORDs += GetDWORDCost(rootParameters[order[i]]);
+        layout.Parameters.push_back(std::move(rootParameters[order[i]]));
+    }
+
+    layout.Remap.resize(bindings.size());
+    for (size_t i = 0; i < bindings.size(); ++i)
+    {
+        uint32_t uniqueIndex = bindingToUnique[i];
+
+        BindingLocation& location = layout.Remap[i];
+        location.RootParameterIndex = newIndices[parameterIndices[uniqueIndex]];
+        location.DescriptorOffset = isRootConstant[uniqueIndex] ? 0 : tableLocations[uniqueIndex].DescriptorOffset;
+    }
+
+    return layout;
+}
@@ -0,0 +1,265 @@
+#include <ShaderCompiler.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <system_error>
+
+namespace fs = std::filesystem;
+
+namespace
+{
+    // Quote an argument for the command processor.
+    std::string Quote(const std::string& argument)
+    {
+        std::string quoted = "\"";
+        for (char c : argument)
+        {
+            if (c == '"')
+            {
+                quoted += '\\';
+            }
+            quoted += c;
+        }
+        quoted += '"';
+        return quoted;
+    }
+
+    std::string ReadFile(const std::string& fileName)
+    {
+        std::ifstream file(fileName, std::ios::binary);
+        std::ostringstream contents;
+        contents << file.rdbuf();
+        return contents.str();
+    }
+}
+
+ShaderCompiler::ShaderCompiler(Backend backend, const std::string& compilerPath)
+    : m_Backend(backend)
+    , m_CompilerPath(compilerPath)
+{}
+
+bool ShaderCompiler::ParseBackend(const std::string& name, Backend& backend)
+{
+    if (name == "fxc")
+    {
+        backend = Backend::FXC;
+        return true;
+    }
+    if (name == "dxc")
+    {
+        backend = Backend::DXC;
+        return true;
+    }
+    return false;
+}
+
+std::string ShaderCompiler::GetProfile(const ShaderDesc& shaderDesc) const
+{
+    // Profiles have the form <stage>_<major>_<minor>.
+    if (m_Backend == Backend::DXC)
+    {
+        size_t separator = shaderDesc.Profile.find('_');
+        if (separator != std::string::npos)
+        {
+            int majorVersion = std::atoi(shaderDesc.Profile.c_str() + separator + 1);
+            if (majorVersion < 6)
+            {
+                return shaderDesc.Profile.substr(0, separator) + "_6_0";
+            }
+        }
+    }
+
+    return shaderDesc.Profile;
+}
+
+std::string ShaderCompiler::GetCompilerId() const
+{
+    std::ostringstream compilerId;
+    compilerId << (m_Backend == Backend::FXC ? "fxc" : "dxc") << ';' << m_CompilerPath;
+
+    std::error_code error;
+    fs::path compilerPath(m_CompilerPath);
+    uintmax_t fileSize = fs::file_size(compilerPath, error);
+    if (!error)
+    {
+        compilerId << ';' << fileSize;
+        fs::file_time_type lastWriteTime = fs::last_write_time(compilerPath, error);
+        if (!error)
+        {
+            compilerId << ';' << lastWriteTime.time_since_epoch().count();
+        }
+    }
+
+    return compilerId.str();
+}
+
+std::string ShaderCompiler::Option(const char* name) const
+{
+    return (m_Backend == Backend::FXC ? "/" : "-") + std::string(name);
+}
+
+std::vector<std::string> ShaderCompiler::GetPreprocessorOptions(const ShaderDesc& shaderDesc) const
+{
+    std::vector<std::string> options;
+
+    for (const std::string& define : shaderDesc.Defines)
+    {
+        options.push_back(Option("D"));
+        options.push_back(define);
+    }
+
+    for (const std::string& includeDir : shaderDesc.IncludeDirs)
+    {
+        options.push_back(Option("I"));
+        options.push_back(includeDir);
+    }
+
+    return options;
+}
+
+std::vector<std::string> ShaderCompiler::GetCompileOptions(const ShaderDesc& shaderDesc) const
+{
+    std::vector<std::string> options;
+
+    options.push_back(Option("T"));
+    options.push_back(GetProfile(shaderDesc));
+    options.push_back(Option("E"));
+    options.push_back(shaderDesc.EntryPoint);
+
+    if (shaderDesc.Debug)
+    {
+        options.push_back(Option("Od"));
+        options.push_back(Option("Zi"));
+        if (m_Backend == Backend::DXC)
+        {
+            // Keep the debug information in the bytecode (like FXC does).
+            options.push_back(Option("Qembed_debug"));
+        }
+    }
+
+    return options;
+}
+
+bool ShaderCompiler::Preprocess(const ShaderDesc& shaderDesc, const std::string& outputFile, std::string& errors) const
+{
+    std::vector<std::string> arguments = GetPreprocessorOptions(shaderDesc);
+
+    if (m_Backend == Backend::FXC)
+    {
+        arguments.push_back("/P");
+        arguments.push_back(outputFile);
+    }
+    else
+    {
+        arguments.push_back("-P");
+        arguments.push_back("-Fi");
+        arguments.push_back(outputFile);
+    }
+
+    arguments.push_back(shaderDesc.Source);
+
+    return Run(arguments, outputFile, errors);
+}
+
+std::vector<std::string> ShaderCompiler::GetSourceFiles(const std::string& preprocessedSource)
+{
+    std::vector<std::string> sourceFiles;
+
+    std::istringstream lines(preprocessedSource);
+    std::string line;
+    while (std::getline(lines, line))
+    {
+        // #line <number> "<file>" or # <number> "<file>" (the backslashes in
+        // the file name may be escaped).
+        size_t directive = line.find_first_not_of(" \t");
+        if (directive == std::string::npos || line[directive] != '#')
+        {
+            continue;
+        }
+        size_t number = line.find_first_not_of(" \t", line.compare(directive, 5, "#line") == 0 ? directive + 5 : directive + 1);
+        if (number == std::string::npos || !isdigit(static_cast<unsigned char>(line[number])))
+        {
+            continue;
+        }
+
+        size_t begin = line.find('"', directive);
+        size_t end = line.rfind('"');
+        if (begin == std::string::npos || end <= begin + 1)
+        {
+            continue;
+        }
+
+        std::string sourceFile;
+        for (size_t i = begin + 1; i < end; ++i)
+        {
+            if (line[i] == '\\' && i + 1 < end && line[i + 1] == '\\')
+            {
+                ++i;
+            }
+            sourceFile += line[i];
+        }
+
+        if (std::find(sourceFiles.begin(), sourceFiles.end(), sourceFile) == sourceFiles.end())
+        {
+            sourceFiles.push_back(sourceFile);
+        }
+    }
+
+    return sourceFiles;
+}
+
+bool ShaderCompiler::Compile(const ShaderDesc& shaderDesc, const std::string& outputFile, const std::string& listingFile, std::string& errors) const
+{
+    std::vector<std::string> arguments = GetCompileOptions(shaderDesc);
+
+    std::vector<std::string> preprocessorOptions = GetPreprocessorOptions(shaderDesc);
+    arguments.insert(arguments.end(), preprocessorOptions.begin(), preprocessorOptions.end());
+
+    arguments.push_back(Option("Fo"));
+    arguments.push_back(outputFile);
+    if (!listingFile.empty())
+    {
+        arguments.push_back(Option("Fc"));
+        arguments.push_back(listingFile);
+    }
+    arguments.push_back(shaderDesc.Source);
+
+    if (!Run(arguments, outputFile, errors))
+    {
+        return false;
+    }
+
+    std::error_code error;
+    return listingFile.empty() || fs::exists(listingFile, error);
+}
+
+bool ShaderCompiler::Run(const std::vector<std::string>& arguments, const std::string& outputFile, std::string& output) const
+{
+    std::string logFile = outputFile + ".log";
+
+    std::string commandLine = Quote(m_CompilerPath);
+    for (const std::string& argument : arguments)
+    {
+        commandLine += ' ';
+        commandLine += Quote(argument);
+    }
+    commandLine += " > " + Quote(logFile) + " 2>&1";
+
+#if defined(_WIN32)
+    // cmd.exe strips the outer quotes of the command line.
+    commandLine = "\"" + commandLine + "\"";
+#endif
+
+    int exitCode = std::system(commandLine.c_str());
+
+    output = ReadFile(logFile);
+
+    std::error_code error;
+    fs::remove(logFile, error);
+
+    return exitCode == 0 && fs::exists(outputFile, error);
+}
@@ -0,0 +1,125 @@
+#include <ShaderDependencyGraph.h>
+
+#include <system_error>
+
+namespace fs = std::filesystem;
+
+fs::path ShaderDependencyGraph::NormalizePath(const fs::path& path)
+{
+    std::error_code error;
+    fs::path canonicalPath = fs::weakly_canonical(path, error);
+    return error ? path.lexically_normal() : canonicalPath;
+}
+
+void ShaderDependencyGraph::SetShaderFiles(ShaderId shader, const std::vector<fs::path>& files)
+{
+    // Remove the previous files of the shader.
+    auto iter = m_ShaderFiles.find(shader);
+    if (iter != m_ShaderFiles.end())
+    {
+        for (const fs::path& file : iter->second)
+        {
+            auto fileShaders = m_FileShaders.find(file);
+            if (fileShaders != m_FileShaders.end())
+            {
+                fileShaders->second.erase(shader);
+                if (fileShaders->second.empty())
+                {
+                    m_FileShaders.erase(fileShaders);
+                }
+            }
+        }
+    }
+
+    std::vector<fs::path>& shaderFiles = m_ShaderFiles[shader];
+    shaderFiles.clear();
+    for (const fs::path& file : files)
+    {
+        fs::path normalizedFile = NormalizePath(file);
+        if (m_FileShaders[normalizedFile].insert(shader).second)
+        {
+            shaderFiles.push_back(normalizedFile);
+        }
+    }
+}
+
+void ShaderDependencyGraph::SetPipelineShaders(PipelineId pipeline, const std::vector<ShaderId>& shaders)
+{
+    RemovePipeline(pipeline);
+
+    m_PipelineShaders[pipeline] = shaders;
+    for (ShaderId shader : shaders)
+    {
+        m_ShaderPipelines[shader].insert(pipeline);
+    }
+}
+
+void ShaderDependencyGraph::RemovePipeline(PipelineId pipeline)
+{
+    auto iter = m_PipelineShaders.find(pipeline);
+    if (iter == m_PipelineShaders.end())
+    {
+        return;
+    }
+
+    for (ShaderId shader : iter->second)
+    {
+        auto shaderPipelines = m_ShaderPipelines.find(shader);
+        if (shaderPipelines != m_ShaderPipelines.end())
+        {
+            shaderPipelines->second.erase(pipeline);
+            if (shaderPipelines->second.empty())
+            {
+                m_ShaderPipelines.erase(shaderPipelines);
+            }
+        }
+    }
+
+    m_PipelineShaders.erase(iter);
+}
+
+std::set<ShaderDependencyGraph::ShaderId> ShaderDependencyGraph::GetShaders(const std::vector<fs::path>& files) const
+{
+    std::set<ShaderId> shaders;
+    for (const fs::path& file : files)
+    {
+        auto iter = m_FileShaders.find(NormalizePath(file));
+        if (iter != m_FileShaders.end())
+        {
+            shaders.insert(iter->second.begin(), iter->second.end());
+        }
+    }
+    return shaders;
+}
+
+std::set<ShaderDependencyGraph::PipelineId> ShaderDependencyGraph::GetPipelines(const std::set<ShaderId>& shaders) const
+{
+    std::set<PipelineId> pipelines;
+    for (ShaderId shader : shaders)
+    {
+        auto iter = m_ShaderPipelines.find(shader);
+        if (iter != m_ShaderPipelines.end())
+        {
+            pipelines.insert(iter->second.begin(), iter->second.end());
+        }
+    }
+    return pipelines;
+}
+
+const std::vector<ShaderDependencyGraph::ShaderId>& ShaderDependencyGraph::GetPipelineShaders(PipelineId pipeline) const
+{
+    static const std::vector<ShaderId> NoShaders;
+
+    auto iter = m_PipelineShaders.find(pipeline);
+    return iter != m_PipelineShaders.end() ? iter->second : NoShaders;
+}
+
+std::set<fs::path> ShaderDependencyGraph::GetDirectories() const
+{
+    std::set<fs::path> directories;
+    for (const auto& file : m_FileShaders)
+    {
+        directories.insert(file.first.parent_path());
+    }
+    return directories;
+}
@@ -0,0 +1,364 @@
+#include <DX12LibPCH.h>
+
+#include <ShaderReloader.h>
+
+#include <ShaderCompiler.h>
+#include <ThreadPool.h>
+
+#include <atomic>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <system_error>
+
+namespace fs = std::filesystem;
+
+namespace
+{
+    std::string ReadFile(const fs::path& fileName)
+    {
+        std::ifstream file(fileName, std::ios::binary);
+        std::ostringstream contents;
+        contents << file.rdbuf();
+        return contents.str();
+    }
+
+    // The compiler the shader was built with.
+    bool GetCompiler(const ShaderReloader::ShaderDesc& shaderDesc, ShaderCompiler::Backend& backend)
+    {
+        return !shaderDesc.CompilerPath.empty() && ShaderCompiler::ParseBackend(shaderDesc.Backend, backend);
+    }
+
+    // The description of the shader for the compiler.
+    ShaderDesc GetCompilerDesc(const ShaderReloader::ShaderDesc& shaderDesc)
+    {
+        ShaderDesc compilerDesc;
+        compilerDesc.Source = shaderDesc.SourceFile.string();
+        compilerDesc.EntryPoint = shaderDesc.EntryPoint;
+        compilerDesc.Profile = shaderDesc.Profile;
+        compilerDesc.Debug = shaderDesc.Debug;
+        return compilerDesc;
+    }
+
+    // A temporary file for the output of the compiler. Shaders are preprocessed
+    // on the main thread and compiled on the thread pool, so each file gets a
+    // unique name.
+    std::string GetTemporaryFile(const ShaderReloader::ShaderDesc& shaderDesc, const char* extension)
+    {
+        static std::atomic<uint32_t> s_NextFileId(0);
+
+        std::error_code error;
+        fs::path directory = fs::temp_directory_path(error);
+        fs::path fileName = shaderDesc.BytecodeFile.stem();
+        fileName += ".reload" + std::to_string(s_NextFileId++);
+        fileName += extension;
+        return (directory / fileName).string();
+    }
+
+    void OutputErrors(const fs::path& sourceFile, const std::string& errors)
+    {
+        std::ostringstream message;
+        message << "Failed to reload shader " << sourceFile.string() << ":\n" << errors << "\n";
+        OutputDebugStringA(message.str().c_str());
+    }
+}
+
+ShaderReloader::ShaderReloader(std::shared_ptr<ThreadPool> threadPool)
+    : m_ThreadPool(threadPool)
+    , m_NextPipelineId(0)
+    , m_Statistics{}
+{}
+
+ShaderReloader::~ShaderReloader()
+{
+    Wait();
+}
+
+ShaderReloader::ShaderId ShaderReloader::AddShader(const ShaderDesc& shaderDesc)
+{
+    Shader shader;
+    shader.Desc = shaderDesc;
+    ThrowIfFailed(D3DReadFileToBlob(shaderDesc.BytecodeFile.c_str(), &shader.Bytecode));
+
+    ShaderId id = static_cast<ShaderId>(m_Shaders.size());
+    m_Shaders.push_back(shader);
+
+    // Preprocess the source to find the files that are included by the shader.
+    // Shaders without a source file or a compiler (for example, if the
+    // application does not run from the build tree) are not reloaded.
+    std::string errors;
+    std::vector<fs::path> files = GetShaderFiles(shaderDesc, errors);
+    if (!files.empty())
+    {
+        m_DependencyGraph.SetShaderFiles(id, files);
+
+        WatchDirectories();
+    }
+
+    return id;
+}
+
+ComPtr<ID3DBlob> ShaderReloader::GetBytecode(ShaderId shader) const
+{
+    return m_Shaders[shader].Bytecode;
+}
+
+ShaderReloader::PipelineId ShaderReloader::AddPipeline(const std::vector<ShaderId>& shaders, PipelineBuilder builder)
+{
+    PipelineId id = m_NextPipelineId++;
+    m_Pipelines[id] = std::move(builder);
+    m_DependencyGraph.SetPipelineShaders(id, shaders);
+
+    return id;
+}
+
+void ShaderReloader::RemovePipeline(PipelineId pipeline)
+{
+    // The builder may be running on the thread pool.
+    Wait();
+
+    m_Pipelines.erase(pipeline);
+    m_DependencyGraph.RemovePipeline(pipeline);
+}
+
+void ShaderReloader::Update()
+{
+    std::vector<fs::path> changedFiles = m_FileWatcher.Poll();
+    if (!changedFiles.empty())
+    {
+        m_ChangedFiles.insert(m_ChangedFiles.end(), changedFiles.begin(), changedFiles.end());
+        m_LastChangeTime = std::chrono::steady_clock::now();
+    }
+
+    if (m_Reload.valid())
+    {
+        if (m_Reload.wait_for(std::chrono::seconds(0)) != std::future_status::ready)
+        {
+            return;
+        }
+
+        ReloadResult result = m_Reload.get();
+        FinishReload(result);
+    }
+
+    if (!m_ChangedFiles.empty() && std::chrono::steady_clock::now() - m_LastChangeTime >= SettleTime)
+    {
+        StartReload();
+    }
+}
+
+void ShaderReloader::Wait()
+{
+    if (m_Reload.valid())
+    {
+        m_Reload.wait();
+    }
+}
+
+void ShaderReloader::StartReload()
+{
+    std::set<ShaderId> shaderIds = m_DependencyGraph.GetShaders(m_ChangedFiles);
+    m_ChangedFiles.clear();
+
+    if (shaderIds.empty())
+    {
+        return;
+    }
+
+    m_Statistics.NumReloads++;
+
+    // Copy everything the background task needs, so the shaders and
+    // pipelines can be modified while the reload is in progress.
+    std::vector< std::pair<ShaderId, ShaderDesc> > shaders;
+    for (ShaderId id : shaderIds)
+    {
+        shaders.emplace_back(id, m_Shaders[id].Desc);
+    }
+
+    struct Pipeline
+    {
+        PipelineId Id;
+        PipelineBuilder Builder;
+        std::vector<ShaderId> ShaderIds;
+        // The current bytecode of the shaders (replaced by the recompiled shaders).
+        Bytecode Shaders;
+    };
+
+    std::vector<Pipeline> pipelines;
+    for (PipelineId id : m_DependencyGraph.GetPipelines(shaderIds))
+    {
+        Pipeline pipeline;
+        pipeline.Id = id;
+        pipeline.Builder = m_Pipelines[id];
+        pipeline.ShaderIds = m_DependencyGraph.GetPipelineShaders(id);
+        for (ShaderId shader : pipeline.ShaderIds)
+        {
+            pipeline.Shaders.push_back(m_Shaders[shader].Bytecode);
+        }
+        pipelines.push_back(std::move(pipeline));
+    }
+
+    m_Reload = m_ThreadPool->Submit([shaders, pipelines]() mutable
+    {
+        ReloadResult result;
+
+        std::map<ShaderId, ComPtr<ID3DBlob>> compiledShaders;
+        std::set<ShaderId> failedShaders;
+        for (const auto& shader : shaders)
+        {
+            result.Shaders.push_back(CompileShader(shader.first, shader.second));
+            if (result.Shaders.back().Bytecode)
+            {
+                compiledShaders[shader.first] = result.Shaders.back().Bytecode;
+            }
+            else
+            {
+                failedShaders.insert(shader.first);
+            }
+        }
+
+        for (Pipeline& pipeline : pipelines)
+        {
+            bool failed = false;
+            for (size_t i = 0; i < pipeline.ShaderIds.size(); ++i)
+            {
+                ShaderId shader = pipeline.ShaderIds[i];
+                failed = failed || failedShaders.count(shader) > 0;
+
+                auto compiledShader = compiledShaders.find(shader);
+                if (compiledShader != compiledShaders.end())
+                {
+                    pipeline.Shaders[i] = compiledShader->second;
+                }
+            }
+
+            // Keep the current pipeline if one of its shaders failed to compile.
+            if (failed)
+            {
+                continue;
+            }
+
+            try
+            {
+                result.Pipelines.push_back({ pipeline.Id, pipeline.Builder(pipeline.Shaders) });
+            }
+            catch (const std::exception& e)
+            {
+                OutputDebugStringA("Failed to rebuild pipeline: ");
+                OutputDebugStringA(e.what());
+                OutputDebugStringA("\n");
+            }
+        }
+
+        return result;
+    });
+}
+
+void ShaderReloader::FinishReload(ReloadResult& result)
+{
+    for (CompiledShader& compiledShader : result.Shaders)
+    {
+        Shader& shader = m_Shaders[compiledShader.Id];
+        if (compiledShader.Bytecode)
+        {
+            shader.Bytecode = compiledShader.Bytecode;
+            m_Statistics.NumCompiledShaders++;
+        }
+        else
+        {
+            OutputErrors(shader.Desc.SourceFile, compiledShader.Errors);
+            m_Statistics.NumFailedShaders++;
+        }
+
+        // The includes may have changed (also if the shader failed to compile).
+        if (!compiledShader.Files.empty())
+        {
+            m_DependencyGraph.SetShaderFiles(compiledShader.Id, compiledShader.Files);
+        }
+    }
+
+    WatchDirectories();
+
+    // Swap in the new pipelines (unless they were removed in the meantime).
+    for (RebuiltPipeline& pipeline : result.Pipelines)
+    {
+        if (pipeline.Commit && m_Pipelines.count(pipeline.Id) > 0)
+        {
+            pipeline.Commit();
+            m_Statistics.NumRebuiltPipelines++;
+        }
+    }
+}
+
+void ShaderReloader::WatchDirectories()
+{
+    for (const fs::path& directory : m_DependencyGraph.GetDirectories())
+    {
+        m_FileWatcher.AddDirectory(directory);
+    }
+}
+
+std::vector<fs::path> ShaderReloader::GetShaderFiles(const ShaderDesc& shaderDesc, std::string& errors)
+{
+    ShaderCompiler::Backend backend;
+    if (!GetCompiler(shaderDesc, backend))
+    {
+        errors = "No shader compiler.";
+        return {};
+    }
+
+    ShaderCompiler compiler(backend, shaderDesc.CompilerPath.string());
+
+    std::string preprocessedFile = GetTemporaryFile(shaderDesc, ".hlsl.i");
+    if (!compiler.Preprocess(GetCompilerDesc(shaderDesc), preprocessedFile, errors))
+    {
+        return {};
+    }
+
+    std::string preprocessedSource = ReadFile(preprocessedFile);
+    std::error_code error;
+    fs::remove(preprocessedFile, error);
+
+    std::vector<fs::path> files = { shaderDesc.SourceFile };
+    for (const std::string& sourceFile : ShaderCompiler::GetSourceFiles(preprocessedSource))
+    {
+        files.push_back(sourceFile);
+    }
+
+    return files;
+}
+
+ShaderReloader::CompiledShader ShaderReloader::CompileShader(ShaderId id, const ShaderDesc& shaderDesc)
+{
+    CompiledShader compiledShader;
+    compiledShader.Id = id;
+
+    // If the shader can't be preprocessed (for example, the file is still
+    // being written by the editor), the includes are unknown and the
+    // previous files of the shader are kept.
+    compiledShader.Files = GetShaderFiles(shaderDesc, compiledShader.Errors);
+    if (compiledShader.Files.empty())
+    {
+        return compiledShader;
+    }
+
+    ShaderCompiler::Backend backend;
+    GetCompiler(shaderDesc, backend);
+    ShaderCompiler compiler(backend, shaderDesc.CompilerPath.string());
+
+    // Shaders are compiled with the same compiler and options as the ShaderBuild tool uses.
+    std::string outputFile = GetTemporaryFile(shaderDesc, ".cso");
+    if (compiler.Compile(GetCompilerDesc(shaderDesc), outputFile, std::string(), compiledShader.Errors))
+    {
+        if (FAILED(D3DReadFileToBlob(fs::path(outputFile).c_str(), &compiledShader.Bytecode)))
+        {
+            compiledShader.Bytecode.Reset();
+            compiledShader.Errors = "Failed to read " + outputFile + ".";
+        }
+    }
+
+    std::error_code error;
+    fs::remove(outputFile, error);
+
+    return compiledShader;
+}
@@ -0,0 +1,97 @@
+#include <ThreadPool.h>
+
+#include <Profiler.h>
+
+#include <algorithm>
+
+ThreadPool::ThreadPool(size_t numThreads)
+    : m_NumPendingTasks(0)
+    , m_Stop(false)
+{
+    if (numThreads == 0)
+    {
+        // Leave one hardware thread for the main thread.
+        size_t numHardwareThreads = std::thread::hardware_concurrency();
+        numThreads = std::max<size_t>(numHardwareThreads, 2) - 1;
+    }
+
+    m_Threads.reserve(numThreads);
+    for (size_t i = 0; i < numThreads; ++i)
+    {
+        m_Threads.emplace_back(&ThreadPool::WorkerThread, this);
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    WaitIdle();
+
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Stop = true;
+    }
+    m_TaskAvailable.notify_all();
+
+    for (std::thread& thread : m_Threads)
+    {
+        thread.join();
+    }
+}
+
+void ThreadPool::Enqueue(std::function<void()> task)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Tasks.push(std::move(task));
+        ++m_NumPendingTasks;
+    }
+    m_TaskAvailable.notify_one();
+}
+
+void ThreadPool::WaitIdle()
+{
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    m_Idle.wait(lock, [this]() { return m_NumPendingTasks == 0; });
+}
+
+size_t ThreadPool::GetNumPendingTasks() const
+{
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    return m_NumPendingTasks;
+}
+
+void ThreadPool::WorkerThread()
+{
+    Profiler::Get().SetThreadName("Thread Pool");
+
+    while (true)
+    {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(m_Mutex);
+            m_TaskAvailable.wait(lock, [this]() { return m_Stop || !m_Tasks.empty(); });
+
+            if (m_Tasks.empty())
+            {
+                // Stopped and all tasks are done.
+                return;
+            }
+
+            task = std::move(m_Tasks.front());
+            m_Tasks.pop();
+        }
+
+        // Exceptions are stored in the future of the task.
+        task();
+
+        bool idle = false;
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            idle = --m_NumPendingTasks == 0;
+        }
+        if (idle)
+        {
+            m_Idle.notify_all();
+        }
+    }
+}
@@ -0,0 +1,188 @@
+#include <TimestampQueryRing.h>
+
+#include <cassert>
+#include <cstdio>
+
+TimestampQueryRing::TimestampQueryRing()
+    : TimestampQueryRing(Settings())
+{}
+
+TimestampQueryRing::TimestampQueryRing(const Settings& settings)
+    : m_Settings(settings)
+    , m_Frames(settings.NumFrames)
+    , m_CurrentFrame(0)
+    , m_ResolveFrame(0)
+    , m_IsRecording(false)
+    , m_NumResolvedFrames(0)
+    , m_NumSkippedFrames(0)
+    , m_NumDroppedScopes(0)
+{
+    assert(settings.NumFrames > 0 && settings.MaxScopesPerFrame > 0);
+}
+
+uint32_t TimestampQueryRing::GetNumQueries() const
+{
+    return m_Settings.NumFrames * m_Settings.MaxScopesPerFrame * 2;
+}
+
+void TimestampQueryRing::Resolve(uint64_t completedFenceValue, const uint64_t* timestamps, uint64_t frequency)
+{
+    // The regions are submitted in order, so they complete in order.
+    while (m_Frames[m_ResolveFrame].State == FrameState::Submitted &&
+           m_Frames[m_ResolveFrame].FenceValue <= completedFenceValue)
+    {
+        Frame& frame = m_Frames[m_ResolveFrame];
+
+        m_Timings.clear();
+        for (const Scope& scope : frame.Scopes)
+        {
+            uint64_t begin = timestamps[scope.BeginQuery];
+            uint64_t end = timestamps[scope.EndQuery];
+
+            ScopeTiming timing;
+            timing.Name = scope.Name;
+            timing.Depth = scope.Depth;
+            // Timestamps from different queues (or after a GPU clock change) can be out of order.
+            timing.Time = end > begin ? static_cast<double>(end - begin) / static_cast<double>(frequency) : 0.0;
+            m_Timings.push_back(std::move(timing));
+        }
+
+        frame.State = FrameState::Free;
+        m_NumResolvedFrames++;
+
+        m_ResolveFrame = (m_ResolveFrame + 1) % m_Settings.NumFrames;
+    }
+}
+
+void TimestampQueryRing::BeginFrame()
+{
+    assert(!m_IsRecording && "EndFrame was not called.");
+
+    Frame& frame = m_Frames[m_CurrentFrame];
+    if (frame.State != FrameState::Free)
+    {
+        // The GPU has not finished the frame that used the region. Don't wait for it.
+        m_NumSkippedFrames++;
+        return;
+    }
+
+    frame.State = FrameState::Recording;
+    frame.NumQueries = 0;
+    frame.Scopes.clear();
+    m_IsRecording = true;
+}
+
+uint32_t TimestampQueryRing::BeginScope(const std::string& name)
+{
+    Frame& frame = m_Frames[m_CurrentFrame];
+    uint32_t depth = static_cast<uint32_t>(m_OpenScopes.size());
+
+    if (!m_IsRecording || frame.NumQueries + 2 > m_Settings.MaxScopesPerFrame * 2)
+    {
+        if (m_IsRecording)
+        {
+            m_NumDroppedScopes++;
+        }
+        m_OpenScopes.push_back(InvalidQuery);
+        return InvalidQuery;
+    }
+
+    // Both queries are reserved so the queries of a scope are next to each other.
+    uint32_t firstQuery = m_CurrentFrame * m_Settings.MaxScopesPerFrame * 2 + frame.NumQueries;
+    frame.NumQueries += 2;
+    frame.Scopes.push_back({ name, depth, firstQuery, firstQuery + 1 });
+
+    m_OpenScopes.push_back(static_cast<uint32_t>(frame.Scopes.size() - 1));
+    return firstQuery;
+}
+
+uint32_t TimestampQueryRing::EndScope()
+{
+    assert(!m_OpenScopes.empty() && "EndScope without BeginScope.");
+
+    uint32_t scope = m_OpenScopes.back();
+    m_OpenScopes.pop_back();
+
+    if (scope == InvalidQuery)
+    {
+        return InvalidQuery;
+    }
+
+    return m_Frames[m_CurrentFrame].Scopes[scope].EndQuery;
+}
+
+void TimestampQueryRing::EndFrame(uint32_t& firstQuery, uint32_t& numQueries)
+{
+    assert(m_OpenScopes.empty() && "A scope was not ended.");
+    m_OpenScopes.clear();
+
+    firstQuery = 0;
+    numQueries = 0;
+
+    if (!m_IsRecording)
+    {
+        return;
+    }
+    m_IsRecording = false;
+
+    Frame& frame = m_Frames[m_CurrentFrame];
+    if (frame.NumQueries == 0)
+    {
+        // Nothing to resolve; the region is used for the next frame.
+        frame.State = FrameState::Free;
+        return;
+    }
+
+    frame.State = FrameState::Closed;
+    firstQuery = m_CurrentFrame * m_Settings.MaxScopesPerFrame * 2;
+    numQueries = frame.NumQueries;
+}
+
+void TimestampQueryRing::Submit(uint64_t fenceValue)
+{
+    Frame& frame = m_Frames[m_CurrentFrame];
+    assert(frame.State == FrameState::Closed && "Submit without queries to resolve.");
+
+    frame.State = FrameState::Submitted;
+    frame.FenceValue = fenceValue;
+
+    m_CurrentFrame = (m_CurrentFrame + 1) % m_Settings.NumFrames;
+}
+
+const std::vector<TimestampQueryRing::ScopeTiming>& TimestampQueryRing::GetTimings() const
+{
+    return m_Timings;
+}
+
+std::string TimestampQueryRing::GetTimingsTable() const
+{
+    std::string table;
+    char line[256];
+
+    snprintf(line, sizeof(line), "%-40s %10s\n", "GPU Scope", "Time (ms)");
+    table += line;
+
+    for (const ScopeTiming& timing : m_Timings)
+    {
+        std::string name = std::string(timing.Depth * 2, ' ') + timing.Name;
+        snprintf(line, sizeof(line), "%-40.40s %10.3f\n", name.c_str(), timing.Time * 1e3);
+        table += line;
+    }
+
+    return table;
+}
+
+uint64_t TimestampQueryRing::GetNumResolvedFrames() const
+{
+    return m_NumResolvedFrames;
+}
+
+uint64_t TimestampQueryRing::GetNumSkippedFrames() const
+{
+    return m_NumSkippedFrames;
+}
+
+uint64_t TimestampQueryRing::GetNumDroppedScopes() const
+{
+    return m_NumDroppedScopes;
+}
@@ -1,19 +1,39 @@
 #include <UploadBuffer.h>
-#include <Application.h>
-#include <DX12LibPCH.h>
+#include <FrameCapture.h>
+#include <Profiler.h>
 
-using Microsoft::WRL::ComPtr;
+#include <new>
 
-UploadBuffer::UploadBuffer(size_t pageSize) : m_PageSize(pageSize) {}
+namespace
+{
+    // Matches Math::AlignUp (the alignment must be a power of two).
+    size_t AlignUp(size_t value, size_t alignment)
+    {
+        return (value + alignment - 1) & ~(alignment - 1);
+    }
+}
+
+UploadBuffer::UploadBuffer(Device& device, size_t pageSize)
+    : m_Device(device)
+    , m_PageSize(pageSize)
+{}
 
 UploadBuffer::~UploadBuffer() {}
 
 UploadBuffer::Allocation UploadBuffer::Allocate(size_t sizeInBytes, size_t alignment) 
 {
+    PROFILE_FUNCTION();
+
     if (sizeInBytes > m_PageSize)
     {
         throw std::bad_alloc();
     }
+
+    if (FrameCapture* frameCapture = m_Device.GetFrameCapture())
+    {
+        frameCapture->Record(FrameCapture::Call::AllocateUpload, { sizeInBytes, alignment });
+    }
+
     // If there is no current page, or the requested allocation exceeds the
     // remaining space in the current page, request a new page.
     if (!m_CurrentPage || !m_CurrentPage->HasSpace(sizeInBytes, alignment))
@@ -34,7 +54,7 @@ std::shared_ptr< UploadBuffer::Page > UploadBuffer::RequestPage()
     }
     else
     {
-        page = std::make_shared<Page>(m_PageSize);
+        page = std::make_shared<Page>(m_Device, m_PageSize);
         m_PagePool.push_back(page);
     }
     return page;
@@ -42,6 +62,11 @@ std::shared_ptr< UploadBuffer::Page > UploadBuffer::RequestPage()
 
 void UploadBuffer::Reset() 
 {
+    if (FrameCapture* frameCapture = m_Device.GetFrameCapture())
+    {
+        frameCapture->Record(FrameCapture::Call::ResetUploadBuffer, {});
+    }
+
     m_CurrentPage = nullptr;    
 
     // Reset all available pages.
@@ -53,51 +78,33 @@ void UploadBuffer::Reset()
     }
 }
 
-UploadBuffer::Page::Page(size_t sizeInBytes) 
+UploadBuffer::Page::Page(Device& device, size_t sizeInBytes) 
     : m_PageSize(sizeInBytes)
     , m_Offset(0)
-    , m_CPUPtr(nullptr)
-    , m_GPUPtr(D3D12_GPU_VIRTUAL_ADDRESS(0))
-{
-    ComPtr<ID3D12Device2> device = Application::Get().GetDevice();
-    CD3DX12_HEAP_PROPERTIES uploadHeapProps =
-        CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD);
-
-    CD3DX12_RESOURCE_DESC bufferDesc = CD3DX12_RESOURCE_DESC::Buffer(m_PageSize);
-
-    ThrowIfFailed(device->CreateCommittedResource(
-        &CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD), D3D12_HEAP_FLAG_NONE,
-        &CD3DX12_RESOURCE_DESC::Buffer(m_PageSize),
-        D3D12_RESOURCE_STATE_GENERIC_READ, nullptr,
-        IID_PPV_ARGS(&m_d3d12Resource)));
-
-    m_GPUPtr = m_d3d12Resource->GetGPUVirtualAddress();
-    m_d3d12Resource->Map(0, nullptr, &m_CPUPtr);
-}
-
-UploadBuffer::Page::~Page()
 {
-    m_d3d12Resource->Unmap(0, nullptr);
-    m_CPUPtr = nullptr;
-    m_GPUPtr = D3D12_GPU_VIRTUAL_ADDRESS(0);
+    m_Resource = device.CreateUploadBuffer(m_PageSize);
+    m_CPUPtr = m_Resource->Map();
+    m_GPUPtr = m_Resource->GetGPUVirtualAddress();
 }
 
 bool UploadBuffer::Page::HasSpace(size_t sizeInBytes, size_t alignment) const
 {
-    size_t alignedSize   = Math::AlignUp(sizeInBytes, alignment);
-    size_t alignedOffset = Math::AlignUp(m_Offset, alignment);
+    size_t alignedSize   = AlignUp(sizeInBytes, alignment);
+    size_t alignedOffset = AlignUp(m_Offset, alignment);
  
     return alignedOffset + alignedSize <= m_PageSize;
 }
 
 UploadBuffer::Allocation UploadBuffer::Page::Allocate(size_t sizeInBytes, size_t alignment) 
 {
-    size_t alignedSize = Math::AlignUp(sizeInBytes, alignment);
-    m_Offset = Math::AlignUp(m_Offset, alignment);
+    size_t alignedSize = AlignUp(sizeInBytes, alignment);
+    m_Offset = AlignUp(m_Offset, alignment);
  
     Allocation allocation;
     allocation.CPU = static_cast<uint8_t*>(m_CPUPtr) + m_Offset;
     allocation.GPU = m_GPUPtr + m_Offset;
+    allocation.Resource = m_Resource.get();
+    allocation.Offset = m_Offset;
  
     m_Offset += alignedSize;
  
@@ -0,0 +1,37 @@
+#include <DX12LibPCH.h>
+
+#include <Win32Platform.h>
+
+#include <FastClock.h>
+
+int Win32Platform::Run()
+{
+    MSG msg = { 0 };
+    while (msg.message != WM_QUIT)
+    {
+        if (PeekMessage(&msg, 0, 0, 0, PM_REMOVE))
+        {
+            TranslateMessage(&msg);
+            DispatchMessage(&msg);
+        }
+    }
+    return static_cast<int>(msg.wParam);
+}
+
+void Win32Platform::Quit(int exitCode)
+{
+    PostQuitMessage(exitCode);
+}
+
+double Win32Platform::GetTime() const
+{
+    return FastClock::GetSeconds();
+}
+
+void Win32Platform::AddWindow(PlatformWindow*)
+{
+    // Windows receive their messages through the window procedure.
+}
+
+void Win32Platform::RemoveWindow(PlatformWindow*)
+{}
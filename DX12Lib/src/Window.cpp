@@ -1,8 +1,28 @@
 #include <DX12LibPCH.h>
 #include <Application.h>
 #include <CommandQueue.h>
+#include <D3D12Device.h>
+#include <FastClock.h>
+#include <FrameCapture.h>
 #include <Window.h>
 #include <Game.h>
+#include <GpuProfiler.h>
+#include <Profiler.h>
+#include <ResourceStateTracker.h>
+#include <ShaderReloader.h>
+
+// Publish the input events [first, last), which all hold an Event, as a batch.
+template<typename Event>
+static void PublishInputEvents(EventBus& eventBus, std::vector<Event>& batch,
+    const std::vector<InputQueue::Event>& events, size_t first, size_t last)
+{
+    batch.clear();
+    for (size_t i = first; i < last; ++i)
+    {
+        batch.push_back(std::get<Event>(events[i]));
+    }
+    eventBus.Publish(batch.data(), batch.size());
+}
 
 Window::Window(HWND hWnd, const std::wstring& windowName, int clientWidth, int clientHeight, bool vSync )
     : m_hWnd(hWnd)
@@ -12,6 +32,9 @@ Window::Window(HWND hWnd, const std::wstring& windowName, int clientWidth, int c
     , m_VSync(vSync)
     , m_Fullscreen(false)
     , m_FrameCounter(0)
+    , m_FixedStep(false)
+    , m_FrameLatencyWaitableObject(nullptr)
+    , m_WaitForFrameLatency(false)
 {
     Application& app = Application::Get();
 
@@ -61,6 +84,16 @@ void Window::Destroy()
         // Notify the registered game that the window is being destroyed.
         pGame->OnWindowDestroy();
     }
+    UnregisterGameListeners();
+    for (int i = 0; i < BufferCount; ++i)
+    {
+        ResourceStateTracker::RemoveGlobalResourceState(m_d3d12BackBuffers[i].Get());
+    }
+    if (m_FrameLatencyWaitableObject)
+    {
+        ::CloseHandle(m_FrameLatencyWaitableObject);
+        m_FrameLatencyWaitableObject = nullptr;
+    }
     if (m_hWnd)
     {
         DestroyWindow(m_hWnd);
@@ -157,81 +190,248 @@ void Window::ToggleFullscreen()
 
 void Window::RegisterCallbacks(std::shared_ptr<Game> pGame)
 {
+    UnregisterGameListeners();
     m_pGame = pGame;
-    return;
+
+    // The game destroys the window before it is destroyed itself (see Game::Destroy),
+    // so the listeners can refer to the game without locking a weak_ptr for each event.
+    Game* game = pGame.get();
+    m_GameListeners.push_back(m_EventBus.Subscribe<KeyEventArgs>([](void* context, KeyEventArgs& e)
+    {
+        Game* game = static_cast<Game*>(context);
+        if (e.State == KeyEventArgs::Pressed)
+        {
+            game->OnKeyPressed(e);
+        }
+        else
+        {
+            game->OnKeyReleased(e);
+        }
+    }, game));
+    m_GameListeners.push_back(m_EventBus.Subscribe<&Game::OnMouseMoved>(game));
+    m_GameListeners.push_back(m_EventBus.Subscribe<MouseButtonEventArgs>([](void* context, MouseButtonEventArgs& e)
+    {
+        Game* game = static_cast<Game*>(context);
+        if (e.State == MouseButtonEventArgs::Pressed)
+        {
+            game->OnMouseButtonPressed(e);
+        }
+        else
+        {
+            game->OnMouseButtonReleased(e);
+        }
+    }, game));
+    m_GameListeners.push_back(m_EventBus.Subscribe<&Game::OnMouseWheel>(game));
+}
+
+void Window::UnregisterGameListeners()
+{
+    for (EventBus::ListenerHandle listener : m_GameListeners)
+    {
+        m_EventBus.Unsubscribe(listener);
+    }
+    m_GameListeners.clear();
+}
+
+EventBus& Window::GetEventBus()
+{
+    return m_EventBus;
 }
 
 void Window::OnUpdate(UpdateEventArgs&)
 {
+    PROFILE_FUNCTION();
+
+    // Input is handled before the game is updated.
+    DispatchInputEvents();
+
     m_UpdateClock.Tick();
     if (auto pGame = m_pGame.lock())
     {
+        // The first delta includes the time since the window was created.
+        if (m_FrameCounter > 0)
+        {
+            m_UpdateFrameStats.AddSample(m_UpdateClock.GetDeltaSeconds());
+        }
         m_FrameCounter++;
-        UpdateEventArgs updateEventArgs(m_UpdateClock.GetDeltaSeconds(), m_UpdateClock.GetTotalSeconds());
-        pGame->OnUpdate(updateEventArgs);
+
+        if (m_FixedStep)
+        {
+            // The steps follow the platform clock (the headless platform
+            // simulates the time, so the steps are deterministic).
+            uint32_t numSteps = m_FixedStepScheduler.BeginFrame(Application::Get().GetPlatform().GetTime());
+            double stepDuration = m_FixedStepScheduler.GetStepDuration();
+            uint64_t firstStep = m_FixedStepScheduler.GetStepCount() - numSteps;
+            for (uint32_t i = 0; i < numSteps; ++i)
+            {
+                UpdateEventArgs updateEventArgs(stepDuration, (firstStep + i + 1) * stepDuration);
+                pGame->OnUpdate(updateEventArgs);
+            }
+        }
+        else
+        {
+            UpdateEventArgs updateEventArgs(m_UpdateClock.GetDeltaSeconds(), m_UpdateClock.GetTotalSeconds());
+            pGame->OnUpdate(updateEventArgs);
+        }
     }
 }
 
 void Window::OnRender(RenderEventArgs&)
 {
+    PROFILE_FUNCTION();
+
+    double gpuWaitTime, pacingWaitTime;
+    WaitForNextFrame(gpuWaitTime, pacingWaitTime);
+
+    // The frames that were retired by the wait no longer use their stale allocations.
+    Application::Get().ReleaseStaleAllocations();
+
     m_RenderClock.Tick();
+    // The first frame is rendered after the first update.
+    if (m_FrameCounter > 1)
+    {
+        m_RenderFrameStats.AddSample(m_RenderClock.GetDeltaSeconds());
+    }
 
     if (auto pGame = m_pGame.lock())
     {
-        RenderEventArgs renderEventArgs(m_RenderClock.GetDeltaSeconds(), m_RenderClock.GetTotalSeconds());
+        // The frame is ended when the game presents it (see Window::Present).
+        uint64_t completedFenceValue = Application::Get().GetCommandQueue()->GetCompletedFenceValue();
+        m_FramePacer.BeginFrame(FastClock::GetSeconds(), gpuWaitTime, pacingWaitTime, completedFenceValue);
+
+        GpuProfiler& gpuProfiler = Application::Get().GetGpuProfiler();
+        gpuProfiler.BeginFrame();
+
+        double alpha = m_FixedStep ? m_FixedStepScheduler.GetAlpha() : 1.0;
+        RenderEventArgs renderEventArgs(m_RenderClock.GetDeltaSeconds(), m_RenderClock.GetTotalSeconds(), alpha);
         pGame->OnRender(renderEventArgs);
+
+        gpuProfiler.EndFrame();
     }
 }
 
-void Window::OnKeyPressed(KeyEventArgs& e)
+void Window::WaitForNextFrame(double& gpuWaitTime, double& pacingWaitTime)
 {
-    if (auto pGame = m_pGame.lock())
+    PROFILE_FUNCTION();
+
+    const FramePacer::Settings& settings = m_FramePacer.GetSettings();
+    double t0 = FastClock::GetSeconds();
+
+    // Limit the number of frames that are queued on the GPU.
+    uint64_t fenceValue = m_FramePacer.GetFenceValueToWait();
+    if (fenceValue > 0)
     {
-        pGame->OnKeyPressed(e);
+        Application::Get().GetCommandQueue()->WaitForFenceValue(fenceValue);
     }
-}
 
-void Window::OnKeyReleased(KeyEventArgs& e)
-{
-    if (auto pGame = m_pGame.lock())
+    double t1 = FastClock::GetSeconds();
+    gpuWaitTime = t1 - t0;
+
+    // Wait until the swapchain is ready to accept a new frame. This keeps
+    // the time between input sampling and presentation as low as possible.
+    // The object is only signaled by presents, so there is nothing to wait
+    // for if the last frame did not present (for example, when minimized).
+    if (settings.WaitableSwapChain && m_FrameLatencyWaitableObject && m_WaitForFrameLatency)
     {
-        pGame->OnKeyReleased(e);
+        ::WaitForSingleObjectEx(m_FrameLatencyWaitableObject, 1000, TRUE);
     }
-}
+    m_WaitForFrameLatency = false;
 
-// The mouse was moved
-void Window::OnMouseMoved(MouseMotionEventArgs& e)
-{
-    if (auto pGame = m_pGame.lock())
+    // Respect the CPU frame-time budget.
+    double now = FastClock::GetSeconds();
+    double delay = m_FramePacer.GetPacingDelay(now);
+    if (delay > 0.0)
     {
-        pGame->OnMouseMoved(e);
+        double deadline = now + delay;
+        // Sleep is only accurate to the scheduler quantum so the last 
+        // couple of milliseconds are spent spinning.
+        if (delay > 0.002)
+        {
+            std::this_thread::sleep_for(std::chrono::duration<double>(delay - 0.002));
+        }
+        while (FastClock::GetSeconds() < deadline)
+        {
+            std::this_thread::yield();
+        }
     }
+
+    pacingWaitTime = FastClock::GetSeconds() - t1;
 }
 
-// A button on the mouse was pressed
-void Window::OnMouseButtonPressed(MouseButtonEventArgs& e)
+void Window::QueueInputEvent(const InputQueue::Event& e)
 {
-    if (auto pGame = m_pGame.lock())
-    {
-        pGame->OnMouseButtonPressed(e);
-    }
+    m_InputQueue.Push(e);
 }
 
-// A button on the mouse was released
-void Window::OnMouseButtonReleased(MouseButtonEventArgs& e)
+void Window::Resize(int width, int height)
 {
-    if (auto pGame = m_pGame.lock())
+    ResizeEventArgs resizeEventArgs(width, height);
+    OnResize(resizeEventArgs);
+}
+
+void Window::Frame()
+{
+    // Swap in the pipelines that were rebuilt with reloaded shaders at the
+    // frame boundary (the headless platform calls Frame directly).
+    Application::Get().GetShaderReloader()->Update();
+
+    {
+        PROFILE_SCOPE("Frame");
+
+        // Delta time will be filled in by the Window.
+        UpdateEventArgs updateEventArgs(0.0f, 0.0f);
+        OnUpdate(updateEventArgs);
+        RenderEventArgs renderEventArgs(0.0f, 0.0f);
+        // Delta time will be filled in by the Window.
+        OnRender(renderEventArgs);
+    }
+
+    if (!Application::Get().GetFrameCapture().EndFrame())
+    {
+        OutputDebugStringA("Failed to write the frame capture.\n");
+    }
+    if (!Profiler::Get().EndFrame())
     {
-        pGame->OnMouseButtonReleased(e);
+        OutputDebugStringA("Failed to write the profiler trace.\n");
     }
 }
 
-// The mouse wheel was moved.
-void Window::OnMouseWheel(MouseWheelEventArgs& e)
+void Window::DispatchInputEvents()
 {
-    if (auto pGame = m_pGame.lock())
+    m_InputEvents.clear();
+    m_InputQueue.PopAll(m_InputEvents);
+
+    // Consecutive events of the same type are published as a batch, so the
+    // events are still dispatched in the order they were received.
+    size_t first = 0;
+    while (first < m_InputEvents.size())
     {
-        pGame->OnMouseWheel(e);
+        const InputQueue::Event& event = m_InputEvents[first];
+
+        size_t last = first + 1;
+        while (last < m_InputEvents.size() && m_InputEvents[last].index() == event.index())
+        {
+            ++last;
+        }
+
+        if (std::holds_alternative<KeyEventArgs>(event))
+        {
+            PublishInputEvents(m_EventBus, m_KeyEvents, m_InputEvents, first, last);
+        }
+        else if (std::holds_alternative<MouseMotionEventArgs>(event))
+        {
+            PublishInputEvents(m_EventBus, m_MouseMotionEvents, m_InputEvents, first, last);
+        }
+        else if (std::holds_alternative<MouseButtonEventArgs>(event))
+        {
+            PublishInputEvents(m_EventBus, m_MouseButtonEvents, m_InputEvents, first, last);
+        }
+        else if (std::holds_alternative<MouseWheelEventArgs>(event))
+        {
+            PublishInputEvents(m_EventBus, m_MouseWheelEvents, m_InputEvents, first, last);
+        }
+
+        first = last;
     }
 }
 
@@ -244,9 +444,12 @@ void Window::OnResize(ResizeEventArgs& e)
         m_ClientHeight = std::max(1, e.Height);
 
         Application::Get().Flush();
+        // All queued frames have been retired by the flush.
+        m_FramePacer.Reset();
 
         for (int i = 0; i < BufferCount; ++i)
         {
+            ResourceStateTracker::RemoveGlobalResourceState(m_d3d12BackBuffers[i].Get());
             m_d3d12BackBuffers[i].Reset();
         }
 
@@ -290,8 +493,12 @@ Microsoft::WRL::ComPtr<IDXGISwapChain4> Window::CreateSwapChain()
     swapChainDesc.AlphaMode = DXGI_ALPHA_MODE_UNSPECIFIED;
     // It is recommended to always allow tearing if tearing support is available.
     swapChainDesc.Flags = m_IsTearingSupported ? DXGI_SWAP_CHAIN_FLAG_ALLOW_TEARING : 0;
+    // The frame latency waitable object is used by the frame pacer.
+    swapChainDesc.Flags |= DXGI_SWAP_CHAIN_FLAG_FRAME_LATENCY_WAITABLE_OBJECT;
 
-    ID3D12CommandQueue* pCommandQueue = app.GetCommandQueue()->GetD3D12CommandQueue().Get();
+    // The swap chain is created on the Direct3D command queue of the direct queue.
+    D3D12Device::CommandQueue& d3d12CommandQueue = static_cast<D3D12Device::CommandQueue&>(*app.GetCommandQueue()->GetDeviceCommandQueue());
+    ID3D12CommandQueue* pCommandQueue = d3d12CommandQueue.GetD3D12CommandQueue().Get();
 
     ComPtr<IDXGISwapChain1> swapChain1;
     ThrowIfFailed(dxgiFactory4->CreateSwapChainForHwnd(
@@ -301,6 +508,9 @@ Microsoft::WRL::ComPtr<IDXGISwapChain4> Window::CreateSwapChain()
 
     ThrowIfFailed(swapChain1.As(&dxgiSwapChain4));
 
+    ThrowIfFailed(dxgiSwapChain4->SetMaximumFrameLatency(m_FramePacer.GetSettings().MaxFrameLatency));
+    m_FrameLatencyWaitableObject = dxgiSwapChain4->GetFrameLatencyWaitableObject();
+
     m_CurrentBackBufferIndex = dxgiSwapChain4->GetCurrentBackBufferIndex();
 
     return dxgiSwapChain4;
@@ -317,6 +527,8 @@ void Window::UpdateRenderTargetViews()
         ComPtr<ID3D12Resource> backBuffer;
         ThrowIfFailed(m_dxgiSwapChain->GetBuffer(i, IID_PPV_ARGS(&backBuffer)));
         device->CreateRenderTargetView(backBuffer.Get(), nullptr, rtvHandle);
+        // Back buffers are in the present state when they are created.
+        ResourceStateTracker::AddGlobalResourceState(backBuffer.Get(), D3D12_RESOURCE_STATE_PRESENT);
         m_d3d12BackBuffers[i] = backBuffer;
         rtvHandle.Offset(m_RTVDescriptorSize);
     }
@@ -342,9 +554,68 @@ UINT Window::GetCurrentBackBufferIndex() const
 
 UINT Window::Present()
 {
-    UINT syncInterval = m_VSync ? 1 : 0;
+    UINT syncInterval = m_VSync ? m_FramePacer.GetSettings().SyncInterval : 0;
     UINT presentFlags = m_IsTearingSupported && !m_VSync ? DXGI_PRESENT_ALLOW_TEARING : 0;
     ThrowIfFailed(m_dxgiSwapChain->Present(syncInterval, presentFlags));
     m_CurrentBackBufferIndex = m_dxgiSwapChain->GetCurrentBackBufferIndex();
+    m_WaitForFrameLatency = true;
+
+    // The fence value is used to limit the number of frames in flight.
+    uint64_t fenceValue = Application::Get().GetCommandQueue()->Signal();
+    m_FramePacer.EndFrame(FastClock::GetSeconds(), fenceValue);
+    Application::Get().EndFrame(fenceValue);
+
     return m_CurrentBackBufferIndex;
 }
+
+const FramePacer& Window::GetFramePacer() const
+{
+    return m_FramePacer;
+}
+
+const FrameStats& Window::GetUpdateFrameStats() const
+{
+    return m_UpdateFrameStats;
+}
+
+const FrameStats& Window::GetRenderFrameStats() const
+{
+    return m_RenderFrameStats;
+}
+
+void Window::SetFixedStep(const FixedStepScheduler::Settings& settings)
+{
+    m_FixedStepScheduler.SetSettings(settings);
+    // Start accumulating at the next frame.
+    m_FixedStepScheduler.Reset();
+    m_FixedStep = true;
+}
+
+void Window::SetVariableStep()
+{
+    m_FixedStep = false;
+}
+
+bool Window::IsFixedStep() const
+{
+    return m_FixedStep;
+}
+
+const FixedStepScheduler& Window::GetFixedStepScheduler() const
+{
+    return m_FixedStepScheduler;
+}
+
+void Window::SetFramePacerSettings(const FramePacer::Settings& settings)
+{
+    // The back buffer of a frame can only be reused after the GPU has
+    // finished the frame, so there can't be more frames in flight than
+    // swapchain buffers.
+    FramePacer::Settings pacerSettings = settings;
+    pacerSettings.MaxFramesInFlight = std::min<uint32_t>(pacerSettings.MaxFramesInFlight, BufferCount);
+    m_FramePacer.SetSettings(pacerSettings);
+    if (m_dxgiSwapChain)
+    {
+        ThrowIfFailed(m_dxgiSwapChain->SetMaximumFrameLatency(m_FramePacer.GetSettings().MaxFrameLatency));
+    }
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+/**
+ * A minimal unit test framework (the tests only depend on the C++ standard library).
+ *
+ * Test cases are defined with TEST_CASE and registered before main runs.
+ * A failed CHECK reports the expression and the location and continues the
+ * test case. The test executable returns 1 if any check failed.
+ *
+ *   TEST_CASE(FramePacerLimitsFramesInFlight)
+ *   {
+ *       CHECK(pacer.GetFramesInFlight(0) == 0);
+ *   }
+ */
+
+namespace Test
+{
+    using TestFunction = void (*)();
+
+    // Register a test case. Returns true so it can initialize a static variable.
+    bool Register(const char* name, TestFunction function);
+
+    // Report a failed check in the running test case.
+    void Fail(const char* file, int line, const char* expression);
+}
+
+#define TEST_CASE(name) \
+    static void name(); \
+    static const bool name##Registered = Test::Register(#name, name); \
+    static void name()
+
+#define CHECK(condition) \
+    do \
+    { \
+        if (!(condition)) \
+        { \
+            Test::Fail(__FILE__, __LINE__, #condition); \
+        } \
+    } while (false)
+
+// Check that two floating-point values differ by at most tolerance.
+#define CHECK_NEAR(expected, actual, tolerance) \
+    CHECK(((expected) - (actual)) <= (tolerance) && ((actual) - (expected)) <= (tolerance))
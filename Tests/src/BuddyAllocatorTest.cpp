@@ -0,0 +1,141 @@
+#include <Test.h>
+
+#include <BuddyAllocator.h>
+#include <Defines.h>
+
+#include <random>
+#include <vector>
+
+TEST_CASE(BlocksAreRoundedUpToPowersOfTwo)
+{
+    BuddyAllocator allocator(_64MB, _64KB);
+
+    CHECK(allocator.GetBlockSize(1) == _64KB);
+    CHECK(allocator.GetBlockSize(_64KB + 1) == 2 * _64KB);
+    CHECK(allocator.GetBlockSize(1, _4MB) == _4MB);
+
+    uint64_t offset = allocator.Allocate(_64KB + 1);
+    CHECK(offset == 0);
+    CHECK(allocator.GetAllocationSize(offset) == 2 * _64KB);
+    CHECK(allocator.GetFreeSize() == _64MB - 2 * _64KB);
+}
+
+TEST_CASE(AllocationsHonorAlignmentClasses)
+{
+    BuddyAllocator allocator(_64MB, _64KB);
+
+    uint64_t small = allocator.Allocate(_64KB);
+    uint64_t msaa = allocator.Allocate(_64KB, _4MB);
+
+    CHECK(small == 0);
+    CHECK(msaa != BuddyAllocator::InvalidOffset);
+    CHECK(msaa % _4MB == 0);
+    CHECK(allocator.GetAllocationSize(msaa) == _4MB);
+}
+
+TEST_CASE(FreedBuddiesAreMerged)
+{
+    BuddyAllocator allocator(_64MB, _64KB);
+
+    std::vector<uint64_t> offsets;
+    for (uint64_t i = 0; i < _64MB / _64KB; ++i)
+    {
+        offsets.push_back(allocator.Allocate(_64KB));
+        CHECK(offsets.back() == i * _64KB);
+    }
+
+    CHECK(allocator.Allocate(_64KB) == BuddyAllocator::InvalidOffset);
+    CHECK(!allocator.HasSpace(_64KB));
+    CHECK(allocator.GetFreeSize() == 0);
+
+    for (uint64_t offset : offsets)
+    {
+        allocator.Free(offset);
+    }
+
+    CHECK(allocator.IsEmpty());
+    CHECK(allocator.GetLargestFreeBlockSize() == _64MB);
+    CHECK(allocator.GetFragmentation() == 0.0f);
+    CHECK(allocator.Allocate(_64MB) == 0);
+}
+
+TEST_CASE(InvalidRequestsFail)
+{
+    BuddyAllocator allocator(_64MB, _64KB);
+
+    CHECK(allocator.Allocate(0) == BuddyAllocator::InvalidOffset);
+    CHECK(allocator.Allocate(_64MB + 1) == BuddyAllocator::InvalidOffset);
+    CHECK(!allocator.HasSpace(_64MB + 1));
+    CHECK(allocator.IsEmpty());
+}
+
+TEST_CASE(FragmentationIsReported)
+{
+    BuddyAllocator allocator(8 * _64KB, _64KB);
+
+    std::vector<uint64_t> offsets;
+    for (int i = 0; i < 8; ++i)
+    {
+        offsets.push_back(allocator.Allocate(_64KB));
+    }
+
+    // Free every other block, so no two free blocks can be merged.
+    for (int i = 0; i < 8; i += 2)
+    {
+        allocator.Free(offsets[i]);
+    }
+
+    CHECK(allocator.GetFreeSize() == 4 * _64KB);
+    CHECK(allocator.GetLargestFreeBlockSize() == _64KB);
+    CHECK_NEAR(0.75f, allocator.GetFragmentation(), 1e-6f);
+    CHECK(!allocator.HasSpace(2 * _64KB));
+}
+
+TEST_CASE(RandomAllocationsDoNotOverlap)
+{
+    BuddyAllocator allocator(_64MB, _64KB);
+    std::mt19937 random(1);
+
+    struct Allocation
+    {
+        uint64_t Offset;
+        uint64_t Size;
+    };
+    std::vector<Allocation> allocations;
+
+    for (int i = 0; i < 10000; ++i)
+    {
+        if (!allocations.empty() && random() % 2 == 0)
+        {
+            size_t index = random() % allocations.size();
+            allocator.Free(allocations[index].Offset);
+            allocations[index] = allocations.back();
+            allocations.pop_back();
+        }
+        else
+        {
+            uint64_t size = 1 + random() % _2MB;
+            uint64_t offset = allocator.Allocate(size);
+            if (offset != BuddyAllocator::InvalidOffset)
+            {
+                CHECK(offset % allocator.GetBlockSize(size) == 0);
+                allocations.push_back({ offset, allocator.GetAllocationSize(offset) });
+            }
+        }
+    }
+
+    uint64_t allocatedSize = 0;
+    for (size_t i = 0; i < allocations.size(); ++i)
+    {
+        allocatedSize += allocations[i].Size;
+        for (size_t j = i + 1; j < allocations.size(); ++j)
+        {
+            const Allocation& a = allocations[i];
+            const Allocation& b = allocations[j];
+            CHECK(a.Offset + a.Size <= b.Offset || b.Offset + b.Size <= a.Offset);
+        }
+    }
+
+    CHECK(allocator.GetNumAllocations() == allocations.size());
+    CHECK(allocator.GetFreeSize() == _64MB - allocatedSize);
+}
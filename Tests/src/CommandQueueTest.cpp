@@ -0,0 +1,243 @@
+#include <Test.h>
+
+#include <CommandQueue.h>
+#include <NullDevice.h>
+#include <ResourceStateTracker.h>
+
+#include <memory>
+#include <stdexcept>
+#include <vector>
+
+namespace
+{
+    // Matches D3D12_RESOURCE_STATES.
+    const uint32_t PixelShaderResource = 0x80;
+    const uint32_t RenderTarget = 0x4;
+
+    /**
+     * The engine command list on the NullDevice (like CommandList): transitions
+     * are tracked with a ResourceStateTracker and the commands are recorded on
+     * a command list of the device.
+     */
+    class NullEngineCommandList
+    {
+    public:
+        NullEngineCommandList(Device& device, Device::CommandListType type)
+            : m_CommandList(std::static_pointer_cast<NullDevice::CommandList>(device.CreateCommandList(type)))
+            , m_NumResets(0)
+            , m_ThrowOnClose(false)
+        {}
+
+        void TransitionBarrier(void* resource, uint32_t stateAfter)
+        {
+            m_ResourceStateTracker.TransitionResource(resource, stateAfter);
+        }
+
+        void Draw()
+        {
+            FlushResourceBarriers();
+            m_CommandList->DrawInstanced(3, 1);
+        }
+
+        bool Close(NullEngineCommandList& pendingCommandList)
+        {
+            if (m_ThrowOnClose)
+            {
+                throw std::runtime_error("Failed to close the command list.");
+            }
+
+            FlushResourceBarriers();
+            m_CommandList->Close();
+
+            uint32_t numPendingBarriers = m_ResourceStateTracker.FlushPendingResourceBarriers(pendingCommandList.GetResourceBarrierFunction());
+            m_ResourceStateTracker.CommitFinalResourceStates();
+
+            return numPendingBarriers > 0;
+        }
+
+        void Close()
+        {
+            FlushResourceBarriers();
+            m_CommandList->Close();
+        }
+
+        void Reset()
+        {
+            m_CommandList->Reset();
+            m_ResourceStateTracker.Reset();
+            m_NumResets++;
+        }
+
+        Device::CommandList& GetDeviceCommandList() const
+        {
+            return *m_CommandList;
+        }
+
+        uint32_t GetNumResets() const
+        {
+            return m_NumResets;
+        }
+
+        void SetThrowOnClose(bool throwOnClose)
+        {
+            m_ThrowOnClose = throwOnClose;
+        }
+
+    private:
+        ResourceStateTracker::ResourceBarrierFunction GetResourceBarrierFunction()
+        {
+            NullDevice::CommandList* commandList = m_CommandList.get();
+            return [commandList](uint32_t numBarriers, const ResourceStateTracker::Barrier*)
+            {
+                commandList->ResourceBarrier(numBarriers);
+            };
+        }
+
+        void FlushResourceBarriers()
+        {
+            m_ResourceStateTracker.FlushResourceBarriers(GetResourceBarrierFunction());
+        }
+
+        std::shared_ptr<NullDevice::CommandList> m_CommandList;
+        ResourceStateTracker m_ResourceStateTracker;
+        uint32_t m_NumResets;
+        bool m_ThrowOnClose;
+    };
+
+    using NullCommandQueue = BasicCommandQueue<NullEngineCommandList>;
+
+    // A resource that is registered in the global resource state while it is alive.
+    class Resource
+    {
+    public:
+        explicit Resource(uint32_t state)
+        {
+            ResourceStateTracker::AddGlobalResourceState(this, state);
+        }
+
+        ~Resource()
+        {
+            ResourceStateTracker::RemoveGlobalResourceState(this);
+        }
+
+        Resource(const Resource&) = delete;
+        Resource& operator=(const Resource&) = delete;
+    };
+
+    // A device whose fence values never complete during the test.
+    NullDevice::Settings StalledGpu()
+    {
+        NullDevice::Settings settings;
+        settings.GpuLatency = 3600.0;
+        return settings;
+    }
+}
+
+TEST_CASE(PendingBarriersAreExecutedOnAPendingCommandList)
+{
+    NullDevice device;
+    NullCommandQueue commandQueue(device, Device::CommandListType::Direct);
+    Resource texture(PixelShaderResource);
+
+    // The state of the texture is not known on the command list, so the
+    // transition is resolved against the global state when it is executed.
+    std::shared_ptr<NullEngineCommandList> commandList = commandQueue.GetCommandList();
+    commandList->TransitionBarrier(&texture, RenderTarget);
+    commandList->Draw();
+    commandQueue.ExecuteCommandList(commandList);
+
+    CHECK(device.GetStatistics().NumExecutedCommandLists == 2);
+    // The draw and the barrier on the pending command list.
+    CHECK(device.GetStatistics().NumExecutedCommands == 2);
+
+    // The texture is already a render target, so there are no pending barriers.
+    commandList = commandQueue.GetCommandList();
+    commandList->TransitionBarrier(&texture, RenderTarget);
+    commandList->Draw();
+    commandQueue.ExecuteCommandList(commandList);
+
+    CHECK(device.GetStatistics().NumExecutedCommandLists == 3);
+    CHECK(device.GetStatistics().NumExecutedCommands == 3);
+}
+
+TEST_CASE(CommandListsAreReusedWhenTheFenceCompletes)
+{
+    NullDevice device;
+    NullCommandQueue commandQueue(device, Device::CommandListType::Direct);
+
+    std::shared_ptr<NullEngineCommandList> commandList = commandQueue.GetCommandList();
+    NullEngineCommandList* first = commandList.get();
+    uint64_t fenceValue = commandQueue.ExecuteCommandList(commandList);
+    commandList.reset();
+
+    commandQueue.WaitForFenceValue(fenceValue);
+    CHECK(commandQueue.IsFenceComplete(fenceValue));
+    CHECK(commandQueue.GetCompletedFenceValue() == fenceValue);
+
+    // The pending command list (which was queued first) and the command list are reused.
+    std::shared_ptr<NullEngineCommandList> reused1 = commandQueue.GetCommandList();
+    std::shared_ptr<NullEngineCommandList> reused2 = commandQueue.GetCommandList();
+    CHECK(reused2.get() == first);
+    CHECK(reused1->GetNumResets() == 1);
+    CHECK(reused2->GetNumResets() == 1);
+}
+
+TEST_CASE(CommandListsInFlightAreNotReused)
+{
+    NullDevice device(StalledGpu());
+    NullCommandQueue commandQueue(device, Device::CommandListType::Direct);
+
+    std::shared_ptr<NullEngineCommandList> commandList = commandQueue.GetCommandList();
+    NullEngineCommandList* first = commandList.get();
+    uint64_t fenceValue = commandQueue.ExecuteCommandList(commandList);
+    commandList.reset();
+
+    CHECK(!commandQueue.IsFenceComplete(fenceValue));
+
+    commandList = commandQueue.GetCommandList();
+    CHECK(commandList.get() != first);
+    CHECK(commandList->GetNumResets() == 0);
+}
+
+TEST_CASE(SignalIncrementsTheFenceValue)
+{
+    NullDevice device;
+    NullCommandQueue commandQueue(device, Device::CommandListType::Copy);
+
+    uint64_t fenceValue1 = commandQueue.Signal();
+    uint64_t fenceValue2 = commandQueue.Signal();
+    CHECK(fenceValue2 == fenceValue1 + 1);
+
+    commandQueue.Flush();
+    CHECK(commandQueue.GetCompletedFenceValue() == fenceValue2 + 1);
+    CHECK(commandQueue.GetCommandListType() == Device::CommandListType::Copy);
+    CHECK(commandQueue.GetDeviceCommandQueue()->GetType() == Device::CommandListType::Copy);
+}
+
+TEST_CASE(TheResourceStateIsUnlockedIfCloseThrows)
+{
+    NullDevice device;
+    NullCommandQueue commandQueue(device, Device::CommandListType::Direct);
+    Resource texture(PixelShaderResource);
+
+    std::shared_ptr<NullEngineCommandList> commandList = commandQueue.GetCommandList();
+    commandList->SetThrowOnClose(true);
+
+    bool thrown = false;
+    try
+    {
+        commandQueue.ExecuteCommandList(commandList);
+    }
+    catch (const std::runtime_error&)
+    {
+        thrown = true;
+    }
+    CHECK(thrown);
+    CHECK(device.GetStatistics().NumExecutedCommandLists == 0);
+
+    // The global resource state can be locked again (this would deadlock otherwise).
+    commandList = commandQueue.GetCommandList();
+    commandList->TransitionBarrier(&texture, RenderTarget);
+    commandQueue.ExecuteCommandList(commandList);
+    CHECK(device.GetStatistics().NumExecutedCommandLists == 2);
+}
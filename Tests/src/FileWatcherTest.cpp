@@ -0,0 +1,105 @@
+#include <Test.h>
+
+#include <FileWatcher.h>
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace
+{
+    // A directory that is removed with its contents when the test ends.
+    class TemporaryDirectory
+    {
+    public:
+        TemporaryDirectory()
+        {
+            std::random_device random;
+            std::ostringstream name;
+            name << "FileWatcherTest-" << std::hex << random() << random();
+
+            m_Path = fs::temp_directory_path() / name.str();
+            fs::create_directories(m_Path);
+            // The watcher reports canonical paths.
+            m_Path = fs::canonical(m_Path);
+        }
+
+        ~TemporaryDirectory()
+        {
+            std::error_code error;
+            fs::remove_all(m_Path, error);
+        }
+
+        const fs::path& GetPath() const
+        {
+            return m_Path;
+        }
+
+    private:
+        fs::path m_Path;
+    };
+
+    void WriteFile(const fs::path& path, const char* contents)
+    {
+        std::ofstream file(path);
+        file << contents;
+    }
+
+    bool Contains(const std::vector<fs::path>& files, const fs::path& file)
+    {
+        return std::find(files.begin(), files.end(), file) != files.end();
+    }
+}
+
+TEST_CASE(WrittenFilesAreReported)
+{
+    TemporaryDirectory directory;
+    FileWatcher watcher;
+    CHECK(watcher.AddDirectory(directory.GetPath()));
+    CHECK(watcher.Poll().empty());
+
+    fs::path shader = directory.GetPath() / "Shader.hlsl";
+    WriteFile(shader, "float4 main() : SV_Target { return 0; }");
+    // Written twice, but only reported once.
+    WriteFile(shader, "float4 main() : SV_Target { return 1; }");
+
+    std::vector<fs::path> changedFiles = watcher.Poll();
+    CHECK(changedFiles.size() == 1);
+    CHECK(Contains(changedFiles, shader));
+
+    // The changes are only returned once.
+    CHECK(watcher.Poll().empty());
+}
+
+TEST_CASE(RenamedFilesAreReported)
+{
+    TemporaryDirectory directory;
+    fs::path tempFile = directory.GetPath() / "Shader.hlsl.tmp";
+    fs::path shader = directory.GetPath() / "Shader.hlsl";
+    WriteFile(tempFile, "float4 main() : SV_Target { return 0; }");
+
+    FileWatcher watcher;
+    CHECK(watcher.AddDirectory(directory.GetPath()));
+    // Adding the directory again has no effect.
+    CHECK(watcher.AddDirectory(directory.GetPath() / "."));
+
+    // Editors often save by writing a temporary file and renaming it.
+    fs::rename(tempFile, shader);
+
+    std::vector<fs::path> changedFiles = watcher.Poll();
+    CHECK(changedFiles.size() == 1);
+    CHECK(Contains(changedFiles, shader));
+}
+
+TEST_CASE(MissingDirectoryIsNotWatched)
+{
+    TemporaryDirectory directory;
+    FileWatcher watcher;
+    CHECK(!watcher.AddDirectory(directory.GetPath() / "Missing"));
+    CHECK(watcher.Poll().empty());
+}
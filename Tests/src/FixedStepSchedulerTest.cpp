@@ -0,0 +1,126 @@
+#include <Test.h>
+
+#include <FixedStepScheduler.h>
+
+#include <cstdint>
+
+namespace
+{
+    // The step durations are powers of two, so the simulated times are exact.
+    FixedStepScheduler::Settings CreateSettings(double stepsPerSecond, uint32_t maxStepsPerFrame)
+    {
+        FixedStepScheduler::Settings settings;
+        settings.StepsPerSecond = stepsPerSecond;
+        settings.MaxStepsPerFrame = maxStepsPerFrame;
+        return settings;
+    }
+}
+
+TEST_CASE(FirstFrameOnlyStartsTheAccumulation)
+{
+    FixedStepScheduler scheduler(CreateSettings(4.0, 4));
+
+    CHECK(scheduler.BeginFrame(10.0) == 0);
+    CHECK(scheduler.GetStepCount() == 0);
+    CHECK(scheduler.GetAlpha() == 0.0);
+
+    CHECK(scheduler.BeginFrame(11.0) == 4);
+    CHECK(scheduler.GetStepCount() == 4);
+    CHECK(scheduler.GetTime() == 1.0);
+    CHECK(scheduler.GetAlpha() == 0.0);
+}
+
+TEST_CASE(RemainderIsCarriedToTheNextFrame)
+{
+    FixedStepScheduler scheduler(CreateSettings(4.0, 4));
+    scheduler.BeginFrame(0.0);
+
+    CHECK(scheduler.BeginFrame(0.375) == 1);
+    CHECK(scheduler.GetAlpha() == 0.5);
+
+    CHECK(scheduler.BeginFrame(0.5) == 1);
+    CHECK(scheduler.GetAlpha() == 0.0);
+
+    CHECK(scheduler.BeginFrame(0.625) == 0);
+    CHECK(scheduler.GetAlpha() == 0.5);
+
+    CHECK(scheduler.GetStepCount() == 2);
+    CHECK(scheduler.GetDroppedTime() == 0.0);
+}
+
+TEST_CASE(StepsPerFrameAreClamped)
+{
+    FixedStepScheduler scheduler(CreateSettings(4.0, 2));
+    scheduler.BeginFrame(0.0);
+
+    // A long stall (like a breakpoint).
+    CHECK(scheduler.BeginFrame(10.125) == 2);
+    CHECK(scheduler.GetStepCount() == 2);
+    CHECK(scheduler.GetDroppedTime() == 9.5);
+    // The fraction of a step is kept.
+    CHECK(scheduler.GetAlpha() == 0.5);
+
+    // The simulation continues at the normal rate.
+    CHECK(scheduler.BeginFrame(10.25) == 1);
+    CHECK(scheduler.GetDroppedTime() == 9.5);
+}
+
+TEST_CASE(AlphaStaysBelowOne)
+{
+    FixedStepScheduler scheduler(CreateSettings(4.0, 4));
+    scheduler.BeginFrame(0.0);
+
+    bool inRange = true;
+    double now = 0.0;
+    for (uint32_t frame = 0; frame < 1000; ++frame)
+    {
+        // Frame times between 1 ms and 1.3 s.
+        now += 0.001 * (1 + (frame * 7919) % 1300);
+        scheduler.BeginFrame(now);
+        inRange = inRange && scheduler.GetAlpha() >= 0.0 && scheduler.GetAlpha() < 1.0;
+    }
+    CHECK(inRange);
+
+    // All the time is either simulated, dropped or left in the accumulator.
+    double accumulated = scheduler.GetAlpha() * scheduler.GetStepDuration();
+    CHECK_NEAR(now, scheduler.GetTime() + scheduler.GetDroppedTime() + accumulated, 1e-6);
+}
+
+TEST_CASE(ShorterStepsKeepAlphaBelowOne)
+{
+    FixedStepScheduler scheduler(CreateSettings(4.0, 4));
+    scheduler.BeginFrame(0.0);
+    CHECK(scheduler.BeginFrame(0.2) == 0);
+    CHECK_NEAR(0.8, scheduler.GetAlpha(), 1e-9);
+
+    // 0.2 seconds is more than a step of the new duration.
+    scheduler.SetSettings(CreateSettings(8.0, 4));
+    CHECK(scheduler.GetStepDuration() == 0.125);
+    CHECK(scheduler.GetAlpha() < 1.0);
+    CHECK_NEAR(0.6, scheduler.GetAlpha(), 1e-9);
+    CHECK_NEAR(0.125, scheduler.GetDroppedTime(), 1e-9);
+}
+
+TEST_CASE(ResetRestartsTheAccumulation)
+{
+    FixedStepScheduler scheduler(CreateSettings(4.0, 4));
+    scheduler.BeginFrame(0.0);
+    scheduler.BeginFrame(0.375);
+    CHECK(scheduler.GetStepCount() == 1);
+
+    // The time while the simulation was paused is not simulated.
+    scheduler.Reset();
+    CHECK(scheduler.GetAlpha() == 0.0);
+    CHECK(scheduler.BeginFrame(5.0) == 0);
+    CHECK(scheduler.BeginFrame(5.25) == 1);
+    CHECK(scheduler.GetStepCount() == 2);
+    CHECK(scheduler.GetTime() == 0.5);
+}
+
+TEST_CASE(SchedulerSettingsAreClamped)
+{
+    FixedStepScheduler scheduler(CreateSettings(0.0, 0));
+    CHECK(scheduler.GetSettings().StepsPerSecond == 1.0);
+    CHECK(scheduler.GetSettings().MaxStepsPerFrame == 1);
+    CHECK(scheduler.GetStepDuration() == 1.0);
+}
@@ -0,0 +1,229 @@
+#include <Test.h>
+
+#include <FramePacer.h>
+
+#include <algorithm>
+#include <vector>
+
+namespace
+{
+    /**
+     * Runs the frame loop of Window (wait for the frames in flight, wait for
+     * the frame-time budget, record and submit the frame) on a simulated clock.
+     * The simulated GPU runs the frames one after the other.
+     */
+    class SimulatedFrameLoop
+    {
+    public:
+        SimulatedFrameLoop(const FramePacer::Settings& settings, double cpuFrameTime, double gpuFrameTime)
+            : m_FramePacer(settings)
+            , m_CpuFrameTime(cpuFrameTime)
+            , m_GpuFrameTime(gpuFrameTime)
+            , m_Time(0.0)
+        {}
+
+        void RunFrame()
+        {
+            double t0 = m_Time;
+
+            uint64_t fenceValue = m_FramePacer.GetFenceValueToWait();
+            if (fenceValue > 0)
+            {
+                m_Time = std::max(m_Time, m_CompletionTimes[fenceValue - 1]);
+            }
+
+            double t1 = m_Time;
+            m_Time += m_FramePacer.GetPacingDelay(m_Time);
+
+            m_FramePacer.BeginFrame(m_Time, t1 - t0, m_Time - t1, GetCompletedFenceValue());
+            m_Time += m_CpuFrameTime;
+
+            // The fence value of a frame is its index in m_CompletionTimes plus one.
+            double gpuStartTime = m_CompletionTimes.empty() ? m_Time : std::max(m_Time, m_CompletionTimes.back());
+            m_CompletionTimes.push_back(gpuStartTime + m_GpuFrameTime);
+            m_FramePacer.EndFrame(m_Time, m_CompletionTimes.size());
+        }
+
+        uint64_t GetCompletedFenceValue() const
+        {
+            return std::upper_bound(m_CompletionTimes.begin(), m_CompletionTimes.end(), m_Time) - m_CompletionTimes.begin();
+        }
+
+        const FramePacer& GetFramePacer() const
+        {
+            return m_FramePacer;
+        }
+
+    private:
+        FramePacer m_FramePacer;
+        double m_CpuFrameTime;
+        double m_GpuFrameTime;
+
+        double m_Time;
+        std::vector<double> m_CompletionTimes;
+    };
+
+    FramePacer::Settings CreateSettings(uint32_t maxFramesInFlight, double targetFrameTime)
+    {
+        FramePacer::Settings settings;
+        settings.MaxFramesInFlight = maxFramesInFlight;
+        settings.TargetFrameTime = targetFrameTime;
+        return settings;
+    }
+}
+
+TEST_CASE(FramesInFlightAreLimited)
+{
+    for (uint32_t maxFramesInFlight = 1; maxFramesInFlight <= 3; ++maxFramesInFlight)
+    {
+        // The GPU is the bottleneck.
+        SimulatedFrameLoop loop(CreateSettings(maxFramesInFlight, 0.0), 0.001, 0.010);
+        for (int i = 0; i < 100; ++i)
+        {
+            loop.RunFrame();
+
+            const FramePacer::FrameTiming& timing = loop.GetFramePacer().GetFrameTiming();
+            CHECK(timing.FramesInFlight < maxFramesInFlight);
+        }
+
+        // The frame rate is limited by the GPU. With a single frame in flight,
+        // the CPU and the GPU don't overlap.
+        const FramePacer::FrameTiming& timing = loop.GetFramePacer().GetFrameTiming();
+        CHECK_NEAR(maxFramesInFlight == 1 ? 0.011 : 0.010, timing.FrameTime, 1e-9);
+        CHECK(timing.GpuWaitTime > 0.0);
+        CHECK(timing.PacingWaitTime == 0.0);
+    }
+}
+
+TEST_CASE(NoWaitUntilMaxFramesAreInFlight)
+{
+    FramePacer pacer(CreateSettings(3, 0.0));
+
+    for (uint64_t frame = 0; frame < 3; ++frame)
+    {
+        CHECK(pacer.GetFenceValueToWait() == 0);
+        pacer.BeginFrame(0.0, 0.0, 0.0, 0);
+        pacer.EndFrame(0.0, frame + 1);
+    }
+
+    // The fourth frame has to wait for the first frame.
+    CHECK(pacer.GetFenceValueToWait() == 1);
+    CHECK(pacer.GetFramesInFlight(0) == 3);
+    CHECK(pacer.GetFramesInFlight(2) == 1);
+}
+
+TEST_CASE(TargetFrameTimeLimitsFrameRate)
+{
+    const double targetFrameTime = 1.0 / 60.0;
+
+    // The CPU and the GPU are faster than the target frame time.
+    SimulatedFrameLoop loop(CreateSettings(2, targetFrameTime), 0.002, 0.004);
+    for (int i = 0; i < 100; ++i)
+    {
+        loop.RunFrame();
+    }
+
+    const FramePacer::FrameTiming& timing = loop.GetFramePacer().GetFrameTiming();
+    CHECK_NEAR(targetFrameTime, timing.FrameTime, 1e-9);
+    CHECK_NEAR(targetFrameTime - 0.002, timing.PacingWaitTime, 1e-9);
+    CHECK_NEAR(0.002, timing.CpuTime, 1e-9);
+    CHECK(timing.GpuWaitTime == 0.0);
+}
+
+TEST_CASE(UnthrottledFrameRateFollowsCpu)
+{
+    // The CPU is the bottleneck.
+    SimulatedFrameLoop loop(CreateSettings(2, 0.0), 0.005, 0.001);
+    for (int i = 0; i < 10; ++i)
+    {
+        loop.RunFrame();
+    }
+
+    const FramePacer::FrameTiming& timing = loop.GetFramePacer().GetFrameTiming();
+    CHECK_NEAR(0.005, timing.FrameTime, 1e-9);
+    CHECK(timing.GpuWaitTime == 0.0);
+    CHECK(timing.PacingWaitTime == 0.0);
+    // The next frame starts right after the previous frame was submitted.
+    CHECK(timing.FramesInFlight == 1);
+}
+
+TEST_CASE(PresentOutsideOfFrameIsTracked)
+{
+    FramePacer pacer(CreateSettings(1, 0.0));
+
+    // For example, a present during a resize.
+    pacer.EndFrame(1.0, 5);
+
+    CHECK(pacer.GetFrameCount() == 1);
+    CHECK(pacer.GetFenceValueToWait() == 5);
+    CHECK(pacer.GetFrameTiming().BeginTime == 1.0);
+    CHECK(pacer.GetFrameTiming().CpuTime == 0.0);
+}
+
+TEST_CASE(FrameWithoutPresentIsDiscarded)
+{
+    FramePacer pacer(CreateSettings(2, 0.0));
+
+    pacer.BeginFrame(0.0, 0.0, 0.0, 0);
+    pacer.EndFrame(0.5, 1);
+
+    // The game did not present the second frame.
+    pacer.BeginFrame(1.0, 0.0, 0.0, 1);
+    pacer.BeginFrame(2.0, 0.0, 0.0, 1);
+    pacer.EndFrame(2.5, 2);
+
+    CHECK(pacer.GetFrameCount() == 2);
+    CHECK(pacer.GetNumFrameTimings() == 2);
+    CHECK(pacer.GetFrameTiming().FrameNumber == 1);
+    CHECK(pacer.GetFrameTiming().BeginTime == 2.0);
+    CHECK(pacer.GetFrameTiming().FrameTime == 1.0);
+    CHECK(pacer.GetFrameTiming().CpuTime == 0.5);
+    CHECK(pacer.GetFramesInFlight(1) == 1);
+}
+
+TEST_CASE(ResetForgetsFramesInFlight)
+{
+    FramePacer pacer(CreateSettings(1, 1.0));
+    pacer.BeginFrame(0.0, 0.0, 0.0, 0);
+    pacer.EndFrame(0.5, 1);
+    CHECK(pacer.GetFenceValueToWait() == 1);
+    CHECK(pacer.GetPacingDelay(0.5) == 0.5);
+
+    pacer.Reset();
+
+    CHECK(pacer.GetFenceValueToWait() == 0);
+    CHECK(pacer.GetFramesInFlight(0) == 0);
+    CHECK(pacer.GetPacingDelay(0.5) == 0.0);
+    // The timing history is kept.
+    CHECK(pacer.GetNumFrameTimings() == 1);
+}
+
+TEST_CASE(SettingsAreClamped)
+{
+    FramePacer::Settings settings;
+    settings.MaxFramesInFlight = 0;
+    settings.MaxFrameLatency = 100;
+    settings.SyncInterval = 0;
+    settings.TargetFrameTime = -1.0;
+
+    FramePacer pacer(settings);
+    CHECK(pacer.GetSettings().MaxFramesInFlight == 1);
+    CHECK(pacer.GetSettings().MaxFrameLatency == FramePacer::MaxTrackedFrames);
+    CHECK(pacer.GetSettings().SyncInterval == 1);
+    CHECK(pacer.GetSettings().TargetFrameTime == 0.0);
+}
+
+TEST_CASE(TimingHistoryWrapsAround)
+{
+    FramePacer pacer;
+    for (uint32_t frame = 0; frame < FramePacer::TimingHistorySize + 10; ++frame)
+    {
+        pacer.BeginFrame(frame, 0.0, 0.0, frame);
+        pacer.EndFrame(frame + 0.5, frame + 1);
+    }
+
+    CHECK(pacer.GetNumFrameTimings() == FramePacer::TimingHistorySize);
+    CHECK(pacer.GetFrameTiming().FrameNumber == FramePacer::TimingHistorySize + 9);
+    CHECK(pacer.GetFrameTiming(FramePacer::TimingHistorySize - 1).FrameNumber == 10);
+    CHECK(pacer.GetFrameTiming().FrameTime == 1.0);
+}
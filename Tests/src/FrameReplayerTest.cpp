@@ -0,0 +1,166 @@
+#include <Test.h>
+
+#include <FrameReplayer.h>
+
+#include <initializer_list>
+
+namespace
+{
+    using Call = FrameCapture::Call;
+
+    const uint64_t CBV_SRV_UAV = static_cast<uint64_t>(Device::DescriptorHeapType::CBV_SRV_UAV);
+
+    // Append a call to a stream (like FrameCapture::Decode).
+    void Add(FrameCapture::Stream& stream, Call call, std::initializer_list<uint64_t> arguments = {})
+    {
+        FrameCapture::CallRecord record;
+        record.Type = call;
+        record.FirstArgument = static_cast<uint32_t>(stream.Arguments.size());
+        record.NumArguments = static_cast<uint32_t>(arguments.size());
+
+        stream.Records.push_back(record);
+        stream.Arguments.insert(stream.Arguments.end(), arguments);
+
+        if (call == Call::EndFrame)
+        {
+            stream.NumFrames++;
+        }
+    }
+
+    uint64_t GetCount(const FrameReplayer& replayer, Call call)
+    {
+        return replayer.GetStatistics().Calls[static_cast<size_t>(call)].Count;
+    }
+}
+
+TEST_CASE(ReplayedDescriptorsAreReusedAfterRelease)
+{
+    NullDevice device;
+    FrameReplayer replayer(device);
+    const uint64_t numDescriptorHeaps = device.GetStatistics().NumDescriptorHeaps;
+
+    // Allocate more descriptors than fit in a page (256 descriptors).
+    FrameCapture::Stream frame1;
+    for (uint64_t i = 0; i < 300; ++i)
+    {
+        Add(frame1, Call::AllocateDescriptors, { CBV_SRV_UAV, 1, 0x1000 + i });
+    }
+    Add(frame1, Call::EndFrame);
+
+    replayer.Replay(frame1);
+    CHECK(device.GetStatistics().NumDescriptorHeaps == numDescriptorHeaps + 2);
+
+    // Free the descriptors in frame 1 and release them when frame 1 has completed.
+    FrameCapture::Stream frame2;
+    for (uint64_t i = 0; i < 300; ++i)
+    {
+        Add(frame2, Call::FreeDescriptors, { CBV_SRV_UAV, 0x1000 + i, 1 });
+    }
+    Add(frame2, Call::ReleaseStaleDescriptors, { CBV_SRV_UAV, 1 });
+    Add(frame2, Call::EndFrame);
+
+    replayer.Replay(frame2);
+    replayer.Replay(frame1);
+
+    CHECK(device.GetStatistics().NumDescriptorHeaps == numDescriptorHeaps + 2);
+    CHECK(GetCount(replayer, Call::AllocateDescriptors) == 600);
+    CHECK(GetCount(replayer, Call::FreeDescriptors) == 300);
+    CHECK(replayer.GetStatistics().FrameTimes.size() == 3);
+    CHECK(replayer.GetStatistics().NumSkippedCalls == 0);
+}
+
+TEST_CASE(ReplayedStaleDescriptorsAreNotReused)
+{
+    NullDevice device;
+    FrameReplayer replayer(device);
+    const uint64_t numDescriptorHeaps = device.GetStatistics().NumDescriptorHeaps;
+
+    FrameCapture::Stream stream;
+    Add(stream, Call::AllocateDescriptors, { CBV_SRV_UAV, 256, 0x1000 });
+    Add(stream, Call::FreeDescriptors, { CBV_SRV_UAV, 0x1000, 5 });
+    // Frame 5 has not completed, so the descriptors are still in use by the GPU.
+    Add(stream, Call::ReleaseStaleDescriptors, { CBV_SRV_UAV, 4 });
+    Add(stream, Call::AllocateDescriptors, { CBV_SRV_UAV, 256, 0x2000 });
+
+    replayer.Replay(stream);
+
+    CHECK(device.GetStatistics().NumDescriptorHeaps == numDescriptorHeaps + 2);
+}
+
+TEST_CASE(ReplayedUploadPagesAreReusedAfterReset)
+{
+    NullDevice device;
+    FrameReplayer replayer(device);
+
+    // The third allocation doesn't fit in the first page (2 MB).
+    FrameCapture::Stream stream;
+    for (int i = 0; i < 3; ++i)
+    {
+        Add(stream, Call::AllocateUpload, { 1024 * 1024, 256 });
+    }
+    Add(stream, Call::ResetUploadBuffer);
+
+    replayer.Replay(stream);
+    CHECK(device.GetStatistics().NumResources == 2);
+
+    replayer.Replay(stream);
+    CHECK(device.GetStatistics().NumResources == 2);
+    CHECK(GetCount(replayer, Call::AllocateUpload) == 6);
+}
+
+TEST_CASE(ReplayedCommitSetsTheDescriptorHeapAndTables)
+{
+    NullDevice device;
+    FrameReplayer replayer(device);
+
+    // A constant buffer (root parameter 0), 4 textures (root parameter 1)
+    // and 2 UAVs (root parameter 2). Only the textures are staged.
+    FrameCapture::Stream stream;
+    Add(stream, Call::ParseRootSignature, { CBV_SRV_UAV, 0, 4, 2 });
+    Add(stream, Call::StageDescriptors, { CBV_SRV_UAV, 1, 0, 4 });
+    Add(stream, Call::CommitStagedDescriptors, { CBV_SRV_UAV });
+    Add(stream, Call::Command, { static_cast<uint64_t>(NullDevice::CommandType::DrawInstanced), 3, 1 });
+    Add(stream, Call::ExecuteCommandList, { 0 });
+    Add(stream, Call::ResetDynamicDescriptorHeap, { CBV_SRV_UAV });
+
+    replayer.Replay(stream);
+
+    // The descriptor heap, both descriptor tables (a new descriptor heap
+    // rebinds all tables) and the draw.
+    NullDevice::Statistics statistics = device.GetStatistics();
+    CHECK(statistics.NumExecutedCommandLists == 1);
+    CHECK(statistics.NumExecutedCommands == 4);
+    CHECK(replayer.GetStatistics().NumSkippedCalls == 0);
+
+    // The shader visible descriptor heap is reused after the reset.
+    const uint64_t numDescriptorHeaps = statistics.NumDescriptorHeaps;
+    replayer.Replay(stream);
+    CHECK(device.GetStatistics().NumDescriptorHeaps == numDescriptorHeaps);
+}
+
+TEST_CASE(InvalidCallsAreSkipped)
+{
+    NullDevice device;
+    FrameReplayer replayer(device);
+
+    FrameCapture::Stream stream;
+    // Allocated before the capture started.
+    Add(stream, Call::FreeDescriptors, { CBV_SRV_UAV, 0x1000, 1 });
+    // The root signature was set before the capture started.
+    Add(stream, Call::StageDescriptors, { CBV_SRV_UAV, 1, 0, 4 });
+    // The alignment is not a power of two.
+    Add(stream, Call::AllocateUpload, { 256, 3 });
+    // Larger than an upload page.
+    Add(stream, Call::AllocateUpload, { 4 * 1024 * 1024, 256 });
+    // Larger than a dynamic descriptor heap.
+    Add(stream, Call::ParseRootSignature, { CBV_SRV_UAV, 2048 });
+    // An invalid descriptor heap type.
+    Add(stream, Call::CommitStagedDescriptors, { 7 });
+    // Missing arguments.
+    Add(stream, Call::AllocateDescriptors, { CBV_SRV_UAV });
+
+    replayer.Replay(stream);
+
+    CHECK(replayer.GetStatistics().NumSkippedCalls == 7);
+    CHECK(device.GetStatistics().NumResources == 0);
+}
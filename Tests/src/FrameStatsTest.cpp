@@ -0,0 +1,192 @@
+#include <Test.h>
+
+#include <FrameStats.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+    FrameStats::Settings CreateSettings(uint32_t numRecentSamples)
+    {
+        FrameStats::Settings settings;
+        settings.NumRecentSamples = numRecentSamples;
+        return settings;
+    }
+
+    // The bounds of the bucket of a time match the time.
+    bool IsInBucket(uint64_t microseconds)
+    {
+        uint32_t bucketIndex = FrameStats::GetBucketIndex(microseconds);
+        return FrameStats::GetBucketLowerBound(bucketIndex) <= microseconds &&
+            microseconds < FrameStats::GetBucketUpperBound(bucketIndex);
+    }
+}
+
+TEST_CASE(BucketsCoverTheTimesWithoutGaps)
+{
+    bool contiguous = true;
+    bool roundTrip = true;
+    for (uint32_t i = 0; i < FrameStats::NumBuckets; ++i)
+    {
+        uint64_t lower = FrameStats::GetBucketLowerBound(i);
+        uint64_t upper = FrameStats::GetBucketUpperBound(i);
+        roundTrip = roundTrip && FrameStats::GetBucketIndex(lower) == i && FrameStats::GetBucketIndex(upper - 1) == i;
+        if (i + 1 < FrameStats::NumBuckets)
+        {
+            contiguous = contiguous && upper == FrameStats::GetBucketLowerBound(i + 1);
+        }
+    }
+    CHECK(contiguous);
+    CHECK(roundTrip);
+
+    CHECK(FrameStats::GetBucketLowerBound(0) == 0);
+    CHECK(FrameStats::GetBucketUpperBound(FrameStats::NumBuckets - 1) == 1ull << FrameStats::MaxTimeBits);
+}
+
+TEST_CASE(BucketsAreExactBelowTheSubBuckets)
+{
+    // The last bucket that is one microsecond wide.
+    CHECK(FrameStats::GetBucketIndex(127) == 127);
+    CHECK(FrameStats::GetBucketUpperBound(127) == 128);
+
+    // The first bucket that is two microseconds wide.
+    CHECK(FrameStats::GetBucketIndex(128) == 128);
+    CHECK(FrameStats::GetBucketIndex(129) == 128);
+    CHECK(FrameStats::GetBucketLowerBound(128) == 128);
+    CHECK(FrameStats::GetBucketUpperBound(128) == 130);
+    CHECK(FrameStats::GetBucketIndex(130) == 129);
+
+    CHECK(IsInBucket(255));
+    CHECK(IsInBucket(256));
+    CHECK(IsInBucket(16667));
+}
+
+TEST_CASE(LongTimesAreCountedInTheLastBucket)
+{
+    const uint64_t maxTime = 1ull << FrameStats::MaxTimeBits;
+    const uint32_t lastBucket = FrameStats::NumBuckets - 1;
+
+    CHECK(FrameStats::GetBucketIndex(maxTime - 1) == lastBucket);
+    CHECK(FrameStats::GetBucketIndex(maxTime) == lastBucket);
+    CHECK(FrameStats::GetBucketIndex(maxTime * 4) == lastBucket);
+    CHECK(FrameStats::GetBucketLowerBound(lastBucket) == maxTime - (maxTime >> 7));
+
+    // The slowest frame is still reported exactly.
+    FrameStats stats;
+    stats.AddSample(0.016);
+    stats.AddSample(10000.0);
+    CHECK(stats.GetPercentile(100.0) == 10000.0);
+    CHECK(stats.GetSummary().MaxTime == 10000.0);
+}
+
+TEST_CASE(PercentilesAreAccurateToOnePercent)
+{
+    FrameStats stats;
+
+    // Frame times between 1 ms and 100 ms.
+    std::vector<double> times;
+    for (uint32_t i = 0; i < 5000; ++i)
+    {
+        double time = 0.001 * std::pow(100.0, ((i * 7919) % 5000) / 5000.0);
+        times.push_back(time);
+        stats.AddSample(time);
+    }
+    std::sort(times.begin(), times.end());
+
+    bool accurate = true;
+    for (double percentile = 1.0; percentile < 100.0; percentile += 0.5)
+    {
+        size_t rank = static_cast<size_t>(std::ceil(percentile / 100.0 * times.size()));
+        double expected = times[rank - 1];
+        accurate = accurate && std::abs(stats.GetPercentile(percentile) - expected) <= 0.01 * expected;
+    }
+    CHECK(accurate);
+
+    FrameStats::Summary summary = stats.GetSummary();
+    CHECK(summary.NumSamples == 5000);
+    CHECK(summary.MinTime == times.front());
+    CHECK(summary.MaxTime == times.back());
+    CHECK(summary.P50 <= summary.P95 && summary.P95 <= summary.P99);
+}
+
+TEST_CASE(HitchesAreDetected)
+{
+    FrameStats stats;
+
+    // The first frame is never a hitch.
+    stats.AddSample(0.1);
+    CHECK(stats.GetNumHitches() == 0);
+    stats.Reset();
+
+    for (int i = 0; i < 10; ++i)
+    {
+        stats.AddSample(0.016);
+    }
+    CHECK(stats.GetNumHitches() == 0);
+
+    // Slower than twice the average.
+    stats.AddSample(0.040);
+    CHECK(stats.GetNumHitches() == 1);
+
+    // Exactly twice the average is not a hitch.
+    stats.Reset();
+    stats.AddSample(0.016);
+    stats.AddSample(0.032);
+    CHECK(stats.GetNumHitches() == 0);
+
+    // The hitches are written to the CSV.
+    stats.AddSample(0.1);
+    std::filesystem::path file = std::filesystem::temp_directory_path() / "FrameStatsTest-samples.csv";
+    CHECK(stats.WriteSamplesCSV(file.string()));
+
+    std::ifstream csv(file);
+    std::string header, line1, line2, line3;
+    std::getline(csv, header);
+    std::getline(csv, line1);
+    std::getline(csv, line2);
+    std::getline(csv, line3);
+    csv.close();
+    std::filesystem::remove(file);
+
+    CHECK(header == "sample,time_ms,hitch");
+    CHECK(line1 == "0,16,0");
+    CHECK(line3 == "2,100,1");
+}
+
+TEST_CASE(RecentSamplesWrapAround)
+{
+    FrameStats stats(CreateSettings(4));
+
+    for (int i = 1; i <= 10; ++i)
+    {
+        stats.AddSample(i * 0.001);
+    }
+
+    CHECK(stats.GetNumRecentSamples() == 4);
+    CHECK_NEAR(0.010, stats.GetRecentSample(0), 1e-12);
+    CHECK_NEAR(0.007, stats.GetRecentSample(3), 1e-12);
+
+    FrameStats::Summary recent = stats.GetRecentSummary();
+    CHECK(recent.NumSamples == 4);
+    CHECK_NEAR(0.007, recent.MinTime, 1e-12);
+    CHECK_NEAR(0.010, recent.MaxTime, 1e-12);
+    CHECK_NEAR(0.0085, recent.AverageTime, 1e-12);
+    CHECK_NEAR(0.008, recent.P50, 1e-12);
+
+    // All samples are in the histogram.
+    FrameStats::Summary summary = stats.GetSummary();
+    CHECK(summary.NumSamples == 10);
+    CHECK_NEAR(0.001, summary.MinTime, 1e-12);
+    CHECK_NEAR(0.0055, summary.AverageTime, 1e-12);
+
+    stats.Reset();
+    CHECK(stats.GetNumRecentSamples() == 0);
+    CHECK(stats.GetSummary().NumSamples == 0);
+    CHECK(stats.GetPercentile(50.0) == 0.0);
+}
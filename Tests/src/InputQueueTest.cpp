@@ -0,0 +1,197 @@
+#include <Test.h>
+
+#include <InputQueue.h>
+
+#include <thread>
+#include <vector>
+
+namespace
+{
+    using Event = InputQueue::Event;
+
+    MouseMotionEventArgs MouseMove(int x, int y, bool leftButton = false)
+    {
+        return MouseMotionEventArgs(leftButton, false, false, false, false, x, y);
+    }
+
+    KeyEventArgs KeyPress(KeyCode::Key key)
+    {
+        return KeyEventArgs(key, 0, KeyEventArgs::Pressed, false, false, false);
+    }
+
+    MouseButtonEventArgs LeftButtonPress(int x, int y)
+    {
+        return MouseButtonEventArgs(MouseButtonEventArgs::Left, MouseButtonEventArgs::Pressed, true, false, false, false, false, x, y);
+    }
+
+    MouseWheelEventArgs Wheel(float wheelDelta, int x, int y)
+    {
+        return MouseWheelEventArgs(wheelDelta, false, false, false, false, false, x, y);
+    }
+}
+
+TEST_CASE(PopAllReturnsTheEventsInOrder)
+{
+    InputQueue queue;
+    queue.Push(KeyPress(KeyCode::A));
+    queue.Push(LeftButtonPress(10, 20));
+    queue.Push(Wheel(1.0f, 10, 20));
+    queue.Push(KeyPress(KeyCode::Escape));
+
+    std::vector<Event> events;
+    queue.PopAll(events);
+
+    CHECK(events.size() == 4);
+    CHECK(std::get<KeyEventArgs>(events[0]).Key == KeyCode::A);
+    CHECK(std::holds_alternative<MouseButtonEventArgs>(events[1]));
+    CHECK(std::holds_alternative<MouseWheelEventArgs>(events[2]));
+    CHECK(std::get<KeyEventArgs>(events[3]).Key == KeyCode::Escape);
+
+    // The queue is empty.
+    events.clear();
+    queue.PopAll(events);
+    CHECK(events.empty());
+}
+
+TEST_CASE(ConsecutiveMouseMovesAreMerged)
+{
+    InputQueue queue;
+    queue.Push(MouseMove(10, 10));
+    queue.Push(MouseMove(15, 12));
+    queue.Push(MouseMove(20, 20, true));
+
+    std::vector<Event> events;
+    queue.PopAll(events);
+
+    // The position and buttons of the last event and the motion of all events
+    // (the first mouse event has no motion).
+    CHECK(events.size() == 1);
+    const MouseMotionEventArgs& mouseMotion = std::get<MouseMotionEventArgs>(events[0]);
+    CHECK(mouseMotion.X == 20);
+    CHECK(mouseMotion.Y == 20);
+    CHECK(mouseMotion.RelX == 10);
+    CHECK(mouseMotion.RelY == 10);
+    CHECK(mouseMotion.LeftButton);
+}
+
+TEST_CASE(MouseMovesAreNotMergedAcrossOtherEvents)
+{
+    InputQueue queue;
+    queue.Push(MouseMove(0, 0));
+    queue.Push(MouseMove(5, 5));
+    queue.Push(KeyPress(KeyCode::A));
+    queue.Push(MouseMove(8, 9));
+
+    std::vector<Event> events;
+    queue.PopAll(events);
+
+    CHECK(events.size() == 3);
+    CHECK(std::get<MouseMotionEventArgs>(events[0]).RelX == 5);
+    CHECK(std::get<MouseMotionEventArgs>(events[0]).RelY == 5);
+    CHECK(std::holds_alternative<KeyEventArgs>(events[1]));
+    CHECK(std::get<MouseMotionEventArgs>(events[2]).RelX == 3);
+    CHECK(std::get<MouseMotionEventArgs>(events[2]).RelY == 4);
+}
+
+TEST_CASE(MouseButtonAndWheelEventsUpdateThePosition)
+{
+    InputQueue queue;
+    queue.Push(MouseMove(0, 0));
+    queue.Push(LeftButtonPress(50, 50));
+    queue.Push(Wheel(-1.0f, 55, 60));
+    queue.Push(MouseMove(60, 62));
+
+    std::vector<Event> events;
+    queue.PopAll(events);
+
+    // The motion is relative to the position of the wheel event.
+    CHECK(events.size() == 4);
+    CHECK(std::get<MouseMotionEventArgs>(events[3]).RelX == 5);
+    CHECK(std::get<MouseMotionEventArgs>(events[3]).RelY == 2);
+}
+
+TEST_CASE(MouseMovesAreOnlyMergedWithinABatch)
+{
+    InputQueue queue;
+    std::vector<Event> events;
+
+    queue.Push(MouseMove(10, 10));
+    queue.PopAll(events);
+
+    queue.Push(MouseMove(12, 14));
+    queue.Push(MouseMove(20, 16));
+    queue.PopAll(events);
+
+    // The events of the previous batch are not changed and the motion
+    // continues from the position of the previous batch.
+    CHECK(events.size() == 2);
+    CHECK(std::get<MouseMotionEventArgs>(events[0]).X == 10);
+    CHECK(std::get<MouseMotionEventArgs>(events[0]).RelX == 0);
+    CHECK(std::get<MouseMotionEventArgs>(events[1]).X == 20);
+    CHECK(std::get<MouseMotionEventArgs>(events[1]).RelX == 10);
+    CHECK(std::get<MouseMotionEventArgs>(events[1]).RelY == 6);
+}
+
+TEST_CASE(EventsAreDroppedWhenTheQueueIsFull)
+{
+    InputQueue queue(4);
+    for (int i = 0; i < 6; ++i)
+    {
+        queue.Push(KeyPress(KeyCode::A));
+    }
+
+    std::vector<Event> events;
+    queue.PopAll(events);
+
+    CHECK(events.size() == 4);
+    CHECK(queue.GetNumDroppedEvents() == 2);
+
+    // There is space again after PopAll.
+    queue.Push(KeyPress(KeyCode::A));
+    events.clear();
+    queue.PopAll(events);
+    CHECK(events.size() == 1);
+    CHECK(queue.GetNumDroppedEvents() == 2);
+}
+
+TEST_CASE(EventsArePushedFromAnotherThread)
+{
+    const size_t numEvents = 100000;
+
+    InputQueue queue(64);
+
+    // The producer pushes dropped events again so all events arrive.
+    std::thread messagePump([&queue, numEvents]()
+    {
+        for (size_t i = 0; i < numEvents; ++i)
+        {
+            KeyEventArgs keyEvent(KeyCode::A, static_cast<unsigned int>(i), KeyEventArgs::Pressed, false, false, false);
+
+            uint64_t numDroppedEvents = queue.GetNumDroppedEvents();
+            queue.Push(keyEvent);
+            while (queue.GetNumDroppedEvents() != numDroppedEvents)
+            {
+                std::this_thread::yield();
+                numDroppedEvents = queue.GetNumDroppedEvents();
+                queue.Push(keyEvent);
+            }
+        }
+    });
+
+    std::vector<Event> events;
+    while (events.size() < numEvents)
+    {
+        queue.PopAll(events);
+        std::this_thread::yield();
+    }
+
+    messagePump.join();
+
+    bool inOrder = true;
+    for (size_t i = 0; i < events.size(); ++i)
+    {
+        inOrder = inOrder && std::get<KeyEventArgs>(events[i]).Char == static_cast<unsigned int>(i);
+    }
+    CHECK(events.size() == numEvents);
+    CHECK(inOrder);
+}
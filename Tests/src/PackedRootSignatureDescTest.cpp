@@ -0,0 +1,302 @@
+#include <Test.h>
+
+#include <PackedRootSignatureDesc.h>
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <utility>
+
+// Count the allocations of the test (the global operator new is replaced).
+static std::atomic<uint64_t> g_NumAllocations(0);
+
+void* operator new(size_t size)
+{
+    g_NumAllocations++;
+    void* pointer = std::malloc(size > 0 ? size : 1);
+    if (!pointer)
+    {
+        throw std::bad_alloc();
+    }
+    return pointer;
+}
+
+void* operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void* pointer) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete[](void* pointer) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete(void* pointer, size_t) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete[](void* pointer, size_t) noexcept
+{
+    std::free(pointer);
+}
+
+namespace
+{
+    // Stand-ins for the D3D12 root signature structures (with the same members).
+    struct DescriptorRange
+    {
+        uint32_t RangeType;
+        uint32_t NumDescriptors;
+        uint32_t BaseShaderRegister;
+        uint32_t RegisterSpace;
+        uint32_t Flags;
+        uint32_t OffsetInDescriptorsFromTableStart;
+    };
+
+    struct RootDescriptorTable
+    {
+        uint32_t NumDescriptorRanges;
+        const DescriptorRange* pDescriptorRanges;
+    };
+
+    struct RootConstants
+    {
+        uint32_t ShaderRegister;
+        uint32_t RegisterSpace;
+        uint32_t Num32BitValues;
+    };
+
+    struct RootParameter
+    {
+        uint32_t ParameterType;
+        union
+        {
+            RootDescriptorTable DescriptorTable;
+            RootConstants Constants;
+        };
+        uint32_t ShaderVisibility;
+    };
+
+    struct StaticSampler
+    {
+        uint32_t Filter;
+        uint32_t AddressU;
+        uint32_t AddressV;
+        uint32_t AddressW;
+        float MipLODBias;
+        uint32_t MaxAnisotropy;
+        uint32_t ComparisonFunc;
+        uint32_t BorderColor;
+        float MinLOD;
+        float MaxLOD;
+        uint32_t ShaderRegister;
+        uint32_t RegisterSpace;
+        uint32_t ShaderVisibility;
+    };
+
+    struct RootSignatureDesc
+    {
+        uint32_t NumParameters;
+        const RootParameter* pParameters;
+        uint32_t NumStaticSamplers;
+        const StaticSampler* pStaticSamplers;
+        uint32_t Flags;
+    };
+
+    using PackedDesc = PackedRootSignatureDesc<RootSignatureDesc>;
+
+    // Matches D3D12_ROOT_PARAMETER_TYPE and D3D12_DESCRIPTOR_RANGE_TYPE.
+    const uint32_t DescriptorTable = 0;
+    const uint32_t Constants = 1;
+    const uint32_t SRV = 0;
+    const uint32_t UAV = 1;
+    const uint32_t Sampler = 3;
+
+    /**
+     * A root signature with root constants (root parameter 0), a table of
+     * 4 textures and 2 UAVs (root parameter 1), a table of 2 samplers
+     * (root parameter 2) and a static sampler.
+     */
+    class TestRootSignature
+    {
+    public:
+        TestRootSignature()
+        {
+            m_TextureRanges[0] = { SRV, 4, 0, 0, 0, 0 };
+            m_TextureRanges[1] = { UAV, 2, 0, 0, 0, 4 };
+            m_SamplerRanges[0] = { Sampler, 2, 0, 0, 0, 0 };
+
+            m_Parameters[0].ParameterType = Constants;
+            m_Parameters[0].Constants = { 0, 0, 16 };
+            m_Parameters[0].ShaderVisibility = 1;
+
+            m_Parameters[1].ParameterType = DescriptorTable;
+            m_Parameters[1].DescriptorTable = { 2, m_TextureRanges };
+            m_Parameters[1].ShaderVisibility = 5;
+
+            m_Parameters[2].ParameterType = DescriptorTable;
+            m_Parameters[2].DescriptorTable = { 1, m_SamplerRanges };
+            m_Parameters[2].ShaderVisibility = 5;
+
+            m_StaticSampler = { 0x15, 1, 1, 1, 0.0f, 16, 0, 0, 0.0f, 1000.0f, 2, 0, 5 };
+
+            m_Desc = { 3, m_Parameters, 1, &m_StaticSampler, 0x1 };
+        }
+
+        const RootSignatureDesc& GetDesc() const
+        {
+            return m_Desc;
+        }
+
+    private:
+        DescriptorRange m_TextureRanges[2];
+        DescriptorRange m_SamplerRanges[1];
+        RootParameter m_Parameters[3];
+        StaticSampler m_StaticSampler;
+        RootSignatureDesc m_Desc;
+    };
+
+    bool IsInStorage(const PackedDesc& packedDesc, const void* pointer)
+    {
+        const uint8_t* begin = reinterpret_cast<const uint8_t*>(packedDesc.GetDesc().pParameters);
+        const uint8_t* bytes = static_cast<const uint8_t*>(pointer);
+        return bytes >= begin && bytes < begin + packedDesc.GetStorageSize();
+    }
+
+    // Check that the packed description matches the test root signature.
+    bool MatchesTestRootSignature(const PackedDesc& packedDesc)
+    {
+        const RootSignatureDesc& desc = packedDesc.GetDesc();
+        if (desc.NumParameters != 3 || desc.NumStaticSamplers != 1 || desc.Flags != 0x1)
+        {
+            return false;
+        }
+
+        const RootDescriptorTable& textures = desc.pParameters[1].DescriptorTable;
+        const RootDescriptorTable& samplers = desc.pParameters[2].DescriptorTable;
+
+        return desc.pParameters[0].Constants.Num32BitValues == 16 &&
+            textures.NumDescriptorRanges == 2 &&
+            textures.pDescriptorRanges[1].RangeType == UAV &&
+            textures.pDescriptorRanges[1].OffsetInDescriptorsFromTableStart == 4 &&
+            samplers.NumDescriptorRanges == 1 &&
+            samplers.pDescriptorRanges[0].NumDescriptors == 2 &&
+            desc.pStaticSamplers[0].MaxLOD == 1000.0f &&
+            IsInStorage(packedDesc, textures.pDescriptorRanges) &&
+            IsInStorage(packedDesc, samplers.pDescriptorRanges) &&
+            IsInStorage(packedDesc, desc.pStaticSamplers);
+    }
+}
+
+TEST_CASE(StoreMakesASingleAllocation)
+{
+    TestRootSignature rootSignature;
+
+    uint64_t numAllocations = g_NumAllocations;
+    PackedDesc packedDesc(rootSignature.GetDesc());
+
+    CHECK(g_NumAllocations - numAllocations == 1);
+    CHECK(MatchesTestRootSignature(packedDesc));
+
+    // The parameters, static samplers and descriptor ranges are tightly packed.
+    CHECK(packedDesc.GetStorageSize() == 3 * sizeof(RootParameter) + sizeof(StaticSampler) + 3 * sizeof(DescriptorRange));
+    CHECK(packedDesc.GetStorageSize() == PackedDesc::ComputeStorageSize(rootSignature.GetDesc()));
+}
+
+TEST_CASE(StoreComputesTheDescriptorTables)
+{
+    TestRootSignature rootSignature;
+    PackedDesc packedDesc(rootSignature.GetDesc());
+
+    CHECK(packedDesc.GetDescriptorTableBitMask() == (1u << 1));
+    CHECK(packedDesc.GetSamplerTableBitMask() == (1u << 2));
+    CHECK(packedDesc.GetNumDescriptors(0) == 0);
+    CHECK(packedDesc.GetNumDescriptors(1) == 6);
+    CHECK(packedDesc.GetNumDescriptors(2) == 2);
+}
+
+TEST_CASE(CopyMakesASingleAllocation)
+{
+    TestRootSignature rootSignature;
+    std::unique_ptr<PackedDesc> original = std::make_unique<PackedDesc>(rootSignature.GetDesc());
+
+    uint64_t numAllocations = g_NumAllocations;
+    PackedDesc copy(*original);
+    CHECK(g_NumAllocations - numAllocations == 1);
+
+    // The pointers of the copy are relocated to its own storage block.
+    CHECK(copy.GetDesc().pParameters != original->GetDesc().pParameters);
+    original.reset();
+
+    CHECK(MatchesTestRootSignature(copy));
+    CHECK(copy.GetNumDescriptors(1) == 6);
+    CHECK(copy.GetSamplerTableBitMask() == (1u << 2));
+
+    // Copy assignment.
+    PackedDesc assigned;
+    numAllocations = g_NumAllocations;
+    assigned = copy;
+    CHECK(g_NumAllocations - numAllocations == 1);
+    CHECK(MatchesTestRootSignature(assigned));
+}
+
+TEST_CASE(MoveMakesNoAllocation)
+{
+    TestRootSignature rootSignature;
+    PackedDesc original(rootSignature.GetDesc());
+    const RootParameter* pParameters = original.GetDesc().pParameters;
+
+    uint64_t numAllocations = g_NumAllocations;
+    PackedDesc moved(std::move(original));
+    PackedDesc assigned;
+    assigned = std::move(moved);
+    CHECK(g_NumAllocations == numAllocations);
+
+    // The description still points into the same storage block.
+    CHECK(assigned.GetDesc().pParameters == pParameters);
+    CHECK(MatchesTestRootSignature(assigned));
+
+    CHECK(original.GetStorageSize() == 0);
+    CHECK(original.GetDesc().NumParameters == 0);
+    CHECK(original.GetDescriptorTableBitMask() == 0);
+    CHECK(moved.GetDesc().pParameters == nullptr);
+}
+
+TEST_CASE(EmptyDescriptionsMakeNoAllocation)
+{
+    RootSignatureDesc emptyDesc = { 0, nullptr, 0, nullptr, 0 };
+
+    uint64_t numAllocations = g_NumAllocations;
+    PackedDesc packedDesc(emptyDesc);
+    PackedDesc copy(packedDesc);
+    CHECK(g_NumAllocations == numAllocations);
+
+    CHECK(packedDesc.GetStorageSize() == 0);
+    CHECK(copy.GetDesc().pParameters == nullptr);
+    CHECK(copy.GetDesc().pStaticSamplers == nullptr);
+}
+
+TEST_CASE(StoreReplacesTheDescription)
+{
+    TestRootSignature rootSignature;
+    PackedDesc packedDesc(rootSignature.GetDesc());
+
+    // Only the root constants.
+    RootSignatureDesc desc = rootSignature.GetDesc();
+    desc.NumParameters = 1;
+    desc.NumStaticSamplers = 0;
+    desc.pStaticSamplers = nullptr;
+    packedDesc.Store(desc);
+
+    CHECK(packedDesc.GetDesc().NumParameters == 1);
+    CHECK(packedDesc.GetStorageSize() == sizeof(RootParameter));
+    CHECK(packedDesc.GetDescriptorTableBitMask() == 0);
+    CHECK(packedDesc.GetSamplerTableBitMask() == 0);
+    CHECK(packedDesc.GetNumDescriptors(1) == 0);
+}
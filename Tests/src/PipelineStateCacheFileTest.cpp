@@ -0,0 +1,135 @@
+#include <Test.h>
+
+#include <Hash.h>
+#include <PipelineStateCacheFile.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+namespace
+{
+    using Header = PipelineStateCacheFile::Header;
+    using Entry = PipelineStateCacheFile::Entry;
+
+    const uint64_t DeviceHash = 0xDEADBEEF;
+
+    const std::vector<uint8_t> Blob1 = { 1, 2, 3 };
+    const std::vector<uint8_t> Blob2 = { 4, 5, 6, 7, 8 };
+
+    std::vector<uint8_t> SerializeBlobs()
+    {
+        PipelineStateCacheFile::BlobMap blobs;
+        blobs[20] = { Blob2.data(), Blob2.size() };
+        blobs[10] = { Blob1.data(), Blob1.size() };
+        return PipelineStateCacheFile::Serialize(blobs, DeviceHash);
+    }
+
+    // Modify a field of the image and update the checksum (so only the
+    // modified field makes the file invalid).
+    template<typename T>
+    void Patch(std::vector<uint8_t>& image, size_t offset, T value)
+    {
+        memcpy(image.data() + offset, &value, sizeof(T));
+
+        uint64_t checksum = HashBytes(image.data() + sizeof(Header), image.size() - sizeof(Header));
+        memcpy(image.data() + offsetof(Header, Checksum), &checksum, sizeof(checksum));
+    }
+
+    bool IsEqual(const PipelineStateCacheFile::Blob& blob, const std::vector<uint8_t>& expected)
+    {
+        return blob.Size == expected.size() && memcmp(blob.Data, expected.data(), blob.Size) == 0;
+    }
+}
+
+TEST_CASE(BlobsSurviveARoundTrip)
+{
+    std::vector<uint8_t> image = SerializeBlobs();
+    CHECK(image.size() == sizeof(Header) + 2 * sizeof(Entry) + Blob1.size() + Blob2.size());
+
+    PipelineStateCacheFile cacheFile;
+    CHECK(cacheFile.Load(image.data(), image.size(), DeviceHash));
+    CHECK(cacheFile.GetBlobs().size() == 2);
+    CHECK(IsEqual(cacheFile.Find(10), Blob1));
+    CHECK(IsEqual(cacheFile.Find(20), Blob2));
+
+    // The blobs point into the file image.
+    CHECK(cacheFile.Find(10).Data >= image.data());
+    CHECK(cacheFile.Find(10).Data < image.data() + image.size());
+
+    PipelineStateCacheFile::Blob missing = cacheFile.Find(30);
+    CHECK(missing.Data == nullptr);
+    CHECK(missing.Size == 0);
+
+    // Serializing the loaded blobs produces the same image.
+    CHECK(PipelineStateCacheFile::Serialize(cacheFile.GetBlobs(), DeviceHash) == image);
+}
+
+TEST_CASE(EmptyCacheIsValid)
+{
+    std::vector<uint8_t> image = PipelineStateCacheFile::Serialize(PipelineStateCacheFile::BlobMap(), DeviceHash);
+    CHECK(image.size() == sizeof(Header));
+
+    PipelineStateCacheFile cacheFile;
+    CHECK(cacheFile.Load(image.data(), image.size(), DeviceHash));
+    CHECK(cacheFile.GetBlobs().empty());
+}
+
+TEST_CASE(FileOfAnotherDeviceIsRejected)
+{
+    std::vector<uint8_t> image = SerializeBlobs();
+
+    PipelineStateCacheFile cacheFile;
+    CHECK(!cacheFile.Load(image.data(), image.size(), DeviceHash + 1));
+    CHECK(cacheFile.GetBlobs().empty());
+}
+
+TEST_CASE(BadHeaderIsRejected)
+{
+    PipelineStateCacheFile cacheFile;
+
+    std::vector<uint8_t> badMagic = SerializeBlobs();
+    Patch(badMagic, offsetof(Header, Magic), uint32_t(0x12345678));
+    CHECK(!cacheFile.Load(badMagic.data(), badMagic.size(), DeviceHash));
+
+    std::vector<uint8_t> badVersion = SerializeBlobs();
+    Patch(badVersion, offsetof(Header, Version), PipelineStateCacheFile::Version + 1);
+    CHECK(!cacheFile.Load(badVersion.data(), badVersion.size(), DeviceHash));
+
+    std::vector<uint8_t> badChecksum = SerializeBlobs();
+    badChecksum.back() ^= 0xFF;
+    CHECK(!cacheFile.Load(badChecksum.data(), badChecksum.size(), DeviceHash));
+
+    CHECK(!cacheFile.Load(nullptr, 0, DeviceHash));
+    CHECK(cacheFile.GetBlobs().empty());
+}
+
+TEST_CASE(TruncatedFileIsRejected)
+{
+    std::vector<uint8_t> image = SerializeBlobs();
+
+    PipelineStateCacheFile cacheFile;
+    CHECK(cacheFile.Load(image.data(), image.size(), DeviceHash));
+
+    // A failed load clears the cache.
+    CHECK(!cacheFile.Load(image.data(), sizeof(Header) - 1, DeviceHash));
+    CHECK(cacheFile.GetBlobs().empty());
+
+    // The entries don't fit in the file.
+    CHECK(!cacheFile.Load(image.data(), sizeof(Header) + sizeof(Entry), DeviceHash));
+
+    // The blob data was cut off (the checksum doesn't match).
+    CHECK(!cacheFile.Load(image.data(), image.size() - 1, DeviceHash));
+
+    // The checksum matches, but the header has more entries than the file.
+    std::vector<uint8_t> tooManyEntries = image;
+    Patch(tooManyEntries, offsetof(Header, NumEntries), uint64_t(3));
+    CHECK(!cacheFile.Load(tooManyEntries.data(), tooManyEntries.size(), DeviceHash));
+
+    // The checksum matches, but the blob of the second entry ends after the file.
+    std::vector<uint8_t> blobOutOfRange = image;
+    Patch(blobOutOfRange, sizeof(Header) + sizeof(Entry) + offsetof(Entry, Size), uint64_t(Blob2.size() + 1));
+    CHECK(!cacheFile.Load(blobOutOfRange.data(), blobOutOfRange.size(), DeviceHash));
+    CHECK(cacheFile.GetBlobs().empty());
+}
@@ -0,0 +1,98 @@
+#include <Test.h>
+
+#include <PipelineStateKey.h>
+
+#include <cstdint>
+#include <vector>
+
+namespace
+{
+    using Field = PipelineStateKey::Field;
+
+    // A pipeline state with a vertex shader, a pixel shader, and a single render target.
+    PipelineStateKey BuildKey(const std::vector<uint8_t>& vs, const std::vector<uint8_t>& ps, uint32_t renderTargetFormat)
+    {
+        PipelineStateKey key;
+        key.AddRootSignature(0x1234);
+        key.AddShader(Field::VS, vs.data(), vs.size());
+        key.AddShader(Field::PS, ps.data(), ps.size());
+        key.AddString(Field::InputLayout, "POSITION");
+        key.AddValue(Field::RenderTargetFormats, renderTargetFormat);
+        return key;
+    }
+}
+
+TEST_CASE(EqualDescriptionsHaveEqualKeys)
+{
+    std::vector<uint8_t> vs = { 1, 2, 3, 4 };
+    std::vector<uint8_t> ps = { 5, 6, 7, 8 };
+
+    // The shaders are added by their contents, not by their address.
+    std::vector<uint8_t> vsCopy = vs;
+    std::vector<uint8_t> psCopy = ps;
+
+    CHECK(BuildKey(vs, ps, 28).GetHash() == BuildKey(vsCopy, psCopy, 28).GetHash());
+    CHECK(BuildKey(vs, ps, 28).GetHash() != BuildKey(vs, ps, 29).GetHash());
+    CHECK(BuildKey(vs, ps, 28).GetHash() != BuildKey(ps, vs, 28).GetHash());
+}
+
+TEST_CASE(ValuesAreTaggedWithTheirField)
+{
+    PipelineStateKey sampleMask;
+    sampleMask.AddValue(Field::SampleMask, 1);
+
+    PipelineStateKey nodeMask;
+    nodeMask.AddValue(Field::NodeMask, 1);
+
+    CHECK(sampleMask.GetHash() != nodeMask.GetHash());
+
+    // The same bytecode used as a vertex shader or a pixel shader.
+    std::vector<uint8_t> bytecode = { 1, 2, 3, 4 };
+    PipelineStateKey vs;
+    vs.AddShader(Field::VS, bytecode.data(), bytecode.size());
+    PipelineStateKey ps;
+    ps.AddShader(Field::PS, bytecode.data(), bytecode.size());
+
+    CHECK(vs.GetHash() != ps.GetHash());
+}
+
+TEST_CASE(StringsDontCollideAcrossBoundaries)
+{
+    PipelineStateKey key1;
+    key1.AddString(Field::InputLayout, "TEXCOORD");
+    key1.AddString(Field::InputLayout, "0");
+
+    PipelineStateKey key2;
+    key2.AddString(Field::InputLayout, "TEXCOORD0");
+
+    PipelineStateKey key3;
+    key3.AddString(Field::InputLayout, "TEXCOOR");
+    key3.AddString(Field::InputLayout, "D0");
+
+    CHECK(key1.GetHash() != key2.GetHash());
+    CHECK(key1.GetHash() != key3.GetHash());
+    CHECK(key2.GetHash() != key3.GetHash());
+}
+
+TEST_CASE(MissingValuesAreDistinct)
+{
+    PipelineStateKey nullString;
+    nullString.AddString(Field::InputLayout, nullptr);
+    PipelineStateKey emptyString;
+    emptyString.AddString(Field::InputLayout, "");
+
+    CHECK(nullString.GetHash() == emptyString.GetHash());
+
+    // A pipeline state without a pixel shader is not the same as one without a field.
+    PipelineStateKey noShader;
+    noShader.AddShader(Field::PS, nullptr, 0);
+    CHECK(noShader.GetHash() != PipelineStateKey().GetHash());
+
+    // The shader hash is not the same as the bytes of the shader.
+    std::vector<uint8_t> bytecode = { 1, 2, 3, 4 };
+    PipelineStateKey shader;
+    shader.AddShader(Field::PS, bytecode.data(), bytecode.size());
+    PipelineStateKey bytes;
+    bytes.AddBytes(Field::PS, bytecode.data(), bytecode.size());
+    CHECK(shader.GetHash() != bytes.GetHash());
+}
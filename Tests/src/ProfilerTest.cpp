@@ -0,0 +1,174 @@
+#include <Test.h>
+
+#include <FastClock.h>
+#include <Profiler.h>
+
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    // The profiler is shared by the test cases, so each test case uses its own zone names.
+    Profiler::ZoneStatistics FindZone(const char* name)
+    {
+        for (const Profiler::ZoneStatistics& zone : Profiler::Get().GetStatistics())
+        {
+            if (zone.Name == name)
+            {
+                return zone;
+            }
+        }
+        return Profiler::ZoneStatistics();
+    }
+
+    std::string ReadFile(const std::filesystem::path& path)
+    {
+        std::ifstream file(path);
+        return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+}
+
+TEST_CASE(StatisticsAreComputedOverTheHistory)
+{
+    Profiler& profiler = Profiler::Get();
+
+    // Start with a full history.
+    for (uint32_t i = 0; i < Profiler::NumHistoryFrames; ++i)
+    {
+        CHECK(profiler.EndFrame());
+    }
+
+    profiler.AddZone("Statistics Zone", 1000, 1100);
+    profiler.AddZone("Statistics Zone", 2000, 2300);
+    profiler.EndFrame();
+    profiler.AddZone("Statistics Zone", 3000, 3200);
+    profiler.EndFrame();
+
+    const double secondsPerTick = FastClock::GetSecondsPerTick();
+
+    Profiler::ZoneStatistics zone = FindZone("Statistics Zone");
+    CHECK(zone.NumFrames == Profiler::NumHistoryFrames);
+    CHECK_NEAR(3.0 / Profiler::NumHistoryFrames, zone.CallsPerFrame, 1e-12);
+    CHECK_NEAR(600 * secondsPerTick / Profiler::NumHistoryFrames, zone.AverageTime, 1e-15);
+    CHECK(zone.MinTime == 0.0);
+    CHECK_NEAR(400 * secondsPerTick, zone.MaxTime, 1e-15);
+
+    // The zone leaves the history after NumHistoryFrames frames.
+    for (uint32_t i = 0; i < Profiler::NumHistoryFrames; ++i)
+    {
+        profiler.EndFrame();
+    }
+    zone = FindZone("Statistics Zone");
+    CHECK(zone.CallsPerFrame == 0.0);
+    CHECK(zone.MaxTime == 0.0);
+
+    CHECK(profiler.GetStatisticsTable().find("Statistics Zone") != std::string::npos);
+}
+
+TEST_CASE(TraceIsWrittenAfterTheLastFrame)
+{
+    Profiler& profiler = Profiler::Get();
+    std::filesystem::path traceFile = std::filesystem::temp_directory_path() / "ProfilerTest-trace.json";
+
+    // Zones that were recorded before the trace started are not in the trace.
+    profiler.AddZone("Early Zone", 0, 1);
+
+    profiler.SetThreadName("Main \"Thread\"");
+    profiler.BeginTrace(traceFile.string(), 2);
+
+    uint64_t start = Profiler::GetTimestamp();
+    profiler.AddZone("Trace Zone", start, start + 10);
+    CHECK(profiler.EndFrame());
+    CHECK(!std::filesystem::exists(traceFile));
+
+    {
+        PROFILE_SCOPE("Scoped Zone");
+    }
+    CHECK(profiler.EndFrame());
+
+    std::string trace = ReadFile(traceFile);
+    std::filesystem::remove(traceFile);
+
+    CHECK(trace.find("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[") == 0);
+    CHECK(trace.find("\"name\":\"Trace Zone\",\"ph\":\"X\"") != std::string::npos);
+    CHECK(trace.find("\"name\":\"Scoped Zone\"") != std::string::npos);
+    CHECK(trace.find("Early Zone") == std::string::npos);
+    // The thread name is escaped.
+    CHECK(trace.find("\"args\":{\"name\":\"Main \\\"Thread\\\"\"}") != std::string::npos);
+    CHECK(trace.find("]}") != std::string::npos);
+
+    // The trace is only written once.
+    CHECK(profiler.EndFrame());
+    CHECK(!std::filesystem::exists(traceFile));
+}
+
+TEST_CASE(FailedTraceIsReported)
+{
+    Profiler& profiler = Profiler::Get();
+    std::filesystem::path traceFile = std::filesystem::temp_directory_path() / "ProfilerTest-missing" / "trace.json";
+
+    profiler.BeginTrace(traceFile.string(), 1);
+    CHECK(!profiler.EndFrame());
+}
+
+TEST_CASE(ThreadBuffersAreReused)
+{
+    Profiler& profiler = Profiler::Get();
+
+    // Make sure the main thread has a buffer.
+    profiler.AddZone("Main Zone", 0, 1);
+    profiler.EndFrame();
+    size_t numThreadBuffers = profiler.GetNumThreadBuffers();
+
+    const uint32_t numThreads = 10;
+    for (uint32_t i = 0; i < numThreads; ++i)
+    {
+        std::thread thread([]()
+        {
+            Profiler::Get().AddZone("Worker Zone", 0, 10);
+        });
+        thread.join();
+
+        profiler.EndFrame();
+    }
+
+    // The zones of the threads were collected and all threads used the same buffer.
+    CHECK_NEAR(numThreads, FindZone("Worker Zone").CallsPerFrame * Profiler::NumHistoryFrames, 1e-9);
+    CHECK(profiler.GetNumThreadBuffers() == numThreadBuffers + 1);
+
+    // Threads that are alive at the same time use their own buffers.
+    std::vector<std::thread> threads;
+    std::atomic<uint32_t> numStarted(0);
+    std::atomic<bool> exit(false);
+    for (uint32_t i = 0; i < 3; ++i)
+    {
+        threads.emplace_back([&]()
+        {
+            Profiler::Get().AddZone("Worker Zone", 0, 10);
+            numStarted++;
+            while (!exit)
+            {
+                std::this_thread::yield();
+            }
+        });
+    }
+    while (numStarted < 3)
+    {
+        std::this_thread::yield();
+    }
+    CHECK(profiler.GetNumThreadBuffers() == numThreadBuffers + 3);
+
+    exit = true;
+    for (std::thread& thread : threads)
+    {
+        thread.join();
+    }
+    profiler.EndFrame();
+    CHECK(profiler.GetNumThreadBuffers() == numThreadBuffers + 3);
+    CHECK(profiler.GetNumDroppedZones() == 0);
+}
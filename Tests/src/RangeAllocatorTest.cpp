@@ -0,0 +1,137 @@
+#include <Test.h>
+
+#include <RangeAllocator.h>
+
+#include <random>
+#include <vector>
+
+TEST_CASE(RangesArePackedFromTheStart)
+{
+    RangeAllocator allocator(1024);
+
+    CHECK(allocator.Allocate(100) == 0);
+    CHECK(allocator.Allocate(28) == 100);
+    CHECK(allocator.GetFreeSize() == 1024 - 128);
+    CHECK(allocator.GetNumAllocations() == 2);
+    CHECK(allocator.GetNumFreeBlocks() == 1);
+}
+
+TEST_CASE(RangesAreAlignedToTheStride)
+{
+    RangeAllocator allocator(1024);
+
+    CHECK(allocator.Allocate(10) == 0);
+    // A vertex stride that is not a power of two.
+    uint64_t offset = allocator.Allocate(24 * 3, 24);
+    CHECK(offset == 24);
+    // The padding in front of the range is returned to the free list.
+    CHECK(allocator.GetNumFreeBlocks() == 2);
+    CHECK(allocator.Allocate(14) == 10);
+}
+
+TEST_CASE(FreedRangesAreMerged)
+{
+    RangeAllocator allocator(300);
+
+    uint64_t a = allocator.Allocate(100);
+    uint64_t b = allocator.Allocate(100);
+    uint64_t c = allocator.Allocate(100);
+    CHECK(!allocator.HasSpace(1));
+    CHECK(allocator.Allocate(1) == RangeAllocator::InvalidOffset);
+
+    allocator.Free(a, 100);
+    allocator.Free(c, 100);
+    CHECK(allocator.GetNumFreeBlocks() == 2);
+    CHECK(!allocator.HasSpace(200));
+
+    // Merged with the previous and the next block.
+    allocator.Free(b, 100);
+    CHECK(allocator.GetNumFreeBlocks() == 1);
+    CHECK(allocator.IsEmpty());
+    CHECK(allocator.GetNumAllocations() == 0);
+    CHECK(allocator.Allocate(300) == 0);
+}
+
+TEST_CASE(SmallestFittingBlockIsUsed)
+{
+    RangeAllocator allocator(1000);
+
+    uint64_t a = allocator.Allocate(200);
+    allocator.Allocate(10);
+    uint64_t b = allocator.Allocate(50);
+    allocator.Allocate(10);
+
+    allocator.Free(a, 200);
+    allocator.Free(b, 50);
+
+    // The 50 byte block fits better than the 200 byte block.
+    CHECK(allocator.Allocate(40) == b);
+}
+
+TEST_CASE(InvalidRequestsFail)
+{
+    RangeAllocator allocator(100);
+
+    CHECK(allocator.Allocate(0) == RangeAllocator::InvalidOffset);
+    CHECK(allocator.Allocate(101) == RangeAllocator::InvalidOffset);
+    CHECK(RangeAllocator(0).Allocate(1) == RangeAllocator::InvalidOffset);
+}
+
+TEST_CASE(RandomRangesDoNotOverlap)
+{
+    const uint64_t size = 1 << 20;
+    RangeAllocator allocator(size);
+    std::mt19937 random(1);
+
+    struct Range
+    {
+        uint64_t Offset;
+        uint64_t Size;
+    };
+    std::vector<Range> ranges;
+
+    for (int i = 0; i < 10000; ++i)
+    {
+        if (!ranges.empty() && random() % 2 == 0)
+        {
+            size_t index = random() % ranges.size();
+            allocator.Free(ranges[index].Offset, ranges[index].Size);
+            ranges[index] = ranges.back();
+            ranges.pop_back();
+        }
+        else
+        {
+            uint64_t rangeSize = 1 + random() % 4096;
+            uint64_t alignment = 1 + random() % 64;
+            uint64_t offset = allocator.Allocate(rangeSize, alignment);
+            if (offset != RangeAllocator::InvalidOffset)
+            {
+                CHECK(offset % alignment == 0);
+                CHECK(offset + rangeSize <= size);
+                ranges.push_back({ offset, rangeSize });
+            }
+        }
+    }
+
+    uint64_t allocatedSize = 0;
+    for (size_t i = 0; i < ranges.size(); ++i)
+    {
+        allocatedSize += ranges[i].Size;
+        for (size_t j = i + 1; j < ranges.size(); ++j)
+        {
+            const Range& a = ranges[i];
+            const Range& b = ranges[j];
+            CHECK(a.Offset + a.Size <= b.Offset || b.Offset + b.Size <= a.Offset);
+        }
+    }
+
+    CHECK(allocator.GetNumAllocations() == ranges.size());
+    CHECK(allocator.GetFreeSize() == size - allocatedSize);
+
+    for (const Range& range : ranges)
+    {
+        allocator.Free(range.Offset, range.Size);
+    }
+    CHECK(allocator.IsEmpty());
+    CHECK(allocator.GetNumFreeBlocks() == 1);
+}
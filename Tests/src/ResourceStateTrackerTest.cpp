@@ -0,0 +1,303 @@
+#include <Test.h>
+
+#include <ResourceStateTracker.h>
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace
+{
+    // Matches D3D12_RESOURCE_STATES.
+    const uint32_t CopyDest = 0x400;
+    const uint32_t CopySource = 0x800;
+    const uint32_t PixelShaderResource = 0x80;
+    const uint32_t RenderTarget = 0x4;
+    const uint32_t Present = 0;
+
+    /**
+     * Records the barriers that are flushed by the resource state tracker
+     * instead of submitting them to a D3D12 command list.
+     */
+    class MockCommandList
+    {
+    public:
+        ResourceStateTracker::ResourceBarrierFunction GetResourceBarrierFunction()
+        {
+            return [this](uint32_t numBarriers, const ResourceStateTracker::Barrier* barriers)
+            {
+                m_NumResourceBarrierCalls++;
+                m_Barriers.insert(m_Barriers.end(), barriers, barriers + numBarriers);
+            };
+        }
+
+        uint32_t GetNumResourceBarrierCalls() const
+        {
+            return m_NumResourceBarrierCalls;
+        }
+
+        const std::vector<ResourceStateTracker::Barrier>& GetBarriers() const
+        {
+            return m_Barriers;
+        }
+
+    private:
+        uint32_t m_NumResourceBarrierCalls = 0;
+        std::vector<ResourceStateTracker::Barrier> m_Barriers;
+    };
+
+    // A resource that is registered in the global resource state while it is alive.
+    class Resource
+    {
+    public:
+        explicit Resource(uint32_t state, uint32_t numSubresources = 1)
+        {
+            ResourceStateTracker::AddGlobalResourceState(this, state, numSubresources);
+        }
+
+        ~Resource()
+        {
+            ResourceStateTracker::RemoveGlobalResourceState(this);
+        }
+
+        // The address of the resource is registered.
+        Resource(const Resource&) = delete;
+        Resource& operator=(const Resource&) = delete;
+    };
+
+    // Close a command list: resolve the pending barriers and commit the final states.
+    uint32_t Close(ResourceStateTracker& tracker, MockCommandList& commandList, MockCommandList& pendingCommandList)
+    {
+        tracker.FlushResourceBarriers(commandList.GetResourceBarrierFunction());
+
+        ResourceStateTracker::Lock();
+        uint32_t numPendingBarriers = tracker.FlushPendingResourceBarriers(pendingCommandList.GetResourceBarrierFunction());
+        tracker.CommitFinalResourceStates();
+        ResourceStateTracker::Unlock();
+
+        return numPendingBarriers;
+    }
+
+    bool IsTransition(const ResourceStateTracker::Barrier& barrier, void* resource, uint32_t subresource, uint32_t stateBefore, uint32_t stateAfter)
+    {
+        return barrier.Type == ResourceStateTracker::BarrierType::Transition &&
+            barrier.Transition.Resource == resource &&
+            barrier.Transition.Subresource == subresource &&
+            barrier.Transition.StateBefore == stateBefore &&
+            barrier.Transition.StateAfter == stateAfter;
+    }
+}
+
+TEST_CASE(FirstTransitionIsResolvedAgainstGlobalState)
+{
+    Resource resource(Present);
+    ResourceStateTracker tracker;
+    MockCommandList commandList;
+    MockCommandList pendingCommandList;
+
+    tracker.TransitionResource(&resource, RenderTarget);
+    tracker.TransitionResource(&resource, Present);
+
+    // The state of the resource is not known on the command list, so the first
+    // transition is pending. The second transition is known.
+    CHECK(Close(tracker, commandList, pendingCommandList) == 1);
+
+    CHECK(pendingCommandList.GetNumResourceBarrierCalls() == 1);
+    CHECK(pendingCommandList.GetBarriers().size() == 1);
+    CHECK(IsTransition(pendingCommandList.GetBarriers()[0], &resource, ResourceStateTracker::AllSubresources, Present, RenderTarget));
+
+    CHECK(commandList.GetNumResourceBarrierCalls() == 1);
+    CHECK(commandList.GetBarriers().size() == 1);
+    CHECK(IsTransition(commandList.GetBarriers()[0], &resource, ResourceStateTracker::AllSubresources, RenderTarget, Present));
+}
+
+TEST_CASE(PendingTransitionToGlobalStateIsDropped)
+{
+    Resource resource(CopyDest);
+    ResourceStateTracker tracker;
+    MockCommandList commandList;
+    MockCommandList pendingCommandList;
+
+    tracker.TransitionResource(&resource, CopyDest);
+
+    CHECK(Close(tracker, commandList, pendingCommandList) == 0);
+    CHECK(pendingCommandList.GetNumResourceBarrierCalls() == 0);
+    CHECK(commandList.GetNumResourceBarrierCalls() == 0);
+    CHECK(tracker.GetStatistics().NumRedundantTransitions == 1);
+}
+
+TEST_CASE(FinalStateIsCommitted)
+{
+    Resource resource(Present);
+
+    {
+        ResourceStateTracker tracker;
+        MockCommandList commandList;
+        MockCommandList pendingCommandList;
+
+        tracker.TransitionResource(&resource, RenderTarget);
+        Close(tracker, commandList, pendingCommandList);
+    }
+
+    // The next command list starts in the committed state.
+    ResourceStateTracker tracker;
+    MockCommandList commandList;
+    MockCommandList pendingCommandList;
+
+    tracker.TransitionResource(&resource, PixelShaderResource);
+
+    CHECK(Close(tracker, commandList, pendingCommandList) == 1);
+    CHECK(IsTransition(pendingCommandList.GetBarriers()[0], &resource, ResourceStateTracker::AllSubresources, RenderTarget, PixelShaderResource));
+}
+
+TEST_CASE(RedundantTransitionsAreDropped)
+{
+    Resource resource(Present);
+    ResourceStateTracker tracker;
+    MockCommandList commandList;
+    MockCommandList pendingCommandList;
+
+    tracker.TransitionResource(&resource, CopyDest);
+    tracker.FlushResourceBarriers(commandList.GetResourceBarrierFunction());
+
+    for (int i = 0; i < 10; ++i)
+    {
+        tracker.TransitionResource(&resource, CopyDest);
+        tracker.FlushResourceBarriers(commandList.GetResourceBarrierFunction());
+    }
+
+    CHECK(commandList.GetNumResourceBarrierCalls() == 0);
+    CHECK(tracker.GetStatistics().NumTransitions == 11);
+    CHECK(tracker.GetStatistics().NumRedundantTransitions == 10);
+
+    Close(tracker, commandList, pendingCommandList);
+}
+
+TEST_CASE(TransitionsInBatchAreMerged)
+{
+    Resource a(Present);
+    Resource b(Present);
+    ResourceStateTracker tracker;
+    MockCommandList commandList;
+    MockCommandList pendingCommandList;
+
+    // Make the state of the resources known on the command list.
+    tracker.TransitionResource(&a, CopyDest);
+    tracker.TransitionResource(&b, CopyDest);
+
+    // A -> B, B -> C is merged into A -> C.
+    tracker.TransitionResource(&a, CopySource);
+    tracker.TransitionResource(&a, PixelShaderResource);
+    // A -> B, B -> A cancel each other out.
+    tracker.TransitionResource(&b, CopySource);
+    tracker.TransitionResource(&b, CopyDest);
+
+    CHECK(tracker.FlushResourceBarriers(commandList.GetResourceBarrierFunction()) == 1);
+    CHECK(commandList.GetNumResourceBarrierCalls() == 1);
+    CHECK(IsTransition(commandList.GetBarriers()[0], &a, ResourceStateTracker::AllSubresources, CopyDest, PixelShaderResource));
+    CHECK(tracker.GetStatistics().NumMergedTransitions == 2);
+
+    CHECK(Close(tracker, commandList, pendingCommandList) == 2);
+    CHECK(pendingCommandList.GetNumResourceBarrierCalls() == 1);
+}
+
+TEST_CASE(TransitionsAreNotMergedAcrossUAVBarriers)
+{
+    Resource resource(Present);
+    ResourceStateTracker tracker;
+    MockCommandList commandList;
+    MockCommandList pendingCommandList;
+
+    tracker.TransitionResource(&resource, CopyDest);
+    tracker.TransitionResource(&resource, CopySource);
+    tracker.UAVBarrier(&resource);
+    tracker.TransitionResource(&resource, PixelShaderResource);
+
+    CHECK(tracker.FlushResourceBarriers(commandList.GetResourceBarrierFunction()) == 3);
+    CHECK(commandList.GetBarriers()[1].Type == ResourceStateTracker::BarrierType::UAV);
+    CHECK(tracker.GetStatistics().NumMergedTransitions == 0);
+
+    Close(tracker, commandList, pendingCommandList);
+}
+
+TEST_CASE(SubresourcesInDifferentStatesAreSplit)
+{
+    const uint32_t numSubresources = 4;
+    Resource resource(PixelShaderResource, numSubresources);
+    ResourceStateTracker tracker;
+    MockCommandList commandList;
+    MockCommandList pendingCommandList;
+
+    // Generate a mip chain: the first mip is read, the second is written.
+    tracker.TransitionResource(&resource, CopySource, 0);
+    tracker.TransitionResource(&resource, CopyDest, 1);
+    tracker.FlushResourceBarriers(commandList.GetResourceBarrierFunction());
+
+    // Transition the whole resource back. The known subresources get a barrier, the
+    // state of the other subresources is resolved when the command list is closed.
+    tracker.TransitionResource(&resource, PixelShaderResource);
+    CHECK(tracker.FlushResourceBarriers(commandList.GetResourceBarrierFunction()) == 2);
+    CHECK(IsTransition(commandList.GetBarriers()[0], &resource, 0, CopySource, PixelShaderResource));
+    CHECK(IsTransition(commandList.GetBarriers()[1], &resource, 1, CopyDest, PixelShaderResource));
+
+    // Subresources 0 and 1 were in the global state, 2 and 3 are already in the requested state.
+    CHECK(Close(tracker, commandList, pendingCommandList) == 2);
+    CHECK(IsTransition(pendingCommandList.GetBarriers()[0], &resource, 0, PixelShaderResource, CopySource));
+    CHECK(IsTransition(pendingCommandList.GetBarriers()[1], &resource, 1, PixelShaderResource, CopyDest));
+}
+
+TEST_CASE(BarriersAreBatched)
+{
+    const int numResources = 16;
+    std::vector< std::unique_ptr<Resource> > resources;
+    for (int i = 0; i < numResources; ++i)
+    {
+        resources.push_back(std::make_unique<Resource>(Present));
+    }
+
+    ResourceStateTracker tracker;
+    MockCommandList commandList;
+    MockCommandList pendingCommandList;
+
+    for (int frame = 0; frame < 2; ++frame)
+    {
+        for (std::unique_ptr<Resource>& resource : resources)
+        {
+            tracker.TransitionResource(resource.get(), RenderTarget);
+        }
+        tracker.FlushResourceBarriers(commandList.GetResourceBarrierFunction());
+
+        for (std::unique_ptr<Resource>& resource : resources)
+        {
+            tracker.TransitionResource(resource.get(), Present);
+        }
+        tracker.FlushResourceBarriers(commandList.GetResourceBarrierFunction());
+    }
+
+    // One call per flush (the first batch is pending).
+    CHECK(commandList.GetNumResourceBarrierCalls() == 3);
+    CHECK(commandList.GetBarriers().size() == 3 * numResources);
+    CHECK(Close(tracker, commandList, pendingCommandList) == numResources);
+    CHECK(pendingCommandList.GetNumResourceBarrierCalls() == 1);
+
+    const ResourceStateTracker::Statistics& statistics = tracker.GetStatistics();
+    CHECK(statistics.NumTransitions == 4 * numResources);
+    CHECK(statistics.NumBarriers == 4 * numResources);
+    CHECK(statistics.NumFlushes == 4);
+
+    tracker.Reset();
+    CHECK(tracker.GetStatistics().NumTransitions == 0);
+}
+
+TEST_CASE(GlobalStateIsRemoved)
+{
+    // The address is captured while the resource is alive. It is only used
+    // as a key after the resource is destroyed.
+    uintptr_t address = 0;
+    {
+        Resource resource(Present);
+        address = reinterpret_cast<uintptr_t>(&resource);
+        CHECK(ResourceStateTracker::HasGlobalResourceState(&resource));
+    }
+    CHECK(!ResourceStateTracker::HasGlobalResourceState(reinterpret_cast<void*>(address)));
+}
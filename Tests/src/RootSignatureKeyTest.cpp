@@ -0,0 +1,170 @@
+#include <Test.h>
+
+#include <RootSignatureKey.h>
+
+namespace
+{
+    using Version = RootSignatureKey::Version;
+    using ParameterType = RootSignatureKey::ParameterType;
+    using DescriptorRange = RootSignatureKey::DescriptorRange;
+    using DescriptorRangeType = RootSignatureKey::DescriptorRangeType;
+
+    const uint32_t Append = RootSignatureKey::DescriptorRangeOffsetAppend;
+
+    // Matches D3D12_SHADER_VISIBILITY.
+    const uint32_t VisibilityAll = 0;
+    const uint32_t VisibilityPixel = 5;
+
+    // Matches D3D12_DESCRIPTOR_RANGE_FLAGS and D3D12_ROOT_DESCRIPTOR_FLAGS.
+    const uint32_t DataStatic = 0x8;
+
+    // A root signature with a table of 4 textures and 2 UAVs.
+    RootSignatureKey BuildTableKey(Version version, uint32_t uavOffset, uint32_t textureFlags = 0)
+    {
+        RootSignatureKey key(version, 0, 1);
+        key.AddDescriptorTable(VisibilityPixel, 2);
+        key.AddDescriptorRange({ DescriptorRangeType::SRV, 4, 0, 0, textureFlags, 0 });
+        key.AddDescriptorRange({ DescriptorRangeType::UAV, 2, 0, 0, 0, uavOffset });
+        key.AddStaticSamplers(0);
+        return key;
+    }
+
+    RootSignatureKey::StaticSampler LinearSampler()
+    {
+        // D3D12_FILTER_MIN_MAG_MIP_LINEAR, D3D12_TEXTURE_ADDRESS_MODE_WRAP.
+        return { 0x15, 1, 1, 1, 0.0f, 16, 0, 0, 0.0f, 3.402823466e+38f, 0, 0, VisibilityPixel };
+    }
+}
+
+TEST_CASE(AppendedRangesMatchExplicitOffsets)
+{
+    RootSignatureKey appended = BuildTableKey(Version::V1_1, Append);
+    RootSignatureKey explicitOffset = BuildTableKey(Version::V1_1, 4);
+
+    CHECK(appended == explicitOffset);
+    CHECK(appended.GetHash() == explicitOffset.GetHash());
+
+    // A gap between the ranges is a different layout.
+    RootSignatureKey gap = BuildTableKey(Version::V1_1, 8);
+    CHECK(!(appended == gap));
+}
+
+TEST_CASE(AppendedRangesFollowExplicitOffsets)
+{
+    RootSignatureKey appended(Version::V1_1, 0, 1);
+    appended.AddDescriptorTable(VisibilityAll, 3);
+    appended.AddDescriptorRange({ DescriptorRangeType::CBV, 1, 0, 0, 0, 10 });
+    appended.AddDescriptorRange({ DescriptorRangeType::SRV, 2, 0, 0, 0, Append });
+    appended.AddDescriptorRange({ DescriptorRangeType::UAV, 1, 0, 0, 0, Append });
+    appended.AddStaticSamplers(0);
+
+    RootSignatureKey explicitOffsets(Version::V1_1, 0, 1);
+    explicitOffsets.AddDescriptorTable(VisibilityAll, 3);
+    explicitOffsets.AddDescriptorRange({ DescriptorRangeType::CBV, 1, 0, 0, 0, 10 });
+    explicitOffsets.AddDescriptorRange({ DescriptorRangeType::SRV, 2, 0, 0, 0, 11 });
+    explicitOffsets.AddDescriptorRange({ DescriptorRangeType::UAV, 1, 0, 0, 0, 13 });
+    explicitOffsets.AddStaticSamplers(0);
+
+    CHECK(appended == explicitOffsets);
+}
+
+TEST_CASE(AppendedRangesRestartInEachTable)
+{
+    RootSignatureKey key(Version::V1_1, 0, 2);
+    key.AddDescriptorTable(VisibilityAll, 1);
+    key.AddDescriptorRange({ DescriptorRangeType::SRV, 4, 0, 0, 0, Append });
+    key.AddDescriptorTable(VisibilityAll, 1);
+    key.AddDescriptorRange({ DescriptorRangeType::SRV, 4, 4, 0, 0, Append });
+    key.AddStaticSamplers(0);
+
+    RootSignatureKey expected(Version::V1_1, 0, 2);
+    expected.AddDescriptorTable(VisibilityAll, 1);
+    expected.AddDescriptorRange({ DescriptorRangeType::SRV, 4, 0, 0, 0, 0 });
+    expected.AddDescriptorTable(VisibilityAll, 1);
+    expected.AddDescriptorRange({ DescriptorRangeType::SRV, 4, 4, 0, 0, 0 });
+    expected.AddStaticSamplers(0);
+
+    CHECK(key == expected);
+}
+
+TEST_CASE(UnboundedRangesDoNotAdvanceTheOffset)
+{
+    RootSignatureKey key(Version::V1_1, 0, 1);
+    key.AddDescriptorTable(VisibilityAll, 1);
+    key.AddDescriptorRange({ DescriptorRangeType::SRV, RootSignatureKey::UnboundedNumDescriptors, 0, 0, 0, Append });
+    key.AddStaticSamplers(0);
+
+    // The offset of the (only) range is resolved to 0.
+    const std::vector<uint32_t>& values = key.GetValues();
+    CHECK(values.size() == 3 + 3 + 6 + 1);
+    CHECK(values[11] == 0);
+}
+
+TEST_CASE(RangeFlagsAreIgnoredByVersion10)
+{
+    CHECK(BuildTableKey(Version::V1_0, Append, DataStatic) == BuildTableKey(Version::V1_0, Append));
+    CHECK(!(BuildTableKey(Version::V1_1, Append, DataStatic) == BuildTableKey(Version::V1_1, Append)));
+
+    // The version is part of the key.
+    CHECK(!(BuildTableKey(Version::V1_0, Append) == BuildTableKey(Version::V1_1, Append)));
+}
+
+TEST_CASE(RootDescriptorFlagsAreIgnoredByVersion10)
+{
+    RootSignatureKey staticCBV(Version::V1_0, 0, 1);
+    staticCBV.AddDescriptor(ParameterType::CBV, VisibilityAll, 0, 0, DataStatic);
+    staticCBV.AddStaticSamplers(0);
+
+    RootSignatureKey cbv(Version::V1_0, 0, 1);
+    cbv.AddDescriptor(ParameterType::CBV, VisibilityAll, 0, 0, 0);
+    cbv.AddStaticSamplers(0);
+
+    CHECK(staticCBV == cbv);
+}
+
+TEST_CASE(ParameterTypesAreDistinguished)
+{
+    // The same register as a root CBV, SRV and root constants.
+    RootSignatureKey cbv(Version::V1_1, 0, 1);
+    cbv.AddDescriptor(ParameterType::CBV, VisibilityAll, 0, 0, 0);
+    cbv.AddStaticSamplers(0);
+
+    RootSignatureKey srv(Version::V1_1, 0, 1);
+    srv.AddDescriptor(ParameterType::SRV, VisibilityAll, 0, 0, 0);
+    srv.AddStaticSamplers(0);
+
+    RootSignatureKey constants(Version::V1_1, 0, 1);
+    constants.AddConstants(VisibilityAll, 0, 0, 0);
+    constants.AddStaticSamplers(0);
+
+    CHECK(!(cbv == srv));
+    CHECK(!(cbv == constants));
+    CHECK(cbv.GetHash() != srv.GetHash());
+    CHECK(cbv.GetHash() != constants.GetHash());
+}
+
+TEST_CASE(StaticSamplersAreCompared)
+{
+    RootSignatureKey::StaticSampler sampler = LinearSampler();
+
+    RootSignatureKey key(Version::V1_1, 0, 0);
+    key.AddStaticSamplers(1);
+    key.AddStaticSampler(sampler);
+
+    RootSignatureKey same(Version::V1_1, 0, 0);
+    same.AddStaticSamplers(1);
+    same.AddStaticSampler(LinearSampler());
+
+    sampler.MipLODBias = 0.5f;
+    RootSignatureKey biased(Version::V1_1, 0, 0);
+    biased.AddStaticSamplers(1);
+    biased.AddStaticSampler(sampler);
+
+    CHECK(key == same);
+    CHECK(!(key == biased));
+
+    // Samplers are not root parameters.
+    RootSignatureKey noSamplers(Version::V1_1, 0, 0);
+    noSamplers.AddStaticSamplers(0);
+    CHECK(!(key == noSamplers));
+}
@@ -0,0 +1,232 @@
+#include <Test.h>
+
+#include <RootSignatureOptimizer.h>
+
+#include <cstddef>
+#include <vector>
+
+namespace
+{
+    using Binding = RootSignatureOptimizer::Binding;
+    using BindingType = RootSignatureOptimizer::BindingType;
+    using ShaderVisibility = RootSignatureOptimizer::ShaderVisibility;
+    using ParameterType = RootSignatureOptimizer::ParameterType;
+    using UpdateFrequency = RootSignatureOptimizer::UpdateFrequency;
+    using Layout = RootSignatureOptimizer::Layout;
+
+    const uint32_t Unbounded = RootSignatureOptimizer::UnboundedNumDescriptors;
+
+    Binding MakeBinding(BindingType type, uint32_t shaderRegister, UpdateFrequency frequency,
+        ShaderVisibility visibility = ShaderVisibility::All)
+    {
+        Binding binding;
+        binding.Type = type;
+        binding.ShaderRegister = shaderRegister;
+        binding.Frequency = frequency;
+        binding.Visibility = visibility;
+        return binding;
+    }
+
+    Binding MakeConstantBuffer(uint32_t shaderRegister, uint32_t sizeInBytes, UpdateFrequency frequency)
+    {
+        Binding binding = MakeBinding(BindingType::CBV, shaderRegister, frequency);
+        binding.SizeInBytes = sizeInBytes;
+        return binding;
+    }
+
+    // Check that the ranges of the descriptor tables don't overlap and that an
+    // unbounded range is only used as the last range of a table.
+    bool HasValidRanges(const Layout& layout)
+    {
+        for (const RootSignatureOptimizer::RootParameter& parameter : layout.Parameters)
+        {
+            uint32_t offset = 0;
+            for (size_t i = 0; i < parameter.Ranges.size(); ++i)
+            {
+                const RootSignatureOptimizer::DescriptorRange& range = parameter.Ranges[i];
+                if (range.OffsetInDescriptorsFromTableStart != offset)
+                {
+                    return false;
+                }
+                if (range.NumDescriptors == Unbounded && i + 1 != parameter.Ranges.size())
+                {
+                    return false;
+                }
+                offset += range.NumDescriptors;
+            }
+        }
+        return true;
+    }
+}
+
+TEST_CASE(ParametersAreSortedByUpdateFrequency)
+{
+    std::vector<Binding> bindings = {
+        MakeBinding(BindingType::SRV, 0, UpdateFrequency::PerFrame),
+        MakeBinding(BindingType::SRV, 1, UpdateFrequency::PerDraw),
+        MakeBinding(BindingType::Sampler, 0, UpdateFrequency::PerMaterial),
+    };
+
+    Layout layout = RootSignatureOptimizer::Optimize(bindings);
+
+    CHECK(layout.Parameters.size() == 3);
+    CHECK(layout.Parameters[0].Frequency == UpdateFrequency::PerDraw);
+    CHECK(layout.Parameters[1].Frequency == UpdateFrequency::PerMaterial);
+    CHECK(layout.Parameters[2].Frequency == UpdateFrequency::PerFrame);
+    CHECK(layout.NumDWORDs == 3);
+
+    CHECK(layout.Remap[0].RootParameterIndex == 2);
+    CHECK(layout.Remap[1].RootParameterIndex == 0);
+    CHECK(layout.Remap[2].RootParameterIndex == 1);
+}
+
+TEST_CASE(RootConstantsArePromotedWithinTheBudget)
+{
+    std::vector<Binding> bindings = {
+        MakeConstantBuffer(0, 64, UpdateFrequency::PerDraw),
+        // Too large for root constants.
+        MakeConstantBuffer(1, 256, UpdateFrequency::PerFrame),
+        MakeConstantBuffer(2, 64, UpdateFrequency::PerMaterial),
+    };
+
+    // Both small constant buffers fit in the default budget.
+    Layout layout = RootSignatureOptimizer::Optimize(bindings);
+    CHECK(layout.Parameters.size() == 3);
+    CHECK(layout.Parameters[0].Type == ParameterType::Constants);
+    CHECK(layout.Parameters[0].ShaderRegister == 0);
+    CHECK(layout.Parameters[0].Num32BitValues == 16);
+    CHECK(layout.Parameters[1].Type == ParameterType::Constants);
+    CHECK(layout.Parameters[1].ShaderRegister == 2);
+    CHECK(layout.Parameters[2].Type == ParameterType::DescriptorTable);
+    CHECK(layout.NumDWORDs == 33);
+    CHECK(layout.NumDWORDs <= RootSignatureOptimizer::MaxRootSignatureDWORDs);
+
+    // Only the most frequently updated constant buffer fits in a smaller budget.
+    RootSignatureOptimizer::Settings settings;
+    settings.MaxRootDWORDs = 20;
+    layout = RootSignatureOptimizer::Optimize(bindings, settings);
+    CHECK(layout.Parameters.size() == 3);
+    CHECK(layout.Parameters[0].Type == ParameterType::Constants);
+    CHECK(layout.Parameters[0].ShaderRegister == 0);
+    CHECK(layout.Parameters[1].Type == ParameterType::DescriptorTable);
+    CHECK(layout.Parameters[1].Frequency == UpdateFrequency::PerMaterial);
+    CHECK(layout.Parameters[2].Type == ParameterType::DescriptorTable);
+    CHECK(layout.NumDWORDs == 18);
+
+    // Root constants are not used if promotion is disabled.
+    settings.PromoteRootConstants = false;
+    layout = RootSignatureOptimizer::Optimize(bindings, settings);
+    CHECK(layout.NumDWORDs == 3);
+}
+
+TEST_CASE(AdjacentRegistersAreMergedIntoOneTable)
+{
+    Binding textureArray = MakeBinding(BindingType::SRV, 1, UpdateFrequency::PerMaterial);
+    textureArray.NumDescriptors = 2;
+
+    std::vector<Binding> bindings = {
+        MakeBinding(BindingType::SRV, 3, UpdateFrequency::PerMaterial),
+        MakeBinding(BindingType::UAV, 0, UpdateFrequency::PerMaterial),
+        MakeBinding(BindingType::SRV, 0, UpdateFrequency::PerMaterial),
+        textureArray,
+    };
+
+    Layout layout = RootSignatureOptimizer::Optimize(bindings);
+    CHECK(layout.Parameters.size() == 1);
+    CHECK(layout.NumDWORDs == 1);
+
+    const std::vector<RootSignatureOptimizer::DescriptorRange>& ranges = layout.Parameters[0].Ranges;
+    CHECK(ranges.size() == 2);
+    CHECK(ranges[0].Type == BindingType::SRV);
+    CHECK(ranges[0].BaseShaderRegister == 0);
+    CHECK(ranges[0].NumDescriptors == 4);
+    CHECK(ranges[1].Type == BindingType::UAV);
+    CHECK(ranges[1].NumDescriptors == 1);
+    CHECK(ranges[1].OffsetInDescriptorsFromTableStart == 4);
+
+    CHECK(layout.Remap[0].DescriptorOffset == 3);
+    CHECK(layout.Remap[1].DescriptorOffset == 4);
+    CHECK(layout.Remap[2].DescriptorOffset == 0);
+    CHECK(layout.Remap[3].DescriptorOffset == 1);
+
+    // Each binding has its own table if merging is disabled.
+    RootSignatureOptimizer::Settings settings;
+    settings.MergeDescriptorTables = false;
+    layout = RootSignatureOptimizer::Optimize(bindings, settings);
+    CHECK(layout.Parameters.size() == 4);
+    CHECK(layout.NumDWORDs == 4);
+}
+
+TEST_CASE(BindingsOfMultipleStagesShareALocation)
+{
+    std::vector<Binding> bindings = {
+        MakeBinding(BindingType::CBV, 0, UpdateFrequency::PerFrame, ShaderVisibility::Vertex),
+        MakeBinding(BindingType::SRV, 0, UpdateFrequency::PerMaterial, ShaderVisibility::Pixel),
+        MakeBinding(BindingType::CBV, 0, UpdateFrequency::PerDraw, ShaderVisibility::Pixel),
+    };
+
+    Layout layout = RootSignatureOptimizer::Optimize(bindings);
+    CHECK(layout.Parameters.size() == 2);
+    CHECK(layout.Remap.size() == 3);
+
+    // The constant buffer is visible to all stages and uses the highest frequency.
+    CHECK(layout.Remap[0].RootParameterIndex == 0);
+    CHECK(layout.Remap[2].RootParameterIndex == 0);
+    CHECK(layout.Remap[1].RootParameterIndex == 1);
+    CHECK(layout.Parameters[0].Visibility == ShaderVisibility::All);
+    CHECK(layout.Parameters[0].Frequency == UpdateFrequency::PerDraw);
+    CHECK(layout.Parameters[1].Visibility == ShaderVisibility::Pixel);
+}
+
+TEST_CASE(UnboundedRangesAreLastInTheirTable)
+{
+    // A bindless texture array in space 1 sorts before the UAV by type.
+    Binding textures = MakeBinding(BindingType::SRV, 0, UpdateFrequency::PerFrame);
+    textures.RegisterSpace = 1;
+    textures.NumDescriptors = Unbounded;
+
+    std::vector<Binding> bindings = {
+        textures,
+        MakeBinding(BindingType::UAV, 0, UpdateFrequency::PerFrame),
+    };
+
+    Layout layout = RootSignatureOptimizer::Optimize(bindings);
+    CHECK(layout.Parameters.size() == 1);
+    CHECK(HasValidRanges(layout));
+
+    const std::vector<RootSignatureOptimizer::DescriptorRange>& ranges = layout.Parameters[0].Ranges;
+    CHECK(ranges.size() == 2);
+    CHECK(ranges[0].Type == BindingType::UAV);
+    CHECK(ranges[0].OffsetInDescriptorsFromTableStart == 0);
+    CHECK(ranges[1].Type == BindingType::SRV);
+    CHECK(ranges[1].NumDescriptors == Unbounded);
+    CHECK(ranges[1].OffsetInDescriptorsFromTableStart == 1);
+
+    CHECK(layout.Remap[0].DescriptorOffset == 1);
+    CHECK(layout.Remap[1].DescriptorOffset == 0);
+}
+
+TEST_CASE(UnboundedRangesUseSeparateTables)
+{
+    Binding textures = MakeBinding(BindingType::SRV, 0, UpdateFrequency::PerFrame);
+    textures.RegisterSpace = 1;
+    textures.NumDescriptors = Unbounded;
+
+    Binding buffers = textures;
+    buffers.RegisterSpace = 2;
+
+    std::vector<Binding> bindings = {
+        textures,
+        buffers,
+        MakeBinding(BindingType::CBV, 0, UpdateFrequency::PerFrame),
+    };
+
+    // A table can only have a single unbounded range.
+    Layout layout = RootSignatureOptimizer::Optimize(bindings);
+    CHECK(layout.Parameters.size() == 2);
+    CHECK(HasValidRanges(layout));
+    CHECK(layout.Remap[0].RootParameterIndex != layout.Remap[1].RootParameterIndex);
+    CHECK(layout.Remap[0].RootParameterIndex == layout.Remap[2].RootParameterIndex);
+    CHECK(layout.Remap[0].DescriptorOffset == 1);
+    CHECK(layout.Remap[1].DescriptorOffset == 0);
+}
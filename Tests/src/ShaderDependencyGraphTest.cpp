@@ -0,0 +1,107 @@
+#include <Test.h>
+
+#include <ShaderDependencyGraph.h>
+
+#include <filesystem>
+#include <set>
+#include <vector>
+
+namespace
+{
+    using ShaderId = ShaderDependencyGraph::ShaderId;
+    using PipelineId = ShaderDependencyGraph::PipelineId;
+
+    enum Shaders : ShaderId
+    {
+        VertexShader,
+        PixelShader,
+        ComputeShader,
+    };
+
+    enum Pipelines : PipelineId
+    {
+        OpaquePipeline,
+        ShadowPipeline,
+        CullingPipeline,
+    };
+
+    // The pipelines that must be rebuilt when the file changes.
+    std::set<PipelineId> GetAffectedPipelines(const ShaderDependencyGraph& graph, const std::filesystem::path& file)
+    {
+        return graph.GetPipelines(graph.GetShaders({ file }));
+    }
+
+    // Two shaders that share an include file and a compute shader, used by three pipelines.
+    ShaderDependencyGraph BuildGraph()
+    {
+        ShaderDependencyGraph graph;
+        graph.SetShaderFiles(VertexShader, { "Shaders/VertexShader.hlsl", "Shaders/Common.hlsli" });
+        graph.SetShaderFiles(PixelShader, { "Shaders/PixelShader.hlsl", "Shaders/Common.hlsli" });
+        graph.SetShaderFiles(ComputeShader, { "Shaders/Culling.hlsl" });
+
+        graph.SetPipelineShaders(OpaquePipeline, { VertexShader, PixelShader });
+        graph.SetPipelineShaders(ShadowPipeline, { VertexShader });
+        graph.SetPipelineShaders(CullingPipeline, { ComputeShader });
+        return graph;
+    }
+}
+
+TEST_CASE(ChangedFilesMapToThePipelinesThatUseThem)
+{
+    ShaderDependencyGraph graph = BuildGraph();
+
+    CHECK(graph.GetShaders({ "Shaders/Common.hlsli" }) == std::set<ShaderId>({ VertexShader, PixelShader }));
+    CHECK(GetAffectedPipelines(graph, "Shaders/Common.hlsli") == std::set<PipelineId>({ OpaquePipeline, ShadowPipeline }));
+    CHECK(GetAffectedPipelines(graph, "Shaders/PixelShader.hlsl") == std::set<PipelineId>({ OpaquePipeline }));
+    CHECK(GetAffectedPipelines(graph, "Shaders/Culling.hlsl") == std::set<PipelineId>({ CullingPipeline }));
+    CHECK(GetAffectedPipelines(graph, "Shaders/Unused.hlsl").empty());
+
+    // The files are compared by their normalized path.
+    CHECK(GetAffectedPipelines(graph, "Shaders/../Shaders/./Culling.hlsl") == std::set<PipelineId>({ CullingPipeline }));
+}
+
+TEST_CASE(ShaderFilesAreReplaced)
+{
+    ShaderDependencyGraph graph = BuildGraph();
+
+    // The pixel shader no longer includes the common file.
+    graph.SetShaderFiles(PixelShader, { "Shaders/PixelShader.hlsl", "Shaders/Lighting.hlsli" });
+
+    CHECK(graph.GetShaders({ "Shaders/Common.hlsli" }) == std::set<ShaderId>({ VertexShader }));
+    CHECK(GetAffectedPipelines(graph, "Shaders/Lighting.hlsli") == std::set<PipelineId>({ OpaquePipeline }));
+
+    // Removing the last shader of a file removes the file.
+    graph.SetShaderFiles(ComputeShader, { "Shaders/Culling2.hlsl" });
+    CHECK(graph.GetShaders({ "Shaders/Culling.hlsl" }).empty());
+    CHECK(graph.GetDirectories().size() == 1);
+    CHECK(*graph.GetDirectories().begin() == ShaderDependencyGraph::NormalizePath("Shaders"));
+}
+
+TEST_CASE(RemovedPipelinesAreNotRebuilt)
+{
+    ShaderDependencyGraph graph = BuildGraph();
+
+    graph.RemovePipeline(ShadowPipeline);
+    CHECK(GetAffectedPipelines(graph, "Shaders/VertexShader.hlsl") == std::set<PipelineId>({ OpaquePipeline }));
+    CHECK(graph.GetPipelineShaders(ShadowPipeline).empty());
+
+    graph.RemovePipeline(OpaquePipeline);
+    CHECK(GetAffectedPipelines(graph, "Shaders/Common.hlsli").empty());
+
+    // The shaders are still tracked (they may be used by a new pipeline).
+    CHECK(graph.GetShaders({ "Shaders/Common.hlsli" }).size() == 2);
+
+    // Removing an unknown pipeline has no effect.
+    graph.RemovePipeline(ShadowPipeline);
+    CHECK(GetAffectedPipelines(graph, "Shaders/Culling.hlsl") == std::set<PipelineId>({ CullingPipeline }));
+}
+
+TEST_CASE(PipelineShadersAreReplaced)
+{
+    ShaderDependencyGraph graph = BuildGraph();
+
+    graph.SetPipelineShaders(ShadowPipeline, { ComputeShader });
+    CHECK(graph.GetPipelineShaders(ShadowPipeline) == std::vector<ShaderId>({ ComputeShader }));
+    CHECK(GetAffectedPipelines(graph, "Shaders/VertexShader.hlsl") == std::set<PipelineId>({ OpaquePipeline }));
+    CHECK(GetAffectedPipelines(graph, "Shaders/Culling.hlsl") == std::set<PipelineId>({ ShadowPipeline, CullingPipeline }));
+}
@@ -0,0 +1,73 @@
+#include <Test.h>
+
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+namespace
+{
+    struct TestCase
+    {
+        const char* Name;
+        Test::TestFunction Function;
+    };
+
+    // Function-local so the registration of the test cases does not depend
+    // on the initialization order of the translation units.
+    std::vector<TestCase>& GetTestCases()
+    {
+        static std::vector<TestCase> testCases;
+        return testCases;
+    }
+
+    unsigned int g_NumFailedChecks = 0;
+}
+
+bool Test::Register(const char* name, TestFunction function)
+{
+    GetTestCases().push_back({ name, function });
+    return true;
+}
+
+void Test::Fail(const char* file, int line, const char* expression)
+{
+    fprintf(stderr, "%s(%d): check failed: %s\n", file, line, expression);
+    ++g_NumFailedChecks;
+}
+
+/**
+ * Run all test cases, or only the test cases whose names are passed on the command line.
+ */
+int main(int argc, char* argv[])
+{
+    unsigned int numTestCases = 0;
+    unsigned int numFailedTestCases = 0;
+
+    for (const TestCase& testCase : GetTestCases())
+    {
+        bool selected = argc < 2;
+        for (int i = 1; i < argc; ++i)
+        {
+            selected |= strcmp(argv[i], testCase.Name) == 0;
+        }
+        if (!selected)
+        {
+            continue;
+        }
+
+        unsigned int numFailedChecks = g_NumFailedChecks;
+        testCase.Function();
+        ++numTestCases;
+
+        bool passed = g_NumFailedChecks == numFailedChecks;
+        if (!passed)
+        {
+            ++numFailedTestCases;
+        }
+        printf("[%s] %s\n", passed ? "  OK  " : "FAILED", testCase.Name);
+    }
+
+    printf("%u test cases, %u failed\n", numTestCases, numFailedTestCases);
+
+    return numFailedTestCases == 0 ? 0 : 1;
+}
@@ -0,0 +1,230 @@
+#include <Test.h>
+
+#include <AsyncHandle.h>
+#include <ThreadPool.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace
+{
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * Creates "pipelines" on a thread pool like Tutorial2::LoadContent. The
+     * creation of a pipeline is simulated by sleeping for the creation cost,
+     * so the workers overlap even on a machine with a single core.
+     */
+    class SimulatedPipelineCompiler
+    {
+    public:
+        SimulatedPipelineCompiler(ThreadPool& threadPool, std::chrono::milliseconds creationCost)
+            : m_ThreadPool(threadPool)
+            , m_CreationCost(creationCost)
+            , m_NumCreating(0)
+            , m_MaxNumCreating(0)
+            , m_NumCreated(0)
+        {}
+
+        // Returns the id of the pipeline when it is created.
+        AsyncHandle<uint32_t> Compile(uint32_t pipelineId)
+        {
+            return AsyncHandle<uint32_t>(m_ThreadPool.Submit([this, pipelineId]()
+            {
+                uint32_t numCreating = ++m_NumCreating;
+                uint32_t maxNumCreating = m_MaxNumCreating.load();
+                while (numCreating > maxNumCreating && !m_MaxNumCreating.compare_exchange_weak(maxNumCreating, numCreating))
+                {
+                }
+
+                std::this_thread::sleep_for(m_CreationCost);
+
+                --m_NumCreating;
+                ++m_NumCreated;
+                return pipelineId;
+            }));
+        }
+
+        // The maximum number of pipelines that were created at the same time.
+        uint32_t GetMaxNumCreating() const
+        {
+            return m_MaxNumCreating;
+        }
+
+        uint32_t GetNumCreated() const
+        {
+            return m_NumCreated;
+        }
+
+    private:
+        ThreadPool& m_ThreadPool;
+        std::chrono::milliseconds m_CreationCost;
+
+        std::atomic<uint32_t> m_NumCreating;
+        std::atomic<uint32_t> m_MaxNumCreating;
+        std::atomic<uint32_t> m_NumCreated;
+    };
+}
+
+TEST_CASE(SubmittedTasksReturnTheirResults)
+{
+    ThreadPool threadPool(2);
+
+    std::vector< std::future<int> > futures;
+    for (int i = 0; i < 16; ++i)
+    {
+        futures.push_back(threadPool.Submit([i]() { return i * i; }));
+    }
+
+    bool correct = true;
+    for (int i = 0; i < 16; ++i)
+    {
+        correct = correct && futures[i].get() == i * i;
+    }
+    CHECK(correct);
+    CHECK(threadPool.GetNumThreads() == 2);
+}
+
+TEST_CASE(ExceptionsAreStoredInTheFuture)
+{
+    ThreadPool threadPool(1);
+
+    AsyncHandle<int> handle(threadPool.Submit([]() -> int
+    {
+        throw std::runtime_error("Failed to create the pipeline state.");
+    }));
+    handle.Wait();
+
+    bool thrown = false;
+    try
+    {
+        handle.GetOr(0);
+    }
+    catch (const std::runtime_error&)
+    {
+        thrown = true;
+    }
+    CHECK(thrown);
+
+    // The worker keeps running.
+    CHECK(threadPool.Submit([]() { return 1; }).get() == 1);
+}
+
+TEST_CASE(WaitIdleWaitsForAllTasks)
+{
+    ThreadPool threadPool(3);
+    SimulatedPipelineCompiler compiler(threadPool, std::chrono::milliseconds(2));
+
+    for (uint32_t i = 0; i < 12; ++i)
+    {
+        compiler.Compile(i);
+    }
+    threadPool.WaitIdle();
+
+    CHECK(compiler.GetNumCreated() == 12);
+    CHECK(threadPool.GetNumPendingTasks() == 0);
+}
+
+TEST_CASE(PipelinesAreCreatedInParallel)
+{
+    const size_t numThreads = 4;
+    const uint32_t numPipelines = 16;
+    const std::chrono::milliseconds creationCost(20);
+
+    ThreadPool threadPool(numThreads);
+    SimulatedPipelineCompiler compiler(threadPool, creationCost);
+
+    Clock::time_point start = Clock::now();
+
+    std::vector< AsyncHandle<uint32_t> > pipelines;
+    for (uint32_t i = 0; i < numPipelines; ++i)
+    {
+        pipelines.push_back(compiler.Compile(i));
+    }
+
+    bool correct = true;
+    for (uint32_t i = 0; i < numPipelines; ++i)
+    {
+        correct = correct && pipelines[i].Get() == i;
+    }
+
+    Clock::duration elapsed = Clock::now() - start;
+
+    CHECK(correct);
+    CHECK(compiler.GetMaxNumCreating() > 1);
+    CHECK(compiler.GetMaxNumCreating() <= numThreads);
+    // Creating the pipelines one after the other takes numPipelines * creationCost.
+    CHECK(elapsed < creationCost * numPipelines);
+}
+
+TEST_CASE(RenderLoopUsesTheFallbackWhileCompiling)
+{
+    const uint32_t fallback = ~0u;
+    const uint32_t numPipelines = 8;
+
+    ThreadPool threadPool(2);
+    SimulatedPipelineCompiler compiler(threadPool, std::chrono::milliseconds(10));
+
+    std::vector< AsyncHandle<uint32_t> > pipelines;
+    for (uint32_t i = 0; i < numPipelines; ++i)
+    {
+        pipelines.push_back(compiler.Compile(i));
+    }
+
+    // Render frames (of 1 ms) until all pipelines are ready. The frames never
+    // wait for the compilation.
+    uint32_t numFrames = 0;
+    uint32_t numFallbackFrames = 0;
+    bool allReady = false;
+    while (!allReady)
+    {
+        allReady = true;
+        for (uint32_t i = 0; i < numPipelines; ++i)
+        {
+            uint32_t pipeline = pipelines[i].GetOr(fallback);
+            if (pipeline == fallback)
+            {
+                allReady = false;
+            }
+            else
+            {
+                CHECK(pipeline == i);
+            }
+        }
+
+        if (!allReady)
+        {
+            numFallbackFrames++;
+        }
+        numFrames++;
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    // 8 pipelines on 2 threads take at least 40 ms.
+    CHECK(numFallbackFrames > 0);
+    CHECK(numFrames == numFallbackFrames + 1);
+    CHECK(compiler.GetNumCreated() == numPipelines);
+}
+
+TEST_CASE(DestructorFinishesQueuedTasks)
+{
+    std::atomic<uint32_t> numExecuted(0);
+    {
+        ThreadPool threadPool(1);
+        for (int i = 0; i < 5; ++i)
+        {
+            threadPool.Submit([&numExecuted]()
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                ++numExecuted;
+            });
+        }
+    }
+
+    CHECK(numExecuted == 5);
+}
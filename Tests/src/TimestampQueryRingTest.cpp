@@ -0,0 +1,282 @@
+#include <Test.h>
+
+#include <NullDevice.h>
+#include <TimestampQueryRing.h>
+
+#include <string>
+#include <vector>
+
+namespace
+{
+    /**
+     * The GpuProfiler on the NullDevice. The scopes write their queries to a
+     * command list of the frame and the queries of the frame are resolved to a
+     * readback buffer when the frame ends (like GpuProfiler::EndFrame).
+     */
+    class NullGpuProfiler
+    {
+    public:
+        NullGpuProfiler(NullDevice& device, const TimestampQueryRing::Settings& settings)
+            : m_QueryRing(settings)
+        {
+            m_QueryHeap = device.CreateQueryHeap(m_QueryRing.GetNumQueries());
+            m_ReadbackBuffer = device.CreateCommittedResource(m_QueryRing.GetNumQueries() * sizeof(uint64_t));
+            m_CommandQueue = std::static_pointer_cast<NullDevice::CommandQueue>(device.CreateCommandQueue(NullDevice::CommandListType::Direct));
+            m_CommandList = std::static_pointer_cast<NullDevice::CommandList>(device.CreateCommandList(NullDevice::CommandListType::Direct));
+            m_TimestampFrequency = device.GetTimestampFrequency();
+        }
+
+        void BeginFrame()
+        {
+            m_QueryRing.Resolve(m_CommandQueue->GetFence()->GetCompletedValue(),
+                static_cast<const uint64_t*>(m_ReadbackBuffer->Map()), m_TimestampFrequency);
+            m_QueryRing.BeginFrame();
+            m_CommandList->Reset();
+        }
+
+        uint32_t BeginScope(const std::string& name)
+        {
+            uint32_t query = m_QueryRing.BeginScope(name);
+            if (query != TimestampQueryRing::InvalidQuery)
+            {
+                m_CommandList->EndQuery(*m_QueryHeap, query);
+            }
+            return query;
+        }
+
+        uint32_t EndScope()
+        {
+            uint32_t query = m_QueryRing.EndScope();
+            if (query != TimestampQueryRing::InvalidQuery)
+            {
+                m_CommandList->EndQuery(*m_QueryHeap, query);
+            }
+            return query;
+        }
+
+        // Returns the number of queries that were resolved.
+        uint32_t EndFrame()
+        {
+            uint32_t firstQuery;
+            uint32_t numQueries;
+            m_QueryRing.EndFrame(firstQuery, numQueries);
+
+            if (numQueries > 0)
+            {
+                m_CommandList->ResolveQueryData(*m_QueryHeap, firstQuery, numQueries, *m_ReadbackBuffer, firstQuery * sizeof(uint64_t));
+                m_QueryRing.Submit(m_CommandQueue->ExecuteCommandList(*m_CommandList));
+            }
+            return numQueries;
+        }
+
+        const TimestampQueryRing& GetQueryRing() const
+        {
+            return m_QueryRing;
+        }
+
+    private:
+        TimestampQueryRing m_QueryRing;
+        std::shared_ptr<NullDevice::QueryHeap> m_QueryHeap;
+        std::shared_ptr<NullDevice::Resource> m_ReadbackBuffer;
+        std::shared_ptr<NullDevice::CommandQueue> m_CommandQueue;
+        std::shared_ptr<NullDevice::CommandList> m_CommandList;
+        uint64_t m_TimestampFrequency;
+    };
+
+    TimestampQueryRing::Settings RingSettings(uint32_t numFrames, uint32_t maxScopesPerFrame)
+    {
+        TimestampQueryRing::Settings settings;
+        settings.NumFrames = numFrames;
+        settings.MaxScopesPerFrame = maxScopesPerFrame;
+        return settings;
+    }
+
+    // A device whose fence values never complete during the test.
+    NullDevice::Settings StalledGpu()
+    {
+        NullDevice::Settings settings;
+        settings.GpuLatency = 3600.0;
+        return settings;
+    }
+}
+
+TEST_CASE(ScopesAreResolvedOnTheNullDevice)
+{
+    NullDevice device;
+    NullGpuProfiler profiler(device, RingSettings(2, 8));
+
+    profiler.BeginFrame();
+    profiler.BeginScope("Frame");
+    profiler.BeginScope("Draw Cubes");
+    profiler.EndScope();
+    profiler.EndScope();
+    CHECK(profiler.EndFrame() == 4);
+
+    // The fence value of the frame completes immediately (no GPU latency).
+    profiler.BeginFrame();
+    profiler.EndFrame();
+
+    const TimestampQueryRing& queryRing = profiler.GetQueryRing();
+    const std::vector<TimestampQueryRing::ScopeTiming>& timings = queryRing.GetTimings();
+
+    CHECK(queryRing.GetNumResolvedFrames() == 1);
+    CHECK(queryRing.GetNumSkippedFrames() == 0);
+    CHECK(timings.size() == 2);
+    CHECK(timings[0].Name == "Frame");
+    CHECK(timings[0].Depth == 0);
+    CHECK(timings[1].Name == "Draw Cubes");
+    CHECK(timings[1].Depth == 1);
+    CHECK(timings[0].Time >= timings[1].Time);
+    CHECK(timings[1].Time >= 0.0);
+}
+
+TEST_CASE(FramesAreSkippedWhileTheGpuIsBehind)
+{
+    NullDevice device(StalledGpu());
+    NullGpuProfiler profiler(device, RingSettings(2, 8));
+
+    // The first two frames use both regions.
+    for (int i = 0; i < 2; ++i)
+    {
+        profiler.BeginFrame();
+        CHECK(profiler.BeginScope("Frame") != TimestampQueryRing::InvalidQuery);
+        CHECK(profiler.EndScope() != TimestampQueryRing::InvalidQuery);
+        CHECK(profiler.EndFrame() == 2);
+    }
+
+    // The next frames are not measured because the regions are still in flight.
+    for (int i = 0; i < 3; ++i)
+    {
+        profiler.BeginFrame();
+        CHECK(profiler.BeginScope("Frame") == TimestampQueryRing::InvalidQuery);
+        CHECK(profiler.BeginScope("Nested") == TimestampQueryRing::InvalidQuery);
+        CHECK(profiler.EndScope() == TimestampQueryRing::InvalidQuery);
+        CHECK(profiler.EndScope() == TimestampQueryRing::InvalidQuery);
+        CHECK(profiler.EndFrame() == 0);
+    }
+
+    const TimestampQueryRing& queryRing = profiler.GetQueryRing();
+    CHECK(queryRing.GetNumSkippedFrames() == 3);
+    CHECK(queryRing.GetNumResolvedFrames() == 0);
+    // The scopes of skipped frames are not dropped scopes.
+    CHECK(queryRing.GetNumDroppedScopes() == 0);
+    CHECK(queryRing.GetTimings().empty());
+}
+
+TEST_CASE(OverflowingScopesAreDropped)
+{
+    NullDevice device;
+    NullGpuProfiler profiler(device, RingSettings(2, 2));
+
+    profiler.BeginFrame();
+    uint32_t frameQuery = profiler.BeginScope("Frame");
+    uint32_t shadowsQuery = profiler.BeginScope("Shadows");
+    // The frame has no queries left for the third and fourth scope.
+    CHECK(profiler.BeginScope("Opaque") == TimestampQueryRing::InvalidQuery);
+    CHECK(profiler.EndScope() == TimestampQueryRing::InvalidQuery);
+    CHECK(profiler.EndScope() == shadowsQuery + 1);
+    CHECK(profiler.BeginScope("Transparent") == TimestampQueryRing::InvalidQuery);
+    CHECK(profiler.EndScope() == TimestampQueryRing::InvalidQuery);
+    CHECK(profiler.EndScope() == frameQuery + 1);
+    CHECK(profiler.EndFrame() == 4);
+
+    CHECK(frameQuery == 0);
+    CHECK(shadowsQuery == 2);
+
+    profiler.BeginFrame();
+    profiler.EndFrame();
+
+    const TimestampQueryRing& queryRing = profiler.GetQueryRing();
+    CHECK(queryRing.GetNumDroppedScopes() == 2);
+    CHECK(queryRing.GetNumResolvedFrames() == 1);
+
+    // Only the measured scopes are read.
+    const std::vector<TimestampQueryRing::ScopeTiming>& timings = queryRing.GetTimings();
+    CHECK(timings.size() == 2);
+    CHECK(timings[0].Name == "Frame");
+    CHECK(timings[1].Name == "Shadows");
+    CHECK(timings[1].Depth == 1);
+}
+
+TEST_CASE(EachFrameUsesItsOwnRegion)
+{
+    const uint32_t maxScopesPerFrame = 4;
+
+    NullDevice device(StalledGpu());
+    NullGpuProfiler profiler(device, RingSettings(3, maxScopesPerFrame));
+    CHECK(profiler.GetQueryRing().GetNumQueries() == 3 * maxScopesPerFrame * 2);
+
+    bool correct = true;
+    for (uint32_t i = 0; i < 3; ++i)
+    {
+        profiler.BeginFrame();
+        correct = correct && profiler.BeginScope("Frame") == i * maxScopesPerFrame * 2;
+        profiler.EndScope();
+        profiler.EndFrame();
+    }
+    CHECK(correct);
+}
+
+TEST_CASE(FramesWithoutScopesKeepTheirRegion)
+{
+    NullDevice device(StalledGpu());
+    NullGpuProfiler profiler(device, RingSettings(2, 8));
+
+    // Frames without scopes are not submitted, so they don't use a region.
+    for (int i = 0; i < 5; ++i)
+    {
+        profiler.BeginFrame();
+        CHECK(profiler.EndFrame() == 0);
+    }
+
+    profiler.BeginFrame();
+    CHECK(profiler.BeginScope("Frame") == 0);
+    profiler.EndScope();
+    profiler.EndFrame();
+
+    CHECK(profiler.GetQueryRing().GetNumSkippedFrames() == 0);
+}
+
+TEST_CASE(TimingsAreReadFromTheReadbackBuffer)
+{
+    TimestampQueryRing queryRing(RingSettings(2, 4));
+    std::vector<uint64_t> timestamps(queryRing.GetNumQueries(), 0);
+    const uint64_t frequency = 1000;
+
+    queryRing.BeginFrame();
+    uint32_t frameQuery = queryRing.BeginScope("Frame");
+    uint32_t clearQuery = queryRing.BeginScope("Clear");
+    timestamps[clearQuery] = 120;
+    timestamps[queryRing.EndScope()] = 150;
+    uint32_t postQuery = queryRing.BeginScope("Post");
+    // The end timestamp is earlier than the start timestamp (for example, after a GPU clock change).
+    timestamps[postQuery] = 300;
+    timestamps[queryRing.EndScope()] = 250;
+    timestamps[frameQuery] = 100;
+    timestamps[queryRing.EndScope()] = 400;
+
+    uint32_t firstQuery;
+    uint32_t numQueries;
+    queryRing.EndFrame(firstQuery, numQueries);
+    CHECK(firstQuery == 0);
+    CHECK(numQueries == 6);
+    queryRing.Submit(5);
+
+    // The fence value of the frame has not completed.
+    queryRing.Resolve(4, timestamps.data(), frequency);
+    CHECK(queryRing.GetNumResolvedFrames() == 0);
+    CHECK(queryRing.GetTimings().empty());
+
+    queryRing.Resolve(5, timestamps.data(), frequency);
+    const std::vector<TimestampQueryRing::ScopeTiming>& timings = queryRing.GetTimings();
+    CHECK(queryRing.GetNumResolvedFrames() == 1);
+    CHECK(timings.size() == 3);
+    CHECK_NEAR(timings[0].Time, 0.3, 1e-9);
+    CHECK_NEAR(timings[1].Time, 0.03, 1e-9);
+    CHECK(timings[2].Time == 0.0);
+
+    // Nested scopes are indented in the table.
+    std::string table = queryRing.GetTimingsTable();
+    CHECK(table.find("\n  Clear") != std::string::npos);
+    CHECK(table.find("\nFrame") != std::string::npos);
+}
@@ -0,0 +1,146 @@
+#include <Test.h>
+
+#include <TripleBuffer.h>
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+
+namespace
+{
+    // A value that is larger than an atomic store, so a torn read would
+    // show different values in the fields.
+    struct Snapshot
+    {
+        uint64_t Values[8];
+    };
+
+    void Fill(Snapshot& snapshot, uint64_t value)
+    {
+        for (uint64_t& v : snapshot.Values)
+        {
+            v = value;
+        }
+    }
+
+    bool IsConsistent(const Snapshot& snapshot)
+    {
+        for (uint64_t v : snapshot.Values)
+        {
+            if (v != snapshot.Values[0])
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+}
+
+TEST_CASE(NothingIsReadBeforePublish)
+{
+    TripleBuffer<int> buffer(7);
+
+    CHECK(!buffer.Update());
+    CHECK(buffer.GetFront() == 7);
+
+    // Filling the back buffer doesn't change the front buffer.
+    buffer.GetBack() = 1;
+    CHECK(!buffer.Update());
+    CHECK(buffer.GetFront() == 7);
+}
+
+TEST_CASE(UpdateReadsThePublishedValue)
+{
+    TripleBuffer<int> buffer(0);
+
+    buffer.GetBack() = 1;
+    buffer.Publish();
+
+    CHECK(buffer.Update());
+    CHECK(buffer.GetFront() == 1);
+
+    // Nothing new was published.
+    CHECK(!buffer.Update());
+    CHECK(buffer.GetFront() == 1);
+}
+
+TEST_CASE(UpdateSkipsOlderValues)
+{
+    TripleBuffer<int> buffer(0);
+
+    for (int i = 1; i <= 5; ++i)
+    {
+        buffer.GetBack() = i;
+        buffer.Publish();
+    }
+
+    CHECK(buffer.Update());
+    CHECK(buffer.GetFront() == 5);
+    CHECK(!buffer.Update());
+}
+
+TEST_CASE(WriterNeverWritesTheFrontBuffer)
+{
+    TripleBuffer<int> buffer(0);
+
+    buffer.GetBack() = 1;
+    buffer.Publish();
+    CHECK(buffer.Update());
+
+    // The writer keeps publishing while the reader holds the front buffer.
+    for (int i = 2; i <= 10; ++i)
+    {
+        CHECK(&buffer.GetBack() != &buffer.GetFront());
+        buffer.GetBack() = i;
+        buffer.Publish();
+        CHECK(buffer.GetFront() == 1);
+    }
+
+    CHECK(buffer.Update());
+    CHECK(buffer.GetFront() == 10);
+}
+
+TEST_CASE(ReaderSeesConsistentIncreasingValues)
+{
+    const uint64_t numValues = 200000;
+
+    Snapshot initialValue;
+    Fill(initialValue, 0);
+    TripleBuffer<Snapshot> buffer(initialValue);
+
+    std::thread writer([&buffer, numValues]()
+    {
+        for (uint64_t i = 1; i <= numValues; ++i)
+        {
+            Fill(buffer.GetBack(), i);
+            buffer.Publish();
+        }
+    });
+
+    uint64_t lastValue = 0;
+    uint64_t numUpdates = 0;
+    bool consistent = true;
+    bool increasing = true;
+    while (lastValue < numValues)
+    {
+        if (!buffer.Update())
+        {
+            std::this_thread::yield();
+            continue;
+        }
+
+        const Snapshot& front = buffer.GetFront();
+        consistent = consistent && IsConsistent(front);
+        increasing = increasing && front.Values[0] > lastValue;
+        lastValue = front.Values[0];
+        numUpdates++;
+    }
+
+    writer.join();
+
+    CHECK(consistent);
+    CHECK(increasing);
+    CHECK(lastValue == numValues);
+    CHECK(numUpdates > 0);
+    CHECK(!buffer.Update());
+}
@@ -0,0 +1,155 @@
+/**
+ * FrameReplay replays a frame capture (see FrameCapture) on the null device
+ * and reports the CPU time of each call, so the CPU cost of a frame can be
+ * measured (and compared between builds) without a GPU.
+ *
+ * Usage:
+ *   FrameReplay [--iterations <count>] [--gpu-latency <seconds>] <file.capture>
+ */
+#include <FrameCapture.h>
+#include <FrameReplayer.h>
+#include <NullDevice.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace
+{
+    struct Options
+    {
+        std::string CaptureFile;
+        uint32_t NumIterations = 1;
+        double GpuLatency = 0.0;
+    };
+
+    void PrintUsage()
+    {
+        fprintf(stderr,
+            "Usage:\n"
+            "  FrameReplay [--iterations <count>] [--gpu-latency <seconds>] <file.capture>\n");
+    }
+
+    bool ParseArguments(int argc, char* argv[], Options& options)
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            const char* argument = argv[i];
+            bool hasValue = i + 1 < argc;
+
+            if (strncmp(argument, "--", 2) == 0 && !hasValue)
+            {
+                fprintf(stderr, "Missing value for %s\n", argument);
+                return false;
+            }
+            else if (strcmp(argument, "--iterations") == 0)
+            {
+                options.NumIterations = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 10));
+            }
+            else if (strcmp(argument, "--gpu-latency") == 0)
+            {
+                options.GpuLatency = strtod(argv[++i], nullptr);
+            }
+            else if (strncmp(argument, "--", 2) == 0)
+            {
+                fprintf(stderr, "Unknown option %s\n", argument);
+                return false;
+            }
+            else
+            {
+                options.CaptureFile = argument;
+            }
+        }
+
+        if (options.CaptureFile.empty() || options.NumIterations == 0)
+        {
+            fprintf(stderr, "Missing required arguments.\n");
+            return false;
+        }
+
+        return true;
+    }
+
+    void PrintStatistics(const FrameReplayer::Statistics& statistics)
+    {
+        printf("%-28s %10s %12s %10s %10s %10s\n", "Call", "Count", "Total (ms)", "Mean (us)", "Min (us)", "Max (us)");
+
+        for (size_t i = 0; i < static_cast<size_t>(FrameCapture::Call::NumCalls); ++i)
+        {
+            const FrameReplayer::CallStatistics& call = statistics.Calls[i];
+            if (call.Count == 0)
+            {
+                continue;
+            }
+
+            printf("%-28s %10llu %12.3f %10.3f %10.3f %10.3f\n",
+                FrameCapture::GetCallName(static_cast<FrameCapture::Call>(i)),
+                static_cast<unsigned long long>(call.Count),
+                call.TotalTime * 1e3,
+                call.TotalTime / call.Count * 1e6,
+                call.MinTime * 1e6,
+                call.MaxTime * 1e6);
+        }
+
+        const std::vector<double>& frameTimes = statistics.FrameTimes;
+        if (!frameTimes.empty())
+        {
+            std::vector<double> sortedFrameTimes = frameTimes;
+            std::sort(sortedFrameTimes.begin(), sortedFrameTimes.end());
+
+            double totalTime = 0.0;
+            for (double frameTime : frameTimes)
+            {
+                totalTime += frameTime;
+            }
+
+            printf("\nFrames: %zu, mean %.3f ms, median %.3f ms, min %.3f ms, max %.3f ms\n",
+                frameTimes.size(),
+                totalTime / frameTimes.size() * 1e3,
+                sortedFrameTimes[sortedFrameTimes.size() / 2] * 1e3,
+                sortedFrameTimes.front() * 1e3,
+                sortedFrameTimes.back() * 1e3);
+        }
+
+        if (statistics.NumSkippedCalls > 0)
+        {
+            printf("Skipped calls: %llu\n", static_cast<unsigned long long>(statistics.NumSkippedCalls));
+        }
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    Options options;
+    if (!ParseArguments(argc, argv, options))
+    {
+        PrintUsage();
+        return 1;
+    }
+
+    FrameCapture::Stream stream;
+    if (!FrameCapture::Load(options.CaptureFile, stream))
+    {
+        fprintf(stderr, "FrameReplay: failed to load %s\n", options.CaptureFile.c_str());
+        return 1;
+    }
+
+    printf("FrameReplay: %s (%zu calls, %u frames)\n\n", options.CaptureFile.c_str(), stream.Records.size(), stream.NumFrames);
+
+    NullDevice::Settings deviceSettings;
+    deviceSettings.GpuLatency = options.GpuLatency;
+    NullDevice device(deviceSettings);
+
+    FrameReplayer replayer(device);
+    for (uint32_t i = 0; i < options.NumIterations; ++i)
+    {
+        replayer.Replay(stream);
+    }
+
+    PrintStatistics(replayer.GetStatistics());
+
+    return 0;
+}
@@ -0,0 +1,398 @@
+/**
+ * HeadlessSoak runs the frame loop of the engine on the headless platform for
+ * a large number of frames with pseudo-random input, without a GPU or a window
+ * system. Each frame goes through the same steps as Window::Frame: the queued
+ * input events are published on the event bus, the fixed-step scheduler runs
+ * the simulation steps and the frame pacer limits the frames in flight on a
+ * simulated GPU.
+ *
+ * The consistency of the input, step and pacing counters is checked at the end
+ * of the run (the exit code is 1 if a check failed) and the CPU time of the
+ * frames is reported, so the driver can be used as a soak test and as a
+ * benchmark of the frame loop.
+ *
+ * Usage:
+ *   HeadlessSoak [--frames <count>] [--seed <seed>] [--frame-time <seconds>]
+ *                [--steps-per-second <steps>] [--frames-in-flight <count>]
+ *                [--gpu-latency <frames>]
+ */
+#include <EventBus.h>
+#include <Events.h>
+#include <FixedStepScheduler.h>
+#include <FramePacer.h>
+#include <FrameStats.h>
+#include <HeadlessPlatform.h>
+#include <HighResolutionClock.h>
+#include <InputQueue.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <type_traits>
+#include <variant>
+#include <vector>
+
+namespace
+{
+    const int ClientWidth = 1280;
+    const int ClientHeight = 720;
+
+    struct Options
+    {
+        uint64_t NumFrames = 100000;
+        uint32_t Seed = 1;
+        double FrameTime = 1.0 / 60.0;
+        // 0 to update once per frame with the variable frame time.
+        double StepsPerSecond = 50.0;
+        uint32_t MaxFramesInFlight = 2;
+        // The number of frames the simulated GPU lags behind the CPU.
+        uint32_t GpuLatency = 3;
+    };
+
+    void PrintUsage()
+    {
+        fprintf(stderr,
+            "Usage:\n"
+            "  HeadlessSoak [--frames <count>] [--seed <seed>] [--frame-time <seconds>]\n"
+            "               [--steps-per-second <steps>] [--frames-in-flight <count>]\n"
+            "               [--gpu-latency <frames>]\n");
+    }
+
+    bool ParseArguments(int argc, char* argv[], Options& options)
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            const char* argument = argv[i];
+            bool hasValue = i + 1 < argc;
+
+            if (strncmp(argument, "--", 2) == 0 && !hasValue)
+            {
+                fprintf(stderr, "Missing value for %s\n", argument);
+                return false;
+            }
+            else if (strcmp(argument, "--frames") == 0)
+            {
+                options.NumFrames = strtoull(argv[++i], nullptr, 10);
+            }
+            else if (strcmp(argument, "--seed") == 0)
+            {
+                options.Seed = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 10));
+            }
+            else if (strcmp(argument, "--frame-time") == 0)
+            {
+                options.FrameTime = strtod(argv[++i], nullptr);
+            }
+            else if (strcmp(argument, "--steps-per-second") == 0)
+            {
+                options.StepsPerSecond = strtod(argv[++i], nullptr);
+            }
+            else if (strcmp(argument, "--frames-in-flight") == 0)
+            {
+                options.MaxFramesInFlight = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 10));
+            }
+            else if (strcmp(argument, "--gpu-latency") == 0)
+            {
+                options.GpuLatency = static_cast<uint32_t>(strtoul(argv[++i], nullptr, 10));
+            }
+            else
+            {
+                fprintf(stderr, "Unknown option %s\n", argument);
+                return false;
+            }
+        }
+
+        if (options.NumFrames == 0 || options.FrameTime <= 0.0 || options.StepsPerSecond < 0.0)
+        {
+            fprintf(stderr, "Invalid arguments.\n");
+            return false;
+        }
+
+        return true;
+    }
+
+    /**
+     * A window that runs the frame loop of Window::Frame on the portable
+     * classes only. The GPU is simulated: a frame is retired GpuLatency frames
+     * after it was submitted, or earlier if the frame pacer waits for it.
+     */
+    class SoakWindow : public PlatformWindow
+    {
+    public:
+        struct Statistics
+        {
+            uint64_t NumQueuedEvents[std::variant_size_v<InputQueue::Event>] = {};
+            uint64_t NumKeyEvents = 0;
+            uint64_t NumMouseMotionEvents = 0;
+            uint64_t NumMouseButtonEvents = 0;
+            uint64_t NumMouseWheelEvents = 0;
+            uint64_t NumUpdates = 0;
+            uint64_t NumGpuWaits = 0;
+            uint32_t MaxFramesInFlight = 0;
+            double FirstFrameTime = 0.0;
+            double LastFrameTime = 0.0;
+        };
+
+        SoakWindow(const Platform& platform, const Options& options)
+            : m_Platform(platform)
+            , m_Options(options)
+            , m_SignaledFenceValue(0)
+            , m_CompletedFenceValue(0)
+        {
+            FramePacer::Settings pacerSettings;
+            pacerSettings.MaxFramesInFlight = options.MaxFramesInFlight;
+            m_FramePacer.SetSettings(pacerSettings);
+
+            if (options.StepsPerSecond > 0.0)
+            {
+                FixedStepScheduler::Settings schedulerSettings;
+                schedulerSettings.StepsPerSecond = options.StepsPerSecond;
+                m_FixedStepScheduler.SetSettings(schedulerSettings);
+            }
+
+            m_EventBus.Subscribe<&SoakWindow::OnKey>(this);
+            m_EventBus.Subscribe<&SoakWindow::OnMouseMotion>(this);
+            m_EventBus.Subscribe<&SoakWindow::OnMouseButton>(this);
+            m_EventBus.Subscribe<&SoakWindow::OnMouseWheel>(this);
+        }
+
+        void QueueInputEvent(const InputQueue::Event& e) override
+        {
+            ++m_Statistics.NumQueuedEvents[e.index()];
+            m_InputQueue.Push(e);
+        }
+
+        void Resize(int, int) override
+        {}
+
+        void Frame() override
+        {
+            m_CpuClock.Reset();
+
+            // Update.
+            m_InputEvents.clear();
+            m_InputQueue.PopAll(m_InputEvents);
+            for (InputQueue::Event& event : m_InputEvents)
+            {
+                std::visit([this](auto& e) { Publish(e); }, event);
+            }
+
+            double now = m_Platform.GetTime();
+            if (m_FramePacer.GetFrameCount() == 0)
+            {
+                m_Statistics.FirstFrameTime = now;
+            }
+            m_Statistics.LastFrameTime = now;
+
+            uint32_t numUpdates = m_Options.StepsPerSecond > 0.0 ? m_FixedStepScheduler.BeginFrame(now) : 1;
+            m_Statistics.NumUpdates += numUpdates;
+
+            // Render.
+            uint64_t fenceValue = m_FramePacer.GetFenceValueToWait();
+            if (fenceValue > m_CompletedFenceValue)
+            {
+                // Block until the GPU retired the frame.
+                m_CompletedFenceValue = fenceValue;
+                ++m_Statistics.NumGpuWaits;
+            }
+
+            m_FramePacer.BeginFrame(now, 0.0, 0.0, m_CompletedFenceValue);
+            m_Statistics.MaxFramesInFlight = std::max(m_Statistics.MaxFramesInFlight, m_FramePacer.GetFramesInFlight(m_CompletedFenceValue));
+            m_FramePacer.EndFrame(now, ++m_SignaledFenceValue);
+
+            // The GPU retires the frames that were submitted GpuLatency frames ago.
+            if (m_SignaledFenceValue > m_Options.GpuLatency)
+            {
+                m_CompletedFenceValue = std::max(m_CompletedFenceValue, m_SignaledFenceValue - m_Options.GpuLatency);
+            }
+
+            m_CpuClock.Tick();
+            m_CpuFrameStats.AddSample(m_CpuClock.GetDeltaSeconds());
+        }
+
+        const Statistics& GetStatistics() const
+        {
+            return m_Statistics;
+        }
+
+        const InputQueue& GetInputQueue() const
+        {
+            return m_InputQueue;
+        }
+
+        const FixedStepScheduler& GetFixedStepScheduler() const
+        {
+            return m_FixedStepScheduler;
+        }
+
+        const FrameStats& GetCpuFrameStats() const
+        {
+            return m_CpuFrameStats;
+        }
+
+    private:
+        void Publish(std::monostate&)
+        {}
+
+        template<typename Event>
+        void Publish(Event& e)
+        {
+            m_EventBus.Publish(e);
+        }
+
+        void OnKey(KeyEventArgs&)
+        {
+            ++m_Statistics.NumKeyEvents;
+        }
+
+        void OnMouseMotion(MouseMotionEventArgs&)
+        {
+            ++m_Statistics.NumMouseMotionEvents;
+        }
+
+        void OnMouseButton(MouseButtonEventArgs&)
+        {
+            ++m_Statistics.NumMouseButtonEvents;
+        }
+
+        void OnMouseWheel(MouseWheelEventArgs&)
+        {
+            ++m_Statistics.NumMouseWheelEvents;
+        }
+
+        const Platform& m_Platform;
+        Options m_Options;
+
+        InputQueue m_InputQueue;
+        std::vector<InputQueue::Event> m_InputEvents;
+        EventBus m_EventBus;
+        FixedStepScheduler m_FixedStepScheduler;
+        FramePacer m_FramePacer;
+
+        uint64_t m_SignaledFenceValue;
+        uint64_t m_CompletedFenceValue;
+
+        HighResolutionClock m_CpuClock;
+        FrameStats m_CpuFrameStats;
+
+        Statistics m_Statistics;
+    };
+
+    // The index of an event type in InputQueue::Event.
+    template<typename Event, size_t Index = 0>
+    constexpr size_t GetEventIndex()
+    {
+        if constexpr (std::is_same_v<std::variant_alternative_t<Index, InputQueue::Event>, Event>)
+        {
+            return Index;
+        }
+        else
+        {
+            return GetEventIndex<Event, Index + 1>();
+        }
+    }
+
+    template<typename Event>
+    uint64_t GetNumQueuedEvents(const SoakWindow::Statistics& statistics)
+    {
+        return statistics.NumQueuedEvents[GetEventIndex<Event>()];
+    }
+
+    bool Check(bool condition, const char* message)
+    {
+        if (!condition)
+        {
+            fprintf(stderr, "HeadlessSoak: check failed: %s\n", message);
+        }
+        return condition;
+    }
+
+    bool CheckStatistics(const SoakWindow& window, const Options& options)
+    {
+        const SoakWindow::Statistics& statistics = window.GetStatistics();
+        bool passed = true;
+
+        // Only the mouse motion events are combined by the input queue.
+        if (window.GetInputQueue().GetNumDroppedEvents() == 0)
+        {
+            passed &= Check(statistics.NumKeyEvents == GetNumQueuedEvents<KeyEventArgs>(statistics),
+                "all key events are published");
+            passed &= Check(statistics.NumMouseButtonEvents == GetNumQueuedEvents<MouseButtonEventArgs>(statistics),
+                "all mouse button events are published");
+            passed &= Check(statistics.NumMouseWheelEvents == GetNumQueuedEvents<MouseWheelEventArgs>(statistics),
+                "all mouse wheel events are published");
+        }
+        passed &= Check(statistics.NumMouseMotionEvents <= GetNumQueuedEvents<MouseMotionEventArgs>(statistics),
+            "mouse motion events are not duplicated");
+
+        passed &= Check(statistics.MaxFramesInFlight < std::max(options.MaxFramesInFlight, 1u),
+            "the frames in flight are limited by the frame pacer");
+
+        if (options.StepsPerSecond > 0.0)
+        {
+            // The elapsed time is either simulated, dropped or left in the accumulator.
+            const FixedStepScheduler& scheduler = window.GetFixedStepScheduler();
+            double elapsedTime = statistics.LastFrameTime - statistics.FirstFrameTime;
+            double scheduledTime = scheduler.GetTime() + scheduler.GetDroppedTime() + scheduler.GetAlpha() * scheduler.GetStepDuration();
+            passed &= Check(std::abs(elapsedTime - scheduledTime) < 1e-6 * std::max(1.0, elapsedTime),
+                "the fixed steps account for the elapsed time");
+            passed &= Check(statistics.NumUpdates == scheduler.GetStepCount(),
+                "a step is run for each scheduled step");
+        }
+
+        return passed;
+    }
+
+    void PrintStatistics(const SoakWindow& window, uint64_t numFrames, double totalTime)
+    {
+        const SoakWindow::Statistics& statistics = window.GetStatistics();
+
+        printf("Frames: %llu in %.3f s (%.1f frames/s)\n",
+            static_cast<unsigned long long>(numFrames), totalTime, numFrames / totalTime);
+        printf("Events: %llu key, %llu mouse motion, %llu mouse button, %llu mouse wheel (%llu dropped)\n",
+            static_cast<unsigned long long>(statistics.NumKeyEvents),
+            static_cast<unsigned long long>(statistics.NumMouseMotionEvents),
+            static_cast<unsigned long long>(statistics.NumMouseButtonEvents),
+            static_cast<unsigned long long>(statistics.NumMouseWheelEvents),
+            static_cast<unsigned long long>(window.GetInputQueue().GetNumDroppedEvents()));
+        printf("Updates: %llu, GPU waits: %llu, max frames in flight: %u\n",
+            static_cast<unsigned long long>(statistics.NumUpdates),
+            static_cast<unsigned long long>(statistics.NumGpuWaits),
+            statistics.MaxFramesInFlight);
+
+        FrameStats::Summary summary = window.GetCpuFrameStats().GetSummary();
+        printf("CPU frame time: mean %.3f us, p50 %.3f us, p95 %.3f us, p99 %.3f us, max %.3f us, hitches %llu\n",
+            summary.AverageTime * 1e6, summary.P50 * 1e6, summary.P95 * 1e6, summary.P99 * 1e6, summary.MaxTime * 1e6,
+            static_cast<unsigned long long>(window.GetCpuFrameStats().GetNumHitches()));
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    Options options;
+    if (!ParseArguments(argc, argv, options))
+    {
+        PrintUsage();
+        return 1;
+    }
+
+    HeadlessPlatform::Settings platformSettings;
+    platformSettings.FrameTime = options.FrameTime;
+    platformSettings.MaxFrames = options.NumFrames;
+    HeadlessPlatform platform(platformSettings);
+    platform.SetInputGenerator(HeadlessPlatform::CreateRandomInput(options.Seed, ClientWidth, ClientHeight));
+
+    SoakWindow window(platform, options);
+    platform.AddWindow(&window);
+
+    HighResolutionClock clock;
+    platform.Run();
+    clock.Tick();
+
+    platform.RemoveWindow(&window);
+
+    PrintStatistics(window, platform.GetFrameCount(), clock.GetTotalSeconds());
+
+    return CheckStatistics(window, options) ? 0 : 1;
+}
@@ -0,0 +1,263 @@
+# Shader build rules that compile HLSL shaders with the ShaderBuild tool
+# and generate reflection headers with the ShaderReflect tool.
+#
+# Bytecode is stored in a content-addressed cache (SHADER_CACHE_DIR), so
+# shaders are only recompiled when the preprocessed source, the compile
+# options or the compiler change. Build statistics are written to
+# ${CMAKE_BINARY_DIR}/ShaderBuildStats.csv and can be summarized with the
+# ShaderBuildReport target.
+
+if( WIN32 )
+    set( SHADER_BUILD_DEFAULT_BACKEND fxc )
+else()
+    set( SHADER_BUILD_DEFAULT_BACKEND dxc )
+endif()
+
+set( SHADER_BUILD_BACKEND ${SHADER_BUILD_DEFAULT_BACKEND} CACHE STRING "The shader compiler backend (fxc or dxc).")
+set_property( CACHE SHADER_BUILD_BACKEND PROPERTY STRINGS fxc dxc )
+
+if( SHADER_BUILD_BACKEND STREQUAL "fxc" )
+    find_program( SHADER_COMPILER fxc
+        PATHS "C:/Program Files (x86)/Windows Kits/10/bin/10.0.18362.0/x64"
+        DOC "The path to the shader compiler.")
+else()
+    find_program( SHADER_COMPILER dxc
+        DOC "The path to the shader compiler.")
+endif()
+
+set( SHADER_CACHE_DIR "${CMAKE_BINARY_DIR}/ShaderCache" CACHE PATH "The directory of the shader bytecode cache.")
+set( SHADER_BUILD_STATS "${CMAKE_BINARY_DIR}/ShaderBuildStats.csv" )
+
+if( NOT SHADER_COMPILER )
+    message( WARNING "Shader compiler (${SHADER_BUILD_BACKEND}) not found. Shaders will not be built.")
+endif()
+
+if( NOT TARGET ShaderBuildReport )
+    add_custom_target( ShaderBuildReport
+        COMMAND ShaderBuild --report "${SHADER_BUILD_STATS}"
+        COMMENT "Shader build statistics")
+endif()
+
+# _shader_build_includes( <source> <output variable> )
+#
+# Scans a shader for the files it includes with #include "<file>" (recursively,
+# relative to the including file). Used when the generator doesn't support
+# depfiles. The build system is regenerated when the shader or one of the
+# included files changes, so new includes are picked up.
+function( _shader_build_includes source_path var_includes )
+    set( includes )
+    set( pending "${source_path}" )
+    while( pending )
+        list( GET pending 0 file )
+        list( REMOVE_AT pending 0 )
+
+        file( STRINGS "${file}" include_lines REGEX "^[ \t]*#[ \t]*include[ \t]*\"[^\"]+\"" )
+        get_filename_component( file_dir "${file}" DIRECTORY )
+        foreach( include_line ${include_lines} )
+            string( REGEX REPLACE "^[ \t]*#[ \t]*include[ \t]*\"([^\"]+)\".*" "\\1" include_name "${include_line}" )
+            get_filename_component( include_path "${include_name}" ABSOLUTE BASE_DIR "${file_dir}" )
+            if( EXISTS "${include_path}" AND NOT include_path IN_LIST includes )
+                list( APPEND includes "${include_path}" )
+                list( APPEND pending "${include_path}" )
+            endif()
+        endforeach()
+    endwhile()
+
+    set_property( DIRECTORY APPEND PROPERTY CMAKE_CONFIGURE_DEPENDS "${source_path}" ${includes} )
+    set( ${var_includes} ${includes} PARENT_SCOPE )
+endfunction()
+
+# shader_build( <output variable>
+#     SOURCE <file.hlsl>
+#     PROFILE <profile>
+#     [ENTRY <entry point>]
+#     [NAME <output name>]
+#     [DEFINES <NAME[=VALUE]>...]
+# )
+#
+# Compiles a shader to ${CMAKE_RUNTIME_OUTPUT_DIRECTORY}/shaders/<name>.cso.
+# The name defaults to the name of the source file. Shaders are compiled with
+# debug information and without optimizations in the Debug configuration.
+#
+# The shader is rebuilt when the source or one of the files it includes
+# changes. ShaderBuild writes the included files to a depfile if the
+# generator supports depfiles (Ninja, Makefiles with CMake 3.20 and Visual
+# Studio with CMake 3.21). Otherwise the includes are scanned when the
+# build system is generated (see _shader_build_includes).
+#
+# The assembly listing of the shader is written to
+# ${CMAKE_CURRENT_BINARY_DIR}/shaders/<name>.lst and its path is returned in
+# <output variable>_LISTING. The shader stage (the first two characters of the
+# profile) is returned in <output variable>_STAGE. See shader_reflect.
+function( shader_build var_binary_path )
+    cmake_parse_arguments( SHADER "" "SOURCE;PROFILE;ENTRY;NAME" "DEFINES" ${ARGN} )
+
+    if( NOT SHADER_COMPILER )
+        set( ${var_binary_path} "" PARENT_SCOPE )
+        return()
+    endif()
+
+    if( NOT SHADER_ENTRY )
+        set( SHADER_ENTRY main )
+    endif()
+    if( NOT SHADER_NAME )
+        get_filename_component( SHADER_NAME ${SHADER_SOURCE} NAME_WE )
+    endif()
+
+    get_filename_component( source_path "${SHADER_SOURCE}" ABSOLUTE )
+    set( binary_path "${CMAKE_RUNTIME_OUTPUT_DIRECTORY}/shaders/${SHADER_NAME}.cso" )
+    set( listing_path "${CMAKE_CURRENT_BINARY_DIR}/shaders/${SHADER_NAME}.lst" )
+    string( SUBSTRING ${SHADER_PROFILE} 0 2 stage )
+
+    set( define_args )
+    foreach( define ${SHADER_DEFINES} )
+        list( APPEND define_args --define ${define} )
+    endforeach()
+
+    set( depfile_args )
+    set( depends "${source_path}" )
+    if( CMAKE_GENERATOR MATCHES "Ninja" OR
+        ( CMAKE_GENERATOR MATCHES "Makefiles" AND NOT CMAKE_VERSION VERSION_LESS 3.20 ) OR
+        ( CMAKE_GENERATOR MATCHES "Visual Studio" AND NOT CMAKE_VERSION VERSION_LESS 3.21 ) )
+        set( depfile_path "${CMAKE_CURRENT_BINARY_DIR}/shaders/${SHADER_NAME}.d" )
+        set( depfile_option --depfile "${depfile_path}" )
+        set( depfile_args DEPFILE "${depfile_path}" )
+    else()
+        set( depfile_option )
+        _shader_build_includes( "${source_path}" includes )
+        list( APPEND depends ${includes} )
+    endif()
+
+    add_custom_command( OUTPUT ${binary_path} ${listing_path}
+        COMMENT "Building shader ${SHADER_NAME}..."
+        COMMAND ShaderBuild
+            --backend ${SHADER_BUILD_BACKEND}
+            --compiler "${SHADER_COMPILER}"
+            --cache "${SHADER_CACHE_DIR}"
+            --stats "${SHADER_BUILD_STATS}"
+            --profile ${SHADER_PROFILE}
+            --entry ${SHADER_ENTRY}
+            ${define_args}
+            $<$<CONFIG:Debug>:--debug>
+            --listing "${listing_path}"
+            ${depfile_option}
+            --output "${binary_path}"
+            "${source_path}"
+        WORKING_DIRECTORY ${CMAKE_CURRENT_BINARY_DIR}
+        DEPENDS ${depends} ShaderBuild
+        ${depfile_args}
+        COMMAND_EXPAND_LISTS
+    )
+
+    set( ${var_binary_path} "${binary_path}" PARENT_SCOPE )
+    set( ${var_binary_path}_LISTING "${listing_path}" PARENT_SCOPE )
+    set( ${var_binary_path}_STAGE ${stage} PARENT_SCOPE )
+endfunction()
+
+# shader_build_definitions( <target> )
+#
+# Adds the compiler settings of the shader build to the compile definitions of
+# a target, so the ShaderReloader recompiles shaders with the same compiler and
+# options (see ShaderReloader::ShaderDesc):
+#   SHADER_BUILD_BACKEND  The compiler backend ("fxc" or "dxc").
+#   SHADER_COMPILER       The path to the compiler ("" if it was not found).
+#   SHADER_BUILD_DEBUG    1 in the Debug configuration, 0 otherwise.
+function( shader_build_definitions target )
+    set( compiler_path "" )
+    if( SHADER_COMPILER )
+        set( compiler_path "${SHADER_COMPILER}" )
+    endif()
+
+    target_compile_definitions( ${target}
+        PRIVATE SHADER_BUILD_BACKEND="${SHADER_BUILD_BACKEND}"
+        PRIVATE SHADER_COMPILER="${compiler_path}"
+        PRIVATE SHADER_BUILD_DEBUG=$<CONFIG:Debug>
+    )
+endfunction()
+
+# shader_build_permutations( <output list variable>
+#     SOURCE <file.hlsl>
+#     PROFILE <profile>
+#     [ENTRY <entry point>]
+#     PERMUTATIONS <define set>...
+# )
+#
+# Builds a shader once for each define set. A define set is a comma-separated
+# list of definitions (for example "USE_FOG=1,USE_SHADOWS=0"). The output name
+# of each permutation is the name of the source file followed by the definitions
+# (for example PixelShader_USE_FOG1_USE_SHADOWS0.cso).
+function( shader_build_permutations var_binary_paths )
+    cmake_parse_arguments( SHADER "" "SOURCE;PROFILE;ENTRY" "PERMUTATIONS" ${ARGN} )
+
+    get_filename_component( source_name ${SHADER_SOURCE} NAME_WE )
+
+    set( binary_paths )
+    foreach( permutation ${SHADER_PERMUTATIONS} )
+        string( REPLACE "," ";" defines "${permutation}" )
+        string( REPLACE "=" "" suffix "${permutation}" )
+        string( REPLACE "," "_" suffix "${suffix}" )
+
+        set( entry_args )
+        if( SHADER_ENTRY )
+            set( entry_args ENTRY ${SHADER_ENTRY} )
+        endif()
+
+        shader_build( binary_path
+            SOURCE ${SHADER_SOURCE}
+            PROFILE ${SHADER_PROFILE}
+            NAME "${source_name}_${suffix}"
+            DEFINES ${defines}
+            ${entry_args}
+        )
+        list( APPEND binary_paths ${binary_path} )
+    endforeach()
+
+    set( ${var_binary_paths} ${binary_paths} PARENT_SCOPE )
+endfunction()
+
+# shader_reflect( <output variable>
+#     NAMESPACE <name>
+#     SHADERS <shader_build output variable>...
+#     [FREQUENCIES <binding>=<PerFrame|PerPass|PerMaterial|PerDraw>...]
+# )
+#
+# Generates ${CMAKE_CURRENT_BINARY_DIR}/generated/<namespace>.h from the listings
+# of the shaders that were built with shader_build. The header contains the
+# constant buffer layouts, the root signature bindings (and the root parameter
+# index of each binding) and the input layout of the shaders. Add the header
+# to the sources of the target that includes it and add the generated directory
+# to its include directories.
+function( shader_reflect var_header_path )
+    cmake_parse_arguments( REFLECT "" "NAMESPACE" "SHADERS;FREQUENCIES" ${ARGN} )
+
+    if( NOT SHADER_COMPILER )
+        set( ${var_header_path} "" PARENT_SCOPE )
+        return()
+    endif()
+
+    set( header_path "${CMAKE_CURRENT_BINARY_DIR}/generated/${REFLECT_NAMESPACE}.h" )
+
+    set( shader_args )
+    set( listings )
+    foreach( shader ${REFLECT_SHADERS} )
+        list( APPEND shader_args "${${shader}_STAGE}=${${shader}_LISTING}" )
+        list( APPEND listings "${${shader}_LISTING}" )
+    endforeach()
+
+    set( frequency_args )
+    foreach( frequency ${REFLECT_FREQUENCIES} )
+        list( APPEND frequency_args --frequency ${frequency} )
+    endforeach()
+
+    add_custom_command( OUTPUT ${header_path}
+        COMMENT "Generating shader reflection header ${REFLECT_NAMESPACE}.h..."
+        COMMAND ShaderReflect
+            --namespace ${REFLECT_NAMESPACE}
+            --output "${header_path}"
+            ${frequency_args}
+            ${shader_args}
+        DEPENDS ${listings} ShaderReflect
+    )
+
+    set( ${var_header_path} "${header_path}" PARENT_SCOPE )
+endfunction()
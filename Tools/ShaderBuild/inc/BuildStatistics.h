@@ -0,0 +1,35 @@
+#pragma once
+
+#include <string>
+
+/**
+ * Build statistics of the shader build.
+ *
+ * Every shader build appends a record to a CSV file. The records can be
+ * summarized with PrintReport to measure the cache hit rate and the time
+ * that is spent on preprocessing and compiling shaders.
+ */
+struct BuildRecord
+{
+    std::string Source;
+    std::string Profile;
+    std::string Defines;
+    bool CacheHit = false;
+    double PreprocessTime = 0.0;
+    double CompileTime = 0.0;
+    double TotalTime = 0.0;
+};
+
+namespace BuildStatistics
+{
+    /**
+     * Append a record to the statistics file. The header is written
+     * if the file does not exist yet.
+     */
+    bool Append(const std::string& fileName, const BuildRecord& record);
+
+    /**
+     * Print a summary of the records in the statistics file to stdout.
+     */
+    bool PrintReport(const std::string& fileName);
+}
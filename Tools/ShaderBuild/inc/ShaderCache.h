@@ -0,0 +1,63 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+/**
+ * A content-addressed cache of shader bytecode.
+ *
+ * Bytecode is stored under a key that is computed from the preprocessed
+ * source of the shader, the compiler options and the compiler itself.
+ * The cache does not depend on file time stamps, so touching a shader
+ * (or switching branches) does not cause a recompile, and a cache directory
+ * can be shared between build directories and build agents.
+ *
+ * Layout: <directory>/<first two characters of the key>/<key>.cso
+ *
+ * The assembly listing of a shader is stored next to the bytecode
+ * (<key>.lst) if it was requested when the shader was compiled.
+ */
+class ShaderCache
+{
+public:
+    explicit ShaderCache(const std::string& directory);
+
+    /**
+     * Compute the cache key of a shader.
+     *
+     * @param preprocessedSource The preprocessed source of the shader.
+     * @param compilerId Identifies the compiler (see ShaderCompiler::GetCompilerId).
+     * @param compileOptions The options that affect the generated bytecode.
+     * @param keepLineDirectives Keep #line directives in the key. Line directives
+     * contain the absolute paths of the source files, so they are only relevant if
+     * the bytecode contains debug information.
+     */
+    static std::string ComputeKey(
+        const std::string& preprocessedSource,
+        const std::string& compilerId,
+        const std::vector<std::string>& compileOptions,
+        bool keepLineDirectives);
+
+    /**
+     * Copy the bytecode (or listing) with the key to the output file.
+     *
+     * @param extension The extension of the cached file (.cso or .lst).
+     * @return false if the key is not in the cache.
+     */
+    bool Fetch(const std::string& key, const std::string& outputFile, const char* extension = BytecodeExtension) const;
+
+    /**
+     * Store a bytecode (or listing) file in the cache.
+     * The file is first copied to a temporary file and then renamed, so
+     * concurrent builds never read a partially written file.
+     */
+    bool Store(const std::string& key, const std::string& file, const char* extension = BytecodeExtension) const;
+
+    std::string GetPath(const std::string& key, const char* extension = BytecodeExtension) const;
+
+    static constexpr const char* BytecodeExtension = ".cso";
+    static constexpr const char* ListingExtension = ".lst";
+
+private:
+    std::string m_Directory;
+};
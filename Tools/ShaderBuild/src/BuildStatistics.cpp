@@ -0,0 +1,129 @@
+#include <BuildStatistics.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <system_error>
+#include <vector>
+
+namespace
+{
+    const char* Header = "source,profile,defines,result,preprocess_ms,compile_ms,total_ms";
+
+    // Fields must not contain commas.
+    std::string Escape(std::string field)
+    {
+        std::replace(field.begin(), field.end(), ',', ';');
+        return field;
+    }
+
+    struct Summary
+    {
+        size_t Count = 0;
+        double TotalTime = 0.0;
+        double MaxTime = 0.0;
+
+        void Add(double time)
+        {
+            ++Count;
+            TotalTime += time;
+            MaxTime = std::max(MaxTime, time);
+        }
+
+        double GetMeanTime() const
+        {
+            return Count > 0 ? TotalTime / Count : 0.0;
+        }
+    };
+}
+
+bool BuildStatistics::Append(const std::string& fileName, const BuildRecord& record)
+{
+    std::error_code error;
+    bool writeHeader = !std::filesystem::exists(fileName, error);
+
+    // A single write per record, so records of parallel builds don't interleave.
+    std::ostringstream line;
+    if (writeHeader)
+    {
+        line << Header << '\n';
+    }
+    line << Escape(record.Source) << ','
+        << Escape(record.Profile) << ','
+        << Escape(record.Defines) << ','
+        << (record.CacheHit ? "hit" : "miss") << ','
+        << record.PreprocessTime << ','
+        << record.CompileTime << ','
+        << record.TotalTime << '\n';
+
+    std::ofstream file(fileName, std::ios::app);
+    file << line.str();
+
+    return static_cast<bool>(file);
+}
+
+bool BuildStatistics::PrintReport(const std::string& fileName)
+{
+    std::ifstream file(fileName);
+    if (!file)
+    {
+        fprintf(stderr, "Failed to open %s\n", fileName.c_str());
+        return false;
+    }
+
+    Summary hits;
+    Summary misses;
+    double preprocessTime = 0.0;
+    double compileTime = 0.0;
+
+    std::string line;
+    while (std::getline(file, line))
+    {
+        if (line.empty() || line == Header)
+        {
+            continue;
+        }
+
+        std::vector<std::string> fields;
+        std::istringstream stream(line);
+        std::string field;
+        while (std::getline(stream, field, ','))
+        {
+            fields.push_back(field);
+        }
+
+        if (fields.size() != 7)
+        {
+            continue;
+        }
+
+        double totalTime = std::atof(fields[6].c_str());
+        if (fields[3] == "hit")
+        {
+            hits.Add(totalTime);
+        }
+        else
+        {
+            misses.Add(totalTime);
+        }
+
+        preprocessTime += std::atof(fields[4].c_str());
+        compileTime += std::atof(fields[5].c_str());
+    }
+
+    size_t numBuilds = hits.Count + misses.Count;
+    double hitRate = numBuilds > 0 ? 100.0 * hits.Count / numBuilds : 0.0;
+
+    printf("Shader builds:   %zu\n", numBuilds);
+    printf("Cache hits:      %zu (%.1f%%)\n", hits.Count, hitRate);
+    printf("Cache misses:    %zu\n", misses.Count);
+    printf("Hit time:        total %.1f ms, mean %.1f ms, max %.1f ms\n", hits.TotalTime, hits.GetMeanTime(), hits.MaxTime);
+    printf("Miss time:       total %.1f ms, mean %.1f ms, max %.1f ms\n", misses.TotalTime, misses.GetMeanTime(), misses.MaxTime);
+    printf("Preprocess time: %.1f ms\n", preprocessTime);
+    printf("Compile time:    %.1f ms\n", compileTime);
+
+    return true;
+}
@@ -0,0 +1,121 @@
+#include <ShaderCache.h>
+
+#include <Hash.h>
+
+#include <cinttypes>
+#include <cstdio>
+#include <filesystem>
+#include <sstream>
+#include <system_error>
+#include <random>
+
+namespace fs = std::filesystem;
+
+namespace
+{
+    // Remove the #line directives from the preprocessed source.
+    std::string RemoveLineDirectives(const std::string& source)
+    {
+        std::istringstream input(source);
+        std::string result;
+        result.reserve(source.size());
+
+        std::string line;
+        while (std::getline(input, line))
+        {
+            size_t first = line.find_first_not_of(" \t");
+            if (first != std::string::npos && line.compare(first, 5, "#line") == 0)
+            {
+                continue;
+            }
+            result += line;
+            result += '\n';
+        }
+
+        return result;
+    }
+}
+
+ShaderCache::ShaderCache(const std::string& directory)
+    : m_Directory(directory)
+{}
+
+std::string ShaderCache::ComputeKey(
+    const std::string& preprocessedSource,
+    const std::string& compilerId,
+    const std::vector<std::string>& compileOptions,
+    bool keepLineDirectives)
+{
+    // The key is built from two 64-bit hashes with different seeds
+    // to make collisions in a large shared cache unlikely.
+    Hasher hashers[2] = { Hasher(), Hasher(Hasher::OffsetBasis ^ 0x9E3779B97F4A7C15ull) };
+
+    std::string source = keepLineDirectives ? preprocessedSource : RemoveLineDirectives(preprocessedSource);
+
+    for (Hasher& hasher : hashers)
+    {
+        hasher.Add(compilerId);
+        hasher.Add(compileOptions.size());
+        for (const std::string& option : compileOptions)
+        {
+            hasher.Add(option);
+        }
+        hasher.Add(source);
+    }
+
+    char key[33];
+    snprintf(key, sizeof(key), "%016" PRIx64 "%016" PRIx64, hashers[0].GetHash(), hashers[1].GetHash());
+
+    return key;
+}
+
+std::string ShaderCache::GetPath(const std::string& key, const char* extension) const
+{
+    return (fs::path(m_Directory) / key.substr(0, 2) / (key + extension)).string();
+}
+
+bool ShaderCache::Fetch(const std::string& key, const std::string& outputFile, const char* extension) const
+{
+    std::error_code error;
+    fs::path cachedFile = GetPath(key, extension);
+    if (!fs::exists(cachedFile, error))
+    {
+        return false;
+    }
+
+    fs::path outputPath(outputFile);
+    if (outputPath.has_parent_path())
+    {
+        fs::create_directories(outputPath.parent_path(), error);
+    }
+
+    return fs::copy_file(cachedFile, outputPath, fs::copy_options::overwrite_existing, error);
+}
+
+bool ShaderCache::Store(const std::string& key, const std::string& file, const char* extension) const
+{
+    std::error_code error;
+    fs::path cachedFile = GetPath(key, extension);
+    fs::create_directories(cachedFile.parent_path(), error);
+
+    // Use a unique temporary file name, since other builds may store the same key.
+    std::random_device random;
+    std::ostringstream tempFileName;
+    tempFileName << cachedFile.string() << ".tmp." << std::hex << random() << random();
+    fs::path tempFile = tempFileName.str();
+
+    if (!fs::copy_file(file, tempFile, fs::copy_options::overwrite_existing, error))
+    {
+        return false;
+    }
+
+    fs::rename(tempFile, cachedFile, error);
+    if (error)
+    {
+        fs::remove(tempFile, error);
+        // Another build may have stored the same key in the meantime.
+        return fs::exists(cachedFile, error);
+    }
+
+    return true;
+}
@@ -0,0 +1,350 @@
+/**
+ * ShaderBuild compiles HLSL shaders through a content-addressed cache.
+ *
+ * The shader is preprocessed first and the cache key is computed from the
+ * preprocessed source, the compile options and the compiler. The shader is
+ * only compiled if the key is not in the cache.
+ *
+ * Usage:
+ *   ShaderBuild --backend <fxc|dxc> --compiler <path> --cache <dir> --profile <profile>
+ *               [--entry <name>] [--define <NAME[=VALUE]>]... [--include <dir>]...
+ *               [--debug] [--stats <file.csv>] [--listing <file.lst>] [--depfile <file.d>]
+ *               --output <file.cso> <source.hlsl>
+ *   ShaderBuild --report <file.csv>
+ *
+ * The depfile lists the shader and the files it includes (in Makefile format),
+ * so the build system rebuilds the shader when an included file changes.
+ */
+#include <BuildStatistics.h>
+#include <ShaderCache.h>
+#include <ShaderCompiler.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <system_error>
+
+namespace fs = std::filesystem;
+
+namespace
+{
+    struct Options
+    {
+        ShaderDesc Shader;
+        std::string Backend;
+        std::string CompilerPath;
+        std::string CacheDirectory;
+        std::string OutputFile;
+        // The assembly listing of the shader (input for ShaderReflect).
+        std::string ListingFile;
+        // The files the output depends on (see WriteDepFile).
+        std::string DepFile;
+        std::string StatsFile;
+        std::string ReportFile;
+    };
+
+    void PrintUsage()
+    {
+        fprintf(stderr,
+            "Usage:\n"
+            "  ShaderBuild --backend <fxc|dxc> --compiler <path> --cache <dir> --profile <profile>\n"
+            "              [--entry <name>] [--define <NAME[=VALUE]>]... [--include <dir>]...\n"
+            "              [--debug] [--stats <file.csv>] [--listing <file.lst>] [--depfile <file.d>]\n"
+            "              --output <file.cso> <source.hlsl>\n"
+            "  ShaderBuild --report <file.csv>\n");
+    }
+
+    bool ParseArguments(int argc, char* argv[], Options& options)
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            const char* argument = argv[i];
+            bool hasValue = i + 1 < argc;
+
+            if (strcmp(argument, "--debug") == 0)
+            {
+                options.Shader.Debug = true;
+            }
+            else if (strncmp(argument, "--", 2) == 0 && !hasValue)
+            {
+                fprintf(stderr, "Missing value for %s\n", argument);
+                return false;
+            }
+            else if (strcmp(argument, "--backend") == 0)
+            {
+                options.Backend = argv[++i];
+            }
+            else if (strcmp(argument, "--compiler") == 0)
+            {
+                options.CompilerPath = argv[++i];
+            }
+            else if (strcmp(argument, "--cache") == 0)
+            {
+                options.CacheDirectory = argv[++i];
+            }
+            else if (strcmp(argument, "--profile") == 0)
+            {
+                options.Shader.Profile = argv[++i];
+            }
+            else if (strcmp(argument, "--entry") == 0)
+            {
+                options.Shader.EntryPoint = argv[++i];
+            }
+            else if (strcmp(argument, "--define") == 0)
+            {
+                options.Shader.Defines.push_back(argv[++i]);
+            }
+            else if (strcmp(argument, "--include") == 0)
+            {
+                options.Shader.IncludeDirs.push_back(argv[++i]);
+            }
+            else if (strcmp(argument, "--output") == 0)
+            {
+                options.OutputFile = argv[++i];
+            }
+            else if (strcmp(argument, "--listing") == 0)
+            {
+                options.ListingFile = argv[++i];
+            }
+            else if (strcmp(argument, "--depfile") == 0)
+            {
+                options.DepFile = argv[++i];
+            }
+            else if (strcmp(argument, "--stats") == 0)
+            {
+                options.StatsFile = argv[++i];
+            }
+            else if (strcmp(argument, "--report") == 0)
+            {
+                options.ReportFile = argv[++i];
+            }
+            else if (strncmp(argument, "--", 2) == 0)
+            {
+                fprintf(stderr, "Unknown option %s\n", argument);
+                return false;
+            }
+            else if (options.Shader.Source.empty())
+            {
+                options.Shader.Source = argument;
+            }
+            else
+            {
+                fprintf(stderr, "Only one source file can be specified.\n");
+                return false;
+            }
+        }
+
+        if (!options.ReportFile.empty())
+        {
+            return true;
+        }
+
+        if (options.Backend.empty() || options.CompilerPath.empty() || options.CacheDirectory.empty() ||
+            options.Shader.Profile.empty() || options.OutputFile.empty() || options.Shader.Source.empty())
+        {
+            fprintf(stderr, "Missing required arguments.\n");
+            return false;
+        }
+
+        return true;
+    }
+
+    double GetElapsedMilliseconds(std::chrono::steady_clock::time_point start)
+    {
+        return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    std::string ReadFile(const std::string& fileName)
+    {
+        std::ifstream file(fileName, std::ios::binary);
+        std::ostringstream contents;
+        contents << file.rdbuf();
+        return contents.str();
+    }
+
+    // Escape a path for a Makefile rule.
+    std::string EscapeDepFilePath(const fs::path& path)
+    {
+        std::string escaped;
+        for (char c : path.generic_string())
+        {
+            if (c == ' ' || c == '#')
+            {
+                escaped += '\\';
+            }
+            else if (c == '$')
+            {
+                escaped += '$';
+            }
+            escaped += c;
+        }
+        return escaped;
+    }
+
+    // Write a Makefile rule that makes the output depend on the source files.
+    bool WriteDepFile(const std::string& depFile, const std::string& outputFile, const std::vector<std::string>& sourceFiles)
+    {
+        std::ofstream file(depFile, std::ios::trunc);
+        if (!file)
+        {
+            return false;
+        }
+
+        std::error_code error;
+        file << EscapeDepFilePath(fs::absolute(outputFile, error)) << ":";
+
+        std::vector<fs::path> paths;
+        for (const std::string& sourceFile : sourceFiles)
+        {
+            fs::path path = fs::absolute(sourceFile, error).lexically_normal();
+            if (std::find(paths.begin(), paths.end(), path) == paths.end())
+            {
+                file << " \\\n  " << EscapeDepFilePath(path);
+                paths.push_back(path);
+            }
+        }
+        file << "\n";
+
+        return static_cast<bool>(file);
+    }
+
+    std::string JoinDefines(const std::vector<std::string>& defines)
+    {
+        std::string result;
+        for (const std::string& define : defines)
+        {
+            if (!result.empty())
+            {
+                result += ' ';
+            }
+            result += define;
+        }
+        return result;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    Options options;
+    if (!ParseArguments(argc, argv, options))
+    {
+        PrintUsage();
+        return 1;
+    }
+
+    if (!options.ReportFile.empty())
+    {
+        return BuildStatistics::PrintReport(options.ReportFile) ? 0 : 1;
+    }
+
+    ShaderCompiler::Backend backend;
+    if (!ShaderCompiler::ParseBackend(options.Backend, backend))
+    {
+        fprintf(stderr, "Unknown backend %s (expected fxc or dxc).\n", options.Backend.c_str());
+        return 1;
+    }
+
+    ShaderCompiler compiler(backend, options.CompilerPath);
+    ShaderCache cache(options.CacheDirectory);
+
+    const ShaderDesc& shader = options.Shader;
+
+    BuildRecord record;
+    record.Source = fs::path(shader.Source).filename().string();
+    record.Profile = compiler.GetProfile(shader);
+    record.Defines = JoinDefines(shader.Defines);
+
+    auto start = std::chrono::steady_clock::now();
+
+    std::error_code error;
+    fs::path outputPath(options.OutputFile);
+    if (outputPath.has_parent_path())
+    {
+        fs::create_directories(outputPath.parent_path(), error);
+    }
+    fs::path listingPath(options.ListingFile);
+    if (listingPath.has_parent_path())
+    {
+        fs::create_directories(listingPath.parent_path(), error);
+    }
+    fs::path depFilePath(options.DepFile);
+    if (depFilePath.has_parent_path())
+    {
+        fs::create_directories(depFilePath.parent_path(), error);
+    }
+
+    // Preprocess the shader to compute the cache key.
+    std::string preprocessedFile = options.OutputFile + ".hlsl.i";
+    std::string messages;
+    if (!compiler.Preprocess(shader, preprocessedFile, messages))
+    {
+        fprintf(stderr, "%s", messages.c_str());
+        fprintf(stderr, "ShaderBuild: failed to preprocess %s\n", shader.Source.c_str());
+        return 1;
+    }
+
+    std::string preprocessedSource = ReadFile(preprocessedFile);
+    std::string key = ShaderCache::ComputeKey(preprocessedSource,
+        compiler.GetCompilerId(), compiler.GetCompileOptions(shader), shader.Debug);
+    fs::remove(preprocessedFile, error);
+
+    if (!options.DepFile.empty())
+    {
+        // The shader is always a dependency (even if the preprocessor
+        // doesn't emit #line directives).
+        std::vector<std::string> sourceFiles = ShaderCompiler::GetSourceFiles(preprocessedSource);
+        sourceFiles.insert(sourceFiles.begin(), shader.Source);
+        if (!WriteDepFile(options.DepFile, options.OutputFile, sourceFiles))
+        {
+            fprintf(stderr, "ShaderBuild: failed to write %s\n", options.DepFile.c_str());
+            return 1;
+        }
+    }
+
+    record.PreprocessTime = GetElapsedMilliseconds(start);
+
+    // The listing is cached with the bytecode. Entries that were stored without
+    // a listing are treated as a miss.
+    record.CacheHit = cache.Fetch(key, options.OutputFile) &&
+        (options.ListingFile.empty() || cache.Fetch(key, options.ListingFile, ShaderCache::ListingExtension));
+    if (!record.CacheHit)
+    {
+        auto compileStart = std::chrono::steady_clock::now();
+
+        if (!compiler.Compile(shader, options.OutputFile, options.ListingFile, messages))
+        {
+            fprintf(stderr, "%s", messages.c_str());
+            fprintf(stderr, "ShaderBuild: failed to compile %s\n", shader.Source.c_str());
+            return 1;
+        }
+        // Forward warnings.
+        fprintf(stderr, "%s", messages.c_str());
+
+        record.CompileTime = GetElapsedMilliseconds(compileStart);
+
+        if (!cache.Store(key, options.OutputFile) ||
+            (!options.ListingFile.empty() && !cache.Store(key, options.ListingFile, ShaderCache::ListingExtension)))
+        {
+            fprintf(stderr, "ShaderBuild: warning: failed to store %s in the cache\n", shader.Source.c_str());
+        }
+    }
+
+    record.TotalTime = GetElapsedMilliseconds(start);
+
+    printf("ShaderBuild: %s %s%s%s: cache %s (%.1f ms) [%s]\n",
+        record.Source.c_str(), record.Profile.c_str(),
+        record.Defines.empty() ? "" : " ", record.Defines.c_str(),
+        record.CacheHit ? "hit" : "miss", record.TotalTime, key.c_str());
+
+    if (!options.StatsFile.empty() && !BuildStatistics::Append(options.StatsFile, record))
+    {
+        fprintf(stderr, "ShaderBuild: warning: failed to write %s\n", options.StatsFile.c_str());
+    }
+
+    return 0;
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <RootSignatureOptimizer.h>
+#include <ShaderListing.h>
+
+#include <map>
+#include <string>
+#include <vector>
+
+/**
+ * Generates a C++ header with the binding metadata of a set of shaders
+ * (typically the shaders of a single pipeline):
+ *
+ *   * A struct for each constant buffer with static_asserts that verify the
+ *     offsets of the members against the HLSL packing rules.
+ *   * The resources that are used by the shaders as RootSignatureOptimizer
+ *     bindings.
+ *   * The root parameter index (and descriptor table offset) of each binding
+ *     in the optimized root signature as constexpr values.
+ *   * The root signature flags (stages without resources are denied root access).
+ *   * The input layout of the vertex shader.
+ */
+class ReflectionHeader
+{
+public:
+    struct Stage
+    {
+        // The shader stage (vs, hs, ds, gs, ps or cs).
+        std::string Name;
+        // The name of the file the reflection was parsed from (for the header comment).
+        std::string FileName;
+        ShaderReflection Reflection;
+    };
+
+    struct Desc
+    {
+        // The namespace of the generated declarations.
+        std::string Namespace;
+        std::vector<Stage> Stages;
+        // The update frequency of each binding (by name).
+        // Bindings that are not in the map are updated PerMaterial.
+        std::map<std::string, RootSignatureOptimizer::UpdateFrequency> Frequencies;
+    };
+
+    /**
+     * Parse the name of a shader stage (vs, hs, ds, gs, ps or cs).
+     *
+     * @return false if the name is not a valid stage.
+     */
+    static bool ParseStage(const std::string& name, RootSignatureOptimizer::ShaderVisibility& visibility);
+
+    /**
+     * Parse the name of an update frequency (PerFrame, PerPass, PerMaterial or PerDraw).
+     *
+     * @return false if the name is not a valid update frequency.
+     */
+    static bool ParseFrequency(const std::string& name, RootSignatureOptimizer::UpdateFrequency& frequency);
+
+    /**
+     * Generate the header.
+     *
+     * @return false if the header could not be generated. The reason is returned in error.
+     */
+    static bool Generate(const Desc& desc, std::string& header, std::string& error);
+};
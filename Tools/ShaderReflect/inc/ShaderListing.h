@@ -0,0 +1,73 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * The reflection data of a compiled shader.
+ *
+ * The reflection is parsed from the assembly listing that is written by
+ * the shader compiler (fxc /Fc or dxc -Fc). The listing has the same
+ * format for both compilers (except for the comment prefix) and can be
+ * parsed on any platform.
+ */
+struct ShaderReflection
+{
+    struct ConstantBufferMember
+    {
+        // The HLSL type (for example, float4x4). For structs this is the struct type name.
+        std::string Type;
+        std::string Name;
+        // The number of array elements (0 if the member is not an array).
+        uint32_t ArraySize = 0;
+        uint32_t Offset = 0;
+        // The size of the member in bytes (0 if the listing does not contain the size).
+        uint32_t Size = 0;
+        bool IsStruct = false;
+        // The members of a struct (offsets are relative to the struct).
+        std::vector<ConstantBufferMember> Members;
+    };
+
+    struct ConstantBuffer
+    {
+        std::string Name;
+        std::vector<ConstantBufferMember> Members;
+        // The size of the constant buffer in bytes (0 if the listing does not contain the size).
+        uint32_t Size = 0;
+    };
+
+    struct ResourceBinding
+    {
+        std::string Name;
+        // The register type: 'b' (CBV), 't' (SRV), 'u' (UAV) or 's' (sampler).
+        char RegisterType = 't';
+        uint32_t Register = 0;
+        uint32_t Space = 0;
+        // The number of descriptors (~0u for unbounded arrays).
+        uint32_t Count = 1;
+    };
+
+    struct InputElement
+    {
+        std::string SemanticName;
+        uint32_t SemanticIndex = 0;
+        uint32_t Register = 0;
+        uint32_t NumComponents = 0;
+        // float, int or uint.
+        std::string ComponentType;
+        // System values (SV_VertexID, etc.) are not part of the input layout.
+        bool IsSystemValue = false;
+    };
+
+    std::vector<ConstantBuffer> ConstantBuffers;
+    std::vector<ResourceBinding> ResourceBindings;
+    std::vector<InputElement> InputSignature;
+};
+
+/**
+ * Parse the reflection data from a shader assembly listing.
+ *
+ * @return false if the listing could not be parsed. The reason is returned in error.
+ */
+bool ParseShaderListing(const std::string& listing, ShaderReflection& reflection, std::string& error);
@@ -0,0 +1,565 @@
+#include <ReflectionHeader.h>
+
+#include <algorithm>
+#include <cctype>
+#include <iterator>
+#include <set>
+#include <sstream>
+#include <tuple>
+
+namespace
+{
+    using Binding = RootSignatureOptimizer::Binding;
+    using BindingType = RootSignatureOptimizer::BindingType;
+    using ShaderVisibility = RootSignatureOptimizer::ShaderVisibility;
+    using UpdateFrequency = RootSignatureOptimizer::UpdateFrequency;
+    using ConstantBuffer = ShaderReflection::ConstantBuffer;
+    using ConstantBufferMember = ShaderReflection::ConstantBufferMember;
+
+    const char* const BindingTypeNames[] = { "SRV", "UAV", "CBV", "Sampler" };
+    const char* const VisibilityNames[] = { "All", "Vertex", "Hull", "Domain", "Geometry", "Pixel" };
+    const char* const FrequencyNames[] = { "PerFrame", "PerPass", "PerMaterial", "PerDraw" };
+
+    // A binding that is used by one or more of the stages.
+    struct NamedBinding
+    {
+        std::string Name;
+        RootSignatureOptimizer::Binding Binding;
+    };
+
+    // The C++ type of an HLSL constant buffer member.
+    struct MemberType
+    {
+        // The C++ type (empty if the member is copied as raw bytes).
+        std::string Type;
+        uint32_t Size;
+    };
+
+    // Replace the characters that are not valid in a C++ identifier.
+    std::string ToIdentifier(const std::string& name)
+    {
+        std::string identifier = name;
+        for (char& c : identifier)
+        {
+            if (!std::isalnum(static_cast<unsigned char>(c)))
+            {
+                c = '_';
+            }
+        }
+        if (identifier.empty() || std::isdigit(static_cast<unsigned char>(identifier[0])))
+        {
+            identifier.insert(identifier.begin(), '_');
+        }
+        return identifier;
+    }
+
+    // Get the C++ type of a scalar, vector or 4x4 matrix type.
+    // Other types (and arrays of types that are not 16 bytes) are copied as raw bytes.
+    bool GetMemberType(const ConstantBufferMember& member, MemberType& memberType)
+    {
+        if (member.IsStruct)
+        {
+            return false;
+        }
+
+        std::string type = member.Type;
+        if (type == "matrix")
+        {
+            type = "float4x4";
+        }
+        else if (type == "dword")
+        {
+            type = "uint";
+        }
+
+        std::string scalar = type;
+        uint32_t numComponents = 1;
+        if (!type.empty() && type.back() >= '1' && type.back() <= '4')
+        {
+            scalar = type.substr(0, type.size() - 1);
+            numComponents = type.back() - '0';
+        }
+
+        if (scalar == "float4x")
+        {
+            if (numComponents != 4)
+            {
+                return false;
+            }
+            memberType = { "DirectX::XMFLOAT4X4", 64 };
+        }
+        else if (scalar == "float")
+        {
+            memberType.Type = numComponents == 1 ? "float" : "DirectX::XMFLOAT" + std::to_string(numComponents);
+        }
+        else if (scalar == "int")
+        {
+            memberType.Type = numComponents == 1 ? "int32_t" : "DirectX::XMINT" + std::to_string(numComponents);
+        }
+        else if (scalar == "uint" || scalar == "bool")
+        {
+            // HLSL bools are 32-bit in constant buffers.
+            memberType.Type = numComponents == 1 ? "uint32_t" : "DirectX::XMUINT" + std::to_string(numComponents);
+        }
+        else
+        {
+            return false;
+        }
+
+        if (scalar != "float4x")
+        {
+            memberType.Size = numComponents * 4;
+        }
+
+        // Array elements are aligned to 16 bytes, so only arrays of
+        // 16-byte types have the same layout in C++.
+        if (member.ArraySize > 0)
+        {
+            if (memberType.Size % 16 != 0)
+            {
+                return false;
+            }
+            memberType.Size *= member.ArraySize;
+        }
+
+        return true;
+    }
+
+    // Remove the structs that wrap the members of a constant buffer
+    // (ConstantBuffer<T> is reflected as a cbuffer with a single struct member).
+    const std::vector<ConstantBufferMember>& UnwrapMembers(const ConstantBuffer& constantBuffer, std::string& typeName)
+    {
+        const std::vector<ConstantBufferMember>* members = &constantBuffer.Members;
+        typeName = constantBuffer.Name;
+
+        while (members->size() == 1 && members->front().IsStruct &&
+            members->front().Offset == 0 && members->front().ArraySize == 0)
+        {
+            typeName = members->front().Type;
+            members = &members->front().Members;
+        }
+
+        return *members;
+    }
+
+    bool WriteConstantBuffer(std::ostream& out, const ConstantBuffer& constantBuffer, const std::string& typeName,
+        const std::vector<ConstantBufferMember>& members, std::string& error)
+    {
+        std::string structName = ToIdentifier(typeName);
+
+        std::ostringstream asserts;
+        uint32_t offset = 0;
+        uint32_t numPadding = 0;
+
+        out << "    // cbuffer " << constantBuffer.Name << "\n";
+        out << "    struct " << structName << "\n";
+        out << "    {\n";
+
+        for (size_t i = 0; i < members.size(); ++i)
+        {
+            const ConstantBufferMember& member = members[i];
+            std::string memberName = ToIdentifier(member.Name);
+
+            if (member.Offset < offset)
+            {
+                error = "Overlapping member " + member.Name + " in constant buffer " + constantBuffer.Name;
+                return false;
+            }
+            if (member.Offset > offset)
+            {
+                out << "        uint8_t Padding" << numPadding++ << "[" << member.Offset - offset << "];\n";
+            }
+
+            MemberType memberType;
+            if (GetMemberType(member, memberType))
+            {
+                out << "        " << memberType.Type << " " << memberName;
+                if (member.ArraySize > 0)
+                {
+                    out << "[" << member.ArraySize << "]";
+                }
+                out << ";\n";
+            }
+            else
+            {
+                // The size of the member is the distance to the next member if the listing doesn't contain the size.
+                uint32_t end = i + 1 < members.size() ? members[i + 1].Offset : constantBuffer.Size;
+                memberType.Size = member.Size > 0 ? member.Size : end - member.Offset;
+                out << "        uint8_t " << memberName << "[" << memberType.Size << "]; // " << member.Type;
+                if (member.ArraySize > 0)
+                {
+                    out << "[" << member.ArraySize << "]";
+                }
+                out << "\n";
+            }
+
+            asserts << "    static_assert(offsetof(" << structName << ", " << memberName << ") == " << member.Offset
+                << ", \"" << structName << "::" << memberName << " does not match the HLSL layout.\");\n";
+
+            offset = member.Offset + memberType.Size;
+        }
+
+        if (offset < constantBuffer.Size)
+        {
+            out << "        uint8_t Padding" << numPadding++ << "[" << constantBuffer.Size - offset << "];\n";
+        }
+
+        out << "    };\n";
+        out << asserts.str();
+        out << "    static_assert(sizeof(" << structName << ") == " << constantBuffer.Size
+            << ", \"" << structName << " does not match the HLSL layout.\");\n\n";
+
+        return true;
+    }
+
+    const char* GetFormat(const ShaderReflection::InputElement& element)
+    {
+        static const char* const FloatFormats[] = { "R32_FLOAT", "R32G32_FLOAT", "R32G32B32_FLOAT", "R32G32B32A32_FLOAT" };
+        static const char* const UintFormats[] = { "R32_UINT", "R32G32_UINT", "R32G32B32_UINT", "R32G32B32A32_UINT" };
+        static const char* const SintFormats[] = { "R32_SINT", "R32G32_SINT", "R32G32B32_SINT", "R32G32B32A32_SINT" };
+
+        uint32_t index = element.NumComponents - 1;
+        if (index > 3)
+        {
+            return nullptr;
+        }
+        if (element.ComponentType == "float")
+        {
+            return FloatFormats[index];
+        }
+        if (element.ComponentType == "uint")
+        {
+            return UintFormats[index];
+        }
+        if (element.ComponentType == "int")
+        {
+            return SintFormats[index];
+        }
+        return nullptr;
+    }
+}
+
+bool ReflectionHeader::ParseStage(const std::string& name, ShaderVisibility& visibility)
+{
+    static const std::pair<const char*, ShaderVisibility> Stages[] =
+    {
+        { "vs", ShaderVisibility::Vertex },
+        { "hs", ShaderVisibility::Hull },
+        { "ds", ShaderVisibility::Domain },
+        { "gs", ShaderVisibility::Geometry },
+        { "ps", ShaderVisibility::Pixel },
+        { "cs", ShaderVisibility::All },
+    };
+
+    for (const auto& stage : Stages)
+    {
+        if (name == stage.first)
+        {
+            visibility = stage.second;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool ReflectionHeader::ParseFrequency(const std::string& name, UpdateFrequency& frequency)
+{
+    for (uint32_t i = 0; i < std::size(FrequencyNames); ++i)
+    {
+        if (name == FrequencyNames[i])
+        {
+            frequency = static_cast<UpdateFrequency>(i);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool ReflectionHeader::Generate(const Desc& desc, std::string& header, std::string& error)
+{
+    std::ostringstream out;
+
+    out << "// Generated by ShaderReflect from";
+    for (size_t i = 0; i < desc.Stages.size(); ++i)
+    {
+        out << (i > 0 ? ", " : " ") << desc.Stages[i].FileName << " (" << desc.Stages[i].Name << ")";
+    }
+    out << ".\n";
+    out << "// Do not edit. The header is regenerated when the shaders are built.\n";
+    out << "#pragma once\n\n";
+    out << "#include <RootSignatureOptimizer.h>\n\n";
+    out << "#include <DirectXMath.h>\n";
+    out << "#include <d3d12.h>\n\n";
+    out << "#include <cstddef>\n";
+    out << "#include <cstdint>\n\n";
+    out << "namespace " << desc.Namespace << "\n";
+    out << "{\n";
+
+    // Constant buffer layouts (constant buffers that are used by multiple stages are only written once).
+    std::map<std::string, uint32_t> constantBufferSizes;
+    std::set<std::string> structNames;
+    bool firstConstantBuffer = true;
+
+    for (const Stage& stage : desc.Stages)
+    {
+        for (const ConstantBuffer& constantBuffer : stage.Reflection.ConstantBuffers)
+        {
+            auto iter = constantBufferSizes.find(constantBuffer.Name);
+            if (iter != constantBufferSizes.end())
+            {
+                if (iter->second != constantBuffer.Size)
+                {
+                    error = "Constant buffer " + constantBuffer.Name + " has a different size in the " + stage.Name + " stage.";
+                    return false;
+                }
+                continue;
+            }
+            constantBufferSizes[constantBuffer.Name] = constantBuffer.Size;
+
+            std::string typeName;
+            const std::vector<ConstantBufferMember>& members = UnwrapMembers(constantBuffer, typeName);
+            if (!structNames.insert(ToIdentifier(typeName)).second)
+            {
+                error = "Constant buffer type " + typeName + " is used by multiple constant buffers.";
+                return false;
+            }
+
+            if (firstConstantBuffer)
+            {
+                out << "    // Constant buffer layouts.\n";
+                firstConstantBuffer = false;
+            }
+            if (!WriteConstantBuffer(out, constantBuffer, typeName, members, error))
+            {
+                return false;
+            }
+        }
+    }
+
+    // Merge the bindings of the stages.
+    std::vector<NamedBinding> bindings;
+    std::map<std::tuple<BindingType, uint32_t, uint32_t>, size_t> bindingIndices;
+    uint32_t stageMask = 0;
+
+    for (const Stage& stage : desc.Stages)
+    {
+        ShaderVisibility visibility;
+        if (!ParseStage(stage.Name, visibility))
+        {
+            error = "Unknown shader stage " + stage.Name;
+            return false;
+        }
+
+        for (const ShaderReflection::ResourceBinding& resourceBinding : stage.Reflection.ResourceBindings)
+        {
+            Binding binding;
+            switch (resourceBinding.RegisterType)
+            {
+            case 'b':
+                binding.Type = BindingType::CBV;
+                break;
+            case 't':
+                binding.Type = BindingType::SRV;
+                break;
+            case 'u':
+                binding.Type = BindingType::UAV;
+                break;
+            default:
+                binding.Type = BindingType::Sampler;
+                break;
+            }
+            binding.ShaderRegister = resourceBinding.Register;
+            binding.RegisterSpace = resourceBinding.Space;
+            binding.NumDescriptors = resourceBinding.Count;
+            binding.Visibility = visibility;
+
+            auto frequency = desc.Frequencies.find(resourceBinding.Name);
+            if (frequency != desc.Frequencies.end())
+            {
+                binding.Frequency = frequency->second;
+            }
+
+            if (binding.Type == BindingType::CBV)
+            {
+                auto size = constantBufferSizes.find(resourceBinding.Name);
+                binding.SizeInBytes = size != constantBufferSizes.end() ? size->second : 0;
+            }
+
+            stageMask |= 1u << static_cast<uint32_t>(visibility);
+
+            auto key = std::make_tuple(binding.Type, binding.RegisterSpace, binding.ShaderRegister);
+            auto iter = bindingIndices.find(key);
+            if (iter == bindingIndices.end())
+            {
+                bindingIndices.emplace(key, bindings.size());
+                bindings.push_back({ resourceBinding.Name, binding });
+            }
+            else if (bindings[iter->second].Binding.Visibility != visibility)
+            {
+                bindings[iter->second].Binding.Visibility = ShaderVisibility::All;
+            }
+        }
+    }
+
+    std::vector<Binding> optimizerBindings;
+    for (const NamedBinding& binding : bindings)
+    {
+        optimizerBindings.push_back(binding.Binding);
+    }
+    RootSignatureOptimizer::Layout layout = RootSignatureOptimizer::Optimize(optimizerBindings);
+
+    if (!bindings.empty())
+    {
+        out << "    // The resources that are used by the shaders.\n";
+        out << "    inline constexpr RootSignatureOptimizer::Binding Bindings[] =\n";
+        out << "    {\n";
+        for (const NamedBinding& namedBinding : bindings)
+        {
+            const Binding& binding = namedBinding.Binding;
+            out << "        // " << namedBinding.Name << "\n";
+            out << "        {\n";
+            out << "            RootSignatureOptimizer::BindingType::" << BindingTypeNames[static_cast<uint32_t>(binding.Type)] << ",\n";
+            out << "            " << binding.ShaderRegister << ", " << binding.RegisterSpace << ", ";
+            if (binding.NumDescriptors == ~0u)
+            {
+                out << "~0u";
+            }
+            else
+            {
+                out << binding.NumDescriptors;
+            }
+            out << ", " << binding.SizeInBytes << ",\n";
+            out << "            RootSignatureOptimizer::ShaderVisibility::" << VisibilityNames[static_cast<uint32_t>(binding.Visibility)] << ",\n";
+            out << "            RootSignatureOptimizer::UpdateFrequency::" << FrequencyNames[static_cast<uint32_t>(binding.Frequency)] << ",\n";
+            out << "        },\n";
+        }
+        out << "    };\n\n";
+
+        out << "    // The index of each binding in Bindings.\n";
+        out << "    namespace BindingIndex\n";
+        out << "    {\n";
+        for (size_t i = 0; i < bindings.size(); ++i)
+        {
+            out << "        constexpr uint32_t " << ToIdentifier(bindings[i].Name) << " = " << i << ";\n";
+        }
+        out << "    }\n\n";
+    }
+
+    out << "    // The root signature that is built by RootSignatureOptimizer::Optimize(Bindings)\n";
+    out << "    // with the default settings.\n";
+    out << "    constexpr uint32_t NumRootParameters = " << layout.Parameters.size() << ";\n";
+    out << "    constexpr uint32_t RootSignatureDWORDs = " << layout.NumDWORDs << ";\n\n";
+
+    if (!bindings.empty())
+    {
+        out << "    // The root parameter index of each binding.\n";
+        out << "    namespace RootParameters\n";
+        out << "    {\n";
+        for (size_t i = 0; i < bindings.size(); ++i)
+        {
+            out << "        constexpr uint32_t " << ToIdentifier(bindings[i].Name) << " = " << layout.Remap[i].RootParameterIndex << ";\n";
+        }
+        out << "    }\n\n";
+
+        out << "    // The offset of each binding in its descriptor table (0 for root constants).\n";
+        out << "    namespace DescriptorOffsets\n";
+        out << "    {\n";
+        for (size_t i = 0; i < bindings.size(); ++i)
+        {
+            out << "        constexpr uint32_t " << ToIdentifier(bindings[i].Name) << " = " << layout.Remap[i].DescriptorOffset << ";\n";
+        }
+        out << "    }\n\n";
+    }
+
+    // Deny root access to the graphics stages that don't use any resources.
+    const Stage* vertexStage = nullptr;
+    bool isCompute = false;
+    for (const Stage& stage : desc.Stages)
+    {
+        if (stage.Name == "vs")
+        {
+            vertexStage = &stage;
+        }
+        isCompute = isCompute || stage.Name == "cs";
+    }
+
+    std::vector<std::string> flags;
+    if (vertexStage && !vertexStage->Reflection.InputSignature.empty())
+    {
+        flags.push_back("D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT");
+    }
+    if (!isCompute)
+    {
+        static const std::pair<ShaderVisibility, const char*> DenyFlags[] =
+        {
+            { ShaderVisibility::Vertex, "D3D12_ROOT_SIGNATURE_FLAG_DENY_VERTEX_SHADER_ROOT_ACCESS" },
+            { ShaderVisibility::Hull, "D3D12_ROOT_SIGNATURE_FLAG_DENY_HULL_SHADER_ROOT_ACCESS" },
+            { ShaderVisibility::Domain, "D3D12_ROOT_SIGNATURE_FLAG_DENY_DOMAIN_SHADER_ROOT_ACCESS" },
+            { ShaderVisibility::Geometry, "D3D12_ROOT_SIGNATURE_FLAG_DENY_GEOMETRY_SHADER_ROOT_ACCESS" },
+            { ShaderVisibility::Pixel, "D3D12_ROOT_SIGNATURE_FLAG_DENY_PIXEL_SHADER_ROOT_ACCESS" },
+        };
+        for (const auto& denyFlag : DenyFlags)
+        {
+            if ((stageMask & (1u << static_cast<uint32_t>(denyFlag.first))) == 0)
+            {
+                flags.push_back(denyFlag.second);
+            }
+        }
+    }
+
+    out << "    // Allow the input layout and deny root access to the stages that don't use any resources.\n";
+    out << "    inline const D3D12_ROOT_SIGNATURE_FLAGS RootSignatureFlags =";
+    if (flags.empty())
+    {
+        out << " D3D12_ROOT_SIGNATURE_FLAG_NONE";
+    }
+    for (size_t i = 0; i < flags.size(); ++i)
+    {
+        out << (i > 0 ? " |" : "") << "\n        " << flags[i];
+    }
+    out << ";\n";
+
+    // The input layout of the vertex shader (system values are generated by the input assembler).
+    if (vertexStage)
+    {
+        std::vector<ShaderReflection::InputElement> elements;
+        for (const ShaderReflection::InputElement& element : vertexStage->Reflection.InputSignature)
+        {
+            if (!element.IsSystemValue)
+            {
+                elements.push_back(element);
+            }
+        }
+        std::stable_sort(elements.begin(), elements.end(), [](const auto& lhs, const auto& rhs)
+        {
+            return lhs.Register < rhs.Register;
+        });
+
+        if (!elements.empty())
+        {
+            out << "\n";
+            out << "    // The input layout of the vertex shader. The formats are derived from the\n";
+            out << "    // shader signature (32-bit components) and the elements are tightly packed in slot 0.\n";
+            out << "    inline const D3D12_INPUT_ELEMENT_DESC InputLayout[] =\n";
+            out << "    {\n";
+            for (const ShaderReflection::InputElement& element : elements)
+            {
+                const char* format = GetFormat(element);
+                if (!format)
+                {
+                    error = "Unsupported input element type " + element.ComponentType + " (" + element.SemanticName + ")";
+                    return false;
+                }
+
+                out << "        { \"" << element.SemanticName << "\", " << element.SemanticIndex << ", DXGI_FORMAT_" << format
+                    << ", 0, D3D12_APPEND_ALIGNED_ELEMENT, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },\n";
+            }
+            out << "    };\n";
+        }
+    }
+
+    out << "}\n";
+
+    header = out.str();
+    return true;
+}
@@ -0,0 +1,417 @@
+#include <ShaderListing.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+
+namespace
+{
+    using ConstantBufferMember = ShaderReflection::ConstantBufferMember;
+
+    std::string Trim(const std::string& value)
+    {
+        size_t first = value.find_first_not_of(" \t\r");
+        if (first == std::string::npos)
+        {
+            return std::string();
+        }
+        size_t last = value.find_last_not_of(" \t\r");
+        return value.substr(first, last - first + 1);
+    }
+
+    bool StartsWith(const std::string& value, const char* prefix)
+    {
+        return value.compare(0, strlen(prefix), prefix) == 0;
+    }
+
+    // Remove the comment prefix (// for fxc, ; for dxc) from a line of the listing.
+    // Returns false if the line is not a comment.
+    bool StripComment(const std::string& line, std::string& text)
+    {
+        std::string trimmed = Trim(line);
+        if (StartsWith(trimmed, "//"))
+        {
+            text = Trim(trimmed.substr(2));
+            return true;
+        }
+        if (StartsWith(trimmed, ";"))
+        {
+            text = Trim(trimmed.substr(1));
+            return true;
+        }
+        return false;
+    }
+
+    std::vector<std::string> Split(const std::string& value)
+    {
+        std::vector<std::string> tokens;
+        std::istringstream stream(value);
+        std::string token;
+        while (stream >> token)
+        {
+            tokens.push_back(token);
+        }
+        return tokens;
+    }
+
+    // Parse "Offset: <n> [Size: <n>]" at the end of a member declaration.
+    void ParseOffsetAndSize(const std::string& text, uint32_t& offset, uint32_t& size)
+    {
+        size_t offsetPos = text.find("Offset:");
+        offset = static_cast<uint32_t>(std::strtoul(text.c_str() + offsetPos + 7, nullptr, 10));
+
+        size_t sizePos = text.find("Size:", offsetPos);
+        size = sizePos != std::string::npos ? static_cast<uint32_t>(std::strtoul(text.c_str() + sizePos + 5, nullptr, 10)) : 0;
+    }
+
+    // The declaration before the offset comment (without the trailing comment prefix and semicolon).
+    std::string GetDeclaration(const std::string& text)
+    {
+        std::string declaration = text.substr(0, text.find("Offset:"));
+        declaration = Trim(declaration);
+
+        // Remove the comment prefix of the offset comment.
+        if (declaration.size() >= 2 && declaration.compare(declaration.size() - 2, 2, "//") == 0)
+        {
+            declaration.erase(declaration.size() - 2);
+        }
+        declaration = Trim(declaration);
+        while (!declaration.empty() && declaration.back() == ';')
+        {
+            declaration.pop_back();
+            declaration = Trim(declaration);
+        }
+
+        return declaration;
+    }
+
+    // Split a name of the form Name[N] into the name and the array size.
+    void ParseArrayName(const std::string& value, std::string& name, uint32_t& arraySize)
+    {
+        size_t bracket = value.find('[');
+        if (bracket == std::string::npos)
+        {
+            name = value;
+            arraySize = 0;
+        }
+        else
+        {
+            name = value.substr(0, bracket);
+            arraySize = static_cast<uint32_t>(std::strtoul(value.c_str() + bracket + 1, nullptr, 10));
+        }
+    }
+
+    std::string StripStructPrefix(const std::string& typeName)
+    {
+        // DXC prefixes struct types with "struct.".
+        return StartsWith(typeName, "struct.") ? typeName.substr(7) : typeName;
+    }
+
+    enum class Section
+    {
+        None,
+        BufferDefinitions,
+        ResourceBindings,
+        InputSignature,
+        Other,
+    };
+
+    Section GetSection(const std::string& text)
+    {
+        if (text == "Buffer Definitions:")
+        {
+            return Section::BufferDefinitions;
+        }
+        if (text == "Resource Bindings:")
+        {
+            return Section::ResourceBindings;
+        }
+        if (text == "Input signature:")
+        {
+            return Section::InputSignature;
+        }
+        if (text == "Output signature:" || text == "Patch Constant signature:" || text == "Pipeline Runtime Information:")
+        {
+            return Section::Other;
+        }
+        return Section::None;
+    }
+
+    // Parses the members of the constant buffers in the buffer definitions section.
+    class BufferDefinitionParser
+    {
+    public:
+        explicit BufferDefinitionParser(ShaderReflection& reflection)
+            : m_Reflection(reflection)
+            , m_Depth(0)
+            , m_IsConstantBuffer(false)
+        {}
+
+        bool ParseLine(const std::string& text, std::string& error)
+        {
+            if (text.empty())
+            {
+                return true;
+            }
+
+            if (m_Depth == 0)
+            {
+                if (text == "{")
+                {
+                    m_Depth = 1;
+                    m_Structs.clear();
+                    m_Structs.emplace_back();
+                }
+                else if (StartsWith(text, "cbuffer "))
+                {
+                    m_IsConstantBuffer = true;
+                    m_Name = Trim(text.substr(8));
+                }
+                else
+                {
+                    // Other buffers (tbuffers, structured buffers) are not reflected.
+                    m_IsConstantBuffer = false;
+                }
+                return true;
+            }
+
+            if (StartsWith(text, "struct "))
+            {
+                ConstantBufferMember member;
+                member.IsStruct = true;
+                member.Type = StripStructPrefix(Trim(text.substr(7)));
+                m_Structs.push_back(member);
+                return true;
+            }
+
+            if (text == "{")
+            {
+                ++m_Depth;
+                return true;
+            }
+
+            if (StartsWith(text, "}"))
+            {
+                --m_Depth;
+
+                if (m_Depth == 0)
+                {
+                    if (m_IsConstantBuffer)
+                    {
+                        ShaderReflection::ConstantBuffer constantBuffer;
+                        constantBuffer.Name = m_Name;
+                        constantBuffer.Members = std::move(m_Structs.front().Members);
+                        constantBuffer.Size = GetSize(constantBuffer.Members);
+                        m_Reflection.ConstantBuffers.push_back(std::move(constantBuffer));
+                    }
+                    m_IsConstantBuffer = false;
+                    return true;
+                }
+
+                if (m_Structs.size() < 2 || text.find("Offset:") == std::string::npos)
+                {
+                    error = "Unexpected end of struct: " + text;
+                    return false;
+                }
+
+                // } Name; // Offset: <n> [Size: <n>]
+                ConstantBufferMember member = std::move(m_Structs.back());
+                m_Structs.pop_back();
+
+                std::string declaration = Trim(GetDeclaration(text).substr(1));
+                ParseArrayName(declaration, member.Name, member.ArraySize);
+                ParseOffsetAndSize(text, member.Offset, member.Size);
+
+                m_Structs.back().Members.push_back(std::move(member));
+                return true;
+            }
+
+            if (text.find("Offset:") != std::string::npos)
+            {
+                // [modifiers] Type Name; // Offset: <n> [Size: <n>]
+                std::vector<std::string> tokens = Split(GetDeclaration(text));
+                if (tokens.size() < 2)
+                {
+                    error = "Invalid constant buffer member: " + text;
+                    return false;
+                }
+
+                ConstantBufferMember member;
+                member.Type = tokens[tokens.size() - 2];
+                ParseArrayName(tokens.back(), member.Name, member.ArraySize);
+                ParseOffsetAndSize(text, member.Offset, member.Size);
+
+                m_Structs.back().Members.push_back(std::move(member));
+            }
+
+            return true;
+        }
+
+    private:
+        // The size of the constant buffer from the member that ends last.
+        static uint32_t GetSize(const std::vector<ConstantBufferMember>& members)
+        {
+            uint32_t size = 0;
+            for (const ConstantBufferMember& member : members)
+            {
+                size = std::max(size, member.Offset + member.Size);
+            }
+            return size;
+        }
+
+        ShaderReflection& m_Reflection;
+        int m_Depth;
+        bool m_IsConstantBuffer;
+        std::string m_Name;
+        // The stack of structs that are being parsed. The first element
+        // contains the members of the constant buffer.
+        std::vector<ConstantBufferMember> m_Structs;
+    };
+
+    bool ParseResourceBinding(const std::string& text, ShaderReflection::ResourceBinding& binding, std::string& error)
+    {
+        // Name Type Format Dim [ID] HLSL-Bind Count
+        std::vector<std::string> tokens = Split(text);
+        if (tokens.size() < 6)
+        {
+            error = "Invalid resource binding: " + text;
+            return false;
+        }
+
+        binding.Name = tokens[0];
+
+        // <type><register>[,space<n>]
+        const std::string& bind = tokens[tokens.size() - 2];
+        binding.RegisterType = bind[0] == 'c' ? 'b' : bind[0];
+        size_t registerStart = bind.find_first_of("0123456789");
+        if (registerStart == std::string::npos)
+        {
+            error = "Invalid resource binding: " + text;
+            return false;
+        }
+        binding.Register = static_cast<uint32_t>(std::strtoul(bind.c_str() + registerStart, nullptr, 10));
+
+        size_t space = bind.find("space");
+        binding.Space = space != std::string::npos ? static_cast<uint32_t>(std::strtoul(bind.c_str() + space + 5, nullptr, 10)) : 0;
+
+        const std::string& count = tokens.back();
+        binding.Count = count == "unbounded" ? ~0u : static_cast<uint32_t>(std::strtoul(count.c_str(), nullptr, 10));
+
+        if (binding.RegisterType != 'b' && binding.RegisterType != 't' &&
+            binding.RegisterType != 'u' && binding.RegisterType != 's')
+        {
+            error = "Unknown register type: " + text;
+            return false;
+        }
+
+        return true;
+    }
+
+    bool ParseInputElement(const std::string& text, ShaderReflection::InputElement& element, std::string& error)
+    {
+        // Name Index Mask Register SysValue Format [Used]
+        std::vector<std::string> tokens = Split(text);
+        if (tokens.size() < 6)
+        {
+            error = "Invalid input signature element: " + text;
+            return false;
+        }
+
+        element.SemanticName = tokens[0];
+        element.SemanticIndex = static_cast<uint32_t>(std::strtoul(tokens[1].c_str(), nullptr, 10));
+        element.NumComponents = static_cast<uint32_t>(tokens[2].find_first_not_of("xyzw") == std::string::npos ? tokens[2].size() : 0);
+        element.Register = static_cast<uint32_t>(std::strtoul(tokens[3].c_str(), nullptr, 10));
+        element.IsSystemValue = tokens[4] != "NONE";
+        element.ComponentType = tokens[5];
+
+        if (element.NumComponents == 0)
+        {
+            error = "Invalid input signature mask: " + text;
+            return false;
+        }
+
+        return true;
+    }
+}
+
+bool ParseShaderListing(const std::string& listing, ShaderReflection& reflection, std::string& error)
+{
+    reflection = ShaderReflection();
+
+    BufferDefinitionParser bufferDefinitionParser(reflection);
+    Section section = Section::None;
+    // Table rows start after the line of dashes below the table header.
+    bool inTable = false;
+
+    std::istringstream stream(listing);
+    std::string line;
+    while (std::getline(stream, line))
+    {
+        std::string text;
+        if (!StripComment(line, text))
+        {
+            // The reflection is in the comments at the top of the listing.
+            if (!reflection.ResourceBindings.empty() || !reflection.InputSignature.empty())
+            {
+                break;
+            }
+            continue;
+        }
+
+        Section nextSection = GetSection(text);
+        if (nextSection != Section::None)
+        {
+            section = nextSection;
+            inTable = false;
+            continue;
+        }
+
+        switch (section)
+        {
+        case Section::BufferDefinitions:
+            if (!bufferDefinitionParser.ParseLine(text, error))
+            {
+                return false;
+            }
+            break;
+        case Section::ResourceBindings:
+        case Section::InputSignature:
+            if (StartsWith(text, "---"))
+            {
+                inTable = true;
+            }
+            else if (inTable && text.empty())
+            {
+                inTable = false;
+                section = Section::None;
+            }
+            else if (inTable)
+            {
+                if (section == Section::ResourceBindings)
+                {
+                    ShaderReflection::ResourceBinding binding;
+                    if (!ParseResourceBinding(text, binding, error))
+                    {
+                        return false;
+                    }
+                    reflection.ResourceBindings.push_back(binding);
+                }
+                else
+                {
+                    ShaderReflection::InputElement element;
+                    if (!ParseInputElement(text, element, error))
+                    {
+                        return false;
+                    }
+                    reflection.InputSignature.push_back(element);
+                }
+            }
+            break;
+        default:
+            break;
+        }
+    }
+
+    return true;
+}
@@ -0,0 +1,190 @@
+/**
+ * ShaderReflect generates a C++ header with the binding metadata of a set
+ * of shaders from the assembly listings that are written by the shader
+ * compiler (see ShaderBuild --listing). The generated header contains the
+ * constant buffer layouts, the root parameter indices and the input layout
+ * of the shaders, so they don't have to be written (and kept in sync) by hand.
+ *
+ * Usage:
+ *   ShaderReflect --namespace <name> --output <file.h>
+ *                 [--frequency <binding>=<PerFrame|PerPass|PerMaterial|PerDraw>]...
+ *                 <stage>=<file.lst>...
+ *
+ * The stage is one of vs, hs, ds, gs, ps or cs.
+ */
+#include <ReflectionHeader.h>
+#include <ShaderListing.h>
+
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <system_error>
+
+namespace fs = std::filesystem;
+
+namespace
+{
+    struct Options
+    {
+        ReflectionHeader::Desc Header;
+        // The listing file of each stage (in the same order as Header.Stages).
+        std::vector<std::string> ListingFiles;
+        std::string OutputFile;
+    };
+
+    void PrintUsage()
+    {
+        fprintf(stderr,
+            "Usage:\n"
+            "  ShaderReflect --namespace <name> --output <file.h>\n"
+            "                [--frequency <binding>=<PerFrame|PerPass|PerMaterial|PerDraw>]...\n"
+            "                <stage>=<file.lst>...\n");
+    }
+
+    bool ParseArguments(int argc, char* argv[], Options& options)
+    {
+        for (int i = 1; i < argc; ++i)
+        {
+            const char* argument = argv[i];
+            bool hasValue = i + 1 < argc;
+
+            if (strncmp(argument, "--", 2) == 0 && !hasValue)
+            {
+                fprintf(stderr, "Missing value for %s\n", argument);
+                return false;
+            }
+            else if (strcmp(argument, "--namespace") == 0)
+            {
+                options.Header.Namespace = argv[++i];
+            }
+            else if (strcmp(argument, "--output") == 0)
+            {
+                options.OutputFile = argv[++i];
+            }
+            else if (strcmp(argument, "--frequency") == 0)
+            {
+                std::string value = argv[++i];
+                size_t separator = value.find('=');
+                RootSignatureOptimizer::UpdateFrequency frequency;
+                if (separator == std::string::npos ||
+                    !ReflectionHeader::ParseFrequency(value.substr(separator + 1), frequency))
+                {
+                    fprintf(stderr, "Invalid update frequency %s\n", value.c_str());
+                    return false;
+                }
+                options.Header.Frequencies[value.substr(0, separator)] = frequency;
+            }
+            else if (strncmp(argument, "--", 2) == 0)
+            {
+                fprintf(stderr, "Unknown option %s\n", argument);
+                return false;
+            }
+            else
+            {
+                std::string value = argument;
+                size_t separator = value.find('=');
+                RootSignatureOptimizer::ShaderVisibility visibility;
+                if (separator == std::string::npos ||
+                    !ReflectionHeader::ParseStage(value.substr(0, separator), visibility))
+                {
+                    fprintf(stderr, "Invalid shader %s (expected <stage>=<file.lst>)\n", argument);
+                    return false;
+                }
+
+                ReflectionHeader::Stage stage;
+                stage.Name = value.substr(0, separator);
+                options.ListingFiles.push_back(value.substr(separator + 1));
+                stage.FileName = fs::path(options.ListingFiles.back()).filename().string();
+                options.Header.Stages.push_back(stage);
+            }
+        }
+
+        if (options.Header.Namespace.empty() || options.OutputFile.empty() || options.Header.Stages.empty())
+        {
+            fprintf(stderr, "Missing required arguments.\n");
+            return false;
+        }
+
+        return true;
+    }
+
+    bool ReadFile(const std::string& fileName, std::string& contents)
+    {
+        std::ifstream file(fileName, std::ios::binary);
+        if (!file)
+        {
+            return false;
+        }
+        std::ostringstream stream;
+        stream << file.rdbuf();
+        contents = stream.str();
+        return true;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    Options options;
+    if (!ParseArguments(argc, argv, options))
+    {
+        PrintUsage();
+        return 1;
+    }
+
+    for (size_t i = 0; i < options.ListingFiles.size(); ++i)
+    {
+        const std::string& listingFile = options.ListingFiles[i];
+
+        std::string listing;
+        if (!ReadFile(listingFile, listing))
+        {
+            fprintf(stderr, "ShaderReflect: failed to read %s\n", listingFile.c_str());
+            return 1;
+        }
+
+        std::string error;
+        if (!ParseShaderListing(listing, options.Header.Stages[i].Reflection, error))
+        {
+            fprintf(stderr, "%s: error: %s\n", listingFile.c_str(), error.c_str());
+            return 1;
+        }
+    }
+
+    std::string header;
+    std::string error;
+    if (!ReflectionHeader::Generate(options.Header, header, error))
+    {
+        fprintf(stderr, "ShaderReflect: error: %s\n", error.c_str());
+        return 1;
+    }
+
+    // Only write the header if it changed, so the files that include it
+    // are not rebuilt when a shader changes without changing its bindings.
+    std::string previousHeader;
+    if (ReadFile(options.OutputFile, previousHeader) && previousHeader == header)
+    {
+        return 0;
+    }
+
+    std::error_code fsError;
+    fs::path outputPath(options.OutputFile);
+    if (outputPath.has_parent_path())
+    {
+        fs::create_directories(outputPath.parent_path(), fsError);
+    }
+
+    std::ofstream file(options.OutputFile, std::ios::binary);
+    file << header;
+    if (!file)
+    {
+        fprintf(stderr, "ShaderReflect: failed to write %s\n", options.OutputFile.c_str());
+        return 1;
+    }
+
+    printf("ShaderReflect: generated %s\n", options.OutputFile.c_str());
+
+    return 0;
+}
@@ -1,6 +1,12 @@
 #pragma once 
 
+#include <AsyncHandle.h>
 #include <Game.h>
+#include <MeshBufferPool.h>
+#include <RootSignature.h>
+#include <RootSignatureOptimizer.h>
+#include <ShaderReloader.h>
+#include <SimulationThread.h>
 #include <Window.h>
 #include <DirectXMath.h>
 #include <Utility.h>
@@ -46,55 +52,62 @@ protected:
 
 private:
     // Helper functions
-    // Transition a resource
-    void TransitionResource(
-        Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList2> commandList, 
-        Microsoft::WRL::ComPtr<ID3D12Resource> resource,
-        D3D12_RESOURCE_STATES beforeState, D3D12_RESOURCE_STATES afterState);
-    
      // Clear a render target view.
-    void ClearRTV(Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList2> commandList,
+    void ClearRTV(std::shared_ptr<CommandList> commandList,
         D3D12_CPU_DESCRIPTOR_HANDLE rtv, FLOAT* clearColor);
 
     // Clear the depth of a depth-stencil view.
-    void ClearDepth(Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList2> commandList,
+    void ClearDepth(std::shared_ptr<CommandList> commandList,
         D3D12_CPU_DESCRIPTOR_HANDLE dsv, FLOAT depth = 1.0f);
 
-    // Create a GPU buffer.
-    void UpdateBufferResource(Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList2> commandList,
-        ID3D12Resource** pDestinationResource, ID3D12Resource** pIntermediateResource,
-        size_t numElements, size_t elementSize, const void* bufferData, 
-        D3D12_RESOURCE_FLAGS flags = D3D12_RESOURCE_FLAG_NONE);
-    
     // Resize the depth buffer to match the size of the client area.
     void ResizeDepthBuffer(int width, int height);
     
-    uint64_t m_FenceValues[Window::BufferCount] = {};
-
-    // Vertex buffer for the cube.
-    Microsoft::WRL::ComPtr<ID3D12Resource> m_VertexBuffer;
-    D3D12_VERTEX_BUFFER_VIEW m_VertexBufferView;
-    // Index buffer for the cube.
-    Microsoft::WRL::ComPtr<ID3D12Resource> m_IndexBuffer;
-    D3D12_INDEX_BUFFER_VIEW m_IndexBufferView;
+    // Vertex buffer range for the cube (in the mesh buffer pool of the application).
+    MeshBufferPool::Range m_VertexBuffer;
+    // Index buffer range for the cube (in the mesh buffer pool of the application).
+    MeshBufferPool::Range m_IndexBuffer;
 
     // Depth buffer.
     Microsoft::WRL::ComPtr<ID3D12Resource> m_DepthBuffer;
     // Descriptor heap for depth buffer.
     Microsoft::WRL::ComPtr<ID3D12DescriptorHeap> m_DSVHeap;
 
-    // Root signature
-    Microsoft::WRL::ComPtr<ID3D12RootSignature> m_RootSignature;
-
-    // Pipeline state object.
-    Microsoft::WRL::ComPtr<ID3D12PipelineState> m_PipelineState;
+    // The root signature and pipeline state that are used to render the cube.
+    struct Pipeline
+    {
+        // Root signature (shared through the root signature cache).
+        std::shared_ptr<::RootSignature> RootSignature;
+        // Pipeline state object (shared through the pipeline state cache).
+        Microsoft::WRL::ComPtr<ID3D12PipelineState> PipelineState;
+    };
+
+    // Create the pipeline from the bytecode of the vertex and pixel shaders. Runs on the thread pool.
+    static Pipeline CreatePipeline(const RootSignatureOptimizer::Layout& layout, D3D_ROOT_SIGNATURE_VERSION rootSignatureVersion,
+        const ShaderReloader::Bytecode& shaders);
+
+    // The pipeline that is compiled on the thread pool.
+    // Replaced at a frame boundary when the shaders are reloaded.
+    AsyncHandle<Pipeline> m_Pipeline;
+    // Rebuilds the pipeline when the shaders change.
+    ShaderReloader::PipelineId m_PipelineId;
+    bool m_IsPipelineRegistered;
 
     D3D12_VIEWPORT m_Viewport;
     D3D12_RECT m_ScissorRect;
 
     float m_FoV;
 
-    DirectX::XMMATRIX m_ModelMatrix;
+    // The state of the cube that is simulated on the simulation thread.
+    struct SimulationState
+    {
+        // The rotation of the cube in degrees.
+        double Angle;
+    };
+
+    // Rotates the cube at a fixed tick rate. The renderer interpolates between the last two ticks.
+    std::unique_ptr< SimulationThread<SimulationState> > m_Simulation;
+
     DirectX::XMMATRIX m_ViewMatrix;
     DirectX::XMMATRIX m_ProjectionMatrix;
 
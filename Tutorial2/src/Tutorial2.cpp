@@ -1,14 +1,28 @@
 #include <Tutorial2.h>
 #include <Application.h>
+#include <CommandList.h>
 #include <CommandQueue.h>
+#include <FrameCapture.h>
+#include <GpuProfiler.h>
+#include <OptimizedRootSignatureDesc.h>
+#include <PipelineStateCache.h>
+#include <Profiler.h>
+#include <ResourceStateTracker.h>
+#include <RootSignatureCache.h>
+#include <ShaderReloader.h>
+#include <ThreadPool.h>
 #include <Window.h>
 #include <Utility.h>
 #include <cstdint>
 
+// Generated from the shaders by ShaderReflect.
+#include <Tutorial2Shaders.h>
+
 #include <wrl.h>
 using namespace Microsoft::WRL;
 
 #include <algorithm>
+#include <filesystem>
 
 using namespace DirectX;
 
@@ -43,75 +57,28 @@ static short g_Indicies[36] =
 
 Demo::Demo(const std::wstring& name, int width, int height, bool vSync) 
     : super(name, width, height, vSync)
+    , m_PipelineId(0)
+    , m_IsPipelineRegistered(false)
     , m_ScissorRect(CD3DX12_RECT(0, 0, LONG_MAX, LONG_MAX))
     , m_Viewport(CD3DX12_VIEWPORT(0.0f, 0.0f, static_cast<float>(width), static_cast<float>(height)))
     , m_FoV(45.0)
     , m_ContentLoaded(false) {}
 
-void Demo::UpdateBufferResource(Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList2> commandList,
-        ID3D12Resource** pDestinationResource, ID3D12Resource** pIntermediateResource,
-        size_t numElements, size_t elementSize, const void* bufferData, 
-        D3D12_RESOURCE_FLAGS flags) 
-{
-    ComPtr<ID3D12Device2> device = Application::Get().GetDevice();
-    size_t bufferSize = numElements * elementSize;
-
-    // Create a committed resource for the GPU resource in a default heap.
-    ThrowIfFailed(device->CreateCommittedResource(&CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_DEFAULT),
-        D3D12_HEAP_FLAG_NONE,
-        &CD3DX12_RESOURCE_DESC::Buffer(bufferSize, flags),
-        D3D12_RESOURCE_STATE_COPY_DEST,
-        nullptr,
-        IID_PPV_ARGS(pDestinationResource)));
-
-    // Create an committed resource for the upload.
-    if (bufferData)
-    {
-        ThrowIfFailed(device->CreateCommittedResource(
-            &CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_UPLOAD),
-            D3D12_HEAP_FLAG_NONE,
-            &CD3DX12_RESOURCE_DESC::Buffer(bufferSize),
-            D3D12_RESOURCE_STATE_GENERIC_READ,
-            nullptr,
-            IID_PPV_ARGS(pIntermediateResource)));
-
-        D3D12_SUBRESOURCE_DATA subresourceData = {};
-        subresourceData.pData = bufferData;
-        subresourceData.RowPitch = bufferSize;
-        subresourceData.SlicePitch = subresourceData.RowPitch;
-
-        UpdateSubresources(commandList.Get(),
-            *pDestinationResource, *pIntermediateResource,
-            0, 0, 1, &subresourceData);
-    }
-}
-
 bool Demo::LoadContent() 
 {
     ComPtr<ID3D12Device2> device = Application::Get().GetDevice();
     std::shared_ptr<CommandQueue> commandQueue = Application::Get().GetCommandQueue(D3D12_COMMAND_LIST_TYPE_COPY);
-    ComPtr<ID3D12GraphicsCommandList2> commandList = commandQueue->GetCommandList();
+    std::shared_ptr<CommandList> commandList = commandQueue->GetCommandList();
 
-    // Upload vertex buffer data.
-    ComPtr<ID3D12Resource> intermediateVertexBuffer;
-    UpdateBufferResource(commandList, &m_VertexBuffer, 
-        &intermediateVertexBuffer, _countof(g_Vertices), sizeof(Vertex), g_Vertices);
+    std::shared_ptr<MeshBufferPool> meshBufferPool = Application::Get().GetMeshBufferPool();
 
-    // Create the vertex buffer view.
-    m_VertexBufferView.BufferLocation = m_VertexBuffer->GetGPUVirtualAddress();
-    m_VertexBufferView.SizeInBytes = sizeof(g_Vertices);
-    m_VertexBufferView.StrideInBytes = sizeof(Vertex);
+    // Upload vertex buffer data.
+    m_VertexBuffer = meshBufferPool->AllocateVertices(_countof(g_Vertices), sizeof(Vertex));
+    meshBufferPool->Upload(*commandList, m_VertexBuffer, g_Vertices);
 
     // Upload index buffer.
-    ComPtr<ID3D12Resource> intermediateIndexBuffer;
-    UpdateBufferResource(commandList,
-        &m_IndexBuffer, &intermediateIndexBuffer,
-        _countof(g_Indicies), sizeof(WORD), g_Indicies);
-
-    // Create index buffer view.
-    m_IndexBufferView.BufferLocation = m_IndexBuffer->GetGPUVirtualAddress();
-    m_IndexBufferView.Format = DXGI_FORMAT_R16_UINT;
-    m_IndexBufferView.SizeInBytes = sizeof(g_Indicies);
+    m_IndexBuffer = meshBufferPool->AllocateIndices(_countof(g_Indicies), DXGI_FORMAT_R16_UINT);
+    meshBufferPool->Upload(*commandList, m_IndexBuffer, g_Indicies);
 
     // Create the descriptor heap for the depth-stencil view.
     D3D12_DESCRIPTOR_HEAP_DESC dsvHeapDesc = {};
@@ -121,21 +88,6 @@ bool Demo::LoadContent()
     ThrowIfFailed(device->CreateDescriptorHeap(&dsvHeapDesc, IID_PPV_ARGS(&m_DSVHeap)));
 
 
-    // Load the vertex shader.
-    ComPtr<ID3DBlob> vertexShaderBlob;
-    ThrowIfFailed(D3DReadFileToBlob(L"shaders/VertexShader.cso", &vertexShaderBlob));
-
-    // Load the pixel shader.
-    ComPtr<ID3DBlob> pixelShaderBlob;
-    ThrowIfFailed(D3DReadFileToBlob(L"shaders/PixelShader.cso", &pixelShaderBlob));
-
-    // Create the vertex input layout
-    D3D12_INPUT_ELEMENT_DESC inputLayout[] = 
-    {
-        { "POSITION", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, D3D12_APPEND_ALIGNED_ELEMENT, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
-        { "COLOR", 0, DXGI_FORMAT_R32G32B32_FLOAT, 0, D3D12_APPEND_ALIGNED_ELEMENT, D3D12_INPUT_CLASSIFICATION_PER_VERTEX_DATA, 0 },
-    };
-
     // Create a root signature.
     D3D12_FEATURE_DATA_ROOT_SIGNATURE featureData = {};
     featureData.HighestVersion = D3D_ROOT_SIGNATURE_VERSION_1_1;
@@ -144,31 +96,95 @@ bool Demo::LoadContent()
         featureData.HighestVersion = D3D_ROOT_SIGNATURE_VERSION_1_0;
     }
 
-    // Allow input layout and deny unnecessary access to certain pipeline stages.
-    D3D12_ROOT_SIGNATURE_FLAGS rootSignatureFlags =
-        D3D12_ROOT_SIGNATURE_FLAG_ALLOW_INPUT_ASSEMBLER_INPUT_LAYOUT |
-        D3D12_ROOT_SIGNATURE_FLAG_DENY_HULL_SHADER_ROOT_ACCESS |
-        D3D12_ROOT_SIGNATURE_FLAG_DENY_DOMAIN_SHADER_ROOT_ACCESS |
-        D3D12_ROOT_SIGNATURE_FLAG_DENY_GEOMETRY_SHADER_ROOT_ACCESS |
-        D3D12_ROOT_SIGNATURE_FLAG_DENY_PIXEL_SHADER_ROOT_ACCESS;
-
-    // A single 32-bit constant root parameter that is used by the vertex shader.
-    CD3DX12_ROOT_PARAMETER1 rootParameters[1];
-    rootParameters[0].InitAsConstants(sizeof(XMMATRIX) / 4, 0, 0, D3D12_SHADER_VISIBILITY_VERTEX);
-
-    CD3DX12_VERSIONED_ROOT_SIGNATURE_DESC rootSignatureDescription;
-    rootSignatureDescription.Init_1_1(_countof(rootParameters), rootParameters, 0, nullptr, rootSignatureFlags);
-
-    // Serialize the root signature.
-    ComPtr<ID3DBlob> rootSignatureBlob;
-    ComPtr<ID3DBlob> errorBlob;
-    ThrowIfFailed(D3DX12SerializeVersionedRootSignature(
-        &rootSignatureDescription,
-        featureData.HighestVersion, 
-        &rootSignatureBlob, &errorBlob));
-    // Create the root signature.
-    ThrowIfFailed(device->CreateRootSignature(0, rootSignatureBlob->GetBufferPointer(),
-        rootSignatureBlob->GetBufferSize(), IID_PPV_ARGS(&m_RootSignature)));
+    // The bindings are reflected from the shaders. The MVP matrix constant buffer
+    // (b0) is promoted to root constants by the optimizer.
+    RootSignatureOptimizer::Layout layout = RootSignatureOptimizer::Optimize(
+        { std::begin(Tutorial2Shaders::Bindings), std::end(Tutorial2Shaders::Bindings) });
+    ASSERT(layout.Remap[Tutorial2Shaders::BindingIndex::ModelViewProjectionCB].RootParameterIndex ==
+        Tutorial2Shaders::RootParameters::ModelViewProjectionCB, "Generated root parameter index does not match the optimized layout.");
+
+    // Load the shaders. The source files are watched and the shaders are
+    // recompiled when they change.
+    std::shared_ptr<ShaderReloader> shaderReloader = Application::Get().GetShaderReloader();
+    std::filesystem::path shaderSourceDirectory(SHADER_SOURCE_DIR);
+
+    // The shaders are recompiled with the compiler and options of the shader build.
+    ShaderReloader::ShaderDesc shaderBuildDesc;
+    shaderBuildDesc.Backend = SHADER_BUILD_BACKEND;
+    shaderBuildDesc.CompilerPath = SHADER_COMPILER;
+    shaderBuildDesc.Debug = SHADER_BUILD_DEBUG != 0;
+
+    ShaderReloader::ShaderDesc vertexShaderDesc = shaderBuildDesc;
+    vertexShaderDesc.SourceFile = shaderSourceDirectory / L"VertexShader.hlsl";
+    vertexShaderDesc.BytecodeFile = L"shaders/VertexShader.cso";
+    vertexShaderDesc.Profile = "vs_5_1";
+
+    ShaderReloader::ShaderDesc pixelShaderDesc = shaderBuildDesc;
+    pixelShaderDesc.SourceFile = shaderSourceDirectory / L"PixelShader.hlsl";
+    pixelShaderDesc.BytecodeFile = L"shaders/PixelShader.cso";
+    pixelShaderDesc.Profile = "ps_5_1";
+
+    ShaderReloader::ShaderId vertexShader = shaderReloader->AddShader(vertexShaderDesc);
+    ShaderReloader::ShaderId pixelShader = shaderReloader->AddShader(pixelShaderDesc);
+    ShaderReloader::Bytecode shaders = { shaderReloader->GetBytecode(vertexShader), shaderReloader->GetBytecode(pixelShader) };
+
+    // Create the root signature and pipeline state on the thread pool.
+    // The cube is not drawn until the pipeline is ready.
+    D3D_ROOT_SIGNATURE_VERSION rootSignatureVersion = featureData.HighestVersion;
+    m_Pipeline = AsyncHandle<Pipeline>(Application::Get().GetThreadPool()->Submit([layout, rootSignatureVersion, shaders]()
+    {
+        return CreatePipeline(layout, rootSignatureVersion, shaders);
+    }));
+
+    // Rebuild the pipeline when the shaders are reloaded. The new pipeline
+    // replaces the current one at a frame boundary.
+    m_PipelineId = shaderReloader->AddPipeline({ vertexShader, pixelShader },
+        [this, layout, rootSignatureVersion](const ShaderReloader::Bytecode& reloadedShaders) -> ShaderReloader::CommitFunction
+    {
+        Pipeline pipeline = CreatePipeline(layout, rootSignatureVersion, reloadedShaders);
+        return [this, pipeline]()
+        {
+            // The replaced pipeline state is not written to the pipeline state cache file.
+            if (m_Pipeline.IsReady() && m_Pipeline.Get().PipelineState != pipeline.PipelineState)
+            {
+                Application::Get().GetPipelineStateCache()->Release(m_Pipeline.Get().PipelineState.Get());
+            }
+            m_Pipeline = AsyncHandle<Pipeline>::MakeReady(pipeline);
+        };
+    });
+    m_IsPipelineRegistered = true;
+
+    // Rotate the cube on the simulation thread (90 degrees per second).
+    m_Simulation = std::make_unique< SimulationThread<SimulationState> >(60.0, SimulationState{ 0.0 },
+        [](SimulationState& state, double deltaTime, double)
+    {
+        state.Angle += 90.0 * deltaTime;
+    });
+    m_Simulation->Start();
+
+    std::uint64_t fenceValue = commandQueue->ExecuteCommandList(commandList);
+    commandQueue->WaitForFenceValue(fenceValue);
+
+    m_ContentLoaded = true;
+
+    ResizeDepthBuffer(GetClientWidth(), GetClientHeight());
+
+    return true;
+}
+
+Demo::Pipeline Demo::CreatePipeline(const RootSignatureOptimizer::Layout& layout, D3D_ROOT_SIGNATURE_VERSION rootSignatureVersion,
+    const ShaderReloader::Bytecode& shaders)
+{
+    ID3DBlob* vertexShaderBlob = shaders[0].Get();
+    ID3DBlob* pixelShaderBlob = shaders[1].Get();
+
+    // The input layout and the root signature flags (deny root access to the
+    // stages that don't use any resources) are reflected from the shaders.
+    OptimizedRootSignatureDesc rootSignatureDescription(layout, Tutorial2Shaders::RootSignatureFlags);
+
+    Pipeline pipeline;
+    pipeline.RootSignature = Application::Get().GetRootSignatureCache()->GetRootSignature(
+        rootSignatureDescription.GetDesc(), rootSignatureVersion);
 
     struct PipelineStateStream
     {
@@ -185,11 +201,11 @@ bool Demo::LoadContent()
     rtvFormats.NumRenderTargets = 1;
     rtvFormats.RTFormats[0] = DXGI_FORMAT_R8G8B8A8_UNORM;
 
-    pipelineStateStream.pRootSignature = m_RootSignature.Get();
-    pipelineStateStream.InputLayout = { inputLayout, _countof(inputLayout) };
+    pipelineStateStream.pRootSignature = pipeline.RootSignature->GetRootSignature().Get();
+    pipelineStateStream.InputLayout = { Tutorial2Shaders::InputLayout, _countof(Tutorial2Shaders::InputLayout) };
     pipelineStateStream.PrimitiveTopologyType = D3D12_PRIMITIVE_TOPOLOGY_TYPE_TRIANGLE;
-    pipelineStateStream.VS = CD3DX12_SHADER_BYTECODE(vertexShaderBlob.Get());
-    pipelineStateStream.PS = CD3DX12_SHADER_BYTECODE(pixelShaderBlob.Get());
+    pipelineStateStream.VS = CD3DX12_SHADER_BYTECODE(vertexShaderBlob);
+    pipelineStateStream.PS = CD3DX12_SHADER_BYTECODE(pixelShaderBlob);
     pipelineStateStream.DSVFormat = DXGI_FORMAT_D32_FLOAT;
     pipelineStateStream.RTVFormats = rtvFormats;
 
@@ -198,21 +214,46 @@ bool Demo::LoadContent()
         sizeof(PipelineStateStream), &pipelineStateStream
     };
 
-    ThrowIfFailed(device->CreatePipelineState(&pipelineStateStreamDesc, IID_PPV_ARGS(&m_PipelineState)));
-
-    std::uint64_t fenceValue = commandQueue->ExecuteCommandList(commandList);
-    commandQueue->WaitForFenceValue(fenceValue);
-
-    m_ContentLoaded = true;
-
-    ResizeDepthBuffer(GetClientWidth(), GetClientHeight());
+    // The pipeline state is loaded from the pipeline state cache file if it was compiled before.
+    uint64_t rootSignatureHash = RootSignatureCache::ComputeHash(rootSignatureDescription.GetDesc(), rootSignatureVersion);
+    pipeline.PipelineState = Application::Get().GetPipelineStateCache()->GetPipelineState(pipelineStateStreamDesc, rootSignatureHash);
 
-    return true;
+    return pipeline;
 }
 
 void Demo::UnloadContent()
 {
     m_ContentLoaded = false;
+
+    if (m_Simulation)
+    {
+        m_Simulation->Stop();
+        m_Simulation.reset();
+    }
+
+    // Stop rebuilding the pipeline (waits for a reload that is in progress).
+    if (m_IsPipelineRegistered)
+    {
+        Application::Get().GetShaderReloader()->RemovePipeline(m_PipelineId);
+        m_IsPipelineRegistered = false;
+    }
+
+    // Wait for the pipeline to finish compiling before it is released.
+    if (m_Pipeline.IsValid())
+    {
+        m_Pipeline.Wait();
+        m_Pipeline = AsyncHandle<Pipeline>();
+    }
+
+    // The ranges are returned to the pool when the GPU has finished the current frame.
+    std::shared_ptr<MeshBufferPool> meshBufferPool = Application::Get().GetMeshBufferPool();
+    meshBufferPool->Free(m_VertexBuffer);
+    meshBufferPool->Free(m_IndexBuffer);
+    m_VertexBuffer = MeshBufferPool::Range();
+    m_IndexBuffer = MeshBufferPool::Range();
+
+    ResourceStateTracker::RemoveGlobalResourceState(m_DepthBuffer.Get());
+    m_DepthBuffer.Reset();
 }
 
 void Demo::ResizeDepthBuffer(int width, int height) 
@@ -233,6 +274,8 @@ void Demo::ResizeDepthBuffer(int width, int height)
         optimizedClearValue.Format = DXGI_FORMAT_D32_FLOAT;
         optimizedClearValue.DepthStencil  = { 1.f, 0 };
 
+        ResourceStateTracker::RemoveGlobalResourceState(m_DepthBuffer.Get());
+
         ThrowIfFailed(device->CreateCommittedResource(
             &CD3DX12_HEAP_PROPERTIES(D3D12_HEAP_TYPE_DEFAULT),
             D3D12_HEAP_FLAG_NONE,
@@ -243,6 +286,8 @@ void Demo::ResizeDepthBuffer(int width, int height)
             IID_PPV_ARGS(&m_DepthBuffer)
         ));
 
+        ResourceStateTracker::AddGlobalResourceState(m_DepthBuffer.Get(), D3D12_RESOURCE_STATE_DEPTH_WRITE);
+
         // Update the depth-stencil view.
         D3D12_DEPTH_STENCIL_VIEW_DESC dsv = {};
         dsv.Format = DXGI_FORMAT_D32_FLOAT;
@@ -277,20 +322,18 @@ void Demo::OnUpdate(UpdateEventArgs& e)
     if (totalTime > 1.)
     {
         const double fps = frameCount / totalTime;
+        const FrameStats::Summary frameTimes = m_pWindow->GetRenderFrameStats().GetRecentSummary();
 
         char buffer[512];
-        sprintf_s(buffer, "FPS: %f\n", fps);
+        sprintf_s(buffer, "FPS: %f (p50: %.2f ms, p95: %.2f ms, p99: %.2f ms, hitches: %llu)\n", fps,
+            frameTimes.P50 * 1e3, frameTimes.P95 * 1e3, frameTimes.P99 * 1e3,
+            static_cast<unsigned long long>(m_pWindow->GetRenderFrameStats().GetNumHitches()));
         OutputDebugStringA(buffer);
 
         frameCount = 0;
         totalTime = .0;
     }
 
-    // Upload the model matrix.
-    float angle = (float)(e.TotalTime * 90.f);
-    const XMVECTOR rotationAxis = XMVectorSet(0.f, 1.f, 1.f, 0.f);
-    m_ModelMatrix = XMMatrixRotationAxis(rotationAxis, XMConvertToRadians(angle));
-
     // Update the view matrix.
     const XMVECTOR eyePosition = XMVectorSet(0.f, 0.f, -10.f, 1.f);
     const XMVECTOR focusPoint  = XMVectorSet(0.f, 0.f, 0.f, 1.f);
@@ -302,32 +345,19 @@ void Demo::OnUpdate(UpdateEventArgs& e)
     m_ProjectionMatrix = XMMatrixPerspectiveFovLH(XMConvertToRadians(m_FoV), aspectRatio, .1f, 100.f);
 }
 
-// Transition resource
-void Demo::TransitionResource(
-    Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList2> commandList, 
-    Microsoft::WRL::ComPtr<ID3D12Resource> resource,
-    D3D12_RESOURCE_STATES beforeState, D3D12_RESOURCE_STATES afterState) 
-{
-    CD3DX12_RESOURCE_BARRIER barrier = CD3DX12_RESOURCE_BARRIER::Transition(
-        resource.Get(),
-        beforeState, afterState);
- 
-    commandList->ResourceBarrier(1, &barrier);   
-}
-
 // Clear a render target.
 void Demo::ClearRTV(
-    Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList2> commandList,
+    std::shared_ptr<CommandList> commandList,
     D3D12_CPU_DESCRIPTOR_HANDLE rtv, FLOAT* clearColor)
 {
-    commandList->ClearRenderTargetView(rtv, clearColor, 0, nullptr);
+    commandList->ClearRenderTargetView(rtv, clearColor);
 }
 
 void Demo::ClearDepth(
-    Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList2> commandList,
+    std::shared_ptr<CommandList> commandList,
     D3D12_CPU_DESCRIPTOR_HANDLE dsv, FLOAT depth)
 {
-    commandList->ClearDepthStencilView(dsv, D3D12_CLEAR_FLAG_DEPTH, depth, 0, 0, nullptr);
+    commandList->ClearDepthStencilView(dsv, D3D12_CLEAR_FLAG_DEPTH, depth);
 }
 
 void Demo::OnRender(RenderEventArgs& e)
@@ -335,16 +365,16 @@ void Demo::OnRender(RenderEventArgs& e)
     super::OnRender(e);
 
     std::shared_ptr<CommandQueue> commandQueue = Application::Get().GetCommandQueue(D3D12_COMMAND_LIST_TYPE_DIRECT);
-    Microsoft::WRL::ComPtr<ID3D12GraphicsCommandList2> commandList = commandQueue->GetCommandList();
-    UINT currentBackBufferIndex = m_pWindow->GetCurrentBackBufferIndex();
+    std::shared_ptr<CommandList> commandList = commandQueue->GetCommandList();
     Microsoft::WRL::ComPtr<ID3D12Resource> backBuffer = m_pWindow->GetCurrentBackBuffer();
     D3D12_CPU_DESCRIPTOR_HANDLE rtv = m_pWindow->GetCurrentRenderTargetView();
     D3D12_CPU_DESCRIPTOR_HANDLE dsv = m_DSVHeap->GetCPUDescriptorHandleForHeapStart();
 
     // Clear the render targets.
     {
-        TransitionResource(commandList, backBuffer,
-            D3D12_RESOURCE_STATE_PRESENT, D3D12_RESOURCE_STATE_RENDER_TARGET);
+        GPU_PROFILE_SCOPE(*commandList, "Clear");
+
+        commandList->TransitionBarrier(backBuffer, D3D12_RESOURCE_STATE_RENDER_TARGET);
 
         FLOAT clearColor[] = { 0.4f, 0.6f, 0.9f, 1.0f };
 
@@ -352,34 +382,51 @@ void Demo::OnRender(RenderEventArgs& e)
         ClearDepth(commandList, dsv);
     }
 
-    commandList->SetPipelineState(m_PipelineState.Get());
-    commandList->SetGraphicsRootSignature(m_RootSignature.Get());
+    // Only the clear color is rendered while the pipeline is compiling.
+    Pipeline pipeline = m_Pipeline.GetOr(Pipeline());
+    if (pipeline.PipelineState)
+    {
+        GPU_PROFILE_SCOPE(*commandList, "Draw Cube");
+
+        commandList->SetPipelineState(pipeline.PipelineState);
+        commandList->SetGraphicsRootSignature(*pipeline.RootSignature);
+
+        commandList->SetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+        commandList->SetVertexBuffer(0, m_VertexBuffer.GetVertexBufferView());
+        commandList->SetIndexBuffer(m_IndexBuffer.GetIndexBufferView());
 
-    commandList->IASetPrimitiveTopology(D3D_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
-    commandList->IASetVertexBuffers(0, 1, &m_VertexBufferView);
-    commandList->IASetIndexBuffer(&m_IndexBufferView);
+        commandList->SetViewport(m_Viewport);
+        commandList->SetScissorRect(m_ScissorRect);
 
-    commandList->RSSetViewports(1, &m_Viewport);
-    commandList->RSSetScissorRects(1, &m_ScissorRect);
+        commandList->SetRenderTargets(1, &rtv, &dsv);
 
-    commandList->OMSetRenderTargets(1, &rtv, FALSE, &dsv);
+        // Interpolate the rotation of the cube between the last two simulation ticks.
+        const auto& snapshot = m_Simulation->GetSnapshot();
+        double alpha = m_Simulation->GetAlpha(snapshot);
+        float angle = static_cast<float>(snapshot.Previous.Angle + (snapshot.Current.Angle - snapshot.Previous.Angle) * alpha);
 
-    // Update the MVP matrix
-    XMMATRIX mvpMatrix = XMMatrixMultiply(m_ModelMatrix, m_ViewMatrix);
-    mvpMatrix = XMMatrixMultiply(mvpMatrix, m_ProjectionMatrix);
-    commandList->SetGraphicsRoot32BitConstants(0, sizeof(XMMATRIX) / 4, &mvpMatrix, 0);
+        const XMVECTOR rotationAxis = XMVectorSet(0.f, 1.f, 1.f, 0.f);
+        XMMATRIX modelMatrix = XMMatrixRotationAxis(rotationAxis, XMConvertToRadians(angle));
+
+        // Update the MVP matrix
+        XMMATRIX mvpMatrix = XMMatrixMultiply(modelMatrix, m_ViewMatrix);
+        mvpMatrix = XMMatrixMultiply(mvpMatrix, m_ProjectionMatrix);
+
+        Tutorial2Shaders::ModelViewProjection modelViewProjection;
+        XMStoreFloat4x4(&modelViewProjection.MVP, mvpMatrix);
+        commandList->SetGraphics32BitConstants(Tutorial2Shaders::RootParameters::ModelViewProjectionCB, modelViewProjection);
+
+        commandList->DrawIndexed(_countof(g_Indicies));
+    }
 
-    commandList->DrawIndexedInstanced(_countof(g_Indicies), 1, 0, 0, 0);
     // Present
     {
-        TransitionResource(commandList, backBuffer,
-            D3D12_RESOURCE_STATE_RENDER_TARGET, D3D12_RESOURCE_STATE_PRESENT);
-
-        m_FenceValues[currentBackBufferIndex] = commandQueue->ExecuteCommandList(commandList);
+        commandList->TransitionBarrier(backBuffer, D3D12_RESOURCE_STATE_PRESENT);
 
-        currentBackBufferIndex = m_pWindow->Present();
+        commandQueue->ExecuteCommandList(commandList);
 
-        commandQueue->WaitForFenceValue(m_FenceValues[currentBackBufferIndex]);
+        // The window's frame pacer limits the number of frames in flight.
+        m_pWindow->Present();
     }
 }
 
@@ -402,6 +449,22 @@ void Demo::OnKeyPressed(KeyEventArgs& e)
         case KeyCode::V:
             m_pWindow->ToggleVSync();
             break;
+        case KeyCode::C:
+            // Capture the next frames for the FrameReplay tool.
+            Application::Get().GetFrameCapture().Begin("Tutorial2.capture", 60);
+            break;
+        case KeyCode::P:
+            OutputDebugStringA(Profiler::Get().GetStatisticsTable().c_str());
+            OutputDebugStringA(Application::Get().GetGpuProfiler().GetTimingsTable().c_str());
+            break;
+        case KeyCode::T:
+            // Open the trace in chrome://tracing or Perfetto.
+            Profiler::Get().BeginTrace("Tutorial2.trace.json", 60);
+            break;
+        case KeyCode::F:
+            m_pWindow->GetRenderFrameStats().WriteSamplesCSV("Tutorial2.frames.csv");
+            m_pWindow->GetRenderFrameStats().WriteHistogramCSV("Tutorial2.histogram.csv");
+            break;
     }
 }
 
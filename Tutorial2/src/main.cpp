@@ -1,8 +1,10 @@
 #define WIN32_LEAN_AND_MEAN
 #include <Windows.h>
 #include <Shlwapi.h>
+#include <shellapi.h>
 
 #include <Application.h>
+#include <HeadlessPlatform.h>
 #include <Tutorial2.h>
 
 #include <dxgidebug.h>
@@ -29,7 +31,25 @@ int CALLBACK wWinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, PWSTR lpCmdL
         SetCurrentDirectoryW(path);
     }
 
-    Application::Create(hInstance);
+    // -headless <frames>: run a fixed number of frames with synthetic input
+    // (for benchmarks and soak tests).
+    std::unique_ptr<Platform> platform;
+    int argc;
+    wchar_t** argv = ::CommandLineToArgvW(::GetCommandLineW(), &argc);
+    for (int i = 1; i + 1 < argc; ++i)
+    {
+        if (::wcscmp(argv[i], L"-headless") == 0)
+        {
+            HeadlessPlatform::Settings settings;
+            settings.MaxFrames = std::wcstoull(argv[i + 1], nullptr, 10);
+            auto headlessPlatform = std::make_unique<HeadlessPlatform>(settings);
+            headlessPlatform->SetInputGenerator(HeadlessPlatform::CreateRandomInput(0, 1280, 720));
+            platform = std::move(headlessPlatform);
+        }
+    }
+    ::LocalFree(argv);
+
+    Application::Create(hInstance, std::move(platform));
     {
         std::shared_ptr<Demo> demo = std::make_shared<Demo>(L"Learning DirectX 12 - Lesson 2", 1280, 720);
         retCode = Application::Get().Run(demo);